@@ -26,6 +26,7 @@
 #include "../mem/meminfo.h"
 #include "../str.h"
 #include "../ut.h"
+#include "../async.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -765,6 +766,105 @@ int cachedb_raw_query(str* cachedb_name, str* attr, cdb_raw_entry*** reply,int e
 	return ret;
 }
 
+int cachedb_async_start(str *cachedb_name, cdb_async_job *job, str *attr,
+			str *val, int n, int expires)
+{
+	cachedb_funcs *f;
+	str cde_engine,grp_name;
+	char *p;
+	int fd;
+
+	if (cachedb_name == NULL || job == NULL || attr == NULL) {
+		LM_ERR("null arguments\n");
+		return -1;
+	}
+
+	p = memchr(cachedb_name->s,':',cachedb_name->len);
+	if (p == NULL) {
+		cde_engine = *cachedb_name;
+		grp_name.s = NULL;
+		grp_name.len = 0;
+	} else {
+		cde_engine.s = cachedb_name->s;
+		cde_engine.len = p - cde_engine.s;
+		grp_name.s = p+1;
+		grp_name.len = cachedb_name->len - cde_engine.len -1;
+	}
+
+	job->cde = lookup_cachedb(&cde_engine);
+	if (job->cde == NULL) {
+		LM_ERR("Wrong argument <%.*s> - no cachedb system with"
+				" this name registered\n",
+				cde_engine.len,cde_engine.s);
+		return -1;
+	}
+
+	f = &job->cde->cdb_func;
+	if (!CACHEDB_CAPABILITY(f,CACHEDB_CAP_ASYNC))
+		return -2;
+
+	job->con = cachedb_get_connection(job->cde,&grp_name);
+	if (job->con == NULL) {
+		LM_ERR("failed to get connection for grp name [%.*s] : check db_url\n",
+				grp_name.len,grp_name.s);
+		return -1;
+	}
+
+	job->priv = NULL;
+
+	switch (job->type) {
+	case CDB_ASYNC_GET:
+		if (!f->async_get)
+			return -2;
+		fd = f->async_get(job->con, attr, &job->priv);
+		break;
+	case CDB_ASYNC_SET:
+		if (!f->async_set)
+			return -2;
+		fd = f->async_set(job->con, attr, val, expires, &job->priv);
+		break;
+	case CDB_ASYNC_ADD:
+		if (!f->async_add)
+			return -2;
+		fd = f->async_add(job->con, attr, n, expires, &job->priv);
+		break;
+	case CDB_ASYNC_SUB:
+		if (!f->async_sub)
+			return -2;
+		fd = f->async_sub(job->con, attr, n, expires, &job->priv);
+		break;
+	case CDB_ASYNC_RAW_QUERY:
+		if (!f->async_raw_query)
+			return -2;
+		fd = f->async_raw_query(job->con, attr, job->res.num_cols,
+			&job->priv);
+		break;
+	default:
+		LM_BUG("bad async cachedb query type %d\n", job->type);
+		return -1;
+	}
+
+	LM_DBG("async %d query for [%.*s] over %.*s returned %d\n", job->type,
+		attr->len, attr->s, cachedb_name->len, cachedb_name->s, fd);
+
+	return fd;
+}
+
+int cachedb_async_resume(int fd, cdb_async_job *job)
+{
+	int rc;
+
+	rc = job->cde->cdb_func.async_resume(job->con, fd, &job->res, job->priv);
+	if (async_status == ASYNC_CONTINUE || async_status == ASYNC_CHANGE_FD)
+		return rc;
+
+	if (rc != 0 && job->res.rc >= 0)
+		job->res.rc = -1;
+
+	/* same as for the sync queries */
+	return job->res.rc == 0 ? 1 : job->res.rc;
+}
+
 void free_raw_fetch(cdb_raw_entry **reply, int num_cols, int num_rows)
 {
 	int i,j;
@@ -42,6 +42,16 @@ typedef struct {
 	} val;
 } cdb_raw_entry;
 
+/* result of an async query, as it would be returned by the sync function */
+typedef struct cdb_async_res {
+	int rc;                 /* the return code of the sync function */
+	str val;                /* get: value, in PKG, freed by the caller */
+	int new_val;            /* add/sub: new value of the counter */
+	cdb_raw_entry **reply;  /* raw_query: rows, freed by the caller */
+	int num_cols;           /* raw_query: expected columns (input) */
+	int num_rows;
+} cdb_async_res;
+
 extern stat_var *cdb_total_queries;
 extern stat_var *cdb_slow_queries;
 
@@ -154,6 +164,39 @@ typedef struct cachedb_funcs_t {
 		const cdb_dict_t *pairs);
 	int (*map_remove) (cachedb_con *con, const str *key, const str *subkey);
 
+	/*
+	 * Asynchronous variants of get/set/add/sub/raw_query
+	 * Support for these endpoints can be verified via CACHEDB_CAP_ASYNC
+	 *
+	 * They only send the query, then return the fd to be watched for its
+	 * reply, or:
+	 *   -1: error
+	 *   -2: the query cannot be done asynchronously right now, the caller
+	 *       shall fall back to the sync function
+	 * @priv is populated by the engine and must be preserved by the caller
+	 * until the query completes.
+	 */
+	int (*async_get) (cachedb_con *con, str *attr, void **priv);
+	int (*async_set) (cachedb_con *con, str *attr, str *val, int expires,
+	        void **priv);
+	int (*async_add) (cachedb_con *con, str *attr, int val, int expires,
+	        void **priv);
+	int (*async_sub) (cachedb_con *con, str *attr, int val, int expires,
+	        void **priv);
+	int (*async_raw_query) (cachedb_con *con, str *query, int num_cols,
+	        void **priv);
+
+	/**
+	 * async_resume() - Reads the reply of an async query from @fd.
+	 *
+	 * Sets "async_status" to ASYNC_CONTINUE if more data is expected,
+	 * otherwise to ASYNC_DONE, once @res is populated and @priv released.
+	 *
+	 * Return: 0 on success, -1 otherwise (the query failed).
+	 */
+	int (*async_resume) (cachedb_con *con, int fd, cdb_async_res *res,
+	        void *priv);
+
 	int capability;
 } cachedb_funcs;
 
@@ -165,6 +208,24 @@ typedef struct cachedb_engines {
 									  for this particular cachedb engine */
 } cachedb_engine;
 
+enum cdb_async_type {
+	CDB_ASYNC_GET,
+	CDB_ASYNC_SET,
+	CDB_ASYNC_ADD,
+	CDB_ASYNC_SUB,
+	CDB_ASYNC_RAW_QUERY,
+};
+
+/* an async query, in progress over some engine's connection */
+typedef struct cdb_async_job {
+	enum cdb_async_type type;
+	cachedb_engine *cde;
+	cachedb_con *con;
+	void *priv;            /* engine data */
+	cdb_async_res res;
+	void *param;           /* caller data */
+} cdb_async_job;
+
 #include "cachedb_cap.h"
 
 int register_cachedb(cachedb_engine* cde_entry);
@@ -179,6 +240,20 @@ int cachedb_sub(str* cachedb_engine, str* attr, int val,int expires,int *new_val
 int cachedb_raw_query(str* cachedb_engine, str* attr, cdb_raw_entry ***reply,
 			int expected_key_no,int *val_no);
 
+/*
+ * Starts the @job->type query over the given "engine[:group]" connection.
+ * Returns the fd to be watched, -2 if the engine cannot do it asynchronously
+ * (the sync variant shall be used instead) or -1 on error.
+ */
+int cachedb_async_start(str *cachedb_name, cdb_async_job *job, str *attr,
+			str *val, int n, int expires);
+/*
+ * Reads the reply of @job from @fd; once "async_status" is no longer
+ * ASYNC_CONTINUE, @job->res is populated and the script return code,
+ * similar to the one of the sync variant, is returned.
+ */
+int cachedb_async_resume(int fd, cdb_async_job *job);
+
 int cachedb_bind_mod(str *url,cachedb_funcs *funcs);
 int cachedb_put_connection(str *cachedb_name,cachedb_con *con);
 
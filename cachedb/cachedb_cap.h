@@ -50,6 +50,8 @@ typedef enum {
 	CACHEDB_CAP_MAP_REMOVE = 1<<12,
 	CACHEDB_CAP_MAP =
 		(CACHEDB_CAP_MAP_GET|CACHEDB_CAP_MAP_SET|CACHEDB_CAP_MAP_REMOVE),
+
+	CACHEDB_CAP_ASYNC = 1<<13,
 } cachedb_cap;
 
 #define CACHEDB_CAPABILITY(cdbf,cpv) (((cdbf)->capability & (cpv)) == (cpv))
@@ -104,6 +106,11 @@ static inline int check_cachedb_api(cachedb_engine *cde)
 	if (cde->cdb_func.map_get && cde->cdb_func.map_set && cde->cdb_func.map_remove)
 		cde->cdb_func.capability |= CACHEDB_CAP_MAP;
 
+	if (cde->cdb_func.async_resume && (cde->cdb_func.async_get ||
+	        cde->cdb_func.async_set || cde->cdb_func.async_add ||
+	        cde->cdb_func.async_sub || cde->cdb_func.async_raw_query))
+		cde->cdb_func.capability |= CACHEDB_CAP_ASYNC;
+
 	return 0;
 }
 
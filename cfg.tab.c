@@ -0,0 +1,6743 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 79 "cfg.y"
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/in_systm.h>
+#include <netinet/ip.h>
+#include <arpa/inet.h>
+#include <string.h>
+#include <errno.h>
+#include "route_struct.h"
+#include "globals.h"
+#include "route.h"
+#include "dprint.h"
+#include "cfg_pp.h"
+#include "sr_module.h"
+#include "modparam.h"
+#include "ip_addr.h"
+#include "resolve.h"
+#include "socket_info.h"
+#include "name_alias.h"
+#include "ut.h"
+#include "pt_scaling.h"
+#include "dset.h"
+#include "pvar.h"
+#include "blacklists.h"
+#include "xlog.h"
+#include "db/db_insertq.h"
+#include "db/db_async_exec.h"
+#include "db/db_preload.h"
+#include "ipc.h"
+#include "bin_interface.h"
+#include "net/trans.h"
+#include "config.h"
+#include "mem/rpm_mem.h"
+#include "poll_types.h"
+
+#ifdef SHM_EXTRA_STATS
+#include "mem/module_info.h"
+#endif
+
+#ifdef DEBUG_DMALLOC
+#include <dmalloc.h>
+#endif
+
+/* hack to avoid alloca usage in the generated C file (needed for compiler
+ with no built in alloca, like icc*/
+#undef _ALLOCA_H
+
+#undef MIN
+#undef MAX
+
+extern int yylex();
+static void yyerror(char* s);
+static void yyerrorf(char* fmt, ...);
+static char* tmp;
+static int i_tmp, rc;
+static void* cmd_tmp;
+static struct socket_id* lst_tmp;
+static int rt;  /* Type of route block for find_export */
+static str s_tmp;
+static str tstr;
+static struct net* net_tmp;
+static pv_spec_t *spec;
+static pv_elem_t *elem;
+static struct bl_rule *bl_head = 0;
+static struct bl_rule *bl_tail = 0;
+
+action_elem_t elems[MAX_ACTION_ELEMS];
+static action_elem_t route_elems[MAX_ACTION_ELEMS];
+action_elem_t *a_tmp;
+
+static inline void warn(char* s);
+static struct socket_id* mk_listen_id(char*, enum sip_protos, int);
+static struct socket_id* set_listen_id_adv(struct socket_id *, char *, int);
+static struct multi_str *new_string(char *s);
+static int parse_ipnet(char *in, int len, struct net **ipnet);
+
+extern int line;
+extern int column;
+extern int startcolumn;
+extern char *finame;
+
+struct listen_param {
+	enum si_flags flags;
+	int workers;
+	struct socket_id *socket;
+	char *tag;
+	char *auto_scaling_profile;
+} p_tmp;
+static void fill_socket_id(struct listen_param *param, struct socket_id *s);
+
+union route_name_var {
+	int iname;
+	struct _pv_spec *sname;
+	struct _pv_elem *ename;
+	void *data;
+} rn_tmp;
+
+#ifndef SHM_EXTRA_STATS
+struct multi_str{
+	char *s;
+	struct multi_str* next;
+};
+#else
+static struct multi_str *tmp_mod;
+#endif
+
+#define get_cfg_file_name \
+	((finame) ? finame : cfg_file ? cfg_file : "default")
+
+
+
+#define mk_action_(_res, _type, _no, _elems) \
+	do { \
+		_res = mk_action(_type, _no, _elems, line, get_cfg_file_name); \
+	} while(0)
+#define mk_action0(_res, _type) \
+	do { \
+		_res = mk_action(_type, 0, 0, line, get_cfg_file_name); \
+	} while(0)
+#define mk_action1(_res, _type, _p1_type, _p1) \
+	do { \
+		elems[0].type = _p1_type; \
+		elems[0].u.data = _p1; \
+		_res = mk_action(_type, 1, elems, line, get_cfg_file_name); \
+	} while(0)
+#define	mk_action2(_res, _type, _p1_type, _p2_type, _p1, _p2) \
+	do { \
+		elems[0].type = _p1_type; \
+		elems[0].u.data = _p1; \
+		elems[1].type = _p2_type; \
+		elems[1].u.data = _p2; \
+		_res = mk_action(_type, 2, elems, line, get_cfg_file_name); \
+	} while(0)
+#define mk_action3(_res, _type, _p1_type, _p2_type, _p3_type, _p1, _p2, _p3) \
+	do { \
+		elems[0].type = _p1_type; \
+		elems[0].u.data = _p1; \
+		elems[1].type = _p2_type; \
+		elems[1].u.data = _p2; \
+		elems[2].type = _p3_type; \
+		elems[2].u.data = _p3; \
+		_res = mk_action(_type, 3, elems, line, get_cfg_file_name); \
+	} while(0)
+
+extern int cfg_parse_only_routes;
+#define IFOR(_instr) \
+	if (cfg_parse_only_routes==1) {_instr;break;}
+
+
+#line 225 "cfg.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "cfg.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_DROP = 3,                       /* DROP  */
+  YYSYMBOL_ASSERT = 4,                     /* ASSERT  */
+  YYSYMBOL_EXIT = 5,                       /* EXIT  */
+  YYSYMBOL_RETURN = 6,                     /* RETURN  */
+  YYSYMBOL_LOG_TOK = 7,                    /* LOG_TOK  */
+  YYSYMBOL_ERROR = 8,                      /* ERROR  */
+  YYSYMBOL_ROUTE = 9,                      /* ROUTE  */
+  YYSYMBOL_ROUTE_FAILURE = 10,             /* ROUTE_FAILURE  */
+  YYSYMBOL_ROUTE_ONREPLY = 11,             /* ROUTE_ONREPLY  */
+  YYSYMBOL_ROUTE_BRANCH = 12,              /* ROUTE_BRANCH  */
+  YYSYMBOL_ROUTE_ERROR = 13,               /* ROUTE_ERROR  */
+  YYSYMBOL_ROUTE_LOCAL = 14,               /* ROUTE_LOCAL  */
+  YYSYMBOL_ROUTE_STARTUP = 15,             /* ROUTE_STARTUP  */
+  YYSYMBOL_ROUTE_TIMER = 16,               /* ROUTE_TIMER  */
+  YYSYMBOL_ROUTE_EVENT = 17,               /* ROUTE_EVENT  */
+  YYSYMBOL_IF = 18,                        /* IF  */
+  YYSYMBOL_ELSE = 19,                      /* ELSE  */
+  YYSYMBOL_SWITCH = 20,                    /* SWITCH  */
+  YYSYMBOL_CASE = 21,                      /* CASE  */
+  YYSYMBOL_DEFAULT = 22,                   /* DEFAULT  */
+  YYSYMBOL_BREAK = 23,                     /* BREAK  */
+  YYSYMBOL_WHILE = 24,                     /* WHILE  */
+  YYSYMBOL_FOR = 25,                       /* FOR  */
+  YYSYMBOL_IN = 26,                        /* IN  */
+  YYSYMBOL_NULLV = 27,                     /* NULLV  */
+  YYSYMBOL_XDBG = 28,                      /* XDBG  */
+  YYSYMBOL_XLOG = 29,                      /* XLOG  */
+  YYSYMBOL_XLOG_BUF_SIZE = 30,             /* XLOG_BUF_SIZE  */
+  YYSYMBOL_XLOG_FORCE_COLOR = 31,          /* XLOG_FORCE_COLOR  */
+  YYSYMBOL_XLOG_PRINT_LEVEL = 32,          /* XLOG_PRINT_LEVEL  */
+  YYSYMBOL_XLOG_LEVEL = 33,                /* XLOG_LEVEL  */
+  YYSYMBOL_PV_PRINT_BUF_SIZE = 34,         /* PV_PRINT_BUF_SIZE  */
+  YYSYMBOL_DEBUG_MODE = 35,                /* DEBUG_MODE  */
+  YYSYMBOL_ENABLE_ASSERTS = 36,            /* ENABLE_ASSERTS  */
+  YYSYMBOL_ABORT_ON_ASSERT = 37,           /* ABORT_ON_ASSERT  */
+  YYSYMBOL_LOGLEVEL = 38,                  /* LOGLEVEL  */
+  YYSYMBOL_LOGSTDOUT = 39,                 /* LOGSTDOUT  */
+  YYSYMBOL_LOGSTDERROR = 40,               /* LOGSTDERROR  */
+  YYSYMBOL_LOGFACILITY = 41,               /* LOGFACILITY  */
+  YYSYMBOL_LOGNAME = 42,                   /* LOGNAME  */
+  YYSYMBOL_AVP_ALIASES = 43,               /* AVP_ALIASES  */
+  YYSYMBOL_LISTEN = 44,                    /* LISTEN  */
+  YYSYMBOL_SOCKET = 45,                    /* SOCKET  */
+  YYSYMBOL_MEMGROUP = 46,                  /* MEMGROUP  */
+  YYSYMBOL_ALIAS = 47,                     /* ALIAS  */
+  YYSYMBOL_AUTO_ALIASES = 48,              /* AUTO_ALIASES  */
+  YYSYMBOL_TAG = 49,                       /* TAG  */
+  YYSYMBOL_DNS = 50,                       /* DNS  */
+  YYSYMBOL_REV_DNS = 51,                   /* REV_DNS  */
+  YYSYMBOL_DNS_TRY_IPV6 = 52,              /* DNS_TRY_IPV6  */
+  YYSYMBOL_DNS_TRY_NAPTR = 53,             /* DNS_TRY_NAPTR  */
+  YYSYMBOL_DNS_RETR_TIME = 54,             /* DNS_RETR_TIME  */
+  YYSYMBOL_DNS_RETR_NO = 55,               /* DNS_RETR_NO  */
+  YYSYMBOL_DNS_SERVERS_NO = 56,            /* DNS_SERVERS_NO  */
+  YYSYMBOL_DNS_USE_SEARCH = 57,            /* DNS_USE_SEARCH  */
+  YYSYMBOL_MAX_WHILE_LOOPS = 58,           /* MAX_WHILE_LOOPS  */
+  YYSYMBOL_UDP_WORKERS = 59,               /* UDP_WORKERS  */
+  YYSYMBOL_CHECK_VIA = 60,                 /* CHECK_VIA  */
+  YYSYMBOL_SHM_HASH_SPLIT_PERCENTAGE = 61, /* SHM_HASH_SPLIT_PERCENTAGE  */
+  YYSYMBOL_SHM_SECONDARY_HASH_SIZE = 62,   /* SHM_SECONDARY_HASH_SIZE  */
+  YYSYMBOL_MEM_WARMING_ENABLED = 63,       /* MEM_WARMING_ENABLED  */
+  YYSYMBOL_MEM_WARMING_PATTERN_FILE = 64,  /* MEM_WARMING_PATTERN_FILE  */
+  YYSYMBOL_MEM_WARMING_PERCENTAGE = 65,    /* MEM_WARMING_PERCENTAGE  */
+  YYSYMBOL_RPM_MEM_FILE = 66,              /* RPM_MEM_FILE  */
+  YYSYMBOL_RPM_MEM_SIZE = 67,              /* RPM_MEM_SIZE  */
+  YYSYMBOL_MEMLOG = 68,                    /* MEMLOG  */
+  YYSYMBOL_MEMDUMP = 69,                   /* MEMDUMP  */
+  YYSYMBOL_EXECMSGTHRESHOLD = 70,          /* EXECMSGTHRESHOLD  */
+  YYSYMBOL_EXECDNSTHRESHOLD = 71,          /* EXECDNSTHRESHOLD  */
+  YYSYMBOL_TCPTHRESHOLD = 72,              /* TCPTHRESHOLD  */
+  YYSYMBOL_EVENT_SHM_THRESHOLD = 73,       /* EVENT_SHM_THRESHOLD  */
+  YYSYMBOL_EVENT_PKG_THRESHOLD = 74,       /* EVENT_PKG_THRESHOLD  */
+  YYSYMBOL_QUERYBUFFERSIZE = 75,           /* QUERYBUFFERSIZE  */
+  YYSYMBOL_QUERYFLUSHTIME = 76,            /* QUERYFLUSHTIME  */
+  YYSYMBOL_QUERYWRITERPROCESSES = 77,      /* QUERYWRITERPROCESSES  */
+  YYSYMBOL_SIP_WARNING = 78,               /* SIP_WARNING  */
+  YYSYMBOL_SERVER_SIGNATURE = 79,          /* SERVER_SIGNATURE  */
+  YYSYMBOL_SERVER_HEADER = 80,             /* SERVER_HEADER  */
+  YYSYMBOL_USER_AGENT_HEADER = 81,         /* USER_AGENT_HEADER  */
+  YYSYMBOL_LOADMODULE = 82,                /* LOADMODULE  */
+  YYSYMBOL_MPATH = 83,                     /* MPATH  */
+  YYSYMBOL_MODPARAM = 84,                  /* MODPARAM  */
+  YYSYMBOL_MAXBUFFER = 85,                 /* MAXBUFFER  */
+  YYSYMBOL_CHROOT = 86,                    /* CHROOT  */
+  YYSYMBOL_WDIR = 87,                      /* WDIR  */
+  YYSYMBOL_MHOMED = 88,                    /* MHOMED  */
+  YYSYMBOL_POLL_METHOD = 89,               /* POLL_METHOD  */
+  YYSYMBOL_TCP_ACCEPT_ALIASES = 90,        /* TCP_ACCEPT_ALIASES  */
+  YYSYMBOL_TCP_WORKERS = 91,               /* TCP_WORKERS  */
+  YYSYMBOL_TCP_HANDSHAKE_WORKERS = 92,     /* TCP_HANDSHAKE_WORKERS  */
+  YYSYMBOL_TCP_CONNECT_TIMEOUT = 93,       /* TCP_CONNECT_TIMEOUT  */
+  YYSYMBOL_TCP_CON_LIFETIME = 94,          /* TCP_CON_LIFETIME  */
+  YYSYMBOL_TCP_SOCKET_BACKLOG = 95,        /* TCP_SOCKET_BACKLOG  */
+  YYSYMBOL_TCP_MAX_CONNECTIONS = 96,       /* TCP_MAX_CONNECTIONS  */
+  YYSYMBOL_TCP_NO_NEW_CONN_BFLAG = 97,     /* TCP_NO_NEW_CONN_BFLAG  */
+  YYSYMBOL_TCP_NO_NEW_CONN_RPLFLAG = 98,   /* TCP_NO_NEW_CONN_RPLFLAG  */
+  YYSYMBOL_TCP_KEEPALIVE = 99,             /* TCP_KEEPALIVE  */
+  YYSYMBOL_TCP_KEEPCOUNT = 100,            /* TCP_KEEPCOUNT  */
+  YYSYMBOL_TCP_KEEPIDLE = 101,             /* TCP_KEEPIDLE  */
+  YYSYMBOL_TCP_KEEPINTERVAL = 102,         /* TCP_KEEPINTERVAL  */
+  YYSYMBOL_TCP_MAX_MSG_TIME = 103,         /* TCP_MAX_MSG_TIME  */
+  YYSYMBOL_ADVERTISED_ADDRESS = 104,       /* ADVERTISED_ADDRESS  */
+  YYSYMBOL_ADVERTISED_PORT = 105,          /* ADVERTISED_PORT  */
+  YYSYMBOL_DISABLE_CORE = 106,             /* DISABLE_CORE  */
+  YYSYMBOL_OPEN_FD_LIMIT = 107,            /* OPEN_FD_LIMIT  */
+  YYSYMBOL_MCAST_LOOPBACK = 108,           /* MCAST_LOOPBACK  */
+  YYSYMBOL_MCAST_TTL = 109,                /* MCAST_TTL  */
+  YYSYMBOL_TOS = 110,                      /* TOS  */
+  YYSYMBOL_DISABLE_DNS_FAILOVER = 111,     /* DISABLE_DNS_FAILOVER  */
+  YYSYMBOL_DISABLE_DNS_BLACKLIST = 112,    /* DISABLE_DNS_BLACKLIST  */
+  YYSYMBOL_DST_BLACKLIST = 113,            /* DST_BLACKLIST  */
+  YYSYMBOL_DISABLE_STATELESS_FWD = 114,    /* DISABLE_STATELESS_FWD  */
+  YYSYMBOL_DB_VERSION_TABLE = 115,         /* DB_VERSION_TABLE  */
+  YYSYMBOL_DB_DEFAULT_URL = 116,           /* DB_DEFAULT_URL  */
+  YYSYMBOL_DB_MAX_ASYNC_CONNECTIONS = 117, /* DB_MAX_ASYNC_CONNECTIONS  */
+  YYSYMBOL_DB_ASYNC_EXECUTORS = 118,       /* DB_ASYNC_EXECUTORS  */
+  YYSYMBOL_DB_PRELOAD_WORKERS = 119,       /* DB_PRELOAD_WORKERS  */
+  YYSYMBOL_IPC_QUEUE_SIZE = 120,           /* IPC_QUEUE_SIZE  */
+  YYSYMBOL_DISABLE_503_TRANSLATION = 121,  /* DISABLE_503_TRANSLATION  */
+  YYSYMBOL_SYNC_TOKEN = 122,               /* SYNC_TOKEN  */
+  YYSYMBOL_ASYNC_TOKEN = 123,              /* ASYNC_TOKEN  */
+  YYSYMBOL_LAUNCH_TOKEN = 124,             /* LAUNCH_TOKEN  */
+  YYSYMBOL_AUTO_SCALING_PROFILE = 125,     /* AUTO_SCALING_PROFILE  */
+  YYSYMBOL_AUTO_SCALING_CYCLE = 126,       /* AUTO_SCALING_CYCLE  */
+  YYSYMBOL_AUTO_SCALING_POLICY = 127,      /* AUTO_SCALING_POLICY  */
+  YYSYMBOL_AUTO_SCALING_LATENCY = 128,     /* AUTO_SCALING_LATENCY  */
+  YYSYMBOL_AUTO_SCALING_SPARES = 129,      /* AUTO_SCALING_SPARES  */
+  YYSYMBOL_AUTO_SCALING_QUEUE = 130,       /* AUTO_SCALING_QUEUE  */
+  YYSYMBOL_TIMER_WORKERS = 131,            /* TIMER_WORKERS  */
+  YYSYMBOL_EQUAL = 132,                    /* EQUAL  */
+  YYSYMBOL_EQUAL_T = 133,                  /* EQUAL_T  */
+  YYSYMBOL_GT = 134,                       /* GT  */
+  YYSYMBOL_LT = 135,                       /* LT  */
+  YYSYMBOL_GTE = 136,                      /* GTE  */
+  YYSYMBOL_LTE = 137,                      /* LTE  */
+  YYSYMBOL_DIFF = 138,                     /* DIFF  */
+  YYSYMBOL_MATCH = 139,                    /* MATCH  */
+  YYSYMBOL_NOTMATCH = 140,                 /* NOTMATCH  */
+  YYSYMBOL_COLONEQ = 141,                  /* COLONEQ  */
+  YYSYMBOL_PLUSEQ = 142,                   /* PLUSEQ  */
+  YYSYMBOL_MINUSEQ = 143,                  /* MINUSEQ  */
+  YYSYMBOL_SLASHEQ = 144,                  /* SLASHEQ  */
+  YYSYMBOL_MULTEQ = 145,                   /* MULTEQ  */
+  YYSYMBOL_MODULOEQ = 146,                 /* MODULOEQ  */
+  YYSYMBOL_BANDEQ = 147,                   /* BANDEQ  */
+  YYSYMBOL_BOREQ = 148,                    /* BOREQ  */
+  YYSYMBOL_BXOREQ = 149,                   /* BXOREQ  */
+  YYSYMBOL_OR = 150,                       /* OR  */
+  YYSYMBOL_AND = 151,                      /* AND  */
+  YYSYMBOL_BOR = 152,                      /* BOR  */
+  YYSYMBOL_BAND = 153,                     /* BAND  */
+  YYSYMBOL_BXOR = 154,                     /* BXOR  */
+  YYSYMBOL_BLSHIFT = 155,                  /* BLSHIFT  */
+  YYSYMBOL_BRSHIFT = 156,                  /* BRSHIFT  */
+  YYSYMBOL_PLUS = 157,                     /* PLUS  */
+  YYSYMBOL_MINUS = 158,                    /* MINUS  */
+  YYSYMBOL_MULT = 159,                     /* MULT  */
+  YYSYMBOL_MODULO = 160,                   /* MODULO  */
+  YYSYMBOL_NOT = 161,                      /* NOT  */
+  YYSYMBOL_BNOT = 162,                     /* BNOT  */
+  YYSYMBOL_NUMBER = 163,                   /* NUMBER  */
+  YYSYMBOL_ZERO = 164,                     /* ZERO  */
+  YYSYMBOL_ID = 165,                       /* ID  */
+  YYSYMBOL_STRING = 166,                   /* STRING  */
+  YYSYMBOL_SCRIPTVAR = 167,                /* SCRIPTVAR  */
+  YYSYMBOL_IPV6ADDR = 168,                 /* IPV6ADDR  */
+  YYSYMBOL_IPV4ADDR = 169,                 /* IPV4ADDR  */
+  YYSYMBOL_IPNET = 170,                    /* IPNET  */
+  YYSYMBOL_COMMA = 171,                    /* COMMA  */
+  YYSYMBOL_SEMICOLON = 172,                /* SEMICOLON  */
+  YYSYMBOL_RPAREN = 173,                   /* RPAREN  */
+  YYSYMBOL_LPAREN = 174,                   /* LPAREN  */
+  YYSYMBOL_LBRACE = 175,                   /* LBRACE  */
+  YYSYMBOL_RBRACE = 176,                   /* RBRACE  */
+  YYSYMBOL_LBRACK = 177,                   /* LBRACK  */
+  YYSYMBOL_RBRACK = 178,                   /* RBRACK  */
+  YYSYMBOL_SLASH = 179,                    /* SLASH  */
+  YYSYMBOL_AS = 180,                       /* AS  */
+  YYSYMBOL_USE_WORKERS = 181,              /* USE_WORKERS  */
+  YYSYMBOL_USE_AUTO_SCALING_PROFILE = 182, /* USE_AUTO_SCALING_PROFILE  */
+  YYSYMBOL_MAX = 183,                      /* MAX  */
+  YYSYMBOL_MIN = 184,                      /* MIN  */
+  YYSYMBOL_DOT = 185,                      /* DOT  */
+  YYSYMBOL_CR = 186,                       /* CR  */
+  YYSYMBOL_COLON = 187,                    /* COLON  */
+  YYSYMBOL_ANY = 188,                      /* ANY  */
+  YYSYMBOL_ANYCAST = 189,                  /* ANYCAST  */
+  YYSYMBOL_SCRIPTVARERR = 190,             /* SCRIPTVARERR  */
+  YYSYMBOL_SCALE_UP_TO = 191,              /* SCALE_UP_TO  */
+  YYSYMBOL_SCALE_DOWN_TO = 192,            /* SCALE_DOWN_TO  */
+  YYSYMBOL_ON = 193,                       /* ON  */
+  YYSYMBOL_CYCLES = 194,                   /* CYCLES  */
+  YYSYMBOL_CYCLES_WITHIN = 195,            /* CYCLES_WITHIN  */
+  YYSYMBOL_PERCENTAGE = 196,               /* PERCENTAGE  */
+  YYSYMBOL_YYACCEPT = 197,                 /* $accept  */
+  YYSYMBOL_cfg = 198,                      /* cfg  */
+  YYSYMBOL_statements = 199,               /* statements  */
+  YYSYMBOL_statement = 200,                /* statement  */
+  YYSYMBOL_201_1 = 201,                    /* $@1  */
+  YYSYMBOL_202_2 = 202,                    /* $@2  */
+  YYSYMBOL_203_3 = 203,                    /* $@3  */
+  YYSYMBOL_204_4 = 204,                    /* $@4  */
+  YYSYMBOL_205_5 = 205,                    /* $@5  */
+  YYSYMBOL_206_6 = 206,                    /* $@6  */
+  YYSYMBOL_207_7 = 207,                    /* $@7  */
+  YYSYMBOL_208_8 = 208,                    /* $@8  */
+  YYSYMBOL_209_9 = 209,                    /* $@9  */
+  YYSYMBOL_listen_id = 210,                /* listen_id  */
+  YYSYMBOL_host_sep = 211,                 /* host_sep  */
+  YYSYMBOL_host = 212,                     /* host  */
+  YYSYMBOL_proto = 213,                    /* proto  */
+  YYSYMBOL_port = 214,                     /* port  */
+  YYSYMBOL_snumber = 215,                  /* snumber  */
+  YYSYMBOL_phostport = 216,                /* phostport  */
+  YYSYMBOL_panyhostport = 217,             /* panyhostport  */
+  YYSYMBOL_alias_def = 218,                /* alias_def  */
+  YYSYMBOL_id_lst = 219,                   /* id_lst  */
+  YYSYMBOL_listen_id_def = 220,            /* listen_id_def  */
+  YYSYMBOL_socket_def_param = 221,         /* socket_def_param  */
+  YYSYMBOL_socket_def_params = 222,        /* socket_def_params  */
+  YYSYMBOL_socket_def = 223,               /* socket_def  */
+  YYSYMBOL_224_10 = 224,                   /* $@10  */
+  YYSYMBOL_225_11 = 225,                   /* $@11  */
+  YYSYMBOL_any_proto = 226,                /* any_proto  */
+  YYSYMBOL_multi_string = 227,             /* multi_string  */
+  YYSYMBOL_blst_elem = 228,                /* blst_elem  */
+  YYSYMBOL_blst_elem_list = 229,           /* blst_elem_list  */
+  YYSYMBOL_auto_scale_profile_def = 230,   /* auto_scale_profile_def  */
+  YYSYMBOL_assign_stm = 231,               /* assign_stm  */
+  YYSYMBOL_module_stm = 232,               /* module_stm  */
+  YYSYMBOL_ip = 233,                       /* ip  */
+  YYSYMBOL_ipv4 = 234,                     /* ipv4  */
+  YYSYMBOL_ipv6addr = 235,                 /* ipv6addr  */
+  YYSYMBOL_ipv6 = 236,                     /* ipv6  */
+  YYSYMBOL_ipnet = 237,                    /* ipnet  */
+  YYSYMBOL_folded_string = 238,            /* folded_string  */
+  YYSYMBOL_route_name = 239,               /* route_name  */
+  YYSYMBOL_route_name_var = 240,           /* route_name_var  */
+  YYSYMBOL_route_stm = 241,                /* route_stm  */
+  YYSYMBOL_failure_route_stm = 242,        /* failure_route_stm  */
+  YYSYMBOL_onreply_route_stm = 243,        /* onreply_route_stm  */
+  YYSYMBOL_branch_route_stm = 244,         /* branch_route_stm  */
+  YYSYMBOL_error_route_stm = 245,          /* error_route_stm  */
+  YYSYMBOL_local_route_stm = 246,          /* local_route_stm  */
+  YYSYMBOL_startup_route_stm = 247,        /* startup_route_stm  */
+  YYSYMBOL_timer_route_stm = 248,          /* timer_route_stm  */
+  YYSYMBOL_event_route_stm = 249,          /* event_route_stm  */
+  YYSYMBOL_exp = 250,                      /* exp  */
+  YYSYMBOL_equalop = 251,                  /* equalop  */
+  YYSYMBOL_compop = 252,                   /* compop  */
+  YYSYMBOL_matchop = 253,                  /* matchop  */
+  YYSYMBOL_intop = 254,                    /* intop  */
+  YYSYMBOL_strop = 255,                    /* strop  */
+  YYSYMBOL_script_var = 256,               /* script_var  */
+  YYSYMBOL_exp_elem = 257,                 /* exp_elem  */
+  YYSYMBOL_exp_cond = 258,                 /* exp_cond  */
+  YYSYMBOL_assignop = 259,                 /* assignop  */
+  YYSYMBOL_assignexp = 260,                /* assignexp  */
+  YYSYMBOL_assign_cmd = 261,               /* assign_cmd  */
+  YYSYMBOL_exp_stm = 262,                  /* exp_stm  */
+  YYSYMBOL_brk_stm = 263,                  /* brk_stm  */
+  YYSYMBOL_stm = 264,                      /* stm  */
+  YYSYMBOL_actions = 265,                  /* actions  */
+  YYSYMBOL_brk_actions = 266,              /* brk_actions  */
+  YYSYMBOL_action = 267,                   /* action  */
+  YYSYMBOL_brk_action = 268,               /* brk_action  */
+  YYSYMBOL_brk_if_cmd = 269,               /* brk_if_cmd  */
+  YYSYMBOL_if_cmd = 270,                   /* if_cmd  */
+  YYSYMBOL_while_cmd = 271,                /* while_cmd  */
+  YYSYMBOL_foreach_cmd = 272,              /* foreach_cmd  */
+  YYSYMBOL_switch_cmd = 273,               /* switch_cmd  */
+  YYSYMBOL_switch_stm = 274,               /* switch_stm  */
+  YYSYMBOL_case_stms = 275,                /* case_stms  */
+  YYSYMBOL_case_stm = 276,                 /* case_stm  */
+  YYSYMBOL_default_stm = 277,              /* default_stm  */
+  YYSYMBOL_func_param = 278,               /* func_param  */
+  YYSYMBOL_route_param = 279,              /* route_param  */
+  YYSYMBOL_async_func = 280,               /* async_func  */
+  YYSYMBOL_cmd = 281                       /* cmd  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  222
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   2034
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  197
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  85
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  487
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  937
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   451
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_uint8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    76,    77,    78,    79,    80,    81,    82,    83,    84,
+      85,    86,    87,    88,    89,    90,    91,    92,    93,    94,
+      95,    96,    97,    98,    99,   100,   101,   102,   103,   104,
+     105,   106,   107,   108,   109,   110,   111,   112,   113,   114,
+     115,   116,   117,   118,   119,   120,   121,   122,   123,   124,
+     125,   126,   127,   128,   129,   130,   131,   132,   133,   134,
+     135,   136,   137,   138,   139,   140,   141,   142,   143,   144,
+     145,   146,   147,   148,   149,   150,   151,   152,   153,   154,
+     155,   156,   157,   158,   159,   160,   161,   162,   163,   164,
+     165,   166,   167,   168,   169,   170,   171,   172,   173,   174,
+     175,   176,   177,   178,   179,   180,   181,   182,   183,   184,
+     185,   186,   187,   188,   189,   190,   191,   192,   193,   194,
+     195,   196
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   492,   492,   495,   496,   497,   500,   501,   502,   502,
+     503,   503,   504,   504,   505,   505,   506,   506,   507,   507,
+     508,   508,   509,   509,   510,   510,   512,   515,   530,   539,
+     554,   555,   558,   559,   573,   578,   588,   589,   592,   593,
+     594,   598,   600,   602,   607,   613,   615,   619,   621,   623,
+     625,   629,   632,   633,   636,   638,   640,   646,   649,   652,
+     655,   658,   663,   664,   667,   668,   669,   669,   674,   674,
+     681,   682,   684,   685,   688,   696,   707,   708,   709,   713,
+     721,   729,   735,   743,   747,   748,   749,   750,   751,   755,
+     757,   760,   761,   765,   766,   772,   773,   774,   775,   776,
+     777,   778,   779,   780,   781,   782,   783,   784,   785,   786,
+     787,   788,   789,   790,   791,   792,   793,   794,   795,   796,
+     800,   801,   804,   808,   809,   810,   818,   826,   834,   842,
+     850,   858,   866,   874,   882,   890,   893,   894,   897,   898,
+     899,   900,   901,   902,   903,   904,   905,   906,   907,   908,
+     918,   919,   933,   934,   935,   936,   937,   938,   940,   941,
+     942,   943,   944,   945,   946,   947,   948,   949,   950,   951,
+     961,   971,   972,   975,   976,   979,   983,   984,   987,   988,
+     991,   992,   995,   996,   999,  1000,  1003,  1004,  1011,  1012,
+    1019,  1021,  1024,  1025,  1028,  1029,  1036,  1037,  1044,  1045,
+    1052,  1053,  1055,  1056,  1060,  1061,  1064,  1065,  1067,  1068,
+    1070,  1072,  1074,  1075,  1076,  1077,  1079,  1080,  1087,  1090,
+    1098,  1101,  1145,  1146,  1151,  1153,  1155,  1156,  1162,  1164,
+    1178,  1180,  1183,  1184,  1187,  1188,  1195,  1196,  1203,  1204,
+    1208,  1236,  1237,  1239,  1240,  1243,  1244,  1247,  1248,  1258,
+    1260,  1262,  1263,  1265,  1266,  1268,  1271,  1273,  1276,  1278,
+    1281,  1286,  1289,  1291,  1294,  1295,  1298,  1300,  1303,  1308,
+    1311,  1317,  1320,  1322,  1325,  1331,  1334,  1337,  1341,  1342,
+    1348,  1354,  1358,  1359,  1362,  1378,  1394,  1395,  1398,  1404,
+    1414,  1424,  1435,  1438,  1447,  1452,  1475,  1480,  1488,  1504,
+    1507,  1513,  1516,  1524,  1530,  1533,  1539,  1542,  1550,  1553,
+    1561,  1564,  1572,  1575,  1588,  1591,  1597,  1602,  1603,  1604,
+    1605,  1606,  1607,  1610,  1611,  1614,  1615,  1616,  1617,  1619,
+    1620,  1623,  1624,  1627,  1628,  1629,  1632,  1648,  1653,  1654,
+    1655,  1657,  1662,  1665,  1668,  1671,  1674,  1680,  1681,  1682,
+    1683,  1684,  1685,  1686,  1687,  1688,  1689,  1693,  1694,  1695,
+    1696,  1697,  1698,  1701,  1704,  1707,  1710,  1713,  1716,  1719,
+    1722,  1725,  1728,  1731,  1734,  1747,  1760,  1782,  1783,  1784,
+    1785,  1786,  1789,  1790,  1791,  1794,  1795,  1796,  1799,  1800,
+    1801,  1805,  1806,  1807,  1810,  1811,  1812,  1813,  1814,  1815,
+    1816,  1817,  1820,  1821,  1822,  1823,  1824,  1825,  1826,  1827,
+    1828,  1831,  1839,  1849,  1857,  1867,  1875,  1893,  1902,  1903,
+    1905,  1906,  1909,  1915,  1921,  1927,  1935,  1938,  1941,  1946,
+    1956,  1963,  1970,  1980,  1985,  1992,  2002,  2007,  2014,  2026,
+    2031,  2036,  2041,  2046,  2056,  2066,  2076,  2088,  2106,  2137,
+    2141,  2147,  2150,  2151,  2152,  2153,  2154,  2156,  2158,  2160,
+    2162,  2164,  2165,  2168,  2174,  2175,  2177,  2183,  2184,  2186,
+    2190,  2209,  2210,  2212,  2235,  2271,  2273,  2276,  2278,  2280,
+    2282,  2284,  2286,  2288,  2294,  2300,  2306,  2312
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "DROP", "ASSERT",
+  "EXIT", "RETURN", "LOG_TOK", "ERROR", "ROUTE", "ROUTE_FAILURE",
+  "ROUTE_ONREPLY", "ROUTE_BRANCH", "ROUTE_ERROR", "ROUTE_LOCAL",
+  "ROUTE_STARTUP", "ROUTE_TIMER", "ROUTE_EVENT", "IF", "ELSE", "SWITCH",
+  "CASE", "DEFAULT", "BREAK", "WHILE", "FOR", "IN", "NULLV", "XDBG",
+  "XLOG", "XLOG_BUF_SIZE", "XLOG_FORCE_COLOR", "XLOG_PRINT_LEVEL",
+  "XLOG_LEVEL", "PV_PRINT_BUF_SIZE", "DEBUG_MODE", "ENABLE_ASSERTS",
+  "ABORT_ON_ASSERT", "LOGLEVEL", "LOGSTDOUT", "LOGSTDERROR", "LOGFACILITY",
+  "LOGNAME", "AVP_ALIASES", "LISTEN", "SOCKET", "MEMGROUP", "ALIAS",
+  "AUTO_ALIASES", "TAG", "DNS", "REV_DNS", "DNS_TRY_IPV6", "DNS_TRY_NAPTR",
+  "DNS_RETR_TIME", "DNS_RETR_NO", "DNS_SERVERS_NO", "DNS_USE_SEARCH",
+  "MAX_WHILE_LOOPS", "UDP_WORKERS", "CHECK_VIA",
+  "SHM_HASH_SPLIT_PERCENTAGE", "SHM_SECONDARY_HASH_SIZE",
+  "MEM_WARMING_ENABLED", "MEM_WARMING_PATTERN_FILE",
+  "MEM_WARMING_PERCENTAGE", "RPM_MEM_FILE", "RPM_MEM_SIZE", "MEMLOG",
+  "MEMDUMP", "EXECMSGTHRESHOLD", "EXECDNSTHRESHOLD", "TCPTHRESHOLD",
+  "EVENT_SHM_THRESHOLD", "EVENT_PKG_THRESHOLD", "QUERYBUFFERSIZE",
+  "QUERYFLUSHTIME", "QUERYWRITERPROCESSES", "SIP_WARNING",
+  "SERVER_SIGNATURE", "SERVER_HEADER", "USER_AGENT_HEADER", "LOADMODULE",
+  "MPATH", "MODPARAM", "MAXBUFFER", "CHROOT", "WDIR", "MHOMED",
+  "POLL_METHOD", "TCP_ACCEPT_ALIASES", "TCP_WORKERS",
+  "TCP_HANDSHAKE_WORKERS", "TCP_CONNECT_TIMEOUT", "TCP_CON_LIFETIME",
+  "TCP_SOCKET_BACKLOG", "TCP_MAX_CONNECTIONS", "TCP_NO_NEW_CONN_BFLAG",
+  "TCP_NO_NEW_CONN_RPLFLAG", "TCP_KEEPALIVE", "TCP_KEEPCOUNT",
+  "TCP_KEEPIDLE", "TCP_KEEPINTERVAL", "TCP_MAX_MSG_TIME",
+  "ADVERTISED_ADDRESS", "ADVERTISED_PORT", "DISABLE_CORE", "OPEN_FD_LIMIT",
+  "MCAST_LOOPBACK", "MCAST_TTL", "TOS", "DISABLE_DNS_FAILOVER",
+  "DISABLE_DNS_BLACKLIST", "DST_BLACKLIST", "DISABLE_STATELESS_FWD",
+  "DB_VERSION_TABLE", "DB_DEFAULT_URL", "DB_MAX_ASYNC_CONNECTIONS",
+  "DB_ASYNC_EXECUTORS", "DB_PRELOAD_WORKERS", "IPC_QUEUE_SIZE",
+  "DISABLE_503_TRANSLATION", "SYNC_TOKEN", "ASYNC_TOKEN", "LAUNCH_TOKEN",
+  "AUTO_SCALING_PROFILE", "AUTO_SCALING_CYCLE", "AUTO_SCALING_POLICY",
+  "AUTO_SCALING_LATENCY", "AUTO_SCALING_SPARES", "AUTO_SCALING_QUEUE",
+  "TIMER_WORKERS", "EQUAL", "EQUAL_T", "GT", "LT", "GTE", "LTE", "DIFF",
+  "MATCH", "NOTMATCH", "COLONEQ", "PLUSEQ", "MINUSEQ", "SLASHEQ", "MULTEQ",
+  "MODULOEQ", "BANDEQ", "BOREQ", "BXOREQ", "OR", "AND", "BOR", "BAND",
+  "BXOR", "BLSHIFT", "BRSHIFT", "PLUS", "MINUS", "MULT", "MODULO", "NOT",
+  "BNOT", "NUMBER", "ZERO", "ID", "STRING", "SCRIPTVAR", "IPV6ADDR",
+  "IPV4ADDR", "IPNET", "COMMA", "SEMICOLON", "RPAREN", "LPAREN", "LBRACE",
+  "RBRACE", "LBRACK", "RBRACK", "SLASH", "AS", "USE_WORKERS",
+  "USE_AUTO_SCALING_PROFILE", "MAX", "MIN", "DOT", "CR", "COLON", "ANY",
+  "ANYCAST", "SCRIPTVARERR", "SCALE_UP_TO", "SCALE_DOWN_TO", "ON",
+  "CYCLES", "CYCLES_WITHIN", "PERCENTAGE", "$accept", "cfg", "statements",
+  "statement", "$@1", "$@2", "$@3", "$@4", "$@5", "$@6", "$@7", "$@8",
+  "$@9", "listen_id", "host_sep", "host", "proto", "port", "snumber",
+  "phostport", "panyhostport", "alias_def", "id_lst", "listen_id_def",
+  "socket_def_param", "socket_def_params", "socket_def", "$@10", "$@11",
+  "any_proto", "multi_string", "blst_elem", "blst_elem_list",
+  "auto_scale_profile_def", "assign_stm", "module_stm", "ip", "ipv4",
+  "ipv6addr", "ipv6", "ipnet", "folded_string", "route_name",
+  "route_name_var", "route_stm", "failure_route_stm", "onreply_route_stm",
+  "branch_route_stm", "error_route_stm", "local_route_stm",
+  "startup_route_stm", "timer_route_stm", "event_route_stm", "exp",
+  "equalop", "compop", "matchop", "intop", "strop", "script_var",
+  "exp_elem", "exp_cond", "assignop", "assignexp", "assign_cmd", "exp_stm",
+  "brk_stm", "stm", "actions", "brk_actions", "action", "brk_action",
+  "brk_if_cmd", "if_cmd", "while_cmd", "foreach_cmd", "switch_cmd",
+  "switch_stm", "case_stms", "case_stm", "default_stm", "func_param",
+  "route_param", "async_func", "cmd", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-792)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-427)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+    1848,   -91,   -69,   -63,   -39,   -26,   -11,    29,   196,   209,
+     214,   233,   245,   249,   257,   262,   310,   318,   399,   420,
+     442,   470,    28,    32,    41,   106,   339,   359,   483,   512,
+     515,   541,   553,   568,   579,   590,   591,   610,   611,   612,
+     617,   625,   642,   648,   652,   656,   667,   670,   681,   685,
+     689,   692,   112,   696,    53,   701,   705,   707,   709,   710,
+     714,   715,   725,   728,   732,   734,   741,   751,   754,   764,
+     780,   785,   789,   791,   796,   799,   813,   814,   816,   818,
+     822,   403,   421,   825,   830,   833,   834,   836,   840,   841,
+     843,   844,   854,   856,   857,   858,   859,   861,   863,  -792,
+     141,  1711,  -792,   416,   485,   498,   567,   607,   682,   738,
+     688,   739,  -792,  -792,  -792,   162,   166,   170,   225,   228,
+     240,   323,   331,   192,   333,   336,    59,   116,    80,    85,
+     653,   154,   355,   357,   363,  -792,   662,  -792,   680,  -792,
+     719,  -792,   753,  -792,   835,  -792,   839,   367,   375,   377,
+     385,   386,   391,   119,   406,   134,   407,   248,   325,   408,
+     422,   432,   434,   436,   446,   447,   450,   453,   464,   135,
+     136,  -792,  -792,   138,  -792,   678,   467,   118,   122,   477,
+     125,   478,   486,   488,   491,   492,   500,   524,    96,   131,
+     531,   532,   536,   549,   564,    67,   571,   572,   576,   582,
+     604,   150,  -792,   848,  -792,   850,   832,   852,   139,   142,
+     605,   613,   620,   624,   638,   151,   649,   144,   666,   669,
+     671,   868,  -792,   -91,  -792,    21,  -792,     3,  -792,    24,
+    -792,    11,  -792,     7,  -792,    42,  -792,    43,  -792,    18,
+    -792,    23,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,   869,
+     870,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,   998,  -792,   849,   589,   609,  -792,  -792,  -792,
+     851,  -792,   855,  -792,  -792,  -792,   853,   860,  -792,  -135,
+     865,  -792,  1117,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,   821,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+     864,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,   838,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+     872,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,   866,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,   862,
+    -792,  1543,    -7,  -792,    -7,  -792,  1543,    -7,  -792,    -7,
+    -792,  1543,  -792,  1543,  -792,  1543,  -792,    -7,  -792,    -7,
+    -792,  -792,  -792,  1446,   634,   634,   145,   878,   693,  -792,
+     156,   883,   693,  -792,   905,   877,   906,   897,   871,   909,
+     901,   903,   907,   711,    57,    60,    65,   908,   912,   913,
+     916,   917,   918,   919,   920,    79,  -792,  -792,  -792,  1516,
+     911,   583,  -792,  -792,  -792,  -792,  -792,   101,  -792,  -792,
+    -792,   923,   924,   628,   926,   927,   673,   712,   757,   945,
+     939,   892,   910,   930,   693,   955,   957,  -792,   634,  -792,
+    -792,  -792,   958,  -792,  -792,   940,  -792,  -792,  -792,   960,
+    -792,   -66,   933,  -792,   959,  1212,   962,   740,  -792,  -792,
+    -792,   123,  -792,   146,  -792,    26,  1212,   -42,  1212,   -42,
+     970,   971,   963,   963,  -792,    89,  1111,  1112,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,  -792,  1259,  -792,  -792,  -792,
+    -792,  -792,  -792,   965,   967,  -792,   972,   974,  -792,  -792,
+    -792,   987,   978,   -54,     9,  -792,   964,  -792,  -792,  -792,
+    -792,  -792,    31,   742,   980,   390,  -792,    14,   992,  -792,
+    1212,  1212,  1390,  1259,  -792,   575,  1849,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,  -792,   983,   988,   989,   990,   993,
+    1001,   994,  1004,  -792,  -126,  -792,   -23,  1012,   194,  1161,
+     -24,   427,   296,   565,    83,  1020,   293,  1023,  -792,  1015,
+    -792,  -792,  -792,   425,  -792,  -792,  1259,  -792,  1259,  -792,
+    1182,  -792,  1474,  -792,  1543,  1543,  1543,  1543,  1016,  1543,
+    -792,  -792,  -792,  -792,  -792,    52,  -792,  -792,  1027,  1029,
+     390,  -792,  -792,  1033,  -792,   -66,  -792,  1047,  -792,   268,
+    -792,   802,  1439,  1212,  1212,  1042,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -792,   344,   -68,  -792,   192,   -52,  -792,
+    -792,  -792,  -792,  1043,  -792,  1044,  -792,   502,  -792,  1435,
+    1037,  1305,   -42,  -792,  -792,  -792,  -792,  1048,  -792,  -792,
+    -792,   273,    -7,    -7,  -792,  -792,  -792,  -792,  -792,  1032,
+    -792,  -792,  1534,  1259,  1259,  1259,  1259,  1259,  1259,  1259,
+    1259,  1259,  1259,   847,   886,   931,   976,  1038,  1021,  -792,
+    -792,  -792,  -792,  1052,   750,  -792,  1199,  -792,  -792,  -792,
+    -792,  -792,  1053,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    1058,  1061,  -792,  -792,  -792,  -792,   472,  1480,  1214,  -792,
+    1216,  1064,  1063,  -792,  1334,  1067,  -792,  -792,  -792,  -792,
+    -792,  -792,   104,  1069,   581,   606,  1075,  -792,   513,   517,
+     621,  -792,  -792,  -792,  -792,   784,   784,   784,   784,   784,
+    -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  -792,  1543,
+    -792,   750,  1078,  1088,  -792,  -792,  -792,  1013,  -792,  -792,
+    1060,  1435,   795,  1080,   687,  -792,  1212,  -792,  -792,   499,
+    -792,  -792,  -792,  -792,  1305,  -792,  -792,  -792,  -792,  1094,
+    -792,  1092,  -792,  1105,  1089,   -54,   234,  -792,  -792,  -792,
+    -792,  -792,  -792,  1072,  1082,  -792,  1084,  -792,  -792,   276,
+    -792,  -792,  -792,  -792,  1100,  1101,  -792,   -54,  1104,  1086,
+    1113,  1512,  1512,  1512,  1305,  -792,  -792,  1108,  1118,  1130,
+    1106,   392,   452,   538,  1277,  1131,  1129,  1110,  1141,  1305,
+    1133,  -792,  1163,  1134,  -792,  -792,  1164,  1168,  1307,  1184,
+    1183,  1320,  1153,  1185,  -792,  1155,  -792
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int16 yydefact[] =
+{
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    26,
+       0,     0,     4,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     6,     7,   276,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,   103,     0,   105,     0,   107,
+       0,   109,     0,   111,     0,   113,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,   278,   277,     0,   281,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,   245,     0,   247,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     1,     5,     3,     0,     9,     0,    11,     0,
+      13,     0,    15,     0,    17,     0,    19,     0,    21,     0,
+      23,     0,    25,   212,   209,   213,   210,   214,   211,   216,
+     215,   208,   207,    89,    88,    85,    84,    87,    86,     0,
+       0,    38,    83,    91,    90,    93,    92,    95,    94,    97,
+      96,   220,     0,    35,     0,    65,    64,   219,   218,   217,
+       0,   224,    32,    28,   285,   284,     0,     0,    47,    29,
+       0,    51,    52,   223,    27,   282,   286,   283,   226,   225,
+      99,    98,   101,   100,   102,   104,   106,   108,   110,   112,
+     115,   114,   120,   118,   124,   123,   126,   125,   128,   127,
+     130,   129,   132,   131,   134,   133,   136,   135,   138,   137,
+     140,   139,   142,   141,   144,   143,   146,   145,   148,   147,
+     150,   149,   152,   151,   154,   153,   156,   155,   158,   157,
+     160,   159,   202,   201,   204,   203,   206,   205,   243,   242,
+       0,   117,   116,   163,   162,   161,   166,   165,   164,   168,
+     167,   171,   169,   170,   173,   172,   176,   174,   178,   177,
+     180,   179,   182,   181,   184,   183,   186,   185,   188,   187,
+     190,   189,   192,   191,   196,   195,   198,   197,   200,   199,
+     194,   193,   228,    32,   227,   230,   229,   232,   231,   234,
+     233,   236,   235,   238,   237,   241,   239,   240,   244,   246,
+       0,   249,   251,   250,   253,   252,   255,   254,   257,   256,
+     259,   258,   261,   260,   263,   262,   265,     0,   264,   267,
+     266,   269,   268,   271,   270,   273,   272,   275,   274,   121,
+     299,     0,     0,   301,     0,   304,     0,     0,   306,     0,
+     308,     0,   310,     0,   312,     0,   314,     0,   316,     0,
+      39,    40,    44,     0,     0,     0,     0,     0,     0,    31,
+       0,     0,     0,    53,     0,     0,     0,     0,     0,     0,
+     452,     0,   454,   461,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,   336,   400,   337,     0,
+       0,     0,   389,   395,   396,   397,   398,     0,   293,   292,
+     294,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    45,    41,     0,     0,     0,     0,    57,    62,    69,
+      67,   222,    72,   221,   287,    48,    34,    33,   119,     0,
+     175,     0,     0,   122,     0,     0,     0,     0,   458,   456,
+     464,     0,   467,     0,   471,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,   476,     0,   347,   348,   349,   350,
+     351,   352,   353,   354,   355,   356,     0,   399,   390,   297,
+     388,   401,   394,     0,     0,   302,     0,     0,   307,   309,
+     311,     0,     0,     0,     0,    60,    54,    59,    58,    61,
+      63,    73,     0,     0,     0,     0,    77,     0,     0,   453,
+       0,     0,     0,     0,   340,     0,   341,   322,   338,   379,
+     339,   378,   377,   455,   460,     0,     0,     0,     0,     0,
+       0,     0,     0,   295,     0,   296,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,   428,   430,
+     473,   433,   436,     0,   375,   376,     0,   358,     0,   357,
+     359,   360,   374,   361,     0,     0,     0,     0,     0,     0,
+      36,    37,    46,    43,    42,     0,    50,    49,     0,     0,
+       0,    70,    71,     0,    78,     0,   248,     0,   319,     0,
+     381,     0,     0,     0,     0,     0,   323,   325,   326,   327,
+     328,   324,   329,   330,   331,   332,   335,     0,     0,   459,
+     457,   465,   462,     0,   468,     0,   472,     0,   469,     0,
+       0,     0,     0,   290,   477,   291,   478,     0,   479,   480,
+     450,     0,     0,     0,   487,   475,   431,   434,   437,   432,
+     474,   372,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    56,
+      55,   279,   280,     0,     0,    76,     0,   320,   380,   321,
+     318,   317,     0,   345,   288,   289,   346,   344,   343,   342,
+       0,     0,   441,   439,   440,   442,     0,     0,   413,   385,
+       0,     0,     0,   409,     0,     0,   415,   382,   404,   405,
+     406,   407,     0,     0,     0,     0,     0,   447,     0,     0,
+       0,   429,   435,   438,   373,   368,   367,   369,   370,   371,
+     362,   363,   364,   366,   365,   298,   300,   303,   305,     0,
+     315,     0,     0,     0,   451,   463,   466,     0,   470,   387,
+       0,     0,     0,     0,   419,   421,     0,   402,   384,     0,
+     392,   408,   410,   403,     0,   481,   482,   449,   448,     0,
+     483,     0,   486,     0,     0,     0,     0,   446,   443,   444,
+     445,   386,   414,     0,     0,   417,     0,   420,   418,     0,
+     393,   383,   391,   416,     0,     0,   313,     0,     0,    82,
+       0,   425,   423,   427,     0,   484,   485,     0,     0,     0,
+      81,     0,     0,     0,   411,     0,     0,     0,     0,     0,
+       0,    74,     0,     0,   412,    75,     0,     0,     0,     0,
+       0,     0,     0,     0,    80,     0,    79
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -792,  -792,  -792,  1249,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -175,  -792,  -792,  -130,  -598,  -123,    46,
+    -792,  -792,  1059,  -792,  -792,  -444,  1224,  -792,  -792,   665,
+     819,   661,  -792,  -792,  -792,  -792,  -290,  -792,  1074,  -792,
+    -753,  -558,  -395,  -792,  -792,  -792,  -792,  -792,  -792,  -792,
+    -792,  -792,  -792,  -520,  -792,  -792,  -792,  -792,  -792,  -490,
+    -792,  -538,  -792,   828,  -529,  -792,  -775,   514,  -454,  -791,
+    -471,   105,  -792,  -517,   256,   342,   388,  -792,  -792,   510,
+    -792,   626,  -792,   793,  -550
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int16 yydefgoto[] =
+{
+       0,   100,   101,   102,   103,   104,   105,   106,   107,   108,
+     109,   110,   111,   288,   481,   289,   274,   682,   669,   275,
+     276,   292,   293,   607,   538,   539,   277,   475,   474,   693,
+     543,   616,   617,   438,   112,   113,   294,   295,   296,   297,
+     786,   651,   521,   644,   226,   228,   230,   232,   234,   236,
+     238,   240,   242,   625,   714,   715,   716,   717,   718,   509,
+     627,   671,   586,   672,   510,   630,   806,   798,   511,   859,
+     512,   807,   808,   513,   514,   515,   516,   853,   854,   855,
+     888,   663,   796,   655,   517
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+     262,   290,   523,   559,   453,   632,   684,   526,   460,   527,
+     683,   528,   458,   653,   687,   694,   632,   628,   632,   466,
+     404,   842,   450,   479,   468,   455,   629,   642,   628,   135,
+     628,   540,   686,   137,   331,   333,   673,   629,   631,   629,
+     590,   114,   139,   462,   464,   727,   646,   728,   648,   631,
+     480,   631,   590,   769,   174,   590,   590,   590,   560,   522,
+     267,   562,   524,   115,   525,   626,   564,   636,   402,   116,
+     632,   632,   529,   673,   530,   645,   626,   647,   626,   649,
+     574,   271,   628,   628,   740,   662,   278,   770,   874,   893,
+     657,   629,   629,   117,   610,   614,   670,   388,  -334,  -334,
+     698,   699,   591,   631,   631,   862,   118,   141,   615,   680,
+     911,   912,   913,   171,   788,   506,   673,   269,   673,   363,
+     322,   119,  -334,   366,   637,   506,   371,   703,   704,   914,
+     626,   626,   390,   670,   681,   326,   354,   356,   508,   358,
+     422,   222,   733,   424,   924,   441,   541,   640,   508,   734,
+     729,   415,   436,   632,   632,   281,   518,   546,   519,   520,
+     136,   120,   290,   243,   138,   628,   628,   245,   701,   748,
+     643,   247,   680,   140,   629,   629,   670,   291,   670,   815,
+     454,   812,   461,   780,   781,   695,   631,   631,   459,   518,
+     696,   519,   520,   506,   680,   467,   451,   681,   452,   456,
+     469,   457,   805,   673,   673,   673,   673,   673,   673,   673,
+     673,   673,   673,   626,   626,   680,   508,   463,   465,   681,
+     763,   764,   765,   766,   268,   768,   249,   175,   789,   251,
+     590,   561,   403,   283,   563,   284,   285,   795,   142,   565,
+     681,   253,   813,   272,   286,   273,   259,   260,   272,   330,
+     273,   662,   261,   575,   812,   658,   506,   741,   799,   823,
+     659,   389,   660,   670,   670,   670,   670,   670,   670,   670,
+     670,   670,   670,   592,   816,   805,   863,   898,   172,   508,
+     259,   260,   270,   364,   365,   323,   261,   367,   368,   638,
+     372,   373,   590,   590,   590,   590,   391,   590,   532,   907,
+     327,   355,   357,   545,   359,   423,   632,   532,   425,   812,
+     442,   542,   641,   416,   812,   417,   437,   272,   628,   282,
+     283,   -30,   284,   285,   255,   244,   332,   629,   121,   246,
+     805,   286,   257,   248,   263,   805,   889,   265,   291,   631,
+     143,   122,   287,   850,   703,   704,   123,   819,   820,   259,
+     260,   812,   812,   812,   812,   261,   298,   880,   300,   606,
+     145,   812,   812,   812,   302,   124,   626,   731,   310,   812,
+     558,   783,   805,   805,   805,   805,   312,   125,   314,   590,
+     799,   126,   805,   805,   805,   873,   316,   318,   250,   127,
+     805,   252,   320,   890,   128,   490,   491,   492,   493,   494,
+     495,   496,   590,   254,   202,   259,   260,   324,   328,   334,
+     801,   261,   498,  -424,  -424,   802,   499,   500,   703,   704,
+     501,   502,   204,   336,   785,   225,   703,   704,   899,   900,
+     259,   260,   624,   338,   635,   340,   261,   342,   639,   658,
+     506,   777,   129,   624,   659,   624,   817,   344,   346,   904,
+     130,   348,   661,   890,   350,   490,   491,   492,   493,   494,
+     495,   496,   733,   508,   743,   352,   744,   737,   361,   738,
+     801,   144,   498,  -422,  -422,   802,   499,   500,   369,   374,
+     501,   502,   259,   260,   785,   692,   256,   376,   261,   378,
+     689,   146,   380,   382,   258,   227,   264,   624,   624,   266,
+     890,   384,   490,   491,   492,   493,   494,   495,   496,   229,
+    -333,  -333,   284,   285,   784,   503,   504,   801,   299,   498,
+     301,   286,   802,   499,   500,   386,   303,   501,   502,   792,
+     311,   131,   392,   394,  -333,   203,   747,   396,   313,   890,
+     315,   490,   491,   492,   493,   494,   495,   496,   317,   319,
+     398,   785,   132,   205,   321,   273,   801,   505,   498,   506,
+     692,   802,   499,   500,   803,   400,   501,   502,  -424,   325,
+     329,   335,   405,   407,   133,   503,   504,   409,   691,   231,
+     624,   624,   508,   411,   588,   337,   490,   491,   492,   493,
+     494,   495,   496,   735,   787,   339,   749,   341,   750,   343,
+     736,   497,   134,   498,   794,   413,   426,   499,   500,   345,
+     347,   501,   502,   349,   428,   147,   351,   505,   661,   506,
+     233,   430,   503,   504,   803,   432,   822,   353,  -422,   588,
+     362,   490,   491,   492,   493,   494,   495,   496,   -68,   434,
+     370,   375,   508,   847,   148,   848,   497,   149,   498,   377,
+     439,   379,   499,   500,   381,   383,   501,   502,   -66,   259,
+     260,   503,   504,   385,   505,   261,   506,   443,   793,   506,
+     445,   803,   447,   150,   588,   891,   490,   491,   492,   493,
+     494,   495,   496,   533,   749,   151,   868,   387,   869,   508,
+     870,   497,   508,   498,   393,   395,   235,   499,   500,   397,
+     152,   501,   502,   505,   239,   506,   503,   504,   852,   886,
+     803,   153,   399,   588,  -426,   490,   491,   492,   493,   494,
+     495,   496,   154,   155,   879,   703,   704,   401,   508,   884,
+     497,   735,   498,   624,   406,   408,   499,   500,   739,   410,
+     501,   502,   156,   157,   158,   412,   705,   733,   505,   159,
+     506,   503,   504,   237,   865,   507,   241,   160,   588,   589,
+     490,   491,   492,   493,   494,   495,   496,   414,   427,   -68,
+     -68,   -68,   735,   508,   161,   497,   429,   498,   -68,   866,
+     162,   499,   500,   431,   163,   501,   502,   433,   164,   -66,
+     -66,   -66,   871,   505,   872,   506,   503,   504,   -66,   165,
+     507,   435,   166,   588,   595,   490,   491,   492,   493,   494,
+     495,   496,   440,   167,   534,   535,   536,   168,   508,   280,
+     497,   169,   498,   537,   170,   304,   499,   500,   173,   444,
+     501,   502,   446,   176,   448,   503,   504,   177,   505,   178,
+     506,   179,   180,   305,   360,   507,   181,   182,   588,   598,
+     490,   491,   492,   493,   494,   495,   496,   183,   403,   283,
+     184,   284,   285,   508,   185,   497,   186,   498,   259,   260,
+     286,   499,   500,   187,   261,   501,   502,   505,   506,   506,
+     503,   504,   306,   188,   507,   557,   189,   588,   599,   490,
+     491,   492,   493,   494,   495,   496,   190,   259,   260,   259,
+     260,   508,   508,   261,   497,   261,   498,   506,   688,   860,
+     499,   500,   191,   634,   501,   502,   307,   192,   284,   285,
+     784,   193,   505,   194,   506,   503,   504,   286,   195,   507,
+     508,   196,   588,   600,   490,   491,   492,   493,   494,   495,
+     496,   758,   759,   760,   761,   197,   198,   508,   199,   497,
+     200,   498,   259,   260,   201,   499,   500,   206,   261,   501,
+     502,   883,   207,   762,   892,   208,   209,   505,   210,   506,
+     503,   504,   211,   212,   507,   213,   214,   588,   778,   490,
+     491,   492,   493,   494,   495,   496,   215,   809,   216,   217,
+     218,   219,   508,   220,   497,   221,   498,   420,   308,   472,
+     499,   500,   309,   484,   501,   502,   860,   860,   860,   503,
+     504,   418,   505,   419,   506,   421,   892,   892,   892,   507,
+     486,   284,   588,   835,   490,   491,   492,   493,   494,   495,
+     496,   449,   470,   471,   552,   485,   473,   508,   476,   497,
+     877,   498,   -35,   549,   489,   499,   500,   478,   547,   501,
+     502,   505,   482,   506,   503,   504,   544,   488,   507,   487,
+     809,   588,   836,   490,   491,   492,   493,   494,   495,   496,
+     548,   550,   551,   810,   553,   554,   508,   555,   497,   603,
+     498,   556,   566,   587,   499,   500,   567,   568,   501,   502,
+     569,   570,   571,   572,   573,   605,   505,   604,   506,   503,
+     504,   593,   594,   507,   596,   597,   588,   837,   490,   491,
+     492,   493,   494,   495,   496,   809,   601,   602,   608,   811,
+     809,   508,   609,   497,   542,   498,   618,   612,   654,   499,
+     500,   613,   619,   501,   502,   633,   650,   652,   664,   665,
+     674,   505,   675,   506,   503,   504,   810,   676,   507,   677,
+     678,   685,   838,   679,   690,   697,   719,   809,   809,   809,
+     809,   720,   721,   722,   723,   725,   508,   809,   809,   809,
+     259,   260,   259,   260,   724,   809,   261,   726,   261,   878,
+     506,   746,   506,   503,   504,   730,   505,   732,   506,   259,
+     260,   742,   811,   507,   767,   261,   745,   840,   821,   506,
+     771,   810,   772,   508,   774,   508,   810,   776,   782,   790,
+     791,   508,   800,   839,   814,   490,   491,   492,   493,   494,
+     495,   496,   508,   841,   843,   505,   844,   506,   503,   504,
+     497,   845,   507,   851,   846,   857,   881,   852,   856,   861,
+     501,   502,   864,   810,   810,   810,   810,   811,   867,   875,
+     508,   876,   811,   810,   810,   810,   885,   894,   895,   901,
+     897,   810,   490,   491,   492,   493,   494,   495,   496,   902,
+     505,   903,   506,   905,   906,   908,   910,   507,   909,   915,
+     272,   896,   282,   283,   916,   284,   285,   501,   502,   811,
+     811,   811,   811,   917,   286,   508,   919,   920,   918,   811,
+     811,   811,   921,   922,   923,   287,   925,   811,   490,   491,
+     492,   493,   494,   495,   496,   706,   707,   708,   709,   710,
+     711,   712,   713,   801,   928,   498,   926,   927,   802,   499,
+     500,   929,   930,   501,   502,   503,   504,   490,   491,   492,
+     493,   494,   495,   496,   931,   933,   932,   934,   935,   936,
+     224,   483,   801,   279,   498,   773,   775,   802,   499,   500,
+     477,   611,   501,   502,   887,   882,   656,   818,     0,   259,
+     260,     0,     0,   620,     0,   261,     0,   505,     0,   506,
+       0,     0,   503,   504,     0,     0,   621,   622,     0,   623,
+       0,     0,     0,   490,   491,   492,   493,   494,   495,   496,
+       0,     0,   508,     0,     0,     0,     0,     0,   497,     0,
+     498,     0,     0,     0,   499,   500,   259,   260,   501,   502,
+       0,   666,   261,     0,   505,   667,   506,     0,   503,   504,
+       0,     0,     0,   668,     0,     0,     0,     0,   490,   491,
+     492,   493,   494,   495,   496,     0,     0,     0,     0,   508,
+       0,   702,     0,   497,     0,   498,     0,   503,   504,   499,
+     500,     0,     0,   501,   502,     0,     0,     0,     0,     0,
+     505,     0,   506,     0,     0,     0,     0,   803,     0,     0,
+     804,     0,     0,   490,   491,   492,   493,   494,   495,   496,
+       0,     0,     0,     0,   751,   508,   752,     0,   497,   505,
+     498,   506,     0,     0,   499,   500,   803,     0,   501,   502,
+     858,     0,     0,   503,   504,   490,   491,   492,   493,   494,
+     495,   496,     0,     0,   508,     0,     0,     0,     0,     0,
+     801,     0,   498,     0,     0,   802,   499,   500,     0,     0,
+     501,   502,     0,     0,     0,     0,   490,   491,   492,   493,
+     494,   495,   496,     0,     0,   505,     0,   506,   503,   504,
+       0,   497,   507,   498,     0,     0,   700,   499,   500,     0,
+       0,   501,   502,     0,     0,     0,     0,     0,     0,     0,
+     508,   825,   826,   827,   828,   829,   830,   831,   832,   833,
+     834,   753,   754,   755,   756,   757,   758,   759,   760,   761,
+     505,     0,   506,   503,   504,   531,     0,   507,     0,     0,
+     797,   403,   283,     0,   284,   285,     0,   779,   762,     0,
+       0,     0,     0,   286,     0,   508,   753,   754,   755,   756,
+     757,   758,   759,   760,   761,   503,   504,     0,     0,     0,
+       0,     0,     0,     0,     0,   505,     0,   506,   576,     0,
+       0,     0,   507,   762,     0,     0,   849,   577,   578,   579,
+     580,   581,   582,   583,   584,   585,   503,   504,     0,     0,
+     508,     0,     0,     0,     0,     0,     0,   505,     0,   506,
+       0,     0,     0,     0,   803,     0,   753,   754,   755,   756,
+     757,   758,   759,   760,   761,     0,     0,     0,     0,     0,
+       0,     0,   508,     0,     0,     0,     0,   824,   505,     0,
+     506,    -2,   223,   762,     0,   507,     0,     0,     0,     0,
+      -8,   -10,   -12,   -14,   -16,   -18,   -20,   -22,   -24,     0,
+       0,     0,     0,   508,     0,     0,     0,     0,     0,     0,
+       0,     2,     3,     4,     5,     6,     7,     8,     9,    10,
+      11,    12,    13,    14,     0,    15,    16,    17,    18,    19,
+       0,    20,    21,    22,    23,    24,    25,    26,    27,    28,
+      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
+      49,    50,    51,    52,    53,    54,    55,    56,    57,    58,
+      59,    60,    61,    62,    63,    64,    65,    66,    67,    68,
+      69,    70,    71,    72,    73,    74,    75,    76,    77,    78,
+      79,    80,    81,    82,    83,    84,    85,    86,    87,    88,
+      89,    90,    91,     0,     0,     0,    92,    93,    94,    95,
+      96,    97,    98,     0,     0,     0,     0,     0,     0,     1,
+       0,     0,     0,     0,     0,     0,     0,    -8,   -10,   -12,
+     -14,   -16,   -18,   -20,   -22,   -24,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     2,     3,
+       4,     5,     6,     7,     8,     9,    10,    11,    12,    13,
+      14,     0,    15,    16,    17,    18,    19,    99,    20,    21,
+      22,    23,    24,    25,    26,    27,    28,    29,    30,    31,
+      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    58,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    76,    77,    78,    79,    80,    81,
+      82,    83,    84,    85,    86,    87,    88,    89,    90,    91,
+       0,     0,     0,    92,    93,    94,    95,    96,    97,    98,
+       0,   576,   706,   707,   708,   709,   710,   711,   712,   713,
+     577,   578,   579,   580,   581,   582,   583,   584,   585,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,    99
+};
+
+static const yytype_int16 yycheck[] =
+{
+     123,   131,   456,   493,     1,   555,   604,   461,     1,   463,
+       1,   465,     1,   571,   612,     1,   566,   555,   568,     1,
+     195,   774,     1,   158,     1,     1,   555,     1,   566,     1,
+     568,   475,     1,     1,   157,   158,   586,   566,   555,   568,
+     511,   132,     1,     1,     1,   171,   566,   173,   568,   566,
+     185,   568,   523,     1,     1,   526,   527,   528,     1,   454,
+       1,     1,   457,   132,   459,   555,     1,   557,     1,   132,
+     620,   621,   467,   623,   469,   565,   566,   567,   568,   569,
+       1,     1,   620,   621,     1,   575,     1,   685,   841,   864,
+       1,   620,   621,   132,   538,   161,   586,     1,   166,   167,
+     620,   621,     1,   620,   621,     1,   132,     1,   174,   163,
+     901,   902,   903,     1,   166,   167,   666,     1,   668,     1,
+       1,   132,   190,     1,     1,   167,     1,   150,   151,   904,
+     620,   621,     1,   623,   188,     1,     1,     1,   190,     1,
+       1,     0,   166,     1,   919,     1,     1,     1,   190,   173,
+     173,     1,     1,   703,   704,     1,   163,     1,   165,   166,
+     132,   132,   292,     1,   132,   703,   704,     1,   622,   659,
+     565,     1,   163,   132,   703,   704,   666,   131,   668,   737,
+     177,   731,   175,   703,   704,   171,   703,   704,   177,   163,
+     176,   165,   166,   167,   163,   177,   175,   188,   177,   175,
+     177,   177,   731,   753,   754,   755,   756,   757,   758,   759,
+     760,   761,   762,   703,   704,   163,   190,   175,   175,   188,
+     674,   675,   676,   677,   165,   679,     1,   174,   718,     1,
+     701,   174,   165,   166,   174,   168,   169,   727,   132,   174,
+     188,     1,   732,   163,   177,   165,   157,   158,   163,     1,
+     165,   741,   163,   174,   804,   166,   167,   174,   729,   749,
+     171,   165,   173,   753,   754,   755,   756,   757,   758,   759,
+     760,   761,   762,   172,     1,   804,   172,   875,   166,   190,
+     157,   158,   166,   165,   166,   166,   163,   165,   166,   166,
+     165,   166,   763,   764,   765,   766,   165,   768,   473,   897,
+     166,   166,   166,   478,   166,   166,   856,   482,   166,   859,
+     166,   166,   166,   163,   864,   165,   165,   163,   856,   165,
+     166,   165,   168,   169,     1,   163,     1,   856,   132,   163,
+     859,   177,     1,   163,     1,   864,   856,     1,   292,   856,
+       1,   132,   188,   797,   150,   151,   132,   742,   743,   157,
+     158,   901,   902,   903,   904,   163,     1,   847,     1,   534,
+       1,   911,   912,   913,     1,   132,   856,   173,     1,   919,
+     493,    27,   901,   902,   903,   904,     1,   132,     1,   850,
+     851,   132,   911,   912,   913,   839,     1,     1,   163,   132,
+     919,   163,     1,     1,   132,     3,     4,     5,     6,     7,
+       8,     9,   873,   163,     1,   157,   158,     1,     1,     1,
+      18,   163,    20,    21,    22,    23,    24,    25,   150,   151,
+      28,    29,     1,     1,   714,     9,   150,   151,   194,   195,
+     157,   158,   555,     1,   557,     1,   163,     1,   561,   166,
+     167,   173,   132,   566,   171,   568,   173,     1,     1,   173,
+     132,     1,   575,     1,     1,     3,     4,     5,     6,     7,
+       8,     9,   166,   190,   171,     1,   173,   171,     1,   173,
+      18,   132,    20,    21,    22,    23,    24,    25,     1,     1,
+      28,    29,   157,   158,   774,   615,   163,     1,   163,     1,
+     613,   132,     1,     1,   163,    10,   163,   620,   621,   163,
+       1,     1,     3,     4,     5,     6,     7,     8,     9,    11,
+     166,   167,   168,   169,   170,   123,   124,    18,   163,    20,
+     163,   177,    23,    24,    25,     1,   163,    28,    29,    27,
+     163,   132,     1,     1,   190,   132,   659,     1,   163,     1,
+     163,     3,     4,     5,     6,     7,     8,     9,   163,   163,
+       1,   841,   132,   132,   163,   165,    18,   165,    20,   167,
+     690,    23,    24,    25,   172,     1,    28,    29,   176,   163,
+     163,   163,     1,     1,   132,   123,   124,     1,   188,    12,
+     703,   704,   190,     1,     1,   163,     3,     4,     5,     6,
+       7,     8,     9,   166,   717,   163,   171,   163,   173,   163,
+     173,    18,   132,    20,   727,     1,     1,    24,    25,   163,
+     163,    28,    29,   163,     1,   132,   163,   165,   741,   167,
+      13,     1,   123,   124,   172,     1,   749,   163,   176,     1,
+     163,     3,     4,     5,     6,     7,     8,     9,    49,     1,
+     163,   163,   190,   171,   132,   173,    18,   132,    20,   163,
+       1,   163,    24,    25,   163,   163,    28,    29,    49,   157,
+     158,   123,   124,   163,   165,   163,   167,     1,   166,   167,
+       1,   172,     1,   132,     1,   176,     3,     4,     5,     6,
+       7,     8,     9,    49,   171,   132,   173,   163,   171,   190,
+     173,    18,   190,    20,   163,   163,    14,    24,    25,   163,
+     132,    28,    29,   165,    16,   167,   123,   124,    21,    22,
+     172,   132,   163,     1,   176,     3,     4,     5,     6,     7,
+       8,     9,   132,   132,   847,   150,   151,   163,   190,   852,
+      18,   166,    20,   856,   163,   163,    24,    25,   173,   163,
+      28,    29,   132,   132,   132,   163,   171,   166,   165,   132,
+     167,   123,   124,    15,   173,   172,    17,   132,     1,   176,
+       3,     4,     5,     6,     7,     8,     9,   163,   163,   180,
+     181,   182,   166,   190,   132,    18,   163,    20,   189,   173,
+     132,    24,    25,   163,   132,    28,    29,   163,   132,   180,
+     181,   182,   171,   165,   173,   167,   123,   124,   189,   132,
+     172,   163,   132,     1,   176,     3,     4,     5,     6,     7,
+       8,     9,   163,   132,   180,   181,   182,   132,   190,   166,
+      18,   132,    20,   189,   132,   163,    24,    25,   132,   163,
+      28,    29,   163,   132,   163,   123,   124,   132,   165,   132,
+     167,   132,   132,   163,   166,   172,   132,   132,     1,   176,
+       3,     4,     5,     6,     7,     8,     9,   132,   165,   166,
+     132,   168,   169,   190,   132,    18,   132,    20,   157,   158,
+     177,    24,    25,   132,   163,    28,    29,   165,   167,   167,
+     123,   124,   163,   132,   172,   174,   132,     1,   176,     3,
+       4,     5,     6,     7,     8,     9,   132,   157,   158,   157,
+     158,   190,   190,   163,    18,   163,    20,   167,   166,   804,
+      24,    25,   132,   173,    28,    29,   163,   132,   168,   169,
+     170,   132,   165,   132,   167,   123,   124,   177,   132,   172,
+     190,   132,     1,   176,     3,     4,     5,     6,     7,     8,
+       9,   157,   158,   159,   160,   132,   132,   190,   132,    18,
+     132,    20,   157,   158,   132,    24,    25,   132,   163,    28,
+      29,   166,   132,   179,   859,   132,   132,   165,   132,   167,
+     123,   124,   132,   132,   172,   132,   132,     1,   176,     3,
+       4,     5,     6,     7,     8,     9,   132,   731,   132,   132,
+     132,   132,   190,   132,    18,   132,    20,   165,   163,     1,
+      24,    25,   163,   182,    28,    29,   901,   902,   903,   123,
+     124,   163,   165,   163,   167,   163,   911,   912,   913,   172,
+     182,   168,     1,   176,     3,     4,     5,     6,     7,     8,
+       9,   163,   163,   163,   163,   171,   187,   190,   187,    18,
+      27,    20,   187,   166,   182,    24,    25,   187,   165,    28,
+      29,   165,   187,   167,   123,   124,   178,   191,   172,   187,
+     804,     1,   176,     3,     4,     5,     6,     7,     8,     9,
+     165,   165,   175,   731,   165,   174,   190,   174,    18,   187,
+      20,   174,   174,   172,    24,    25,   174,   174,    28,    29,
+     174,   174,   174,   174,   174,   165,   165,   187,   167,   123,
+     124,   178,   178,   172,   178,   178,     1,   176,     3,     4,
+       5,     6,     7,     8,     9,   859,   171,   178,   163,   731,
+     864,   190,   165,    18,   166,    20,   193,   187,   165,    24,
+      25,   171,   173,    28,    29,   173,   166,   166,    27,    27,
+     175,   165,   175,   167,   123,   124,   804,   175,   172,   175,
+     163,   187,   176,   175,   174,   163,   173,   901,   902,   903,
+     904,   173,   173,   173,   171,   171,   190,   911,   912,   913,
+     157,   158,   157,   158,   173,   919,   163,   173,   163,   166,
+     167,   166,   167,   123,   124,   173,   165,    26,   167,   157,
+     158,   171,   804,   172,   178,   163,   173,   176,   166,   167,
+     173,   859,   173,   190,   171,   190,   864,   160,   166,   166,
+     166,   190,   175,   175,   166,     3,     4,     5,     6,     7,
+       8,     9,   190,   171,    25,   165,   173,   167,   123,   124,
+      18,   173,   172,    19,   173,   172,   176,    21,   174,   172,
+      28,    29,   173,   901,   902,   903,   904,   859,   173,   171,
+     190,   163,   864,   911,   912,   913,   176,   163,   166,   187,
+     171,   919,     3,     4,     5,     6,     7,     8,     9,   187,
+     165,   187,   167,   173,   173,   171,   163,   172,   192,   171,
+     163,   176,   165,   166,   166,   168,   169,    28,    29,   901,
+     902,   903,   904,   163,   177,   190,    19,   166,   192,   911,
+     912,   913,   173,   193,   163,   188,   173,   919,     3,     4,
+       5,     6,     7,     8,     9,   133,   134,   135,   136,   137,
+     138,   139,   140,    18,   160,    20,   163,   193,    23,    24,
+      25,   163,    25,    28,    29,   123,   124,     3,     4,     5,
+       6,     7,     8,     9,   160,    25,   163,   194,   163,   194,
+     101,   292,    18,   129,    20,   690,   695,    23,    24,    25,
+     286,   542,    28,    29,   854,   851,   573,   741,    -1,   157,
+     158,    -1,    -1,   161,    -1,   163,    -1,   165,    -1,   167,
+      -1,    -1,   123,   124,    -1,    -1,   174,   175,    -1,   177,
+      -1,    -1,    -1,     3,     4,     5,     6,     7,     8,     9,
+      -1,    -1,   190,    -1,    -1,    -1,    -1,    -1,    18,    -1,
+      20,    -1,    -1,    -1,    24,    25,   157,   158,    28,    29,
+      -1,   162,   163,    -1,   165,   166,   167,    -1,   123,   124,
+      -1,    -1,    -1,   174,    -1,    -1,    -1,    -1,     3,     4,
+       5,     6,     7,     8,     9,    -1,    -1,    -1,    -1,   190,
+      -1,   623,    -1,    18,    -1,    20,    -1,   123,   124,    24,
+      25,    -1,    -1,    28,    29,    -1,    -1,    -1,    -1,    -1,
+     165,    -1,   167,    -1,    -1,    -1,    -1,   172,    -1,    -1,
+     175,    -1,    -1,     3,     4,     5,     6,     7,     8,     9,
+      -1,    -1,    -1,    -1,   666,   190,   668,    -1,    18,   165,
+      20,   167,    -1,    -1,    24,    25,   172,    -1,    28,    29,
+     176,    -1,    -1,   123,   124,     3,     4,     5,     6,     7,
+       8,     9,    -1,    -1,   190,    -1,    -1,    -1,    -1,    -1,
+      18,    -1,    20,    -1,    -1,    23,    24,    25,    -1,    -1,
+      28,    29,    -1,    -1,    -1,    -1,     3,     4,     5,     6,
+       7,     8,     9,    -1,    -1,   165,    -1,   167,   123,   124,
+      -1,    18,   172,    20,    -1,    -1,   176,    24,    25,    -1,
+      -1,    28,    29,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+     190,   753,   754,   755,   756,   757,   758,   759,   760,   761,
+     762,   152,   153,   154,   155,   156,   157,   158,   159,   160,
+     165,    -1,   167,   123,   124,   159,    -1,   172,    -1,    -1,
+     175,   165,   166,    -1,   168,   169,    -1,   178,   179,    -1,
+      -1,    -1,    -1,   177,    -1,   190,   152,   153,   154,   155,
+     156,   157,   158,   159,   160,   123,   124,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,   165,    -1,   167,   132,    -1,
+      -1,    -1,   172,   179,    -1,    -1,   176,   141,   142,   143,
+     144,   145,   146,   147,   148,   149,   123,   124,    -1,    -1,
+     190,    -1,    -1,    -1,    -1,    -1,    -1,   165,    -1,   167,
+      -1,    -1,    -1,    -1,   172,    -1,   152,   153,   154,   155,
+     156,   157,   158,   159,   160,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,   190,    -1,    -1,    -1,    -1,   173,   165,    -1,
+     167,     0,     1,   179,    -1,   172,    -1,    -1,    -1,    -1,
+       9,    10,    11,    12,    13,    14,    15,    16,    17,    -1,
+      -1,    -1,    -1,   190,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,    40,    41,    42,    -1,    44,    45,    46,    47,    48,
+      -1,    50,    51,    52,    53,    54,    55,    56,    57,    58,
+      59,    60,    61,    62,    63,    64,    65,    66,    67,    68,
+      69,    70,    71,    72,    73,    74,    75,    76,    77,    78,
+      79,    80,    81,    82,    83,    84,    85,    86,    87,    88,
+      89,    90,    91,    92,    93,    94,    95,    96,    97,    98,
+      99,   100,   101,   102,   103,   104,   105,   106,   107,   108,
+     109,   110,   111,   112,   113,   114,   115,   116,   117,   118,
+     119,   120,   121,    -1,    -1,    -1,   125,   126,   127,   128,
+     129,   130,   131,    -1,    -1,    -1,    -1,    -1,    -1,     1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,     9,    10,    11,
+      12,    13,    14,    15,    16,    17,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    30,    31,
+      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    -1,    44,    45,    46,    47,    48,   186,    50,    51,
+      52,    53,    54,    55,    56,    57,    58,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    76,    77,    78,    79,    80,    81,
+      82,    83,    84,    85,    86,    87,    88,    89,    90,    91,
+      92,    93,    94,    95,    96,    97,    98,    99,   100,   101,
+     102,   103,   104,   105,   106,   107,   108,   109,   110,   111,
+     112,   113,   114,   115,   116,   117,   118,   119,   120,   121,
+      -1,    -1,    -1,   125,   126,   127,   128,   129,   130,   131,
+      -1,   132,   133,   134,   135,   136,   137,   138,   139,   140,
+     141,   142,   143,   144,   145,   146,   147,   148,   149,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,   186
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int16 yystos[] =
+{
+       0,     1,    30,    31,    32,    33,    34,    35,    36,    37,
+      38,    39,    40,    41,    42,    44,    45,    46,    47,    48,
+      50,    51,    52,    53,    54,    55,    56,    57,    58,    59,
+      60,    61,    62,    63,    64,    65,    66,    67,    68,    69,
+      70,    71,    72,    73,    74,    75,    76,    77,    78,    79,
+      80,    81,    82,    83,    84,    85,    86,    87,    88,    89,
+      90,    91,    92,    93,    94,    95,    96,    97,    98,    99,
+     100,   101,   102,   103,   104,   105,   106,   107,   108,   109,
+     110,   111,   112,   113,   114,   115,   116,   117,   118,   119,
+     120,   121,   125,   126,   127,   128,   129,   130,   131,   186,
+     198,   199,   200,   201,   202,   203,   204,   205,   206,   207,
+     208,   209,   231,   232,   132,   132,   132,   132,   132,   132,
+     132,   132,   132,   132,   132,   132,   132,   132,   132,   132,
+     132,   132,   132,   132,   132,     1,   132,     1,   132,     1,
+     132,     1,   132,     1,   132,     1,   132,   132,   132,   132,
+     132,   132,   132,   132,   132,   132,   132,   132,   132,   132,
+     132,   132,   132,   132,   132,   132,   132,   132,   132,   132,
+     132,     1,   166,   132,     1,   174,   132,   132,   132,   132,
+     132,   132,   132,   132,   132,   132,   132,   132,   132,   132,
+     132,   132,   132,   132,   132,   132,   132,   132,   132,   132,
+     132,   132,     1,   132,     1,   132,   132,   132,   132,   132,
+     132,   132,   132,   132,   132,   132,   132,   132,   132,   132,
+     132,   132,     0,     1,   200,     9,   241,    10,   242,    11,
+     243,    12,   244,    13,   245,    14,   246,    15,   247,    16,
+     248,    17,   249,     1,   163,     1,   163,     1,   163,     1,
+     163,     1,   163,     1,   163,     1,   163,     1,   163,   157,
+     158,   163,   215,     1,   163,     1,   163,     1,   165,     1,
+     166,     1,   163,   165,   213,   216,   217,   223,     1,   223,
+     166,     1,   165,   166,   168,   169,   177,   188,   210,   212,
+     213,   216,   218,   219,   233,   234,   235,   236,     1,   163,
+       1,   163,     1,   163,   163,   163,   163,   163,   163,   163,
+       1,   163,     1,   163,     1,   163,     1,   163,     1,   163,
+       1,   163,     1,   166,     1,   163,     1,   166,     1,   163,
+       1,   215,     1,   215,     1,   163,     1,   163,     1,   163,
+       1,   163,     1,   163,     1,   163,     1,   163,     1,   163,
+       1,   163,     1,   163,     1,   166,     1,   166,     1,   166,
+     166,     1,   163,     1,   165,   166,     1,   165,   166,     1,
+     163,     1,   165,   166,     1,   163,     1,   163,     1,   163,
+       1,   163,     1,   163,     1,   163,     1,   163,     1,   165,
+       1,   165,     1,   163,     1,   163,     1,   163,     1,   163,
+       1,   163,     1,   165,   210,     1,   163,     1,   163,     1,
+     163,     1,   163,     1,   163,     1,   163,   165,   163,   163,
+     165,   163,     1,   166,     1,   166,     1,   163,     1,   163,
+       1,   163,     1,   163,     1,   163,     1,   165,   230,     1,
+     163,     1,   166,     1,   163,     1,   163,     1,   163,   163,
+       1,   175,   177,     1,   177,     1,   175,   177,     1,   177,
+       1,   175,     1,   175,     1,   175,     1,   177,     1,   177,
+     163,   163,     1,   187,   225,   224,   187,   235,   187,   158,
+     185,   211,   187,   219,   182,   171,   182,   187,   191,   182,
+       3,     4,     5,     6,     7,     8,     9,    18,    20,    24,
+      25,    28,    29,   123,   124,   165,   167,   172,   190,   256,
+     261,   265,   267,   270,   271,   272,   273,   281,   163,   165,
+     166,   239,   239,   265,   239,   239,   265,   265,   265,   239,
+     239,   159,   210,    49,   180,   181,   182,   189,   221,   222,
+     222,     1,   166,   227,   178,   210,     1,   165,   165,   166,
+     165,   175,   163,   165,   174,   174,   174,   174,   215,   256,
+       1,   174,     1,   174,     1,   174,   174,   174,   174,   174,
+     174,   174,   174,   174,     1,   174,   132,   141,   142,   143,
+     144,   145,   146,   147,   148,   149,   259,   172,     1,   176,
+     267,     1,   172,   178,   178,   176,   178,   178,   176,   176,
+     176,   171,   178,   187,   187,   165,   210,   220,   163,   165,
+     222,   227,   187,   171,   161,   174,   228,   229,   193,   173,
+     161,   174,   175,   177,   215,   250,   256,   257,   258,   261,
+     262,   270,   281,   173,   173,   215,   256,     1,   166,   215,
+       1,   166,     1,   239,   240,   256,   250,   256,   250,   256,
+     166,   238,   166,   238,   165,   280,   280,     1,   166,   171,
+     173,   215,   256,   278,    27,    27,   162,   166,   174,   215,
+     256,   258,   260,   281,   175,   175,   175,   175,   163,   175,
+     163,   188,   214,     1,   214,   187,     1,   214,   166,   215,
+     174,   188,   213,   226,     1,   171,   176,   163,   250,   250,
+     176,   265,   260,   150,   151,   171,   133,   134,   135,   136,
+     137,   138,   139,   140,   251,   252,   253,   254,   255,   173,
+     173,   173,   173,   171,   173,   171,   173,   171,   173,   173,
+     173,   173,    26,   166,   173,   166,   173,   171,   173,   173,
+       1,   174,   171,   171,   173,   173,   166,   215,   256,   171,
+     173,   260,   260,   152,   153,   154,   155,   156,   157,   158,
+     159,   160,   179,   265,   265,   265,   265,   178,   265,     1,
+     214,   173,   173,   226,   171,   228,   160,   173,   176,   178,
+     250,   250,   166,    27,   170,   233,   237,   215,   166,   256,
+     166,   166,    27,   166,   215,   256,   279,   175,   264,   267,
+     175,    18,    23,   172,   175,   261,   263,   268,   269,   271,
+     272,   273,   281,   256,   166,   238,     1,   173,   278,   239,
+     239,   166,   215,   256,   173,   260,   260,   260,   260,   260,
+     260,   260,   260,   260,   260,   176,   176,   176,   176,   175,
+     176,   171,   237,    25,   173,   173,   173,   171,   173,   176,
+     265,    19,    21,   274,   275,   276,   174,   172,   176,   266,
+     268,   172,     1,   172,   173,   173,   173,   173,   173,   171,
+     173,   171,   173,   265,   237,   171,   163,    27,   166,   215,
+     256,   176,   264,   166,   215,   176,    22,   276,   277,   250,
+       1,   176,   268,   263,   163,   166,   176,   171,   214,   194,
+     195,   187,   187,   187,   173,   173,   173,   214,   171,   192,
+     163,   266,   266,   266,   263,   171,   166,   163,   192,    19,
+     166,   173,   193,   163,   263,   173,   163,   193,   160,   163,
+      25,   160,   163,    25,   194,   163,   194
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int16 yyr1[] =
+{
+       0,   197,   198,   199,   199,   199,   200,   200,   201,   200,
+     202,   200,   203,   200,   204,   200,   205,   200,   206,   200,
+     207,   200,   208,   200,   209,   200,   200,   210,   210,   210,
+     211,   211,   212,   212,   212,   213,   214,   214,   215,   215,
+     215,   216,   216,   216,   216,   217,   217,   218,   218,   218,
+     218,   218,   219,   219,   220,   220,   220,   221,   221,   221,
+     221,   221,   222,   222,   223,   223,   224,   223,   225,   223,
+     226,   226,   227,   227,   228,   228,   229,   229,   229,   230,
+     230,   230,   230,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   231,   231,   231,
+     231,   231,   231,   231,   231,   231,   231,   232,   232,   232,
+     232,   232,   233,   233,   234,   235,   236,   236,   237,   237,
+     238,   238,   239,   239,   239,   240,   240,   241,   241,   241,
+     242,   242,   243,   243,   243,   244,   244,   245,   245,   246,
+     246,   247,   247,   248,   248,   249,   249,   250,   250,   250,
+     250,   250,   250,   251,   251,   252,   252,   252,   252,   253,
+     253,   254,   254,   255,   255,   255,   256,   256,   257,   257,
+     257,   257,   258,   258,   258,   258,   258,   259,   259,   259,
+     259,   259,   259,   259,   259,   259,   259,   260,   260,   260,
+     260,   260,   260,   260,   260,   260,   260,   260,   260,   260,
+     260,   260,   260,   260,   261,   261,   261,   262,   262,   262,
+     262,   262,   263,   263,   263,   264,   264,   264,   265,   265,
+     265,   266,   266,   266,   267,   267,   267,   267,   267,   267,
+     267,   267,   268,   268,   268,   268,   268,   268,   268,   268,
+     268,   269,   269,   270,   270,   271,   272,   273,   274,   274,
+     275,   275,   276,   276,   276,   276,   277,   277,   278,   278,
+     278,   278,   278,   278,   278,   278,   278,   278,   278,   279,
+     279,   279,   279,   279,   279,   279,   279,   280,   280,   280,
+     280,   281,   281,   281,   281,   281,   281,   281,   281,   281,
+     281,   281,   281,   281,   281,   281,   281,   281,   281,   281,
+     281,   281,   281,   281,   281,   281,   281,   281,   281,   281,
+     281,   281,   281,   281,   281,   281,   281,   281
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     2,     1,     2,     1,     1,     0,     2,
+       0,     2,     0,     2,     0,     2,     0,     2,     0,     2,
+       0,     2,     0,     2,     0,     2,     1,     1,     1,     1,
+       1,     1,     1,     3,     3,     1,     1,     1,     1,     2,
+       2,     3,     5,     5,     2,     3,     5,     1,     3,     5,
+       5,     1,     1,     2,     1,     3,     3,     1,     2,     2,
+       2,     2,     1,     2,     1,     1,     0,     3,     0,     3,
+       1,     1,     1,     2,     9,    10,     3,     1,     2,    18,
+      17,    10,     9,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     2,     3,     2,     3,     2,     3,     2,
+       3,     2,     3,     2,     3,     3,     3,     3,     3,     5,
+       3,     3,     5,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     5,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     5,     5,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     2,     3,     2,     7,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     2,     2,     2,     8,
+       8,     2,     1,     1,     1,     1,     1,     3,     1,     1,
+       2,     2,     1,     1,     1,     1,     1,     4,     7,     2,
+       7,     2,     4,     7,     2,     7,     2,     4,     2,     4,
+       2,     4,     2,     9,     2,     7,     2,     3,     3,     2,
+       3,     3,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     3,     3,     3,     3,     3,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     2,     3,     3,     3,     3,     1,     1,     1,
+       3,     2,     1,     3,     2,     1,     3,     2,     2,     1,
+       2,     2,     1,     2,     2,     1,     1,     1,     1,     2,
+       1,     2,     2,     2,     1,     1,     1,     1,     2,     1,
+       2,     5,     7,     5,     7,     5,     7,     7,     2,     1,
+       2,     1,     4,     3,     4,     3,     3,     2,     1,     3,
+       1,     2,     2,     1,     2,     3,     1,     2,     3,     1,
+       1,     1,     1,     3,     3,     3,     3,     3,     4,     4,
+       2,     6,     1,     3,     1,     3,     2,     4,     2,     4,
+       3,     1,     4,     6,     2,     4,     6,     2,     4,     4,
+       6,     2,     4,     3,     4,     4,     2,     4,     4,     4,
+       4,     6,     6,     6,     8,     8,     6,     4
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+{
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 3: /* statements: statements statement  */
+#line 495 "cfg.y"
+                                     {}
+#line 2401 "cfg.tab.c"
+    break;
+
+  case 4: /* statements: statement  */
+#line 496 "cfg.y"
+                            {}
+#line 2407 "cfg.tab.c"
+    break;
+
+  case 5: /* statements: statements error  */
+#line 497 "cfg.y"
+                                   { yyerror(""); YYABORT;}
+#line 2413 "cfg.tab.c"
+    break;
+
+  case 8: /* $@1: %empty  */
+#line 502 "cfg.y"
+                  {rt=REQUEST_ROUTE;}
+#line 2419 "cfg.tab.c"
+    break;
+
+  case 10: /* $@2: %empty  */
+#line 503 "cfg.y"
+                  {rt=FAILURE_ROUTE;}
+#line 2425 "cfg.tab.c"
+    break;
+
+  case 12: /* $@3: %empty  */
+#line 504 "cfg.y"
+                  {rt=ONREPLY_ROUTE;}
+#line 2431 "cfg.tab.c"
+    break;
+
+  case 14: /* $@4: %empty  */
+#line 505 "cfg.y"
+                  {rt=BRANCH_ROUTE;}
+#line 2437 "cfg.tab.c"
+    break;
+
+  case 16: /* $@5: %empty  */
+#line 506 "cfg.y"
+                  {rt=ERROR_ROUTE;}
+#line 2443 "cfg.tab.c"
+    break;
+
+  case 18: /* $@6: %empty  */
+#line 507 "cfg.y"
+                  {rt=LOCAL_ROUTE;}
+#line 2449 "cfg.tab.c"
+    break;
+
+  case 20: /* $@7: %empty  */
+#line 508 "cfg.y"
+                  {rt=STARTUP_ROUTE;}
+#line 2455 "cfg.tab.c"
+    break;
+
+  case 22: /* $@8: %empty  */
+#line 509 "cfg.y"
+                  {rt=TIMER_ROUTE;}
+#line 2461 "cfg.tab.c"
+    break;
+
+  case 24: /* $@9: %empty  */
+#line 510 "cfg.y"
+                  {rt=EVENT_ROUTE;}
+#line 2467 "cfg.tab.c"
+    break;
+
+  case 27: /* listen_id: ip  */
+#line 515 "cfg.y"
+                                        { IFOR();
+							tmp=ip_addr2a((yyvsp[0].ipaddr));
+							if(tmp==0){
+								LM_CRIT("cfg. parser: bad ip address.\n");
+								(yyval.strval)=0;
+							}else{
+								(yyval.strval)=pkg_malloc(strlen(tmp)+1);
+								if ((yyval.strval)==0){
+									LM_CRIT("cfg. parser: out of memory.\n");
+									YYABORT;
+								}else{
+									memcpy((yyval.strval), tmp, strlen(tmp)+1);
+								}
+							}
+						}
+#line 2487 "cfg.tab.c"
+    break;
+
+  case 28: /* listen_id: STRING  */
+#line 530 "cfg.y"
+                                        { IFOR();
+							(yyval.strval)=pkg_malloc(strlen((yyvsp[0].strval))+1);
+							if ((yyval.strval)==0){
+									LM_CRIT("cfg. parser: out of memory.\n");
+									YYABORT;
+							}else{
+									memcpy((yyval.strval), (yyvsp[0].strval), strlen((yyvsp[0].strval))+1);
+							}
+						}
+#line 2501 "cfg.tab.c"
+    break;
+
+  case 29: /* listen_id: host  */
+#line 539 "cfg.y"
+                                        { IFOR();
+							if ((yyvsp[0].strval)==0) {
+								(yyval.strval) = 0;
+							} else {
+								(yyval.strval)=pkg_malloc(strlen((yyvsp[0].strval))+1);
+								if ((yyval.strval)==0){
+									LM_CRIT("cfg. parser: out of memory.\n");
+									YYABORT;
+								}else{
+									memcpy((yyval.strval), (yyvsp[0].strval), strlen((yyvsp[0].strval))+1);
+								}
+							}
+						}
+#line 2519 "cfg.tab.c"
+    break;
+
+  case 30: /* host_sep: DOT  */
+#line 554 "cfg.y"
+                    {(yyval.strval)=".";}
+#line 2525 "cfg.tab.c"
+    break;
+
+  case 31: /* host_sep: MINUS  */
+#line 555 "cfg.y"
+                              {(yyval.strval)="-"; }
+#line 2531 "cfg.tab.c"
+    break;
+
+  case 32: /* host: ID  */
+#line 558 "cfg.y"
+                                        { (yyval.strval)=(yyvsp[0].strval); }
+#line 2537 "cfg.tab.c"
+    break;
+
+  case 33: /* host: host host_sep ID  */
+#line 559 "cfg.y"
+                                { IFOR();
+						(yyval.strval)=(char*)pkg_malloc(strlen((yyvsp[-2].strval))+1+strlen((yyvsp[0].strval))+1);
+						if ((yyval.strval)==0){
+							LM_CRIT("cfg. parser: memory allocation"
+										" failure while parsing host\n");
+							YYABORT;
+						}else{
+							memcpy((yyval.strval), (yyvsp[-2].strval), strlen((yyvsp[-2].strval)));
+							(yyval.strval)[strlen((yyvsp[-2].strval))]=*(yyvsp[-1].strval);
+							memcpy((yyval.strval)+strlen((yyvsp[-2].strval))+1, (yyvsp[0].strval), strlen((yyvsp[0].strval)));
+							(yyval.strval)[strlen((yyvsp[-2].strval))+1+strlen((yyvsp[0].strval))]=0;
+						}
+						pkg_free((yyvsp[-2].strval)); pkg_free((yyvsp[0].strval));
+					}
+#line 2556 "cfg.tab.c"
+    break;
+
+  case 34: /* host: host DOT error  */
+#line 573 "cfg.y"
+                         { (yyval.strval)=0; pkg_free((yyvsp[-2].strval));
+					yyerror("invalid hostname (use quotes if hostname "
+						"has config keywords)"); }
+#line 2564 "cfg.tab.c"
+    break;
+
+  case 35: /* proto: ID  */
+#line 578 "cfg.y"
+           { IFOR();
+		if (parse_proto((unsigned char *)(yyvsp[0].strval), strlen((yyvsp[0].strval)), &i_tmp) < 0) {
+			yyerrorf("cannot handle protocol <%s>\n", (yyvsp[0].strval));
+			YYABORT;
+		}
+		pkg_free((yyvsp[0].strval));
+		(yyval.intval) = i_tmp;
+	 }
+#line 2577 "cfg.tab.c"
+    break;
+
+  case 36: /* port: NUMBER  */
+#line 588 "cfg.y"
+                        { (yyval.intval)=(yyvsp[0].intval); }
+#line 2583 "cfg.tab.c"
+    break;
+
+  case 37: /* port: ANY  */
+#line 589 "cfg.y"
+                                { (yyval.intval)=0; }
+#line 2589 "cfg.tab.c"
+    break;
+
+  case 38: /* snumber: NUMBER  */
+#line 592 "cfg.y"
+                        { (yyval.intval)=(yyvsp[0].intval); }
+#line 2595 "cfg.tab.c"
+    break;
+
+  case 39: /* snumber: PLUS NUMBER  */
+#line 593 "cfg.y"
+                                { (yyval.intval)=(yyvsp[0].intval); }
+#line 2601 "cfg.tab.c"
+    break;
+
+  case 40: /* snumber: MINUS NUMBER  */
+#line 594 "cfg.y"
+                                { (yyval.intval)=-(yyvsp[0].intval); }
+#line 2607 "cfg.tab.c"
+    break;
+
+  case 41: /* phostport: proto COLON listen_id  */
+#line 598 "cfg.y"
+                                        { IFOR();
+				(yyval.sockid)=mk_listen_id((yyvsp[0].strval), (yyvsp[-2].intval), 0); }
+#line 2614 "cfg.tab.c"
+    break;
+
+  case 42: /* phostport: proto COLON listen_id COLON port  */
+#line 600 "cfg.y"
+                                                                { IFOR();
+				(yyval.sockid)=mk_listen_id((yyvsp[-2].strval), (yyvsp[-4].intval), (yyvsp[0].intval));}
+#line 2621 "cfg.tab.c"
+    break;
+
+  case 43: /* phostport: proto COLON listen_id COLON error  */
+#line 602 "cfg.y"
+                                                            {
+				(yyval.sockid)=0;
+				yyerror("port number expected");
+				YYABORT;
+				}
+#line 2631 "cfg.tab.c"
+    break;
+
+  case 44: /* phostport: NUMBER error  */
+#line 607 "cfg.y"
+                                       { (yyval.sockid)=0;
+				yyerror("protocol expected");
+				YYABORT;
+			}
+#line 2640 "cfg.tab.c"
+    break;
+
+  case 45: /* panyhostport: proto COLON MULT  */
+#line 613 "cfg.y"
+                                                        { IFOR();
+				(yyval.sockid)=mk_listen_id(0, (yyvsp[-2].intval), 0); }
+#line 2647 "cfg.tab.c"
+    break;
+
+  case 46: /* panyhostport: proto COLON MULT COLON port  */
+#line 615 "cfg.y"
+                                                        { IFOR();
+				(yyval.sockid)=mk_listen_id(0, (yyvsp[-4].intval), (yyvsp[0].intval)); }
+#line 2654 "cfg.tab.c"
+    break;
+
+  case 47: /* alias_def: listen_id  */
+#line 619 "cfg.y"
+                                                                        { IFOR();
+				(yyval.sockid)=mk_listen_id((yyvsp[0].strval), PROTO_NONE, 0); }
+#line 2661 "cfg.tab.c"
+    break;
+
+  case 48: /* alias_def: ANY COLON listen_id  */
+#line 621 "cfg.y"
+                                                                        { IFOR();
+		 		(yyval.sockid)=mk_listen_id((yyvsp[0].strval), PROTO_NONE, 0); }
+#line 2668 "cfg.tab.c"
+    break;
+
+  case 49: /* alias_def: ANY COLON listen_id COLON port  */
+#line 623 "cfg.y"
+                                                        { IFOR();
+		 		(yyval.sockid)=mk_listen_id((yyvsp[-2].strval), PROTO_NONE, (yyvsp[0].intval)); }
+#line 2675 "cfg.tab.c"
+    break;
+
+  case 50: /* alias_def: ANY COLON listen_id COLON error  */
+#line 625 "cfg.y"
+                                                        {
+				(yyval.sockid)=0;
+				yyerror(" port number expected");
+				}
+#line 2684 "cfg.tab.c"
+    break;
+
+  case 52: /* id_lst: alias_def  */
+#line 632 "cfg.y"
+                                        { IFOR();  (yyval.sockid)=(yyvsp[0].sockid) ; }
+#line 2690 "cfg.tab.c"
+    break;
+
+  case 53: /* id_lst: alias_def id_lst  */
+#line 633 "cfg.y"
+                                        { IFOR(); (yyval.sockid)=(yyvsp[-1].sockid); (yyval.sockid)->next=(yyvsp[0].sockid); }
+#line 2696 "cfg.tab.c"
+    break;
+
+  case 54: /* listen_id_def: listen_id  */
+#line 636 "cfg.y"
+                                                                { IFOR();
+					(yyval.sockid)=mk_listen_id((yyvsp[0].strval), PROTO_NONE, 0); }
+#line 2703 "cfg.tab.c"
+    break;
+
+  case 55: /* listen_id_def: listen_id COLON port  */
+#line 638 "cfg.y"
+                                                                { IFOR();
+			 		(yyval.sockid)=mk_listen_id((yyvsp[-2].strval), PROTO_NONE, (yyvsp[0].intval)); }
+#line 2710 "cfg.tab.c"
+    break;
+
+  case 56: /* listen_id_def: listen_id COLON error  */
+#line 640 "cfg.y"
+                                                      {
+					(yyval.sockid)=0;
+					yyerror(" port number expected");
+					}
+#line 2719 "cfg.tab.c"
+    break;
+
+  case 57: /* socket_def_param: ANYCAST  */
+#line 646 "cfg.y"
+                          { IFOR();
+					p_tmp.flags |= SI_IS_ANYCAST;
+					}
+#line 2727 "cfg.tab.c"
+    break;
+
+  case 58: /* socket_def_param: USE_WORKERS NUMBER  */
+#line 649 "cfg.y"
+                                                     { IFOR();
+					p_tmp.workers=(yyvsp[0].intval);
+					}
+#line 2735 "cfg.tab.c"
+    break;
+
+  case 59: /* socket_def_param: AS listen_id_def  */
+#line 652 "cfg.y"
+                                                   { IFOR();
+					p_tmp.socket = (yyvsp[0].sockid);
+					}
+#line 2743 "cfg.tab.c"
+    break;
+
+  case 60: /* socket_def_param: TAG ID  */
+#line 655 "cfg.y"
+                                         { IFOR();
+					p_tmp.tag = (yyvsp[0].strval);
+					}
+#line 2751 "cfg.tab.c"
+    break;
+
+  case 61: /* socket_def_param: USE_AUTO_SCALING_PROFILE ID  */
+#line 658 "cfg.y"
+                                                              { IFOR();
+					p_tmp.auto_scaling_profile=(yyvsp[0].strval);
+					}
+#line 2759 "cfg.tab.c"
+    break;
+
+  case 64: /* socket_def: panyhostport  */
+#line 667 "cfg.y"
+                                                { (yyval.sockid)=(yyvsp[0].sockid); }
+#line 2765 "cfg.tab.c"
+    break;
+
+  case 65: /* socket_def: phostport  */
+#line 668 "cfg.y"
+                                                                { (yyval.sockid)=(yyvsp[0].sockid); }
+#line 2771 "cfg.tab.c"
+    break;
+
+  case 66: /* $@10: %empty  */
+#line 669 "cfg.y"
+                                       { IFOR();
+					memset(&p_tmp, 0, sizeof(p_tmp));
+				}
+#line 2779 "cfg.tab.c"
+    break;
+
+  case 67: /* socket_def: panyhostport $@10 socket_def_params  */
+#line 671 "cfg.y"
+                                                        { IFOR();
+					(yyval.sockid)=(yyvsp[-2].sockid); fill_socket_id(&p_tmp, (yyval.sockid));
+				}
+#line 2787 "cfg.tab.c"
+    break;
+
+  case 68: /* $@11: %empty  */
+#line 674 "cfg.y"
+                                    { IFOR();
+					memset(&p_tmp, 0, sizeof(p_tmp));
+				}
+#line 2795 "cfg.tab.c"
+    break;
+
+  case 69: /* socket_def: phostport $@11 socket_def_params  */
+#line 676 "cfg.y"
+                                                        { IFOR();
+					(yyval.sockid)=(yyvsp[-2].sockid); fill_socket_id(&p_tmp, (yyval.sockid));
+				}
+#line 2803 "cfg.tab.c"
+    break;
+
+  case 70: /* any_proto: ANY  */
+#line 681 "cfg.y"
+                        { (yyval.intval)=PROTO_NONE; }
+#line 2809 "cfg.tab.c"
+    break;
+
+  case 71: /* any_proto: proto  */
+#line 682 "cfg.y"
+                                { (yyval.intval)=(yyvsp[0].intval); }
+#line 2815 "cfg.tab.c"
+    break;
+
+  case 72: /* multi_string: STRING  */
+#line 684 "cfg.y"
+                       {  IFOR(); (yyval.multistr)=new_string((yyvsp[0].strval)); }
+#line 2821 "cfg.tab.c"
+    break;
+
+  case 73: /* multi_string: STRING multi_string  */
+#line 685 "cfg.y"
+                                      { IFOR(); (yyval.multistr)=new_string((yyvsp[-1].strval)); (yyval.multistr)->next=(yyvsp[0].multistr); }
+#line 2827 "cfg.tab.c"
+    break;
+
+  case 74: /* blst_elem: LPAREN any_proto COMMA ipnet COMMA port COMMA STRING RPAREN  */
+#line 688 "cfg.y"
+                                                                        {
+				IFOR(pkg_free((yyvsp[-5].ipnet)));
+				s_tmp.s=(yyvsp[-1].strval);
+				s_tmp.len=strlen((yyvsp[-1].strval));
+				if (add_rule_to_list(&bl_head,&bl_tail,(yyvsp[-5].ipnet),&s_tmp,(yyvsp[-3].intval),(yyvsp[-7].intval),0)) {
+					yyerror("failed to add backlist element\n");YYABORT;
+				}
+			}
+#line 2840 "cfg.tab.c"
+    break;
+
+  case 75: /* blst_elem: NOT LPAREN any_proto COMMA ipnet COMMA port COMMA STRING RPAREN  */
+#line 696 "cfg.y"
+                                                                                    {
+				IFOR(pkg_free((yyvsp[-5].ipnet)));
+				s_tmp.s=(yyvsp[-1].strval);
+				s_tmp.len=strlen((yyvsp[-1].strval));
+				if (add_rule_to_list(&bl_head,&bl_tail,(yyvsp[-5].ipnet),&s_tmp,
+				(yyvsp[-3].intval),(yyvsp[-7].intval),BLR_APPLY_CONTRARY)) {
+					yyerror("failed to add backlist element\n");YYABORT;
+				}
+			}
+#line 2854 "cfg.tab.c"
+    break;
+
+  case 76: /* blst_elem_list: blst_elem_list COMMA blst_elem  */
+#line 707 "cfg.y"
+                                               {}
+#line 2860 "cfg.tab.c"
+    break;
+
+  case 77: /* blst_elem_list: blst_elem  */
+#line 708 "cfg.y"
+                            {}
+#line 2866 "cfg.tab.c"
+    break;
+
+  case 78: /* blst_elem_list: blst_elem_list error  */
+#line 709 "cfg.y"
+                                       { yyerror("bad black list element");}
+#line 2872 "cfg.tab.c"
+    break;
+
+  case 79: /* auto_scale_profile_def: ID SCALE_UP_TO NUMBER ON NUMBER MODULO FOR NUMBER CYCLES_WITHIN NUMBER SCALE_DOWN_TO NUMBER ON NUMBER MODULO FOR NUMBER CYCLES  */
+#line 716 "cfg.y"
+                                              { IFOR();
+			if (create_auto_scaling_profile((yyvsp[-17].strval),(yyvsp[-15].intval),(yyvsp[-13].intval),(yyvsp[-10].intval),(yyvsp[-8].intval),
+			(yyvsp[-6].intval), (yyvsp[-4].intval), (yyvsp[-1].intval),10*(yyvsp[-1].intval))<0)
+				yyerror("failed to create auto scaling profile");
+		 }
+#line 2882 "cfg.tab.c"
+    break;
+
+  case 80: /* auto_scale_profile_def: ID SCALE_UP_TO NUMBER ON NUMBER MODULO FOR NUMBER CYCLES SCALE_DOWN_TO NUMBER ON NUMBER MODULO FOR NUMBER CYCLES  */
+#line 724 "cfg.y"
+                                              { IFOR();
+			if (create_auto_scaling_profile((yyvsp[-16].strval),(yyvsp[-14].intval),(yyvsp[-12].intval),(yyvsp[-9].intval),(yyvsp[-9].intval),
+			(yyvsp[-6].intval), (yyvsp[-4].intval), (yyvsp[-1].intval), 10*(yyvsp[-1].intval))<0)
+				yyerror("failed to create auto scaling profile");
+		 }
+#line 2892 "cfg.tab.c"
+    break;
+
+  case 81: /* auto_scale_profile_def: ID SCALE_UP_TO NUMBER ON NUMBER MODULO FOR NUMBER CYCLES_WITHIN NUMBER  */
+#line 730 "cfg.y"
+                                                            { IFOR();
+			if (create_auto_scaling_profile((yyvsp[-9].strval),(yyvsp[-7].intval),(yyvsp[-5].intval),(yyvsp[-2].intval),(yyvsp[0].intval),
+			0, 0, 0, 0)<0)
+				yyerror("failed to create auto scaling profile");
+		}
+#line 2902 "cfg.tab.c"
+    break;
+
+  case 82: /* auto_scale_profile_def: ID SCALE_UP_TO NUMBER ON NUMBER MODULO FOR NUMBER CYCLES  */
+#line 736 "cfg.y"
+                                              { IFOR();
+			if (create_auto_scaling_profile((yyvsp[-8].strval),(yyvsp[-6].intval),(yyvsp[-4].intval),(yyvsp[-1].intval),(yyvsp[-1].intval),
+			0, 0, 0, 0)<0)
+				yyerror("failed to create auto scaling profile");
+		}
+#line 2912 "cfg.tab.c"
+    break;
+
+  case 83: /* assign_stm: LOGLEVEL EQUAL snumber  */
+#line 743 "cfg.y"
+                                   { IFOR();
+			/* in debug mode, force logging to DEBUG level*/
+			*log_level = debug_mode?L_DBG:(yyvsp[0].intval);
+			}
+#line 2921 "cfg.tab.c"
+    break;
+
+  case 84: /* assign_stm: ENABLE_ASSERTS EQUAL NUMBER  */
+#line 747 "cfg.y"
+                                               { IFOR(); enable_asserts=(yyvsp[0].intval); }
+#line 2927 "cfg.tab.c"
+    break;
+
+  case 85: /* assign_stm: ENABLE_ASSERTS EQUAL error  */
+#line 748 "cfg.y"
+                                              { yyerror("boolean value expected"); }
+#line 2933 "cfg.tab.c"
+    break;
+
+  case 86: /* assign_stm: ABORT_ON_ASSERT EQUAL NUMBER  */
+#line 749 "cfg.y"
+                                                { IFOR(); abort_on_assert=(yyvsp[0].intval); }
+#line 2939 "cfg.tab.c"
+    break;
+
+  case 87: /* assign_stm: ABORT_ON_ASSERT EQUAL error  */
+#line 750 "cfg.y"
+                                               { yyerror("boolean value expected"); }
+#line 2945 "cfg.tab.c"
+    break;
+
+  case 88: /* assign_stm: DEBUG_MODE EQUAL NUMBER  */
+#line 751 "cfg.y"
+                                           { IFOR();
+			debug_mode=(yyvsp[0].intval);
+			if (debug_mode) { *log_level = L_DBG;log_stderr=1;}
+			}
+#line 2954 "cfg.tab.c"
+    break;
+
+  case 89: /* assign_stm: DEBUG_MODE EQUAL error  */
+#line 756 "cfg.y"
+                        { yyerror("boolean value expected for debug_mode"); }
+#line 2960 "cfg.tab.c"
+    break;
+
+  case 90: /* assign_stm: LOGSTDOUT EQUAL NUMBER  */
+#line 759 "cfg.y"
+                        { IFOR(); log_stdout=(yyvsp[0].intval); }
+#line 2966 "cfg.tab.c"
+    break;
+
+  case 91: /* assign_stm: LOGSTDOUT EQUAL error  */
+#line 760 "cfg.y"
+                                        { yyerror("boolean value expected"); }
+#line 2972 "cfg.tab.c"
+    break;
+
+  case 92: /* assign_stm: LOGSTDERROR EQUAL NUMBER  */
+#line 764 "cfg.y"
+                        { IFOR(); if (!config_check && !debug_mode) log_stderr=(yyvsp[0].intval); }
+#line 2978 "cfg.tab.c"
+    break;
+
+  case 93: /* assign_stm: LOGSTDERROR EQUAL error  */
+#line 765 "cfg.y"
+                                          { yyerror("boolean value expected"); }
+#line 2984 "cfg.tab.c"
+    break;
+
+  case 94: /* assign_stm: LOGFACILITY EQUAL ID  */
+#line 766 "cfg.y"
+                                       { IFOR();
+			if ( (i_tmp=str2facility((yyvsp[0].strval)))==-1)
+				yyerror("bad facility (see syslog(3) man page)");
+			if (!config_check)
+				log_facility=i_tmp;
+			}
+#line 2995 "cfg.tab.c"
+    break;
+
+  case 95: /* assign_stm: LOGFACILITY EQUAL error  */
+#line 772 "cfg.y"
+                                          { yyerror("ID expected"); }
+#line 3001 "cfg.tab.c"
+    break;
+
+  case 96: /* assign_stm: LOGNAME EQUAL STRING  */
+#line 773 "cfg.y"
+                                       { IFOR(); log_name=(yyvsp[0].strval); }
+#line 3007 "cfg.tab.c"
+    break;
+
+  case 97: /* assign_stm: LOGNAME EQUAL error  */
+#line 774 "cfg.y"
+                                      { yyerror("string value expected"); }
+#line 3013 "cfg.tab.c"
+    break;
+
+  case 98: /* assign_stm: DNS EQUAL NUMBER  */
+#line 775 "cfg.y"
+                                     { IFOR(); received_dns|= ((yyvsp[0].intval))?DO_DNS:0; }
+#line 3019 "cfg.tab.c"
+    break;
+
+  case 99: /* assign_stm: DNS EQUAL error  */
+#line 776 "cfg.y"
+                                  { yyerror("boolean value expected"); }
+#line 3025 "cfg.tab.c"
+    break;
+
+  case 100: /* assign_stm: REV_DNS EQUAL NUMBER  */
+#line 777 "cfg.y"
+                                       { IFOR(); received_dns|= ((yyvsp[0].intval))?DO_REV_DNS:0; }
+#line 3031 "cfg.tab.c"
+    break;
+
+  case 101: /* assign_stm: REV_DNS EQUAL error  */
+#line 778 "cfg.y"
+                                      { yyerror("boolean value expected"); }
+#line 3037 "cfg.tab.c"
+    break;
+
+  case 102: /* assign_stm: DNS_TRY_IPV6 EQUAL NUMBER  */
+#line 779 "cfg.y"
+                                              { IFOR(); dns_try_ipv6=(yyvsp[0].intval); }
+#line 3043 "cfg.tab.c"
+    break;
+
+  case 103: /* assign_stm: DNS_TRY_IPV6 error  */
+#line 780 "cfg.y"
+                                     { yyerror("boolean value expected"); }
+#line 3049 "cfg.tab.c"
+    break;
+
+  case 104: /* assign_stm: DNS_TRY_NAPTR EQUAL NUMBER  */
+#line 781 "cfg.y"
+                                               { IFOR(); dns_try_naptr=(yyvsp[0].intval); }
+#line 3055 "cfg.tab.c"
+    break;
+
+  case 105: /* assign_stm: DNS_TRY_NAPTR error  */
+#line 782 "cfg.y"
+                                      { yyerror("boolean value expected"); }
+#line 3061 "cfg.tab.c"
+    break;
+
+  case 106: /* assign_stm: DNS_RETR_TIME EQUAL NUMBER  */
+#line 783 "cfg.y"
+                                               { IFOR(); dns_retr_time=(yyvsp[0].intval); }
+#line 3067 "cfg.tab.c"
+    break;
+
+  case 107: /* assign_stm: DNS_RETR_TIME error  */
+#line 784 "cfg.y"
+                                      { yyerror("number expected"); }
+#line 3073 "cfg.tab.c"
+    break;
+
+  case 108: /* assign_stm: DNS_RETR_NO EQUAL NUMBER  */
+#line 785 "cfg.y"
+                                             { IFOR(); dns_retr_no=(yyvsp[0].intval); }
+#line 3079 "cfg.tab.c"
+    break;
+
+  case 109: /* assign_stm: DNS_RETR_NO error  */
+#line 786 "cfg.y"
+                                    { yyerror("number expected"); }
+#line 3085 "cfg.tab.c"
+    break;
+
+  case 110: /* assign_stm: DNS_SERVERS_NO EQUAL NUMBER  */
+#line 787 "cfg.y"
+                                                { IFOR(); dns_servers_no=(yyvsp[0].intval); }
+#line 3091 "cfg.tab.c"
+    break;
+
+  case 111: /* assign_stm: DNS_SERVERS_NO error  */
+#line 788 "cfg.y"
+                                       { yyerror("number expected"); }
+#line 3097 "cfg.tab.c"
+    break;
+
+  case 112: /* assign_stm: DNS_USE_SEARCH EQUAL NUMBER  */
+#line 789 "cfg.y"
+                                                { IFOR(); dns_search_list=(yyvsp[0].intval); }
+#line 3103 "cfg.tab.c"
+    break;
+
+  case 113: /* assign_stm: DNS_USE_SEARCH error  */
+#line 790 "cfg.y"
+                                       { yyerror("boolean value expected"); }
+#line 3109 "cfg.tab.c"
+    break;
+
+  case 114: /* assign_stm: MAX_WHILE_LOOPS EQUAL NUMBER  */
+#line 791 "cfg.y"
+                                               { IFOR(); max_while_loops=(yyvsp[0].intval); }
+#line 3115 "cfg.tab.c"
+    break;
+
+  case 115: /* assign_stm: MAX_WHILE_LOOPS EQUAL error  */
+#line 792 "cfg.y"
+                                              { yyerror("number expected"); }
+#line 3121 "cfg.tab.c"
+    break;
+
+  case 116: /* assign_stm: MAXBUFFER EQUAL NUMBER  */
+#line 793 "cfg.y"
+                                         { IFOR(); maxbuffer=(yyvsp[0].intval); }
+#line 3127 "cfg.tab.c"
+    break;
+
+  case 117: /* assign_stm: MAXBUFFER EQUAL error  */
+#line 794 "cfg.y"
+                                        { yyerror("number expected"); }
+#line 3133 "cfg.tab.c"
+    break;
+
+  case 118: /* assign_stm: UDP_WORKERS EQUAL NUMBER  */
+#line 795 "cfg.y"
+                                           { IFOR(); udp_workers_no=(yyvsp[0].intval); }
+#line 3139 "cfg.tab.c"
+    break;
+
+  case 119: /* assign_stm: UDP_WORKERS EQUAL NUMBER USE_AUTO_SCALING_PROFILE ID  */
+#line 796 "cfg.y"
+                                                                       { IFOR();
+				udp_workers_no=(yyvsp[-2].intval);
+				udp_auto_scaling_profile=(yyvsp[0].strval);
+		}
+#line 3148 "cfg.tab.c"
+    break;
+
+  case 120: /* assign_stm: UDP_WORKERS EQUAL error  */
+#line 800 "cfg.y"
+                                          { yyerror("number expected"); }
+#line 3154 "cfg.tab.c"
+    break;
+
+  case 121: /* assign_stm: TIMER_WORKERS EQUAL NUMBER  */
+#line 801 "cfg.y"
+                                             { IFOR();
+				timer_workers_no=(yyvsp[0].intval);
+		}
+#line 3162 "cfg.tab.c"
+    break;
+
+  case 122: /* assign_stm: TIMER_WORKERS EQUAL NUMBER USE_AUTO_SCALING_PROFILE ID  */
+#line 804 "cfg.y"
+                                                                         { IFOR();
+				timer_workers_no=(yyvsp[-2].intval);
+				timer_auto_scaling_profile=(yyvsp[0].strval);
+		}
+#line 3171 "cfg.tab.c"
+    break;
+
+  case 123: /* assign_stm: CHECK_VIA EQUAL NUMBER  */
+#line 808 "cfg.y"
+                                         { check_via=(yyvsp[0].intval); }
+#line 3177 "cfg.tab.c"
+    break;
+
+  case 124: /* assign_stm: CHECK_VIA EQUAL error  */
+#line 809 "cfg.y"
+                                        { yyerror("boolean value expected"); }
+#line 3183 "cfg.tab.c"
+    break;
+
+  case 125: /* assign_stm: SHM_HASH_SPLIT_PERCENTAGE EQUAL NUMBER  */
+#line 810 "cfg.y"
+                                                         { IFOR();
+			#ifdef HP_MALLOC
+			shm_hash_split_percentage=(yyvsp[0].intval);
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with support "
+				"for HP_MALLOC\n");
+			#endif
+			}
+#line 3196 "cfg.tab.c"
+    break;
+
+  case 126: /* assign_stm: SHM_HASH_SPLIT_PERCENTAGE EQUAL error  */
+#line 818 "cfg.y"
+                                                        {
+			#ifdef HP_MALLOC
+			yyerror("number expected");
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with support "
+				"for HP_MALLOC\n");
+			#endif
+				}
+#line 3209 "cfg.tab.c"
+    break;
+
+  case 127: /* assign_stm: SHM_SECONDARY_HASH_SIZE EQUAL NUMBER  */
+#line 826 "cfg.y"
+                                                       { IFOR();
+			#ifdef HP_MALLOC
+			shm_secondary_hash_size=(yyvsp[0].intval);
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with support"
+				" for HP_MALLOC\n");
+			#endif
+			}
+#line 3222 "cfg.tab.c"
+    break;
+
+  case 128: /* assign_stm: SHM_SECONDARY_HASH_SIZE EQUAL error  */
+#line 834 "cfg.y"
+                                                      {
+			#ifdef HP_MALLOC
+			yyerror("number expected");
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with support "
+				"for HP_MALLOC\n");
+			#endif
+			}
+#line 3235 "cfg.tab.c"
+    break;
+
+  case 129: /* assign_stm: MEM_WARMING_ENABLED EQUAL NUMBER  */
+#line 842 "cfg.y"
+                                                   { IFOR();
+			#ifdef HP_MALLOC
+			mem_warming_enabled = (yyvsp[0].intval);
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with support"
+				" for HP_MALLOC\n");
+			#endif
+			}
+#line 3248 "cfg.tab.c"
+    break;
+
+  case 130: /* assign_stm: MEM_WARMING_ENABLED EQUAL error  */
+#line 850 "cfg.y"
+                                                  {
+			#ifdef HP_MALLOC
+			yyerror("number expected");
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with support "
+				"for HP_MALLOC\n");
+			#endif
+			}
+#line 3261 "cfg.tab.c"
+    break;
+
+  case 131: /* assign_stm: MEM_WARMING_PATTERN_FILE EQUAL STRING  */
+#line 858 "cfg.y"
+                                                        { IFOR();
+			#ifdef HP_MALLOC
+			mem_warming_pattern_file = (yyvsp[0].strval);
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with "
+				"support for HP_MALLOC\n");
+			#endif
+			}
+#line 3274 "cfg.tab.c"
+    break;
+
+  case 132: /* assign_stm: MEM_WARMING_PATTERN_FILE EQUAL error  */
+#line 866 "cfg.y"
+                                                       {
+			#ifdef HP_MALLOC
+			yyerror("string expected");
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with support "
+				"for HP_MALLOC\n");
+			#endif
+			}
+#line 3287 "cfg.tab.c"
+    break;
+
+  case 133: /* assign_stm: MEM_WARMING_PERCENTAGE EQUAL NUMBER  */
+#line 874 "cfg.y"
+                                                      { IFOR();
+			#ifdef HP_MALLOC
+			mem_warming_percentage = (yyvsp[0].intval);
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with "
+				"support for HP_MALLOC\n");
+			#endif
+			}
+#line 3300 "cfg.tab.c"
+    break;
+
+  case 134: /* assign_stm: MEM_WARMING_PERCENTAGE EQUAL error  */
+#line 882 "cfg.y"
+                                                     {
+			#ifdef HP_MALLOC
+			yyerror("number expected");
+			#else
+			LM_ERR("Cannot set parameter; Please recompile with support "
+				"for HP_MALLOC\n");
+			#endif
+			}
+#line 3313 "cfg.tab.c"
+    break;
+
+  case 135: /* assign_stm: RPM_MEM_FILE EQUAL STRING  */
+#line 890 "cfg.y"
+                                            { IFOR();
+			rpm_mem_file = (yyvsp[0].strval);
+			}
+#line 3321 "cfg.tab.c"
+    break;
+
+  case 136: /* assign_stm: RPM_MEM_FILE EQUAL error  */
+#line 893 "cfg.y"
+                                           { yyerror("string value expected"); }
+#line 3327 "cfg.tab.c"
+    break;
+
+  case 137: /* assign_stm: RPM_MEM_SIZE EQUAL NUMBER  */
+#line 894 "cfg.y"
+                                            { IFOR();
+			rpm_mem_size = (yyvsp[0].intval) * 1024 * 1024;
+			}
+#line 3335 "cfg.tab.c"
+    break;
+
+  case 138: /* assign_stm: RPM_MEM_SIZE EQUAL error  */
+#line 897 "cfg.y"
+                                           { yyerror("int value expected"); }
+#line 3341 "cfg.tab.c"
+    break;
+
+  case 139: /* assign_stm: MEMLOG EQUAL snumber  */
+#line 898 "cfg.y"
+                                       { IFOR(); memlog=(yyvsp[0].intval); memdump=(yyvsp[0].intval); }
+#line 3347 "cfg.tab.c"
+    break;
+
+  case 140: /* assign_stm: MEMLOG EQUAL error  */
+#line 899 "cfg.y"
+                                     { yyerror("int value expected"); }
+#line 3353 "cfg.tab.c"
+    break;
+
+  case 141: /* assign_stm: MEMDUMP EQUAL snumber  */
+#line 900 "cfg.y"
+                                        { IFOR(); memdump=(yyvsp[0].intval); }
+#line 3359 "cfg.tab.c"
+    break;
+
+  case 142: /* assign_stm: MEMDUMP EQUAL error  */
+#line 901 "cfg.y"
+                                      { yyerror("int value expected"); }
+#line 3365 "cfg.tab.c"
+    break;
+
+  case 143: /* assign_stm: EXECMSGTHRESHOLD EQUAL NUMBER  */
+#line 902 "cfg.y"
+                                                {  IFOR();execmsgthreshold=(yyvsp[0].intval); }
+#line 3371 "cfg.tab.c"
+    break;
+
+  case 144: /* assign_stm: EXECMSGTHRESHOLD EQUAL error  */
+#line 903 "cfg.y"
+                                               { yyerror("int value expected"); }
+#line 3377 "cfg.tab.c"
+    break;
+
+  case 145: /* assign_stm: EXECDNSTHRESHOLD EQUAL NUMBER  */
+#line 904 "cfg.y"
+                                                { IFOR(); execdnsthreshold=(yyvsp[0].intval); }
+#line 3383 "cfg.tab.c"
+    break;
+
+  case 146: /* assign_stm: EXECDNSTHRESHOLD EQUAL error  */
+#line 905 "cfg.y"
+                                               { yyerror("int value expected"); }
+#line 3389 "cfg.tab.c"
+    break;
+
+  case 147: /* assign_stm: TCPTHRESHOLD EQUAL NUMBER  */
+#line 906 "cfg.y"
+                                            { IFOR(); tcpthreshold=(yyvsp[0].intval); }
+#line 3395 "cfg.tab.c"
+    break;
+
+  case 148: /* assign_stm: TCPTHRESHOLD EQUAL error  */
+#line 907 "cfg.y"
+                                           { yyerror("int value expected"); }
+#line 3401 "cfg.tab.c"
+    break;
+
+  case 149: /* assign_stm: EVENT_SHM_THRESHOLD EQUAL NUMBER  */
+#line 908 "cfg.y"
+                                                   { IFOR();
+			#ifdef STATISTICS
+			if ((yyvsp[0].intval) < 0 || (yyvsp[0].intval) > 100)
+				yyerror("SHM threshold has to be a percentage between"
+					" 0 and 100");
+			event_shm_threshold=(yyvsp[0].intval);
+			#else
+			yyerror("statistics support not compiled in");
+			#endif /* STATISTICS */
+			}
+#line 3416 "cfg.tab.c"
+    break;
+
+  case 150: /* assign_stm: EVENT_SHM_THRESHOLD EQUAL error  */
+#line 918 "cfg.y"
+                                                  { yyerror("int value expected"); }
+#line 3422 "cfg.tab.c"
+    break;
+
+  case 151: /* assign_stm: EVENT_PKG_THRESHOLD EQUAL NUMBER  */
+#line 919 "cfg.y"
+                                                   { IFOR();
+			#ifdef PKG_MALLOC
+			#ifdef STATISTICS
+			if ((yyvsp[0].intval) < 0 || (yyvsp[0].intval) > 100)
+				yyerror("PKG threshold has to be a percentage between "
+					"0 and 100");
+			event_pkg_threshold=(yyvsp[0].intval);
+			#else
+			yyerror("statistics support not compiled in");
+			#endif
+			#else
+			yyerror("pkg_malloc support not compiled in");
+			#endif
+			}
+#line 3441 "cfg.tab.c"
+    break;
+
+  case 152: /* assign_stm: EVENT_PKG_THRESHOLD EQUAL error  */
+#line 933 "cfg.y"
+                                                  { yyerror("int value expected"); }
+#line 3447 "cfg.tab.c"
+    break;
+
+  case 153: /* assign_stm: QUERYBUFFERSIZE EQUAL NUMBER  */
+#line 934 "cfg.y"
+                                               { IFOR(); query_buffer_size=(yyvsp[0].intval); }
+#line 3453 "cfg.tab.c"
+    break;
+
+  case 154: /* assign_stm: QUERYBUFFERSIZE EQUAL error  */
+#line 935 "cfg.y"
+                                              { yyerror("int value expected"); }
+#line 3459 "cfg.tab.c"
+    break;
+
+  case 155: /* assign_stm: QUERYFLUSHTIME EQUAL NUMBER  */
+#line 936 "cfg.y"
+                                              { IFOR(); query_flush_time=(yyvsp[0].intval); }
+#line 3465 "cfg.tab.c"
+    break;
+
+  case 156: /* assign_stm: QUERYFLUSHTIME EQUAL error  */
+#line 937 "cfg.y"
+                                             { yyerror("int value expected"); }
+#line 3471 "cfg.tab.c"
+    break;
+
+  case 157: /* assign_stm: QUERYWRITERPROCESSES EQUAL NUMBER  */
+#line 938 "cfg.y"
+                                                    { IFOR();
+				query_writer_processes=(yyvsp[0].intval); }
+#line 3478 "cfg.tab.c"
+    break;
+
+  case 158: /* assign_stm: QUERYWRITERPROCESSES EQUAL error  */
+#line 940 "cfg.y"
+                                                   { yyerror("int value expected"); }
+#line 3484 "cfg.tab.c"
+    break;
+
+  case 159: /* assign_stm: SIP_WARNING EQUAL NUMBER  */
+#line 941 "cfg.y"
+                                           { IFOR(); sip_warning=(yyvsp[0].intval); }
+#line 3490 "cfg.tab.c"
+    break;
+
+  case 160: /* assign_stm: SIP_WARNING EQUAL error  */
+#line 942 "cfg.y"
+                                          { yyerror("boolean value expected"); }
+#line 3496 "cfg.tab.c"
+    break;
+
+  case 161: /* assign_stm: CHROOT EQUAL STRING  */
+#line 943 "cfg.y"
+                                          { IFOR(); chroot_dir=(yyvsp[0].strval); }
+#line 3502 "cfg.tab.c"
+    break;
+
+  case 162: /* assign_stm: CHROOT EQUAL ID  */
+#line 944 "cfg.y"
+                                          { IFOR(); chroot_dir=(yyvsp[0].strval); }
+#line 3508 "cfg.tab.c"
+    break;
+
+  case 163: /* assign_stm: CHROOT EQUAL error  */
+#line 945 "cfg.y"
+                                          { yyerror("string value expected"); }
+#line 3514 "cfg.tab.c"
+    break;
+
+  case 164: /* assign_stm: WDIR EQUAL STRING  */
+#line 946 "cfg.y"
+                                        { IFOR(); working_dir=(yyvsp[0].strval); }
+#line 3520 "cfg.tab.c"
+    break;
+
+  case 165: /* assign_stm: WDIR EQUAL ID  */
+#line 947 "cfg.y"
+                                        { IFOR(); working_dir=(yyvsp[0].strval); }
+#line 3526 "cfg.tab.c"
+    break;
+
+  case 166: /* assign_stm: WDIR EQUAL error  */
+#line 948 "cfg.y"
+                                        { yyerror("string value expected"); }
+#line 3532 "cfg.tab.c"
+    break;
+
+  case 167: /* assign_stm: MHOMED EQUAL NUMBER  */
+#line 949 "cfg.y"
+                                      { IFOR(); mhomed=(yyvsp[0].intval); }
+#line 3538 "cfg.tab.c"
+    break;
+
+  case 168: /* assign_stm: MHOMED EQUAL error  */
+#line 950 "cfg.y"
+                                     { yyerror("boolean value expected"); }
+#line 3544 "cfg.tab.c"
+    break;
+
+  case 169: /* assign_stm: POLL_METHOD EQUAL ID  */
+#line 951 "cfg.y"
+                                       { IFOR();
+									io_poll_method=get_poll_type((yyvsp[0].strval));
+									if (io_poll_method==POLL_NONE){
+										LM_CRIT("bad poll method name:"
+											" %s\n, try one of %s.\n",
+											(yyvsp[0].strval), poll_support);
+										yyerror("bad poll_method "
+											"value");
+									}
+								}
+#line 3559 "cfg.tab.c"
+    break;
+
+  case 170: /* assign_stm: POLL_METHOD EQUAL STRING  */
+#line 961 "cfg.y"
+                                           { IFOR();
+									io_poll_method=get_poll_type((yyvsp[0].strval));
+									if (io_poll_method==POLL_NONE){
+										LM_CRIT("bad poll method name:"
+											" %s\n, try one of %s.\n",
+											(yyvsp[0].strval), poll_support);
+										yyerror("bad poll_method "
+											"value");
+									}
+									}
+#line 3574 "cfg.tab.c"
+    break;
+
+  case 171: /* assign_stm: POLL_METHOD EQUAL error  */
+#line 971 "cfg.y"
+                                          { yyerror("poll method name expected"); }
+#line 3580 "cfg.tab.c"
+    break;
+
+  case 172: /* assign_stm: TCP_ACCEPT_ALIASES EQUAL NUMBER  */
+#line 972 "cfg.y"
+                                                  { IFOR();
+				tcp_accept_aliases=(yyvsp[0].intval);
+		}
+#line 3588 "cfg.tab.c"
+    break;
+
+  case 173: /* assign_stm: TCP_ACCEPT_ALIASES EQUAL error  */
+#line 975 "cfg.y"
+                                                 { yyerror("boolean value expected"); }
+#line 3594 "cfg.tab.c"
+    break;
+
+  case 174: /* assign_stm: TCP_WORKERS EQUAL NUMBER  */
+#line 976 "cfg.y"
+                                           { IFOR();
+				tcp_workers_no=(yyvsp[0].intval);
+		}
+#line 3602 "cfg.tab.c"
+    break;
+
+  case 175: /* assign_stm: TCP_WORKERS EQUAL NUMBER USE_AUTO_SCALING_PROFILE ID  */
+#line 979 "cfg.y"
+                                                                      { IFOR();
+				tcp_workers_no=(yyvsp[-2].intval);
+				tcp_auto_scaling_profile=(yyvsp[0].strval);
+		}
+#line 3611 "cfg.tab.c"
+    break;
+
+  case 176: /* assign_stm: TCP_WORKERS EQUAL error  */
+#line 983 "cfg.y"
+                                          { yyerror("number expected"); }
+#line 3617 "cfg.tab.c"
+    break;
+
+  case 177: /* assign_stm: TCP_HANDSHAKE_WORKERS EQUAL NUMBER  */
+#line 984 "cfg.y"
+                                                     { IFOR();
+				tcp_handshake_workers_no=(yyvsp[0].intval);
+		}
+#line 3625 "cfg.tab.c"
+    break;
+
+  case 178: /* assign_stm: TCP_HANDSHAKE_WORKERS EQUAL error  */
+#line 987 "cfg.y"
+                                                    { yyerror("number expected"); }
+#line 3631 "cfg.tab.c"
+    break;
+
+  case 179: /* assign_stm: TCP_CONNECT_TIMEOUT EQUAL NUMBER  */
+#line 988 "cfg.y"
+                                                   { IFOR();
+				tcp_connect_timeout=(yyvsp[0].intval);
+		}
+#line 3639 "cfg.tab.c"
+    break;
+
+  case 180: /* assign_stm: TCP_CONNECT_TIMEOUT EQUAL error  */
+#line 991 "cfg.y"
+                                                  { yyerror("number expected"); }
+#line 3645 "cfg.tab.c"
+    break;
+
+  case 181: /* assign_stm: TCP_CON_LIFETIME EQUAL NUMBER  */
+#line 992 "cfg.y"
+                                                { IFOR();
+				tcp_con_lifetime=(yyvsp[0].intval);
+		}
+#line 3653 "cfg.tab.c"
+    break;
+
+  case 182: /* assign_stm: TCP_CON_LIFETIME EQUAL error  */
+#line 995 "cfg.y"
+                                               { yyerror("number expected"); }
+#line 3659 "cfg.tab.c"
+    break;
+
+  case 183: /* assign_stm: TCP_SOCKET_BACKLOG EQUAL NUMBER  */
+#line 996 "cfg.y"
+                                                  { IFOR();
+				tcp_socket_backlog=(yyvsp[0].intval);
+		}
+#line 3667 "cfg.tab.c"
+    break;
+
+  case 184: /* assign_stm: TCP_SOCKET_BACKLOG EQUAL error  */
+#line 999 "cfg.y"
+                                                 { yyerror("number expected"); }
+#line 3673 "cfg.tab.c"
+    break;
+
+  case 185: /* assign_stm: TCP_MAX_CONNECTIONS EQUAL NUMBER  */
+#line 1000 "cfg.y"
+                                                   { IFOR();
+				tcp_max_connections=(yyvsp[0].intval);
+		}
+#line 3681 "cfg.tab.c"
+    break;
+
+  case 186: /* assign_stm: TCP_MAX_CONNECTIONS EQUAL error  */
+#line 1003 "cfg.y"
+                                                  { yyerror("number expected"); }
+#line 3687 "cfg.tab.c"
+    break;
+
+  case 187: /* assign_stm: TCP_NO_NEW_CONN_BFLAG EQUAL ID  */
+#line 1004 "cfg.y"
+                                                 { IFOR();
+				tcp_no_new_conn_bflag =
+					get_flag_id_by_name(FLAG_TYPE_BRANCH, (yyvsp[0].strval), 0);
+				if (!flag_in_range( (flag_t)tcp_no_new_conn_bflag ) )
+					yyerror("invalid TCP no_new_conn Branch Flag");
+				flag_idx2mask( &tcp_no_new_conn_bflag );
+		}
+#line 3699 "cfg.tab.c"
+    break;
+
+  case 188: /* assign_stm: TCP_NO_NEW_CONN_BFLAG EQUAL error  */
+#line 1011 "cfg.y"
+                                                    { yyerror("number value expected"); }
+#line 3705 "cfg.tab.c"
+    break;
+
+  case 189: /* assign_stm: TCP_NO_NEW_CONN_RPLFLAG EQUAL ID  */
+#line 1012 "cfg.y"
+                                                   { IFOR();
+				tcp_no_new_conn_rplflag =
+					get_flag_id_by_name(FLAG_TYPE_MSG, (yyvsp[0].strval), 0);
+				if (!flag_in_range( (flag_t)tcp_no_new_conn_rplflag ) )
+					yyerror("invalid TCP no_new_conn RePLy Flag");
+				flag_idx2mask( &tcp_no_new_conn_rplflag );
+		}
+#line 3717 "cfg.tab.c"
+    break;
+
+  case 190: /* assign_stm: TCP_NO_NEW_CONN_RPLFLAG EQUAL error  */
+#line 1019 "cfg.y"
+                                                      { yyerror("number value expected"); }
+#line 3723 "cfg.tab.c"
+    break;
+
+  case 191: /* assign_stm: TCP_KEEPALIVE EQUAL NUMBER  */
+#line 1021 "cfg.y"
+                                             { IFOR();
+				tcp_keepalive=(yyvsp[0].intval);
+		}
+#line 3731 "cfg.tab.c"
+    break;
+
+  case 192: /* assign_stm: TCP_KEEPALIVE EQUAL error  */
+#line 1024 "cfg.y"
+                                            { yyerror("boolean value expected"); }
+#line 3737 "cfg.tab.c"
+    break;
+
+  case 193: /* assign_stm: TCP_MAX_MSG_TIME EQUAL NUMBER  */
+#line 1025 "cfg.y"
+                                                { IFOR();
+				tcp_max_msg_time=(yyvsp[0].intval);
+		}
+#line 3745 "cfg.tab.c"
+    break;
+
+  case 194: /* assign_stm: TCP_MAX_MSG_TIME EQUAL error  */
+#line 1028 "cfg.y"
+                                               { yyerror("boolean value expected"); }
+#line 3751 "cfg.tab.c"
+    break;
+
+  case 195: /* assign_stm: TCP_KEEPCOUNT EQUAL NUMBER  */
+#line 1029 "cfg.y"
+                                                        { IFOR();
+			#ifndef HAVE_TCP_KEEPCNT
+				warn("cannot be enabled TCP_KEEPCOUNT (no OS support)");
+			#else
+				tcp_keepcount=(yyvsp[0].intval);
+			#endif
+		}
+#line 3763 "cfg.tab.c"
+    break;
+
+  case 196: /* assign_stm: TCP_KEEPCOUNT EQUAL error  */
+#line 1036 "cfg.y"
+                                            { yyerror("int value expected"); }
+#line 3769 "cfg.tab.c"
+    break;
+
+  case 197: /* assign_stm: TCP_KEEPIDLE EQUAL NUMBER  */
+#line 1037 "cfg.y"
+                                                        { IFOR();
+			#ifndef HAVE_TCP_KEEPIDLE
+				warn("cannot be enabled TCP_KEEPIDLE (no OS support)");
+			#else
+				tcp_keepidle=(yyvsp[0].intval);
+			#endif
+		}
+#line 3781 "cfg.tab.c"
+    break;
+
+  case 198: /* assign_stm: TCP_KEEPIDLE EQUAL error  */
+#line 1044 "cfg.y"
+                                           { yyerror("int value expected"); }
+#line 3787 "cfg.tab.c"
+    break;
+
+  case 199: /* assign_stm: TCP_KEEPINTERVAL EQUAL NUMBER  */
+#line 1045 "cfg.y"
+                                                { IFOR();
+			#ifndef HAVE_TCP_KEEPINTVL
+				warn("cannot be enabled TCP_KEEPINTERVAL (no OS support)");
+			#else
+				tcp_keepinterval=(yyvsp[0].intval);
+			 #endif
+		}
+#line 3799 "cfg.tab.c"
+    break;
+
+  case 200: /* assign_stm: TCP_KEEPINTERVAL EQUAL error  */
+#line 1052 "cfg.y"
+                                               { yyerror("int value expected"); }
+#line 3805 "cfg.tab.c"
+    break;
+
+  case 201: /* assign_stm: SERVER_SIGNATURE EQUAL NUMBER  */
+#line 1053 "cfg.y"
+                                                { IFOR();
+							server_signature=(yyvsp[0].intval); }
+#line 3812 "cfg.tab.c"
+    break;
+
+  case 202: /* assign_stm: SERVER_SIGNATURE EQUAL error  */
+#line 1055 "cfg.y"
+                                               { yyerror("boolean value expected"); }
+#line 3818 "cfg.tab.c"
+    break;
+
+  case 203: /* assign_stm: SERVER_HEADER EQUAL STRING  */
+#line 1056 "cfg.y"
+                                             { IFOR();
+							server_header->s=(yyvsp[0].strval);
+							server_header->len=strlen((yyvsp[0].strval));
+							}
+#line 3827 "cfg.tab.c"
+    break;
+
+  case 204: /* assign_stm: SERVER_HEADER EQUAL error  */
+#line 1060 "cfg.y"
+                                            { yyerror("string value expected"); }
+#line 3833 "cfg.tab.c"
+    break;
+
+  case 205: /* assign_stm: USER_AGENT_HEADER EQUAL STRING  */
+#line 1061 "cfg.y"
+                                                 { user_agent_header->s=(yyvsp[0].strval);
+			user_agent_header->len=strlen((yyvsp[0].strval));
+									}
+#line 3841 "cfg.tab.c"
+    break;
+
+  case 206: /* assign_stm: USER_AGENT_HEADER EQUAL error  */
+#line 1064 "cfg.y"
+                                                { yyerror("string value expected"); }
+#line 3847 "cfg.tab.c"
+    break;
+
+  case 207: /* assign_stm: PV_PRINT_BUF_SIZE EQUAL NUMBER  */
+#line 1065 "cfg.y"
+                                                 { IFOR();
+							pv_print_buf_size = (yyvsp[0].intval); }
+#line 3854 "cfg.tab.c"
+    break;
+
+  case 208: /* assign_stm: PV_PRINT_BUF_SIZE EQUAL error  */
+#line 1067 "cfg.y"
+                                                { yyerror("number expected"); }
+#line 3860 "cfg.tab.c"
+    break;
+
+  case 209: /* assign_stm: XLOG_BUF_SIZE EQUAL NUMBER  */
+#line 1068 "cfg.y"
+                                             { IFOR();
+							xlog_buf_size = (yyvsp[0].intval); }
+#line 3867 "cfg.tab.c"
+    break;
+
+  case 210: /* assign_stm: XLOG_FORCE_COLOR EQUAL NUMBER  */
+#line 1070 "cfg.y"
+                                                { IFOR();
+							xlog_force_color = (yyvsp[0].intval); }
+#line 3874 "cfg.tab.c"
+    break;
+
+  case 211: /* assign_stm: XLOG_PRINT_LEVEL EQUAL NUMBER  */
+#line 1072 "cfg.y"
+                                                { IFOR();
+							xlog_print_level = (yyvsp[0].intval); }
+#line 3881 "cfg.tab.c"
+    break;
+
+  case 212: /* assign_stm: XLOG_BUF_SIZE EQUAL error  */
+#line 1074 "cfg.y"
+                                            { yyerror("number expected"); }
+#line 3887 "cfg.tab.c"
+    break;
+
+  case 213: /* assign_stm: XLOG_FORCE_COLOR EQUAL error  */
+#line 1075 "cfg.y"
+                                               { yyerror("boolean value expected"); }
+#line 3893 "cfg.tab.c"
+    break;
+
+  case 214: /* assign_stm: XLOG_PRINT_LEVEL EQUAL error  */
+#line 1076 "cfg.y"
+                                               { yyerror("number expected"); }
+#line 3899 "cfg.tab.c"
+    break;
+
+  case 215: /* assign_stm: XLOG_LEVEL EQUAL NUMBER  */
+#line 1077 "cfg.y"
+                                          { IFOR();
+							*xlog_level = (yyvsp[0].intval); }
+#line 3906 "cfg.tab.c"
+    break;
+
+  case 216: /* assign_stm: XLOG_LEVEL EQUAL error  */
+#line 1079 "cfg.y"
+                                         { yyerror("number expected"); }
+#line 3912 "cfg.tab.c"
+    break;
+
+  case 217: /* assign_stm: SOCKET EQUAL socket_def  */
+#line 1080 "cfg.y"
+                                          { IFOR();
+							if (add_listening_socket((yyvsp[0].sockid))!=0){
+								LM_CRIT("cfg. parser: failed"
+										" to add listening socket\n");
+								break;
+							}
+						}
+#line 3924 "cfg.tab.c"
+    break;
+
+  case 218: /* assign_stm: SOCKET EQUAL error  */
+#line 1087 "cfg.y"
+                                      { yyerror("ip address or hostname "
+						"expected (use quotes if the hostname includes"
+						" config keywords)"); }
+#line 3932 "cfg.tab.c"
+    break;
+
+  case 219: /* assign_stm: LISTEN EQUAL socket_def  */
+#line 1090 "cfg.y"
+                                          { IFOR();
+							warn("'listen' is deprecated, use 'socket' instead");
+							if (add_listening_socket((yyvsp[0].sockid))!=0){
+								LM_CRIT("cfg. parser: failed"
+										" to add listen address\n");
+								break;
+							}
+						}
+#line 3945 "cfg.tab.c"
+    break;
+
+  case 220: /* assign_stm: LISTEN EQUAL error  */
+#line 1098 "cfg.y"
+                                      { yyerror("ip address or hostname "
+						"expected (use quotes if the hostname includes"
+						" config keywords)"); }
+#line 3953 "cfg.tab.c"
+    break;
+
+  case 221: /* assign_stm: MEMGROUP EQUAL STRING COLON multi_string  */
+#line 1101 "cfg.y"
+                                                           { IFOR();
+							/* convert STIRNG ($3) to an ID */
+							/* update the memstats type for each module */
+							#ifndef SHM_EXTRA_STATS
+								LM_CRIT("SHM_EXTRA_STATS not defined");
+								YYABORT;
+							#else
+
+							#ifdef SHM_SHOW_DEFAULT_GROUP
+							if(strcmp((yyvsp[-2].strval), "default") == 0){
+								LM_CRIT("default group  name is not allowed");
+								YYABORT;
+							}
+							#endif
+
+							for(tmp_mod = mod_names; tmp_mod; tmp_mod=tmp_mod->next){
+								if(strcmp((yyvsp[-2].strval), tmp_mod->s) == 0){
+									LM_CRIT("The same mem-group name is used twice: [%s] [%s]\n", (yyvsp[-2].strval), tmp_mod->s);
+									YYABORT;
+								}
+							}
+
+							tmp_mod = pkg_malloc(sizeof(struct multi_str));
+							if(!tmp_mod){
+								LM_CRIT("out of pkg memory");
+								YYABORT;
+							}
+
+							tmp_mod->s = (yyvsp[-2].strval);
+							tmp_mod->next = mod_names;
+							mod_names = tmp_mod;
+							for (tmp_mod = (yyvsp[0].multistr); tmp_mod; tmp_mod = tmp_mod->next){
+								if(set_mem_idx(tmp_mod->s, mem_free_idx)){
+									YYABORT;
+								}
+							}
+
+							mem_free_idx++;
+
+							if(alloc_group_stat()){
+								YYABORT;
+							}
+							#endif
+						}
+#line 4002 "cfg.tab.c"
+    break;
+
+  case 222: /* assign_stm: MEMGROUP EQUAL STRING COLON error  */
+#line 1145 "cfg.y"
+                                                    { yyerror("invalid or no module specified"); }
+#line 4008 "cfg.tab.c"
+    break;
+
+  case 223: /* assign_stm: ALIAS EQUAL id_lst  */
+#line 1146 "cfg.y"
+                                      { IFOR();
+							for(lst_tmp=(yyvsp[0].sockid); lst_tmp; lst_tmp=lst_tmp->next)
+								add_alias(lst_tmp->name, strlen(lst_tmp->name),
+											lst_tmp->port, lst_tmp->proto);
+							  }
+#line 4018 "cfg.tab.c"
+    break;
+
+  case 224: /* assign_stm: ALIAS EQUAL error  */
+#line 1151 "cfg.y"
+                                      { yyerror("hostname expected (use quotes"
+							" if the hostname includes config keywords)"); }
+#line 4025 "cfg.tab.c"
+    break;
+
+  case 225: /* assign_stm: AUTO_ALIASES EQUAL NUMBER  */
+#line 1153 "cfg.y"
+                                            { IFOR();
+								auto_aliases=(yyvsp[0].intval); }
+#line 4032 "cfg.tab.c"
+    break;
+
+  case 226: /* assign_stm: AUTO_ALIASES EQUAL error  */
+#line 1155 "cfg.y"
+                                            { yyerror("number  expected"); }
+#line 4038 "cfg.tab.c"
+    break;
+
+  case 227: /* assign_stm: ADVERTISED_ADDRESS EQUAL listen_id  */
+#line 1156 "cfg.y"
+                                                     { IFOR();
+								if ((yyvsp[0].strval)) {
+									default_global_address->s=(yyvsp[0].strval);
+									default_global_address->len=strlen((yyvsp[0].strval));
+								}
+								}
+#line 4049 "cfg.tab.c"
+    break;
+
+  case 228: /* assign_stm: ADVERTISED_ADDRESS EQUAL error  */
+#line 1162 "cfg.y"
+                                                 {yyerror("ip address or hostname "
+												"expected"); }
+#line 4056 "cfg.tab.c"
+    break;
+
+  case 229: /* assign_stm: ADVERTISED_PORT EQUAL NUMBER  */
+#line 1164 "cfg.y"
+                                               { IFOR();
+								tmp = int2str((yyvsp[0].intval), &i_tmp);
+								if (i_tmp > default_global_port->len)
+									default_global_port->s =
+									pkg_realloc(default_global_port->s, i_tmp);
+								if (!default_global_port->s) {
+									LM_CRIT("cfg. parser: out of memory.\n");
+									YYABORT;
+								} else {
+									default_global_port->len = i_tmp;
+									memcpy(default_global_port->s, tmp,
+											default_global_port->len);
+								}
+								}
+#line 4075 "cfg.tab.c"
+    break;
+
+  case 230: /* assign_stm: ADVERTISED_PORT EQUAL error  */
+#line 1178 "cfg.y"
+                                             {yyerror("ip address or hostname "
+												"expected"); }
+#line 4082 "cfg.tab.c"
+    break;
+
+  case 231: /* assign_stm: DISABLE_CORE EQUAL NUMBER  */
+#line 1180 "cfg.y"
+                                            { IFOR();
+										disable_core_dump=(yyvsp[0].intval);
+									}
+#line 4090 "cfg.tab.c"
+    break;
+
+  case 232: /* assign_stm: DISABLE_CORE EQUAL error  */
+#line 1183 "cfg.y"
+                                           { yyerror("boolean value expected"); }
+#line 4096 "cfg.tab.c"
+    break;
+
+  case 233: /* assign_stm: OPEN_FD_LIMIT EQUAL NUMBER  */
+#line 1184 "cfg.y"
+                                             { IFOR();
+										open_files_limit=(yyvsp[0].intval);
+									}
+#line 4104 "cfg.tab.c"
+    break;
+
+  case 234: /* assign_stm: OPEN_FD_LIMIT EQUAL error  */
+#line 1187 "cfg.y"
+                                            { yyerror("number expected"); }
+#line 4110 "cfg.tab.c"
+    break;
+
+  case 235: /* assign_stm: MCAST_LOOPBACK EQUAL NUMBER  */
+#line 1188 "cfg.y"
+                                              { IFOR();
+								#ifdef USE_MCAST
+										mcast_loopback=(yyvsp[0].intval);
+								#else
+									warn("no multicast support compiled in");
+								#endif
+		  }
+#line 4122 "cfg.tab.c"
+    break;
+
+  case 236: /* assign_stm: MCAST_LOOPBACK EQUAL error  */
+#line 1195 "cfg.y"
+                                             { yyerror("boolean value expected"); }
+#line 4128 "cfg.tab.c"
+    break;
+
+  case 237: /* assign_stm: MCAST_TTL EQUAL NUMBER  */
+#line 1196 "cfg.y"
+                                         { IFOR();
+								#ifdef USE_MCAST
+										mcast_ttl=(yyvsp[0].intval);
+								#else
+									warn("no multicast support compiled in");
+								#endif
+		  }
+#line 4140 "cfg.tab.c"
+    break;
+
+  case 238: /* assign_stm: MCAST_TTL EQUAL error  */
+#line 1203 "cfg.y"
+                                        { yyerror("number expected as tos"); }
+#line 4146 "cfg.tab.c"
+    break;
+
+  case 239: /* assign_stm: TOS EQUAL NUMBER  */
+#line 1204 "cfg.y"
+                                   { IFOR(); tos = (yyvsp[0].intval);
+							if (tos<=0)
+								yyerror("invalid tos value");
+		 }
+#line 4155 "cfg.tab.c"
+    break;
+
+  case 240: /* assign_stm: TOS EQUAL ID  */
+#line 1208 "cfg.y"
+                               { IFOR();
+							if (strcasecmp((yyvsp[0].strval),"IPTOS_LOWDELAY")) {
+								tos=IPTOS_LOWDELAY;
+							} else if (strcasecmp((yyvsp[0].strval),"IPTOS_THROUGHPUT")) {
+								tos=IPTOS_THROUGHPUT;
+							} else if (strcasecmp((yyvsp[0].strval),"IPTOS_RELIABILITY")) {
+								tos=IPTOS_RELIABILITY;
+#if defined(IPTOS_MINCOST)
+							} else if (strcasecmp((yyvsp[0].strval),"IPTOS_MINCOST")) {
+								tos=IPTOS_MINCOST;
+#endif
+#if defined(IPTOS_LOWCOST)
+							} else if (strcasecmp((yyvsp[0].strval),"IPTOS_LOWCOST")) {
+								tos=IPTOS_LOWCOST;
+#endif
+							} else {
+								yyerror("invalid tos value - allowed: "
+									"IPTOS_LOWDELAY,IPTOS_THROUGHPUT,"
+									"IPTOS_RELIABILITY"
+#if defined(IPTOS_LOWCOST)
+									",IPTOS_LOWCOST"
+#endif
+#if defined(IPTOS_MINCOST)
+									",IPTOS_MINCOST"
+#endif
+									"\n");
+							}
+		 }
+#line 4188 "cfg.tab.c"
+    break;
+
+  case 241: /* assign_stm: TOS EQUAL error  */
+#line 1236 "cfg.y"
+                                  { yyerror("number expected"); }
+#line 4194 "cfg.tab.c"
+    break;
+
+  case 242: /* assign_stm: MPATH EQUAL STRING  */
+#line 1237 "cfg.y"
+                                     {IFOR();
+				set_mpath((yyvsp[0].strval)); }
+#line 4201 "cfg.tab.c"
+    break;
+
+  case 243: /* assign_stm: MPATH EQUAL error  */
+#line 1239 "cfg.y"
+                                     { yyerror("string value expected"); }
+#line 4207 "cfg.tab.c"
+    break;
+
+  case 244: /* assign_stm: DISABLE_DNS_FAILOVER EQUAL NUMBER  */
+#line 1240 "cfg.y"
+                                                    { IFOR();
+										disable_dns_failover=(yyvsp[0].intval);
+									}
+#line 4215 "cfg.tab.c"
+    break;
+
+  case 245: /* assign_stm: DISABLE_DNS_FAILOVER error  */
+#line 1243 "cfg.y"
+                                             { yyerror("boolean value expected"); }
+#line 4221 "cfg.tab.c"
+    break;
+
+  case 246: /* assign_stm: DISABLE_DNS_BLACKLIST EQUAL NUMBER  */
+#line 1244 "cfg.y"
+                                                     { IFOR();
+										disable_dns_blacklist=(yyvsp[0].intval);
+									}
+#line 4229 "cfg.tab.c"
+    break;
+
+  case 247: /* assign_stm: DISABLE_DNS_BLACKLIST error  */
+#line 1247 "cfg.y"
+                                              { yyerror("boolean value expected"); }
+#line 4235 "cfg.tab.c"
+    break;
+
+  case 248: /* assign_stm: DST_BLACKLIST EQUAL ID COLON LBRACE blst_elem_list RBRACE  */
+#line 1248 "cfg.y"
+                                                                            { IFOR();
+				s_tmp.s = (yyvsp[-4].strval);
+				s_tmp.len = strlen((yyvsp[-4].strval));
+				if (create_bl_head( BL_CORE_ID, BL_READONLY_LIST,
+				    bl_head, bl_tail, &s_tmp)==0) {
+					yyerror("failed to create blacklist\n");
+					YYABORT;
+				}
+				bl_head = bl_tail = NULL;
+				}
+#line 4250 "cfg.tab.c"
+    break;
+
+  case 249: /* assign_stm: DISABLE_STATELESS_FWD EQUAL NUMBER  */
+#line 1258 "cfg.y"
+                                                     { IFOR();
+				sl_fwd_disabled=(yyvsp[0].intval); }
+#line 4257 "cfg.tab.c"
+    break;
+
+  case 250: /* assign_stm: DB_VERSION_TABLE EQUAL STRING  */
+#line 1260 "cfg.y"
+                                                { IFOR();
+				db_version_table=(yyvsp[0].strval); }
+#line 4264 "cfg.tab.c"
+    break;
+
+  case 251: /* assign_stm: DB_VERSION_TABLE EQUAL error  */
+#line 1262 "cfg.y"
+                                               { yyerror("string value expected"); }
+#line 4270 "cfg.tab.c"
+    break;
+
+  case 252: /* assign_stm: DB_DEFAULT_URL EQUAL STRING  */
+#line 1263 "cfg.y"
+                                              { IFOR();
+				db_default_url=(yyvsp[0].strval); }
+#line 4277 "cfg.tab.c"
+    break;
+
+  case 253: /* assign_stm: DB_DEFAULT_URL EQUAL error  */
+#line 1265 "cfg.y"
+                                             { yyerror("string value expected"); }
+#line 4283 "cfg.tab.c"
+    break;
+
+  case 254: /* assign_stm: DB_MAX_ASYNC_CONNECTIONS EQUAL NUMBER  */
+#line 1266 "cfg.y"
+                                                        { IFOR();
+				db_max_async_connections=(yyvsp[0].intval); }
+#line 4290 "cfg.tab.c"
+    break;
+
+  case 255: /* assign_stm: DB_MAX_ASYNC_CONNECTIONS EQUAL error  */
+#line 1268 "cfg.y"
+                                                       {
+				yyerror("integer value expected");
+				}
+#line 4298 "cfg.tab.c"
+    break;
+
+  case 256: /* assign_stm: DB_ASYNC_EXECUTORS EQUAL NUMBER  */
+#line 1271 "cfg.y"
+                                                  { IFOR();
+				db_async_executors=(yyvsp[0].intval); }
+#line 4305 "cfg.tab.c"
+    break;
+
+  case 257: /* assign_stm: DB_ASYNC_EXECUTORS EQUAL error  */
+#line 1273 "cfg.y"
+                                                 {
+				yyerror("integer value expected");
+				}
+#line 4313 "cfg.tab.c"
+    break;
+
+  case 258: /* assign_stm: DB_PRELOAD_WORKERS EQUAL NUMBER  */
+#line 1276 "cfg.y"
+                                                  { IFOR();
+				db_preload_workers=(yyvsp[0].intval); }
+#line 4320 "cfg.tab.c"
+    break;
+
+  case 259: /* assign_stm: DB_PRELOAD_WORKERS EQUAL error  */
+#line 1278 "cfg.y"
+                                                 {
+				yyerror("integer value expected");
+				}
+#line 4328 "cfg.tab.c"
+    break;
+
+  case 260: /* assign_stm: IPC_QUEUE_SIZE EQUAL NUMBER  */
+#line 1281 "cfg.y"
+                                              { IFOR();
+				if ((yyvsp[0].intval) <= 0)
+					yyerror("positive IPC queue size expected");
+				else
+					ipc_queue_size=(yyvsp[0].intval); }
+#line 4338 "cfg.tab.c"
+    break;
+
+  case 261: /* assign_stm: IPC_QUEUE_SIZE EQUAL error  */
+#line 1286 "cfg.y"
+                                             {
+				yyerror("integer value expected");
+				}
+#line 4346 "cfg.tab.c"
+    break;
+
+  case 262: /* assign_stm: DISABLE_503_TRANSLATION EQUAL NUMBER  */
+#line 1289 "cfg.y"
+                                                       { IFOR();
+				disable_503_translation=(yyvsp[0].intval); }
+#line 4353 "cfg.tab.c"
+    break;
+
+  case 263: /* assign_stm: DISABLE_503_TRANSLATION EQUAL error  */
+#line 1291 "cfg.y"
+                                                      {
+				yyerror("integer value expected");
+				}
+#line 4361 "cfg.tab.c"
+    break;
+
+  case 264: /* assign_stm: AUTO_SCALING_PROFILE EQUAL auto_scale_profile_def  */
+#line 1294 "cfg.y"
+                                                                    {}
+#line 4367 "cfg.tab.c"
+    break;
+
+  case 265: /* assign_stm: AUTO_SCALING_PROFILE EQUAL error  */
+#line 1295 "cfg.y"
+                                                   {
+				yyerror("bad auto-scaling profile definition");
+				}
+#line 4375 "cfg.tab.c"
+    break;
+
+  case 266: /* assign_stm: AUTO_SCALING_CYCLE EQUAL NUMBER  */
+#line 1298 "cfg.y"
+                                                  { IFOR();
+				auto_scaling_cycle=(yyvsp[0].intval); }
+#line 4382 "cfg.tab.c"
+    break;
+
+  case 267: /* assign_stm: AUTO_SCALING_CYCLE EQUAL error  */
+#line 1300 "cfg.y"
+                                                 {
+				yyerror("integer value expected");
+				}
+#line 4390 "cfg.tab.c"
+    break;
+
+  case 268: /* assign_stm: AUTO_SCALING_POLICY EQUAL STRING  */
+#line 1303 "cfg.y"
+                                                   { IFOR();
+				if (set_auto_scaling_policy((yyvsp[0].strval))<0)
+					yyerror("unknown auto-scaling policy, \"load\" or "
+						"\"queue\" expected");
+				}
+#line 4400 "cfg.tab.c"
+    break;
+
+  case 269: /* assign_stm: AUTO_SCALING_POLICY EQUAL error  */
+#line 1308 "cfg.y"
+                                                  {
+				yyerror("string value expected");
+				}
+#line 4408 "cfg.tab.c"
+    break;
+
+  case 270: /* assign_stm: AUTO_SCALING_LATENCY EQUAL NUMBER  */
+#line 1311 "cfg.y"
+                                                    { IFOR();
+				if ((yyvsp[0].intval) <= 0)
+					yyerror("positive latency (usec) expected");
+				else
+					auto_scaling_latency=(yyvsp[0].intval);
+				}
+#line 4419 "cfg.tab.c"
+    break;
+
+  case 271: /* assign_stm: AUTO_SCALING_LATENCY EQUAL error  */
+#line 1317 "cfg.y"
+                                                   {
+				yyerror("integer value expected");
+				}
+#line 4427 "cfg.tab.c"
+    break;
+
+  case 272: /* assign_stm: AUTO_SCALING_SPARES EQUAL NUMBER  */
+#line 1320 "cfg.y"
+                                                   { IFOR();
+				auto_scaling_spares=(yyvsp[0].intval); }
+#line 4434 "cfg.tab.c"
+    break;
+
+  case 273: /* assign_stm: AUTO_SCALING_SPARES EQUAL error  */
+#line 1322 "cfg.y"
+                                                  {
+				yyerror("integer value expected");
+				}
+#line 4442 "cfg.tab.c"
+    break;
+
+  case 274: /* assign_stm: AUTO_SCALING_QUEUE EQUAL NUMBER  */
+#line 1325 "cfg.y"
+                                                  { IFOR();
+				if ((yyvsp[0].intval) <= 0)
+					yyerror("positive queue depth expected");
+				else
+					auto_scaling_queue=(yyvsp[0].intval);
+				}
+#line 4453 "cfg.tab.c"
+    break;
+
+  case 275: /* assign_stm: AUTO_SCALING_QUEUE EQUAL error  */
+#line 1331 "cfg.y"
+                                                 {
+				yyerror("integer value expected");
+				}
+#line 4461 "cfg.tab.c"
+    break;
+
+  case 276: /* assign_stm: error EQUAL  */
+#line 1334 "cfg.y"
+                              { yyerror("unknown config variable"); }
+#line 4467 "cfg.tab.c"
+    break;
+
+  case 277: /* module_stm: LOADMODULE STRING  */
+#line 1337 "cfg.y"
+                                        { IFOR();
+			if (load_module((yyvsp[0].strval)) < 0)
+				yyerrorf("failed to load module %s\n", (yyvsp[0].strval));
+		}
+#line 4476 "cfg.tab.c"
+    break;
+
+  case 278: /* module_stm: LOADMODULE error  */
+#line 1341 "cfg.y"
+                                        { yyerror("string expected");  }
+#line 4482 "cfg.tab.c"
+    break;
+
+  case 279: /* module_stm: MODPARAM LPAREN STRING COMMA STRING COMMA STRING RPAREN  */
+#line 1342 "cfg.y"
+                                                                          { IFOR();
+				if (set_mod_param_regex((yyvsp[-5].strval), (yyvsp[-3].strval), STR_PARAM, (yyvsp[-1].strval)) != 0) {
+					yyerrorf("Parameter <%s> not found in module <%s> - "
+						"can't set", (yyvsp[-3].strval), (yyvsp[-5].strval));
+				}
+			}
+#line 4493 "cfg.tab.c"
+    break;
+
+  case 280: /* module_stm: MODPARAM LPAREN STRING COMMA STRING COMMA snumber RPAREN  */
+#line 1348 "cfg.y"
+                                                                           { IFOR();
+				if (set_mod_param_regex((yyvsp[-5].strval), (yyvsp[-3].strval), INT_PARAM, (void*)(yyvsp[-1].intval)) != 0) {
+					yyerrorf("Parameter <%s> not found in module <%s> - "
+						"can't set", (yyvsp[-3].strval), (yyvsp[-5].strval));
+				}
+			}
+#line 4504 "cfg.tab.c"
+    break;
+
+  case 281: /* module_stm: MODPARAM error  */
+#line 1354 "cfg.y"
+                                 { yyerror("Invalid arguments"); }
+#line 4510 "cfg.tab.c"
+    break;
+
+  case 282: /* ip: ipv4  */
+#line 1358 "cfg.y"
+                       { (yyval.ipaddr)=(yyvsp[0].ipaddr); }
+#line 4516 "cfg.tab.c"
+    break;
+
+  case 283: /* ip: ipv6  */
+#line 1359 "cfg.y"
+                       { (yyval.ipaddr)=(yyvsp[0].ipaddr); }
+#line 4522 "cfg.tab.c"
+    break;
+
+  case 284: /* ipv4: IPV4ADDR  */
+#line 1362 "cfg.y"
+                 {
+					(yyval.ipaddr)=pkg_malloc(sizeof(struct ip_addr));
+					if ((yyval.ipaddr)==0){
+						LM_CRIT("ERROR: cfg. parser: out of memory.\n");
+						YYABORT;
+					}else{
+						memset((yyval.ipaddr), 0, sizeof(struct ip_addr));
+						(yyval.ipaddr)->af=AF_INET;
+						(yyval.ipaddr)->len=16;
+						if (inet_pton(AF_INET, (yyvsp[0].strval), (yyval.ipaddr)->u.addr)<=0){
+							yyerror("bad ipv4 address");
+						}
+					}
+				}
+#line 4541 "cfg.tab.c"
+    break;
+
+  case 285: /* ipv6addr: IPV6ADDR  */
+#line 1378 "cfg.y"
+                         {
+					(yyval.ipaddr)=pkg_malloc(sizeof(struct ip_addr));
+					if ((yyval.ipaddr)==0){
+						LM_CRIT("ERROR: cfg. parser: out of memory.\n");
+						YYABORT;
+					}else{
+						memset((yyval.ipaddr), 0, sizeof(struct ip_addr));
+						(yyval.ipaddr)->af=AF_INET6;
+						(yyval.ipaddr)->len=16;
+						if (inet_pton(AF_INET6, (yyvsp[0].strval), (yyval.ipaddr)->u.addr)<=0){
+							yyerror("bad ipv6 address");
+						}
+					}
+				}
+#line 4560 "cfg.tab.c"
+    break;
+
+  case 286: /* ipv6: ipv6addr  */
+#line 1394 "cfg.y"
+                 { (yyval.ipaddr)=(yyvsp[0].ipaddr); }
+#line 4566 "cfg.tab.c"
+    break;
+
+  case 287: /* ipv6: LBRACK ipv6addr RBRACK  */
+#line 1395 "cfg.y"
+                                 {(yyval.ipaddr)=(yyvsp[-1].ipaddr); }
+#line 4572 "cfg.tab.c"
+    break;
+
+  case 288: /* ipnet: IPNET  */
+#line 1398 "cfg.y"
+                {
+				if (parse_ipnet((yyvsp[0].strval), strlen((yyvsp[0].strval)), &net_tmp) < 0)
+					yyerror("unable to parse ip and/or netmask\n");
+
+				(yyval.ipnet) = net_tmp;
+			}
+#line 4583 "cfg.tab.c"
+    break;
+
+  case 289: /* ipnet: ip  */
+#line 1404 "cfg.y"
+                        {
+				(yyval.ipnet)=mk_net_bitlen((yyvsp[0].ipaddr), (yyvsp[0].ipaddr)->len*8);
+				pkg_free((yyvsp[0].ipaddr));
+			}
+#line 4592 "cfg.tab.c"
+    break;
+
+  case 290: /* folded_string: STRING STRING  */
+#line 1414 "cfg.y"
+                              {
+				(yyval.strval) = pkg_malloc( strlen((yyvsp[-1].strval)) + strlen((yyvsp[0].strval)) + 1);
+				if ((yyval.strval)==0){
+					yyerror("cfg. parser: out of memory");
+					YYABORT;
+				} else {
+					strcpy((yyval.strval),(yyvsp[-1].strval)); strcat((yyval.strval),(yyvsp[0].strval));
+					pkg_free((yyvsp[-1].strval)); pkg_free((yyvsp[0].strval));
+				}
+			}
+#line 4607 "cfg.tab.c"
+    break;
+
+  case 291: /* folded_string: folded_string STRING  */
+#line 1424 "cfg.y"
+                                       {
+				(yyval.strval) = pkg_malloc( strlen((yyvsp[-1].strval)) + strlen((yyvsp[0].strval)) + 1);
+				if ((yyval.strval)==0){
+					LM_CRIT("ERROR: cfg. parser: out of memory.\n");
+					YYABORT;
+				} else {
+					strcpy((yyval.strval),(yyvsp[-1].strval)); strcat((yyval.strval),(yyvsp[0].strval));
+					pkg_free((yyvsp[-1].strval)); pkg_free((yyvsp[0].strval));
+				}
+			}
+#line 4622 "cfg.tab.c"
+    break;
+
+  case 292: /* route_name: ID  */
+#line 1435 "cfg.y"
+                {
+				(yyval.strval) = (yyvsp[0].strval);
+				}
+#line 4630 "cfg.tab.c"
+    break;
+
+  case 293: /* route_name: NUMBER  */
+#line 1438 "cfg.y"
+                         {
+				tmp=int2str((yyvsp[0].intval), &i_tmp);
+				if (((yyval.strval)=pkg_malloc(i_tmp+1))==0) {
+					yyerror("cfg. parser: out of memory.\n");
+					YYABORT;
+				}
+				memcpy( (yyval.strval), tmp, i_tmp);
+				(yyval.strval)[i_tmp] = 0;
+				}
+#line 4644 "cfg.tab.c"
+    break;
+
+  case 294: /* route_name: STRING  */
+#line 1447 "cfg.y"
+                        {
+				(yyval.strval) = (yyvsp[0].strval);
+		}
+#line 4652 "cfg.tab.c"
+    break;
+
+  case 295: /* route_name_var: route_name  */
+#line 1452 "cfg.y"
+                           {
+				/* check to see if there are any "$" in the string name */
+				tmp = strchr((yyvsp[0].strval), '$');
+				if (!tmp) {
+					/* route name is a cosntant string - search for the route */
+					rn_tmp.data = 0;
+					rn_tmp.iname = get_script_route_idx((yyvsp[0].strval), sroutes->request,
+							RT_NO, 0);
+					if (rn_tmp.iname==-1)
+						yyerror("too many script routes");
+					(yyval.intval) = NUMBER_ST;
+				} else {
+					tstr.s = (yyvsp[0].strval);
+					tstr.len = strlen(tstr.s);
+					if (pv_parse_format(&tstr, &elem) < 0) {
+						yyerror("cannot parse format");
+						YYABORT;
+					}
+					/* the route name is a format, so we can't evaluate it now */
+					rn_tmp.ename = elem;
+					(yyval.intval) = SCRIPTVAR_ELEM_ST;
+				}
+			}
+#line 4680 "cfg.tab.c"
+    break;
+
+  case 296: /* route_name_var: script_var  */
+#line 1475 "cfg.y"
+                             {
+				rn_tmp.sname = (yyvsp[0].specval);
+				(yyval.intval) = SCRIPTVAR_ST;
+		}
+#line 4689 "cfg.tab.c"
+    break;
+
+  case 297: /* route_stm: ROUTE LBRACE actions RBRACE  */
+#line 1480 "cfg.y"
+                                        {
+						if (sroutes->request[DEFAULT_RT].a!=0) {
+							yyerror("overwriting default "
+								"request routing table");
+							YYABORT;
+						}
+						push((yyvsp[-1].action), &sroutes->request[DEFAULT_RT].a);
+					}
+#line 4702 "cfg.tab.c"
+    break;
+
+  case 298: /* route_stm: ROUTE LBRACK route_name RBRACK LBRACE actions RBRACE  */
+#line 1488 "cfg.y"
+                                                                       {
+						if ( strtol((yyvsp[-4].strval),&tmp,10)==0 && *tmp==0) {
+							/* route[0] detected */
+							if (sroutes->request[DEFAULT_RT].a!=0) {
+								yyerror("overwriting(2) default "
+									"request routing table");
+								YYABORT;
+							}
+							push((yyvsp[-1].action), &sroutes->request[DEFAULT_RT].a);
+						} else {
+							i_tmp = get_script_route_idx( (yyvsp[-4].strval),
+								sroutes->request, RT_NO,1);
+							if (i_tmp==-1) YYABORT;
+							push((yyvsp[-1].action), &sroutes->request[i_tmp].a);
+						}
+					}
+#line 4723 "cfg.tab.c"
+    break;
+
+  case 299: /* route_stm: ROUTE error  */
+#line 1504 "cfg.y"
+                              { yyerror("invalid  route  statement"); }
+#line 4729 "cfg.tab.c"
+    break;
+
+  case 300: /* failure_route_stm: ROUTE_FAILURE LBRACK route_name RBRACK LBRACE actions RBRACE  */
+#line 1507 "cfg.y"
+                                                                                {
+						i_tmp = get_script_route_idx( (yyvsp[-4].strval), sroutes->failure,
+							FAILURE_RT_NO,1);
+						if (i_tmp==-1) YYABORT;
+						push((yyvsp[-1].action), &sroutes->failure[i_tmp].a);
+					}
+#line 4740 "cfg.tab.c"
+    break;
+
+  case 301: /* failure_route_stm: ROUTE_FAILURE error  */
+#line 1513 "cfg.y"
+                                      { yyerror("invalid failure_route statement"); }
+#line 4746 "cfg.tab.c"
+    break;
+
+  case 302: /* onreply_route_stm: ROUTE_ONREPLY LBRACE actions RBRACE  */
+#line 1516 "cfg.y"
+                                                       {
+						if (sroutes->onreply[DEFAULT_RT].a!=0) {
+							yyerror("overwriting default "
+								"onreply routing table");
+							YYABORT;
+						}
+						push((yyvsp[-1].action), &sroutes->onreply[DEFAULT_RT].a);
+					}
+#line 4759 "cfg.tab.c"
+    break;
+
+  case 303: /* onreply_route_stm: ROUTE_ONREPLY LBRACK route_name RBRACK LBRACE actions RBRACE  */
+#line 1524 "cfg.y"
+                                                                               {
+						i_tmp = get_script_route_idx( (yyvsp[-4].strval), sroutes->onreply,
+							ONREPLY_RT_NO,1);
+						if (i_tmp==-1) YYABORT;
+						push((yyvsp[-1].action), &sroutes->onreply[i_tmp].a);
+					}
+#line 4770 "cfg.tab.c"
+    break;
+
+  case 304: /* onreply_route_stm: ROUTE_ONREPLY error  */
+#line 1530 "cfg.y"
+                                      { yyerror("invalid onreply_route statement"); }
+#line 4776 "cfg.tab.c"
+    break;
+
+  case 305: /* branch_route_stm: ROUTE_BRANCH LBRACK route_name RBRACK LBRACE actions RBRACE  */
+#line 1533 "cfg.y"
+                                                                              {
+						i_tmp = get_script_route_idx( (yyvsp[-4].strval), sroutes->branch,
+							BRANCH_RT_NO,1);
+						if (i_tmp==-1) YYABORT;
+						push((yyvsp[-1].action), &sroutes->branch[i_tmp].a);
+					}
+#line 4787 "cfg.tab.c"
+    break;
+
+  case 306: /* branch_route_stm: ROUTE_BRANCH error  */
+#line 1539 "cfg.y"
+                                     { yyerror("invalid branch_route statement"); }
+#line 4793 "cfg.tab.c"
+    break;
+
+  case 307: /* error_route_stm: ROUTE_ERROR LBRACE actions RBRACE  */
+#line 1542 "cfg.y"
+                                                    {
+						if (sroutes->error.a!=0) {
+							yyerror("overwriting default "
+								"error routing table");
+							YYABORT;
+						}
+						push((yyvsp[-1].action), &sroutes->error.a);
+					}
+#line 4806 "cfg.tab.c"
+    break;
+
+  case 308: /* error_route_stm: ROUTE_ERROR error  */
+#line 1550 "cfg.y"
+                                    { yyerror("invalid error_route statement"); }
+#line 4812 "cfg.tab.c"
+    break;
+
+  case 309: /* local_route_stm: ROUTE_LOCAL LBRACE actions RBRACE  */
+#line 1553 "cfg.y"
+                                                    {
+						if (sroutes->local.a!=0) {
+							yyerror("re-definition of local "
+								"route detected");
+							YYABORT;
+						}
+						push((yyvsp[-1].action), &sroutes->local.a);
+					}
+#line 4825 "cfg.tab.c"
+    break;
+
+  case 310: /* local_route_stm: ROUTE_LOCAL error  */
+#line 1561 "cfg.y"
+                                    { yyerror("invalid local_route statement"); }
+#line 4831 "cfg.tab.c"
+    break;
+
+  case 311: /* startup_route_stm: ROUTE_STARTUP LBRACE actions RBRACE  */
+#line 1564 "cfg.y"
+                                                        {
+						if (sroutes->startup.a!=0) {
+							yyerror("re-definition of startup "
+								"route detected");
+							YYABORT;
+						}
+						push((yyvsp[-1].action), &sroutes->startup.a);
+					}
+#line 4844 "cfg.tab.c"
+    break;
+
+  case 312: /* startup_route_stm: ROUTE_STARTUP error  */
+#line 1572 "cfg.y"
+                                      { yyerror("invalid startup_route statement"); }
+#line 4850 "cfg.tab.c"
+    break;
+
+  case 313: /* timer_route_stm: ROUTE_TIMER LBRACK route_name COMMA NUMBER RBRACK LBRACE actions RBRACE  */
+#line 1575 "cfg.y"
+                                                                                          {
+						i_tmp = 0;
+						while(sroutes->timer[i_tmp].a!=0 && i_tmp<TIMER_RT_NO){
+							i_tmp++;
+						}
+						if(i_tmp == TIMER_RT_NO) {
+							yyerror("Too many timer routes defined\n");
+							YYABORT;
+						}
+						sroutes->timer[i_tmp].name = (yyvsp[-6].strval);
+						sroutes->timer[i_tmp].interval = (yyvsp[-4].intval);
+						push((yyvsp[-1].action), &sroutes->timer[i_tmp].a);
+					}
+#line 4868 "cfg.tab.c"
+    break;
+
+  case 314: /* timer_route_stm: ROUTE_TIMER error  */
+#line 1588 "cfg.y"
+                                    { yyerror("invalid timer_route statement"); }
+#line 4874 "cfg.tab.c"
+    break;
+
+  case 315: /* event_route_stm: ROUTE_EVENT LBRACK route_name RBRACK LBRACE actions RBRACE  */
+#line 1591 "cfg.y"
+                                                                            {
+						i_tmp = get_script_route_idx((yyvsp[-4].strval), sroutes->event,
+								EVENT_RT_NO,1);
+						if (i_tmp==-1) YYABORT;
+						push((yyvsp[-1].action), &sroutes->event[i_tmp].a);
+					}
+#line 4885 "cfg.tab.c"
+    break;
+
+  case 316: /* event_route_stm: ROUTE_EVENT error  */
+#line 1597 "cfg.y"
+                                    { yyerror("invalid event_route statement"); }
+#line 4891 "cfg.tab.c"
+    break;
+
+  case 317: /* exp: exp AND exp  */
+#line 1602 "cfg.y"
+                        { (yyval.expr)=mk_exp(AND_OP, (yyvsp[-2].expr), (yyvsp[0].expr)); }
+#line 4897 "cfg.tab.c"
+    break;
+
+  case 318: /* exp: exp OR exp  */
+#line 1603 "cfg.y"
+                                { (yyval.expr)=mk_exp(OR_OP, (yyvsp[-2].expr), (yyvsp[0].expr));  }
+#line 4903 "cfg.tab.c"
+    break;
+
+  case 319: /* exp: NOT exp  */
+#line 1604 "cfg.y"
+                                        { (yyval.expr)=mk_exp(NOT_OP, (yyvsp[0].expr), 0);  }
+#line 4909 "cfg.tab.c"
+    break;
+
+  case 320: /* exp: LPAREN exp RPAREN  */
+#line 1605 "cfg.y"
+                                { (yyval.expr)=mk_exp(EVAL_OP, (yyvsp[-1].expr), 0); }
+#line 4915 "cfg.tab.c"
+    break;
+
+  case 321: /* exp: LBRACK assignexp RBRACK  */
+#line 1606 "cfg.y"
+                                  { (yyval.expr)=(yyvsp[-1].expr); }
+#line 4921 "cfg.tab.c"
+    break;
+
+  case 322: /* exp: exp_elem  */
+#line 1607 "cfg.y"
+                                        { (yyval.expr)=(yyvsp[0].expr); }
+#line 4927 "cfg.tab.c"
+    break;
+
+  case 323: /* equalop: EQUAL_T  */
+#line 1610 "cfg.y"
+                          {(yyval.intval)=EQUAL_OP; }
+#line 4933 "cfg.tab.c"
+    break;
+
+  case 324: /* equalop: DIFF  */
+#line 1611 "cfg.y"
+                                {(yyval.intval)=DIFF_OP; }
+#line 4939 "cfg.tab.c"
+    break;
+
+  case 325: /* compop: GT  */
+#line 1614 "cfg.y"
+                {(yyval.intval)=GT_OP; }
+#line 4945 "cfg.tab.c"
+    break;
+
+  case 326: /* compop: LT  */
+#line 1615 "cfg.y"
+                        {(yyval.intval)=LT_OP; }
+#line 4951 "cfg.tab.c"
+    break;
+
+  case 327: /* compop: GTE  */
+#line 1616 "cfg.y"
+                        {(yyval.intval)=GTE_OP; }
+#line 4957 "cfg.tab.c"
+    break;
+
+  case 328: /* compop: LTE  */
+#line 1617 "cfg.y"
+                        {(yyval.intval)=LTE_OP; }
+#line 4963 "cfg.tab.c"
+    break;
+
+  case 329: /* matchop: MATCH  */
+#line 1619 "cfg.y"
+                {(yyval.intval)=MATCH_OP; }
+#line 4969 "cfg.tab.c"
+    break;
+
+  case 330: /* matchop: NOTMATCH  */
+#line 1620 "cfg.y"
+                                {(yyval.intval)=NOTMATCH_OP; }
+#line 4975 "cfg.tab.c"
+    break;
+
+  case 331: /* intop: equalop  */
+#line 1623 "cfg.y"
+                {(yyval.intval)=(yyvsp[0].intval); }
+#line 4981 "cfg.tab.c"
+    break;
+
+  case 332: /* intop: compop  */
+#line 1624 "cfg.y"
+                        {(yyval.intval)=(yyvsp[0].intval); }
+#line 4987 "cfg.tab.c"
+    break;
+
+  case 333: /* strop: equalop  */
+#line 1627 "cfg.y"
+                {(yyval.intval)=(yyvsp[0].intval); }
+#line 4993 "cfg.tab.c"
+    break;
+
+  case 334: /* strop: compop  */
+#line 1628 "cfg.y"
+                     {(yyval.intval)=(yyvsp[0].intval); }
+#line 4999 "cfg.tab.c"
+    break;
+
+  case 335: /* strop: matchop  */
+#line 1629 "cfg.y"
+                                {(yyval.intval)=(yyvsp[0].intval); }
+#line 5005 "cfg.tab.c"
+    break;
+
+  case 336: /* script_var: SCRIPTVAR  */
+#line 1632 "cfg.y"
+                                {
+				spec = (pv_spec_t*)pkg_malloc(sizeof(pv_spec_t));
+				if (spec==NULL){
+					yyerror("no more pkg memory\n");
+					YYABORT;
+				}
+				memset(spec, 0, sizeof(pv_spec_t));
+				tstr.s = (yyvsp[0].strval);
+				tstr.len = strlen(tstr.s);
+				if(pv_parse_spec(&tstr, spec)==NULL)
+				{
+					yyerror("unknown script variable");
+				}
+
+				(yyval.specval) = spec;
+			}
+#line 5026 "cfg.tab.c"
+    break;
+
+  case 337: /* script_var: SCRIPTVARERR  */
+#line 1648 "cfg.y"
+                               {
+			(yyval.specval)=0; yyerror("invalid script variable name");
+		}
+#line 5034 "cfg.tab.c"
+    break;
+
+  case 338: /* exp_elem: exp_cond  */
+#line 1653 "cfg.y"
+                                {(yyval.expr)=(yyvsp[0].expr); }
+#line 5040 "cfg.tab.c"
+    break;
+
+  case 339: /* exp_elem: exp_stm  */
+#line 1654 "cfg.y"
+                                        {(yyval.expr)=mk_elem( NO_OP, ACTION_O, 0, ACTIONS_ST, (yyvsp[0].action) ); }
+#line 5046 "cfg.tab.c"
+    break;
+
+  case 340: /* exp_elem: snumber  */
+#line 1655 "cfg.y"
+                                        {(yyval.expr)=mk_elem( NO_OP, NUMBER_O, 0, NUMBER_ST,
+											(void*)(yyvsp[0].intval) ); }
+#line 5053 "cfg.tab.c"
+    break;
+
+  case 341: /* exp_elem: script_var  */
+#line 1657 "cfg.y"
+                                {
+				(yyval.expr)=mk_elem(NO_OP, SCRIPTVAR_O,0,SCRIPTVAR_ST,(void*)(yyvsp[0].specval));
+			}
+#line 5061 "cfg.tab.c"
+    break;
+
+  case 342: /* exp_cond: script_var strop script_var  */
+#line 1662 "cfg.y"
+                                      {
+				(yyval.expr)=mk_elem( (yyvsp[-1].intval), SCRIPTVAR_O,(void*)(yyvsp[-2].specval),SCRIPTVAR_ST,(void*)(yyvsp[0].specval));
+			}
+#line 5069 "cfg.tab.c"
+    break;
+
+  case 343: /* exp_cond: script_var strop STRING  */
+#line 1665 "cfg.y"
+                                          {
+				(yyval.expr)=mk_elem( (yyvsp[-1].intval), SCRIPTVAR_O,(void*)(yyvsp[-2].specval),STR_ST,(yyvsp[0].strval));
+			}
+#line 5077 "cfg.tab.c"
+    break;
+
+  case 344: /* exp_cond: script_var intop snumber  */
+#line 1668 "cfg.y"
+                                           {
+				(yyval.expr)=mk_elem( (yyvsp[-1].intval), SCRIPTVAR_O,(void*)(yyvsp[-2].specval),NUMBER_ST,(void *)(yyvsp[0].intval));
+			}
+#line 5085 "cfg.tab.c"
+    break;
+
+  case 345: /* exp_cond: script_var equalop NULLV  */
+#line 1671 "cfg.y"
+                                                {
+				(yyval.expr)=mk_elem( (yyvsp[-1].intval), SCRIPTVAR_O,(void*)(yyvsp[-2].specval), NULLV_ST, 0);
+			}
+#line 5093 "cfg.tab.c"
+    break;
+
+  case 346: /* exp_cond: script_var equalop ipnet  */
+#line 1674 "cfg.y"
+                                           {
+				(yyval.expr)=mk_elem((yyvsp[-1].intval), SCRIPTVAR_O, (void*)(yyvsp[-2].specval), NET_ST, (yyvsp[0].ipnet));
+			}
+#line 5101 "cfg.tab.c"
+    break;
+
+  case 347: /* assignop: EQUAL  */
+#line 1680 "cfg.y"
+              { (yyval.intval) = EQ_T; }
+#line 5107 "cfg.tab.c"
+    break;
+
+  case 348: /* assignop: COLONEQ  */
+#line 1681 "cfg.y"
+                  { (yyval.intval) = COLONEQ_T; }
+#line 5113 "cfg.tab.c"
+    break;
+
+  case 349: /* assignop: PLUSEQ  */
+#line 1682 "cfg.y"
+                 { (yyval.intval) = PLUSEQ_T; }
+#line 5119 "cfg.tab.c"
+    break;
+
+  case 350: /* assignop: MINUSEQ  */
+#line 1683 "cfg.y"
+                  { (yyval.intval) = MINUSEQ_T;}
+#line 5125 "cfg.tab.c"
+    break;
+
+  case 351: /* assignop: SLASHEQ  */
+#line 1684 "cfg.y"
+                  { (yyval.intval) = DIVEQ_T; }
+#line 5131 "cfg.tab.c"
+    break;
+
+  case 352: /* assignop: MULTEQ  */
+#line 1685 "cfg.y"
+                 { (yyval.intval) = MULTEQ_T; }
+#line 5137 "cfg.tab.c"
+    break;
+
+  case 353: /* assignop: MODULOEQ  */
+#line 1686 "cfg.y"
+                   { (yyval.intval) = MODULOEQ_T; }
+#line 5143 "cfg.tab.c"
+    break;
+
+  case 354: /* assignop: BANDEQ  */
+#line 1687 "cfg.y"
+                 { (yyval.intval) = BANDEQ_T; }
+#line 5149 "cfg.tab.c"
+    break;
+
+  case 355: /* assignop: BOREQ  */
+#line 1688 "cfg.y"
+                { (yyval.intval) = BOREQ_T; }
+#line 5155 "cfg.tab.c"
+    break;
+
+  case 356: /* assignop: BXOREQ  */
+#line 1689 "cfg.y"
+                 { (yyval.intval) = BXOREQ_T; }
+#line 5161 "cfg.tab.c"
+    break;
+
+  case 357: /* assignexp: snumber  */
+#line 1693 "cfg.y"
+                { (yyval.expr) = mk_elem(VALUE_OP, NUMBERV_O, (void*)(yyvsp[0].intval), 0, 0); }
+#line 5167 "cfg.tab.c"
+    break;
+
+  case 358: /* assignexp: STRING  */
+#line 1694 "cfg.y"
+                 { (yyval.expr) = mk_elem(VALUE_OP, STRINGV_O, (yyvsp[0].strval), 0, 0); }
+#line 5173 "cfg.tab.c"
+    break;
+
+  case 359: /* assignexp: script_var  */
+#line 1695 "cfg.y"
+                     { (yyval.expr) = mk_elem(VALUE_OP, SCRIPTVAR_O, (yyvsp[0].specval), 0, 0); }
+#line 5179 "cfg.tab.c"
+    break;
+
+  case 360: /* assignexp: exp_cond  */
+#line 1696 "cfg.y"
+                   { (yyval.expr)= (yyvsp[0].expr); }
+#line 5185 "cfg.tab.c"
+    break;
+
+  case 361: /* assignexp: cmd  */
+#line 1697 "cfg.y"
+              { (yyval.expr)=mk_elem( NO_OP, ACTION_O, 0, ACTIONS_ST, (yyvsp[0].action) ); }
+#line 5191 "cfg.tab.c"
+    break;
+
+  case 362: /* assignexp: assignexp PLUS assignexp  */
+#line 1698 "cfg.y"
+                                   {
+				(yyval.expr) = mk_elem(PLUS_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5199 "cfg.tab.c"
+    break;
+
+  case 363: /* assignexp: assignexp MINUS assignexp  */
+#line 1701 "cfg.y"
+                                    {
+				(yyval.expr) = mk_elem(MINUS_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5207 "cfg.tab.c"
+    break;
+
+  case 364: /* assignexp: assignexp MULT assignexp  */
+#line 1704 "cfg.y"
+                                   {
+				(yyval.expr) = mk_elem(MULT_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5215 "cfg.tab.c"
+    break;
+
+  case 365: /* assignexp: assignexp SLASH assignexp  */
+#line 1707 "cfg.y"
+                                    {
+				(yyval.expr) = mk_elem(DIV_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5223 "cfg.tab.c"
+    break;
+
+  case 366: /* assignexp: assignexp MODULO assignexp  */
+#line 1710 "cfg.y"
+                                     {
+				(yyval.expr) = mk_elem(MODULO_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5231 "cfg.tab.c"
+    break;
+
+  case 367: /* assignexp: assignexp BAND assignexp  */
+#line 1713 "cfg.y"
+                                   {
+				(yyval.expr) = mk_elem(BAND_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5239 "cfg.tab.c"
+    break;
+
+  case 368: /* assignexp: assignexp BOR assignexp  */
+#line 1716 "cfg.y"
+                                  {
+				(yyval.expr) = mk_elem(BOR_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5247 "cfg.tab.c"
+    break;
+
+  case 369: /* assignexp: assignexp BXOR assignexp  */
+#line 1719 "cfg.y"
+                                   {
+				(yyval.expr) = mk_elem(BXOR_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5255 "cfg.tab.c"
+    break;
+
+  case 370: /* assignexp: assignexp BLSHIFT assignexp  */
+#line 1722 "cfg.y"
+                                      {
+				(yyval.expr) = mk_elem(BLSHIFT_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5263 "cfg.tab.c"
+    break;
+
+  case 371: /* assignexp: assignexp BRSHIFT assignexp  */
+#line 1725 "cfg.y"
+                                      {
+				(yyval.expr) = mk_elem(BRSHIFT_OP, EXPR_O, (yyvsp[-2].expr), EXPR_ST, (yyvsp[0].expr));
+			}
+#line 5271 "cfg.tab.c"
+    break;
+
+  case 372: /* assignexp: BNOT assignexp  */
+#line 1728 "cfg.y"
+                         {
+				(yyval.expr) = mk_elem(BNOT_OP, EXPR_O, (yyvsp[0].expr), 0, 0);
+			}
+#line 5279 "cfg.tab.c"
+    break;
+
+  case 373: /* assignexp: LPAREN assignexp RPAREN  */
+#line 1731 "cfg.y"
+                                  { (yyval.expr) = (yyvsp[-1].expr); }
+#line 5285 "cfg.tab.c"
+    break;
+
+  case 374: /* assign_cmd: script_var assignop assignexp  */
+#line 1734 "cfg.y"
+                                          {
+			if(!pv_is_w((yyvsp[-2].specval)))
+				yyerror("invalid left operand in assignment");
+			if((yyvsp[-2].specval)->trans!=0)
+				yyerror("transformations not accepted in left side "
+					"of assignment");
+
+			mk_action2( (yyval.action), (yyvsp[-1].intval),
+					SCRIPTVAR_ST,
+					EXPR_ST,
+					(yyvsp[-2].specval),
+					(yyvsp[0].expr));
+		}
+#line 5303 "cfg.tab.c"
+    break;
+
+  case 375: /* assign_cmd: script_var EQUAL NULLV  */
+#line 1747 "cfg.y"
+                                  {
+			if(!pv_is_w((yyvsp[-2].specval)))
+				yyerror("invalid left operand in assignment");
+			if((yyvsp[-2].specval)->trans!=0)
+				yyerror("transformations not accepted in left side "
+					"of assignment");
+
+			mk_action2( (yyval.action), EQ_T,
+					SCRIPTVAR_ST,
+					NULLV_ST,
+					(yyvsp[-2].specval),
+					0);
+		}
+#line 5321 "cfg.tab.c"
+    break;
+
+  case 376: /* assign_cmd: script_var COLONEQ NULLV  */
+#line 1760 "cfg.y"
+                                    {
+			if(!pv_is_w((yyvsp[-2].specval)))
+				yyerror("invalid left operand in assignment");
+			/* not all can get NULL with := */
+			switch((yyvsp[-2].specval)->type) {
+				case PVT_AVP:
+				break;
+				default:
+					yyerror("invalid left operand in NULL assignment");
+			}
+			if((yyvsp[-2].specval)->trans!=0)
+				yyerror("transformations not accepted in left side "
+					"of assignment");
+
+			mk_action2( (yyval.action), COLONEQ_T,
+					SCRIPTVAR_ST,
+					NULLV_ST,
+					(yyvsp[-2].specval),
+					0);
+		}
+#line 5346 "cfg.tab.c"
+    break;
+
+  case 377: /* exp_stm: cmd  */
+#line 1782 "cfg.y"
+                                                                { (yyval.action)=(yyvsp[0].action); }
+#line 5352 "cfg.tab.c"
+    break;
+
+  case 378: /* exp_stm: if_cmd  */
+#line 1783 "cfg.y"
+                                                                { (yyval.action)=(yyvsp[0].action); }
+#line 5358 "cfg.tab.c"
+    break;
+
+  case 379: /* exp_stm: assign_cmd  */
+#line 1784 "cfg.y"
+                                                                { (yyval.action)=(yyvsp[0].action); }
+#line 5364 "cfg.tab.c"
+    break;
+
+  case 380: /* exp_stm: LBRACE actions RBRACE  */
+#line 1785 "cfg.y"
+                                                { (yyval.action)=(yyvsp[-1].action); }
+#line 5370 "cfg.tab.c"
+    break;
+
+  case 381: /* exp_stm: LBRACE RBRACE  */
+#line 1786 "cfg.y"
+                                                        { (yyval.action)=0; }
+#line 5376 "cfg.tab.c"
+    break;
+
+  case 382: /* brk_stm: brk_action  */
+#line 1789 "cfg.y"
+                                                                { (yyval.action)=(yyvsp[0].action); }
+#line 5382 "cfg.tab.c"
+    break;
+
+  case 383: /* brk_stm: LBRACE brk_actions RBRACE  */
+#line 1790 "cfg.y"
+                                                        { (yyval.action)=(yyvsp[-1].action); }
+#line 5388 "cfg.tab.c"
+    break;
+
+  case 384: /* brk_stm: LBRACE RBRACE  */
+#line 1791 "cfg.y"
+                                                        { (yyval.action)=0; }
+#line 5394 "cfg.tab.c"
+    break;
+
+  case 385: /* stm: action  */
+#line 1794 "cfg.y"
+                                                        { (yyval.action)=(yyvsp[0].action); }
+#line 5400 "cfg.tab.c"
+    break;
+
+  case 386: /* stm: LBRACE actions RBRACE  */
+#line 1795 "cfg.y"
+                                                { (yyval.action)=(yyvsp[-1].action); }
+#line 5406 "cfg.tab.c"
+    break;
+
+  case 387: /* stm: LBRACE RBRACE  */
+#line 1796 "cfg.y"
+                                                        { (yyval.action)=0; }
+#line 5412 "cfg.tab.c"
+    break;
+
+  case 388: /* actions: actions action  */
+#line 1799 "cfg.y"
+                                {(yyval.action)=append_action((yyvsp[-1].action), (yyvsp[0].action)); }
+#line 5418 "cfg.tab.c"
+    break;
+
+  case 389: /* actions: action  */
+#line 1800 "cfg.y"
+                                                {(yyval.action)=(yyvsp[0].action);}
+#line 5424 "cfg.tab.c"
+    break;
+
+  case 390: /* actions: actions error  */
+#line 1801 "cfg.y"
+                                { (yyval.action)=0; yyerror("bad command!)"); }
+#line 5430 "cfg.tab.c"
+    break;
+
+  case 391: /* brk_actions: brk_actions brk_action  */
+#line 1805 "cfg.y"
+                                        {(yyval.action)=append_action((yyvsp[-1].action), (yyvsp[0].action)); }
+#line 5436 "cfg.tab.c"
+    break;
+
+  case 392: /* brk_actions: brk_action  */
+#line 1806 "cfg.y"
+                                                {(yyval.action)=(yyvsp[0].action);}
+#line 5442 "cfg.tab.c"
+    break;
+
+  case 393: /* brk_actions: brk_actions error  */
+#line 1807 "cfg.y"
+                                    { (yyval.action)=0; yyerror("bad command!)"); }
+#line 5448 "cfg.tab.c"
+    break;
+
+  case 394: /* action: cmd SEMICOLON  */
+#line 1810 "cfg.y"
+                              {(yyval.action)=(yyvsp[-1].action);}
+#line 5454 "cfg.tab.c"
+    break;
+
+  case 395: /* action: if_cmd  */
+#line 1811 "cfg.y"
+                         {(yyval.action)=(yyvsp[0].action);}
+#line 5460 "cfg.tab.c"
+    break;
+
+  case 396: /* action: while_cmd  */
+#line 1812 "cfg.y"
+                            {(yyval.action)=(yyvsp[0].action);}
+#line 5466 "cfg.tab.c"
+    break;
+
+  case 397: /* action: foreach_cmd  */
+#line 1813 "cfg.y"
+                              {(yyval.action)=(yyvsp[0].action);}
+#line 5472 "cfg.tab.c"
+    break;
+
+  case 398: /* action: switch_cmd  */
+#line 1814 "cfg.y"
+                             {(yyval.action)=(yyvsp[0].action);}
+#line 5478 "cfg.tab.c"
+    break;
+
+  case 399: /* action: assign_cmd SEMICOLON  */
+#line 1815 "cfg.y"
+                                       {(yyval.action)=(yyvsp[-1].action);}
+#line 5484 "cfg.tab.c"
+    break;
+
+  case 400: /* action: SEMICOLON  */
+#line 1816 "cfg.y"
+                                              {(yyval.action)=0;}
+#line 5490 "cfg.tab.c"
+    break;
+
+  case 401: /* action: cmd error  */
+#line 1817 "cfg.y"
+                            { (yyval.action)=0; yyerror("bad command: missing ';'?"); }
+#line 5496 "cfg.tab.c"
+    break;
+
+  case 402: /* brk_action: BREAK SEMICOLON  */
+#line 1820 "cfg.y"
+                            { mk_action0((yyval.action), BREAK_T);}
+#line 5502 "cfg.tab.c"
+    break;
+
+  case 403: /* brk_action: cmd SEMICOLON  */
+#line 1821 "cfg.y"
+                                {(yyval.action)=(yyvsp[-1].action);}
+#line 5508 "cfg.tab.c"
+    break;
+
+  case 404: /* brk_action: brk_if_cmd  */
+#line 1822 "cfg.y"
+                             {(yyval.action)=(yyvsp[0].action);}
+#line 5514 "cfg.tab.c"
+    break;
+
+  case 405: /* brk_action: while_cmd  */
+#line 1823 "cfg.y"
+                            {(yyval.action)=(yyvsp[0].action);}
+#line 5520 "cfg.tab.c"
+    break;
+
+  case 406: /* brk_action: foreach_cmd  */
+#line 1824 "cfg.y"
+                              {(yyval.action)=(yyvsp[0].action);}
+#line 5526 "cfg.tab.c"
+    break;
+
+  case 407: /* brk_action: switch_cmd  */
+#line 1825 "cfg.y"
+                             {(yyval.action)=(yyvsp[0].action);}
+#line 5532 "cfg.tab.c"
+    break;
+
+  case 408: /* brk_action: assign_cmd SEMICOLON  */
+#line 1826 "cfg.y"
+                                       {(yyval.action)=(yyvsp[-1].action);}
+#line 5538 "cfg.tab.c"
+    break;
+
+  case 409: /* brk_action: SEMICOLON  */
+#line 1827 "cfg.y"
+                                              {(yyval.action)=0;}
+#line 5544 "cfg.tab.c"
+    break;
+
+  case 410: /* brk_action: cmd error  */
+#line 1828 "cfg.y"
+                            { (yyval.action)=0; yyerror("bad command: missing ';'?"); }
+#line 5550 "cfg.tab.c"
+    break;
+
+  case 411: /* brk_if_cmd: IF LPAREN exp RPAREN brk_stm  */
+#line 1831 "cfg.y"
+                                                                { mk_action3( (yyval.action), IF_T,
+													 EXPR_ST,
+													 ACTIONS_ST,
+													 NOSUBTYPE,
+													 (yyvsp[-2].expr),
+													 (yyvsp[0].action),
+													 0);
+									}
+#line 5563 "cfg.tab.c"
+    break;
+
+  case 412: /* brk_if_cmd: IF LPAREN exp RPAREN brk_stm ELSE brk_stm  */
+#line 1839 "cfg.y"
+                                                                        { mk_action3( (yyval.action), IF_T,
+													 EXPR_ST,
+													 ACTIONS_ST,
+													 ACTIONS_ST,
+													 (yyvsp[-4].expr),
+													 (yyvsp[-2].action),
+													 (yyvsp[0].action));
+									}
+#line 5576 "cfg.tab.c"
+    break;
+
+  case 413: /* if_cmd: IF LPAREN exp RPAREN stm  */
+#line 1849 "cfg.y"
+                                                                        { mk_action3( (yyval.action), IF_T,
+													 EXPR_ST,
+													 ACTIONS_ST,
+													 NOSUBTYPE,
+													 (yyvsp[-2].expr),
+													 (yyvsp[0].action),
+													 0);
+									}
+#line 5589 "cfg.tab.c"
+    break;
+
+  case 414: /* if_cmd: IF LPAREN exp RPAREN stm ELSE stm  */
+#line 1857 "cfg.y"
+                                                                { mk_action3( (yyval.action), IF_T,
+													 EXPR_ST,
+													 ACTIONS_ST,
+													 ACTIONS_ST,
+													 (yyvsp[-4].expr),
+													 (yyvsp[-2].action),
+													 (yyvsp[0].action));
+									}
+#line 5602 "cfg.tab.c"
+    break;
+
+  case 415: /* while_cmd: WHILE LPAREN exp RPAREN brk_stm  */
+#line 1867 "cfg.y"
+                                                        { mk_action2( (yyval.action), WHILE_T,
+													 EXPR_ST,
+													 ACTIONS_ST,
+													 (yyvsp[-2].expr),
+													 (yyvsp[0].action));
+									}
+#line 5613 "cfg.tab.c"
+    break;
+
+  case 416: /* foreach_cmd: FOR LPAREN script_var IN script_var RPAREN brk_stm  */
+#line 1875 "cfg.y"
+                                                                   {
+					if ((yyvsp[-4].specval)->type != PVT_SCRIPTVAR &&
+					    (yyvsp[-4].specval)->type != PVT_AVP &&
+						pv_type((yyvsp[-4].specval)->type) != PVT_JSON) {
+						yyerror("\nfor-each statement: only \"var\", \"avp\" "
+					            "and \"json\" iterators are supported!");
+					}
+
+					mk_action3( (yyval.action), FOR_EACH_T,
+					            SCRIPTVAR_ST,
+					            SCRIPTVAR_ST,
+					            ACTIONS_ST,
+					            (yyvsp[-4].specval),
+					            (yyvsp[-2].specval),
+					            (yyvsp[0].action));
+					}
+#line 5634 "cfg.tab.c"
+    break;
+
+  case 417: /* switch_cmd: SWITCH LPAREN script_var RPAREN LBRACE switch_stm RBRACE  */
+#line 1893 "cfg.y"
+                                                                                        {
+											mk_action2( (yyval.action), SWITCH_T,
+														SCRIPTVAR_ST,
+														ACTIONS_ST,
+														(yyvsp[-4].specval),
+														(yyvsp[-1].action));
+									}
+#line 5646 "cfg.tab.c"
+    break;
+
+  case 418: /* switch_stm: case_stms default_stm  */
+#line 1902 "cfg.y"
+                                  { (yyval.action)=append_action((yyvsp[-1].action), (yyvsp[0].action)); }
+#line 5652 "cfg.tab.c"
+    break;
+
+  case 419: /* switch_stm: case_stms  */
+#line 1903 "cfg.y"
+                                                { (yyval.action)=(yyvsp[0].action); }
+#line 5658 "cfg.tab.c"
+    break;
+
+  case 420: /* case_stms: case_stms case_stm  */
+#line 1905 "cfg.y"
+                                        {(yyval.action)=append_action((yyvsp[-1].action), (yyvsp[0].action)); }
+#line 5664 "cfg.tab.c"
+    break;
+
+  case 421: /* case_stms: case_stm  */
+#line 1906 "cfg.y"
+                                                {(yyval.action)=(yyvsp[0].action);}
+#line 5670 "cfg.tab.c"
+    break;
+
+  case 422: /* case_stm: CASE snumber COLON brk_actions  */
+#line 1909 "cfg.y"
+                                         { mk_action2( (yyval.action), CASE_T,
+													NUMBER_ST,
+													ACTIONS_ST,
+													(void*)(yyvsp[-2].intval),
+													(yyvsp[0].action));
+											}
+#line 5681 "cfg.tab.c"
+    break;
+
+  case 423: /* case_stm: CASE snumber COLON  */
+#line 1915 "cfg.y"
+                                     { mk_action2( (yyval.action), CASE_T,
+													NUMBER_ST,
+													ACTIONS_ST,
+													(void*)(yyvsp[-1].intval),
+													NULL);
+							}
+#line 5692 "cfg.tab.c"
+    break;
+
+  case 424: /* case_stm: CASE STRING COLON brk_actions  */
+#line 1921 "cfg.y"
+                                                { mk_action2( (yyval.action), CASE_T,
+													STR_ST,
+													ACTIONS_ST,
+													(void*)(yyvsp[-2].strval),
+													(yyvsp[0].action));
+											}
+#line 5703 "cfg.tab.c"
+    break;
+
+  case 425: /* case_stm: CASE STRING COLON  */
+#line 1927 "cfg.y"
+                                    { mk_action2( (yyval.action), CASE_T,
+													STR_ST,
+													ACTIONS_ST,
+													(void*)(yyvsp[-1].strval),
+													NULL);
+							}
+#line 5714 "cfg.tab.c"
+    break;
+
+  case 426: /* default_stm: DEFAULT COLON brk_actions  */
+#line 1935 "cfg.y"
+                                       { mk_action1( (yyval.action), DEFAULT_T,
+													ACTIONS_ST, (yyvsp[0].action));
+									}
+#line 5722 "cfg.tab.c"
+    break;
+
+  case 427: /* default_stm: DEFAULT COLON  */
+#line 1938 "cfg.y"
+                                { mk_action1( (yyval.action), DEFAULT_T, ACTIONS_ST, NULL); }
+#line 5728 "cfg.tab.c"
+    break;
+
+  case 428: /* func_param: STRING  */
+#line 1941 "cfg.y"
+                   {
+										elems[1].type = STR_ST;
+										elems[1].u.data = (yyvsp[0].strval);
+										(yyval.intval)=1;
+										}
+#line 5738 "cfg.tab.c"
+    break;
+
+  case 429: /* func_param: func_param COMMA STRING  */
+#line 1946 "cfg.y"
+                                          {
+										if ((yyvsp[-2].intval)+1>=MAX_ACTION_ELEMS) {
+											yyerror("too many arguments "
+												"in function\n");
+											(yyval.intval)=0;
+										}
+										elems[(yyvsp[-2].intval)+1].type = STR_ST;
+										elems[(yyvsp[-2].intval)+1].u.data = (yyvsp[0].strval);
+										(yyval.intval)=(yyvsp[-2].intval)+1;
+										}
+#line 5753 "cfg.tab.c"
+    break;
+
+  case 430: /* func_param: COMMA  */
+#line 1956 "cfg.y"
+                        {
+										elems[1].type = NULLV_ST;
+										elems[1].u.data = NULL;
+										elems[2].type = NULLV_ST;
+										elems[2].u.data = NULL;
+										(yyval.intval)=2;
+										}
+#line 5765 "cfg.tab.c"
+    break;
+
+  case 431: /* func_param: COMMA STRING  */
+#line 1963 "cfg.y"
+                               {
+										elems[1].type = NULLV_ST;
+										elems[1].u.data = NULL;
+										elems[2].type = STR_ST;
+										elems[2].u.data = (yyvsp[0].strval);
+										(yyval.intval)=2;
+										}
+#line 5777 "cfg.tab.c"
+    break;
+
+  case 432: /* func_param: func_param COMMA  */
+#line 1970 "cfg.y"
+                                   {
+										if ((yyvsp[-1].intval)+1>=MAX_ACTION_ELEMS) {
+											yyerror("too many arguments "
+												"in function\n");
+											(yyval.intval)=0;
+										}
+										elems[(yyvsp[-1].intval)+1].type = NULLV_ST;
+										elems[(yyvsp[-1].intval)+1].u.data = NULL;
+										(yyval.intval)=(yyvsp[-1].intval)+1;
+										}
+#line 5792 "cfg.tab.c"
+    break;
+
+  case 433: /* func_param: snumber  */
+#line 1980 "cfg.y"
+                          {
+										elems[1].type = NUMBER_ST;
+										elems[1].u.number = (yyvsp[0].intval);
+										(yyval.intval)=1;
+										}
+#line 5802 "cfg.tab.c"
+    break;
+
+  case 434: /* func_param: COMMA snumber  */
+#line 1985 "cfg.y"
+                                {
+										elems[1].type = NULLV_ST;
+										elems[1].u.data = NULL;
+										elems[2].type = NUMBER_ST;
+										elems[2].u.number = (yyvsp[0].intval);
+										(yyval.intval)=2;
+										}
+#line 5814 "cfg.tab.c"
+    break;
+
+  case 435: /* func_param: func_param COMMA snumber  */
+#line 1992 "cfg.y"
+                                           {
+										if ((yyvsp[-2].intval)+1>=MAX_ACTION_ELEMS) {
+											yyerror("too many arguments "
+												"in function\n");
+											(yyval.intval)=0;
+										}
+										elems[(yyvsp[-2].intval)+1].type = NUMBER_ST;
+										elems[(yyvsp[-2].intval)+1].u.number = (yyvsp[0].intval);
+										(yyval.intval)=(yyvsp[-2].intval)+1;
+										}
+#line 5829 "cfg.tab.c"
+    break;
+
+  case 436: /* func_param: script_var  */
+#line 2002 "cfg.y"
+                             {
+										elems[1].type = SCRIPTVAR_ST;
+										elems[1].u.data = (yyvsp[0].specval);
+										(yyval.intval)=1;
+										}
+#line 5839 "cfg.tab.c"
+    break;
+
+  case 437: /* func_param: COMMA script_var  */
+#line 2007 "cfg.y"
+                                   {
+										elems[1].type = NULLV_ST;
+										elems[1].u.data = NULL;
+										elems[2].type = SCRIPTVAR_ST;
+										elems[2].u.data = (yyvsp[0].specval);
+										(yyval.intval)=2;
+										}
+#line 5851 "cfg.tab.c"
+    break;
+
+  case 438: /* func_param: func_param COMMA script_var  */
+#line 2014 "cfg.y"
+                                              {
+										if ((yyvsp[-2].intval)+1>=MAX_ACTION_ELEMS) {
+											yyerror("too many arguments "
+												"in function\n");
+											(yyval.intval)=0;
+										}
+										elems[(yyvsp[-2].intval)+1].type = SCRIPTVAR_ST;
+										elems[(yyvsp[-2].intval)+1].u.data = (yyvsp[0].specval);
+										(yyval.intval)=(yyvsp[-2].intval)+1;
+										}
+#line 5866 "cfg.tab.c"
+    break;
+
+  case 439: /* route_param: STRING  */
+#line 2026 "cfg.y"
+                    {
+						route_elems[0].type = STRING_ST;
+						route_elems[0].u.string = (yyvsp[0].strval);
+						(yyval.intval)=1;
+			}
+#line 5876 "cfg.tab.c"
+    break;
+
+  case 440: /* route_param: snumber  */
+#line 2031 "cfg.y"
+                          {
+						route_elems[0].type = NUMBER_ST;
+						route_elems[0].u.number = (long)(yyvsp[0].intval);
+						(yyval.intval)=1;
+			}
+#line 5886 "cfg.tab.c"
+    break;
+
+  case 441: /* route_param: NULLV  */
+#line 2036 "cfg.y"
+                        {
+						route_elems[0].type = NULLV_ST;
+						route_elems[0].u.data = 0;
+						(yyval.intval)=1;
+			}
+#line 5896 "cfg.tab.c"
+    break;
+
+  case 442: /* route_param: script_var  */
+#line 2041 "cfg.y"
+                             {
+						route_elems[0].type = SCRIPTVAR_ST;
+						route_elems[0].u.data = (yyvsp[0].specval);
+						(yyval.intval)=1;
+			}
+#line 5906 "cfg.tab.c"
+    break;
+
+  case 443: /* route_param: route_param COMMA STRING  */
+#line 2046 "cfg.y"
+                                           {
+						if ((yyvsp[-2].intval)>=MAX_ACTION_ELEMS) {
+							yyerror("too many arguments in function\n");
+							(yyval.intval)=-1;
+						} else {
+							route_elems[(yyvsp[-2].intval)].type = STRING_ST;
+							route_elems[(yyvsp[-2].intval)].u.data = (yyvsp[0].strval);
+							(yyval.intval)=(yyvsp[-2].intval)+1;
+						}
+			}
+#line 5921 "cfg.tab.c"
+    break;
+
+  case 444: /* route_param: route_param COMMA snumber  */
+#line 2056 "cfg.y"
+                                            {
+						if ((yyvsp[-2].intval)>=MAX_ACTION_ELEMS) {
+							yyerror("too many arguments in function\n");
+							(yyval.intval)=-1;
+						} else {
+							route_elems[(yyvsp[-2].intval)].type = NUMBER_ST;
+							route_elems[(yyvsp[-2].intval)].u.data = (void*)(long)(yyvsp[0].intval);
+							(yyval.intval)=(yyvsp[-2].intval)+1;
+						}
+			}
+#line 5936 "cfg.tab.c"
+    break;
+
+  case 445: /* route_param: route_param COMMA script_var  */
+#line 2066 "cfg.y"
+                                               {
+						if ((yyvsp[-2].intval)+1>=MAX_ACTION_ELEMS) {
+							yyerror("too many arguments in function\n");
+							(yyval.intval)=-1;
+						} else {
+							route_elems[(yyvsp[-2].intval)].type = SCRIPTVAR_ST;
+							route_elems[(yyvsp[-2].intval)].u.data = (yyvsp[0].specval);
+							(yyval.intval)=(yyvsp[-2].intval)+1;
+						}
+			}
+#line 5951 "cfg.tab.c"
+    break;
+
+  case 446: /* route_param: route_param COMMA NULLV  */
+#line 2076 "cfg.y"
+                                          {
+						if ((yyvsp[-2].intval)+1>=MAX_ACTION_ELEMS) {
+							yyerror("too many arguments in function\n");
+							(yyval.intval)=-1;
+						} else {
+							route_elems[(yyvsp[-2].intval)].type = NULLV_ST;
+							route_elems[(yyvsp[-2].intval)].u.data = 0;
+							(yyval.intval)=(yyvsp[-2].intval)+1;
+						}
+			}
+#line 5966 "cfg.tab.c"
+    break;
+
+  case 447: /* async_func: ID LPAREN RPAREN  */
+#line 2088 "cfg.y"
+                             {
+				cmd_tmp=(void*)find_acmd_export_t((yyvsp[-2].strval));
+				if (cmd_tmp==0){
+					yyerrorf("unknown async command <%s>, "
+						"missing loadmodule?", (yyvsp[-2].strval));
+					(yyval.action)=0;
+				}else{
+					if (check_acmd_call_params(cmd_tmp,elems,0)<0) {
+						yyerrorf("too few parameters "
+							"for command <%s>\n", (yyvsp[-2].strval));
+						(yyval.action)=0;
+					} else {
+						elems[0].type = ACMD_ST;
+						elems[0].u.data = cmd_tmp;
+						mk_action_((yyval.action), AMODULE_T, 1, elems);
+					}
+				}
+			}
+#line 5989 "cfg.tab.c"
+    break;
+
+  case 448: /* async_func: ID LPAREN func_param RPAREN  */
+#line 2106 "cfg.y"
+                                                      {
+				cmd_tmp=(void*)find_acmd_export_t((yyvsp[-3].strval));
+				if (cmd_tmp==0){
+					yyerrorf("unknown async command <%s>, "
+						"missing loadmodule?", (yyvsp[-3].strval));
+					(yyval.action)=0;
+				}else{
+					rc = check_acmd_call_params(cmd_tmp,elems,(yyvsp[-1].intval));
+					switch (rc) {
+					case -1:
+						yyerrorf("too few parameters "
+							"for async command <%s>\n", (yyvsp[-3].strval));
+						(yyval.action)=0;
+						break;
+					case -2:
+						yyerrorf("too many parameters "
+							"for async command <%s>\n", (yyvsp[-3].strval));
+						(yyval.action)=0;
+						break;
+					case -3:
+						yyerrorf("mandatory parameter "
+							" omitted for async command <%s>\n", (yyvsp[-3].strval));
+						(yyval.action)=0;
+						break;
+					default:
+						elems[0].type = ACMD_ST;
+						elems[0].u.data = cmd_tmp;
+						mk_action_((yyval.action), AMODULE_T, (yyvsp[-1].intval)+1, elems);
+					}
+				}
+			}
+#line 6025 "cfg.tab.c"
+    break;
+
+  case 449: /* async_func: ID LPAREN error RPAREN  */
+#line 2137 "cfg.y"
+                                                 {
+				(yyval.action)=0;
+				yyerrorf("bad arguments for command <%s>", (yyvsp[-3].strval));
+			}
+#line 6034 "cfg.tab.c"
+    break;
+
+  case 450: /* async_func: ID error  */
+#line 2141 "cfg.y"
+                                   {
+				(yyval.action)=0;
+				yyerrorf("bare word <%s> found, command calls need '()'", (yyvsp[-1].strval));
+			}
+#line 6043 "cfg.tab.c"
+    break;
+
+  case 451: /* cmd: ASSERT LPAREN exp COMMA STRING RPAREN  */
+#line 2147 "cfg.y"
+                                                 {
+			mk_action2( (yyval.action), ASSERT_T, EXPR_ST, STRING_ST, (yyvsp[-3].expr), (yyvsp[-1].strval));
+			}
+#line 6051 "cfg.tab.c"
+    break;
+
+  case 452: /* cmd: DROP  */
+#line 2150 "cfg.y"
+                                                 {mk_action0( (yyval.action), DROP_T); }
+#line 6057 "cfg.tab.c"
+    break;
+
+  case 453: /* cmd: DROP LPAREN RPAREN  */
+#line 2151 "cfg.y"
+                                     {mk_action0( (yyval.action), DROP_T); }
+#line 6063 "cfg.tab.c"
+    break;
+
+  case 454: /* cmd: EXIT  */
+#line 2152 "cfg.y"
+                                                 {mk_action0( (yyval.action), EXIT_T); }
+#line 6069 "cfg.tab.c"
+    break;
+
+  case 455: /* cmd: EXIT LPAREN RPAREN  */
+#line 2153 "cfg.y"
+                                     {mk_action0( (yyval.action), EXIT_T); }
+#line 6075 "cfg.tab.c"
+    break;
+
+  case 456: /* cmd: RETURN script_var  */
+#line 2155 "cfg.y"
+                                                         {mk_action1( (yyval.action), RETURN_T, SCRIPTVAR_ST, (void*)(yyvsp[0].specval)); }
+#line 6081 "cfg.tab.c"
+    break;
+
+  case 457: /* cmd: RETURN LPAREN script_var RPAREN  */
+#line 2157 "cfg.y"
+                                                         {mk_action1( (yyval.action), RETURN_T, SCRIPTVAR_ST, (void*)(yyvsp[-1].specval)); }
+#line 6087 "cfg.tab.c"
+    break;
+
+  case 458: /* cmd: RETURN snumber  */
+#line 2159 "cfg.y"
+                                                         {mk_action1( (yyval.action), RETURN_T, NUMBER_ST, (void*)(yyvsp[0].intval)); }
+#line 6093 "cfg.tab.c"
+    break;
+
+  case 459: /* cmd: RETURN LPAREN snumber RPAREN  */
+#line 2161 "cfg.y"
+                                                         {mk_action1( (yyval.action), RETURN_T, NUMBER_ST, (void*)(yyvsp[-1].intval)); }
+#line 6099 "cfg.tab.c"
+    break;
+
+  case 460: /* cmd: RETURN LPAREN RPAREN  */
+#line 2163 "cfg.y"
+                                                         {mk_action1( (yyval.action), RETURN_T, NUMBER_ST, (void*)1); }
+#line 6105 "cfg.tab.c"
+    break;
+
+  case 461: /* cmd: RETURN  */
+#line 2164 "cfg.y"
+                                                 {mk_action1( (yyval.action), RETURN_T, NUMBER_ST, (void*)1); }
+#line 6111 "cfg.tab.c"
+    break;
+
+  case 462: /* cmd: LOG_TOK LPAREN STRING RPAREN  */
+#line 2165 "cfg.y"
+                                                {mk_action2( (yyval.action), LOG_T, NUMBER_ST,
+													STRING_ST,(void*)4,(yyvsp[-1].strval));
+									}
+#line 6119 "cfg.tab.c"
+    break;
+
+  case 463: /* cmd: LOG_TOK LPAREN snumber COMMA STRING RPAREN  */
+#line 2168 "cfg.y"
+                                                                {mk_action2( (yyval.action), LOG_T,
+																NUMBER_ST,
+																STRING_ST,
+																(void*)(yyvsp[-3].intval),
+																(yyvsp[-1].strval));
+												}
+#line 6130 "cfg.tab.c"
+    break;
+
+  case 464: /* cmd: LOG_TOK error  */
+#line 2174 "cfg.y"
+                                { (yyval.action)=0; yyerror("missing '(' or ')' ?"); }
+#line 6136 "cfg.tab.c"
+    break;
+
+  case 465: /* cmd: LOG_TOK LPAREN error RPAREN  */
+#line 2175 "cfg.y"
+                                              { (yyval.action)=0; yyerror("bad log"
+									"argument"); }
+#line 6143 "cfg.tab.c"
+    break;
+
+  case 466: /* cmd: ERROR LPAREN STRING COMMA STRING RPAREN  */
+#line 2177 "cfg.y"
+                                                          {mk_action2( (yyval.action), ERROR_T,
+																STRING_ST,
+																STRING_ST,
+																(yyvsp[-3].strval),
+																(yyvsp[-1].strval));
+												  }
+#line 6154 "cfg.tab.c"
+    break;
+
+  case 467: /* cmd: ERROR error  */
+#line 2183 "cfg.y"
+                              { (yyval.action)=0; yyerror("missing '(' or ')' ?"); }
+#line 6160 "cfg.tab.c"
+    break;
+
+  case 468: /* cmd: ERROR LPAREN error RPAREN  */
+#line 2184 "cfg.y"
+                                            { (yyval.action)=0; yyerror("bad error"
+														"argument"); }
+#line 6167 "cfg.tab.c"
+    break;
+
+  case 469: /* cmd: ROUTE LPAREN route_name_var RPAREN  */
+#line 2186 "cfg.y"
+                                                        {
+						mk_action2( (yyval.action), ROUTE_T, (yyvsp[-1].intval), 0, rn_tmp.data, 0);
+					}
+#line 6175 "cfg.tab.c"
+    break;
+
+  case 470: /* cmd: ROUTE LPAREN route_name_var COMMA route_param RPAREN  */
+#line 2190 "cfg.y"
+                                                                        {
+						if ((yyvsp[-1].intval) <= 0) yyerror("too many route parameters");
+
+						/* duplicate the list */
+						a_tmp = pkg_malloc((yyvsp[-1].intval) * sizeof(action_elem_t));
+						if (!a_tmp) {
+							yyerror("no more pkg memory");
+							YYABORT;
+						}
+						memcpy(a_tmp, route_elems, (yyvsp[-1].intval)*sizeof(action_elem_t));
+
+						mk_action3( (yyval.action), ROUTE_T, (yyvsp[-3].intval),	/* route idx */
+							NUMBER_ST,					/* number of params */
+							SCRIPTVAR_ST,				/* parameters */
+							rn_tmp.data,
+							(void*)(long)(yyvsp[-1].intval),
+							(void*)a_tmp);
+					}
+#line 6198 "cfg.tab.c"
+    break;
+
+  case 471: /* cmd: ROUTE error  */
+#line 2209 "cfg.y"
+                              { (yyval.action)=0; yyerror("missing '(' or ')' ?"); }
+#line 6204 "cfg.tab.c"
+    break;
+
+  case 472: /* cmd: ROUTE LPAREN error RPAREN  */
+#line 2210 "cfg.y"
+                                            { (yyval.action)=0; yyerror("bad route"
+						"argument"); }
+#line 6211 "cfg.tab.c"
+    break;
+
+  case 473: /* cmd: ID LPAREN RPAREN  */
+#line 2212 "cfg.y"
+                                        {
+								cmd_tmp=(void*)find_cmd_export_t((yyvsp[-2].strval), rt);
+								if (cmd_tmp==0){
+									if (find_cmd_export_t((yyvsp[-2].strval), 0)) {
+										yyerrorf("Command <%s> cannot be "
+											"used in the block\n", (yyvsp[-2].strval));
+									} else {
+										yyerrorf("unknown command <%s>, "
+											"missing loadmodule?", (yyvsp[-2].strval));
+									}
+									(yyval.action)=0;
+								}else{
+									if (check_cmd_call_params(cmd_tmp,elems,0)<0) {
+										yyerrorf("too few parameters "
+											"for command <%s>\n", (yyvsp[-2].strval));
+										(yyval.action)=0;
+									} else {
+										elems[0].type = CMD_ST;
+										elems[0].u.data = cmd_tmp;
+										mk_action_((yyval.action), CMD_T, 1, elems);
+									}
+								}
+							}
+#line 6239 "cfg.tab.c"
+    break;
+
+  case 474: /* cmd: ID LPAREN func_param RPAREN  */
+#line 2235 "cfg.y"
+                                                {
+								cmd_tmp=(void*)find_cmd_export_t((yyvsp[-3].strval), rt);
+								if (cmd_tmp==0){
+									if (find_cmd_export_t((yyvsp[-3].strval), 0)) {
+										yyerrorf("Command <%s> cannot be "
+											"used in the block\n", (yyvsp[-3].strval));
+									} else {
+										yyerrorf("unknown command <%s>, "
+											"missing loadmodule?", (yyvsp[-3].strval));
+									}
+									(yyval.action)=0;
+								}else{
+									rc = check_cmd_call_params(cmd_tmp,elems,(yyvsp[-1].intval));
+									switch (rc) {
+									case -1:
+										yyerrorf("too few parameters "
+											"for command <%s>\n", (yyvsp[-3].strval));
+										(yyval.action)=0;
+										break;
+									case -2:
+										yyerrorf("too many parameters "
+											"for command <%s>\n", (yyvsp[-3].strval));
+										(yyval.action)=0;
+										break;
+									case -3:
+										yyerrorf("mandatory parameter "
+											"omitted for command <%s>\n", (yyvsp[-3].strval));
+										(yyval.action)=0;
+										break;
+									default:
+										elems[0].type = CMD_ST;
+										elems[0].u.data = cmd_tmp;
+										mk_action_((yyval.action), CMD_T, (yyvsp[-1].intval)+1, elems);
+									}
+								}
+							}
+#line 6280 "cfg.tab.c"
+    break;
+
+  case 475: /* cmd: ID LPAREN error RPAREN  */
+#line 2271 "cfg.y"
+                                         { (yyval.action)=0; yyerrorf("bad arguments for "
+												"command <%s>", (yyvsp[-3].strval)); }
+#line 6287 "cfg.tab.c"
+    break;
+
+  case 476: /* cmd: ID error  */
+#line 2273 "cfg.y"
+                           { (yyval.action)=0;
+			yyerrorf("bare word <%s> found, command calls need '()'", (yyvsp[-1].strval));
+			}
+#line 6295 "cfg.tab.c"
+    break;
+
+  case 477: /* cmd: XDBG LPAREN STRING RPAREN  */
+#line 2276 "cfg.y"
+                                            {
+				mk_action1((yyval.action), XDBG_T, STR_ST, (yyvsp[-1].strval));	}
+#line 6302 "cfg.tab.c"
+    break;
+
+  case 478: /* cmd: XDBG LPAREN folded_string RPAREN  */
+#line 2278 "cfg.y"
+                                                   {
+				mk_action1((yyval.action), XDBG_T, STR_ST, (yyvsp[-1].strval));	}
+#line 6309 "cfg.tab.c"
+    break;
+
+  case 479: /* cmd: XLOG LPAREN STRING RPAREN  */
+#line 2280 "cfg.y"
+                                            {
+				mk_action1((yyval.action), XLOG_T, STR_ST, (yyvsp[-1].strval)); }
+#line 6316 "cfg.tab.c"
+    break;
+
+  case 480: /* cmd: XLOG LPAREN folded_string RPAREN  */
+#line 2282 "cfg.y"
+                                                   {
+				mk_action1((yyval.action), XLOG_T, STR_ST, (yyvsp[-1].strval)); }
+#line 6323 "cfg.tab.c"
+    break;
+
+  case 481: /* cmd: XLOG LPAREN STRING COMMA STRING RPAREN  */
+#line 2284 "cfg.y"
+                                                         {
+				mk_action2((yyval.action), XLOG_T, STR_ST, STR_ST, (yyvsp[-3].strval), (yyvsp[-1].strval)); }
+#line 6330 "cfg.tab.c"
+    break;
+
+  case 482: /* cmd: XLOG LPAREN STRING COMMA folded_string RPAREN  */
+#line 2286 "cfg.y"
+                                                                {
+				mk_action2((yyval.action), XLOG_T, STR_ST, STR_ST, (yyvsp[-3].strval), (yyvsp[-1].strval)); }
+#line 6337 "cfg.tab.c"
+    break;
+
+  case 483: /* cmd: ASYNC_TOKEN LPAREN async_func COMMA route_name RPAREN  */
+#line 2288 "cfg.y"
+                                                                        {
+				i_tmp = get_script_route_idx( (yyvsp[-1].strval), sroutes->request, RT_NO, 0);
+				if (i_tmp==-1) yyerror("too many script routes");
+				mk_action2((yyval.action), ASYNC_T, ACTIONS_ST, NUMBER_ST,
+						(yyvsp[-3].action), (void*)(long)i_tmp);
+				}
+#line 6348 "cfg.tab.c"
+    break;
+
+  case 484: /* cmd: ASYNC_TOKEN LPAREN async_func COMMA route_name COMMA NUMBER RPAREN  */
+#line 2294 "cfg.y"
+                                                                                     {
+				i_tmp = get_script_route_idx( (yyvsp[-3].strval), sroutes->request, RT_NO, 0);
+				if (i_tmp==-1) yyerror("too many script routes");
+				mk_action3((yyval.action), ASYNC_T, ACTIONS_ST, NUMBER_ST, NUMBER_ST,
+						(yyvsp[-5].action), (void*)(long)i_tmp, (void*)(long)(yyvsp[-1].intval));
+				}
+#line 6359 "cfg.tab.c"
+    break;
+
+  case 485: /* cmd: LAUNCH_TOKEN LPAREN async_func COMMA route_name COMMA STRING RPAREN  */
+#line 2300 "cfg.y"
+                                                                                      {
+				i_tmp = get_script_route_idx( (yyvsp[-3].strval), sroutes->request, RT_NO, 0);
+				if (i_tmp==-1) yyerror("too many script routes");
+				mk_action3((yyval.action), LAUNCH_T, ACTIONS_ST, NUMBER_ST, STRING_ST,
+						(yyvsp[-5].action), (void*)(long)i_tmp, (yyvsp[-1].strval));
+				}
+#line 6370 "cfg.tab.c"
+    break;
+
+  case 486: /* cmd: LAUNCH_TOKEN LPAREN async_func COMMA route_name RPAREN  */
+#line 2306 "cfg.y"
+                                                                         {
+				i_tmp = get_script_route_idx( (yyvsp[-1].strval), sroutes->request, RT_NO, 0);
+				if (i_tmp==-1) yyerror("too many script routes");
+				mk_action2((yyval.action), LAUNCH_T, ACTIONS_ST, NUMBER_ST,
+						(yyvsp[-3].action), (void*)(long)i_tmp);
+				}
+#line 6381 "cfg.tab.c"
+    break;
+
+  case 487: /* cmd: LAUNCH_TOKEN LPAREN async_func RPAREN  */
+#line 2312 "cfg.y"
+                                                        {
+				mk_action2((yyval.action), LAUNCH_T, ACTIONS_ST, NUMBER_ST,
+						(yyvsp[-1].action), (void*)(long)-1);
+				}
+#line 6390 "cfg.tab.c"
+    break;
+
+
+#line 6394 "cfg.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 2319 "cfg.y"
+
+
+static inline void ALLOW_UNUSED warn(char* s)
+{
+	LM_WARN("warning in config file %s, line %d, column %d-%d: %s\n",
+			get_cfg_file_name, line, startcolumn, column, s);
+}
+
+static void yyerror(char* s)
+{
+	cfg_dump_backtrace();
+	LM_CRIT("parse error in %s:%d:%d-%d: %s\n",
+			get_cfg_file_name, line, startcolumn, column, s);
+	_cfg_dump_context(get_cfg_file_name, line, startcolumn, column, 1);
+	cfg_errors++;
+}
+
+#define ERROR_MAXLEN 1024
+static void yyerrorf(char *fmt, ...)
+{
+	char *tmp = pkg_malloc(ERROR_MAXLEN);
+	va_list ap;
+	va_start(ap, fmt);
+
+	vsnprintf(tmp, ERROR_MAXLEN, fmt, ap);
+	yyerror(tmp);
+
+	pkg_free(tmp);
+	va_end(ap);
+}
+
+
+static struct socket_id* mk_listen_id(char* host, enum sip_protos proto,
+																	int port)
+{
+	struct socket_id* l;
+	l=pkg_malloc(sizeof(struct socket_id));
+	if (l==0){
+		LM_CRIT("cfg. parser: out of memory.\n");
+	}else{
+		memset(l, 0, sizeof(*l));
+		l->name     = host;
+		l->proto    = proto;
+		l->port     = port;
+	}
+
+	return l;
+}
+
+static void fill_socket_id(struct listen_param *param, struct socket_id *s)
+{
+	s->flags |= param->flags;
+	s->workers = param->workers;
+	s->auto_scaling_profile = param->auto_scaling_profile;
+	if (param->socket)
+		set_listen_id_adv(s, param->socket->name, param->socket->port);
+	s->tag = param->tag;
+}
+
+static struct multi_str *new_string(char *s)
+{
+	struct multi_str *ms = pkg_malloc(sizeof(struct multi_str));
+	if (!ms) {
+		LM_CRIT("cfg. parser: out of memory.\n");
+	}else{
+		ms->s    = s;
+		ms->next = NULL;
+	}
+	return ms;
+}
+
+static struct socket_id* set_listen_id_adv(struct socket_id* sock,
+											char *adv_name,
+											int adv_port)
+{
+	sock->adv_name=adv_name;
+	sock->adv_port=adv_port;
+	return sock;
+}
+
+static int parse_ipnet(char *in, int len, struct net **ipnet)
+{
+	char *p = NULL;
+	str ip_s, mask_s;
+	struct ip_addr *ip = NULL, *mask = NULL, *ip_tmp;
+	int af;
+	unsigned int bitlen;
+
+	p = q_memchr(in, '.', len);
+	if (p)
+		af = AF_INET;
+	else if (q_memchr(in, ':', len)) {
+		af = AF_INET6;
+	} else {
+		LM_ERR("Not an IP");
+		return -1;
+	}
+
+	p = q_memchr(in, '/', len);
+	if (!p) {
+		LM_ERR("No netmask\n");
+		return -1;
+	}
+	ip_s.s = in;
+	ip_s.len = p - in;
+
+	mask_s.s = p + 1;
+	mask_s.len = len - ip_s.len - 1;
+	if (!mask_s.s || mask_s.len == 0) {
+		LM_ERR("Empty netmask\n");
+		return -1;
+	}
+
+	ip_tmp = (af == AF_INET) ? str2ip(&ip_s) : str2ip6(&ip_s);
+	if (!ip_tmp) {
+		LM_ERR("Invalid IP\n");
+		return -1;
+	}
+	ip = pkg_malloc(sizeof *ip);
+	if (!ip) {
+		LM_CRIT("No more pkg memory\n");
+		return -1;
+	}
+	memcpy(ip, ip_tmp, sizeof *ip);
+
+	p = (af == AF_INET) ? q_memchr(p, '.', len-(p-in)+1) : q_memchr(p, ':', len-(p-in)+1);
+	if (p) {
+		ip_tmp = (af == AF_INET) ? str2ip(&mask_s) : str2ip6(&mask_s);
+		if (!ip_tmp) {
+			LM_ERR("Invalid netmask\n");
+			return -1;
+		}
+		mask = pkg_malloc(sizeof *mask);
+		if (!mask) {
+			LM_CRIT("No more pkg memory\n");
+			return -1;
+		}
+		memcpy(mask, ip_tmp, sizeof *mask);
+
+		*ipnet = mk_net(ip, mask);
+	} else {
+		if (str2int(&mask_s, &bitlen) < 0) {
+			LM_ERR("Invalid netmask bitlen\n");
+			return -1;
+		}
+
+		*ipnet = mk_net_bitlen(ip, bitlen);
+	}
+
+	pkg_free(ip);
+	pkg_free(mask);
+
+	if (*ipnet == NULL)
+			return -1;
+
+	return 0;
+}
@@ -0,0 +1,288 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_CFG_TAB_H_INCLUDED
+# define YY_YY_CFG_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    DROP = 258,                    /* DROP  */
+    ASSERT = 259,                  /* ASSERT  */
+    EXIT = 260,                    /* EXIT  */
+    RETURN = 261,                  /* RETURN  */
+    LOG_TOK = 262,                 /* LOG_TOK  */
+    ERROR = 263,                   /* ERROR  */
+    ROUTE = 264,                   /* ROUTE  */
+    ROUTE_FAILURE = 265,           /* ROUTE_FAILURE  */
+    ROUTE_ONREPLY = 266,           /* ROUTE_ONREPLY  */
+    ROUTE_BRANCH = 267,            /* ROUTE_BRANCH  */
+    ROUTE_ERROR = 268,             /* ROUTE_ERROR  */
+    ROUTE_LOCAL = 269,             /* ROUTE_LOCAL  */
+    ROUTE_STARTUP = 270,           /* ROUTE_STARTUP  */
+    ROUTE_TIMER = 271,             /* ROUTE_TIMER  */
+    ROUTE_EVENT = 272,             /* ROUTE_EVENT  */
+    IF = 273,                      /* IF  */
+    ELSE = 274,                    /* ELSE  */
+    SWITCH = 275,                  /* SWITCH  */
+    CASE = 276,                    /* CASE  */
+    DEFAULT = 277,                 /* DEFAULT  */
+    BREAK = 278,                   /* BREAK  */
+    WHILE = 279,                   /* WHILE  */
+    FOR = 280,                     /* FOR  */
+    IN = 281,                      /* IN  */
+    NULLV = 282,                   /* NULLV  */
+    XDBG = 283,                    /* XDBG  */
+    XLOG = 284,                    /* XLOG  */
+    XLOG_BUF_SIZE = 285,           /* XLOG_BUF_SIZE  */
+    XLOG_FORCE_COLOR = 286,        /* XLOG_FORCE_COLOR  */
+    XLOG_PRINT_LEVEL = 287,        /* XLOG_PRINT_LEVEL  */
+    XLOG_LEVEL = 288,              /* XLOG_LEVEL  */
+    PV_PRINT_BUF_SIZE = 289,       /* PV_PRINT_BUF_SIZE  */
+    DEBUG_MODE = 290,              /* DEBUG_MODE  */
+    ENABLE_ASSERTS = 291,          /* ENABLE_ASSERTS  */
+    ABORT_ON_ASSERT = 292,         /* ABORT_ON_ASSERT  */
+    LOGLEVEL = 293,                /* LOGLEVEL  */
+    LOGSTDOUT = 294,               /* LOGSTDOUT  */
+    LOGSTDERROR = 295,             /* LOGSTDERROR  */
+    LOGFACILITY = 296,             /* LOGFACILITY  */
+    LOGNAME = 297,                 /* LOGNAME  */
+    AVP_ALIASES = 298,             /* AVP_ALIASES  */
+    LISTEN = 299,                  /* LISTEN  */
+    SOCKET = 300,                  /* SOCKET  */
+    MEMGROUP = 301,                /* MEMGROUP  */
+    ALIAS = 302,                   /* ALIAS  */
+    AUTO_ALIASES = 303,            /* AUTO_ALIASES  */
+    TAG = 304,                     /* TAG  */
+    DNS = 305,                     /* DNS  */
+    REV_DNS = 306,                 /* REV_DNS  */
+    DNS_TRY_IPV6 = 307,            /* DNS_TRY_IPV6  */
+    DNS_TRY_NAPTR = 308,           /* DNS_TRY_NAPTR  */
+    DNS_RETR_TIME = 309,           /* DNS_RETR_TIME  */
+    DNS_RETR_NO = 310,             /* DNS_RETR_NO  */
+    DNS_SERVERS_NO = 311,          /* DNS_SERVERS_NO  */
+    DNS_USE_SEARCH = 312,          /* DNS_USE_SEARCH  */
+    MAX_WHILE_LOOPS = 313,         /* MAX_WHILE_LOOPS  */
+    UDP_WORKERS = 314,             /* UDP_WORKERS  */
+    CHECK_VIA = 315,               /* CHECK_VIA  */
+    SHM_HASH_SPLIT_PERCENTAGE = 316, /* SHM_HASH_SPLIT_PERCENTAGE  */
+    SHM_SECONDARY_HASH_SIZE = 317, /* SHM_SECONDARY_HASH_SIZE  */
+    MEM_WARMING_ENABLED = 318,     /* MEM_WARMING_ENABLED  */
+    MEM_WARMING_PATTERN_FILE = 319, /* MEM_WARMING_PATTERN_FILE  */
+    MEM_WARMING_PERCENTAGE = 320,  /* MEM_WARMING_PERCENTAGE  */
+    RPM_MEM_FILE = 321,            /* RPM_MEM_FILE  */
+    RPM_MEM_SIZE = 322,            /* RPM_MEM_SIZE  */
+    MEMLOG = 323,                  /* MEMLOG  */
+    MEMDUMP = 324,                 /* MEMDUMP  */
+    EXECMSGTHRESHOLD = 325,        /* EXECMSGTHRESHOLD  */
+    EXECDNSTHRESHOLD = 326,        /* EXECDNSTHRESHOLD  */
+    TCPTHRESHOLD = 327,            /* TCPTHRESHOLD  */
+    EVENT_SHM_THRESHOLD = 328,     /* EVENT_SHM_THRESHOLD  */
+    EVENT_PKG_THRESHOLD = 329,     /* EVENT_PKG_THRESHOLD  */
+    QUERYBUFFERSIZE = 330,         /* QUERYBUFFERSIZE  */
+    QUERYFLUSHTIME = 331,          /* QUERYFLUSHTIME  */
+    QUERYWRITERPROCESSES = 332,    /* QUERYWRITERPROCESSES  */
+    SIP_WARNING = 333,             /* SIP_WARNING  */
+    SERVER_SIGNATURE = 334,        /* SERVER_SIGNATURE  */
+    SERVER_HEADER = 335,           /* SERVER_HEADER  */
+    USER_AGENT_HEADER = 336,       /* USER_AGENT_HEADER  */
+    LOADMODULE = 337,              /* LOADMODULE  */
+    MPATH = 338,                   /* MPATH  */
+    MODPARAM = 339,                /* MODPARAM  */
+    MAXBUFFER = 340,               /* MAXBUFFER  */
+    CHROOT = 341,                  /* CHROOT  */
+    WDIR = 342,                    /* WDIR  */
+    MHOMED = 343,                  /* MHOMED  */
+    POLL_METHOD = 344,             /* POLL_METHOD  */
+    TCP_ACCEPT_ALIASES = 345,      /* TCP_ACCEPT_ALIASES  */
+    TCP_WORKERS = 346,             /* TCP_WORKERS  */
+    TCP_HANDSHAKE_WORKERS = 347,   /* TCP_HANDSHAKE_WORKERS  */
+    TCP_CONNECT_TIMEOUT = 348,     /* TCP_CONNECT_TIMEOUT  */
+    TCP_CON_LIFETIME = 349,        /* TCP_CON_LIFETIME  */
+    TCP_SOCKET_BACKLOG = 350,      /* TCP_SOCKET_BACKLOG  */
+    TCP_MAX_CONNECTIONS = 351,     /* TCP_MAX_CONNECTIONS  */
+    TCP_NO_NEW_CONN_BFLAG = 352,   /* TCP_NO_NEW_CONN_BFLAG  */
+    TCP_NO_NEW_CONN_RPLFLAG = 353, /* TCP_NO_NEW_CONN_RPLFLAG  */
+    TCP_KEEPALIVE = 354,           /* TCP_KEEPALIVE  */
+    TCP_KEEPCOUNT = 355,           /* TCP_KEEPCOUNT  */
+    TCP_KEEPIDLE = 356,            /* TCP_KEEPIDLE  */
+    TCP_KEEPINTERVAL = 357,        /* TCP_KEEPINTERVAL  */
+    TCP_MAX_MSG_TIME = 358,        /* TCP_MAX_MSG_TIME  */
+    ADVERTISED_ADDRESS = 359,      /* ADVERTISED_ADDRESS  */
+    ADVERTISED_PORT = 360,         /* ADVERTISED_PORT  */
+    DISABLE_CORE = 361,            /* DISABLE_CORE  */
+    OPEN_FD_LIMIT = 362,           /* OPEN_FD_LIMIT  */
+    MCAST_LOOPBACK = 363,          /* MCAST_LOOPBACK  */
+    MCAST_TTL = 364,               /* MCAST_TTL  */
+    TOS = 365,                     /* TOS  */
+    DISABLE_DNS_FAILOVER = 366,    /* DISABLE_DNS_FAILOVER  */
+    DISABLE_DNS_BLACKLIST = 367,   /* DISABLE_DNS_BLACKLIST  */
+    DST_BLACKLIST = 368,           /* DST_BLACKLIST  */
+    DISABLE_STATELESS_FWD = 369,   /* DISABLE_STATELESS_FWD  */
+    DB_VERSION_TABLE = 370,        /* DB_VERSION_TABLE  */
+    DB_DEFAULT_URL = 371,          /* DB_DEFAULT_URL  */
+    DB_MAX_ASYNC_CONNECTIONS = 372, /* DB_MAX_ASYNC_CONNECTIONS  */
+    DB_ASYNC_EXECUTORS = 373,      /* DB_ASYNC_EXECUTORS  */
+    DB_PRELOAD_WORKERS = 374,      /* DB_PRELOAD_WORKERS  */
+    IPC_QUEUE_SIZE = 375,          /* IPC_QUEUE_SIZE  */
+    DISABLE_503_TRANSLATION = 376, /* DISABLE_503_TRANSLATION  */
+    SYNC_TOKEN = 377,              /* SYNC_TOKEN  */
+    ASYNC_TOKEN = 378,             /* ASYNC_TOKEN  */
+    LAUNCH_TOKEN = 379,            /* LAUNCH_TOKEN  */
+    AUTO_SCALING_PROFILE = 380,    /* AUTO_SCALING_PROFILE  */
+    AUTO_SCALING_CYCLE = 381,      /* AUTO_SCALING_CYCLE  */
+    AUTO_SCALING_POLICY = 382,     /* AUTO_SCALING_POLICY  */
+    AUTO_SCALING_LATENCY = 383,    /* AUTO_SCALING_LATENCY  */
+    AUTO_SCALING_SPARES = 384,     /* AUTO_SCALING_SPARES  */
+    AUTO_SCALING_QUEUE = 385,      /* AUTO_SCALING_QUEUE  */
+    TIMER_WORKERS = 386,           /* TIMER_WORKERS  */
+    EQUAL = 387,                   /* EQUAL  */
+    EQUAL_T = 388,                 /* EQUAL_T  */
+    GT = 389,                      /* GT  */
+    LT = 390,                      /* LT  */
+    GTE = 391,                     /* GTE  */
+    LTE = 392,                     /* LTE  */
+    DIFF = 393,                    /* DIFF  */
+    MATCH = 394,                   /* MATCH  */
+    NOTMATCH = 395,                /* NOTMATCH  */
+    COLONEQ = 396,                 /* COLONEQ  */
+    PLUSEQ = 397,                  /* PLUSEQ  */
+    MINUSEQ = 398,                 /* MINUSEQ  */
+    SLASHEQ = 399,                 /* SLASHEQ  */
+    MULTEQ = 400,                  /* MULTEQ  */
+    MODULOEQ = 401,                /* MODULOEQ  */
+    BANDEQ = 402,                  /* BANDEQ  */
+    BOREQ = 403,                   /* BOREQ  */
+    BXOREQ = 404,                  /* BXOREQ  */
+    OR = 405,                      /* OR  */
+    AND = 406,                     /* AND  */
+    BOR = 407,                     /* BOR  */
+    BAND = 408,                    /* BAND  */
+    BXOR = 409,                    /* BXOR  */
+    BLSHIFT = 410,                 /* BLSHIFT  */
+    BRSHIFT = 411,                 /* BRSHIFT  */
+    PLUS = 412,                    /* PLUS  */
+    MINUS = 413,                   /* MINUS  */
+    MULT = 414,                    /* MULT  */
+    MODULO = 415,                  /* MODULO  */
+    NOT = 416,                     /* NOT  */
+    BNOT = 417,                    /* BNOT  */
+    NUMBER = 418,                  /* NUMBER  */
+    ZERO = 419,                    /* ZERO  */
+    ID = 420,                      /* ID  */
+    STRING = 421,                  /* STRING  */
+    SCRIPTVAR = 422,               /* SCRIPTVAR  */
+    IPV6ADDR = 423,                /* IPV6ADDR  */
+    IPV4ADDR = 424,                /* IPV4ADDR  */
+    IPNET = 425,                   /* IPNET  */
+    COMMA = 426,                   /* COMMA  */
+    SEMICOLON = 427,               /* SEMICOLON  */
+    RPAREN = 428,                  /* RPAREN  */
+    LPAREN = 429,                  /* LPAREN  */
+    LBRACE = 430,                  /* LBRACE  */
+    RBRACE = 431,                  /* RBRACE  */
+    LBRACK = 432,                  /* LBRACK  */
+    RBRACK = 433,                  /* RBRACK  */
+    SLASH = 434,                   /* SLASH  */
+    AS = 435,                      /* AS  */
+    USE_WORKERS = 436,             /* USE_WORKERS  */
+    USE_AUTO_SCALING_PROFILE = 437, /* USE_AUTO_SCALING_PROFILE  */
+    MAX = 438,                     /* MAX  */
+    MIN = 439,                     /* MIN  */
+    DOT = 440,                     /* DOT  */
+    CR = 441,                      /* CR  */
+    COLON = 442,                   /* COLON  */
+    ANY = 443,                     /* ANY  */
+    ANYCAST = 444,                 /* ANYCAST  */
+    SCRIPTVARERR = 445,            /* SCRIPTVARERR  */
+    SCALE_UP_TO = 446,             /* SCALE_UP_TO  */
+    SCALE_DOWN_TO = 447,           /* SCALE_DOWN_TO  */
+    ON = 448,                      /* ON  */
+    CYCLES = 449,                  /* CYCLES  */
+    CYCLES_WITHIN = 450,           /* CYCLES_WITHIN  */
+    PERCENTAGE = 451               /* PERCENTAGE  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 234 "cfg.y"
+
+	long intval;
+	unsigned long uval;
+	char* strval;
+	struct expr* expr;
+	struct action* action;
+	struct net* ipnet;
+	struct ip_addr* ipaddr;
+	struct socket_id* sockid;
+	struct listen_param* listen_param;
+	struct _pv_spec *specval;
+	struct multi_str* multistr;
+
+#line 274 "cfg.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_CFG_TAB_H_INCLUDED  */
@@ -106,6 +106,9 @@
 #include "blacklists.h"
 #include "xlog.h"
 #include "db/db_insertq.h"
+#include "db/db_async_exec.h"
+#include "db/db_preload.h"
+#include "ipc.h"
 #include "bin_interface.h"
 #include "net/trans.h"
 #include "config.h"
@@ -322,6 +325,7 @@ extern int cfg_parse_only_routes;
 %token EVENT_PKG_THRESHOLD
 %token QUERYBUFFERSIZE
 %token QUERYFLUSHTIME
+%token QUERYWRITERPROCESSES
 %token SIP_WARNING
 %token SERVER_SIGNATURE
 %token SERVER_HEADER
@@ -336,6 +340,7 @@ extern int cfg_parse_only_routes;
 %token POLL_METHOD
 %token TCP_ACCEPT_ALIASES
 %token TCP_WORKERS
+%token TCP_HANDSHAKE_WORKERS
 %token TCP_CONNECT_TIMEOUT
 %token TCP_CON_LIFETIME
 %token TCP_SOCKET_BACKLOG
@@ -361,12 +366,19 @@ extern int cfg_parse_only_routes;
 %token DB_VERSION_TABLE
 %token DB_DEFAULT_URL
 %token DB_MAX_ASYNC_CONNECTIONS
+%token DB_ASYNC_EXECUTORS
+%token DB_PRELOAD_WORKERS
+%token IPC_QUEUE_SIZE
 %token DISABLE_503_TRANSLATION
 %token SYNC_TOKEN
 %token ASYNC_TOKEN
 %token LAUNCH_TOKEN
 %token AUTO_SCALING_PROFILE
 %token AUTO_SCALING_CYCLE
+%token AUTO_SCALING_POLICY
+%token AUTO_SCALING_LATENCY
+%token AUTO_SCALING_SPARES
+%token AUTO_SCALING_QUEUE
 %token TIMER_WORKERS
 
 
@@ -923,6 +935,9 @@ assign_stm: LOGLEVEL EQUAL snumber { IFOR();
 		| QUERYBUFFERSIZE EQUAL error { yyerror("int value expected"); }
 		| QUERYFLUSHTIME EQUAL NUMBER { IFOR(); query_flush_time=$3; }
 		| QUERYFLUSHTIME EQUAL error { yyerror("int value expected"); }
+		| QUERYWRITERPROCESSES EQUAL NUMBER { IFOR();
+				query_writer_processes=$3; }
+		| QUERYWRITERPROCESSES EQUAL error { yyerror("int value expected"); }
 		| SIP_WARNING EQUAL NUMBER { IFOR(); sip_warning=$3; }
 		| SIP_WARNING EQUAL error { yyerror("boolean value expected"); }
 		| CHROOT EQUAL STRING     { IFOR(); chroot_dir=$3; }
@@ -966,6 +981,10 @@ assign_stm: LOGLEVEL EQUAL snumber { IFOR();
 				tcp_auto_scaling_profile=$5;
 		}
 		| TCP_WORKERS EQUAL error { yyerror("number expected"); }
+		| TCP_HANDSHAKE_WORKERS EQUAL NUMBER { IFOR();
+				tcp_handshake_workers_no=$3;
+		}
+		| TCP_HANDSHAKE_WORKERS EQUAL error { yyerror("number expected"); }
 		| TCP_CONNECT_TIMEOUT EQUAL NUMBER { IFOR();
 				tcp_connect_timeout=$3;
 		}
@@ -1249,6 +1268,24 @@ assign_stm: LOGLEVEL EQUAL snumber { IFOR();
 		| DB_MAX_ASYNC_CONNECTIONS EQUAL error {
 				yyerror("integer value expected");
 				}
+		| DB_ASYNC_EXECUTORS EQUAL NUMBER { IFOR();
+				db_async_executors=$3; }
+		| DB_ASYNC_EXECUTORS EQUAL error {
+				yyerror("integer value expected");
+				}
+		| DB_PRELOAD_WORKERS EQUAL NUMBER { IFOR();
+				db_preload_workers=$3; }
+		| DB_PRELOAD_WORKERS EQUAL error {
+				yyerror("integer value expected");
+				}
+		| IPC_QUEUE_SIZE EQUAL NUMBER { IFOR();
+				if ($3 <= 0)
+					yyerror("positive IPC queue size expected");
+				else
+					ipc_queue_size=$3; }
+		| IPC_QUEUE_SIZE EQUAL error {
+				yyerror("integer value expected");
+				}
 		| DISABLE_503_TRANSLATION EQUAL NUMBER { IFOR();
 				disable_503_translation=$3; }
 		| DISABLE_503_TRANSLATION EQUAL error {
@@ -1263,6 +1300,37 @@ assign_stm: LOGLEVEL EQUAL snumber { IFOR();
 		| AUTO_SCALING_CYCLE EQUAL error {
 				yyerror("integer value expected");
 				}
+		| AUTO_SCALING_POLICY EQUAL STRING { IFOR();
+				if (set_auto_scaling_policy($3)<0)
+					yyerror("unknown auto-scaling policy, \"load\" or "
+						"\"queue\" expected");
+				}
+		| AUTO_SCALING_POLICY EQUAL error {
+				yyerror("string value expected");
+				}
+		| AUTO_SCALING_LATENCY EQUAL NUMBER { IFOR();
+				if ($3 <= 0)
+					yyerror("positive latency (usec) expected");
+				else
+					auto_scaling_latency=$3;
+				}
+		| AUTO_SCALING_LATENCY EQUAL error {
+				yyerror("integer value expected");
+				}
+		| AUTO_SCALING_SPARES EQUAL NUMBER { IFOR();
+				auto_scaling_spares=$3; }
+		| AUTO_SCALING_SPARES EQUAL error {
+				yyerror("integer value expected");
+				}
+		| AUTO_SCALING_QUEUE EQUAL NUMBER { IFOR();
+				if ($3 <= 0)
+					yyerror("positive queue depth expected");
+				else
+					auto_scaling_queue=$3;
+				}
+		| AUTO_SCALING_QUEUE EQUAL error {
+				yyerror("integer value expected");
+				}
 		| error EQUAL { yyerror("unknown config variable"); }
 	;
 
@@ -2018,7 +2086,7 @@ route_param: STRING {
 	;
 
 async_func: ID LPAREN RPAREN {
-				cmd_tmp=(void*)find_mod_acmd_export_t($1);
+				cmd_tmp=(void*)find_acmd_export_t($1);
 				if (cmd_tmp==0){
 					yyerrorf("unknown async command <%s>, "
 						"missing loadmodule?", $1);
@@ -2036,7 +2104,7 @@ async_func: ID LPAREN RPAREN {
 				}
 			}
 			| ID LPAREN func_param RPAREN {
-				cmd_tmp=(void*)find_mod_acmd_export_t($1);
+				cmd_tmp=(void*)find_acmd_export_t($1);
 				if (cmd_tmp==0){
 					yyerrorf("unknown async command <%s>, "
 						"missing loadmodule?", $1);
@@ -32,6 +32,17 @@ cmd_export_t* find_cmd_export_t(char* name, int flags)
 	return cmd;
 }
 
+acmd_export_t* find_acmd_export_t(char* name)
+{
+	acmd_export_t* cmd;
+
+	cmd = find_core_acmd_export_t(name);
+	if (!cmd)
+		cmd = find_mod_acmd_export_t(name);
+
+	return cmd;
+}
+
 /* Checks if the module function is called with the right number of parameters
  * and all mandatory parameters are given
  * Return:
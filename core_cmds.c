@@ -104,6 +104,16 @@ static int w_cache_sub(struct sip_msg *msg, str *id, str *attr,
 					int *dec, int *expire, pv_spec_t *new_val);
 static int w_cache_raw_query(struct sip_msg *msg, str *id, str *raw_query,
 					pvname_list_t *avp_list);
+static int w_async_cache_store(struct sip_msg *msg, async_ctx *ctx, str *id,
+					str *attr, str *val, int *expire);
+static int w_async_cache_fetch(struct sip_msg *msg, async_ctx *ctx, str *id,
+					str *attr, pv_spec_t *res);
+static int w_async_cache_add(struct sip_msg *msg, async_ctx *ctx, str *id,
+					str *attr, int *inc, int *expire, pv_spec_t *new_val);
+static int w_async_cache_sub(struct sip_msg *msg, async_ctx *ctx, str *id,
+					str *attr, int *dec, int *expire, pv_spec_t *new_val);
+static int w_async_cache_raw_query(struct sip_msg *msg, async_ctx *ctx,
+					str *id, str *raw_query, pvname_list_t *avp_list);
 static int w_raise_event(struct sip_msg *msg, void *ev_id, pv_spec_t *attrs_avp,
 					pv_spec_t *vals_avp);
 static int w_subscribe_event(struct sip_msg *msg, str *name, str *socket,
@@ -302,6 +312,35 @@ static cmd_export_t core_cmds[]={
 	{0,0,{{0,0,0}},0}
 };
 
+static acmd_export_t core_acmds[]={
+	{"cache_store", (acmd_function)w_async_cache_store, {
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_INT|CMD_PARAM_OPT, 0, 0}, {0,0,0}}},
+	{"cache_fetch", (acmd_function)w_async_cache_fetch, {
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_VAR, fixup_check_wrvar, 0}, {0,0,0}}},
+	{"cache_add", (acmd_function)w_async_cache_add, {
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_INT, 0, 0},
+		{CMD_PARAM_INT, 0, 0},
+		{CMD_PARAM_VAR|CMD_PARAM_OPT, fixup_check_wrvar, 0}, {0,0,0}}},
+	{"cache_sub", (acmd_function)w_async_cache_sub, {
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_INT, 0, 0},
+		{CMD_PARAM_INT, 0, 0},
+		{CMD_PARAM_VAR|CMD_PARAM_OPT, fixup_check_wrvar, 0}, {0,0,0}}},
+	{"cache_raw_query", (acmd_function)w_async_cache_raw_query, {
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_STR, 0, 0},
+		{CMD_PARAM_STR|CMD_PARAM_OPT|CMD_PARAM_NO_EXPAND, fixup_avp_list, 0}, {0,0,0}}},
+	{0,0,{{0,0,0}}}
+};
+
 
 cmd_export_t* find_core_cmd_export_t(char* name, int flags)
 {
@@ -319,6 +358,22 @@ cmd_export_t* find_core_cmd_export_t(char* name, int flags)
 }
 
 
+acmd_export_t* find_core_acmd_export_t(char* name)
+{
+	acmd_export_t* cmd;
+
+	for(cmd=core_acmds; cmd && cmd->name; cmd++){
+		if(strcmp(name, cmd->name)==0){
+			LM_DBG("found async <%s> core function\n", name);
+			return cmd;
+		}
+	}
+
+	LM_DBG("async <%s> not found \n", name);
+	return 0;
+}
+
+
 static int fixup_destination(void** param)
 {
 	str *s = (str*)*param;
@@ -1065,16 +1120,67 @@ static int w_cache_sub(struct sip_msg *msg, str *id, str *attr,
 	return ret;
 }
 
+/* pushes the rows of a raw query reply into the AVPs, then frees it */
+static int cache_raw_query_avps(struct sip_msg *msg, pvname_list_t *avp_list,
+				cdb_raw_entry **cdb_reply, int num_cols, int num_rows)
+{
+	pvname_list_t *it;
+	int_str avp_val;
+	int_str avp_name;
+	unsigned short avp_type;
+	int i,j;
+
+	for (i=num_rows-1; i>=0;i--) {
+		it=avp_list;
+		for (j=0;j < num_cols;j++) {
+			avp_type = 0;
+			if (pv_get_avp_name(msg,&it->sname.pvp,&avp_name.n,
+				&avp_type) != 0) {
+				LM_ERR("cannot get avp name [%d/%d]\n",i,j);
+				goto next_avp;
+			}
+
+			switch (cdb_reply[i][j].type) {
+				case CDB_INT32:
+					avp_val.n = cdb_reply[i][j].val.n;
+					break;
+				case CDB_STR:
+					avp_type |= AVP_VAL_STR;
+					avp_val.s = cdb_reply[i][j].val.s;
+					break;
+				case CDB_NULL:
+					avp_type |= AVP_VAL_NULL;
+					avp_val.s = cdb_reply[i][j].val.s;
+					break;
+				default:
+					LM_WARN("Unknown type %d\n",cdb_reply[i][j].type);
+					goto next_avp;
+			}
+			if (add_avp(avp_type,avp_name.n,avp_val) != 0) {
+				LM_ERR("Unable to add AVP\n");
+				free_raw_fetch(cdb_reply,num_cols,num_rows);
+				return -1;
+			}
+next_avp:
+			if (it) {
+				it = it->next;
+				if (it==NULL)
+					break;
+			}
+		}
+	}
+	free_raw_fetch(cdb_reply,num_cols,num_rows);
+
+	return 0;
+}
+
 static int w_cache_raw_query(struct sip_msg *msg, str *id, str *raw_query_s,
 				pvname_list_t *avp_list)
 {
 	cdb_raw_entry **cdb_reply = NULL;
-	int num_cols=0,i,j;
+	int num_cols=0;
 	int num_rows=0;
 	pvname_list_t *it;
-	int_str avp_val;
-	int_str avp_name;
-	unsigned short avp_type;
 	int ret;
 
 	if (!raw_query_s || !raw_query_s->s || !raw_query_s->len) {
@@ -1091,52 +1197,202 @@ static int w_cache_raw_query(struct sip_msg *msg, str *id, str *raw_query_s,
 	LM_DBG("The query expects %d fields per result\n", num_cols);
 
 	ret = cachedb_raw_query(id, raw_query_s, &cdb_reply, num_cols, &num_rows);
-	if (ret >= 0 && num_cols > 0) {
-		for (i=num_rows-1; i>=0;i--) {
-			it=avp_list;
-			for (j=0;j < num_cols;j++) {
-				avp_type = 0;
-				if (pv_get_avp_name(msg,&it->sname.pvp,&avp_name.n,
-					&avp_type) != 0) {
-					LM_ERR("cannot get avp name [%d/%d]\n",i,j);
-					goto next_avp;
-				}
-
-				switch (cdb_reply[i][j].type) {
-					case CDB_INT32:
-						avp_val.n = cdb_reply[i][j].val.n;
-						break;
-					case CDB_STR:
-						avp_type |= AVP_VAL_STR;
-						avp_val.s = cdb_reply[i][j].val.s;
-						break;
-					case CDB_NULL:
-						avp_type |= AVP_VAL_NULL;
-						avp_val.s = cdb_reply[i][j].val.s;
-						break;
-					default:
-						LM_WARN("Unknown type %d\n",cdb_reply[i][j].type);
-						goto next_avp;
-				}
-				if (add_avp(avp_type,avp_name.n,avp_val) != 0) {
-					LM_ERR("Unable to add AVP\n");
-					free_raw_fetch(cdb_reply,num_cols,num_rows);
-					return -1;
-				}
-next_avp:
-				if (it) {
-					it = it->next;
-					if (it==NULL)
-						break;
-				}
-			}
+	if (ret >= 0 && num_cols > 0 &&
+			cache_raw_query_avps(msg, avp_list, cdb_reply, num_cols, num_rows) < 0)
+		return -1;
+
+	return ret;
+}
+
+static int resume_async_cache_query(int fd, struct sip_msg *msg, void *param)
+{
+	cdb_async_job *job = (cdb_async_job *)param;
+	pv_value_t val;
+	int ret;
+
+	ret = cachedb_async_resume(fd, job);
+	if (async_status == ASYNC_CONTINUE || async_status == ASYNC_CHANGE_FD)
+		return ret;
+
+	if (ret < 0)
+		goto out;
+
+	switch (job->type) {
+	case CDB_ASYNC_GET:
+		val.rs = job->res.val;
+		val.flags = PV_VAL_STR;
+		fix_val_str_flags(val);
+
+		if (pv_set_value(msg, (pv_spec_t *)job->param, 0, &val) < 0) {
+			LM_ERR("cannot set the variable value\n");
+			ret = -1;
+		}
+		break;
+	case CDB_ASYNC_ADD:
+	case CDB_ASYNC_SUB:
+		if (!job->param)
+			break;
+
+		val.ri = job->res.new_val;
+		val.flags = PV_TYPE_INT|PV_VAL_INT;
+
+		if (pv_set_value(msg, (pv_spec_t *)job->param, 0, &val) < 0) {
+			LM_ERR("cannot set the variable value\n");
+			ret = -1;
+		}
+		break;
+	case CDB_ASYNC_RAW_QUERY:
+		if (job->res.num_cols > 0 && job->res.reply) {
+			if (cache_raw_query_avps(msg, (pvname_list_t *)job->param,
+					job->res.reply, job->res.num_cols, job->res.num_rows) < 0)
+				ret = -1;
+			job->res.reply = NULL;
 		}
-		free_raw_fetch(cdb_reply,num_cols,num_rows);
+		break;
+	default:
+		break;
 	}
 
+out:
+	if (job->res.val.s)
+		pkg_free(job->res.val.s);
+	if (job->res.reply)
+		free_raw_fetch(job->res.reply, job->res.num_cols, job->res.num_rows);
+	pkg_free(job);
+
+	async_status = ASYNC_DONE;
 	return ret;
 }
 
+/* starts the async cacheDB query, if the engine is able to; returns 1 if
+ * started, 0 if it shall be done in sync mode or -1 on error */
+static int cache_async_start(async_ctx *ctx, enum cdb_async_type type,
+				str *id, str *attr, str *val, int n, int expires, void *param,
+				int num_cols)
+{
+	cdb_async_job *job;
+	int fd;
+
+	job = pkg_malloc(sizeof *job);
+	if (!job) {
+		LM_ERR("no more pkg mem\n");
+		return -1;
+	}
+	memset(job, 0, sizeof *job);
+
+	job->type = type;
+	job->param = param;
+	job->res.num_cols = num_cols;
+
+	fd = cachedb_async_start(id, job, attr, val, n, expires);
+	if (fd < 0) {
+		pkg_free(job);
+		ctx->resume_f = NULL;
+		ctx->resume_param = NULL;
+		async_status = ASYNC_NO_IO;
+		return fd == -2 ? 0 : -1;
+	}
+
+	ctx->resume_f = resume_async_cache_query;
+	ctx->resume_param = job;
+	async_status = fd;
+
+	return 1;
+}
+
+static int w_async_cache_store(struct sip_msg *msg, async_ctx *ctx, str *id,
+				str *attr, str *val, int *expire)
+{
+	int rc;
+
+	if (!attr->s || !attr->len) {
+		LM_ERR("attribute cannot be empty\n");
+		return E_UNSPEC;
+	}
+
+	rc = cache_async_start(ctx, CDB_ASYNC_SET, id, attr, val, 0,
+		expire ? *expire : 0, NULL, 0);
+	if (rc == 0)
+		return w_cache_store(msg, id, attr, val, expire);
+
+	return rc;
+}
+
+static int w_async_cache_fetch(struct sip_msg *msg, async_ctx *ctx, str *id,
+				str *attr, pv_spec_t *res)
+{
+	int rc;
+
+	if (!attr->s || !attr->len) {
+		LM_ERR("attribute cannot be empty\n");
+		return E_UNSPEC;
+	}
+
+	rc = cache_async_start(ctx, CDB_ASYNC_GET, id, attr, NULL, 0, 0, res, 0);
+	if (rc == 0)
+		return w_cache_fetch(msg, id, attr, res);
+
+	return rc;
+}
+
+static int w_async_cache_add(struct sip_msg *msg, async_ctx *ctx, str *id,
+				str *attr, int *inc, int *expire, pv_spec_t *new_val)
+{
+	int rc;
+
+	if (!attr->s || !attr->len) {
+		LM_ERR("attribute cannot be empty\n");
+		return E_UNSPEC;
+	}
+
+	rc = cache_async_start(ctx, CDB_ASYNC_ADD, id, attr, NULL, *inc, *expire,
+		new_val, 0);
+	if (rc == 0)
+		return w_cache_add(msg, id, attr, inc, expire, new_val);
+
+	return rc;
+}
+
+static int w_async_cache_sub(struct sip_msg *msg, async_ctx *ctx, str *id,
+				str *attr, int *dec, int *expire, pv_spec_t *new_val)
+{
+	int rc;
+
+	if (!attr->s || !attr->len) {
+		LM_ERR("attribute cannot be empty\n");
+		return E_UNSPEC;
+	}
+
+	rc = cache_async_start(ctx, CDB_ASYNC_SUB, id, attr, NULL, *dec, *expire,
+		new_val, 0);
+	if (rc == 0)
+		return w_cache_sub(msg, id, attr, dec, expire, new_val);
+
+	return rc;
+}
+
+static int w_async_cache_raw_query(struct sip_msg *msg, async_ctx *ctx,
+				str *id, str *raw_query_s, pvname_list_t *avp_list)
+{
+	pvname_list_t *it;
+	int num_cols = 0, rc;
+
+	if (!raw_query_s || !raw_query_s->s || !raw_query_s->len) {
+		LM_ERR("raw query cannot be empty\n");
+		return E_UNSPEC;
+	}
+
+	for (it=avp_list;it;it=it->next)
+		num_cols++;
+
+	rc = cache_async_start(ctx, CDB_ASYNC_RAW_QUERY, id, raw_query_s, NULL,
+		0, 0, avp_list, num_cols);
+	if (rc == 0)
+		return w_cache_raw_query(msg, id, raw_query_s, avp_list);
+
+	return rc;
+}
+
 static int w_raise_event(struct sip_msg *msg, void *ev_id, pv_spec_t *attrs_avp,
 					pv_spec_t *vals_avp)
 {
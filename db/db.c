@@ -171,6 +171,10 @@ int db_check_api(db_func_t* dbf, char *mname)
 		dbf->cap |= DB_CAP_INSERT_UPDATE;
 	}
 
+	if (dbf->insert_rows) {
+		dbf->cap |= DB_CAP_BULK_INSERT;
+	}
+
 	if (dbf->async_raw_query || dbf->async_resume || dbf->async_free_result) {
 		if (!dbf->async_raw_query || !dbf->async_resume || !dbf->async_free_result) {
 			LM_BUG("NULL async raw_query | resume | free_result in %s", mname);
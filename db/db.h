@@ -277,6 +277,22 @@ typedef int (*db_last_inserted_id_f) (const db_con_t* _h);
 typedef int (*db_insert_update_f) (const db_con_t* _h, const db_key_t* _k,
 				const db_val_t* _v, const int _n);
 
+/**
+ * \brief Insert several rows at once into the specified table.
+ *
+ * Used for flushing the buffered inserts (see query_buffer_size), so the
+ * driver may use its most efficient bulk loading path (e.g. COPY). The rows
+ * are owned (and freed) by the caller.
+ * \param _h structure representing database connection
+ * \param _k key names
+ * \param _rows the rows to be inserted, each holding _n values
+ * \param _nr number of rows
+ * \param _n number of key=value pairs
+ * \return returns 0 if everything is OK, otherwise returns value < 0
+ */
+typedef int (*db_insert_rows_f) (const db_con_t* _h, const db_key_t* _k,
+				db_val_t **_rows, const int _nr, const int _n);
+
 /**
  * \brief Asynchronous raw SQL query on a separate DB connection.
  *		  Returns immediately.
@@ -359,6 +375,7 @@ typedef struct db_func {
 	db_async_raw_query_f   async_raw_query;   /* Starts an asynchronous raw query */
 	db_async_resume_f      async_resume;      /* Called on progress or completed query */
 	db_async_free_result_f async_free_result; /* Clean up after an async query */
+	db_insert_rows_f       insert_rows;       /* Bulk insert of several rows */
 } db_func_t;
 
 
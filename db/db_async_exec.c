@@ -0,0 +1,330 @@
+/*
+ * Shared executor for the async DB queries
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../dprint.h"
+#include "../globals.h"
+#include "../mem/mem.h"
+#include "../mem/shm_mem.h"
+#include "../pt.h"
+#include "../ipc.h"
+#include "../reactor_proc.h"
+#include "../daemonize.h"
+#include "db.h"
+#include "db_row.h"
+#include "db_async_exec.h"
+
+int db_async_executors = 0;
+
+/* process_no of each DB executor process */
+static int *exec_procs;
+
+/* executor side: one async capable handle per DB URL, with its jobs
+ * waiting for a free async connection */
+struct db_exec_url {
+	str url;
+	db_func_t dbf;
+	db_con_t *hdl;
+	int ongoing;
+	db_async_job_t *first;
+	db_async_job_t *last;
+	struct db_exec_url *next;
+};
+
+static struct db_exec_url *exec_urls;
+
+
+void db_async_job_free(db_async_job_t *job)
+{
+	if (job->res)
+		shm_free(job->res);
+	shm_free(job);
+}
+
+
+/* runs in the worker which launched the query */
+static void db_exec_job_done(int sender, void *param)
+{
+	db_async_job_t *job = (db_async_job_t *)param;
+
+	LM_DBG("async query %p completed by executor %d (rc: %d)\n",
+		job, sender, job->rc);
+
+	/* invoke the global resume ASYNC function */
+	async_script_resume_f(ASYNC_FD_NONE, job->ctx, 0);
+}
+
+
+static struct db_exec_url *db_exec_get_url(const str *url)
+{
+	struct db_exec_url *eu;
+
+	for (eu = exec_urls; eu; eu = eu->next)
+		if (eu->url.len == url->len && !memcmp(eu->url.s, url->s, url->len))
+			return eu;
+
+	eu = pkg_malloc(sizeof *eu + url->len);
+	if (!eu) {
+		LM_ERR("no more pkg mem\n");
+		return NULL;
+	}
+	memset(eu, 0, sizeof *eu);
+
+	eu->url.s = (char *)(eu + 1);
+	eu->url.len = url->len;
+	memcpy(eu->url.s, url->s, url->len);
+
+	if (db_bind_mod(&eu->url, &eu->dbf) < 0) {
+		LM_ERR("failed to bind to DB module\n");
+		goto error;
+	}
+
+	eu->hdl = eu->dbf.init(&eu->url);
+	if (!eu->hdl) {
+		LM_ERR("unable to connect to DB\n");
+		goto error;
+	}
+
+	eu->next = exec_urls;
+	exec_urls = eu;
+
+	return eu;
+
+error:
+	pkg_free(eu);
+	return NULL;
+}
+
+
+static void db_exec_reply(db_async_job_t *job)
+{
+	if (ipc_send_rpc(job->proc_no, db_exec_job_done, job) < 0) {
+		LM_ERR("failed to send the result of query %p to process %d\n",
+			job, job->proc_no);
+		db_async_job_free(job);
+	}
+}
+
+
+static void db_exec_start_job(db_async_job_t *job);
+
+/* called once the query of the job is done, successfully or not */
+static void db_exec_finish_job(db_async_job_t *job, db_res_t *res, int rc)
+{
+	struct db_exec_url *eu = job->eu;
+
+	job->rc = rc;
+	if (rc == 0 && res && RES_ROW_N(res) > 0 && RES_COL_N(res) > 0) {
+		job->res = db_res_shm_clone(res);
+		if (!job->res)
+			job->rc = -1;
+	}
+
+	eu->dbf.async_free_result(eu->hdl, res, job->db_priv);
+	eu->ongoing--;
+
+	db_exec_reply(job);
+
+	/* a connection was freed, serve the waiting jobs */
+	while (eu->first && eu->ongoing < db_max_async_connections) {
+		job = eu->first;
+		eu->first = job->next;
+		if (!eu->first)
+			eu->last = NULL;
+
+		db_exec_start_job(job);
+	}
+}
+
+
+static int db_exec_resume(int fd, void *param)
+{
+	db_async_job_t *job = (db_async_job_t *)param;
+	db_res_t *res = NULL;
+	int rc;
+
+	rc = job->eu->dbf.async_resume(job->eu->hdl, fd, &res, job->db_priv);
+	if (async_status == ASYNC_CONTINUE || async_status == ASYNC_CHANGE_FD)
+		return rc;
+
+	db_exec_finish_job(job, res, rc);
+	return 0;
+}
+
+
+static void db_exec_start_job(db_async_job_t *job)
+{
+	struct db_exec_url *eu = job->eu;
+	int fd;
+
+	fd = eu->dbf.async_raw_query(eu->hdl, &job->query, &job->db_priv);
+	if (fd < 0) {
+		LM_ERR("failed to start async query %.*s\n",
+			job->query.len, job->query.s);
+		job->rc = -1;
+		db_exec_reply(job);
+		return;
+	}
+
+	eu->ongoing++;
+
+	if (register_async_fd(fd, db_exec_resume, job) < 0) {
+		LM_ERR("failed to watch the DB fd, completing the query in "
+			"sync mode\n");
+		do {
+			async_status = ASYNC_DONE;
+			fd = db_exec_resume(fd, job);
+		} while (async_status == ASYNC_CONTINUE ||
+			async_status == ASYNC_CHANGE_FD);
+	}
+}
+
+
+/* runs in the executor process */
+static void db_exec_run_job(int sender, void *param)
+{
+	db_async_job_t *job = (db_async_job_t *)param;
+	struct db_exec_url *eu;
+	db_res_t *res = NULL;
+
+	eu = db_exec_get_url(&job->url);
+	if (!eu) {
+		job->rc = -1;
+		db_exec_reply(job);
+		return;
+	}
+	job->eu = eu;
+
+	if (!DB_CAPABILITY(eu->dbf, DB_CAP_ASYNC_RAW_QUERY)) {
+		/* at least it does not block the SIP worker */
+		job->rc = eu->dbf.raw_query(eu->hdl, &job->query, &res);
+		if (job->rc == 0 && res && RES_ROW_N(res) > 0 && RES_COL_N(res) > 0)
+			if (!(job->res = db_res_shm_clone(res)))
+				job->rc = -1;
+		if (res)
+			eu->dbf.free_result(eu->hdl, res);
+		db_exec_reply(job);
+		return;
+	}
+
+	if (eu->ongoing >= db_max_async_connections) {
+		/* all the connections are busy, wait for one */
+		job->next = NULL;
+		if (eu->last)
+			eu->last->next = job;
+		else
+			eu->first = job;
+		eu->last = job;
+		return;
+	}
+
+	db_exec_start_job(job);
+}
+
+
+int db_async_exec_query(const str *url, const str *query, async_ctx *ctx,
+		void *resume_f, void *param)
+{
+	static unsigned int rr;
+	db_async_job_t *job;
+
+	job = shm_malloc(sizeof *job + url->len + query->len + 1);
+	if (!job) {
+		LM_ERR("no more shm\n");
+		return -1;
+	}
+	memset(job, 0, sizeof *job);
+
+	job->ctx = ctx;
+	job->param = param;
+	job->proc_no = process_no;
+
+	job->url.s = (char *)(job + 1);
+	job->url.len = url->len;
+	memcpy(job->url.s, url->s, url->len);
+
+	/* some engines need it null terminated */
+	job->query.s = job->url.s + url->len;
+	job->query.len = query->len;
+	memcpy(job->query.s, query->s, query->len);
+	job->query.s[query->len] = '\0';
+
+	if (ipc_send_rpc(exec_procs[rr++ % db_async_executors],
+			db_exec_run_job, job) < 0) {
+		LM_ERR("failed to send query to the DB executor\n");
+		shm_free(job);
+		return -1;
+	}
+
+	ctx->resume_f = resume_f;
+	ctx->resume_param = job;
+
+	return 0;
+}
+
+
+int db_async_exec_count_processes(void)
+{
+	return db_async_executors;
+}
+
+/* forks the DB executor processes; they only serve the IPC query jobs
+ *
+ * Important : To be called before forking the SIP workers, so they
+ * all know the executors */
+int db_async_exec_start_processes(void)
+{
+	int i, id;
+
+	if (db_async_executors <= 0)
+		return 0;
+
+	exec_procs = pkg_malloc(db_async_executors * sizeof *exec_procs);
+	if (!exec_procs) {
+		LM_ERR("no more pkg mem\n");
+		return -1;
+	}
+
+	for (i = 0; i < db_async_executors; i++) {
+		if ((id=internal_fork("DB executor", 0, TYPE_NONE)) < 0) {
+			LM_CRIT("cannot fork DB executor process\n");
+			return -1;
+		} else if (id == 0) {
+			/* new process */
+			clean_write_pipeend();
+
+			if (reactor_proc_init("DB executor") < 0) {
+				LM_ERR("failed to init the DB executor reactor\n");
+				exit(-1);
+			}
+
+			reactor_proc_loop();
+			exit(-1);
+		}
+
+		exec_procs[i] = id;
+	}
+
+	return 0;
+}
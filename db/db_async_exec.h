@@ -0,0 +1,89 @@
+/*
+ * Shared executor for the async DB queries
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * Instead of each SIP worker opening its own set of async DB connections
+ * (up to "db_max_async_connections" per worker), the async raw queries may
+ * be handed over to a small set of "DB executor" processes. Each executor
+ * multiplexes the queries of all the workers over its own bounded pool of
+ * async connections (queueing the excess) and sends the result back to
+ * the originating worker, where the async script context is resumed
+ * (ASYNC_NO_FD style, via IPC).
+ */
+
+#ifndef DB_ASYNC_EXEC_H
+#define DB_ASYNC_EXEC_H
+
+#include "../str.h"
+#include "../async.h"
+#include "db_res.h"
+
+extern int db_async_executors;
+
+struct db_exec_url;
+
+typedef struct db_async_job {
+	/* the async context to be resumed once the query completes */
+	async_ctx *ctx;
+	/* the parameter of the caller, to be used on resume */
+	void *param;
+	/* the process which launched the query */
+	int proc_no;
+
+	str url;
+	str query;
+
+	/* the outcome of the query: 0 on success and, if any, the result
+	 * set (as a single shm chunk, to be released by the job free) */
+	int rc;
+	db_res_t *res;
+
+	/* executor-side data */
+	struct db_exec_url *eu;
+	void *db_priv;
+	struct db_async_job *next;
+} db_async_job_t;
+
+/**
+ * Returns true if the async queries are to be pushed to the executors
+ */
+#define db_async_exec_enabled() (db_async_executors > 0)
+
+/**
+ * Sends the raw query to one of the DB executor processes. Upon success,
+ * "ctx" is fully set up (resume function and parameter) and the caller
+ * must signal an ASYNC_NO_FD async status. Once the query completes, "f"
+ * is called (in the current process) with the db_async_job_t as
+ * parameter; use job->param, job->rc and job->res, then release it with
+ * db_async_job_free().
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int db_async_exec_query(const str *url, const str *query, async_ctx *ctx,
+		void *resume_f, void *param);
+
+void db_async_job_free(db_async_job_t *job);
+
+int db_async_exec_count_processes(void);
+int db_async_exec_start_processes(void);
+
+#endif /* DB_ASYNC_EXEC_H */
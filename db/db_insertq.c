@@ -25,16 +25,29 @@
 
 #include "../timer.h"
 #include "../pt.h"
+#include "../ipc.h"
+#include "../hash_func.h"
+#include "../reactor_proc.h"
+#include "../daemonize.h"
 
 #include "db_insertq.h"
 #include "db_cap.h"
 
 int query_buffer_size = 0;
 int query_flush_time = 0;
+int query_writer_processes = 0;
 query_list_t **query_list = NULL;
 query_list_t **last_query = NULL;
 gen_lock_t *ql_lock;
 
+/* process_no of each SQL writer process */
+static int *ql_writers;
+
+stat_var *sql_queued_rows;
+stat_var *sql_flushed_rows;
+stat_var *sql_dropped_rows;
+stat_var *sql_writer_flushes;
+
 /* inits all the global variables needed for the insert query lists */
 int init_query_list(void)
 {
@@ -85,6 +98,25 @@ int init_ql_support(void)
 {
 	if (query_buffer_size > 1)
 	{
+		if (query_writer_processes > 0) {
+			ql_writers = shm_malloc(query_writer_processes * sizeof *ql_writers);
+			if (!ql_writers) {
+				LM_ERR("no more shm\n");
+				return -1;
+			}
+			memset(ql_writers, 0, query_writer_processes * sizeof *ql_writers);
+		}
+
+		if (register_stat("sql", "sql_queued_rows", &sql_queued_rows,
+				STAT_NO_RESET) ||
+			register_stat("sql", "sql_flushed_rows", &sql_flushed_rows, 0) ||
+			register_stat("sql", "sql_dropped_rows", &sql_dropped_rows, 0) ||
+			register_stat("sql", "sql_writer_flushes", &sql_writer_flushes, 0))
+		{
+			LM_ERR("failed to register insert queue stats\n");
+			return -1;
+		}
+
 		if  (init_query_list() != 0 ||
 			register_timer("querydb-flush", ql_timer_routine,NULL,
 				query_flush_time>0?query_flush_time:DEF_FLUSH_TIME,
@@ -103,6 +135,7 @@ void flush_query_list(void)
 {
 	query_list_t *it;
 	static db_ps_t my_ps = NULL;
+	db_val_t *row;
 	int i;
 
 	/* no locks, only attendent is left at this point */
@@ -134,12 +167,14 @@ void flush_query_list(void)
 			/* and let's insert the rows */
 			for (i=0;i<it->no_rows;i++)
 			{
+				row = it->rows[(it->first_row + i) % it->max_rows];
+
 				CON_SET_CURR_PS(it->conn[process_no], &my_ps);
-				if (it->dbf.insert(it->conn[process_no],it->cols,it->rows[i],
+				if (it->dbf.insert(it->conn[process_no],it->cols,row,
 							it->col_no) < 0)
 					LM_ERR("failed to insert into DB\n");
 
-				shm_free(it->rows[i]);
+				shm_free(row);
 			}
 
 			/* no longer need this connection */
@@ -194,10 +229,25 @@ void ql_add_unsafe(query_list_t *entry)
 	}
 }
 
+/* removes a query from the list
+ * assumes ql_lock is acquired*/
+static void ql_remove_unsafe(query_list_t *entry)
+{
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		*query_list = entry->next;
+
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		*last_query = entry->prev;
+}
+
 int ql_detach_rows_unsafe(query_list_t *entry,db_val_t ***ins_rows)
 {
 	static db_val_t **detached_rows = NULL;
-	int no_rows;
+	int no_rows,i;
 
 	if (detached_rows == NULL)
 	{
@@ -214,19 +264,32 @@ int ql_detach_rows_unsafe(query_list_t *entry,db_val_t ***ins_rows)
 	if (entry->no_rows == 0)
 		return 0;
 
-	memcpy(detached_rows,entry->rows,query_buffer_size * sizeof(db_val_t *));
-	memset(entry->rows,0,query_buffer_size * sizeof(db_val_t *));
+	/* detach at most one batch, starting with the oldest row */
+	no_rows = entry->no_rows < query_buffer_size ?
+		entry->no_rows : query_buffer_size;
+
+	memset(detached_rows,0,query_buffer_size * sizeof(db_val_t *));
+	for (i=0;i<no_rows;i++)
+	{
+		detached_rows[i] = entry->rows[entry->first_row];
+		entry->rows[entry->first_row] = NULL;
+		entry->first_row = (entry->first_row + 1) % entry->max_rows;
+	}
 
-	no_rows = entry->no_rows;
 	LM_DBG("detached %d rows\n",no_rows);
 
-	entry->no_rows = 0;
-	entry->oldest_query = 0;
+	entry->no_rows -= no_rows;
+	entry->oldest_query = entry->no_rows ? time(0) : 0;
 	*ins_rows = detached_rows;
 
+	update_stat(sql_queued_rows, -no_rows);
+	update_stat(sql_flushed_rows, no_rows);
+
 	return no_rows;
 }
 
+static int ql_send_flush(query_list_t *entry, int all);
+
 /* safely adds a new row to the insert list
  * also checks if the queue is full and returns all the rows that need to
  * be flushed to DB to the caller
@@ -303,20 +366,51 @@ int ql_row_add(query_list_t *entry,const db_val_t *row,db_val_t ***ins_rows)
 	LM_DBG("before locking query entry\n");
 	lock_get(entry->lock);
 
+	if (entry->no_rows == entry->max_rows)
+	{
+		/* the writer cannot keep up with the DB - rather than blocking
+		 * the caller until there is room in the queue, drop the row */
+		lock_release(entry->lock);
+		shm_free(shm_row);
+		update_stat(sql_dropped_rows, 1);
+		LM_ERR("insert queue for table [%.*s] is full (%d rows), "
+			"dropping row\n",entry->table.len,entry->table.s,entry->max_rows);
+		return -1;
+	}
+
 	/* store oldest query for timer to know */
 	if (entry->no_rows == 0)
 		entry->oldest_query = time(0);
 
-	entry->rows[entry->no_rows++] = shm_row;
+	entry->rows[(entry->first_row + entry->no_rows++) % entry->max_rows] =
+		shm_row;
+	update_stat(sql_queued_rows, 1);
 	LM_DBG("query for table [%.*s] has %d rows\n",entry->table.len,entry->table.s,entry->no_rows);
 
 	/* is it time to flush to DB ? */
-	if (entry->no_rows == query_buffer_size)
+	if (entry->no_rows >= query_buffer_size)
 	{
-		if ((no_rows = ql_detach_rows_unsafe(entry,ins_rows)) < 0)
+		if (entry->writer)
+		{
+			/* leave the flushing to the writer process */
+			if (!entry->flush_pending)
+			{
+				entry->flush_pending = 1;
+				lock_release(entry->lock);
+
+				if (ql_send_flush(entry, 0) < 0)
+				{
+					lock_get(entry->lock);
+					entry->flush_pending = 0;
+					lock_release(entry->lock);
+				}
+
+				return 0;
+			}
+		}
+		else if ((no_rows = ql_detach_rows_unsafe(entry,ins_rows)) < 0)
 		{
 			LM_ERR("failed to detach rows for insertion\n");
-			lock_release(entry->lock);
 			return -1;
 		}
 	}
@@ -328,15 +422,18 @@ int ql_row_add(query_list_t *entry,const db_val_t *row,db_val_t ***ins_rows)
 /* initializez a new query entry */
 query_list_t *ql_init(db_con_t *con,db_key_t *cols,int col_no)
 {
-	int key_size,row_q_size,size,i;
+	int key_size,row_q_size,size,i,max_rows;
 	char *pos;
 	query_list_t *entry;
 
+	max_rows = query_buffer_size *
+		(query_writer_processes > 0 ? QL_WRITER_BATCHES : 1);
+
 	key_size = col_no * sizeof(db_key_t) + col_no * sizeof(str);
 	for (i=0;i<col_no;i++)
 		key_size += cols[i]->len;
 
-	row_q_size = sizeof(db_val_t *) * query_buffer_size;
+	row_q_size = sizeof(db_val_t *) * max_rows;
 	size = sizeof(query_list_t) +
 		counted_max_processes * sizeof(db_con_t *) +
 		con->table->len + key_size + row_q_size + con->url.len;
@@ -390,6 +487,12 @@ query_list_t *ql_init(db_con_t *con,db_key_t *cols,int col_no)
 	/* deal with the rows */
 	entry->rows = (db_val_t **)(void *)((char *)(entry + 1) +
 					con->table->len + key_size);
+	entry->max_rows = max_rows;
+
+	/* all the queries for the same DB URL go to the same writer */
+	if (query_writer_processes > 0)
+		entry->writer = ql_writers[core_hash(&con->url, NULL,
+			query_writer_processes)];
 
 	/* save url for later use by timer */
 	entry->url.s = (char *)entry + sizeof(query_list_t) +
@@ -421,6 +524,10 @@ query_list_t *find_query_list_unsafe(const str *table,db_key_t *cols,int col_no)
 	{
 		LM_DBG("iterating through %p\n",it);
 
+		/* on its way to be freed */
+		if (it->unused)
+			continue;
+
 		/* match number of columns */
 		if (it->col_no != col_no)
 		{
@@ -506,6 +613,7 @@ int con_set_inslist(db_func_t *dbf,db_con_t *con,query_list_t **list,
 			}
 
 			ql_add_unsafe(entry);
+			entry->refs++;
 			con->ins_list = entry;
 			*list = entry;
 		}
@@ -514,6 +622,7 @@ int con_set_inslist(db_func_t *dbf,db_con_t *con,query_list_t **list,
 			LM_DBG("query list already exists - attaching\n");
 			/* another process has done a query of this type,
 			 * just attach to the con and save for later use */
+			entry->refs++;
 			con->ins_list = entry;
 			*list = entry;
 		}
@@ -532,6 +641,76 @@ int con_set_inslist(db_func_t *dbf,db_con_t *con,query_list_t **list,
 	return 0;
 }
 
+/* drops the reference of the current process to a query list, previously
+ * set by con_set_inslist(); once no process uses it, the insert timer
+ * flushes its remaining rows and frees it */
+void ql_release(query_list_t *entry)
+{
+	if (query_buffer_size <= 1 || !entry)
+		return;
+
+	lock_get(ql_lock);
+	if (--entry->refs == 0)
+	{
+		LM_DBG("query list for table [%.*s] no longer used\n",
+			entry->table.len,entry->table.s);
+		entry->unused = 1;
+	}
+	lock_release(ql_lock);
+}
+
+/* frees an unused query list, once all its rows were flushed
+ * returns 1 if freed, 0 if it still has to wait for its rows or writer
+ *
+ * Important : only the insert timer frees the query lists, so it is
+ * the only one walking the list without holding ql_lock */
+static int ql_free_unused(query_list_t *entry)
+{
+	lock_get(entry->lock);
+
+	/* the rows are flushed by the usual timer path */
+	if (entry->no_rows > 0 || entry->flush_pending)
+	{
+		lock_release(entry->lock);
+		return 0;
+	}
+
+	/* have the writer close its connection first */
+	if (entry->writer && entry->conn[entry->writer])
+	{
+		entry->flush_pending = 1;
+		lock_release(entry->lock);
+
+		if (ql_send_flush(entry, 1) < 0)
+		{
+			lock_get(entry->lock);
+			entry->flush_pending = 0;
+			lock_release(entry->lock);
+		}
+		return 0;
+	}
+
+	lock_release(entry->lock);
+
+	if (entry->conn[process_no])
+	{
+		entry->dbf.close(entry->conn[process_no]);
+		entry->conn[process_no] = NULL;
+	}
+
+	lock_get(ql_lock);
+	ql_remove_unsafe(entry);
+	lock_release(ql_lock);
+
+	LM_DBG("freeing query list for table [%.*s]\n",
+		entry->table.len,entry->table.s);
+
+	lock_destroy(entry->lock);
+	lock_dealloc(entry->lock);
+	shm_free(entry);
+	return 1;
+}
+
 /* clean shm memory used by the rows */
 void cleanup_rows(db_val_t **rows)
 {
@@ -550,20 +729,47 @@ void cleanup_rows(db_val_t **rows)
  * that flushes old rows to DB */
 void ql_timer_routine(unsigned int ticks,void *param)
 {
-	query_list_t *it;
+	query_list_t *it, *next;
 	time_t now;
 
 	now = time(0);
 
-	for (it=*query_list;it;it=it->next)
+	for (it=*query_list;it;it=next)
 	{
+		next = it->next;
+
+		if (it->unused && ql_free_unused(it))
+			continue;
+
 		lock_get(it->lock);
 
-		/* are there any old queries in queue ? */
-		if (it->oldest_query && (now - it->oldest_query > query_flush_time))
+		/* are there any old queries in queue ? (the unused lists are
+		 * flushed right away) */
+		if (it->oldest_query &&
+			(it->unused || now - it->oldest_query > query_flush_time))
 		{
 			LM_DBG("insert timer kicking in for query %p [%d]\n",it, it->no_rows);
 
+			if (it->writer)
+			{
+				/* the writer will flush them, if not already doing so */
+				if (!it->flush_pending)
+				{
+					it->flush_pending = 1;
+					lock_release(it->lock);
+
+					if (ql_send_flush(it, 1) < 0)
+					{
+						lock_get(it->lock);
+						it->flush_pending = 0;
+						lock_release(it->lock);
+					}
+				}
+				else
+					lock_release(it->lock);
+				continue;
+			}
+
 			if (it->dbf.init == NULL)
 			{
 				/* first time timer kicked in for this query */
@@ -635,6 +841,9 @@ void ql_force_process_disconnect(int p_id)
 	query_list_t *it;
 
 	if (query_list) {
+		/* the unused lists may be freed meanwhile by the timer */
+		lock_get(ql_lock);
+
 		for (it=*query_list;it;it=it->next) {
 			lock_get(it->lock);
 
@@ -645,6 +854,164 @@ void ql_force_process_disconnect(int p_id)
 
 			lock_release(it->lock);
 		}
+
+		lock_release(ql_lock);
+	}
+}
+
+
+/* returns the DB connection of the current (writer) process for @entry */
+static db_con_t *ql_writer_conn(query_list_t *entry)
+{
+	if (entry->dbf.init == NULL && db_bind_mod(&entry->url,&entry->dbf) < 0)
+	{
+		LM_ERR("writer failed to bind to db\n");
+		return NULL;
+	}
+
+	if (entry->conn[process_no] == NULL)
+	{
+		entry->conn[process_no] = entry->dbf.init(&entry->url);
+		if (entry->conn[process_no] == NULL)
+		{
+			LM_ERR("unable to connect to DB\n");
+			return NULL;
+		}
+
+		LM_DBG("writer has init conn for query %p\n",entry);
+	}
+
+	return entry->conn[process_no];
+}
+
+/* flushes to DB the full batches of queued rows (or all the rows, if
+ * @all is set), using the bulk insert of the DB engine, if available */
+static void ql_writer_flush(query_list_t *entry, int all)
+{
+	db_con_t *con;
+	db_val_t **rows;
+	int no_rows;
+
+	con = ql_writer_conn(entry);
+
+	for (;;)
+	{
+		lock_get(entry->lock);
+
+		if (!con || entry->no_rows == 0 ||
+			(!all && entry->no_rows < query_buffer_size))
+		{
+			/* nothing left to write, the list is about to be freed */
+			if (con && entry->unused && entry->no_rows == 0)
+			{
+				entry->dbf.close(con);
+				entry->conn[process_no] = NULL;
+				entry->writer_ps = NULL;
+			}
+
+			/* the leftovers (if any) will be flushed on timer */
+			entry->flush_pending = 0;
+			lock_release(entry->lock);
+			return;
+		}
+
+		entry->dbf.use_table(con,&entry->table);
+
+		if (!DB_CAPABILITY(entry->dbf,DB_CAP_BULK_INSERT))
+		{
+			/* let the DB engine detach and insert the rows */
+			con->ins_list = entry;
+			CON_FLUSH_UNSAFE(con);
+
+			if (entry->dbf.insert(con,entry->cols,(db_val_t *)-1,
+						entry->col_no) < 0)
+				LM_ERR("failed to insert rows to DB\n");
+
+			update_stat(sql_writer_flushes, 1);
+			continue;
+		}
+
+		if ((no_rows = ql_detach_rows_unsafe(entry,&rows)) < 0)
+		{
+			LM_ERR("failed to detach rows for insertion\n");
+			lock_get(entry->lock);
+			entry->flush_pending = 0;
+			lock_release(entry->lock);
+			return;
+		}
+		lock_release(entry->lock);
+
+		/* the DB engine may insert the rows through a prepared statement */
+		CON_SET_CURR_PS(con,&entry->writer_ps);
+		if (entry->dbf.insert_rows(con,entry->cols,rows,no_rows,
+					entry->col_no) < 0)
+			LM_ERR("failed to insert %d rows to DB\n",no_rows);
+
+		cleanup_rows(rows);
+
+		update_stat(sql_writer_flushes, 1);
+	}
+}
+
+static void ql_writer_flush_batches(int sender, void *param)
+{
+	ql_writer_flush((query_list_t *)param, 0);
+}
+
+static void ql_writer_flush_all(int sender, void *param)
+{
+	ql_writer_flush((query_list_t *)param, 1);
+}
+
+static int ql_send_flush(query_list_t *entry, int all)
+{
+	if (ipc_send_rpc(entry->writer,
+			all ? ql_writer_flush_all : ql_writer_flush_batches, entry) < 0)
+	{
+		LM_ERR("failed to send flush job to SQL writer %d\n",entry->writer);
+		return -1;
 	}
+
+	return 0;
 }
 
+int ql_count_writer_processes(void)
+{
+	return (query_buffer_size > 1 && ql_writers) ? query_writer_processes : 0;
+}
+
+/* forks the SQL writer processes; they only serve IPC flush jobs
+ *
+ * Important : To be called before forking any other processes which may
+ * buffer inserts, so they all know the writers */
+int ql_start_writer_processes(void)
+{
+	int i, id;
+
+	for (i=0;i<ql_count_writer_processes();i++)
+	{
+		if ((id=internal_fork("SQL writer", 0, TYPE_NONE)) < 0)
+		{
+			LM_CRIT("cannot fork SQL writer process\n");
+			return -1;
+		}
+		else if (id == 0)
+		{
+			/* new process */
+			clean_write_pipeend();
+
+			if (reactor_proc_init("SQL writer") < 0)
+			{
+				LM_ERR("failed to init the SQL writer reactor\n");
+				exit(-1);
+			}
+
+			reactor_proc_loop();
+			exit(-1);
+		}
+
+		ql_writers[i] = id;
+	}
+
+	return 0;
+}
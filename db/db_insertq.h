@@ -29,6 +29,7 @@
 #include "db_ut.h"
 #include "db_query.h"
 #include "../locking.h"
+#include "../statistics.h"
 
 extern int query_buffer_size; /* number of insert queries that will be
 								 held in memory once this number of same
@@ -38,9 +39,19 @@ extern int query_flush_time; /* if the query contains inserts older
 								that query_flush_time seconds, the timer
 								will kick in and flush to DB,
 								to maintain "real time" sync with DB */
+extern int query_writer_processes; /* number of dedicated processes which
+								flush the queued rows to DB; if 0, the
+								process filling up a query is flushing it */
+
+extern stat_var *sql_queued_rows;
+extern stat_var *sql_flushed_rows;
+extern stat_var *sql_dropped_rows;
+extern stat_var *sql_writer_flushes;
 
 #define CON_HAS_INSLIST(cn)	((cn)->ins_list)
 #define DEF_FLUSH_TIME		10 /* seconds */
+#define QL_WRITER_BATCHES	16 /* queue capacity, in batches of
+								  query_buffer_size rows, with writers */
 
 typedef struct query_list {
 	str url;			/* url for the connection - needed by timer */
@@ -49,9 +60,16 @@ typedef struct query_list {
 	str table;			/* table that query is targetting */
 	db_key_t *cols;		/* columns for the insert */
 	int col_no;			/* number of columns */
-	db_val_t **rows;	/* rows queued to be inserted */
+	db_val_t **rows;	/* ring of rows queued to be inserted */
+	int max_rows;		/* capacity of the ring */
+	int first_row;		/* index of the oldest row in the ring */
 	gen_lock_t* lock;	/* lock for adding rows */
 	int no_rows;		/* number of rows in queue */
+	int writer;			/* process flushing the rows, 0 if none */
+	int flush_pending;	/* a flush job is pending in the writer */
+	db_ps_t writer_ps;	/* prepared statement of the writer, if any */
+	int refs;			/* number of processes using the list */
+	int unused;			/* released by all processes, to be freed */
 	time_t oldest_query;	/* timestamp of oldest query in queue */
 	struct query_list *next;
 	struct query_list *prev;
@@ -61,10 +79,13 @@ extern query_list_t **query_list;
 extern gen_lock_t *ql_lock;
 
 int init_ql_support(void);
+int ql_count_writer_processes(void);
+int ql_start_writer_processes(void);
 int ql_row_add(query_list_t *entry,const db_val_t *row,db_val_t ***ins_rows);
 int ql_detach_rows_unsafe(query_list_t *entry,db_val_t ***ins_rows);
 int con_set_inslist(db_func_t *dbf,db_con_t *con,
 							query_list_t **list,db_key_t *cols,int col_no);
+void ql_release(query_list_t *entry);
 void ql_timer_routine(unsigned int ticks,void *param);
 int ql_flush_rows(db_func_t *dbf, db_con_t *conn,query_list_t *entry);
 void ql_force_process_disconnect(int p_id);
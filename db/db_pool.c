@@ -117,3 +117,9 @@ int pool_remove(struct pool_con* con)
 
 	return 1;
 }
+
+
+void pool_detach(void)
+{
+	db_pool = 0;
+}
@@ -85,4 +85,12 @@ void pool_insert(struct pool_con* con);
 int pool_remove(struct pool_con* con);
 
 
+/**
+ * Forget all the pooled connections, without closing them. To be used by
+ * a freshly forked process, so it does not share the connections (still
+ * used by its parent) when opening its own ones.
+ */
+void pool_detach(void);
+
+
 #endif /* _POOL_H */
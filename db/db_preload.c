@@ -0,0 +1,438 @@
+/*
+ * Parallel loading of whole tables at startup
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "../dprint.h"
+#include "../mem/mem.h"
+#include "../mem/shm_mem.h"
+#include "db.h"
+#include "db_pool.h"
+#include "db_preload.h"
+
+int db_preload_workers = 0;
+
+#define DB_PRELOAD_MAX_WORKERS  64
+#define DB_PRELOAD_BATCH_ROWS   1000
+/* batches in flight, per helper */
+#define DB_PRELOAD_CREDITS      4
+
+/* the end-of-range markers sent by the helpers */
+#define DB_PRELOAD_DONE    ((db_res_t *)0)
+#define DB_PRELOAD_FAILED  ((db_res_t *)-1)
+
+typedef int (*db_preload_chunk_f)(db_res_t *res, void *param);
+
+struct db_preload_rows {
+	db_preload_row_f row_f;
+	void *param;
+};
+
+struct db_preload_helper {
+	int out;        /* batches to the loader */
+	int credits;    /* one byte for each batch that may be sent */
+};
+
+
+/* runs the query and passes the result, chunk by chunk, to "chunk_f" */
+static int db_preload_query(const struct db_preload *p, db_con_t *con,
+		db_key_t *keys, db_op_t *ops, db_val_t *vals, int n_keys,
+		db_preload_chunk_f chunk_f, void *param)
+{
+	db_res_t *res = NULL;
+	int rows, rc = 0;
+
+	if (p->dbf->use_table(con, p->table) < 0) {
+		LM_ERR("failed to use table %.*s\n", p->table->len, p->table->s);
+		return -1;
+	}
+
+	if (DB_CAPABILITY(*p->dbf, DB_CAP_FETCH)) {
+		if (p->dbf->query(con, keys, ops, vals, p->cols, n_keys, p->n_cols,
+		0, 0) < 0) {
+			LM_ERR("failed to query table %.*s\n", p->table->len, p->table->s);
+			return -1;
+		}
+
+		rows = p->row_size ? estimate_available_rows(p->row_size, p->n_cols)
+			: DB_PRELOAD_BATCH_ROWS;
+		if (rows <= 0 || rows > DB_PRELOAD_BATCH_ROWS)
+			rows = DB_PRELOAD_BATCH_ROWS;
+
+		do {
+			if (p->dbf->fetch_result(con, &res, rows) < 0) {
+				LM_ERR("failed to fetch rows from %.*s\n",
+					p->table->len, p->table->s);
+				rc = -1;
+				break;
+			}
+
+			if (RES_ROW_N(res) > 0 && chunk_f(res, param) < 0) {
+				rc = -1;
+				break;
+			}
+		} while (RES_ROW_N(res) > 0);
+	} else {
+		if (p->dbf->query(con, keys, ops, vals, p->cols, n_keys, p->n_cols,
+		0, &res) < 0) {
+			LM_ERR("failed to query table %.*s\n", p->table->len, p->table->s);
+			return -1;
+		}
+
+		if (RES_ROW_N(res) > 0 && chunk_f(res, param) < 0)
+			rc = -1;
+	}
+
+	if (res)
+		p->dbf->free_result(con, res);
+
+	return rc;
+}
+
+
+static int db_preload_rows(db_res_t *res, void *param)
+{
+	struct db_preload_rows *r = (struct db_preload_rows *)param;
+	int i;
+
+	for (i = 0; i < RES_ROW_N(res); i++)
+		if (r->row_f(ROW_VALUES(RES_ROWS(res) + i), RES_COL_N(res),
+		r->param) < 0)
+			return -1;
+
+	return 0;
+}
+
+
+static int db_preload_send(int fd, db_res_t *batch)
+{
+	while (write(fd, &batch, sizeof batch) < 0)
+		if (errno != EINTR) {
+			LM_ERR("failed to pass a batch: %s\n", strerror(errno));
+			return -1;
+		}
+
+	return 0;
+}
+
+
+/* helper side: clone each chunk into shm and pass it to the loader */
+static int db_preload_send_chunk(db_res_t *res, void *param)
+{
+	struct db_preload_helper *h = (struct db_preload_helper *)param;
+	db_res_t *batch;
+	char credit;
+	int rc;
+
+	/* do not get too far ahead of the loader */
+	while ((rc = read(h->credits, &credit, 1)) <= 0) {
+		if (rc == 0) {
+			LM_DBG("the loader gave up, stopping\n");
+			return -1;
+		}
+		if (errno != EINTR) {
+			LM_ERR("failed to wait for the loader: %s\n", strerror(errno));
+			return -1;
+		}
+	}
+
+	batch = db_res_shm_clone(res);
+	if (!batch)
+		return -1;
+
+	if (db_preload_send(h->out, batch) < 0) {
+		shm_free(batch);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/* returns 0 if the boundaries were found, 1 if the table is empty or -1
+ * if they could not be determined */
+static int db_preload_get_range(const struct db_preload *p, db_con_t *con,
+		long long *min, long long *max)
+{
+	static char buf[256];
+	db_res_t *res = NULL;
+	db_val_t *v;
+	str q;
+	int i, rc = -1;
+
+	q.len = snprintf(buf, sizeof buf, "SELECT MIN(%.*s),MAX(%.*s) FROM %.*s",
+		p->split_key->len, p->split_key->s,
+		p->split_key->len, p->split_key->s, p->table->len, p->table->s);
+	if (q.len >= sizeof buf) {
+		LM_ERR("query too long\n");
+		return -1;
+	}
+	q.s = buf;
+
+	if (p->dbf->raw_query(con, &q, &res) < 0) {
+		LM_ERR("failed to get the boundaries of %.*s\n",
+			p->table->len, p->table->s);
+		return -1;
+	}
+
+	if (RES_ROW_N(res) != 1 || RES_COL_N(res) != 2)
+		goto out;
+
+	v = ROW_VALUES(RES_ROWS(res));
+	if (VAL_NULL(v) || VAL_NULL(v + 1)) {
+		rc = 1;
+		goto out;
+	}
+
+	for (i = 0; i < 2; i++) {
+		switch (VAL_TYPE(v + i)) {
+		case DB_INT:
+			*(i ? max : min) = VAL_INT(v + i);
+			break;
+		case DB_BIGINT:
+			*(i ? max : min) = VAL_BIGINT(v + i);
+			break;
+		default:
+			LM_DBG("%.*s is not an integer column (%d)\n",
+				p->split_key->len, p->split_key->s, VAL_TYPE(v + i));
+			goto out;
+		}
+	}
+	rc = 0;
+
+out:
+	p->dbf->free_result(con, res);
+	return rc;
+}
+
+
+static void db_preload_helper(const struct db_preload *p, long long lo,
+		long long hi, int first, int last, struct db_preload_helper *h)
+{
+	db_key_t keys[p->n_keys + 2];
+	db_op_t ops[p->n_keys + 2];
+	db_val_t vals[p->n_keys + 2];
+	db_con_t *con;
+	int n = p->n_keys, rc;
+
+	/* the connections of the parent are not ours to use */
+	pool_detach();
+
+	con = p->dbf->init(p->url);
+	if (!con) {
+		LM_ERR("failed to connect to the database\n");
+		db_preload_send(h->out, DB_PRELOAD_FAILED);
+		_exit(1);
+	}
+
+	if (n) {
+		memcpy(keys, p->keys, n * sizeof *keys);
+		memcpy(ops, p->ops, n * sizeof *ops);
+		memcpy(vals, p->vals, n * sizeof *vals);
+	}
+
+	/* the outer ranges are open, so the rows inserted meanwhile with
+	 * keys outside of [min, max] are not lost */
+	memset(vals + n, 0, 2 * sizeof *vals);
+	if (!first) {
+		keys[n] = p->split_key;
+		ops[n] = OP_GEQ;
+		VAL_TYPE(vals + n) = DB_BIGINT;
+		VAL_BIGINT(vals + n) = lo;
+		n++;
+	}
+	if (!last) {
+		keys[n] = p->split_key;
+		ops[n] = OP_LT;
+		VAL_TYPE(vals + n) = DB_BIGINT;
+		VAL_BIGINT(vals + n) = hi;
+		n++;
+	}
+
+	rc = db_preload_query(p, con, keys, ops, vals, n,
+		db_preload_send_chunk, h);
+
+	db_preload_send(h->out, rc < 0 ? DB_PRELOAD_FAILED : DB_PRELOAD_DONE);
+
+	p->dbf->close(con);
+	_exit(rc < 0 ? 1 : 0);
+}
+
+
+/* stops the @n helpers already started and discards what they loaded so
+ * far: with no more credits granted, each of them stops at its next batch */
+static void db_preload_abort(pid_t *pids, int n, int out[2], int credits[2])
+{
+	db_res_t *batch;
+	int i, rc;
+
+	close(credits[1]);
+	close(out[1]);
+
+	while ((rc = read(out[0], &batch, sizeof batch)) != 0) {
+		if (rc < 0) {
+			if (errno == EINTR)
+				continue;
+			LM_ERR("failed to read a batch: %s\n", strerror(errno));
+			for (i = 0; i < n; i++)
+				kill(pids[i], SIGKILL);
+			break;
+		}
+
+		if (batch != DB_PRELOAD_DONE && batch != DB_PRELOAD_FAILED)
+			shm_free(batch);
+	}
+
+	for (i = 0; i < n; i++)
+		/* may have already been reaped by the SIGCHLD handler */
+		while (waitpid(pids[i], NULL, 0) < 0 && errno == EINTR) ;
+
+	close(out[0]);
+	close(credits[0]);
+}
+
+
+int db_preload_table(const struct db_preload *p, db_con_t *con,
+		db_preload_row_f row_f, void *param)
+{
+	struct db_preload_rows r = {row_f, param};
+	struct db_preload_helper h;
+	pid_t pids[DB_PRELOAD_MAX_WORKERS];
+	unsigned long long span, step;
+	long long min, max, lo;
+	int out[2], credits[2];
+	int n, i, done = 0, failed = 0, rc;
+	db_res_t *batch;
+	char credit = 0;
+
+	n = db_preload_workers;
+	if (n > DB_PRELOAD_MAX_WORKERS)
+		n = DB_PRELOAD_MAX_WORKERS;
+
+	if (n < 2 || !p->split_key || !p->url ||
+	!DB_CAPABILITY(*p->dbf, DB_CAP_FETCH|DB_CAP_RAW_QUERY))
+		goto sequential;
+
+	rc = db_preload_get_range(p, con, &min, &max);
+	if (rc != 0)
+		goto sequential;
+
+	span = (unsigned long long)max - (unsigned long long)min;
+	if (span < n)
+		goto sequential;
+	step = span / n;
+
+	if (pipe(out) < 0) {
+		LM_ERR("failed to create pipe: %s\n", strerror(errno));
+		goto sequential;
+	}
+	if (pipe(credits) < 0) {
+		LM_ERR("failed to create pipe: %s\n", strerror(errno));
+		close(out[0]);
+		close(out[1]);
+		goto sequential;
+	}
+
+	for (i = 0; i < n * DB_PRELOAD_CREDITS; i++)
+		if (write(credits[1], &credit, 1) < 0)
+			LM_ERR("failed to grant credit: %s\n", strerror(errno));
+
+	h.out = out[1];
+	h.credits = credits[0];
+
+	for (i = 0; i < n; i++) {
+		lo = (long long)((unsigned long long)min + step * i);
+
+		pids[i] = fork();
+		if (pids[i] < 0) {
+			LM_ERR("failed to fork a preload helper: %s\n", strerror(errno));
+			/* the helpers already running cover less than the table */
+			db_preload_abort(pids, i, out, credits);
+			goto sequential;
+		}
+
+		if (pids[i] == 0) {
+			close(out[0]);
+			close(credits[1]);
+			db_preload_helper(p, lo, (long long)((unsigned long long)lo + step),
+				i == 0, i == n - 1, &h);
+		}
+	}
+
+	close(out[1]);
+
+	LM_DBG("loading %.*s with %d helpers, keys %lld..%lld\n",
+		p->table->len, p->table->s, n, min, max);
+
+	while (done < n) {
+		rc = read(out[0], &batch, sizeof batch);
+		if (rc < 0) {
+			if (errno == EINTR)
+				continue;
+			LM_ERR("failed to read a batch: %s\n", strerror(errno));
+			failed = 1;
+			break;
+		}
+
+		if (rc == 0) {
+			LM_ERR("%d preload helpers died unexpectedly\n", n - done);
+			failed = 1;
+			break;
+		}
+
+		if (batch == DB_PRELOAD_DONE || batch == DB_PRELOAD_FAILED) {
+			if (batch == DB_PRELOAD_FAILED)
+				failed = 1;
+			done++;
+			continue;
+		}
+
+		/* keep draining the helpers, even if the loading failed */
+		if (!failed && db_preload_rows(batch, &r) < 0)
+			failed = 1;
+
+		shm_free(batch);
+
+		if (write(credits[1], &credit, 1) < 0)
+			LM_ERR("failed to grant credit: %s\n", strerror(errno));
+	}
+
+	for (i = 0; i < n; i++)
+		/* may have already been reaped by the SIGCHLD handler */
+		while (waitpid(pids[i], NULL, 0) < 0 && errno == EINTR) ;
+
+	close(out[0]);
+	close(credits[0]);
+	close(credits[1]);
+
+	return failed ? -1 : 0;
+
+sequential:
+	return db_preload_query(p, con, p->keys, p->ops, p->vals, p->n_keys,
+		db_preload_rows, &r);
+}
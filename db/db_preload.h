@@ -0,0 +1,82 @@
+/*
+ * Parallel loading of whole tables at startup
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/**
+ * A table is split in "db_preload_workers" ranges of an integer key column
+ * and each range is fetched by a short-lived helper process, over its own
+ * DB connection. The rows are passed back in shm batches (through a pipe,
+ * with a bounded number of batches in flight), so the calling process only
+ * has to build its data out of ready-made rows, while the helpers wait for
+ * the DB and decode its replies.
+ *
+ * With no helpers configured, with a backend not able to fetch results in
+ * chunks or to run raw queries (needed for getting the key boundaries), the
+ * table is simply loaded by the calling process, with the same row callback.
+ */
+
+#ifndef DB_PRELOAD_H
+#define DB_PRELOAD_H
+
+#include "../str.h"
+#include "db.h"
+
+extern int db_preload_workers;
+
+struct db_preload {
+	const str *url;
+	db_func_t *dbf;
+	const str *table;
+
+	/* the columns to be loaded */
+	db_key_t *cols;
+	int n_cols;
+
+	/* optional filters */
+	db_key_t *keys;
+	db_op_t *ops;
+	db_val_t *vals;
+	int n_keys;
+
+	/* integer column (usually the primary key) used for splitting the
+	 * table - if missing, the table is not split */
+	db_key_t split_key;
+
+	/* estimated size of a row, for sizing the fetched chunks (optional) */
+	int row_size;
+};
+
+/**
+ * Called (in the calling process) for each loaded row; a negative return
+ * code aborts the loading.
+ */
+typedef int (*db_preload_row_f)(db_val_t *vals, int n_vals, void *param);
+
+/**
+ * Loads all the (matching) rows of a table. "con" is the connection of the
+ * caller, only used in the calling process.
+ *
+ * Returns 0 on success, -1 on error.
+ */
+int db_preload_table(const struct db_preload *p, db_con_t *con,
+		db_preload_row_f row_f, void *param);
+
+#endif /* DB_PRELOAD_H */
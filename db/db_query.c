@@ -348,6 +348,62 @@ err_exit:
 }
 
 
+int db_do_insert_rows(const db_con_t* _h, const db_key_t* _k,
+	db_val_t **_rows, const int _nr, const int _n,
+	int (*val2str) (const db_con_t*, const db_val_t*, char*, int*),
+	int (*submit_query)(const db_con_t* _h, const str* _c))
+{
+	int off, ret, i;
+
+	if (!_h || !_k || !_rows || !_nr || !_n || !val2str || !submit_query) {
+		LM_ERR("invalid parameter value\n");
+		return -1;
+	}
+
+	ret = snprintf(sql_buf, SQL_BUF_LEN, "insert into %.*s (", CON_TABLE(_h)->len, CON_TABLE(_h)->s);
+	if (ret < 0 || ret >= SQL_BUF_LEN) goto error;
+	off = ret;
+
+	ret = db_print_columns(sql_buf + off, SQL_BUF_LEN - off, _k, _n);
+	if (ret < 0) goto error;
+	off += ret;
+
+	ret = snprintf(sql_buf + off, SQL_BUF_LEN - off, ") values");
+	if (ret < 0 || ret >= (SQL_BUF_LEN - off)) goto error;
+	off += ret;
+
+	for (i=0;i<_nr;i++)
+	{
+		if (off + 1 > SQL_BUF_LEN) goto error;
+		sql_buf[off++]='(';
+		ret = db_print_values(_h, sql_buf + off, SQL_BUF_LEN - off,
+								_rows[i], _n, val2str);
+		if (ret < 0) goto error;
+		off += ret;
+
+		if (off + 2 > SQL_BUF_LEN) goto error;
+		sql_buf[off++]=')';
+		if (i != (_nr - 1))
+			sql_buf[off++]=',';
+	}
+
+	if (off + 1 > SQL_BUF_LEN) goto error;
+	sql_buf[off] = '\0';
+	sql_str.s = sql_buf;
+	sql_str.len = off;
+
+	if (submit_query(_h, &sql_str) < 0) {
+		LM_ERR("error while submitting query\n");
+		return -2;
+	}
+	return 0;
+
+error:
+	LM_ERR("error while preparing multi-row insert operation\n");
+	return -1;
+}
+
+
 int db_do_update(const db_con_t* _h, const db_key_t* _k, const db_op_t* _o,
 	const db_val_t* _v, const db_key_t* _uk, const db_val_t* _uv, const int _n,
 	const int _un, int (*val2str) (const db_con_t*, const db_val_t*, char*, int*),
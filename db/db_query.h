@@ -111,6 +111,27 @@ int db_do_insert(const db_con_t* _h, const db_key_t* _k, const db_val_t* _v,
 	int (*submit_query)(const db_con_t* _h, const str* _c));
 
 
+/**
+ * \brief Helper function for db multi-row insert operations
+ *
+ * Builds a single "insert ... values (...),(...)" statement out of all the
+ * given rows and submits it. The rows are not freed.
+ *
+ * \param _h structure representing database connection
+ * \param _k key names
+ * \param _rows the rows to be inserted, each holding _n values
+ * \param _nr number of rows
+ * \param _n number of key/value pairs
+ * \param (*val2str) function pointer to the db specific val conversion function
+ * \param (*submit_query) function pointer to the db specific query submit function
+ * \return zero on success, negative on errors
+ */
+int db_do_insert_rows(const db_con_t* _h, const db_key_t* _k,
+	db_val_t **_rows, const int _nr, const int _n,
+	int (*val2str) (const db_con_t*, const db_val_t*, char*, int*),
+	int (*submit_query)(const db_con_t* _h, const str* _c));
+
+
 /**
  * \brief Helper function for db delete operations
  *
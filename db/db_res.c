@@ -32,6 +32,7 @@
 #include "db_row.h"
 #include "../dprint.h"
 #include "../mem/mem.h"
+#include "../mem/shm_mem.h"
 
 #include <string.h>
 
@@ -213,3 +214,106 @@ int db_realloc_rows(db_res_t *_res, const unsigned int old_rows,
 
 	return 0;
 }
+
+
+/*
+ * Clone a result set into a single shm chunk (to be released with shm_free)
+ */
+db_res_t *db_res_shm_clone(db_res_t *res)
+{
+	db_res_t *clone;
+	db_val_t *v, *cv;
+	char *p;
+	int size, i, j, cols, rows;
+
+	cols = RES_COL_N(res);
+	rows = RES_ROW_N(res);
+
+	size = sizeof *clone + rows * sizeof(db_row_t) +
+		rows * cols * sizeof(db_val_t) +
+		cols * (sizeof(db_key_t) + sizeof(str) + sizeof(db_type_t));
+
+	for (i = 0; i < cols; i++)
+		size += RES_NAMES(res)[i]->len;
+
+	for (i = 0; i < rows; i++)
+		for (j = 0; j < cols; j++) {
+			v = &ROW_VALUES(&RES_ROWS(res)[i])[j];
+			if (VAL_NULL(v))
+				continue;
+
+			switch (VAL_TYPE(v)) {
+			case DB_STRING:
+				size += strlen(VAL_STRING(v)) + 1;
+				break;
+			case DB_STR:
+				size += VAL_STR(v).len + 1;
+				break;
+			case DB_BLOB:
+				size += VAL_BLOB(v).len + 1;
+				break;
+			default:
+				break;
+			}
+		}
+
+	clone = shm_malloc(size);
+	if (!clone) {
+		LM_ERR("no more shm (%d)\n", size);
+		return NULL;
+	}
+
+	*clone = *res;
+	RES_ROWS(clone) = (db_row_t *)(clone + 1);
+	cv = (db_val_t *)(RES_ROWS(clone) + rows);
+	RES_NAMES(clone) = (db_key_t *)(cv + rows * cols);
+	RES_TYPES(clone) = (db_type_t *)((str *)(RES_NAMES(clone) + cols) + cols);
+	p = (char *)(RES_TYPES(clone) + cols);
+
+	for (i = 0; i < cols; i++) {
+		RES_NAMES(clone)[i] = (str *)(RES_NAMES(clone) + cols) + i;
+		RES_NAMES(clone)[i]->s = p;
+		RES_NAMES(clone)[i]->len = RES_NAMES(res)[i]->len;
+		memcpy(p, RES_NAMES(res)[i]->s, RES_NAMES(res)[i]->len);
+		p += RES_NAMES(res)[i]->len;
+
+		RES_TYPES(clone)[i] = RES_TYPES(res)[i];
+	}
+
+	for (i = 0; i < rows; i++, cv += cols) {
+		ROW_VALUES(&RES_ROWS(clone)[i]) = cv;
+		ROW_N(&RES_ROWS(clone)[i]) = cols;
+
+		for (j = 0; j < cols; j++) {
+			v = &ROW_VALUES(&RES_ROWS(res)[i])[j];
+			cv[j] = *v;
+			VAL_FREE(&cv[j]) = 0;
+			if (VAL_NULL(v))
+				continue;
+
+			switch (VAL_TYPE(v)) {
+			case DB_STRING:
+				VAL_STRING(&cv[j]) = p;
+				strcpy(p, VAL_STRING(v));
+				p += strlen(p) + 1;
+				break;
+			case DB_STR:
+				VAL_STR(&cv[j]).s = p;
+				memcpy(p, VAL_STR(v).s, VAL_STR(v).len);
+				p += VAL_STR(v).len;
+				*(p++) = '\0';
+				break;
+			case DB_BLOB:
+				VAL_BLOB(&cv[j]).s = p;
+				memcpy(p, VAL_BLOB(v).s, VAL_BLOB(v).len);
+				p += VAL_BLOB(v).len;
+				*(p++) = '\0';
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	return clone;
+}
@@ -123,4 +123,12 @@ int db_allocate_rows(db_res_t* _res, const unsigned int rows);
 int db_realloc_rows(db_res_t *_res, const unsigned int old_rows,
                     const unsigned int rows);
 
+/**
+ * Clone a result set into a single shm chunk, so it may be passed to other
+ * processes. All the string values of the clone are null-terminated.
+ * \param res the result set to be cloned
+ * \return the clone (to be released with shm_free()) or NULL on error
+ */
+db_res_t *db_res_shm_clone(db_res_t *res);
+
 #endif /* DB_RES_H */
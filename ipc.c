@@ -21,12 +21,16 @@
 
 #include <string.h>
 #include <errno.h>
+#include <time.h>
+#include <stdint.h>
 #include <sys/types.h>
-#include <sys/socket.h>
+#include <sys/eventfd.h>
 
 #include "ipc.h"
+#include "ipc_queue.h"
 #include "dprint.h"
 #include "mem/mem.h"
+#include "mem/shm_mem.h"
 
 #include <fcntl.h>
 
@@ -38,51 +42,70 @@ typedef struct _ipc_handler {
 	char name[IPC_HANDLER_NAME_MAX+1];
 } ipc_handler;
 
-typedef struct _ipc_job {
-	/* the ID (internal) of the process sending the job */
-	unsigned short snd_proc;
-	/* the job's handler type */
-	ipc_handler_type handler_type;
-	/* the payload of the job, just pointers */
-	void *payload1;
-	void *payload2;
-} ipc_job;
+typedef struct _ipc_type_stats {
+	unsigned long jobs;
+	unsigned long long latency;
+	unsigned long max_latency;
+} ipc_type_stats;
+
+/* max number of jobs handled out of the own queue for a single reactor
+ * event, so that the other fds of the process are not starved */
+#define IPC_JOBS_PER_WAKEUP  64
 
 static ipc_handler *ipc_handlers = NULL;
 static unsigned int ipc_handlers_no = 0;
 
+/* the per-process job queues */
+static ipc_queue **ipc_queues = NULL;
+
 /* shared IPC support: dispatching a job to a random OpenSIPS worker */
-static int ipc_shared_pipe[2];
+static ipc_queue *ipc_shared_queue = NULL;
+
+/* per handler type counters, for the types registered before forking */
+static ipc_type_stats *ipc_stats = NULL;
+static unsigned int ipc_stats_no = 0;
 
 /* IPC type used for RPC - a self registered type */
 static ipc_handler_type ipc_rpc_type = 0;
 
-/* FD (pipe) used for dispatching IPC jobs between all processes (1 to any) */
+/* FD (eventfd) used for dispatching IPC jobs between all processes
+ * (1 to any) */
 int ipc_shared_fd_read;
 
-int init_ipc(void)
+/* number of jobs each process may have pending */
+int ipc_queue_size = IPC_DEFAULT_QUEUE_SIZE;
+
+
+static inline unsigned long long ipc_now(void)
 {
-	int optval;
+	struct timespec ts;
 
-	/* create the pipe for dispatching the timer jobs */
-	if (pipe(ipc_shared_pipe) != 0) {
-		LM_ERR("failed to create ipc pipe (%s)!\n", strerror(errno));
-		return -1;
-	}
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
 
-	/* make reading fd non-blocking */
-	optval = fcntl(ipc_shared_pipe[0], F_GETFL);
-	if (optval == -1) {
-		LM_ERR("fcntl failed: (%d) %s\n", errno, strerror(errno));
-		return -1;
+
+int init_ipc(void)
+{
+	unsigned int size;
+
+	/* the queues are indexed by masking the positions */
+	for (size = 1; size < ipc_queue_size; size <<= 1) ;
+	if (size != ipc_queue_size) {
+		LM_DBG("rounding up the IPC queue size from %d to %u\n",
+			ipc_queue_size, size);
+		ipc_queue_size = size;
 	}
 
-	if (fcntl(ipc_shared_pipe[0], F_SETFL, optval|O_NONBLOCK) == -1) {
-		LM_ERR("set non-blocking failed: (%d) %s\n", errno, strerror(errno));
+	/* create the queue for dispatching jobs to any worker (i.e. the
+	 * timer jobs), larger as it is shared by all the workers */
+	ipc_shared_queue = ipc_new_queue(IPC_SHARED_QUEUE_FACTOR * size);
+	if (!ipc_shared_queue) {
+		LM_ERR("failed to create the shared IPC queue!\n");
 		return -1;
 	}
 
-	ipc_shared_fd_read = ipc_shared_pipe[0];
+	ipc_shared_fd_read = ipc_shared_queue->efd;
 
 	/* self-register the IPC type for RPC */
 	ipc_rpc_type = ipc_register_handler( NULL, "RPC");
@@ -100,26 +123,32 @@ int create_ipc_pipes( int proc_no )
 {
 	int optval, i;
 
-	for( i=0 ; i<proc_no ; i++ ) {
-		if (pipe(pt[i].ipc_pipe_holder)<0) {
-			LM_ERR("failed to create IPC pipe for process %d, err %d/%s\n",
-				i, errno, strerror(errno));
-			return -1;
-		}
+	ipc_queues = shm_malloc(proc_no * sizeof *ipc_queues);
+	if (!ipc_queues) {
+		LM_ERR("oom\n");
+		return -1;
+	}
 
-		/* make writing fd non-blocking */
-		optval = fcntl( pt[i].ipc_pipe_holder[1], F_GETFL);
-		if (optval == -1) {
-			LM_ERR("fcntl failed: (%d) %s\n", errno, strerror(errno));
-			return -1;
-		}
+	/* the handlers must be registered before forking, so all the types
+	 * are known by now */
+	ipc_stats_no = ipc_handlers_no;
+	ipc_stats = shm_malloc(ipc_stats_no * sizeof *ipc_stats);
+	if (!ipc_stats) {
+		LM_ERR("oom\n");
+		return -1;
+	}
+	memset(ipc_stats, 0, ipc_stats_no * sizeof *ipc_stats);
 
-		if (fcntl(pt[i].ipc_pipe_holder[1], F_SETFL, optval|O_NONBLOCK) == -1){
-			LM_ERR("set non-blocking write failed: (%d) %s\n",
-				errno, strerror(errno));
+	for( i=0 ; i<proc_no ; i++ ) {
+		ipc_queues[i] = ipc_new_queue(ipc_queue_size);
+		if (!ipc_queues[i]) {
+			LM_ERR("failed to create IPC queue for process %d\n", i);
 			return -1;
 		}
 
+		/* the same eventfd is used for both waiting and signaling */
+		pt[i].ipc_pipe_holder[0] = ipc_queues[i]->efd;
+		pt[i].ipc_pipe_holder[1] = ipc_queues[i]->efd;
 
 		if (pipe(pt[i].ipc_sync_pipe_holder)<0) {
 			LM_ERR("failed to create IPC sync pipe for process %d, "
@@ -180,63 +209,73 @@ ipc_handler_type ipc_register_handler( ipc_handler_f *hdl, char *name)
 }
 
 
-static inline int __ipc_send_job(int fd, int dst_proc, ipc_handler_type type,
-												void *payload1, void *payload2)
+static inline int __ipc_send_job(ipc_queue *q, int dst_proc,
+						ipc_handler_type type, void *payload1, void *payload2)
 {
 	ipc_job job;
-	int n;
-
-	// FIXME - we should check if the destination process really listens
-	// for read, otherwise we may end up filling in the pipe and block
 
 	job.snd_proc = (short)process_no;
 	job.handler_type = type;
 	job.payload1 = payload1;
 	job.payload2 = payload2;
+	job.stamp = ipc_now();
 
-again:
-	/* The per-proc IPC write fds are sent to non-blocking (to be sure we
-	 * do not escalate into a global blocking if a single process got stuck.
-	 * In such care the EAGAIN or EWOULDBLOCK will be thrown and we will
-	 * handle as generic error, nothing special to do.
+	/* The queues are bounded (to be sure we do not escalate into a global
+	 * blocking if a single process got stuck), so a full queue is handled
+	 * as a generic error, nothing special to do.
 	 */
-	n = write(fd, &job, sizeof(job) );
-	if (n<0) {
-		if (errno==EAGAIN || errno==EWOULDBLOCK)
-			LM_CRIT("blocking detected while sending job type %d[%s] on %d "
-				" to proc id %d/%d [%s]\n", type, ipc_handlers[type].name, fd,
-				dst_proc, (dst_proc==-1)?-1:pt[dst_proc].pid ,
-				(dst_proc==-1)?"n/a":pt[dst_proc].desc);
-		else if (errno==EINTR)
-			goto again;
-		else
-			LM_ERR("sending job type %d[%s] on %d failed: %s\n",
-				type, ipc_handlers[type].name, fd, strerror(errno));
+	if (ipc_queue_push(q, &job) < 0) {
+		LM_CRIT("blocking detected while sending job type %d[%s] on %d "
+			" to proc id %d/%d [%s]\n", type, ipc_handlers[type].name, q->efd,
+			dst_proc, (dst_proc==-1)?-1:pt[dst_proc].pid ,
+			(dst_proc==-1)?"n/a":pt[dst_proc].desc);
 		return -1;
 	}
+
+	ipc_queue_wakeup(q);
 	return 0;
 }
 
+static inline ipc_queue *ipc_proc_queue(int dst_proc, ipc_handler_type type)
+{
+	/* the process does not exist or does not accept IPC jobs */
+	if (IPC_FD_WRITE(dst_proc) < 0) {
+		LM_ERR("sending job type %d[%s] to proc id %d failed: no IPC\n",
+			type, ipc_handlers[type].name, dst_proc);
+		return NULL;
+	}
+
+	return ipc_queues[dst_proc];
+}
+
 int ipc_send_job(int dst_proc, ipc_handler_type type, void *payload)
 {
-	return __ipc_send_job(IPC_FD_WRITE(dst_proc), dst_proc,
-		type, payload, NULL);
+	ipc_queue *q = ipc_proc_queue(dst_proc, type);
+
+	if (!q)
+		return -1;
+
+	return __ipc_send_job(q, dst_proc, type, payload, NULL);
 }
 
 int ipc_dispatch_job(ipc_handler_type type, void *payload)
 {
-	return __ipc_send_job(ipc_shared_pipe[1], -1, type, payload, NULL);
+	return __ipc_send_job(ipc_shared_queue, -1, type, payload, NULL);
 }
 
 int ipc_send_rpc(int dst_proc, ipc_rpc_f *rpc, void *param)
 {
-	return __ipc_send_job(IPC_FD_WRITE(dst_proc), dst_proc,
-		ipc_rpc_type, rpc, param);
+	ipc_queue *q = ipc_proc_queue(dst_proc, ipc_rpc_type);
+
+	if (!q)
+		return -1;
+
+	return __ipc_send_job(q, dst_proc, ipc_rpc_type, rpc, param);
 }
 
 int ipc_dispatch_rpc( ipc_rpc_f *rpc, void *param)
 {
-	return __ipc_send_job(ipc_shared_pipe[1], -1, ipc_rpc_type, rpc, param);
+	return __ipc_send_job(ipc_shared_queue, -1, ipc_rpc_type, rpc, param);
 }
 
 int ipc_send_sync_reply(int dst_proc, void *param)
@@ -273,42 +312,121 @@ again:
 	return 0;
 }
 
+static inline void ipc_run_job(ipc_job *job)
+{
+	ipc_type_stats *st;
+	unsigned long lat, max;
+
+	if (job->handler_type < ipc_stats_no) {
+		st = &ipc_stats[job->handler_type];
+		lat = (unsigned long)(ipc_now() - job->stamp);
+		__sync_fetch_and_add(&st->jobs, 1);
+		__sync_fetch_and_add(&st->latency, (unsigned long long)lat);
+		while (lat > (max = st->max_latency) &&
+		!__sync_bool_compare_and_swap(&st->max_latency, max, lat)) ;
+		/* per process, for the auto-scaling */
+		pt[process_no].ipc_jobs++;
+		pt[process_no].ipc_latency += lat;
+	}
+
+	LM_DBG("received job type %d[%s] from process %d\n",
+		job->handler_type, ipc_handlers[job->handler_type].name,
+		job->snd_proc);
+
+	/* custom handling for RPC type */
+	if (job->handler_type==ipc_rpc_type) {
+		((ipc_rpc_f*)job->payload1)( job->snd_proc, job->payload2);
+	} else {
+		/* generic registered type */
+		ipc_handlers[job->handler_type].func( job->snd_proc, job->payload1);
+	}
+}
+
+static inline ipc_queue *ipc_fd_queue(int fd)
+{
+	return (fd == ipc_shared_fd_read) ? ipc_shared_queue :
+		ipc_queues[process_no];
+}
+
 void ipc_handle_job(int fd)
 {
+	ipc_queue *q = ipc_fd_queue(fd);
 	ipc_job job;
 	int n;
 
-	/* read one IPC job from the pipe; even if the read is blocking,
-	 * we are here triggered from the reactor, on a READ event, so 
-	 * we shouldn;t ever block */
-	n = read(fd, &job, sizeof(job) );
-	if (n==-1) {
-		if (errno==EAGAIN || errno==EINTR || errno==EWOULDBLOCK )
+	if (q == ipc_shared_queue) {
+		/* some other worker may have already taken the wakeup */
+		if (ipc_queue_ack(q) < 0)
 			return;
-		LM_ERR("read failed:[%d] %s\n", errno, strerror(errno));
+
+		/* take a single job, then pass the wakeup along, so the rest of
+		 * the jobs get spread over all the idle workers */
+		if (ipc_queue_pop(q, &job) < 0)
+			return;
+		if (!ipc_queue_empty(q))
+			ipc_queue_wakeup(q);
+
+		ipc_run_job(&job);
 		return;
 	}
 
-	LM_DBG("received job type %d[%s] from process %d\n",
-		job.handler_type, ipc_handlers[job.handler_type].name, job.snd_proc);
+	/* all the wakeups are coalesced into a single reactor event; we are the
+	 * only consumer of our queue, so a spurious wakeup changes nothing */
+	ipc_queue_ack(q);
 
-	/* custom handling for RPC type */
-	if (job.handler_type==ipc_rpc_type) {
-		((ipc_rpc_f*)job.payload1)( job.snd_proc, job.payload2);
-	} else {
-		/* generic registered type */
-		ipc_handlers[job.handler_type].func( job.snd_proc, job.payload1);
+	for (n = 0; n < IPC_JOBS_PER_WAKEUP; n++) {
+		if (ipc_queue_pop(q, &job) < 0)
+			return;
+		ipc_run_job(&job);
 	}
 
-	return;
+	/* give the reactor a chance to serve the other fds as well */
+	if (!ipc_queue_empty(q))
+		ipc_queue_wakeup(q);
 }
 
 
 void ipc_handle_all_pending_jobs(int fd)
 {
-	char buf;
+	ipc_queue *q = ipc_fd_queue(fd);
+	ipc_job job;
+
+	ipc_queue_ack(q);
+
+	while (ipc_queue_pop(q, &job) == 0)
+		ipc_run_job(&job);
+}
+
 
-	while ( recv(fd, &buf, 1, MSG_DONTWAIT|MSG_PEEK)==1 )
-		ipc_handle_job(fd);
+unsigned int ipc_queue_depth(int proc_no)
+{
+	ipc_queue *q;
+	unsigned long enq, deq;
+
+	if (proc_no < 0)
+		q = ipc_shared_queue;
+	else if (ipc_queues && proc_no < counted_max_processes)
+		q = ipc_queues[proc_no];
+	else
+		return 0;
+
+	deq = *(volatile unsigned long *)&q->deq_pos;
+	enq = *(volatile unsigned long *)&q->enq_pos;
+	return (enq > deq) ? (unsigned int)(enq - deq) : 0;
 }
 
+
+int ipc_get_handler_stats(ipc_handler_type type, struct ipc_handler_stats *hs)
+{
+	ipc_type_stats *st;
+
+	if (type < 0 || type >= ipc_stats_no)
+		return -1;
+
+	st = &ipc_stats[type];
+	hs->name = ipc_handlers[type].name;
+	hs->jobs = st->jobs;
+	hs->latency = st->latency;
+	hs->max_latency = st->max_latency;
+	return 0;
+}
@@ -23,11 +23,23 @@
 #define _CORE_IPC_H
 
 
+/*
+ * Each process has its own bounded, lock-free job queue in shm, which any
+ * other process may push jobs into. The consumer is woken up through an
+ * eventfd, signaled only once for a burst of jobs queued before the consumer
+ * gets to run. One more queue (IPC_SHARED_QUEUE_FACTOR times larger) holds
+ * the jobs to be dispatched to any of the SIP workers.
+ */
+
 typedef short ipc_handler_type;
 extern int ipc_shared_fd_read;
+extern int ipc_queue_size;
 #define IPC_TYPE_NONE (-1)
 #define ipc_bad_handler_type(htype) ((htype) < 0)
 
+#define IPC_DEFAULT_QUEUE_SIZE   1024
+#define IPC_SHARED_QUEUE_FACTOR  4
+
 #define IPC_FD_READ(_proc_no)   pt[_proc_no].ipc_pipe[0]
 #define IPC_FD_WRITE(_proc_no)  pt[_proc_no].ipc_pipe[1]
 #define IPC_FD_READ_SELF        IPC_FD_READ(process_no)
@@ -115,11 +127,34 @@ void ipc_handle_job(int fd);
 
 
 /*
- * reads and execute all the jobs available on the pipe, without blocking
+ * reads and execute all the jobs available on the queue, without blocking
  */
 void ipc_handle_all_pending_jobs(int fd);
 
 
+struct ipc_handler_stats {
+	const char *name;
+	/* number of jobs handled so far */
+	unsigned long jobs;
+	/* total and max time spent by the jobs in the queue, in usec */
+	unsigned long long latency;
+	unsigned long max_latency;
+};
+
+/*
+ * Number of jobs currently pending for process "proc_no" (or in the shared
+ * queue, for a negative "proc_no")
+ */
+unsigned int ipc_queue_depth(int proc_no);
+
+/*
+ * Fetch the counters of a handler type (all the processes)
+ *
+ * Return: 0 on success, -1 for an unknown type
+ */
+int ipc_get_handler_stats(ipc_handler_type type, struct ipc_handler_stats *hs);
+
+
 /* internal functions */
 int init_ipc(void);
 
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * The IPC job queues - internal to ipc.c, only exposed for the unit tests
+ */
+
+#ifndef _CORE_IPC_QUEUE_H
+#define _CORE_IPC_QUEUE_H
+
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "ipc.h"
+#include "dprint.h"
+#include "mem/shm_mem.h"
+
+typedef struct _ipc_job {
+	/* the ID (internal) of the process sending the job */
+	unsigned short snd_proc;
+	/* the job's handler type */
+	ipc_handler_type handler_type;
+	/* the payload of the job, just pointers */
+	void *payload1;
+	void *payload2;
+	/* when the job was queued (monotonic time, in usec) */
+	unsigned long long stamp;
+} ipc_job;
+
+/* a slot of a job queue - "seq" tells if the slot is free for the
+ * producer at position "seq" or holds a job for the consumer at
+ * position "seq-1" */
+typedef struct _ipc_cell {
+	unsigned long seq;
+	ipc_job job;
+} ipc_cell;
+
+#define IPC_CACHE_LINE  64
+
+/* bounded multi-producer / multi-consumer job queue (D. Vyukov), in shm;
+ * the producers and the consumers only compete on the position counters,
+ * which are kept on different cache lines */
+typedef struct _ipc_queue {
+	unsigned long enq_pos;
+	char _pad1[IPC_CACHE_LINE - sizeof(unsigned long)];
+	unsigned long deq_pos;
+	char _pad2[IPC_CACHE_LINE - sizeof(unsigned long)];
+	/* set while a wakeup is pending on the eventfd, so only the first
+	 * of several jobs queued in a row has to write into it */
+	int signaled;
+	/* eventfd waking up the consumer(s) */
+	int efd;
+	unsigned long mask;
+	ipc_cell cells[0];
+} ipc_queue;
+
+static inline ipc_queue *ipc_new_queue(unsigned int size)
+{
+	ipc_queue *q;
+	unsigned int i;
+
+	q = shm_malloc(sizeof *q + size * sizeof(ipc_cell));
+	if (!q) {
+		LM_ERR("oom (queue size %u)\n", size);
+		return NULL;
+	}
+	memset(q, 0, sizeof *q);
+
+	q->efd = eventfd(0, EFD_NONBLOCK);
+	if (q->efd < 0) {
+		LM_ERR("failed to create eventfd: (%d) %s\n", errno, strerror(errno));
+		shm_free(q);
+		return NULL;
+	}
+
+	q->mask = size - 1;
+	for (i = 0; i < size; i++)
+		q->cells[i].seq = i;
+
+	return q;
+}
+
+
+static inline int ipc_queue_push(ipc_queue *q, const ipc_job *job)
+{
+	ipc_cell *cell;
+	unsigned long pos, seq;
+	long diff;
+
+	pos = *(volatile unsigned long *)&q->enq_pos;
+	for (;;) {
+		cell = &q->cells[pos & q->mask];
+		seq = *(volatile unsigned long *)&cell->seq;
+		__sync_synchronize();
+		diff = (long)seq - (long)pos;
+		if (diff == 0) {
+			if (__sync_bool_compare_and_swap(&q->enq_pos, pos, pos + 1))
+				break;
+		} else if (diff < 0) {
+			/* full */
+			return -1;
+		}
+		pos = *(volatile unsigned long *)&q->enq_pos;
+	}
+
+	cell->job = *job;
+	__sync_synchronize();
+	cell->seq = pos + 1;
+	return 0;
+}
+
+
+static inline int ipc_queue_pop(ipc_queue *q, ipc_job *job)
+{
+	ipc_cell *cell;
+	unsigned long pos, seq;
+	long diff;
+
+	pos = *(volatile unsigned long *)&q->deq_pos;
+	for (;;) {
+		cell = &q->cells[pos & q->mask];
+		seq = *(volatile unsigned long *)&cell->seq;
+		__sync_synchronize();
+		diff = (long)seq - (long)(pos + 1);
+		if (diff == 0) {
+			if (__sync_bool_compare_and_swap(&q->deq_pos, pos, pos + 1))
+				break;
+		} else if (diff < 0) {
+			/* empty */
+			return -1;
+		}
+		pos = *(volatile unsigned long *)&q->deq_pos;
+	}
+
+	*job = cell->job;
+	__sync_synchronize();
+	cell->seq = pos + q->mask + 1;
+	return 0;
+}
+
+
+static inline int ipc_queue_empty(ipc_queue *q)
+{
+	return *(volatile unsigned long *)&q->enq_pos ==
+		*(volatile unsigned long *)&q->deq_pos;
+}
+
+
+static inline void ipc_queue_wakeup(ipc_queue *q)
+{
+	uint64_t one = 1;
+
+	/* a wakeup is already pending, the consumer will see our job too */
+	if (__sync_lock_test_and_set(&q->signaled, 1))
+		return;
+
+	while (write(q->efd, &one, sizeof one) < 0) {
+		if (errno == EINTR)
+			continue;
+		LM_ERR("failed to signal IPC queue on %d: %s\n", q->efd,
+			strerror(errno));
+		break;
+	}
+}
+
+
+/* consume the pending wakeup; any job queued from now on signals again */
+static inline int ipc_queue_ack(ipc_queue *q)
+{
+	uint64_t cnt;
+	int n;
+
+	do {
+		n = read(q->efd, &cnt, sizeof cnt);
+	} while (n < 0 && errno == EINTR);
+
+	if (n < 0) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK)
+			LM_ERR("read failed:[%d] %s\n", errno, strerror(errno));
+		return -1;
+	}
+
+	q->signaled = 0;
+	__sync_synchronize();
+	return 0;
+}
+
+#endif /* _CORE_IPC_QUEUE_H */
@@ -0,0 +1,395 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../dprint.h"
+#include "../mem/mem.h"
+#include "../crc.h"
+#include "snapshot.h"
+
+#define SNAP_BYTE_ORDER 0x01020304
+
+struct snap_header {
+	char magic[SNAP_MAGIC_LEN];
+	uint32_t version;
+	uint32_t byte_order;
+	uint64_t created;
+	uint64_t index_offset;
+	uint32_t n_blocks;
+	uint32_t index_crc;
+	uint32_t flags;
+	uint32_t hdr_crc;       /* over all the above fields */
+};
+
+static inline uint32_t snap_crc(const void *data, uint64_t len)
+{
+	unsigned int crc;
+	str s;
+
+	s.s = (char *)data;
+	s.len = (int)len;
+	crc32_uint(&s, &crc);
+	return crc;
+}
+
+static int snap_write_all(int fd, const void *data, size_t len)
+{
+	const char *p = data;
+	ssize_t n;
+
+	while (len) {
+		n = write(fd, p, len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		p += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+int snap_open_write(struct snap_writer *w, const char *path,
+		const char *magic, unsigned int version)
+{
+	struct snap_header hdr;
+	int len = strlen(path);
+
+	memset(w, 0, sizeof *w);
+	w->fd = -1;
+
+	w->path = pkg_malloc(2 * len + 4 + 2);
+	if (!w->path) {
+		LM_ERR("oom\n");
+		return -1;
+	}
+	memcpy(w->path, path, len + 1);
+	w->tmp_path = w->path + len + 1;
+	memcpy(w->tmp_path, path, len);
+	memcpy(w->tmp_path + len, ".tmp", 5);
+
+	w->fd = open(w->tmp_path, O_WRONLY|O_CREAT|O_TRUNC, 0600);
+	if (w->fd < 0) {
+		LM_ERR("failed to create %s: %s\n", w->tmp_path, strerror(errno));
+		goto error;
+	}
+
+	memcpy(w->magic, magic, SNAP_MAGIC_LEN);
+	w->version = version;
+	w->created = time(NULL);
+
+	/* the real header is written on commit, once the index is known */
+	memset(&hdr, 0, sizeof hdr);
+	if (snap_write_all(w->fd, &hdr, sizeof hdr) < 0) {
+		LM_ERR("failed to write %s: %s\n", w->tmp_path, strerror(errno));
+		goto error;
+	}
+	w->offset = sizeof hdr;
+
+	return 0;
+
+error:
+	snap_abort(w);
+	return -1;
+}
+
+int snap_put(struct snap_writer *w, const void *data, unsigned int len)
+{
+	unsigned int size;
+	char *buf;
+
+	if (w->buf_len + len > w->buf_size) {
+		for (size = w->buf_size ? w->buf_size : 4096;
+				size < w->buf_len + len; size <<= 1) ;
+
+		buf = pkg_realloc(w->buf, size);
+		if (!buf) {
+			LM_ERR("oom (%u bytes)\n", size);
+			w->error = 1;
+			return -1;
+		}
+
+		w->buf = buf;
+		w->buf_size = size;
+	}
+
+	memcpy(w->buf + w->buf_len, data, len);
+	w->buf_len += len;
+	return 0;
+}
+
+int snap_put_str(struct snap_writer *w, const str *s)
+{
+	uint32_t len = (s && s->s) ? s->len : 0;
+	char nt = '\0';
+
+	/* the strings are null-terminated, so they may be used in place */
+	if (snap_put_val(w, len) < 0 || (len && snap_put(w, s->s, len) < 0) ||
+			snap_put(w, &nt, 1) < 0)
+		return -1;
+
+	return 0;
+}
+
+int snap_end_block(struct snap_writer *w)
+{
+	struct snap_block *blocks;
+
+	if (w->error)
+		return -1;
+
+	if (w->n_blocks == w->max_blocks) {
+		w->max_blocks = w->max_blocks ? 2 * w->max_blocks : 256;
+		blocks = pkg_realloc(w->blocks, w->max_blocks * sizeof *blocks);
+		if (!blocks) {
+			LM_ERR("oom\n");
+			w->error = 1;
+			return -1;
+		}
+		w->blocks = blocks;
+	}
+
+	w->blocks[w->n_blocks].offset = w->offset;
+	w->blocks[w->n_blocks].len = w->buf_len;
+	w->blocks[w->n_blocks].crc = snap_crc(w->buf, w->buf_len);
+
+	if (w->buf_len && snap_write_all(w->fd, w->buf, w->buf_len) < 0) {
+		LM_ERR("failed to write %s: %s\n", w->tmp_path, strerror(errno));
+		w->error = 1;
+		return -1;
+	}
+
+	w->offset += w->buf_len;
+	w->n_blocks++;
+	w->buf_len = 0;
+
+	return 0;
+}
+
+int snap_commit(struct snap_writer *w, unsigned int flags)
+{
+	struct snap_header hdr;
+	uint64_t index_len = (uint64_t)w->n_blocks * sizeof *w->blocks;
+
+	if (w->error)
+		return -1;
+
+	if (index_len &&
+			snap_write_all(w->fd, w->blocks, index_len) < 0) {
+		LM_ERR("failed to write %s: %s\n", w->tmp_path, strerror(errno));
+		return -1;
+	}
+
+	memset(&hdr, 0, sizeof hdr);
+	memcpy(hdr.magic, w->magic, SNAP_MAGIC_LEN);
+	hdr.version = w->version;
+	hdr.byte_order = SNAP_BYTE_ORDER;
+	hdr.created = (uint64_t)w->created;
+	hdr.index_offset = w->offset;
+	hdr.n_blocks = w->n_blocks;
+	hdr.index_crc = snap_crc(w->blocks, index_len);
+	hdr.flags = flags;
+	hdr.hdr_crc = snap_crc(&hdr, offsetof(struct snap_header, hdr_crc));
+
+	if (pwrite(w->fd, &hdr, sizeof hdr, 0) != sizeof hdr) {
+		LM_ERR("failed to write %s: %s\n", w->tmp_path, strerror(errno));
+		return -1;
+	}
+
+	if (fsync(w->fd) < 0) {
+		LM_ERR("failed to sync %s: %s\n", w->tmp_path, strerror(errno));
+		return -1;
+	}
+
+	close(w->fd);
+	w->fd = -1;
+
+	if (rename(w->tmp_path, w->path) < 0) {
+		LM_ERR("failed to rename %s: %s\n", w->tmp_path, strerror(errno));
+		return -1;
+	}
+
+	LM_DBG("wrote %s: %u blocks, %llu bytes\n", w->path, w->n_blocks,
+		(unsigned long long)(w->offset + index_len));
+
+	/* nothing left to remove */
+	w->tmp_path[0] = '\0';
+	snap_abort(w);
+	return 0;
+}
+
+void snap_abort(struct snap_writer *w)
+{
+	if (w->fd >= 0) {
+		close(w->fd);
+		w->fd = -1;
+	}
+
+	if (w->path) {
+		if (w->tmp_path[0])
+			unlink(w->tmp_path);
+		pkg_free(w->path);
+		w->path = w->tmp_path = NULL;
+	}
+
+	if (w->buf) {
+		pkg_free(w->buf);
+		w->buf = NULL;
+	}
+
+	if (w->blocks) {
+		pkg_free(w->blocks);
+		w->blocks = NULL;
+	}
+}
+
+int snap_open_read(struct snap_reader *r, const char *path,
+		const char *magic, unsigned int version)
+{
+	struct snap_header hdr;
+	struct stat st;
+	uint64_t index_len;
+	int fd;
+
+	memset(r, 0, sizeof *r);
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		if (errno == ENOENT) {
+			LM_DBG("no %s snapshot\n", path);
+			return 1;
+		}
+		LM_ERR("failed to open %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	if (fstat(fd, &st) < 0) {
+		LM_ERR("failed to stat %s: %s\n", path, strerror(errno));
+		goto error;
+	}
+
+	if (st.st_size < sizeof hdr) {
+		LM_ERR("truncated snapshot %s\n", path);
+		goto error;
+	}
+
+	r->size = st.st_size;
+	r->map = mmap(NULL, r->size, PROT_READ, MAP_SHARED, fd, 0);
+	if (r->map == MAP_FAILED) {
+		LM_ERR("failed to map %s: %s\n", path, strerror(errno));
+		r->map = NULL;
+		goto error;
+	}
+	close(fd);
+	fd = -1;
+
+	memcpy(&hdr, r->map, sizeof hdr);
+
+	if (memcmp(hdr.magic, magic, SNAP_MAGIC_LEN) ||
+			hdr.byte_order != SNAP_BYTE_ORDER) {
+		LM_ERR("%s is not a valid snapshot\n", path);
+		goto error;
+	}
+
+	if (hdr.version != version) {
+		LM_ERR("%s has an unsupported version (%u, expected %u)\n", path,
+			hdr.version, version);
+		goto error;
+	}
+
+	if (hdr.hdr_crc != snap_crc(&hdr, offsetof(struct snap_header, hdr_crc))) {
+		LM_ERR("corrupted snapshot header in %s\n", path);
+		goto error;
+	}
+
+	index_len = (uint64_t)hdr.n_blocks * sizeof *r->blocks;
+	if (hdr.index_offset < sizeof hdr || hdr.index_offset > r->size ||
+			index_len > r->size - hdr.index_offset) {
+		LM_ERR("truncated snapshot %s\n", path);
+		goto error;
+	}
+
+	r->blocks = (struct snap_block *)(r->map + hdr.index_offset);
+	if (hdr.index_crc != snap_crc(r->blocks, index_len)) {
+		LM_ERR("corrupted snapshot index in %s\n", path);
+		goto error;
+	}
+
+	r->n_blocks = hdr.n_blocks;
+	r->flags = hdr.flags;
+	r->created = (time_t)hdr.created;
+
+	/* the blocks are decoded in order */
+	madvise(r->map, r->size, MADV_SEQUENTIAL);
+
+	return 0;
+
+error:
+	if (fd >= 0)
+		close(fd);
+	snap_close(r);
+	return -1;
+}
+
+int snap_open_block(struct snap_reader *r, unsigned int idx,
+		struct snap_cursor *c)
+{
+	struct snap_block b;
+
+	if (idx >= r->n_blocks)
+		return -1;
+
+	/* the index is not necessarily aligned */
+	memcpy(&b, r->blocks + idx, sizeof b);
+
+	if (b.offset > r->size || b.len > r->size - b.offset) {
+		LM_ERR("block %u is out of the snapshot\n", idx);
+		return -1;
+	}
+
+	if (b.crc != snap_crc(r->map + b.offset, b.len)) {
+		LM_ERR("block %u of the snapshot is corrupted\n", idx);
+		return -1;
+	}
+
+	c->p = r->map + b.offset;
+	c->end = c->p + b.len;
+	return 0;
+}
+
+void snap_close(struct snap_reader *r)
+{
+	if (r->map) {
+		munmap(r->map, r->size);
+		r->map = NULL;
+	}
+
+	r->blocks = NULL;
+	r->n_blocks = 0;
+}
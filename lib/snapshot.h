@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Binary snapshot files, for quickly restoring in-memory state on restart
+ *
+ * A snapshot is a sequence of opaque blocks (i.e. the records of a hash
+ * table slot), each with its own CRC32, followed by an index of all the
+ * blocks and preceded by a fixed header holding the format magic/version,
+ * the creation time and the location of the index:
+ *
+ *   | header | block 0 | block 1 | ... | block N-1 | index |
+ *
+ * The file is written under a temporary name, then renamed over the
+ * previous snapshot, so readers only ever see complete snapshots. It is
+ * read through mmap(), so the blocks may be decoded by several processes
+ * in parallel, each of them mapping the same (page cache) pages.
+ *
+ * The values are stored in host byte order - a snapshot is only meant to
+ * be loaded by the same host.
+ */
+
+#ifndef __LIB_SNAPSHOT__
+#define __LIB_SNAPSHOT__
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "../str.h"
+
+#define SNAP_MAGIC_LEN 8
+
+/* the snapshot was written on shutdown, after all the data was flushed */
+#define SNAP_FL_FINAL (1<<0)
+
+struct snap_block {
+	uint64_t offset;
+	uint32_t len;
+	uint32_t crc;
+};
+
+struct snap_writer {
+	int fd;
+	char *path;
+	char *tmp_path;
+
+	/* the block in progress */
+	char *buf;
+	unsigned int buf_len;
+	unsigned int buf_size;
+
+	struct snap_block *blocks;
+	unsigned int n_blocks;
+	unsigned int max_blocks;
+	uint64_t offset;
+
+	char magic[SNAP_MAGIC_LEN];
+	unsigned int version;
+	time_t created;
+	int error;
+};
+
+struct snap_reader {
+	char *map;
+	size_t size;
+	struct snap_block *blocks;
+	unsigned int n_blocks;
+	unsigned int flags;
+	time_t created;
+};
+
+struct snap_cursor {
+	char *p;
+	char *end;
+};
+
+/*
+ * Start writing a new snapshot of @path (the previous one stays in place
+ * until snap_commit()). All the data is kept in pkg memory until written.
+ */
+int snap_open_write(struct snap_writer *w, const char *path,
+		const char *magic, unsigned int version);
+
+/* append data to the current block */
+int snap_put(struct snap_writer *w, const void *data, unsigned int len);
+int snap_put_str(struct snap_writer *w, const str *s);
+
+#define snap_put_val(_w, _v) snap_put(_w, &(_v), sizeof(_v))
+
+/* write the current block (possibly empty) to the file */
+int snap_end_block(struct snap_writer *w);
+
+/* write the index and the header, then replace the previous snapshot */
+int snap_commit(struct snap_writer *w, unsigned int flags);
+
+/* drop the snapshot in progress (also needed after a failed commit) */
+void snap_abort(struct snap_writer *w);
+
+/*
+ * Map the @path snapshot and validate its header and index
+ *
+ * Returns 0 on success, 1 if there is no snapshot and -1 if the snapshot is
+ * unusable (bad magic/version, corrupted or truncated).
+ */
+int snap_open_read(struct snap_reader *r, const char *path,
+		const char *magic, unsigned int version);
+
+/* validate the CRC of block @idx and point the cursor to its data */
+int snap_open_block(struct snap_reader *r, unsigned int idx,
+		struct snap_cursor *c);
+
+void snap_close(struct snap_reader *r);
+
+/* helpers for decoding the block data; they return -1 on truncated data */
+static inline int snap_get(struct snap_cursor *c, void *data, unsigned int len)
+{
+	if (c->end - c->p < len)
+		return -1;
+
+	memcpy(data, c->p, len);
+	c->p += len;
+	return 0;
+}
+
+#define snap_get_val(_c, _v) snap_get(_c, &(_v), sizeof(_v))
+
+/* the returned string points inside the mapping and is null-terminated */
+static inline int snap_get_str(struct snap_cursor *c, str *s)
+{
+	uint32_t len;
+
+	if (snap_get_val(c, len) < 0 || c->end - c->p < (long)len + 1 ||
+			c->p[len] != '\0')
+		return -1;
+
+	s->s = len ? c->p : NULL;
+	s->len = len;
+	c->p += len + 1;
+	return 0;
+}
+
+static inline int snap_cursor_end(struct snap_cursor *c)
+{
+	return c->p >= c->end;
+}
+
+#endif /* __LIB_SNAPSHOT__ */
@@ -142,6 +142,7 @@
 #include "version.h"
 #include "mi/mi_core.h"
 #include "db/db_insertq.h"
+#include "db/db_async_exec.h"
 #include "cachedb/cachedb.h"
 #include "net/trans.h"
 
@@ -203,6 +204,17 @@ static int main_loop(void)
 
 	chd_rank=0;
 
+	/* fork the SQL writers first, so all the others know about them */
+	if (ql_start_writer_processes()!=0) {
+		LM_ERR("failed to fork SQL writer processes\n");
+		goto error;
+	}
+
+	if (db_async_exec_start_processes()!=0) {
+		LM_ERR("failed to fork DB executor processes\n");
+		goto error;
+	}
+
 	if (start_module_procs()!=0) {
 		LM_ERR("failed to fork module processes\n");
 		goto error;
@@ -47,6 +47,7 @@
 #include "../cachedb/cachedb.h"
 #include "../evi/event_interface.h"
 #include "../ipc.h"
+#include "../pt_scaling.h"
 #include "../xlog.h"
 #include "../cfg_reload.h"
 #include "mi.h"
@@ -320,6 +321,79 @@ error:
 }
 
 
+static mi_response_t *mi_ipc_stats(const mi_params_t *params,
+						struct mi_handler *async_hdl)
+{
+	mi_response_t *resp;
+	mi_item_t *resp_obj;
+	mi_item_t *arr, *item;
+	struct ipc_handler_stats hs;
+	int i;
+
+	resp = init_mi_result_object(&resp_obj);
+	if (!resp)
+		return 0;
+
+	if (add_mi_number(resp_obj, MI_SSTR("Shared queue"),
+	ipc_queue_depth(-1)) < 0)
+		goto error;
+
+	arr = add_mi_array(resp_obj, MI_SSTR("Queues"));
+	if (!arr)
+		goto error;
+
+	for ( i=0 ; i<counted_max_processes ; i++ ) {
+		if (!is_process_running(i) || IPC_FD_WRITE(i)<=0)
+			continue;
+		item = add_mi_object(arr, 0, 0);
+		if (!item)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("ID"), i) < 0)
+			goto error;
+
+		if (add_mi_string(item, MI_SSTR("Type"),
+			pt[i].desc, strlen(pt[i].desc)) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Depth"), ipc_queue_depth(i)) < 0)
+			goto error;
+	}
+
+	arr = add_mi_array(resp_obj, MI_SSTR("Handlers"));
+	if (!arr)
+		goto error;
+
+	for ( i=0 ; ipc_get_handler_stats(i, &hs)==0 ; i++ ) {
+		item = add_mi_object(arr, 0, 0);
+		if (!item)
+			goto error;
+
+		if (add_mi_string(item, MI_SSTR("Name"),
+			(char *)hs.name, strlen(hs.name)) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Jobs"), hs.jobs) < 0)
+			goto error;
+
+		/* latencies in usec */
+		if (add_mi_number(item, MI_SSTR("Avg latency"),
+		hs.jobs ? hs.latency / hs.jobs : 0) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Max latency"), hs.max_latency) < 0)
+			goto error;
+	}
+
+	return resp;
+
+error:
+	LM_ERR("failed to add mi item\n");
+	free_mi_response(resp);
+	return 0;
+}
+
+
 static mi_response_t *mi_kill(const mi_params_t *params,
 							struct mi_handler *async_hdl)
 {
@@ -797,6 +871,19 @@ static mi_export_t mi_core_cmds[] = {
 		{EMPTY_MI_RECIPE}
 		}
 	},
+	{ "auto_scaling", "lists the auto-scaling groups of processes, with "
+		"their last sampled load and queues and the last scaling decision",
+		0, 0, {
+		{mi_auto_scaling, {0}},
+		{EMPTY_MI_RECIPE}
+		}
+	},
+	{ "ipc_stats", "lists the pending IPC jobs per process and the IPC "
+		"job latencies per handler type", 0, 0, {
+		{mi_ipc_stats, {0}},
+		{EMPTY_MI_RECIPE}
+		}
+	},
 	{ "kill", "terminates OpenSIPS", 0, 0, {
 		{mi_kill, {0}},
 		{EMPTY_MI_RECIPE}
@@ -56,6 +56,7 @@
 #include "acc_extra.h"
 #include "acc_logic.h"
 #include "acc_vars.h"
+#include "acc_file.h"
 
 #define TABLE_VERSION 7
 
@@ -76,6 +77,7 @@ extern struct acc_extra *log_extra_tags;
 extern struct acc_extra *db_extra_tags;
 extern struct acc_extra *aaa_extra_tags;
 extern struct acc_extra *evi_extra_tags;
+extern struct acc_extra *file_extra_tags;
 
 extern tag_t* extra_tags;
 extern int extra_tgs_len;
@@ -84,6 +86,7 @@ extern struct acc_extra *log_leg_tags;
 extern struct acc_extra *db_leg_tags;
 extern struct acc_extra *aaa_leg_tags;
 extern struct acc_extra *evi_leg_tags;
+extern struct acc_extra *file_leg_tags;
 
 extern tag_t* leg_tags;
 extern int leg_tgs_len;
@@ -1423,6 +1426,116 @@ end:
 	return res;
 }
 
+/********************************************
+ *        BINARY FILE ACCOUNTING
+ ********************************************/
+
+/* builds a record out of the first @n values of val_arr and of the leg
+ * values; if present, @ctx must be locked */
+static int acc_file_push(int type, uint64_t ms_time, unsigned int created,
+		unsigned int setuptime, unsigned int ms_duration, int n,
+		acc_ctx_t *ctx)
+{
+	struct acc_file_rec *rec;
+	struct acc_extra *extra;
+	unsigned int len;
+	int i, legs;
+	char *p;
+
+	legs = (ctx && ctx->leg_values) ? ctx->legs_no : 0;
+
+	len = ACC_FILE_REC_HDR_LEN;
+	for (i = 0; i < n; i++)
+		len += acc_file_val_len(&val_arr[i]);
+	for (i = 0; i < legs; i++)
+		for (extra = file_leg_tags; extra; extra = extra->next)
+			len += acc_file_val_len(&LEG_VALUE(i, extra, ctx));
+
+	rec = acc_file_rec_new(len);
+	if (!rec)
+		return -1;
+
+	p = acc_file_put_u8(rec->buf + 4, type);
+	p = acc_file_put_u64(p, ms_time);
+	p = acc_file_put_u32(p, created);
+	p = acc_file_put_u32(p, setuptime);
+	p = acc_file_put_u32(p, ms_duration);
+	p = acc_file_put_u16(p, legs);
+
+	for (i = 0; i < n; i++)
+		p = acc_file_put_val(p, &val_arr[i]);
+	for (i = 0; i < legs; i++)
+		for (extra = file_leg_tags; extra; extra = extra->next)
+			p = acc_file_put_val(p, &LEG_VALUE(i, extra, ctx));
+
+	return acc_file_send(rec);
+}
+
+int acc_file_request(struct sip_msg *rq, struct sip_msg *rpl, int missed)
+{
+	struct acc_extra *extra;
+	unsigned int created = 0, setuptime = 0;
+	acc_ctx_t *ctx = try_fetch_ctx();
+	int m, ret;
+
+	m = core2strar(rq, val_arr);
+
+	if (ctx) {
+		created = ctx->created;
+		setuptime = time(NULL) - created;
+
+		accX_lock(&ctx->lock);
+		for (extra = file_extra_tags; extra; extra = extra->next, m++)
+			val_arr[m] = ctx->extra_values[extra->tag_idx].value;
+	} else {
+		/* all the records have the same fields */
+		for (extra = file_extra_tags; extra; extra = extra->next, m++) {
+			val_arr[m].s = 0;
+			val_arr[m].len = 0;
+		}
+	}
+
+	ret = acc_file_push(missed ? ACC_FILE_REC_MISSED : ACC_FILE_REC_REQUEST,
+		(uint64_t)acc_env.ts.tv_sec * 1000 + acc_env.ts.tv_usec / 1000,
+		created, setuptime, 0, m, ctx);
+
+	if (ctx)
+		accX_unlock(&ctx->lock);
+
+	return ret < 0 ? -1 : 1;
+}
+
+int acc_file_cdrs(struct dlg_cell *dlg, struct sip_msg *msg, acc_ctx_t *ctx)
+{
+	struct acc_extra *extra;
+	struct timeval start_time;
+	str core_s;
+	int m, ret;
+
+	core_s.s = 0;
+
+	m = prebuild_core_arr(dlg, &core_s, &start_time);
+	if (m < 0) {
+		LM_ERR("cannot copy core arguments\n");
+		return -1;
+	}
+
+	accX_lock(&ctx->lock);
+	for (extra = file_extra_tags; extra; extra = extra->next, m++)
+		val_arr[m] = ctx->extra_values[extra->tag_idx].value;
+
+	ret = acc_file_push(ACC_FILE_REC_CDR,
+		(uint64_t)start_time.tv_sec * 1000 + start_time.tv_usec / 1000,
+		ctx->created, start_time.tv_sec - ctx->created,
+		TIMEVAL_MS_DIFF(start_time, ctx->bye_time), m, ctx);
+	accX_unlock(&ctx->lock);
+
+	if (core_s.s)
+		pkg_free(core_s.s);
+
+	return ret < 0 ? -1 : 1;
+}
+
 /* Functions used to store values into dlg */
 
 static str cdr_buf;
@@ -104,6 +104,8 @@ struct dlg_cell *create_acc_dlg(struct sip_msg* req);
 int  init_acc_evi(void);
 int  acc_evi_request( struct sip_msg *req, struct sip_msg *rpl, int missed_flag);
 int  acc_evi_cdrs(struct dlg_cell *dlg, struct sip_msg *msg, acc_ctx_t* ctx);
+int  acc_file_request( struct sip_msg *req, struct sip_msg *rpl, int missed);
+int  acc_file_cdrs(struct dlg_cell *dlg, struct sip_msg *msg, acc_ctx_t* ctx);
 extern event_id_t acc_cdr_event;
 extern event_id_t acc_event;
 extern event_id_t acc_missed_event;
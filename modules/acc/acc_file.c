@@ -0,0 +1,597 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../dprint.h"
+#include "../../mem/mem.h"
+#include "../../mem/shm_mem.h"
+#include "../../ipc.h"
+#include "../../locking.h"
+#include "../../pt.h"
+#include "../../statistics.h"
+#include "../../timer.h"
+#include "../../reactor_proc.h"
+
+#include "acc_extra.h"
+#include "acc_file.h"
+
+/* the records are buffered and written when no other record is pending,
+ * or when the buffer fills up */
+#define ACC_FILE_BUF_SIZE (64*1024)
+
+char *acc_file_dir = NULL;
+char *acc_file_prefix = "acc";
+int acc_file_rotate_size = 64*1024*1024;
+int acc_file_rotate_interval = 3600;
+int acc_file_backlog = 1024;
+
+stat_var *acc_file_dropped;
+
+extern struct acc_extra *file_extra_tags;
+extern struct acc_extra *file_leg_tags;
+
+/* process_no of the writer */
+static int *acc_file_proc;
+
+/* the names of the fields and of the leg fields, as written in the
+ * header of each file */
+static str acc_file_names;
+static unsigned short acc_file_fields;
+static unsigned short acc_file_leg_fields;
+
+static const str acc_file_core_names[] = {
+	str_init("method"),
+	str_init("from_tag"),
+	str_init("to_tag"),
+	str_init("callid"),
+	str_init("sip_code"),
+	str_init("sip_reason"),
+};
+
+/* the current file and the buffered records are kept in shm, so that
+ * they can still be written out on shutdown, once the writer is gone.
+ * The records which cannot be written right away (writer not up yet, IPC
+ * or I/O failures) wait in the backlog, up to acc_file_backlog of them */
+struct acc_file_state {
+	int open;
+	int path_len;
+	char path[PATH_MAX];
+	int buf_len;
+	char buf[ACC_FILE_BUF_SIZE];
+	gen_lock_t lock;
+	unsigned int bl_len;
+	struct acc_file_rec *bl_head;
+	struct acc_file_rec *bl_tail;
+};
+
+static struct acc_file_state *acc_st;
+
+/* writer process state */
+static int acc_fd = -1;
+static time_t acc_opened;
+static unsigned long acc_written;
+static unsigned int acc_seq;
+
+
+static int acc_file_build_names(void)
+{
+	struct acc_extra *extra;
+	unsigned int i, len;
+	char *p;
+
+	len = 0;
+	for (i = 0; i < sizeof acc_file_core_names / sizeof *acc_file_core_names;
+			i++)
+		len += acc_file_val_len(&acc_file_core_names[i]);
+	for (extra = file_extra_tags; extra; extra = extra->next)
+		len += acc_file_val_len(&extra->name);
+	for (extra = file_leg_tags; extra; extra = extra->next)
+		len += acc_file_val_len(&extra->name);
+
+	acc_file_names.s = pkg_malloc(len);
+	if (!acc_file_names.s) {
+		LM_ERR("no more pkg memory\n");
+		return -1;
+	}
+	acc_file_names.len = len;
+
+	p = acc_file_names.s;
+	for (i = 0; i < sizeof acc_file_core_names / sizeof *acc_file_core_names;
+			i++, acc_file_fields++)
+		p = acc_file_put_val(p, &acc_file_core_names[i]);
+	for (extra = file_extra_tags; extra; extra = extra->next, acc_file_fields++)
+		p = acc_file_put_val(p, &extra->name);
+	for (extra = file_leg_tags; extra; extra = extra->next,
+			acc_file_leg_fields++)
+		p = acc_file_put_val(p, &extra->name);
+
+	return 0;
+}
+
+/* the files left behind by a previous run are complete, up to the last
+ * record which may be truncated, so just make them available */
+static void acc_file_recover(void)
+{
+	char from[PATH_MAX], to[PATH_MAX];
+	struct dirent *de;
+	DIR *dir;
+	int plen = strlen(acc_file_prefix), len;
+	int slen = sizeof(ACC_FILE_SUFFIX ACC_FILE_PART_SUFFIX) - 1;
+
+	dir = opendir(acc_file_dir);
+	if (!dir) {
+		LM_ERR("failed to open %s: %s\n", acc_file_dir, strerror(errno));
+		return;
+	}
+
+	while ((de = readdir(dir))) {
+		len = strlen(de->d_name);
+		if (len <= plen + slen || strncmp(de->d_name, acc_file_prefix, plen) ||
+				strcmp(de->d_name + len - slen,
+					ACC_FILE_SUFFIX ACC_FILE_PART_SUFFIX))
+			continue;
+
+		snprintf(from, sizeof from, "%s/%s", acc_file_dir, de->d_name);
+		snprintf(to, sizeof to, "%s/%.*s", acc_file_dir,
+			len - (int)(sizeof(ACC_FILE_PART_SUFFIX) - 1), de->d_name);
+		if (rename(from, to) < 0)
+			LM_ERR("failed to rename %s: %s\n", from, strerror(errno));
+		else
+			LM_INFO("recovered accounting file %s\n", to);
+	}
+
+	closedir(dir);
+}
+
+static void acc_file_tick(unsigned int ticks, void *param);
+
+int acc_file_init(void)
+{
+	if (access(acc_file_dir, W_OK|X_OK) < 0) {
+		LM_ERR("cannot write accounting files in %s: %s\n", acc_file_dir,
+			strerror(errno));
+		return -1;
+	}
+
+	if (acc_file_rotate_size <= 0 || acc_file_rotate_interval <= 0) {
+		LM_ERR("bad file_rotate_size/file_rotate_interval\n");
+		return -1;
+	}
+
+	if (acc_file_build_names() < 0)
+		return -1;
+
+	acc_file_recover();
+
+	acc_file_proc = shm_malloc(sizeof *acc_file_proc);
+	if (!acc_file_proc) {
+		LM_ERR("no more shm memory\n");
+		return -1;
+	}
+	*acc_file_proc = -1;
+
+	acc_st = shm_malloc(sizeof *acc_st);
+	if (!acc_st) {
+		LM_ERR("no more shm memory\n");
+		return -1;
+	}
+	acc_st->open = 0;
+	acc_st->buf_len = 0;
+	acc_st->bl_len = 0;
+	acc_st->bl_head = acc_st->bl_tail = NULL;
+	if (!lock_init(&acc_st->lock)) {
+		LM_ERR("failed to init the backlog lock\n");
+		return -1;
+	}
+
+	if (acc_file_backlog < 0)
+		acc_file_backlog = 0;
+
+	if (register_timer("acc-file-rotate", acc_file_tick, NULL, 1,
+			TIMER_FLAG_SKIP_ON_DELAY) < 0) {
+		LM_ERR("failed to register the rotation timer\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+struct acc_file_rec *acc_file_rec_new(unsigned int len)
+{
+	struct acc_file_rec *rec;
+
+	rec = shm_malloc(sizeof *rec + len);
+	if (!rec) {
+		LM_ERR("no more shm memory\n");
+		return NULL;
+	}
+
+	rec->len = len;
+	rec->next = NULL;
+	acc_file_put_u32(rec->buf, len);
+
+	return rec;
+}
+
+
+/* keeps the record for a later write, or drops it if the backlog is full */
+static int acc_file_backlog_add(struct acc_file_rec *rec)
+{
+	lock_get(&acc_st->lock);
+
+	if (acc_st->bl_len >= (unsigned int)acc_file_backlog) {
+		lock_release(&acc_st->lock);
+		LM_ERR("accounting backlog full (%u records), dropping record\n",
+			acc_st->bl_len);
+		update_stat(acc_file_dropped, 1);
+		shm_free(rec);
+		return -1;
+	}
+
+	rec->next = NULL;
+	if (acc_st->bl_tail)
+		acc_st->bl_tail->next = rec;
+	else
+		acc_st->bl_head = rec;
+	acc_st->bl_tail = rec;
+	acc_st->bl_len++;
+
+	lock_release(&acc_st->lock);
+	return 0;
+}
+
+static struct acc_file_rec *acc_file_backlog_pop(void)
+{
+	struct acc_file_rec *rec;
+
+	lock_get(&acc_st->lock);
+
+	rec = acc_st->bl_head;
+	if (rec) {
+		acc_st->bl_head = rec->next;
+		if (!acc_st->bl_head)
+			acc_st->bl_tail = NULL;
+		acc_st->bl_len--;
+	}
+
+	lock_release(&acc_st->lock);
+	return rec;
+}
+
+/* puts back a record which failed again, ahead of the newer ones */
+static void acc_file_backlog_push(struct acc_file_rec *rec)
+{
+	lock_get(&acc_st->lock);
+
+	rec->next = acc_st->bl_head;
+	acc_st->bl_head = rec;
+	if (!acc_st->bl_tail)
+		acc_st->bl_tail = rec;
+	acc_st->bl_len++;
+
+	lock_release(&acc_st->lock);
+}
+
+
+static int acc_file_write(const char *buf, int len)
+{
+	int n;
+
+	while (len) {
+		n = write(acc_fd, buf, len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			LM_ERR("failed to write %.*s: %s\n", acc_st->path_len,
+				acc_st->path, strerror(errno));
+			return -1;
+		}
+		buf += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+/* on failure, the records not fully written are kept in the buffer, for
+ * the next file - only the last record of a file may be truncated */
+static int acc_file_flush(void)
+{
+	uint32_t len;
+	int n, done, off;
+
+	for (done = 0; done < acc_st->buf_len; done += n) {
+		n = write(acc_fd, acc_st->buf + done, acc_st->buf_len - done);
+		if (n < 0) {
+			if (errno == EINTR) {
+				n = 0;
+				continue;
+			}
+			LM_ERR("failed to write %.*s: %s\n", acc_st->path_len,
+				acc_st->path, strerror(errno));
+
+			for (off = 0; ; off += len) {
+				memcpy(&len, acc_st->buf + off, sizeof len);
+				if (off + (int)len > done)
+					break;
+			}
+			memmove(acc_st->buf, acc_st->buf + off, acc_st->buf_len - off);
+			acc_st->buf_len -= off;
+			return -1;
+		}
+	}
+
+	acc_st->buf_len = 0;
+	return 0;
+}
+
+/* after a write failure, nothing more is to be written in the file */
+static void acc_file_close(int flush)
+{
+	char part[PATH_MAX];
+
+	if (acc_fd < 0)
+		return;
+
+	if (flush)
+		acc_file_flush();
+	close(acc_fd);
+	acc_fd = -1;
+	acc_st->open = 0;
+
+	snprintf(part, sizeof part, "%.*s" ACC_FILE_PART_SUFFIX,
+		acc_st->path_len, acc_st->path);
+	if (rename(part, acc_st->path) < 0)
+		LM_ERR("failed to rename %s: %s\n", part, strerror(errno));
+	else
+		LM_DBG("closed %s, %lu bytes\n", acc_st->path, acc_written);
+}
+
+static int acc_file_open(void)
+{
+	char part[PATH_MAX];
+	char hdr[ACC_FILE_HDR_LEN], *p;
+	struct tm tm;
+
+	acc_opened = time(NULL);
+	localtime_r(&acc_opened, &tm);
+
+	acc_st->path_len = snprintf(acc_st->path, sizeof acc_st->path,
+		"%s/%s-%04d%02d%02d%02d%02d%02d-%d-%u" ACC_FILE_SUFFIX,
+		acc_file_dir, acc_file_prefix, tm.tm_year + 1900, tm.tm_mon + 1,
+		tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, my_pid(), acc_seq++);
+	if (acc_st->path_len < 0 || acc_st->path_len >=
+			(int)(sizeof acc_st->path - (sizeof(ACC_FILE_PART_SUFFIX) - 1))) {
+		LM_ERR("accounting file path too long\n");
+		return -1;
+	}
+	memcpy(part, acc_st->path, acc_st->path_len);
+	memcpy(part + acc_st->path_len, ACC_FILE_PART_SUFFIX,
+		sizeof ACC_FILE_PART_SUFFIX);
+
+	acc_fd = open(part, O_WRONLY|O_CREAT|O_EXCL|O_APPEND, 0640);
+	if (acc_fd < 0) {
+		LM_ERR("failed to create %s: %s\n", part, strerror(errno));
+		return -1;
+	}
+	acc_st->open = 1;
+
+	memcpy(hdr, ACC_FILE_MAGIC, ACC_FILE_MAGIC_LEN);
+	p = acc_file_put_u32(hdr + ACC_FILE_MAGIC_LEN, ACC_FILE_VERSION);
+	p = acc_file_put_u32(p, ACC_FILE_BOM);
+	p = acc_file_put_u64(p, acc_opened);
+	p = acc_file_put_u16(p, acc_file_fields);
+	acc_file_put_u16(p, acc_file_leg_fields);
+
+	if (acc_file_write(hdr, sizeof hdr) < 0 ||
+			acc_file_write(acc_file_names.s, acc_file_names.len) < 0) {
+		acc_file_close(0);
+		return -1;
+	}
+
+	acc_written = sizeof hdr + acc_file_names.len;
+	return 0;
+}
+
+/* rotate at the interval boundaries (i.e. every hour, at :00) */
+static inline int acc_file_expired(time_t now)
+{
+	return now / acc_file_rotate_interval !=
+		acc_opened / acc_file_rotate_interval;
+}
+
+/* on failure, the record is left to the caller */
+static int acc_file_store(struct acc_file_rec *rec)
+{
+	if (acc_fd >= 0 && (acc_written >= (unsigned long)acc_file_rotate_size ||
+			acc_file_expired(time(NULL))))
+		acc_file_close(1);
+
+	if (acc_fd < 0 && acc_file_open() < 0)
+		return -1;
+
+	if (acc_st->buf_len + rec->len > ACC_FILE_BUF_SIZE &&
+			acc_file_flush() < 0)
+		goto error;
+
+	if (rec->len > ACC_FILE_BUF_SIZE) {
+		if (acc_file_write(rec->buf, rec->len) < 0)
+			goto error;
+	} else {
+		memcpy(acc_st->buf + acc_st->buf_len, rec->buf, rec->len);
+		acc_st->buf_len += rec->len;
+	}
+	acc_written += rec->len;
+
+	return 0;
+
+error:
+	/* carry on with a new file */
+	acc_file_close(0);
+	return -1;
+}
+
+/* writes out what previously failed, oldest first */
+static int acc_file_retry(void)
+{
+	struct acc_file_rec *rec;
+
+	while (acc_st->bl_len && (rec = acc_file_backlog_pop())) {
+		if (acc_file_store(rec) < 0) {
+			acc_file_backlog_push(rec);
+			return -1;
+		}
+		shm_free(rec);
+	}
+
+	if (!acc_st->buf_len)
+		return 0;
+
+	if (acc_fd < 0 && acc_file_open() < 0)
+		return -1;
+
+	if (acc_file_flush() < 0) {
+		acc_file_close(0);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void acc_file_write_job(int sender, void *param)
+{
+	struct acc_file_rec *rec = (struct acc_file_rec *)param;
+
+	if (acc_st->bl_len && acc_file_retry() < 0) {
+		acc_file_backlog_add(rec);
+		return;
+	}
+
+	if (acc_file_store(rec) < 0) {
+		acc_file_backlog_add(rec);
+		return;
+	}
+	shm_free(rec);
+
+	/* nothing else queued - do not keep the records in memory */
+	if (ipc_queue_depth(process_no) == 0 && acc_file_flush() < 0)
+		acc_file_close(0);
+}
+
+static void acc_file_tick_job(int sender, void *param)
+{
+	if (acc_fd >= 0 && acc_file_expired(time(NULL)))
+		acc_file_close(1);
+
+	acc_file_retry();
+}
+
+static void acc_file_tick(unsigned int ticks, void *param)
+{
+	if (*acc_file_proc < 0)
+		return;
+
+	if (ipc_send_rpc(*acc_file_proc, acc_file_tick_job, NULL) < 0)
+		LM_ERR("failed to trigger the accounting file rotation\n");
+}
+
+
+int acc_file_send(struct acc_file_rec *rec)
+{
+	if (!acc_file_proc) {
+		LM_ERR("file accounting requested, but no \"file_dir\" is set\n");
+		shm_free(rec);
+		return -1;
+	}
+
+	/* the writer is not up yet, or cannot be reached for now */
+	if (*acc_file_proc < 0)
+		return acc_file_backlog_add(rec);
+
+	if (ipc_send_rpc(*acc_file_proc, acc_file_write_job, rec) < 0) {
+		LM_WARN("failed to pass the record to the accounting file writer, "
+			"keeping it in the backlog\n");
+		return acc_file_backlog_add(rec);
+	}
+
+	return 0;
+}
+
+
+void acc_file_process(int rank)
+{
+	if (reactor_proc_init("acc file writer") < 0) {
+		LM_ERR("failed to init the acc file writer\n");
+		return;
+	}
+
+	*acc_file_proc = process_no;
+
+	/* the records generated before the writer was up */
+	acc_file_retry();
+
+	reactor_proc_loop();
+}
+
+
+/* called on shutdown, once the writer is gone: write out the records it
+ * still buffered or left in the backlog and make its file available */
+void acc_file_destroy(void)
+{
+	char part[PATH_MAX];
+	struct acc_file_rec *rec;
+	unsigned int dropped = 0;
+	uint32_t len;
+	int off;
+
+	if (!acc_st)
+		return;
+
+	if (acc_st->open) {
+		snprintf(part, sizeof part, "%.*s" ACC_FILE_PART_SUFFIX,
+			acc_st->path_len, acc_st->path);
+		acc_fd = open(part, O_WRONLY|O_APPEND);
+		if (acc_fd < 0)
+			LM_ERR("failed to open %s: %s\n", part, strerror(errno));
+	}
+
+	if (acc_file_retry() < 0) {
+		while ((rec = acc_file_backlog_pop())) {
+			shm_free(rec);
+			dropped++;
+		}
+		for (off = 0; off < acc_st->buf_len; off += len, dropped++)
+			memcpy(&len, acc_st->buf + off, sizeof len);
+		acc_st->buf_len = 0;
+
+		LM_ERR("dropping %u accounting records on shutdown\n", dropped);
+		update_stat(acc_file_dropped, dropped);
+	}
+
+	acc_file_close(1);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/*
+ * Binary file accounting backend
+ *
+ * The SIP workers serialize each record in shm and pass it, through IPC,
+ * to a dedicated writer process, which appends the records to local files
+ * (see acc_file_fmt.h), rotated by size and by time.
+ */
+
+#ifndef _ACC_FILE_H_
+#define _ACC_FILE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../../str.h"
+#include "../../statistics.h"
+#include "acc_file_fmt.h"
+
+struct acc_file_rec {
+	unsigned int len;
+	struct acc_file_rec *next; /* in the backlog */
+	char buf[0];
+};
+
+extern char *acc_file_dir;
+extern char *acc_file_prefix;
+extern int acc_file_rotate_size;
+extern int acc_file_rotate_interval;
+extern int acc_file_backlog;
+
+/* the records lost, once the backlog was full */
+extern stat_var *acc_file_dropped;
+
+/* to be called from mod_init(), only if the backend is enabled */
+int acc_file_init(void);
+
+/* the writer process */
+void acc_file_process(int rank);
+
+/* to be called on shutdown, writes out what the writer left buffered */
+void acc_file_destroy(void);
+
+/* allocates a record of @len bytes, with the length field already set */
+struct acc_file_rec *acc_file_rec_new(unsigned int len);
+
+/* hands the record over to the writer process, which will free it */
+int acc_file_send(struct acc_file_rec *rec);
+
+static inline unsigned int acc_file_val_len(const str *s)
+{
+	return 2 + (s->len > ACC_FILE_MAX_VALUE ? ACC_FILE_MAX_VALUE :
+		(s->len < 0 ? 0 : s->len));
+}
+
+static inline char *acc_file_put_u8(char *p, uint8_t v)
+{
+	*p = (char)v;
+	return p + 1;
+}
+
+static inline char *acc_file_put_u16(char *p, uint16_t v)
+{
+	memcpy(p, &v, sizeof v);
+	return p + sizeof v;
+}
+
+static inline char *acc_file_put_u32(char *p, uint32_t v)
+{
+	memcpy(p, &v, sizeof v);
+	return p + sizeof v;
+}
+
+static inline char *acc_file_put_u64(char *p, uint64_t v)
+{
+	memcpy(p, &v, sizeof v);
+	return p + sizeof v;
+}
+
+static inline char *acc_file_put_val(char *p, const str *s)
+{
+	unsigned int len = acc_file_val_len(s) - 2;
+
+	p = acc_file_put_u16(p, (uint16_t)len);
+	if (len)
+		memcpy(p, s->s, len);
+	return p + len;
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/*
+ * Layout of the binary accounting files - shared with the offline
+ * converter (utils/acc_bin), so it must not depend on any OpenSIPS header
+ *
+ * All the integers are in the byte order of the writer, as given by the
+ * byte order mark of the file header; nothing is aligned.
+ *
+ * File header:
+ *     char magic[8]           "OSACCBIN"
+ *     u32  version
+ *     u32  byte order mark    0x01020304
+ *     u64  creation time      (UNIX time)
+ *     u16  fields             number of values of each record
+ *     u16  leg fields         number of values of each leg
+ *     then the names of the fields, then the names of the leg fields,
+ *     each one as a value (see below)
+ *
+ * Record:
+ *     u32  length             of the whole record, including this field
+ *     u8   type               ACC_FILE_REC_*
+ *     u64  time               in ms; the call start time, for CDRs
+ *     u32  created            dialog creation time, 0 if not known
+ *     u32  setuptime          in seconds
+ *     u32  duration           in ms, CDRs only
+ *     u16  legs
+ *     then the values of the fields, then the values of each leg
+ *
+ * Value:
+ *     u16  length
+ *     char value[length]
+ */
+
+#ifndef _ACC_FILE_FMT_H_
+#define _ACC_FILE_FMT_H_
+
+#define ACC_FILE_MAGIC      "OSACCBIN"
+#define ACC_FILE_MAGIC_LEN  8
+#define ACC_FILE_VERSION    1
+#define ACC_FILE_BOM        0x01020304
+
+#define ACC_FILE_HDR_LEN    (ACC_FILE_MAGIC_LEN + 4 + 4 + 8 + 2 + 2)
+#define ACC_FILE_REC_HDR_LEN (4 + 1 + 8 + 4 + 4 + 4 + 2)
+
+/* record types */
+#define ACC_FILE_REC_REQUEST  1
+#define ACC_FILE_REC_MISSED   2
+#define ACC_FILE_REC_CDR      3
+
+#define ACC_FILE_MAX_VALUE  0xFFFF
+
+/* the suffix of the file currently being written */
+#define ACC_FILE_PART_SUFFIX ".part"
+#define ACC_FILE_SUFFIX      ".acc"
+
+#endif
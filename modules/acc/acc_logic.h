@@ -37,6 +37,7 @@
 #define DO_ACC_LOG  (1<<(0*8))
 #define DO_ACC_AAA  (1<<(1*8))
 #define DO_ACC_DB   (1<<(2*8))
+#define DO_ACC_FILE ((unsigned long long)1<<(3*8))
 #define DO_ACC_EVI  ((unsigned long long)1<<(4*8))
 #define DO_ACC_ERR  ((unsigned long long)-1)
 
@@ -53,6 +54,7 @@
 #define DO_ACC_AAA_STR  "aaa"
 #define DO_ACC_DB_STR   "db"
 #define DO_ACC_EVI_STR  "evi"
+#define DO_ACC_FILE_STR "file"
 
 #define DO_ACC_CDR_STR    "cdr"
 #define DO_ACC_MISSED_STR "missed"
@@ -59,6 +59,7 @@
 #include "acc_extra.h"
 #include "acc_logic.h"
 #include "acc_vars.h"
+#include "acc_file.h"
 
 struct dlg_binds dlg_api;
 struct tm_binds tmb;
@@ -66,6 +67,7 @@ struct rr_binds rrb;
 
 static int mod_init(void);
 static int child_init(int rank);
+static void mod_destroy(void);
 
 
 /* ----- General purpose variables ----------- */
@@ -138,6 +140,11 @@ str acc_created_col    = str_init("created");
 struct acc_extra *evi_extra_tags = 0;
 struct acc_extra *evi_leg_tags = 0;
 
+/* ----- Binary file acc variables ----------- */
+/* file extra variables */
+struct acc_extra *file_extra_tags = 0;
+struct acc_extra *file_leg_tags = 0;
+
 /* acc context position */
 int acc_flags_ctx_idx;
 int acc_tm_flags_ctx_idx;
@@ -227,9 +234,25 @@ static param_export_t params[] = {
 	{"acc_sip_code_column",  STR_PARAM, &acc_sipcode_col.s    },
 	{"acc_sip_reason_column",STR_PARAM, &acc_sipreason_col.s  },
 	{"acc_time_column",      STR_PARAM, &acc_time_col.s       },
+	/* file specific */
+	{"file_dir",             STR_PARAM, &acc_file_dir         },
+	{"file_prefix",          STR_PARAM, &acc_file_prefix      },
+	{"file_rotate_size",     INT_PARAM, &acc_file_rotate_size },
+	{"file_rotate_interval", INT_PARAM, &acc_file_rotate_interval },
+	{"file_backlog",         INT_PARAM, &acc_file_backlog     },
+	{0,0,0}
+};
+
+static stat_export_t mod_stats[] = {
+	{"acc_file_dropped", 0, &acc_file_dropped},
 	{0,0,0}
 };
 
+static proc_export_t procs[] = {
+	{"acc file writer", 0, 0, acc_file_process, 0, PROC_FLAG_HAS_IPC},
+	{0,0,0,0,0,0}
+};
+
 static module_dependency_t *get_deps_aaa_url(param_export_t *param)
 {
 	char *aaa_url = *(char **)param->param_pointer;
@@ -290,15 +313,15 @@ struct module_exports exports= {
 	cmds,       /* exported functions */
 	0,          /* exported async functions */
 	params,     /* exported params */
-	0,          /* exported statistics */
+	mod_stats,  /* exported statistics */
 	0,          /* exported MI functions */
 	mod_items,  /* exported pseudo-variables */
 	0,			/* exported transformations */
-	0,          /* extra processes */
+	procs,      /* extra processes */
 	mod_preinit,/* pre-initialization module */
 	mod_init,   /* initialization module */
 	0,          /* response function */
-	0,          /* destroy function */
+	mod_destroy,/* destroy function */
 	child_init, /* per-child init function */
 	0           /* reload confirm function */
 };
@@ -397,6 +420,22 @@ static int mod_init( void )
 	}
 
 
+	/* ----------- BINARY FILE INIT SECTION ----------- */
+	if (acc_file_dir && acc_file_dir[0]) {
+		if (acc_file_init() < 0) {
+			LM_ERR("failed to init file accounting\n");
+			return -1;
+		}
+		procs[0].no = 1;
+	} else {
+		if (file_extra_tags || file_leg_tags) {
+			LM_ERR("file leg and/or extra fields defined but no file_dir!\n");
+			return -1;
+		}
+		acc_file_dir = NULL;
+	}
+
+
 	/* ----------- EVENT INTERFACE INIT SECTION ----------- */
 	if (init_acc_evi() < 0) {
 		LM_ERR("cannot init acc events\n");
@@ -426,3 +465,8 @@ static int child_init(int rank)
 }
 
 
+static void mod_destroy(void)
+{
+	if (acc_file_dir)
+		acc_file_destroy();
+}
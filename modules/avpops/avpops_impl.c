@@ -43,6 +43,7 @@
 #include "../../parser/parse_from.h"
 #include "../../parser/parse_uri.h"
 #include "../../mem/mem.h"
+#include "../../db/db_async_exec.h"
 #include "avpops_impl.h"
 #include "avpops_db.h"
 
@@ -821,6 +822,21 @@ int ops_async_dbquery(struct sip_msg* msg, async_ctx *ctx,
 
 	LM_DBG("query [%.*s]\n", query->len, query->s);
 
+	/* let the core DB executors run it over their shared connections */
+	if (db_async_exec_enabled())
+	{
+		if (db_async_exec_query(&url->url, query, ctx,
+				resume_async_dbquery_exec, dest) < 0)
+		{
+			ctx->resume_param = NULL;
+			ctx->resume_f = NULL;
+			return -1;
+		}
+
+		async_status = ASYNC_NO_FD;
+		return 1;
+	}
+
 	/* No async capabilities - just run it in blocking mode */
 	if (!DB_CAPABILITY(url->dbf, DB_CAP_ASYNC_RAW_QUERY))
 	{
@@ -863,6 +879,31 @@ int ops_async_dbquery(struct sip_msg* msg, async_ctx *ctx,
 	return 1;
 }
 
+int resume_async_dbquery_exec(int fd, struct sip_msg *msg, void *_param)
+{
+	db_async_job_t *job = (db_async_job_t *)_param;
+	int ret;
+
+	if (job->rc != 0) {
+		LM_ERR("async query returned error\n");
+		ret = -1;
+	} else if (!job->res) {
+		LM_DBG("query returned no results\n");
+		ret = -2;
+	} else if (db_query_avp_print_results(msg, job->res,
+			(pvname_list_t *)job->param) != 0) {
+		LM_ERR("failed to print results\n");
+		ret = -1;
+	} else {
+		ret = 1;
+	}
+
+	async_status = ASYNC_DONE;
+
+	db_async_job_free(job);
+	return ret;
+}
+
 int resume_async_dbquery(int fd, struct sip_msg *msg, void *_param)
 {
 	db_res_t *res = NULL;
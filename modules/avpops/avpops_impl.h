@@ -144,6 +144,8 @@ int ops_async_dbquery(struct sip_msg* msg, async_ctx *ctx,
 
 int resume_async_dbquery(int fd, struct sip_msg *msg, void *_param);
 
+int resume_async_dbquery_exec(int fd, struct sip_msg *msg, void *_param);
+
 int ops_delete_avp(struct sip_msg* msg,
 								struct fis_param *ap);
 
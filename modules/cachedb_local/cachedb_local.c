@@ -62,6 +62,7 @@ str cache_repl_cap = str_init("cachedb-local-repl");
 int cluster_id = 0;
 enum cachedb_rr_persist rr_persist = RRP_SYNC_FROM_CLUSTER;
 char *cluster_persist;
+static char *max_memory_s;
 
 static int remove_chunk_f(struct sip_msg* msg, str* collection, str* glob);
 mi_response_t *mi_cache_remove_chunk_1(const mi_params_t *params,
@@ -69,7 +70,10 @@ mi_response_t *mi_cache_remove_chunk_1(const mi_params_t *params,
 mi_response_t *mi_cache_remove_chunk_2(const mi_params_t *params,
 								struct mi_handler *async_hdl);
 void localcache_clean(unsigned int ticks,void *param);
+void localcache_reclaim(unsigned int ticks,void *param);
 static int parse_collections(unsigned int type, void *val);
+static int parse_max_memory(char *val);
+static int register_col_stats(lcache_col_t *col);
 static int store_urls(unsigned int type, void *val);
 
 static param_export_t params[]={
@@ -79,6 +83,7 @@ static param_export_t params[]={
 	{ "cachedb_url",        STR_PARAM|USE_FUNC_PARAM, (void *)store_urls },
 	{ "cluster_id",INT_PARAM, &cluster_id },
 	{ "cluster_persistency",STR_PARAM, &cluster_persist },
+	{ "collection_max_memory",STR_PARAM, &max_memory_s },
 	{0,0,0}
 };
 
@@ -142,7 +147,7 @@ static int pat_buff_size = 0;
 static int remove_chunk_f(struct sip_msg* msg, str* col_s, str* pat)
 {
 	int i;
-	lcache_entry_t* me1, *me2;
+	lcache_entry_t* me1, **link;
 	struct timeval start;
 
 	lcache_col_t* col;
@@ -184,10 +189,9 @@ static int remove_chunk_f(struct sip_msg* msg, str* col_s, str* pat)
 
 	for(i = 0; i< col->size; i++) {
 		lock_get(&cache_htable[i].lock);
-		me1 = cache_htable[i].entries;
-		me2 = NULL;
+		link = (lcache_entry_t **)&cache_htable[i].entries;
 
-		while(me1) {
+		while((me1 = *link)) {
 			if (me1->attr.len + 1 > key_buff_size) {
 				key_buff = pkg_realloc(key_buff,me1->attr.len+1);
 				if (key_buff == NULL) {
@@ -210,18 +214,9 @@ static int remove_chunk_f(struct sip_msg* msg, str* col_s, str* pat)
 				LM_DBG("[%.*s] matches glob [%.*s] - removing from bucket %d\n",
 						me1->attr.len, me1->attr.s,pat_buff_size,pat_buff,i);
 
-				if(me2) {
-					me2->next = me1->next;
-					shm_free(me1);
-					me1 = me2->next;
-				} else{
-					cache_htable[i].entries = me1->next;
-					shm_free(me1);
-					me1 = cache_htable[i].entries;
-				}
+				lcache_unlink_entry(col, link);
 			} else {
-				me2 = me1;
-				me1 = me1->next;
+				link = &me1->next;
 			}
 		}
 		lock_release(&cache_htable[i].lock);
@@ -377,11 +372,12 @@ static int mod_init(void)
 			LM_ERR("no more shared memory!\n");
 			return -1;
 		}
+		memset(default_col, 0, sizeof(lcache_col_t));
 
 		default_col->col_name.s = DEFAULT_COLLECTION_NAME;
 		default_col->col_name.len = sizeof(DEFAULT_COLLECTION_NAME) - 1;
 		default_col->size = (1 << HASH_SIZE_DEFAULT);
-		if (lcache_htable_init(&default_col->col_htable, default_col->size) < 0) {
+		if (lcache_col_init(default_col) < 0) {
 			LM_ERR("failed to initialize for <%s> collection!\n",
 						DEFAULT_COLLECTION_NAME);
 			return -1;
@@ -396,6 +392,18 @@ static int mod_init(void)
 		lcache_collection = default_col;
 	}
 
+	if (max_memory_s && parse_max_memory(max_memory_s) < 0) {
+		LM_ERR("failed to parse 'collection_max_memory'!\n");
+		return -1;
+	}
+
+	for ( col_it=lcache_collection; col_it; col_it=col_it->next )
+		if (register_col_stats(col_it) < 0) {
+			LM_ERR("failed to register the statistics of collection <%.*s>\n",
+				col_it->col_name.len, col_it->col_name.s);
+			return -1;
+		}
+
 	if ( it ) {
 		while (it) {
 			con = lcache_init(&it->url);
@@ -446,6 +454,10 @@ static int mod_init(void)
 	register_timer("localcache-expire",localcache_clean, 0,
 		cache_clean_period, TIMER_FLAG_DELAY_ON_DELAY);
 
+	/* and the one to release the entries no longer seen by any reader */
+	register_timer("localcache-reclaim",localcache_reclaim, 0,
+		1, TIMER_FLAG_DELAY_ON_DELAY);
+
 	/* register clusterer module */
 	if (cluster_id) {
 		if (cluster_persist) {
@@ -496,57 +508,141 @@ static void destroy(void)
 	lcache_col_t* it;
 
 	for ( it=lcache_collection; it; it=it->next) {
-		lcache_htable_destroy(&it->col_htable, it->size);
+		lcache_col_destroy(it);
 	}
 }
 
 void localcache_clean(unsigned int ticks,void *param)
 {
-	int i;
-	lcache_entry_t* me1, *me2;
 	lcache_col_t* it;
-	lcache_t* cache_htable;
 
 	for ( it=lcache_collection; it; it=it->next ) {
 		LM_DBG("start\n");
-		cache_htable = it->col_htable;
-
-		for(i = 0; i< it->size; i++)
-		{
-			lock_get(&cache_htable[i].lock);
-			me1 = cache_htable[i].entries;
-			me2 = NULL;
-
-			while(me1)
-			{
-				if((me1->expires > 0) && (me1->expires < get_ticks()))
-				{
-					LM_DBG("deleted entry attr= [%.*s]\n",
-							me1->attr.len, me1->attr.s);
-
-					if(me2)
-					{
-						me2->next = me1->next;
-						shm_free(me1);
-						me1 = me2->next;
-					}
-					else
-					{
-						cache_htable[i].entries = me1->next;
-						shm_free(me1);
-						me1 = cache_htable[i].entries;
-					}
-				}
-				else
-				{
-					me2 = me1;
-					me1 = me1->next;
-				}
+		lcache_expire_col(it, get_ticks());
+	}
+}
+
+void localcache_reclaim(unsigned int ticks,void *param)
+{
+	lcache_col_t* it;
+
+	for ( it=lcache_collection; it; it=it->next )
+		lcache_reclaim_col(it);
+}
+
+#ifdef STATISTICS
+static unsigned long get_col_used_memory(void *col)
+{
+	return ((lcache_col_t *)col)->used_mem;
+}
+#endif
+
+static int register_col_stats(lcache_col_t *col)
+{
+#ifdef STATISTICS
+	static str hits = str_init("hits"), misses = str_init("misses"),
+		evictions = str_init("evictions"), used = str_init("used_memory");
+	char *col_name, *name;
+
+	col_name = pkg_malloc(col->col_name.len + 1);
+	if (!col_name) {
+		LM_ERR("no more pkg mem\n");
+		return -1;
+	}
+	memcpy(col_name, col->col_name.s, col->col_name.len);
+	col_name[col->col_name.len] = '\0';
+
+	/* e.g. "hits-default" */
+	if ((name = build_stat_name(&hits, col_name)) == NULL ||
+		register_stat(exports.name, name, &col->hits, STAT_SHM_NAME) != 0)
+		goto error;
+	if ((name = build_stat_name(&misses, col_name)) == NULL ||
+		register_stat(exports.name, name, &col->misses, STAT_SHM_NAME) != 0)
+		goto error;
+	if ((name = build_stat_name(&evictions, col_name)) == NULL ||
+		register_stat(exports.name, name, &col->evictions,
+			STAT_SHM_NAME) != 0)
+		goto error;
+	if ((name = build_stat_name(&used, col_name)) == NULL ||
+		register_stat2(exports.name, name, (stat_var **)get_col_used_memory,
+			STAT_SHM_NAME|STAT_IS_FUNC, col, 0) != 0)
+		goto error;
+
+	pkg_free(col_name);
+	return 0;
+
+error:
+	pkg_free(col_name);
+	return -1;
+#else
+	return 0;
+#endif
+}
+
+/* "name = size[K|M|G]; ..." */
+static int parse_max_memory(char *val)
+{
+	str list, size;
+	csv_record *cols, *col, *kv;
+	lcache_col_t *it;
+	unsigned int mem;
+	unsigned long mult;
+
+	init_str(&list, val);
+	cols = __parse_csv_record(&list, 0, ';');
+	if (!cols)
+		return -1;
+
+	for (col = cols; col; col = col->next) {
+		if (ZSTR(col->s))
+			continue;
+
+		kv = __parse_csv_record(&col->s, 0, '=');
+		if (!kv || !kv->next)
+			goto bad_input;
+
+		for ( it=lcache_collection; it; it=it->next )
+			if ( !str_strcmp( &kv->s, &it->col_name) )
+				break;
+
+		if (!it) {
+			LM_ERR("collection <%.*s> not defined!\n", kv->s.len, kv->s.s);
+			goto bad_input;
+		}
+
+		size = kv->next->s;
+		mult = 1;
+		if (size.len > 0) {
+			switch (size.s[size.len - 1]) {
+			case 'k': case 'K': mult = 1024; break;
+			case 'm': case 'M': mult = 1024 * 1024; break;
+			case 'g': case 'G': mult = 1024 * 1024 * 1024; break;
 			}
+			if (mult != 1)
+				size.len--;
+		}
 
-			lock_release(&cache_htable[i].lock);
+		if (str2int(&size, &mem) < 0) {
+			LM_ERR("invalid memory size <%.*s>!\n",
+				kv->next->s.len, kv->next->s.s);
+			goto bad_input;
 		}
+
+		it->max_mem = mem * mult;
+		LM_DBG("collection <%.*s> limited to %lu bytes\n",
+			it->col_name.len, it->col_name.s, it->max_mem);
+
+		free_csv_record(kv);
 	}
+
+	free_csv_record(cols);
+	return 0;
+
+bad_input:
+	if (kv)
+		free_csv_record(kv);
+	free_csv_record(cols);
+	return -1;
 }
 
 static int parse_collections(unsigned int type, void* val)
@@ -620,7 +716,7 @@ static int parse_collections(unsigned int type, void* val)
 		}
 
 		new_col->size = (1 << coll_size);
-		if (lcache_htable_init(&new_col->col_htable, new_col->size) < 0) {
+		if (lcache_col_init(new_col) < 0) {
 			LM_ERR("failed to initialize htable for collection <%.*s>!\n",
 					coll.len, coll.s);
 			return -1;
@@ -29,6 +29,7 @@
 
 #include "../../cachedb/cachedb.h"
 #include "../../cachedb/cachedb_cap.h"
+#include "../../statistics.h"
 #include "hash.h"
 
 #define HASH_SIZE_DEFAULT 9 /* power of two */
@@ -58,6 +59,21 @@ typedef struct lcache_col {
 
 	int replicated;
 
+	/* memory limit of the entries (0 if unlimited) and current usage */
+	unsigned long max_mem;
+	volatile unsigned long used_mem;
+	/* next bucket to be inspected by the CLOCK eviction */
+	volatile unsigned int clock_hand;
+
+	lcache_wheel_slot_t* wheel;
+	unsigned int wheel_last;
+
+	lcache_rcu_t rcu;
+
+	stat_var* hits;
+	stat_var* misses;
+	stat_var* evictions;
+
 	struct lcache_col* next;
 } lcache_col_t;
 
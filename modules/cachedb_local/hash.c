@@ -36,7 +36,14 @@
 #include "cachedb_local_replication.h"
 #include "hash.h"
 
-void lcache_htable_remove_safe(str attr, lcache_entry_t** it);
+/* publishes a fully built entry to the lock-less readers */
+#define lcache_publish(_link, _e) \
+	do { \
+		__sync_synchronize(); \
+		*(_link) = (_e); \
+	} while (0)
+
+#define lcache_head(_bucket) ((lcache_entry_t **)&(_bucket)->entries)
 
 int lcache_htable_init(lcache_t** cache_htable_p, int size)
 {
@@ -103,6 +110,376 @@ void lcache_htable_destroy(lcache_t** cache_htable_p, int size)
 	*cache_htable_p = NULL;
 }
 
+int lcache_col_init(lcache_col_t *col)
+{
+	int i;
+
+	if (lcache_htable_init(&col->col_htable, col->size) < 0)
+		return -1;
+
+	col->wheel = shm_malloc(LCACHE_WHEEL_SIZE * sizeof *col->wheel);
+	if (!col->wheel) {
+		LM_ERR("no more shared memory\n");
+		goto error;
+	}
+	memset(col->wheel, 0, LCACHE_WHEEL_SIZE * sizeof *col->wheel);
+
+	for (i = 0; i < LCACHE_WHEEL_SIZE; i++)
+		if (!lock_init(&col->wheel[i].lock)) {
+			LM_ERR("failed to initialize wheel lock [%d]\n", i);
+			goto error;
+		}
+
+	if (!lock_init(&col->rcu.lock)) {
+		LM_ERR("failed to initialize the reclaim lock\n");
+		goto error;
+	}
+
+	col->wheel_last = get_ticks();
+
+	return 0;
+
+error:
+	if (col->wheel) {
+		shm_free(col->wheel);
+		col->wheel = NULL;
+	}
+	lcache_htable_destroy(&col->col_htable, col->size);
+	return -1;
+}
+
+static void lcache_free_list(lcache_entry_t *e)
+{
+	lcache_entry_t *next;
+
+	/* the retired entries are chained by "wheel_next" */
+	for (; e; e = next) {
+		next = e->wheel_next;
+		shm_free(e);
+	}
+}
+
+void lcache_col_destroy(lcache_col_t *col)
+{
+	int i;
+
+	lcache_htable_destroy(&col->col_htable, col->size);
+
+	lcache_free_list(col->rcu.retired);
+	lcache_free_list(col->rcu.grace);
+	col->rcu.retired = col->rcu.grace = NULL;
+	lock_destroy(&col->rcu.lock);
+
+	if (col->wheel) {
+		for (i = 0; i < LCACHE_WHEEL_SIZE; i++)
+			lock_destroy(&col->wheel[i].lock);
+		shm_free(col->wheel);
+		col->wheel = NULL;
+	}
+}
+
+/* returns the reader epoch index, to be passed to lcache_read_unlock() */
+unsigned int lcache_read_lock(lcache_col_t *col)
+{
+	unsigned int idx;
+
+	for (;;) {
+		idx = col->rcu.epoch & 1;
+		__sync_fetch_and_add(&col->rcu.readers[idx], 1);
+
+		/* make sure we did not race with an epoch switch, otherwise the
+		 * reclaimer could already be waiting on the other counter */
+		if ((col->rcu.epoch & 1) == idx)
+			return idx;
+
+		__sync_fetch_and_sub(&col->rcu.readers[idx], 1);
+	}
+}
+
+void lcache_read_unlock(lcache_col_t *col, unsigned int idx)
+{
+	__sync_fetch_and_sub(&col->rcu.readers[idx], 1);
+}
+
+/* to be run periodically, by a single process at a time */
+void lcache_reclaim_col(lcache_col_t *col)
+{
+	lcache_rcu_t *rcu = &col->rcu;
+
+	if (rcu->grace) {
+		/* all the readers which could still see these entries are done? */
+		if (rcu->readers[rcu->grace_epoch & 1] != 0)
+			return;
+
+		lcache_free_list(rcu->grace);
+		rcu->grace = NULL;
+	}
+
+	lock_get(&rcu->lock);
+	rcu->grace = rcu->retired;
+	rcu->retired = NULL;
+	lock_release(&rcu->lock);
+
+	if (!rcu->grace)
+		return;
+
+	/* the new readers count on the next epoch from now on */
+	rcu->grace_epoch = rcu->epoch;
+	__sync_fetch_and_add(&rcu->epoch, 1);
+}
+
+static void lcache_retire(lcache_col_t *col, lcache_entry_t *e)
+{
+	__sync_fetch_and_sub(&col->used_mem, e->size);
+
+	/* the readers may still walk through it, so keep "next" intact */
+	lock_get(&col->rcu.lock);
+	e->wheel_next = col->rcu.retired;
+	col->rcu.retired = e;
+	lock_release(&col->rcu.lock);
+}
+
+static void lcache_wheel_link(lcache_col_t *col, lcache_entry_t *e)
+{
+	lcache_wheel_slot_t *slot;
+
+	slot = &col->wheel[e->expires & (LCACHE_WHEEL_SIZE - 1)];
+
+	lock_get(&slot->lock);
+	e->wheel_prev = NULL;
+	e->wheel_next = slot->entries;
+	if (slot->entries)
+		slot->entries->wheel_prev = e;
+	slot->entries = e;
+	lock_release(&slot->lock);
+}
+
+static void lcache_wheel_unlink(lcache_col_t *col, lcache_entry_t *e)
+{
+	lcache_wheel_slot_t *slot;
+
+	slot = &col->wheel[e->expires & (LCACHE_WHEEL_SIZE - 1)];
+
+	lock_get(&slot->lock);
+	if (e->wheel_prev)
+		e->wheel_prev->wheel_next = e->wheel_next;
+	else
+		slot->entries = e->wheel_next;
+	if (e->wheel_next)
+		e->wheel_next->wheel_prev = e->wheel_prev;
+	lock_release(&slot->lock);
+}
+
+void lcache_unlink_entry(lcache_col_t *col, lcache_entry_t **link)
+{
+	lcache_entry_t *e = *link;
+
+	/* the readers currently on "e" may still move on */
+	*link = e->next;
+
+	if (e->expires)
+		lcache_wheel_unlink(col, e);
+
+	lcache_retire(col, e);
+}
+
+/* must be called under the bucket lock; the new entry replaces the one
+ * pointed by "link" or, if none, it is added at the head of the bucket */
+static void lcache_link_entry(lcache_col_t *col, lcache_t *bucket,
+		lcache_entry_t **link, lcache_entry_t *me)
+{
+	lcache_entry_t *old = NULL;
+
+	if (link) {
+		old = *link;
+		me->next = old->next;
+	} else {
+		link = lcache_head(bucket);
+		me->next = *link;
+	}
+
+	__sync_fetch_and_add(&col->used_mem, me->size);
+
+	if (me->expires)
+		lcache_wheel_link(col, me);
+
+	lcache_publish(link, me);
+
+	if (old) {
+		if (old->expires)
+			lcache_wheel_unlink(col, old);
+		lcache_retire(col, old);
+	}
+}
+
+/* must be called under the bucket lock */
+static lcache_entry_t **lcache_find_link(lcache_t *bucket, str *attr)
+{
+	lcache_entry_t **link;
+
+	for (link = lcache_head(bucket); *link; link = &(*link)->next)
+		if ((*link)->attr.len == attr->len &&
+				memcmp((*link)->attr.s, attr->s, attr->len) == 0)
+			return link;
+
+	return NULL;
+}
+
+/* lock-less lookup, to be done between lcache_read_lock/unlock() */
+static lcache_entry_t *lcache_lookup(lcache_t *bucket, str *attr)
+{
+	lcache_entry_t *it;
+
+	for (it = bucket->entries; it; it = it->next)
+		if (it->attr.len == attr->len &&
+				memcmp(it->attr.s, attr->s, attr->len) == 0)
+			return it;
+
+	return NULL;
+}
+
+/* "expires" is absolute (in ticks), 0 if never expiring */
+static lcache_entry_t *lcache_new_entry(lcache_col_t *col, str *attr,
+		str *value, unsigned int expires)
+{
+	lcache_entry_t *me;
+	int size;
+
+	size = sizeof(lcache_entry_t) + attr->len + value->len;
+
+	if (col->max_mem && size > col->max_mem) {
+		LM_ERR("record of %d bytes exceeds the memory limit of "
+			"collection <%.*s>\n", size, col->col_name.len, col->col_name.s);
+		return NULL;
+	}
+
+	me = (lcache_entry_t*)shm_malloc(size);
+	if(me == NULL)
+	{
+		LM_ERR("no more shared memory\n");
+		return NULL;
+	}
+	memset(me, 0, sizeof(lcache_entry_t));
+
+	me->attr.s = (char*)me + (sizeof(lcache_entry_t));
+	memcpy(me->attr.s, attr->s, attr->len);
+	me->attr.len = attr->len;
+
+	me->value.s = (char*)me + (sizeof(lcache_entry_t)) + attr->len;
+	memcpy(me->value.s, value->s, value->len);
+	me->value.len = value->len;
+
+	me->expires = expires;
+	me->size = size;
+	/* give it a chance before the first eviction round */
+	me->referenced = 1;
+
+	return me;
+}
+
+/* CLOCK approximation of LRU: the hand walks the buckets, evicting the
+ * entries not looked up since its previous pass */
+static void lcache_evict(lcache_col_t *col)
+{
+	lcache_entry_t **link, *e;
+	lcache_t *bucket;
+	unsigned int i;
+
+	for (i = 0; i < 2 * col->size && col->used_mem > col->max_mem; i++) {
+		bucket = &col->col_htable[
+			__sync_fetch_and_add(&col->clock_hand, 1) & (col->size - 1)];
+
+		lock_get(&bucket->lock);
+
+		link = lcache_head(bucket);
+		while ((e = *link) && col->used_mem > col->max_mem) {
+			if (e->referenced) {
+				e->referenced = 0;
+				link = &e->next;
+				continue;
+			}
+
+			LM_DBG("evicting [%.*s] from collection <%.*s>\n",
+				e->attr.len, e->attr.s,
+				col->col_name.len, col->col_name.s);
+			lcache_unlink_entry(col, link);
+			update_stat(col->evictions, 1);
+		}
+
+		lock_release(&bucket->lock);
+	}
+}
+
+/* drops the entries expired until "now" (excluding), walking the wheel
+ * slots passed since the previous run; to be run by a single process */
+void lcache_expire_col(lcache_col_t *col, unsigned int now)
+{
+	static lcache_entry_t **expired;
+	static int expired_size;
+	lcache_entry_t *e, **link, **tmp;
+	lcache_wheel_slot_t *slot;
+	lcache_t *bucket;
+	unsigned int t, end, idx;
+	int n, i;
+
+	end = now - 1;
+	if ((int)(end - col->wheel_last) <= 0)
+		return;
+
+	t = col->wheel_last;
+	if (end - t > LCACHE_WHEEL_SIZE)
+		t = end - LCACHE_WHEEL_SIZE;
+
+	/* the collected entries must not be released under our feet */
+	idx = lcache_read_lock(col);
+
+	while (t != end) {
+		t++;
+		slot = &col->wheel[t & (LCACHE_WHEEL_SIZE - 1)];
+
+		n = 0;
+		lock_get(&slot->lock);
+		for (e = slot->entries; e; e = e->wheel_next) {
+			/* further away, waiting for another wheel rotation */
+			if (e->expires >= now)
+				continue;
+
+			if (n == expired_size) {
+				tmp = pkg_realloc(expired,
+					(2 * expired_size + 16) * sizeof *expired);
+				if (!tmp) {
+					LM_ERR("no more pkg memory\n");
+					break;
+				}
+				expired = tmp;
+				expired_size = 2 * expired_size + 16;
+			}
+			expired[n++] = e;
+		}
+		lock_release(&slot->lock);
+
+		/* the bucket lock comes first, so we look again for each entry */
+		for (i = 0; i < n; i++) {
+			e = expired[i];
+			bucket = &col->col_htable[core_hash(&e->attr, NULL, col->size)];
+
+			lock_get(&bucket->lock);
+			for (link = lcache_head(bucket); *link && *link != e;
+				link = &(*link)->next) ;
+
+			if (*link) {
+				LM_DBG("deleted entry attr= [%.*s]\n", e->attr.len, e->attr.s);
+				lcache_unlink_entry(col, link);
+			}
+			lock_release(&bucket->lock);
+		}
+	}
+
+	lcache_read_unlock(col, idx);
+
+	col->wheel_last = end;
+}
+
 int lcache_htable_insert(cachedb_con *con,str* attr, str* value, int expires)
 {
 	lcache_col_t *cache_col;
@@ -120,49 +497,32 @@ int lcache_htable_insert(cachedb_con *con,str* attr, str* value, int expires)
 int _lcache_htable_insert(lcache_col_t *cache_col, str* attr, str* value,
 	int expires, int isrepl)
 {
-	lcache_entry_t* me, *it;
+	lcache_entry_t* me;
 	int hash_code;
-	int size;
 	struct timeval start;
 	lcache_t* cache_htable;
 
 	cache_htable = cache_col->col_htable;
 
-	size= sizeof(lcache_entry_t) + attr->len + value->len;
-
-	me = (lcache_entry_t*)shm_malloc(size);
-	if(me == NULL)
-	{
-		LM_ERR("no more shared memory\n");
+	me = lcache_new_entry(cache_col, attr, value,
+		expires != 0 ? get_ticks() + expires : 0);
+	if (me == NULL)
 		return -1;
-	}
-	memset(me, 0, size);
 
 	start_expire_timer(start,local_exec_threshold);
 
-	me->attr.s = (char*)me + (sizeof(lcache_entry_t));
-	memcpy(me->attr.s, attr->s, attr->len);
-	me->attr.len = attr->len;
-
-	me->value.s = (char*)me + (sizeof(lcache_entry_t)) + attr->len;
-	memcpy(me->value.s, value->s, value->len);
-	me->value.len = value->len;
-	if( expires != 0)
-		me->expires = get_ticks() + expires;
-
 	hash_code= core_hash( attr, NULL, cache_col->size);
 	lock_get(&cache_htable[hash_code].lock);
 
-	it = cache_htable[hash_code].entries;
-
-	/* if a previous record for the same attr delete it */
-	lcache_htable_remove_safe( *attr, &it);
-
-	me->next = it;
-	cache_htable[hash_code].entries = me;
+	/* if a previous record for the same attr, replace it */
+	lcache_link_entry(cache_col, &cache_htable[hash_code],
+		lcache_find_link(&cache_htable[hash_code], attr), me);
 
 	lock_release(&cache_htable[hash_code].lock);
 
+	if (cache_col->max_mem && cache_col->used_mem > cache_col->max_mem)
+		lcache_evict(cache_col);
+
 	_stop_expire_timer(start,local_exec_threshold,
 		"cachedb_local insert",attr->s,attr->len,0,
 		cdb_slow_queries, cdb_total_queries);
@@ -174,31 +534,6 @@ int _lcache_htable_insert(lcache_col_t *cache_col, str* attr, str* value,
 	return 1;
 }
 
-void lcache_htable_remove_safe(str attr, lcache_entry_t** it_p)
-{
-	lcache_entry_t* me = NULL, *it= *it_p;
-
-	while(it)
-	{
-		if(it->attr.len == attr.len &&
-				(strncmp(it->attr.s, attr.s, attr.len) == 0))
-		{
-
-			if(me)
-				me->next = it->next;
-			else
-				*it_p = it->next;
-
-			shm_free(it);
-
-			return;
-		}
-		me = it;
-		it = it->next;
-	}
-	LM_DBG("entry not found\n");
-}
-
 int lcache_htable_remove(cachedb_con *con,str* attr)
 {
 	lcache_col_t *cache_col;
@@ -218,6 +553,7 @@ int _lcache_htable_remove(lcache_col_t *cache_col, str* attr, int isrepl)
 	int hash_code;
 	struct timeval start;
 	lcache_t* cache_htable;
+	lcache_entry_t **link;
 
 	cache_htable = cache_col->col_htable;
 
@@ -227,7 +563,11 @@ int _lcache_htable_remove(lcache_col_t *cache_col, str* attr, int isrepl)
 	hash_code= core_hash( attr, NULL, cache_col->size);
 	lock_get(&cache_htable[hash_code].lock);
 
-	lcache_htable_remove_safe( *attr, &cache_htable[hash_code].entries);
+	link = lcache_find_link(&cache_htable[hash_code], attr);
+	if (link)
+		lcache_unlink_entry(cache_col, link);
+	else
+		LM_DBG("entry not found\n");
 
 	lock_release(&cache_htable[hash_code].lock);
 
@@ -244,10 +584,8 @@ int _lcache_htable_remove(lcache_col_t *cache_col, str* attr, int isrepl)
 int lcache_htable_add(cachedb_con *con,str *attr,int val,int expires,int *new_val)
 {
 	int hash_code;
-	lcache_entry_t *it=NULL,*it_prev=NULL;
-	int old_value;
-	char *new_value;
-	int new_len;
+	lcache_entry_t *it, *me, **link;
+	int old_value, is_new;
 	str ins_val;
 	struct timeval start;
 
@@ -268,102 +606,63 @@ int lcache_htable_add(cachedb_con *con,str *attr,int val,int expires,int *new_va
 	hash_code = core_hash(attr, NULL,cache_col->size);
 	lock_get(&cache_htable[hash_code].lock);
 
-	it = cache_htable[hash_code].entries;
-	while (it) {
-		if (it->attr.len == attr->len &&
-				memcmp(it->attr.s,attr->s,attr->len) == 0) {
-			if (it->expires !=0 && it->expires < get_ticks()) {
-				/* found an expired entry  -> delete it */
-				if(it_prev)
-					it_prev->next = it->next;
-				else
-					cache_htable[hash_code].entries = it->next;
-
-				shm_free(it);
-				lock_release(&cache_htable[hash_code].lock);
-
-				ins_val.s = sint2str(val,&ins_val.len);
-				if (lcache_htable_insert(con,attr,&ins_val,expires) < 0) {
-					LM_ERR("failed to insert value\n");
-					_stop_expire_timer(start,local_exec_threshold,
-						"cachedb_local add",attr->s,attr->len,0,
-						cdb_slow_queries, cdb_total_queries);
-					return -1;
-				}
-
-				if (new_val)
-					*new_val = val;
-
-				_stop_expire_timer(start,local_exec_threshold,
-					"cachedb_local add",attr->s,attr->len,0,
-					cdb_slow_queries, cdb_total_queries);
-				return 0;
-			}
+	link = lcache_find_link(&cache_htable[hash_code], attr);
+	it = link ? *link : NULL;
 
-			/* found our valid entry */
-			if (str2sint(&it->value,&old_value) < 0) {
-				LM_ERR("not an integer\n");
-				lock_release(&cache_htable[hash_code].lock);
-				_stop_expire_timer(start,local_exec_threshold,
-					"cachedb_local add",attr->s,attr->len,0,
-					cdb_slow_queries, cdb_total_queries);
-				return -1;
-			}
-
-			old_value+=val;
-			expires = it->expires;
-			new_value = sint2str(old_value,&new_len);
-			it = shm_realloc(it,sizeof(lcache_entry_t) + attr->len +new_len);
-			if (it == NULL) {
-				LM_ERR("failed to realloc struct\n");
-				lock_release(&cache_htable[hash_code].lock);
-				_stop_expire_timer(start,local_exec_threshold,
-					"cachedb_local add",attr->s,attr->len,0,
-					cdb_slow_queries, cdb_total_queries);
-				return -1;
-			}
+	/* an expired entry is replaced, as if not found */
+	is_new = (!it || (it->expires != 0 && it->expires < get_ticks()));
 
-			if (it_prev)
-				it_prev->next = it;
-			else
-				cache_htable[hash_code].entries = it;
-
-			it->attr.s = (char*)(it + 1);
-			it->value.s =(char *)(it + 1) + attr->len;
-			it->expires = expires;
-
-			memcpy(it->value.s,new_value,new_len);
-			it->value.len = new_len;
+	if (!is_new) {
+		/* found our valid entry */
+		if (str2sint(&it->value,&old_value) < 0) {
+			LM_ERR("not an integer\n");
 			lock_release(&cache_htable[hash_code].lock);
-			if (new_val)
-				*new_val = old_value;
 			_stop_expire_timer(start,local_exec_threshold,
 				"cachedb_local add",attr->s,attr->len,0,
 				cdb_slow_queries, cdb_total_queries);
-			return 0;
+			return -1;
 		}
 
-		it_prev = it;
-		it = it->next;
-	}
+		old_value += val;
+		ins_val.s = sint2str(old_value,&ins_val.len);
 
-	lock_release(&cache_htable[hash_code].lock);
+		/* the readers may be on the old one, so we swap in a new entry */
+		me = lcache_new_entry(cache_col, attr, &ins_val, it->expires);
+	} else {
+		old_value = val;
+		ins_val.s = sint2str(val,&ins_val.len);
 
-	/* not found */
-	ins_val.s = sint2str(val,&ins_val.len);
-	if (lcache_htable_insert(con,attr,&ins_val,expires) < 0) {
+		me = lcache_new_entry(cache_col, attr, &ins_val,
+			expires != 0 ? get_ticks() + expires : 0);
+	}
+
+	if (me == NULL) {
 		LM_ERR("failed to insert value\n");
+		lock_release(&cache_htable[hash_code].lock);
 		_stop_expire_timer(start,local_exec_threshold,
 			"cachedb_local add",attr->s,attr->len,0,
 			cdb_slow_queries, cdb_total_queries);
 		return -1;
 	}
 
+	lcache_link_entry(cache_col, &cache_htable[hash_code], link, me);
+
+	lock_release(&cache_htable[hash_code].lock);
+
+	if (cache_col->max_mem && cache_col->used_mem > cache_col->max_mem)
+		lcache_evict(cache_col);
+
 	if (new_val)
-		*new_val = val;
+		*new_val = old_value;
+
 	_stop_expire_timer(start,local_exec_threshold,
 		"cachedb_local add",attr->s,attr->len,0,
 		cdb_slow_queries, cdb_total_queries);
+
+	/* replicate the (re)created records, same as an insert */
+	if (is_new && cluster_id && cache_col->replicated)
+		replicate_cache_insert(&cache_col->col_name, attr, &ins_val, expires);
+
 	return 0;
 }
 
@@ -380,8 +679,9 @@ int lcache_htable_sub(cachedb_con *con,str *attr,int val,int expires,int *new_va
  * */
 int lcache_htable_fetch(cachedb_con *con,str* attr, str* res)
 {
-	int hash_code;
-	lcache_entry_t* it = NULL, *it_aux = NULL;
+	int hash_code, ret;
+	unsigned int idx;
+	lcache_entry_t* it;
 	char* value;
 	struct timeval start;
 
@@ -401,67 +701,47 @@ int lcache_htable_fetch(cachedb_con *con,str* attr, str* res)
 	start_expire_timer(start,local_exec_threshold);
 
 	hash_code= core_hash( attr, NULL, cache_col->size);
-	lock_get(&cache_htable[hash_code].lock);
-
-	it = cache_htable[hash_code].entries;
-
-	while(it)
-	{
-		if(it->attr.len == attr->len &&
-				(strncmp(it->attr.s, attr->s, attr->len) == 0))
+	idx = lcache_read_lock(cache_col);
+
+	it = lcache_lookup(&cache_htable[hash_code], attr);
+	if (!it || (it->expires != 0 && it->expires < get_ticks())) {
+		/* an expired entry is left to the expiry timer */
+		ret = -2;
+	} else {
+		value = (char*)pkg_malloc(it->value.len);
+		if(value == NULL)
 		{
-			if( it->expires != 0 && it->expires < get_ticks())
-			{
-				/* found an expired entry  -> delete it */
-				if(it_aux)
-					it_aux->next = it->next;
-				else
-					cache_htable[hash_code].entries = it->next;
-
-				shm_free(it);
-
-				lock_release(&cache_htable[hash_code].lock);
-				_stop_expire_timer(start,local_exec_threshold,
-					"cachedb_local fetch",attr->s,attr->len,0,
-					cdb_slow_queries, cdb_total_queries);
-				return -2;
-			}
-			value = (char*)pkg_malloc(it->value.len);
-			if(value == NULL)
-			{
-				LM_ERR("no more memory\n");
-				lock_release(&cache_htable[hash_code].lock);
-				_stop_expire_timer(start,local_exec_threshold,
-					"cachedb_local fetch",attr->s,attr->len,0,
-					cdb_slow_queries, cdb_total_queries);
-				return -1;
-			}
+			LM_ERR("no more memory\n");
+			ret = -1;
+		} else {
 			memcpy(value, it->value.s, it->value.len);
 			res->len = it->value.len;
 			res->s = value;
-			lock_release(&cache_htable[hash_code].lock);
-			_stop_expire_timer(start,local_exec_threshold,
-				"cachedb_local fetch",attr->s,attr->len,0,
-				cdb_slow_queries, cdb_total_queries);
-			return 1;
+			ret = 1;
 		}
 
-		it_aux = it;
-		it = it->next;
+		if (!it->referenced)
+			it->referenced = 1;
 	}
 
-	lock_release(&cache_htable[hash_code].lock);
+	lcache_read_unlock(cache_col, idx);
+
+	if (ret == -2)
+		update_stat(cache_col->misses, 1);
+	else
+		update_stat(cache_col->hits, 1);
+
 	_stop_expire_timer(start,local_exec_threshold,
 		"cachedb_local fetch",attr->s,attr->len,0,
 		cdb_slow_queries, cdb_total_queries);
-	return -2;
+	return ret;
 }
 
 int lcache_htable_fetch_counter(cachedb_con* con,str* attr,int *val)
 {
-	int hash_code;
-	lcache_entry_t* it = NULL, *it_aux = NULL;
-	int ret;
+	int hash_code, ret, cnt;
+	unsigned int idx;
+	lcache_entry_t* it;
 	struct timeval start;
 
 	lcache_t* cache_htable;
@@ -479,55 +759,34 @@ int lcache_htable_fetch_counter(cachedb_con* con,str* attr,int *val)
 	start_expire_timer(start,local_exec_threshold);
 
 	hash_code= core_hash( attr, NULL, cache_col->size);
-	lock_get(&cache_htable[hash_code].lock);
-
-	it = cache_htable[hash_code].entries;
-
-	while(it)
-	{
-		if(it->attr.len == attr->len &&
-				(strncmp(it->attr.s, attr->s, attr->len) == 0))
-		{
-			if( it->expires != 0 && it->expires < get_ticks())
-			{
-				/* found an expired entry  -> delete it */
-				if(it_aux)
-					it_aux->next = it->next;
-				else
-					cache_htable[hash_code].entries = it->next;
-
-				shm_free(it);
-
-				lock_release(&cache_htable[hash_code].lock);
-				_stop_expire_timer(start,local_exec_threshold,
-					"cachedb_local fetch_counter",attr->s,attr->len,0,
-					cdb_slow_queries, cdb_total_queries);
-				return -2;
-			}
-			if (str2sint(&it->value,&ret) != 0) {
-				LM_ERR("Not a counter key\n");
-				lock_release(&cache_htable[hash_code].lock);
-				_stop_expire_timer(start,local_exec_threshold,
-					"cachedb_local fetch_counter",attr->s,attr->len,0,
-					cdb_slow_queries, cdb_total_queries);
-				return -3;
-			}
+	idx = lcache_read_lock(cache_col);
+
+	it = lcache_lookup(&cache_htable[hash_code], attr);
+	if (!it || (it->expires != 0 && it->expires < get_ticks())) {
+		ret = -2;
+	} else {
+		if (str2sint(&it->value,&cnt) != 0) {
+			LM_ERR("Not a counter key\n");
+			ret = -3;
+		} else {
 			if (val)
-				*val = ret;
-			lock_release(&cache_htable[hash_code].lock);
-			_stop_expire_timer(start,local_exec_threshold,
-				"cachedb_local fetch_counter",attr->s,attr->len,0,
-				cdb_slow_queries, cdb_total_queries);
-			return 1;
+				*val = cnt;
+			ret = 1;
 		}
 
-		it_aux = it;
-		it = it->next;
+		if (!it->referenced)
+			it->referenced = 1;
 	}
 
-	lock_release(&cache_htable[hash_code].lock);
+	lcache_read_unlock(cache_col, idx);
+
+	if (ret == -2)
+		update_stat(cache_col->misses, 1);
+	else
+		update_stat(cache_col->hits, 1);
+
 	_stop_expire_timer(start,local_exec_threshold,
 		"cachedb_local fetch_counter",attr->s,attr->len,0,
 		cdb_slow_queries, cdb_total_queries);
-	return -2;
+	return ret;
 }
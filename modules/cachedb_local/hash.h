@@ -32,24 +32,74 @@
 #include "../../lock_ops.h"
 #include "../../cachedb/cachedb.h"
 
+/* number of one second slots of the expiry timing wheel; the entries
+ * expiring further away just wait for more wheel rotations */
+#define LCACHE_WHEEL_SIZE 1024
+
 typedef struct lcache_entry
 {
 	str attr;
 	str value;
 	unsigned int expires;
+	/* size of the shm chunk, for the collection memory accounting */
+	unsigned int size;
+	/* set on each lookup, cleared by the CLOCK eviction hand */
+	volatile unsigned char referenced;
 	struct lcache_entry* next;
+	/* the timing wheel slot of the entry, if expiring */
+	struct lcache_entry* wheel_prev;
+	struct lcache_entry* wheel_next;
 }lcache_entry_t;
 
 
+/* the bucket chains are read without locking; the writers (holding the
+ * bucket lock) only publish fully built entries and the unlinked entries
+ * are released only after all the readers which could still see them
+ * are done (see lcache_read_lock()) */
 typedef struct lcache
 {
-	lcache_entry_t* entries;
+	lcache_entry_t* volatile entries;
 	gen_lock_t lock;
 }lcache_t;
 
+typedef struct lcache_wheel_slot
+{
+	lcache_entry_t* entries;
+	gen_lock_t lock;
+}lcache_wheel_slot_t;
+
+/* deferred release of the unlinked entries: the readers register with
+ * the counter of the current epoch; on each reclaim run, the entries
+ * retired so far wait for the readers of the current epoch to drain,
+ * while the new readers already count on the next epoch */
+typedef struct lcache_rcu
+{
+	volatile unsigned int epoch;
+	volatile int readers[2];
+	gen_lock_t lock;
+	/* unlinked entries, waiting for the next epoch switch */
+	lcache_entry_t* retired;
+	/* entries waiting for the readers of epoch "grace_epoch" to drain */
+	lcache_entry_t* grace;
+	unsigned int grace_epoch;
+}lcache_rcu_t;
+
+struct lcache_col;
 
 int lcache_htable_init(lcache_t** cache_htable_p, int size);
-void lcache_htable_destroy();
+void lcache_htable_destroy(lcache_t** cache_htable_p, int size);
+int lcache_col_init(struct lcache_col *col);
+void lcache_col_destroy(struct lcache_col *col);
+
+unsigned int lcache_read_lock(struct lcache_col *col);
+void lcache_read_unlock(struct lcache_col *col, unsigned int idx);
+
+/* unlinks an entry from the bucket chain link it is pointed by; must be
+ * called under the bucket lock */
+void lcache_unlink_entry(struct lcache_col *col, lcache_entry_t **link);
+
+void lcache_expire_col(struct lcache_col *col, unsigned int now);
+void lcache_reclaim_col(struct lcache_col *col);
 int lcache_htable_insert(cachedb_con *con,str* attr, str* value, int expires);
 int lcache_htable_remove(cachedb_con *con,str* attr);
 int lcache_htable_fetch(cachedb_con *con,str* attr, str* val);
@@ -76,6 +76,8 @@ mem_server * servers;
 static param_export_t params[]={
 	{"cachedb_url",        STR_PARAM|USE_FUNC_PARAM, (void*)&mc_set_connection },
 	{"exec_threshold",     INT_PARAM,                &memcache_exec_threshold  },
+	{"async_connections",  INT_PARAM,                &memcache_async_connections },
+	{"async_timeout",      INT_PARAM,                &memcache_async_timeout   },
 	{0,0,0}
 };
 
@@ -450,6 +452,7 @@ void memcached_free_connection(cachedb_pool_con *con)
 	if (!con) return;
 	c = (memcached_con *)con;
 
+	memcached_async_free_cons(c);
 	memcached_free(c->memc);
 }
 
@@ -479,6 +482,13 @@ static int mod_init(void)
 	cde.cdb_func.remove = wrap_memcached_remove;
 	cde.cdb_func.add = wrap_memcached_add;
 	cde.cdb_func.sub = wrap_memcached_sub;
+#ifdef MEMCACHED_ASYNC
+	cde.cdb_func.async_get = memcached_async_get;
+	cde.cdb_func.async_set = memcached_async_set;
+	cde.cdb_func.async_add = memcached_async_add;
+	cde.cdb_func.async_sub = memcached_async_sub;
+	cde.cdb_func.async_resume = memcached_async_resume;
+#endif
 
 	cde.cdb_func.capability = CACHEDB_CAP_BINARY_VALUE;
 
@@ -5,12 +5,43 @@
 #include "../../cachedb/cachedb.h"
 #include "../../cachedb/cachedb_cap.h"
 
+/* the async queries need to know the server of each key */
+#if defined(LIBMEMCACHED_VERSION_HEX) && LIBMEMCACHED_VERSION_HEX >= 0x00049000
+#define MEMCACHED_ASYNC
+#endif
+
+/* a connection dedicated to the async queries, serving one at a time */
+struct mc_async_con {
+	char *host;
+	unsigned short port;
+	int fd;
+	int busy;
+	struct mc_async_con *next;
+};
+
 typedef struct {
 	struct cachedb_id *id;
 	unsigned int ref;
 	struct cachedb_pool_con_t *next;
 
 	memcached_st *memc;
+
+	/* opened on demand, up to "async_connections" per server */
+	struct mc_async_con *async_cons;
 } memcached_con;
 
+extern int memcache_async_connections;
+extern int memcache_async_timeout;
+
+int memcached_async_get(cachedb_con *con, str *attr, void **priv);
+int memcached_async_set(cachedb_con *con, str *attr, str *val, int expires,
+		void **priv);
+int memcached_async_add(cachedb_con *con, str *attr, int val, int expires,
+		void **priv);
+int memcached_async_sub(cachedb_con *con, str *attr, int val, int expires,
+		void **priv);
+int memcached_async_resume(cachedb_con *con, int fd, cdb_async_res *res,
+		void *priv);
+void memcached_async_free_cons(memcached_con *con);
+
 #endif /* CACHEDB_MEMCACHEDH */
@@ -0,0 +1,560 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Asynchronous queries (cachedb async API)
+ *
+ * libmemcached only offers blocking calls, so the async queries are done
+ * over separate connections to the server which libmemcached would pick
+ * for the key, by speaking the memcached text protocol directly. Each of
+ * these connections serves a single query at a time; if all of them are
+ * busy, the query is done in sync mode, through libmemcached.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+#include "../../dprint.h"
+#include "../../mem/mem.h"
+#include "../../async.h"
+#include "../../ut.h"
+
+#include "cachedb_memcached.h"
+
+int memcache_async_connections = 10;
+int memcache_async_timeout = 2000;
+
+#ifdef MEMCACHED_ASYNC
+
+/* the longest key accepted by the memcached text protocol */
+#define MC_MAX_KEY_LEN 250
+#define MC_READ_CHUNK  1024
+
+enum mc_async_op {
+	MC_ASYNC_GET,
+	MC_ASYNC_SET,
+	MC_ASYNC_INCR,
+	MC_ASYNC_DECR,
+};
+
+struct mc_async_query {
+	enum mc_async_op op;
+	struct mc_async_con *acon;
+
+	/* incr/decr: the initial value and expiry of a missing counter */
+	int val;
+	int expires;
+	int inserting;
+
+	/* reply, as read so far */
+	char *buf;
+	int len;
+	int size;
+
+	str key;
+};
+
+
+static void mc_async_drop_con(memcached_con *con, struct mc_async_con *acon)
+{
+	struct mc_async_con **it;
+
+	for (it = &con->async_cons; *it; it = &(*it)->next)
+		if (*it == acon) {
+			*it = acon->next;
+			break;
+		}
+
+	close(acon->fd);
+	pkg_free(acon);
+}
+
+void memcached_async_free_cons(memcached_con *con)
+{
+	while (con->async_cons)
+		mc_async_drop_con(con, con->async_cons);
+}
+
+static int mc_async_connect(const char *host, unsigned short port)
+{
+	struct addrinfo hints, *res, *ai;
+	struct pollfd pfd;
+	char port_s[8];
+	socklen_t optlen;
+	int fd = -1, flags = 0, err, rc;
+
+	memset(&hints, 0, sizeof hints);
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	sprintf(port_s, "%hu", port);
+
+	rc = getaddrinfo(host, port_s, &hints, &res);
+	if (rc != 0) {
+		LM_ERR("failed to resolve %s - %s\n", host, gai_strerror(rc));
+		return -1;
+	}
+
+	for (ai = res; ai; ai = ai->ai_next) {
+		fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (fd < 0)
+			continue;
+
+		/* do not block the worker for longer than the async timeout */
+		flags = fcntl(fd, F_GETFL);
+		if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+			goto next;
+
+		if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+			goto connected;
+
+		if (errno == EINPROGRESS) {
+			pfd.fd = fd;
+			pfd.events = POLLOUT;
+			optlen = sizeof err;
+			if (poll(&pfd, 1, memcache_async_timeout) == 1 &&
+			        getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &optlen) == 0 &&
+			        err == 0)
+				goto connected;
+		}
+
+next:
+		close(fd);
+		fd = -1;
+	}
+
+	freeaddrinfo(res);
+	LM_ERR("failed to connect to %s:%hu\n", host, port);
+	return -1;
+
+connected:
+	freeaddrinfo(res);
+
+	/* the requests are small enough to be written at once, while the
+	 * replies are only read once available */
+	if (fcntl(fd, F_SETFL, flags) < 0) {
+		LM_ERR("failed to set the socket back in blocking mode (%d)\n", errno);
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+/* returns an idle async connection to the server of @key, opening a new one
+ * if needed, or NULL if none is available */
+static struct mc_async_con *mc_async_get_con(memcached_con *con, str *key)
+{
+	memcached_server_instance_st srv;
+	memcached_return_t rc;
+	struct mc_async_con *acon;
+	const char *host;
+	unsigned short port;
+	int n = 0, host_len;
+
+	srv = memcached_server_by_key(con->memc, key->s, key->len, &rc);
+	if (!srv) {
+		LM_ERR("no server for %.*s: %s\n", key->len, key->s,
+			memcached_strerror(con->memc, rc));
+		return NULL;
+	}
+
+	host = memcached_server_name(srv);
+	port = memcached_server_port(srv);
+
+	for (acon = con->async_cons; acon; acon = acon->next) {
+		if (acon->port != port || strcmp(acon->host, host))
+			continue;
+
+		if (!acon->busy)
+			return acon;
+		n++;
+	}
+
+	if (n >= memcache_async_connections) {
+		LM_DBG("all the %d async connections to %s:%hu are busy\n",
+			n, host, port);
+		return NULL;
+	}
+
+	host_len = strlen(host);
+	acon = pkg_malloc(sizeof *acon + host_len + 1);
+	if (!acon) {
+		LM_ERR("no more pkg memory\n");
+		return NULL;
+	}
+	memset(acon, 0, sizeof *acon);
+
+	acon->host = (char *)(acon + 1);
+	memcpy(acon->host, host, host_len + 1);
+	acon->port = port;
+
+	acon->fd = mc_async_connect(host, port);
+	if (acon->fd < 0) {
+		pkg_free(acon);
+		return NULL;
+	}
+
+	acon->next = con->async_cons;
+	con->async_cons = acon;
+
+	LM_DBG("opened async connection #%d to %s:%hu\n", n + 1, host, port);
+	return acon;
+}
+
+static int mc_async_write(struct mc_async_con *acon, char *buf, int len)
+{
+	int n;
+
+	while (len > 0) {
+		n = write(acon->fd, buf, len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			LM_INFO("failed to write to %s:%hu (%d)\n", acon->host,
+				acon->port, errno);
+			return -1;
+		}
+
+		buf += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+/* "set" request, also used for the missing counters */
+static int mc_async_send_set(struct mc_async_con *acon, str *key, str *val,
+		int expires)
+{
+	char *buf;
+	int len, rc;
+
+	buf = pkg_malloc(key->len + val->len + 64);
+	if (!buf) {
+		LM_ERR("no more pkg memory\n");
+		return -1;
+	}
+
+	len = sprintf(buf, "set %.*s 0 %d %d\r\n", key->len, key->s, expires,
+		val->len);
+	memcpy(buf + len, val->s, val->len);
+	len += val->len;
+	memcpy(buf + len, "\r\n", 2);
+	len += 2;
+
+	rc = mc_async_write(acon, buf, len);
+	pkg_free(buf);
+
+	return rc;
+}
+
+/*
+ * Sends the request over an idle async connection to the server of @key.
+ *
+ * Returns the fd to watch for the reply, -2 if the query should rather be
+ * done in sync mode or -1 on error
+ */
+static int mc_async_send(cachedb_con *connection, str *key,
+		enum mc_async_op op, str *val, int n, int expires, void **priv)
+{
+	memcached_con *con = (memcached_con *)connection->data;
+	struct mc_async_query *q;
+	char line[MC_MAX_KEY_LEN + 64];
+	int i, len, rc;
+
+	/* leave the keys we cannot put on a text protocol line to libmemcached */
+	if (key->len > MC_MAX_KEY_LEN)
+		return -2;
+	for (i = 0; i < key->len; i++)
+		if ((unsigned char)key->s[i] <= ' ' || key->s[i] == 0x7f)
+			return -2;
+
+	q = pkg_malloc(sizeof *q + key->len);
+	if (!q) {
+		LM_ERR("no more pkg memory\n");
+		return -1;
+	}
+	memset(q, 0, sizeof *q);
+
+	q->op = op;
+	q->val = n;
+	q->expires = expires;
+	q->key.s = (char *)(q + 1);
+	q->key.len = key->len;
+	memcpy(q->key.s, key->s, key->len);
+
+	q->acon = mc_async_get_con(con, key);
+	if (!q->acon) {
+		pkg_free(q);
+		return -2;
+	}
+
+	switch (op) {
+	case MC_ASYNC_GET:
+		len = sprintf(line, "get %.*s\r\n", key->len, key->s);
+		rc = mc_async_write(q->acon, line, len);
+		break;
+	case MC_ASYNC_SET:
+		rc = mc_async_send_set(q->acon, key, val, expires);
+		break;
+	default:
+		/* the same as libmemcached does, the offset is unsigned */
+		len = sprintf(line, "%s %.*s %u\r\n", op == MC_ASYNC_INCR ?
+			"incr" : "decr", key->len, key->s, (unsigned int)n);
+		rc = mc_async_write(q->acon, line, len);
+		break;
+	}
+
+	if (rc < 0) {
+		/* most likely, a broken connection - let libmemcached handle it */
+		mc_async_drop_con(con, q->acon);
+		pkg_free(q);
+		return -2;
+	}
+
+	q->acon->busy = 1;
+	*priv = q;
+
+	return q->acon->fd;
+}
+
+int memcached_async_get(cachedb_con *con, str *attr, void **priv)
+{
+	return mc_async_send(con, attr, MC_ASYNC_GET, NULL, 0, 0, priv);
+}
+
+int memcached_async_set(cachedb_con *con, str *attr, str *val, int expires,
+		void **priv)
+{
+	return mc_async_send(con, attr, MC_ASYNC_SET, val, 0, expires, priv);
+}
+
+int memcached_async_add(cachedb_con *con, str *attr, int val, int expires,
+		void **priv)
+{
+	return mc_async_send(con, attr, MC_ASYNC_INCR, NULL, val, expires, priv);
+}
+
+int memcached_async_sub(cachedb_con *con, str *attr, int val, int expires,
+		void **priv)
+{
+	return mc_async_send(con, attr, MC_ASYNC_DECR, NULL, val, expires, priv);
+}
+
+/* returns the length of the first line of the reply (without the CRLF)
+ * or -1 if not fully read yet */
+static int mc_async_line(char *buf, int len)
+{
+	int i;
+
+	for (i = 0; i + 1 < len; i++)
+		if (buf[i] == '\r' && buf[i + 1] == '\n')
+			return i;
+
+	return -1;
+}
+
+#define mc_line_is(_s, _len, _c) \
+	((_len) == sizeof(_c) - 1 && !memcmp(_s, _c, sizeof(_c) - 1))
+
+/*
+ * Parses the reply read so far; returns 1 once complete (@res populated),
+ * 0 if more data is expected or -1 on error
+ */
+static int mc_async_parse(struct mc_async_query *q, cdb_async_res *res)
+{
+	str hdr, tok;
+	char *p, *end;
+	int line, bytes, i;
+
+	line = mc_async_line(q->buf, q->len);
+	if (line < 0)
+		return 0;
+
+	switch (q->op) {
+	case MC_ASYNC_GET:
+		if (mc_line_is(q->buf, line, "END")) {
+			LM_DBG("no such key - %.*s\n", q->key.len, q->key.s);
+			res->rc = -2;
+			return 1;
+		}
+
+		if (line < 6 || memcmp(q->buf, "VALUE ", 6))
+			goto error;
+
+		/* VALUE <key> <flags> <bytes> [<cas unique>] */
+		hdr.s = q->buf + 6;
+		hdr.len = line - 6;
+		end = hdr.s + hdr.len;
+		for (i = 0, p = hdr.s; i < 3; i++, p++) {
+			tok.s = p;
+			while (p < end && *p != ' ')
+				p++;
+			tok.len = p - tok.s;
+		}
+		if (str2sint(&tok, &bytes) < 0 || bytes < 0)
+			goto error;
+
+		/* the data block, then "END\r\n" */
+		if (q->len < line + 2 + bytes + 2 + 5)
+			return 0;
+
+		if (bytes) {
+			res->val.s = pkg_malloc(bytes);
+			if (!res->val.s) {
+				LM_ERR("no more pkg memory\n");
+				res->rc = -1;
+				return -1;
+			}
+			memcpy(res->val.s, q->buf + line + 2, bytes);
+			res->val.len = bytes;
+		}
+
+		res->rc = 0;
+		return 1;
+
+	case MC_ASYNC_SET:
+		if (!mc_line_is(q->buf, line, "STORED"))
+			goto error;
+
+		res->rc = 0;
+		return 1;
+
+	default:
+		if (q->inserting) {
+			if (!mc_line_is(q->buf, line, "STORED"))
+				goto error;
+
+			res->new_val = q->val;
+			res->rc = 0;
+			return 1;
+		}
+
+		if (mc_line_is(q->buf, line, "NOT_FOUND")) {
+			/* the same as the sync add/sub, start a new counter */
+			tok.s = sint2str(q->val, &tok.len);
+			if (mc_async_send_set(q->acon, &q->key, &tok, q->expires) < 0)
+				return -1;
+
+			q->inserting = 1;
+			q->len = 0;
+			return 0;
+		}
+
+		tok.s = q->buf;
+		tok.len = line;
+		if (str2sint(&tok, &res->new_val) < 0)
+			goto error;
+
+		res->rc = 0;
+		return 1;
+	}
+
+error:
+	LM_ERR("async query for %.*s failed - %.*s\n", q->key.len, q->key.s,
+		line, q->buf);
+	res->rc = -1;
+	return -1;
+}
+
+int memcached_async_resume(cachedb_con *connection, int fd,
+		cdb_async_res *res, void *priv)
+{
+	struct mc_async_query *q = (struct mc_async_query *)priv;
+	struct pollfd pfd;
+	char *buf;
+	int rc, n;
+
+	/* only relevant if resumed in sync mode, outside the reactor */
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	rc = poll(&pfd, 1, memcache_async_timeout);
+	if (rc < 0 && errno == EINTR) {
+		async_status = ASYNC_CONTINUE;
+		return 0;
+	} else if (rc <= 0) {
+		LM_ERR("async query to %s:%hu timed out\n", q->acon->host,
+			q->acon->port);
+		goto drop;
+	}
+
+	if (q->size - q->len < MC_READ_CHUNK) {
+		n = q->size ? 2 * q->size : MC_READ_CHUNK;
+		buf = pkg_realloc(q->buf, n);
+		if (!buf) {
+			LM_ERR("no more pkg memory\n");
+			goto drop;
+		}
+		q->buf = buf;
+		q->size = n;
+	}
+
+	do {
+		n = read(fd, q->buf + q->len, q->size - q->len);
+	} while (n < 0 && errno == EINTR);
+
+	if (n <= 0) {
+		LM_ERR("failed to read from %s:%hu (%d)\n", q->acon->host,
+			q->acon->port, n < 0 ? errno : 0);
+		goto drop;
+	}
+	q->len += n;
+
+	rc = mc_async_parse(q, res);
+	if (rc == 0) {
+		async_status = ASYNC_CONTINUE;
+		return 0;
+	} else if (rc < 0) {
+		goto drop;
+	}
+
+	q->acon->busy = 0;
+	rc = 0;
+	goto out;
+
+drop:
+	/* the replies of this connection are out of sync now */
+	mc_async_drop_con((memcached_con *)connection->data, q->acon);
+	if (res->rc >= 0)
+		res->rc = -1;
+	rc = -1;
+
+out:
+	if (q->buf)
+		pkg_free(q->buf);
+	pkg_free(q);
+
+	async_status = ASYNC_DONE;
+	return rc;
+}
+
+#else
+
+void memcached_async_free_cons(memcached_con *con)
+{
+}
+
+#endif
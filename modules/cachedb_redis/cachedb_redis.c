@@ -39,6 +39,8 @@
 #include "../../cachedb/cachedb.h"
 
 #include "cachedb_redis_dbase.h"
+#include "cachedb_redis_tracking.h"
+#include "cachedb_redis_async.h"
 
 static int mod_init(void);
 static int child_init(int);
@@ -58,6 +60,17 @@ static param_export_t params[]={
 	{ "shutdown_on_error",           INT_PARAM,                &shutdown_on_error     },
 	{ "cachedb_url",                 STR_PARAM|USE_FUNC_PARAM, (void *)&set_connection},
 	{ "use_tls",                     INT_PARAM,                &use_tls},
+	{ "client_cache",                INT_PARAM,                &redis_client_cache},
+	{ "client_cache_size",           INT_PARAM,                &redis_client_cache_size},
+	{ "client_cache_ttl",            INT_PARAM,                &redis_client_cache_ttl},
+	{ "async_connections",           INT_PARAM,                &redis_async_connections},
+	{0,0,0}
+};
+
+static stat_export_t mod_stats[] = {
+	{"client_cache_hits",          0, &redis_cc_hits         },
+	{"client_cache_misses",        0, &redis_cc_misses       },
+	{"client_cache_invalidations", 0, &redis_cc_invalidations},
 	{0,0,0}
 };
 
@@ -99,7 +112,7 @@ struct module_exports exports= {
 	0,						/* exported functions */
 	0,						/* exported async functions */
 	params,						/* exported parameters */
-	0,							/* exported statistics */
+	mod_stats,					/* exported statistics */
 	0,							/* exported MI functions */
 	0,							/* exported pseudo-variables */
 	0,							/* exported transformations */
@@ -137,6 +150,12 @@ static int mod_init(void)
 	cde.cdb_func.map_get = redis_map_get;
 	cde.cdb_func.map_set = redis_map_set;
 	cde.cdb_func.map_remove = redis_map_remove;
+	cde.cdb_func.async_get = redis_async_get;
+	cde.cdb_func.async_set = redis_async_set;
+	cde.cdb_func.async_add = redis_async_add;
+	cde.cdb_func.async_sub = redis_async_sub;
+	cde.cdb_func.async_raw_query = redis_async_raw_query;
+	cde.cdb_func.async_resume = redis_async_resume;
 
 	cde.cdb_func.capability = 0;
 
@@ -153,6 +172,18 @@ static int mod_init(void)
 		use_tls = 0;
 	}
 #endif
+#ifndef HAVE_REDIS_RESP3
+	if (redis_client_cache) {
+		LM_WARN("the client-side cache requires libhiredis 1.0.0+ (RESP3 "
+			"support), disabling it\n");
+		redis_client_cache = 0;
+	}
+#endif
+	if (redis_client_cache && redis_client_cache_size <= 0) {
+		LM_ERR("invalid client_cache_size: %d\n", redis_client_cache_size);
+		return -1;
+	}
+
 	if (use_tls && load_tls_mgm_api(&tls_api) != 0) {
 		LM_ERR("failed to load tls_mgm API!\n");
 		return -1;
@@ -0,0 +1,455 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+
+#include "../../dprint.h"
+#include "../../mem/mem.h"
+#include "../../async.h"
+#include "cachedb_redis_async.h"
+#include "cachedb_redis_utils.h"
+#include "cachedb_redis_tracking.h"
+
+int redis_async_connections = 10;
+
+enum redis_async_op {
+	REDIS_ASYNC_GET,
+	REDIS_ASYNC_SET,
+	REDIS_ASYNC_COUNTER,
+	REDIS_ASYNC_RAW,
+};
+
+struct redis_async_query {
+	enum redis_async_op op;
+	cluster_node *node;
+	redis_async_con *acon;
+
+	/* replies still expected (the EXPIRE one, if any, comes last) */
+	int pending;
+	redisReply *reply;
+
+	int num_cols;
+	str key;
+};
+
+
+static void redis_async_drop_con(cluster_node *node, redis_async_con *acon)
+{
+	redis_async_con **it;
+
+	for (it = &node->async_cons; *it; it = &(*it)->next)
+		if (*it == acon) {
+			*it = acon->next;
+			break;
+		}
+
+	redisFree(acon->ctx);
+	pkg_free(acon);
+}
+
+void redis_async_free_cons(cluster_node *node)
+{
+	while (node->async_cons)
+		redis_async_drop_con(node, node->async_cons);
+}
+
+/* returns an idle async connection to the node, opening a new one if
+ * needed, or NULL if none is available */
+static redis_async_con *redis_async_get_con(redis_con *con,
+		cluster_node *node)
+{
+	redis_async_con *acon;
+	int n = 0;
+
+	for (acon = node->async_cons; acon; acon = acon->next, n++)
+		if (!acon->busy)
+			return acon;
+
+	if (n >= redis_async_connections) {
+		LM_DBG("all the %d async connections to %s:%hu are busy\n",
+			n, node->ip, node->port);
+		return NULL;
+	}
+
+	acon = pkg_malloc(sizeof *acon);
+	if (!acon) {
+		LM_ERR("no more pkg memory\n");
+		return NULL;
+	}
+	memset(acon, 0, sizeof *acon);
+
+	acon->ctx = redis_get_ctx(node->ip, node->port);
+	if (!acon->ctx)
+		goto error;
+
+	if (redis_prepare_ctx(con, acon->ctx) < 0) {
+		redisFree(acon->ctx);
+		goto error;
+	}
+
+	acon->next = node->async_cons;
+	node->async_cons = acon;
+
+	LM_DBG("opened async connection #%d to %s:%hu\n", n + 1,
+		node->ip, node->port);
+	return acon;
+
+error:
+	pkg_free(acon);
+	return NULL;
+}
+
+/*
+ * Writes the command (and an "EXPIRE @key @expires", if required) over an
+ * idle async connection of the node serving @key.
+ *
+ * Returns the fd to watch for the reply, -2 if the query should rather be
+ * done in sync mode (no connection available) or -1 on error
+ */
+static int redis_async_send(cachedb_con *connection, str *key,
+		enum redis_async_op op, int expires, void **priv,
+		const char *cmd_fmt, ...)
+{
+	redis_con *con = ((redis_con *)connection->data)->current;
+	struct redis_async_query *q;
+	cluster_node *node;
+	int done = 0, rc;
+	va_list ap;
+
+	/* let the sync queries handle the (re)connects and the failover */
+	if (!(con->flags & REDIS_INIT_NODES))
+		return -2;
+
+#ifdef HAVE_REDIS_SSL
+	if (use_tls && con->id->extra_options)
+		return -2;
+#endif
+
+	node = get_redis_connection(con, key);
+	if (!node) {
+		LM_ERR("Bad cluster configuration\n");
+		return -1;
+	}
+
+	q = pkg_malloc(sizeof *q + key->len);
+	if (!q) {
+		LM_ERR("no more pkg memory\n");
+		return -1;
+	}
+	memset(q, 0, sizeof *q);
+
+	q->op = op;
+	q->node = node;
+	q->key.s = (char *)(q + 1);
+	q->key.len = key->len;
+	memcpy(q->key.s, key->s, key->len);
+
+	q->acon = redis_async_get_con(con, node);
+	if (!q->acon)
+		goto sync;
+
+	va_start(ap, cmd_fmt);
+	rc = redisvAppendCommand(q->acon->ctx, cmd_fmt, ap);
+	va_end(ap);
+	if (rc != REDIS_OK)
+		goto drop;
+	q->pending = 1;
+
+	if (expires) {
+		if (redisAppendCommand(q->acon->ctx, "EXPIRE %b %d",
+		        key->s, (size_t)key->len, expires) != REDIS_OK)
+			goto drop;
+		q->pending++;
+	}
+
+	/* the commands are small, they are written right away */
+	do {
+		if (redisBufferWrite(q->acon->ctx, &done) != REDIS_OK)
+			goto drop;
+	} while (!done);
+
+	q->acon->busy = 1;
+	*priv = q;
+
+	return q->acon->ctx->fd;
+
+drop:
+	/* most likely, a broken connection - the sync query will reconnect */
+	LM_INFO("failed to send async query to %s:%hu - %s\n", node->ip,
+		node->port, q->acon->ctx->errstr);
+	redis_async_drop_con(node, q->acon);
+sync:
+	pkg_free(q);
+	return -2;
+}
+
+int redis_async_get(cachedb_con *connection, str *attr, void **priv)
+{
+	redis_con *con = ((redis_con *)connection->data)->current;
+
+	if (!attr || !connection) {
+		LM_ERR("null parameter\n");
+		return -1;
+	}
+
+	/* the async connections do not track the keys they read, so they are
+	 * not cached; however, if already cached, the sync GET is instant */
+	if (redis_cc_active(con->cc)) {
+		redis_cc_poll(con);
+		if (redis_cc_cached(con->cc, attr))
+			return -2;
+	}
+
+	return redis_async_send(connection, attr, REDIS_ASYNC_GET, 0, priv,
+		"GET %b", attr->s, (size_t)attr->len);
+}
+
+int redis_async_set(cachedb_con *connection, str *attr, str *val,
+		int expires, void **priv)
+{
+	if (!attr || !val || !connection) {
+		LM_ERR("null parameter\n");
+		return -1;
+	}
+
+	redis_cc_invalidate(((redis_con *)connection->data)->cc, attr);
+
+	if (expires)
+		return redis_async_send(connection, attr, REDIS_ASYNC_SET, 0, priv,
+			"SET %b %b EX %d", attr->s, (size_t)attr->len, val->s,
+			(size_t)val->len, expires);
+
+	return redis_async_send(connection, attr, REDIS_ASYNC_SET, 0, priv,
+		"SET %b %b", attr->s, (size_t)attr->len, val->s, (size_t)val->len);
+}
+
+int redis_async_add(cachedb_con *connection, str *attr, int val,
+		int expires, void **priv)
+{
+	if (!attr || !connection) {
+		LM_ERR("null parameter\n");
+		return -1;
+	}
+
+	redis_cc_invalidate(((redis_con *)connection->data)->cc, attr);
+
+	return redis_async_send(connection, attr, REDIS_ASYNC_COUNTER, expires,
+		priv, "INCRBY %b %d", attr->s, (size_t)attr->len, val);
+}
+
+int redis_async_sub(cachedb_con *connection, str *attr, int val,
+		int expires, void **priv)
+{
+	if (!attr || !connection) {
+		LM_ERR("null parameter\n");
+		return -1;
+	}
+
+	redis_cc_invalidate(((redis_con *)connection->data)->cc, attr);
+
+	return redis_async_send(connection, attr, REDIS_ASYNC_COUNTER, expires,
+		priv, "DECRBY %b %d", attr->s, (size_t)attr->len, val);
+}
+
+int redis_async_raw_query(cachedb_con *connection, str *attr, int num_cols,
+		void **priv)
+{
+	static str attr_nt;
+	str query_key;
+	int fd;
+
+	if (!attr || !connection) {
+		LM_ERR("null parameter\n");
+		return -1;
+	}
+
+	if (redis_raw_query_extract_key(attr, &query_key) < 0) {
+		LM_ERR("Failed to extract Redis raw query key\n");
+		return -1;
+	}
+
+	if (pkg_str_extend(&attr_nt, attr->len + 1) < 0) {
+		LM_ERR("oom\n");
+		return -1;
+	}
+
+	memcpy(attr_nt.s, attr->s, attr->len);
+	attr_nt.s[attr->len] = '\0';
+
+	/* the query might change the key */
+	redis_cc_invalidate(((redis_con *)connection->data)->cc, &query_key);
+
+	fd = redis_async_send(connection, &query_key, REDIS_ASYNC_RAW, 0, priv,
+		attr_nt.s);
+	if (fd >= 0)
+		((struct redis_async_query *)*priv)->num_cols = num_cols;
+
+	return fd;
+}
+
+/* populates @res out of the reply, the same as the sync functions do */
+static int redis_async_result(struct redis_async_query *q,
+		cdb_async_res *res)
+{
+	redisReply *reply = q->reply;
+
+	if (reply->type == REDIS_REPLY_ERROR) {
+		LM_ERR("Redis async query failed - %.*s\n",
+			(unsigned)reply->len, reply->str);
+		res->rc = -1;
+		return -1;
+	}
+
+	switch (q->op) {
+	case REDIS_ASYNC_GET:
+		if (reply->type == REDIS_REPLY_NIL) {
+			LM_DBG("no such key - %.*s\n", q->key.len, q->key.s);
+			res->rc = -2;
+			break;
+		}
+
+		if (reply->str && reply->len) {
+			res->val.s = pkg_malloc(reply->len);
+			if (!res->val.s) {
+				LM_ERR("no more pkg\n");
+				res->rc = -1;
+				return -1;
+			}
+			memcpy(res->val.s, reply->str, reply->len);
+			res->val.len = reply->len;
+		}
+		res->rc = 0;
+		break;
+
+	case REDIS_ASYNC_SET:
+		res->rc = 0;
+		break;
+
+	case REDIS_ASYNC_COUNTER:
+		res->new_val = reply->integer;
+		res->rc = 0;
+		break;
+
+	case REDIS_ASYNC_RAW:
+		switch (reply->type) {
+		case REDIS_REPLY_NIL:
+			res->rc = -2;
+			break;
+		case REDIS_REPLY_STATUS:
+			res->num_rows = 0;
+			res->rc = 1;
+			break;
+		default:
+			if (q->num_cols <= 0) {
+				res->rc = 1;
+				break;
+			}
+
+			/* the reply is consumed */
+			q->reply = NULL;
+			res->rc = redis_raw_query_handle_reply(reply, &res->reply,
+				q->num_cols, &res->num_rows);
+			if (res->rc < 0)
+				return -1;
+		}
+		break;
+	}
+
+	return 0;
+}
+
+int redis_async_resume(cachedb_con *connection, int fd, cdb_async_res *res,
+		void *priv)
+{
+	struct redis_async_query *q = (struct redis_async_query *)priv;
+	redisContext *ctx = q->acon->ctx;
+	struct pollfd pfd;
+	void *reply;
+	int rc;
+
+	/* only relevant if resumed in sync mode, outside the reactor */
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	rc = poll(&pfd, 1, redis_query_tout ? redis_query_tout : -1);
+	if (rc < 0 && errno == EINTR) {
+		async_status = ASYNC_CONTINUE;
+		return 0;
+	} else if (rc <= 0) {
+		LM_ERR("async query to %s:%hu timed out\n", q->node->ip,
+			q->node->port);
+		goto drop;
+	}
+
+	if (redisBufferRead(ctx) != REDIS_OK) {
+		LM_ERR("failed to read from %s:%hu - %s\n", q->node->ip,
+			q->node->port, ctx->errstr);
+		goto drop;
+	}
+
+	while (q->pending) {
+		reply = NULL;
+		if (redisGetReplyFromReader(ctx, &reply) != REDIS_OK) {
+			LM_ERR("bad reply from %s:%hu - %s\n", q->node->ip,
+				q->node->port, ctx->errstr);
+			goto drop;
+		}
+		if (!reply)
+			break;
+
+		q->pending--;
+		if (!q->reply) {
+			q->reply = reply;
+			continue;
+		}
+
+		/* the EXPIRE reply */
+		if (((redisReply *)reply)->type == REDIS_REPLY_ERROR)
+			LM_ERR("failed to set %.*s to expire - %.*s\n", q->key.len,
+				q->key.s, (unsigned)((redisReply *)reply)->len,
+				((redisReply *)reply)->str);
+		freeReplyObject(reply);
+	}
+
+	if (q->pending) {
+		async_status = ASYNC_CONTINUE;
+		return 0;
+	}
+
+	rc = redis_async_result(q, res);
+
+	q->acon->busy = 0;
+	goto out;
+
+drop:
+	/* the replies of this connection are out of sync now */
+	redis_async_drop_con(q->node, q->acon);
+	res->rc = -1;
+	rc = -1;
+
+out:
+	if (q->reply)
+		freeReplyObject(q->reply);
+	pkg_free(q);
+
+	async_status = ASYNC_DONE;
+	return rc;
+}
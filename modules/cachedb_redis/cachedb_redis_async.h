@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Asynchronous queries (cachedb async API): the query is written over a
+ * connection of the target node which is dedicated to the async queries
+ * and, once its fd becomes readable, the reply is read without blocking.
+ *
+ * As the regular connection of the node may be used by other scripts while
+ * the async query is in progress, each node gets its own set of async
+ * connections, opened on demand, each serving a single query at a time.
+ * If all of them are busy, the query is done in sync mode.
+ */
+
+#ifndef CACHEDB_REDIS_ASYNC_H
+#define CACHEDB_REDIS_ASYNC_H
+
+#include "../../cachedb/cachedb.h"
+#include "cachedb_redis_dbase.h"
+
+extern int redis_async_connections;
+
+typedef struct redis_async_con {
+	redisContext *ctx;
+	int busy;
+	struct redis_async_con *next;
+} redis_async_con;
+
+int redis_async_get(cachedb_con *con, str *attr, void **priv);
+int redis_async_set(cachedb_con *con, str *attr, str *val, int expires,
+		void **priv);
+int redis_async_add(cachedb_con *con, str *attr, int val, int expires,
+		void **priv);
+int redis_async_sub(cachedb_con *con, str *attr, int val, int expires,
+		void **priv);
+int redis_async_raw_query(cachedb_con *con, str *query, int num_cols,
+		void **priv);
+int redis_async_resume(cachedb_con *con, int fd, cdb_async_res *res,
+		void *priv);
+
+void redis_async_free_cons(cluster_node *node);
+
+#endif /* CACHEDB_REDIS_ASYNC_H */
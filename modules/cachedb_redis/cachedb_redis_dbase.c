@@ -26,6 +26,7 @@
 #include "../../dprint.h"
 #include "cachedb_redis_dbase.h"
 #include "cachedb_redis_utils.h"
+#include "cachedb_redis_tracking.h"
 #include "../../mem/mem.h"
 #include "../../ut.h"
 #include "../../pt.h"
@@ -143,42 +144,30 @@ static int redis_init_ssl(char *url_extra_opts, redisContext *ctx,
 }
 #endif
 
-int redis_connect_node(redis_con *con,cluster_node *node)
+/* authenticates and selects the database over a new connection */
+int redis_prepare_ctx(redis_con *con, redisContext *ctx)
 {
 	redisReply *rpl;
 
-	node->context = redis_get_ctx(node->ip,node->port);
-	if (!node->context)
-		return -1;
-
-#ifdef HAVE_REDIS_SSL
-	if (use_tls && con->id->extra_options &&
-		redis_init_ssl(con->id->extra_options, node->context,
-			&node->tls_dom) < 0) {
-		redisFree(node->context);
-		return -1;
-	}
-#endif
-
 	if (con->id->password) {
-		rpl = redisCommand(node->context,"AUTH %s",con->id->password);
+		rpl = redisCommand(ctx,"AUTH %s",con->id->password);
 		if (rpl == NULL || rpl->type == REDIS_REPLY_ERROR) {
 			LM_ERR("failed to auth to redis - %.*s\n",
 				rpl?(unsigned)rpl->len:7,rpl?rpl->str:"FAILURE");
 			freeReplyObject(rpl);
-			goto error;
+			return -1;
 		}
 		LM_DBG("AUTH [password] -  %.*s\n",(unsigned)rpl->len,rpl->str);
 		freeReplyObject(rpl);
 	}
 
 	if ((con->flags & REDIS_SINGLE_INSTANCE) && con->id->database) {
-		rpl = redisCommand(node->context,"SELECT %s",con->id->database);
+		rpl = redisCommand(ctx,"SELECT %s",con->id->database);
 		if (rpl == NULL || rpl->type == REDIS_REPLY_ERROR) {
 			LM_ERR("failed to select database %s - %.*s\n",con->id->database,
 				rpl?(unsigned)rpl->len:7,rpl?rpl->str:"FAILURE");
 			freeReplyObject(rpl);
-			goto error;
+			return -1;
 		}
 
 		LM_DBG("SELECT [%s] - %.*s\n",con->id->database,(unsigned)rpl->len,rpl->str);
@@ -186,6 +175,30 @@ int redis_connect_node(redis_con *con,cluster_node *node)
 	}
 
 	return 0;
+}
+
+int redis_connect_node(redis_con *con,cluster_node *node)
+{
+	node->context = redis_get_ctx(node->ip,node->port);
+	if (!node->context)
+		return -1;
+
+#ifdef HAVE_REDIS_SSL
+	if (use_tls && con->id->extra_options &&
+		redis_init_ssl(con->id->extra_options, node->context,
+			&node->tls_dom) < 0) {
+		redisFree(node->context);
+		return -1;
+	}
+#endif
+
+	if (redis_prepare_ctx(con, node->context) < 0)
+		goto error;
+
+	if (redis_cc_active(con->cc) && redis_cc_enable_tracking(con, node) < 0)
+		con->cc->disabled = 1;
+
+	return 0;
 
 error:
 	redisFree(node->context);
@@ -261,6 +274,7 @@ int redis_connect(redis_con *con)
 		con->nodes->start_slot = 0;
 		con->nodes->end_slot = 4096;
 		con->nodes->context = NULL;
+		con->nodes->async_cons = NULL;
 		con->nodes->next = NULL;
 		LM_DBG("single instance mode\n");
 	} else {
@@ -309,6 +323,9 @@ void redis_free_conns(redis_con *con)
 {
 	redis_con *aux = NULL, *head = con;
 
+	if (con)
+		redis_cc_free(con->cc);
+
 	while (con && (con != head || !aux)) {
 		aux = con;
 		con = con->next_con;
@@ -367,6 +384,7 @@ redis_con* redis_new_connection(struct cachedb_id* id)
 	redis_con *con, *cons = NULL;
 	csv_record *r, *it;
 	unsigned int multi_hosts;
+	struct redis_cc *cc = NULL;
 
 	if (id == NULL) {
 		LM_ERR("null cachedb_id\n");
@@ -378,6 +396,12 @@ redis_con* redis_new_connection(struct cachedb_id* id)
 	else
 		multi_hosts = 0;
 
+	if (redis_client_cache) {
+		cc = redis_cc_new();
+		if (!cc)
+			return NULL;
+	}
+
 	r = parse_csv_record(_str(id->host));
 	for (it = r; it; it = it->next) {
 		LM_DBG("parsed Redis host: '%.*s'\n", it->s.len, it->s.s);
@@ -398,6 +422,7 @@ redis_con* redis_new_connection(struct cachedb_id* id)
 		con->id = id;
 		con->ref = 1;
 		con->flags |= multi_hosts; /* if the case */
+		con->cc = cc;
 
 		/* if doing failover Redises, only connect the 1st one for now! */
 		if (!cons && redis_connect(con) < 0) {
@@ -419,7 +444,10 @@ redis_con* redis_new_connection(struct cachedb_id* id)
 
 out_err:
 	free_csv_record(r);
-	redis_free_conns(cons);
+	if (cons)
+		redis_free_conns(cons);
+	else
+		redis_cc_free(cc);
 	return NULL;
 }
 
@@ -437,6 +465,8 @@ void redis_free_connection(cachedb_pool_con *cpc)
 	if (!con)
 		return;
 
+	redis_cc_free(con->cc);
+
 	while (con && (con != head || !aux)) {
 		aux = con;
 		con = con->next_con;
@@ -451,15 +481,57 @@ void redis_destroy(cachedb_con *con) {
 	cachedb_do_close(con,redis_free_connection);
 }
 
+/*
+ * Sends the command, pipelined with an "EXPIRE @key @expires", then
+ * returns the reply of the command (NULL on I/O error)
+ */
+static redisReply *redis_command_with_expire(redisContext *ctx, str *key,
+	int expires, int argc, const char **argv, const size_t *argvlen,
+	char *cmd_fmt, va_list ap)
+{
+	redisReply *reply = NULL, *exp_reply = NULL;
+	int rc;
+
+	if (argc)
+		rc = redisAppendCommandArgv(ctx, argc, argv, argvlen);
+	else
+		rc = redisvAppendCommand(ctx, cmd_fmt, ap);
+	if (rc != REDIS_OK ||
+	        redisAppendCommand(ctx, "EXPIRE %b %d",
+	            key->s, (size_t)key->len, expires) != REDIS_OK)
+		return NULL;
+
+	/* both replies must be read, to keep the connection in sync */
+	if (redisGetReply(ctx, (void **)&reply) != REDIS_OK ||
+	        redisGetReply(ctx, (void **)&exp_reply) != REDIS_OK) {
+		if (reply)
+			freeReplyObject(reply);
+		return NULL;
+	}
+
+	if (exp_reply->type == REDIS_REPLY_ERROR)
+		LM_ERR("failed to set %.*s to expire in %d s - %.*s\n",
+			key->len, key->s, expires, (unsigned)exp_reply->len, exp_reply->str);
+	else
+		LM_DBG("set %.*s to expire in %d s - %lld\n",
+			key->len, key->s, expires, exp_reply->integer);
+
+	freeReplyObject(exp_reply);
+	return reply;
+}
+
 /*
  * Upon returning 0 (success), @rpl is guaranteed to be:
  *   - non-NULL
  *   - non-REDIS_REPLY_ERROR
  *
+ * If @expires is non-zero, @key is also set to expire, within the same
+ * round trip.
+ *
  * On error, a negative code is returned
  */
 static int _redis_run_command(cachedb_con *connection, redisReply **rpl, str *key,
-	int argc, const char **argv, const size_t *argvlen,
+	int expires, int argc, const char **argv, const size_t *argvlen,
 	char *cmd_fmt, va_list ap)
 {
 	redis_con *con = NULL, *first;
@@ -493,7 +565,12 @@ static int _redis_run_command(cachedb_con *connection, redisReply **rpl, str *ke
 		}
 
 		for (i = QUERY_ATTEMPTS; i; i--) {
-			if (argc) {
+			if (expires) {
+				va_copy(aq, ap);
+				reply = redis_command_with_expire(node->context, key, expires,
+					argc, argv, argvlen, cmd_fmt, aq);
+				va_end(aq);
+			} else if (argc) {
 				reply = redisCommandArgv(node->context, argc, argv, argvlen);
 			} else {
 				va_copy(aq, ap);
@@ -529,6 +606,8 @@ static int _redis_run_command(cachedb_con *connection, redisReply **rpl, str *ke
 		break;
 
 try_next_con:
+		/* the new host did not track the keys we read so far */
+		redis_cc_flush(con->cc);
 		((redis_con *)connection->data)->current = con->next_con;
 		if (con->next_con != first)
 			LM_INFO("failing over to next Redis host (%s:%d)\n",
@@ -546,7 +625,21 @@ static int redis_run_command(cachedb_con *connection, redisReply **rpl,
 	va_list ap;
 
 	va_start(ap, cmd_fmt);
-	rc = _redis_run_command(connection, rpl, key, 0, NULL, NULL, cmd_fmt, ap);
+	rc = _redis_run_command(connection, rpl, key, 0, 0, NULL, NULL, cmd_fmt, ap);
+	va_end(ap);
+
+	return rc;
+}
+
+static int redis_run_command_expire(cachedb_con *connection, redisReply **rpl,
+              str *key, int expires, char *cmd_fmt, ...)
+{
+	int rc;
+	va_list ap;
+
+	va_start(ap, cmd_fmt);
+	rc = _redis_run_command(connection, rpl, key, expires, 0, NULL, NULL,
+		cmd_fmt, ap);
 	va_end(ap);
 
 	return rc;
@@ -557,7 +650,36 @@ static int redis_run_command_argv(cachedb_con *connection, redisReply **rpl,
 {
 	va_list _;
 
-	return _redis_run_command(connection, rpl, key, argc, argv, argvlen, NULL, _);
+	return _redis_run_command(connection, rpl, key, 0, argc, argv, argvlen, NULL, _);
+}
+
+/* looks the key up in the client-side cache, if enabled; see
+ * redis_cc_lookup() for the return codes */
+static int redis_cached_get(cachedb_con *connection, str *attr, str *val)
+{
+	redis_con *con = ((redis_con *)connection->data)->current;
+
+	if (!redis_cc_active(con->cc))
+		return 0;
+
+	/* catch up with the invalidations received meanwhile */
+	redis_cc_poll(con);
+
+	return redis_cc_lookup(con->cc, attr, val);
+}
+
+static void redis_cache_reply(cachedb_con *connection, str *attr,
+		redisReply *reply)
+{
+	redis_con *con = ((redis_con *)connection->data)->current;
+
+	if (redis_cc_active(con->cc))
+		redis_cc_store(con->cc, attr, reply);
+}
+
+static void redis_uncache(cachedb_con *connection, str *attr)
+{
+	redis_cc_invalidate(((redis_con *)connection->data)->cc, attr);
 }
 
 int redis_get(cachedb_con *connection,str *attr,str *val)
@@ -570,11 +692,23 @@ int redis_get(cachedb_con *connection,str *attr,str *val)
 		return -1;
 	}
 
+	switch (redis_cached_get(connection, attr, val)) {
+	case 1:
+		LM_DBG("GET %.*s - served from the client-side cache\n",
+			attr->len, attr->s);
+		return 0;
+	case 2:
+		LM_DBG("no such key - %.*s (cached)\n",attr->len,attr->s);
+		return -2;
+	}
+
 	rc = redis_run_command(connection, &reply, attr, "GET %b",
 		attr->s, (size_t)attr->len);
 	if (rc != 0)
 		goto out_err;
 
+	redis_cache_reply(connection, attr, reply);
+
 	if (reply->type == REDIS_REPLY_NIL) {
 		LM_DBG("no such key - %.*s\n",attr->len,attr->s);
 		val->s = NULL;
@@ -620,28 +754,24 @@ int redis_set(cachedb_con *connection,str *attr,str *val,int expires)
 		return -1;
 	}
 
-	rc = redis_run_command(connection, &reply, attr, "SET %b %b",
-			attr->s, (size_t)attr->len, val->s, (size_t)val->len);
+	redis_uncache(connection, attr);
+
+	/* a single round trip, even if expiring */
+	if (expires)
+		rc = redis_run_command(connection, &reply, attr, "SET %b %b EX %d",
+				attr->s, (size_t)attr->len, val->s, (size_t)val->len, expires);
+	else
+		rc = redis_run_command(connection, &reply, attr, "SET %b %b",
+				attr->s, (size_t)attr->len, val->s, (size_t)val->len);
 	if (rc != 0)
 		goto out_err;
 
-	LM_DBG("set %.*s to %.*s - status = %d - %.*s\n",attr->len,attr->s,val->len,
-			val->s,reply->type,(unsigned)reply->len,reply->str);
+	LM_DBG("set %.*s to %.*s (expires: %d) - status = %d - %.*s\n",
+			attr->len,attr->s,val->len,val->s,expires,
+			reply->type,(unsigned)reply->len,reply->str);
 
 	freeReplyObject(reply);
 
-	if (expires) {
-		rc = redis_run_command(connection, &reply, attr, "EXPIRE %b %d",
-		             attr->s, (size_t)attr->len, expires);
-		if (rc != 0)
-			goto out_err;
-
-		LM_DBG("set %.*s to expire in %d s - %.*s\n",attr->len,attr->s,expires,
-				(unsigned)reply->len,reply->str);
-
-		freeReplyObject(reply);
-	}
-
 	return 0;
 
 out_err:
@@ -662,6 +792,8 @@ int redis_remove(cachedb_con *connection,str *attr)
 		return -1;
 	}
 
+	redis_uncache(connection, attr);
+
 	rc = redis_run_command(connection, &reply, attr, "DEL %b",
 		attr->s, (size_t)attr->len);
 	if (rc != 0)
@@ -692,8 +824,11 @@ int redis_add(cachedb_con *connection,str *attr,int val,int expires,int *new_val
 		return -1;
 	}
 
-	rc = redis_run_command(connection, &reply, attr, "INCRBY %b %d",
-			attr->s, (size_t)attr->len,val);
+	redis_uncache(connection, attr);
+
+	/* the EXPIRE (if any) is pipelined with the INCRBY */
+	rc = redis_run_command_expire(connection, &reply, attr, expires,
+			"INCRBY %b %d", attr->s, (size_t)attr->len,val);
 	if (rc != 0)
 		goto out_err;
 
@@ -701,18 +836,6 @@ int redis_add(cachedb_con *connection,str *attr,int val,int expires,int *new_val
 		*new_val = reply->integer;
 	freeReplyObject(reply);
 
-	if (expires) {
-		rc = redis_run_command(connection, &reply, attr, "EXPIRE %b %d",
-				attr->s, (size_t)attr->len,expires);
-		if (rc != 0)
-			goto out_err;
-
-		LM_DBG("set %.*s to expire in %d s - %.*s\n",attr->len,attr->s,expires,
-				(unsigned)reply->len,reply->str);
-
-		freeReplyObject(reply);
-	}
-
 	return rc;
 
 out_err:
@@ -730,8 +853,10 @@ int redis_sub(cachedb_con *connection,str *attr,int val,int expires,int *new_val
 		return -1;
 	}
 
-	rc = redis_run_command(connection, &reply, attr, "DECRBY %b %d",
-			attr->s, (size_t)attr->len, val);
+	redis_uncache(connection, attr);
+
+	rc = redis_run_command_expire(connection, &reply, attr, expires,
+			"DECRBY %b %d", attr->s, (size_t)attr->len, val);
 	if (rc != 0)
 		goto out_err;
 
@@ -739,18 +864,6 @@ int redis_sub(cachedb_con *connection,str *attr,int val,int expires,int *new_val
 		*new_val = reply->integer;
 	freeReplyObject(reply);
 
-	if (expires) {
-		rc = redis_run_command(connection, &reply, attr, "EXPIRE %b %d",
-				attr->s, (size_t)attr->len, expires);
-		if (rc != 0)
-			goto out_err;
-
-		LM_DBG("set %.*s to expire in %d s - %.*s\n",attr->len,attr->s,expires,
-				(unsigned)reply->len,reply->str);
-
-		freeReplyObject(reply);
-	}
-
 	return 0;
 
 out_err:
@@ -769,11 +882,30 @@ int redis_get_counter(cachedb_con *connection,str *attr,int *val)
 		return -1;
 	}
 
+	if (redis_cached_get(connection, attr, &response)) {
+		if (!response.s) {
+			LM_DBG("no such key - %.*s\n",attr->len,attr->s);
+			return -2;
+		}
+
+		rc = str2sint(&response,&ret);
+		pkg_free(response.s);
+		if (rc != 0) {
+			LM_ERR("Not a counter \n");
+			return -3;
+		}
+
+		*val = ret;
+		return 0;
+	}
+
 	rc = redis_run_command(connection, &reply, attr, "GET %b",
 			attr->s, (size_t)attr->len);
 	if (rc != 0)
 		goto out_err;
 
+	redis_cache_reply(connection, attr, reply);
+
 	if (reply->type == REDIS_REPLY_NIL || reply->str == NULL
 			|| reply->len == 0) {
 		LM_DBG("no such key - %.*s\n",attr->len,attr->s);
@@ -822,6 +954,10 @@ int redis_raw_query_handle_reply(redisReply *reply,cdb_raw_entry ***ret,
 
 	switch (reply->type) {
 		case REDIS_REPLY_STRING:
+#ifdef HAVE_REDIS_RESP3
+		case REDIS_REPLY_VERB:
+		case REDIS_REPLY_DOUBLE:
+#endif
 			(*ret)[current_size][0].val.s.s = pkg_malloc(reply->len);
 			if (! (*ret)[current_size][0].val.s.s ) {
 				LM_ERR("No more pkg \n");
@@ -846,8 +982,17 @@ int redis_raw_query_handle_reply(redisReply *reply,cdb_raw_entry ***ret,
 			current_size++;
 			break;
 		case REDIS_REPLY_ARRAY:
+#ifdef HAVE_REDIS_RESP3
+		/* RESP3 replies, if the client-side cache is enabled */
+		case REDIS_REPLY_MAP:
+		case REDIS_REPLY_SET:
+#endif
 			for (i=0;i<reply->elements;i++) {
 				switch (reply->element[i]->type) {
+#ifdef HAVE_REDIS_RESP3
+					case REDIS_REPLY_VERB:
+					case REDIS_REPLY_DOUBLE:
+#endif
 					case REDIS_REPLY_STRING:
 					case REDIS_REPLY_INTEGER:
 					case REDIS_REPLY_NIL:
@@ -971,6 +1116,9 @@ int redis_raw_query_send(cachedb_con *connection, redisReply **reply,
 	memcpy(attr_nt.s, attr->s, attr->len);
 	attr_nt.s[attr->len] = '\0';
 
+	/* the query might change the key */
+	redis_uncache(connection, &query_key);
+
 	return redis_run_command(connection, reply, &query_key, attr_nt.s);
 }
 
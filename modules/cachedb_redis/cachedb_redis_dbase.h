@@ -45,6 +45,9 @@ typedef struct cluster_nodes {
 	redisContext *context;			/* actual connection to this node */
 	struct tls_domain *tls_dom;
 
+	/* connections dedicated to the async queries, opened on demand */
+	struct redis_async_con *async_cons;
+
 	struct cluster_nodes *next;
 } cluster_node;
 
@@ -75,6 +78,8 @@ enum redis_flag {
 	REDIS_MULTIPLE_HOSTS   = 1 << 3,
 };
 
+struct redis_cc;
+
 typedef struct _redis_con {
 	/* ------ Fixed conn header -------- */
 	struct cachedb_id *id;
@@ -93,8 +98,17 @@ typedef struct _redis_con {
 	struct _redis_con *next_con;
 	/* only populated for 1st item in the list: the "last-known-to-work" con */
 	struct _redis_con *current;
+
+	/* client-side cache, shared by all the cons of the list (if enabled) */
+	struct redis_cc *cc;
 } redis_con;
 
+int redis_prepare_ctx(redis_con *con, redisContext *ctx);
+redisContext *redis_get_ctx(char *ip, int port);
+int redis_raw_query_handle_reply(redisReply *reply,cdb_raw_entry ***ret,
+		int expected_kv_no,int *reply_no);
+int redis_raw_query_extract_key(str *attr,str *query_key);
+
 cachedb_con* redis_init(str *url);
 void redis_destroy(cachedb_con *con);
 int redis_get(cachedb_con *con,str *attr,str *val);
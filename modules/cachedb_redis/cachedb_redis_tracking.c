@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+#include <poll.h>
+
+#include "../../dprint.h"
+#include "../../mem/mem.h"
+#include "../../timer.h"
+#include "../../hash_func.h"
+#include "cachedb_redis_tracking.h"
+
+int redis_client_cache = 0;
+int redis_client_cache_size = 1024;
+int redis_client_cache_ttl = 0;
+
+stat_var *redis_cc_hits;
+stat_var *redis_cc_misses;
+stat_var *redis_cc_invalidations;
+
+struct redis_cc *redis_cc_new(void)
+{
+	struct redis_cc *cc;
+	unsigned int size;
+
+	/* about two entries per bucket, at most */
+	for (size = 16; size < redis_client_cache_size / 2; size <<= 1) ;
+
+	cc = pkg_malloc(sizeof *cc + size * sizeof *cc->buckets);
+	if (!cc) {
+		LM_ERR("no more pkg memory\n");
+		return NULL;
+	}
+	memset(cc, 0, sizeof *cc + size * sizeof *cc->buckets);
+
+	cc->buckets = (redis_cc_entry **)(cc + 1);
+	cc->size = size;
+
+	return cc;
+}
+
+static void redis_cc_unlink(struct redis_cc *cc, redis_cc_entry **link)
+{
+	redis_cc_entry *e = *link;
+
+	*link = e->next;
+
+	if (e->lru_prev)
+		e->lru_prev->lru_next = e->lru_next;
+	else
+		cc->lru_first = e->lru_next;
+	if (e->lru_next)
+		e->lru_next->lru_prev = e->lru_prev;
+	else
+		cc->lru_last = e->lru_prev;
+
+	cc->count--;
+	pkg_free(e);
+}
+
+static redis_cc_entry **redis_cc_find(struct redis_cc *cc, str *key)
+{
+	redis_cc_entry **link;
+
+	for (link = &cc->buckets[core_hash(key, NULL, cc->size)]; *link;
+			link = &(*link)->next)
+		if ((*link)->key.len == key->len &&
+				!memcmp((*link)->key.s, key->s, key->len))
+			return link;
+
+	return NULL;
+}
+
+void redis_cc_flush(struct redis_cc *cc)
+{
+	unsigned int i;
+
+	if (!cc || !cc->count)
+		return;
+
+	LM_DBG("flushing %u cached keys\n", cc->count);
+
+	for (i = 0; i < cc->size; i++)
+		while (cc->buckets[i])
+			redis_cc_unlink(cc, &cc->buckets[i]);
+}
+
+void redis_cc_free(struct redis_cc *cc)
+{
+	if (!cc)
+		return;
+
+	redis_cc_flush(cc);
+	pkg_free(cc);
+}
+
+void redis_cc_invalidate(struct redis_cc *cc, str *key)
+{
+	redis_cc_entry **link;
+
+	if (!cc || !cc->count)
+		return;
+
+	link = redis_cc_find(cc, key);
+	if (link) {
+		LM_DBG("invalidating %.*s\n", key->len, key->s);
+		redis_cc_unlink(cc, link);
+	}
+}
+
+int redis_cc_lookup(struct redis_cc *cc, str *key, str *val)
+{
+	redis_cc_entry **link, *e;
+
+	link = redis_cc_find(cc, key);
+	if (!link) {
+		update_stat(redis_cc_misses, 1);
+		return 0;
+	}
+
+	e = *link;
+	if (e->expires && e->expires < get_ticks()) {
+		redis_cc_unlink(cc, link);
+		update_stat(redis_cc_misses, 1);
+		return 0;
+	}
+
+	if (!e->val.s || e->val.len == 0) {
+		val->s = NULL;
+		val->len = 0;
+	} else {
+		val->s = pkg_malloc(e->val.len);
+		if (!val->s) {
+			LM_ERR("no more pkg memory\n");
+			return 0;
+		}
+		memcpy(val->s, e->val.s, e->val.len);
+		val->len = e->val.len;
+	}
+
+	/* move it to the front of the recently used list */
+	if (e->lru_prev) {
+		e->lru_prev->lru_next = e->lru_next;
+		if (e->lru_next)
+			e->lru_next->lru_prev = e->lru_prev;
+		else
+			cc->lru_last = e->lru_prev;
+
+		e->lru_prev = NULL;
+		e->lru_next = cc->lru_first;
+		cc->lru_first->lru_prev = e;
+		cc->lru_first = e;
+	}
+
+	update_stat(redis_cc_hits, 1);
+	return e->val.s ? 1 : 2;
+}
+
+int redis_cc_cached(struct redis_cc *cc, str *key)
+{
+	redis_cc_entry **link;
+
+	link = redis_cc_find(cc, key);
+
+	return link && (!(*link)->expires || (*link)->expires >= get_ticks());
+}
+
+void redis_cc_store(struct redis_cc *cc, str *key, redisReply *reply)
+{
+	redis_cc_entry **link, *e;
+	int val_len;
+
+	if (reply->type == REDIS_REPLY_NIL)
+		val_len = 0;
+	else if (reply->type == REDIS_REPLY_STRING)
+		val_len = reply->len;
+	else
+		return;
+
+	link = redis_cc_find(cc, key);
+	if (link)
+		redis_cc_unlink(cc, link);
+
+	while (cc->count >= redis_client_cache_size && cc->lru_last)
+		redis_cc_unlink(cc, redis_cc_find(cc, &cc->lru_last->key));
+
+	e = pkg_malloc(sizeof *e + key->len + val_len);
+	if (!e) {
+		LM_ERR("no more pkg memory\n");
+		return;
+	}
+	memset(e, 0, sizeof *e);
+
+	e->key.s = (char *)(e + 1);
+	e->key.len = key->len;
+	memcpy(e->key.s, key->s, key->len);
+
+	if (reply->type == REDIS_REPLY_STRING) {
+		e->val.s = e->key.s + key->len;
+		e->val.len = val_len;
+		memcpy(e->val.s, reply->str, val_len);
+	}
+
+	if (redis_client_cache_ttl)
+		e->expires = get_ticks() + redis_client_cache_ttl;
+
+	link = &cc->buckets[core_hash(key, NULL, cc->size)];
+	e->next = *link;
+	*link = e;
+
+	e->lru_next = cc->lru_first;
+	if (cc->lru_first)
+		cc->lru_first->lru_prev = e;
+	else
+		cc->lru_last = e;
+	cc->lru_first = e;
+
+	cc->count++;
+}
+
+#ifdef HAVE_REDIS_RESP3
+
+/* handles an "invalidate" push: ["invalidate", [key, ...]] or, if the
+ * server dropped its whole tracking table, ["invalidate", nil] */
+static void redis_cc_push(void *privdata, void *_reply)
+{
+	struct redis_cc *cc = (struct redis_cc *)privdata;
+	redisReply *reply = (redisReply *)_reply, *keys;
+	str key;
+	size_t i;
+
+	if (reply->type != REDIS_REPLY_PUSH || reply->elements < 2 ||
+			reply->element[0]->type != REDIS_REPLY_STRING ||
+			reply->element[0]->len != 10 ||
+			memcmp(reply->element[0]->str, "invalidate", 10)) {
+		LM_DBG("ignoring push message\n");
+		goto out;
+	}
+
+	if (!cc)
+		goto out;
+
+	keys = reply->element[1];
+	if (keys->type == REDIS_REPLY_ARRAY) {
+		for (i = 0; i < keys->elements; i++) {
+			key.s = keys->element[i]->str;
+			key.len = keys->element[i]->len;
+			redis_cc_invalidate(cc, &key);
+		}
+		update_stat(redis_cc_invalidations, keys->elements);
+	} else {
+		redis_cc_flush(cc);
+		update_stat(redis_cc_invalidations, 1);
+	}
+
+out:
+	freeReplyObject(reply);
+}
+
+int redis_cc_enable_tracking(redis_con *con, cluster_node *node)
+{
+	redisReply *rpl;
+
+	/* whatever we cached so far might have been changed meanwhile */
+	redis_cc_flush(con->cc);
+
+	rpl = redisCommand(node->context, "HELLO 3");
+	if (rpl == NULL || rpl->type == REDIS_REPLY_ERROR) {
+		LM_WARN("%s:%hu does not support RESP3 (Redis 6+ required), "
+			"disabling the client-side cache - %.*s\n",
+			node->ip, node->port, rpl ? (unsigned)rpl->len : 7,
+			rpl ? rpl->str : "FAILURE");
+		goto disable;
+	}
+	freeReplyObject(rpl);
+
+	node->context->privdata = con->cc;
+	redisSetPushCallback(node->context, redis_cc_push);
+
+	rpl = redisCommand(node->context, "CLIENT TRACKING on");
+	if (rpl == NULL || rpl->type == REDIS_REPLY_ERROR) {
+		LM_WARN("failed to enable the key tracking on %s:%hu, disabling "
+			"the client-side cache - %.*s\n", node->ip, node->port,
+			rpl ? (unsigned)rpl->len : 7, rpl ? rpl->str : "FAILURE");
+		goto disable;
+	}
+	freeReplyObject(rpl);
+
+	LM_DBG("key tracking enabled on %s:%hu\n", node->ip, node->port);
+	return 0;
+
+disable:
+	if (rpl)
+		freeReplyObject(rpl);
+	node->context->privdata = NULL;
+	return -1;
+}
+
+void redis_cc_poll(redis_con *con)
+{
+	struct pollfd pfd;
+	cluster_node *node;
+	void *reply;
+
+	for (node = con->nodes; node; node = node->next) {
+		if (!node->context || node->context->err)
+			continue;
+
+		pfd.fd = node->context->fd;
+		pfd.events = POLLIN;
+
+		if (poll(&pfd, 1, 0) <= 0)
+			continue;
+
+		/* no query is in progress, so only pushes may be pending */
+		if (redisBufferRead(node->context) != REDIS_OK) {
+			LM_INFO("connection to %s:%hu lost - %s\n", node->ip, node->port,
+				node->context->errstr);
+			/* the invalidations might have been lost as well */
+			redis_cc_flush(con->cc);
+			continue;
+		}
+
+		for (;;) {
+			reply = NULL;
+			if (redisGetReplyFromReader(node->context, &reply) != REDIS_OK) {
+				redis_cc_flush(con->cc);
+				break;
+			}
+			if (!reply)
+				break;
+
+			redis_cc_push(con->cc, reply);
+		}
+	}
+}
+
+#else
+
+int redis_cc_enable_tracking(redis_con *con, cluster_node *node)
+{
+	return -1;
+}
+
+void redis_cc_poll(redis_con *con)
+{
+}
+
+#endif
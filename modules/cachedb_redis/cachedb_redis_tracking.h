@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Client-side caching of the GET replies, kept valid through the Redis
+ * server-assisted invalidation ("CLIENT TRACKING", RESP3 protocol): the
+ * server remembers the keys read over each connection and pushes an
+ * "invalidate" message on the same connection once any of them changes.
+ *
+ * Each process has its own connections, so the cache is a private (pkg)
+ * one, shared by all the failover hosts of a cachedb URL. The pushes are
+ * consumed either while reading the reply of a regular command or, before
+ * serving a lookup from the cache, by draining the already received data
+ * of the connection (without blocking).
+ */
+
+#ifndef CACHEDB_REDIS_TRACKING_H
+#define CACHEDB_REDIS_TRACKING_H
+
+#include "../../str.h"
+#include "../../statistics.h"
+#include "cachedb_redis_dbase.h"
+
+/* RESP3 (push messages) is available starting with hiredis 1.0 */
+#if defined(HIREDIS_MAJOR) && HIREDIS_MAJOR >= 1
+#define HAVE_REDIS_RESP3
+#endif
+
+extern int redis_client_cache;
+extern int redis_client_cache_size;
+extern int redis_client_cache_ttl;
+
+extern stat_var *redis_cc_hits;
+extern stat_var *redis_cc_misses;
+extern stat_var *redis_cc_invalidations;
+
+typedef struct redis_cc_entry {
+	str key;
+	/* the cached value; NULL if the key does not exist */
+	str val;
+	unsigned int expires;
+
+	struct redis_cc_entry *next;
+	/* recently used list, most recent first */
+	struct redis_cc_entry *lru_prev;
+	struct redis_cc_entry *lru_next;
+} redis_cc_entry;
+
+struct redis_cc {
+	/* set if any of the servers cannot track our keys */
+	int disabled;
+
+	redis_cc_entry **buckets;
+	unsigned int size;
+	unsigned int count;
+
+	redis_cc_entry *lru_first;
+	redis_cc_entry *lru_last;
+};
+
+#define redis_cc_active(_cc) ((_cc) && !(_cc)->disabled)
+
+struct redis_cc *redis_cc_new(void);
+void redis_cc_free(struct redis_cc *cc);
+void redis_cc_flush(struct redis_cc *cc);
+
+/* switches a freshly connected node to RESP3 and enables the tracking of
+ * the keys it reads; on failure, the cache is disabled for its URL */
+int redis_cc_enable_tracking(redis_con *con, cluster_node *node);
+
+/* processes the invalidations already received over the connections */
+void redis_cc_poll(redis_con *con);
+
+/* returns 1 if found (@val is a pkg copy, NULL if empty), 2 if cached as
+ * non-existing or 0 if not cached */
+int redis_cc_lookup(struct redis_cc *cc, str *key, str *val);
+/* returns 1 if @key is cached (no copy, no stats), 0 otherwise */
+int redis_cc_cached(struct redis_cc *cc, str *key);
+/* caches a GET reply (string or nil) */
+void redis_cc_store(struct redis_cc *cc, str *key, redisReply *reply);
+void redis_cc_invalidate(struct redis_cc *cc, str *key);
+
+#endif /* CACHEDB_REDIS_TRACKING_H */
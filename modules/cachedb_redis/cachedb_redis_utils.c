@@ -25,6 +25,7 @@
 
 #include "../../dprint.h"
 #include "cachedb_redis_dbase.h"
+#include "cachedb_redis_async.h"
 #include "../../mem/mem.h"
 #include "../../ut.h"
 #include "../../cachedb/cachedb.h"
@@ -109,6 +110,7 @@ void destroy_cluster_nodes(redis_con *con)
 	new = con->nodes;
 	while (new) {
 		foo = new->next;
+		redis_async_free_cons(new);
 		redisFree(new->context);
 		if (use_tls && new->tls_dom)
 			tls_api.release_domain(new->tls_dom);
@@ -205,6 +205,23 @@ typedef bin_packet_t* (*sync_chunk_start_f)(str *capability, int cluster_id,
  */
 typedef int (*sync_chunk_iter_f)(bin_packet_t *packet);
 
+/*
+ * Declare that the data set of a capability may be synced in partitions,
+ * possibly streamed in parallel from several donor nodes. The module must
+ * then use sync_partition_f in order to only send the requested partition.
+ *
+ * Should be called right after registering the capability.
+ */
+typedef int (*set_partitioned_sync_f)(str *capability, int cluster_id);
+/*
+ * Returns the partition of the data set to be sent, as [0, @part_no-1].
+ * A data chunk (e.g. all the records in a hash slot) belongs to partition
+ * "slot % @part_no".
+ *
+ * This function should only be called from the callback for the SYNC_REQ_RCV event.
+ */
+typedef int (*sync_partition_f)(int *part_idx, int *part_no);
+
 /*
  * Gets the state of a sharing tag by name and cluster ID
  *
@@ -288,6 +305,8 @@ struct clusterer_binds {
 	request_sync_f request_sync;
 	sync_chunk_start_f sync_chunk_start;
 	sync_chunk_iter_f sync_chunk_iter;
+	set_partitioned_sync_f set_partitioned_sync;
+	sync_partition_f sync_partition;
 	shtag_get_f shtag_get;
 	shtag_activate_f shtag_activate;
 	shtag_get_all_active_f shtag_get_all_active;
@@ -1071,6 +1071,8 @@ void bin_rcv_cl_extra_packets(bin_packet_t *packet, int packet_type,
 			handle_sync_request(packet, cl, node);
 		else if (packet_type == CLUSTERER_SYNC || packet_type == CLUSTERER_SYNC_END)
 			handle_sync_packet(packet, packet_type, cl, source_id);
+		else if (packet_type == CLUSTERER_SYNC_ACK)
+			handle_sync_ack(packet, cl, source_id);
 		else {
 			LM_ERR("Unknown clusterer message type: %d\n", packet_type);
 			goto exit;
@@ -1164,23 +1166,13 @@ exit:
 
 void run_mod_packet_cb(int sender, void *param)
 {
-	extern char *next_data_chunk;
 	struct packet_rpc_params *p = (struct packet_rpc_params *)param;
 	bin_packet_t packet;
-	str cap_name;
-	int data_version;
 
 	bin_init_buffer(&packet, p->pkt_buf.s, p->pkt_buf.len);
 	packet.src_id = p->pkt_src_id;
 	packet.type = p->pkt_type;
 
-	if (packet.type == SYNC_PACKET_TYPE) {
-		/* this packet is cloned and both below fields have been used */
-		bin_pop_str(&packet, &cap_name);
-		bin_pop_int(&packet, &data_version);
-		next_data_chunk = NULL;
-	}
-
 	p->cap->packet_cb(&packet);
 
 	shm_free(param);
@@ -1561,7 +1553,7 @@ void do_actions_node_ev(cluster_info_t *clusters, int *select_cluster,
 						lock_release(node->lock);
 						/* reply now that the node is up */
 						if (ipc_dispatch_sync_reply(cl, node->node_id,
-							&n_cap->name) < 0)
+							&n_cap->name, n_cap->sync_seq, 0, 1, 0) < 0)
 							LM_ERR("Failed to dispatch sync reply job\n");
 						lock_get(node->lock);
 					}
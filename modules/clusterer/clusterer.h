@@ -32,7 +32,7 @@
 #include "api.h"
 
 #define BIN_VERSION 1
-#define BIN_SYNC_VERSION 2
+#define BIN_SYNC_VERSION 3
 #define DEFAULT_PING_INTERVAL 4
 #define DEFAULT_NODE_TIMEOUT 60
 #define DEFAULT_PING_TIMEOUT 1000 /* in milliseconds */
@@ -46,6 +46,8 @@
 
 #define MI_CMD_MAX_NR_PARAMS 15
 
+#define MAX_SYNC_PARTITIONS 64
+
 /* node flags */
 #define NODE_STATE_ENABLED	(1<<0)
 #define NODE_EVENT_DOWN		(1<<1)
@@ -57,6 +59,7 @@
 #define CAP_SYNC_PENDING	(1<<1)
 #define CAP_PKT_BUFFERING	(1<<2)
 #define CAP_STATE_ENABLED	(1<<3)
+#define CAP_SYNC_PARTITIONED	(1<<4)
 
 #define CAP_DISABLED 0
 #define CAP_ENABLED  1
@@ -69,7 +72,8 @@ typedef enum { CLUSTERER_PING, CLUSTERER_PONG,
 				CLUSTERER_MI_CMD,
 				CLUSTERER_CAP_UPDATE,
 				CLUSTERER_SYNC_REQ, CLUSTERER_SYNC, CLUSTERER_SYNC_END,
-				CLUSTERER_SHTAG_ACTIVE
+				CLUSTERER_SHTAG_ACTIVE,
+				CLUSTERER_SYNC_ACK
 } clusterer_msg_type;
 
 typedef enum {
@@ -102,12 +106,22 @@ struct local_cap {
 	struct buf_bin_pkt *pkt_q_back;
 	struct timeval sync_req_time;
 	unsigned int flags;
+	/* progress of the last sync requested for this capability */
+	int sync_seq;
+	int sync_parts;
+	int sync_parts_done;
+	unsigned int sync_part_pkts[MAX_SYNC_PARTITIONS];
+	unsigned long sync_pkts;
+	unsigned long long sync_bytes;
+	struct timeval sync_start;
+	struct timeval sync_end;
 	struct local_cap *next;
 };
 
 struct remote_cap {
 	str name;
 	unsigned int flags;
+	int sync_seq;  /* of the last deferred sync request */
 	struct remote_cap *next;
 };
 
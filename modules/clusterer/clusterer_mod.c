@@ -161,6 +161,11 @@ static param_export_t params[] = {
 	{"sharing_tag",			STR_PARAM|USE_FUNC_PARAM,
 		(void*)&shtag_modparam_func},
 	{"sync_packet_size",	INT_PARAM,	&sync_packet_size	},
+	{"sync_partitions",		INT_PARAM,	&sync_partitions	},
+	{"sync_donors",			INT_PARAM,	&sync_donors		},
+	{"sync_window",			INT_PARAM,	&sync_window		},
+	{"sync_ack_timeout",	INT_PARAM,	&sync_ack_timeout	},
+	{"sync_max_queued",		INT_PARAM,	&sync_max_queued	},
 	{0, 0, 0}
 };
 
@@ -380,6 +385,29 @@ static int mod_init(void)
 		LM_WARN("Invalid seed_fallback_interval parameter, using default value\n");
 		seed_fb_interval = DEFAULT_SEED_FB_INTERVAL;
 	}
+	if (sync_partitions < 1 || sync_partitions > MAX_SYNC_PARTITIONS) {
+		LM_WARN("Invalid sync_partitions parameter, must be between 1 and "
+			"%d, using 1\n", MAX_SYNC_PARTITIONS);
+		sync_partitions = 1;
+	}
+	if (sync_donors < 1) {
+		LM_WARN("Invalid sync_donors parameter, using 1\n");
+		sync_donors = 1;
+	} else if (sync_donors > sync_partitions) {
+		sync_donors = sync_partitions;
+	}
+	if (sync_window < 0) {
+		LM_WARN("Invalid sync_window parameter, disabling sync flow control\n");
+		sync_window = 0;
+	}
+	if (sync_ack_timeout <= 0) {
+		LM_WARN("Invalid sync_ack_timeout parameter, using default value\n");
+		sync_ack_timeout = DEFAULT_SYNC_ACK_TIMEOUT;
+	}
+	if (sync_max_queued <= 0) {
+		LM_WARN("Invalid sync_max_queued parameter, using default value\n");
+		sync_max_queued = DEFAULT_SYNC_MAX_QUEUED;
+	}
 
 	/* create & init lock */
 	if ((cl_list_lock = lock_init_rw()) == NULL) {
@@ -387,6 +415,11 @@ static int mod_init(void)
 		return -1;
 	}
 
+	if (init_sync() < 0) {
+		LM_CRIT("Failed to init sync structures\n");
+		goto error;
+	}
+
 	/* data pointer in shm */
 	if (cluster_list == NULL) {
 		cluster_list = shm_malloc(sizeof *cluster_list);
@@ -455,6 +488,12 @@ static int mod_init(void)
 		}
 	}
 
+	if (sync_window > 0 && register_utimer("clstr-sync-timer", sync_timer,
+		NULL, SYNC_TIMER_INTERVAL*1000, TIMER_FLAG_DELAY_ON_DELAY) < 0) {
+		LM_CRIT("Unable to register clusterer sync timer\n");
+		goto error;
+	}
+
 	if (register_utimer("cl-seed-fb-check", seed_fb_check_timer,
 		NULL, SEED_FB_CHECK_INTERVAL*1000, TIMER_FLAG_DELAY_ON_DELAY) < 0) {
 		LM_CRIT("Unable to register clusterer seed check timer\n");
@@ -726,6 +765,38 @@ error:
 	return NULL;
 }
 
+static int add_mi_sync_progress(mi_item_t *cap_item, struct local_cap *cap)
+{
+	mi_item_t *sync_item;
+	struct timeval end;
+	long long duration;
+
+	sync_item = add_mi_object(cap_item, MI_SSTR("sync"));
+	if (!sync_item)
+		return -1;
+
+	if (cap->sync_end.tv_sec)
+		end = cap->sync_end;
+	else
+		gettimeofday(&end, NULL);
+	duration = TIME_DIFF(cap->sync_start, end) / 1000;
+
+	if (add_mi_string_fmt(sync_item, MI_SSTR("partitions"), "%d/%d",
+		cap->sync_parts_done, cap->sync_parts) < 0)
+		return -1;
+	if (add_mi_number(sync_item, MI_SSTR("packets"), cap->sync_pkts) < 0)
+		return -1;
+	if (add_mi_number(sync_item, MI_SSTR("bytes"), cap->sync_bytes) < 0)
+		return -1;
+	if (add_mi_number(sync_item, MI_SSTR("duration_ms"), duration) < 0)
+		return -1;
+	if (add_mi_number(sync_item, MI_SSTR("throughput_Bps"),
+		duration ? cap->sync_bytes * 1000 / duration : 0) < 0)
+		return -1;
+
+	return 0;
+}
+
 static mi_response_t *clusterer_list_cap(const mi_params_t *params,
 								struct mi_handler *async_hdl)
 {
@@ -786,6 +857,11 @@ static mi_response_t *clusterer_list_cap(const mi_params_t *params,
 				goto error;
 			}
 
+			if (cap->sync_start.tv_sec && add_mi_sync_progress(cap_item, cap) < 0) {
+				lock_release(cl->lock);
+				goto error;
+			}
+
 			lock_release(cl->lock);
 	   }
 	}
@@ -1366,6 +1442,8 @@ int load_clusterer(struct clusterer_binds *binds)
 	binds->request_sync = cl_request_sync;
 	binds->sync_chunk_start = cl_sync_chunk_start;
 	binds->sync_chunk_iter = cl_sync_chunk_iter;
+	binds->set_partitioned_sync = cl_set_partitioned_sync;
+	binds->sync_partition = cl_sync_partition;
 	binds->shtag_get = shtag_get;
 	binds->shtag_activate = shtag_activate;
 	binds->shtag_get_all_active = shtag_get_all_active;
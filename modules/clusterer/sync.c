@@ -19,6 +19,7 @@
 
 #include "../../rw_locking.h"
 #include "../../ipc.h"
+#include "../../ut.h"
 
 #include "api.h"
 #include "node_info.h"
@@ -27,13 +28,64 @@
 #include "sync.h"
 
 int sync_packet_size = DEFAULT_SYNC_PACKET_SIZE;
+int sync_partitions = 1;
+int sync_donors = 1;
+int sync_window = 0;
+int sync_ack_timeout = DEFAULT_SYNC_ACK_TIMEOUT;
+int sync_max_queued = DEFAULT_SYNC_MAX_QUEUED;
 int _sync_from_id = 0;
 
 static bin_packet_t *sync_packet_snd;
 static int sync_prev_buf_len;
 static int *sync_last_chunk_sz;
 
-int send_sync_req(str *capability, int cluster_id, int source_id)
+/* the partition of the data set currently being sent by this process */
+static int sync_part_idx;
+static int sync_part_no = 1;
+static int sync_seq;
+static unsigned int sync_pkts_sent;
+static struct sync_stream *sync_stream;
+
+/* a sync packet, as queued while held back by the flow control window */
+struct sync_pkt {
+	bin_packet_t packet;
+	struct sync_pkt *next;
+};
+
+/* the packets of the current partition held back by the window; they are
+ * sent as the acks come in, without ever blocking while the data set is
+ * packed (the modules hold their data locks at that point) - at most
+ * sync_max_queued of them, so that the data set is never fully buffered */
+static struct sync_pkt *sync_q_head, *sync_q_tail;
+static int sync_q_len;
+
+/* all the partitions currently streamed by this node, waiting for acks */
+static struct sync_stream **sync_streams;
+static gen_lock_t *sync_streams_lock;
+
+int init_sync(void)
+{
+	sync_streams = shm_malloc(sizeof *sync_streams);
+	if (!sync_streams) {
+		LM_ERR("No more shm memory\n");
+		return -1;
+	}
+	*sync_streams = NULL;
+
+	if ((sync_streams_lock = lock_alloc()) == NULL) {
+		LM_ERR("Failed to allocate lock\n");
+		return -1;
+	}
+	if (!lock_init(sync_streams_lock)) {
+		LM_ERR("Failed to init lock\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int send_sync_part_req(str *capability, int cluster_id, int source_id,
+                              int seq, int part_idx, int part_no)
 {
 	bin_packet_t packet;
 	int rc;
@@ -44,26 +96,96 @@ int send_sync_req(str *capability, int cluster_id, int source_id)
 	}
 
 	bin_push_str(&packet, capability);
+	bin_push_int(&packet, seq);
+	bin_push_int(&packet, part_idx);
+	bin_push_int(&packet, part_no);
+	bin_push_int(&packet, sync_window);
 	msg_add_trailer(&packet, cluster_id, source_id);
 
 	rc = clusterer_send_msg(&packet, cluster_id, source_id, 0);
 	if (rc == CLUSTERER_SEND_SUCCESS)
-		LM_INFO("Sent sync request for capability '%.*s' to node %d, "
-		        "cluster %d\n", capability->len, capability->s, source_id,
-		        cluster_id);
+		LM_INFO("Sent sync request for capability '%.*s' (partition %d/%d) "
+		        "to node %d, cluster %d\n", capability->len, capability->s,
+		        part_idx + 1, part_no, source_id, cluster_id);
 
 	bin_free_packet(&packet);
 
 	return rc;
 }
 
-static int get_sync_source(cluster_info_t *cluster, str *capability,
-                           enum cl_node_match_op match_cond)
+/* start tracking the progress of a new sync for @cap and return its sequence
+ * number; must be called with the cluster lock held */
+static int sync_progress_init(struct local_cap *cap, int part_no)
+{
+	cap->sync_seq++;
+	cap->sync_parts = part_no;
+	cap->sync_parts_done = 0;
+	memset(cap->sync_part_pkts, 0, sizeof cap->sync_part_pkts);
+	cap->sync_pkts = 0;
+	cap->sync_bytes = 0;
+	gettimeofday(&cap->sync_start, NULL);
+	memset(&cap->sync_end, 0, sizeof cap->sync_end);
+
+	return cap->sync_seq;
+}
+
+/* request all the partitions of the data set, spreading them over the
+ * @no_sources donor nodes */
+static int request_sync_parts(cluster_info_t *cluster, struct local_cap *cap,
+                              int *sources, int no_sources)
+{
+	int part_no, seq, i;
+	int rc = CLUSTERER_SEND_SUCCESS;
+
+	part_no = (cap->flags & CAP_SYNC_PARTITIONED) ? sync_partitions : 1;
+
+	lock_get(cluster->lock);
+	seq = sync_progress_init(cap, part_no);
+	lock_release(cluster->lock);
+
+	for (i = 0; i < part_no; i++) {
+		rc = send_sync_part_req(&cap->reg.name, cluster->cluster_id,
+		                        sources[i % no_sources], seq, i, part_no);
+		if (rc != CLUSTERER_SEND_SUCCESS)
+			break;
+	}
+
+	return rc;
+}
+
+int send_sync_req(str *capability, int cluster_id, int source_id)
+{
+	cluster_info_t *cluster;
+	struct local_cap *lcap;
+
+	cluster = get_cluster_by_id(cluster_id);
+	if (!cluster) {
+		LM_ERR("Unknown cluster [%d]\n", cluster_id);
+		return CLUSTERER_SEND_ERR;
+	}
+
+	for (lcap = cluster->capabilities; lcap; lcap = lcap->next)
+		if (!str_strcmp(capability, &lcap->reg.name))
+			break;
+	if (!lcap) {
+		LM_ERR("Request sync for unknown capability: %.*s\n",
+			capability->len, capability->s);
+		return CLUSTERER_SEND_ERR;
+	}
+
+	return request_sync_parts(cluster, lcap, &source_id, 1);
+}
+
+/* fill in @sources with up to @max_sources nodes able to act as donors */
+static int get_sync_sources(cluster_info_t *cluster, str *capability,
+                   enum cl_node_match_op match_cond, int *sources, int max_sources)
 {
 	node_info_t *node;
 	struct remote_cap *cap;
+	int no_sources = 0;
 
-	for (node = cluster->node_list; node; node = node->next) {
+	for (node = cluster->node_list; node && no_sources < max_sources;
+		node = node->next) {
 		if (get_next_hop(node) == 0)
 			continue;
 
@@ -77,22 +199,21 @@ static int get_sync_source(cluster_info_t *cluster, str *capability,
 
 		/* if the node does have the capability and it's in the OK state
 		 * then it can be a source for syncing */
-		if (cap && cap->flags & CAP_STATE_OK) {
-			lock_release(node->lock);
-			return node->node_id;
-		}
+		if (cap && cap->flags & CAP_STATE_OK)
+			sources[no_sources++] = node->node_id;
 
 		lock_release(node->lock);
 	}
 
-	return 0;
+	return no_sources;
 }
 
 int cl_request_sync(str *capability, int cluster_id)
 {
 	cluster_info_t *cluster;
 	struct local_cap *lcap;
-	int source_id;
+	int sources[MAX_SYNC_PARTITIONS];
+	int no_sources;
 	int rc;
 
 	LM_DBG("requesting %.*s sync in cluster %d\n",
@@ -134,8 +255,9 @@ int cl_request_sync(str *capability, int cluster_id)
 	} else
 		lock_release(cluster->lock);
 
-	source_id = get_sync_source(cluster, capability, lcap->reg.sync_cond);
-	if (source_id == 0) {	/* we didn't find any node ready to sync from */
+	no_sources = get_sync_sources(cluster, capability, lcap->reg.sync_cond,
+		sources, (lcap->flags & CAP_SYNC_PARTITIONED) ? sync_donors : 1);
+	if (no_sources == 0) {	/* we didn't find any node ready to sync from */
 		LM_DBG("donor node not found\n");
 		/* send requst later */
 		lock_get(cluster->lock);
@@ -146,8 +268,8 @@ int cl_request_sync(str *capability, int cluster_id)
 
 		lock_release(cluster->lock);
 	} else {
-		LM_DBG("found donor node: %d\n", source_id);
-		rc = send_sync_req(capability, cluster_id, source_id);
+		LM_DBG("found %d donor node(s), first: %d\n", no_sources, sources[0]);
+		rc = request_sync_parts(cluster, lcap, sources, no_sources);
 		if (rc == CLUSTERER_DEST_DOWN || rc == CLUSTERER_CURR_DISABLED) {
 			/* node was up and ready but in the meantime got disabled or down */
 			lock_get(cluster->lock);
@@ -160,13 +282,133 @@ int cl_request_sync(str *capability, int cluster_id)
 	return 0;
 }
 
+int cl_set_partitioned_sync(str *capability, int cluster_id)
+{
+	cluster_info_t *cluster;
+	struct local_cap *lcap;
+
+	cluster = get_cluster_by_id(cluster_id);
+	if (!cluster) {
+		LM_ERR("Unknown cluster [%d]\n", cluster_id);
+		return -1;
+	}
+
+	for (lcap = cluster->capabilities; lcap; lcap = lcap->next)
+		if (!str_strcmp(capability, &lcap->reg.name))
+			break;
+	if (!lcap) {
+		LM_ERR("Unknown capability: %.*s\n", capability->len, capability->s);
+		return -1;
+	}
+
+	lcap->flags |= CAP_SYNC_PARTITIONED;
+	return 0;
+}
+
+int cl_sync_partition(int *part_idx, int *part_no)
+{
+	*part_idx = sync_part_idx;
+	*part_no = sync_part_no;
+
+	return 0;
+}
+
+/* tells if one more packet fits into the flow control window */
+static int sync_window_open(void)
+{
+	unsigned int in_flight;
+
+	lock_get(sync_streams_lock);
+	sync_stream->pkts_sent = sync_pkts_sent;
+	in_flight = sync_stream->pkts_sent - sync_stream->pkts_acked;
+	lock_release(sync_streams_lock);
+
+	return in_flight < sync_stream->window;
+}
+
+static int sync_send(struct sync_pkt *sp, int cluster_id, int dst_id)
+{
+	int rc;
+
+	if ((rc = clusterer_send_msg(&sp->packet, cluster_id, dst_id, 0)) < 0)
+		LM_ERR("Failed to send sync packet, rc=%d\n", rc);
+	else
+		sync_pkts_sent++;
+
+	bin_free_packet(&sp->packet);
+	pkg_free(sp);
+
+	return rc;
+}
+
+/* send the queued packets, as long as the flow control window allows it */
+static int sync_flush_queue(int cluster_id, int dst_id)
+{
+	struct sync_pkt *sp;
+	int rc = CLUSTERER_SEND_SUCCESS;
+
+	while ((sp = sync_q_head)) {
+		if (sync_stream->window && !sync_window_open())
+			break;
+
+		sync_q_head = sp->next;
+		if (!sync_q_head)
+			sync_q_tail = NULL;
+		sync_q_len--;
+
+		rc = sync_send(sp, cluster_id, dst_id);
+	}
+
+	return rc;
+}
+
+static int send_sync_packet(int cluster_id, int dst_id)
+{
+	struct sync_pkt *sp = (struct sync_pkt *)sync_packet_snd;
+	int rc;
+
+	msg_add_trailer(sync_packet_snd, cluster_id, dst_id);
+
+	sync_packet_snd = NULL;
+	sync_last_chunk_sz = NULL;
+
+	if (!sync_stream)
+		return sync_send(sp, cluster_id, dst_id);
+
+	/* flow controlled - queue the packet and send what the window allows */
+	sp->next = NULL;
+	if (sync_q_tail)
+		sync_q_tail->next = sp;
+	else
+		sync_q_head = sp;
+	sync_q_tail = sp;
+	sync_q_len++;
+
+	rc = sync_flush_queue(cluster_id, dst_id);
+	if (sync_q_len <= sync_max_queued)
+		return rc;
+
+	/* the receiver cannot keep up with the packing - rather than buffering
+	 * the whole data set, send the rest of it right away */
+	LM_WARN("more than %d sync packets held back for node %d, disabling "
+	        "flow control for partition %d/%d\n", sync_max_queued,
+	        sync_stream->node_id, sync_stream->part_idx + 1, sync_part_no);
+
+	lock_get(sync_streams_lock);
+	sync_stream->window = 0;
+	lock_release(sync_streams_lock);
+
+	return sync_flush_queue(cluster_id, dst_id);
+}
+
 bin_packet_t *cl_sync_chunk_start(str *capability, int cluster_id, int dst_id,
                                   short data_version)
 {
 	str bin_buffer;
 	int prev_chunk_size = 0;
 	int aloc_new_pkt = 0;
-	bin_packet_t *new_packet = NULL;
+	struct sync_pkt *new_pkt;
+	bin_packet_t *new_packet;
 
 	if (sync_packet_snd) {
 		bin_get_buffer(sync_packet_snd, &bin_buffer);
@@ -183,31 +425,26 @@ bin_packet_t *cl_sync_chunk_start(str *capability, int cluster_id, int dst_id,
 			*sync_last_chunk_sz = prev_chunk_size;
 
 			/* send and free the previous packet */
-			msg_add_trailer(sync_packet_snd, cluster_id, dst_id);
-
-			if (clusterer_send_msg(sync_packet_snd, cluster_id, dst_id, 0) < 0)
-				LM_ERR("Failed to send sync packet\n");
-
-			bin_free_packet(sync_packet_snd);
-			pkg_free(sync_packet_snd);
-			sync_packet_snd = NULL;
-			sync_last_chunk_sz = NULL;
+			send_sync_packet(cluster_id, dst_id);
 		}
 
-		new_packet = pkg_malloc(sizeof *new_packet);
-		if (!new_packet) {
+		new_pkt = pkg_malloc(sizeof *new_pkt);
+		if (!new_pkt) {
 			LM_ERR("No more pkg memory\n");
 			return NULL;
 		}
+		new_packet = &new_pkt->packet;
 
 		if (bin_init(new_packet,&cl_extra_cap,CLUSTERER_SYNC,BIN_SYNC_VERSION,0)<0) {
 			LM_ERR("Failed to init bin packet\n");
-			pkg_free(new_packet);
+			pkg_free(new_pkt);
 			return NULL;
 		}
 
 		bin_push_str(new_packet, capability);
 		bin_push_int(new_packet, data_version);
+		bin_push_int(new_packet, sync_seq);
+		bin_push_int(new_packet, sync_part_idx);
 		sync_packet_snd = new_packet;
 	}
 
@@ -278,12 +515,226 @@ int cl_sync_chunk_iter(bin_packet_t *packet)
 	return 1;
 }
 
-void send_sync_repl(int sender, void *param)
+static struct sync_stream *sync_stream_add(struct reply_rpc_params *p)
+{
+	struct sync_stream *stream;
+
+	stream = shm_malloc(sizeof *stream + p->cap_name.len);
+	if (!stream) {
+		LM_ERR("No more shm memory\n");
+		return NULL;
+	}
+	memset(stream, 0, sizeof *stream);
+
+	stream->cluster_id = p->cluster->cluster_id;
+	stream->node_id = p->node_id;
+	stream->seq = p->seq;
+	stream->part_idx = p->part_idx;
+	stream->part_no = p->part_no;
+	stream->window = p->window;
+	/* the stream may outlive the reply params */
+	stream->cap_name.s = (char *)(stream + 1);
+	stream->cap_name.len = p->cap_name.len;
+	memcpy(stream->cap_name.s, p->cap_name.s, p->cap_name.len);
+
+	lock_get(sync_streams_lock);
+	stream->next = *sync_streams;
+	*sync_streams = stream;
+	lock_release(sync_streams_lock);
+
+	return stream;
+}
+
+/* assumes sync_streams_lock is acquired */
+static void sync_stream_unlink_unsafe(struct sync_stream *stream)
+{
+	struct sync_stream *it, *prev = NULL;
+
+	for (it = *sync_streams; it; prev = it, it = it->next)
+		if (it == stream) {
+			if (prev)
+				prev->next = it->next;
+			else
+				*sync_streams = it->next;
+			break;
+		}
+}
+
+static void sync_stream_del(struct sync_stream *stream)
+{
+	lock_get(sync_streams_lock);
+	sync_stream_unlink_unsafe(stream);
+	lock_release(sync_streams_lock);
+
+	shm_free(stream);
+}
+
+/* send the indication that all the sync packets were sent */
+static void send_sync_end(int cluster_id, int node_id, str *cap_name, int seq,
+                          int part_idx, int part_no, unsigned int pkts)
 {
 	bin_packet_t sync_end_pkt;
+
+	if (bin_init(&sync_end_pkt,&cl_extra_cap,CLUSTERER_SYNC_END,BIN_SYNC_VERSION,0)<0) {
+		LM_ERR("Failed to init bin packet\n");
+		return;
+	}
+	bin_push_str(&sync_end_pkt, cap_name);
+	bin_push_int(&sync_end_pkt, seq);
+	bin_push_int(&sync_end_pkt, part_idx);
+	bin_push_int(&sync_end_pkt, part_no);
+	bin_push_int(&sync_end_pkt, pkts);
+	msg_add_trailer(&sync_end_pkt, cluster_id, node_id);
+
+	if (clusterer_send_msg(&sync_end_pkt, cluster_id, node_id, 0) < 0) {
+		LM_ERR("Failed to send sync end message\n");
+		bin_free_packet(&sync_end_pkt);
+		return;
+	}
+
+	bin_free_packet(&sync_end_pkt);
+
+	LM_INFO("Sent all sync packets (%u) for capability '%.*s', partition "
+	        "%d/%d, to node %d, cluster %d\n", pkts, cap_name->len,
+	        cap_name->s, part_idx + 1, part_no, node_id, cluster_id);
+}
+
+/* send a sync packet, as already built */
+static int send_sync_buf(str *buf, int cluster_id, int dst_id)
+{
+	bin_packet_t packet;
+	int rc;
+
+	bin_init_buffer(&packet, buf->s, buf->len);
+	if ((rc = clusterer_send_msg(&packet, cluster_id, dst_id, 0)) < 0)
+		LM_ERR("Failed to send sync packet, rc=%d\n", rc);
+
+	return rc;
+}
+
+/* send the packets of a packed stream, as long as its window allows it,
+ * and finish the stream once they were all sent; only one process at a
+ * time, so that the packets keep their order
+ *
+ * Important : to be called with sync_streams_lock acquired, which is
+ * released on return */
+static void sync_stream_flush(struct sync_stream *stream)
+{
+	struct sync_shm_pkt *sp;
+	int done;
+
+	if (!stream->packed || stream->flushing) {
+		lock_release(sync_streams_lock);
+		return;
+	}
+	stream->flushing = 1;
+
+	while ((sp = stream->q_head) && (!stream->window ||
+	        stream->pkts_sent - stream->pkts_acked < stream->window)) {
+		stream->q_head = sp->next;
+		if (!stream->q_head)
+			stream->q_tail = NULL;
+		stream->pkts_sent++;
+		lock_release(sync_streams_lock);
+
+		done = send_sync_buf(&sp->buf, stream->cluster_id, stream->node_id);
+		shm_free(sp);
+
+		lock_get(sync_streams_lock);
+		if (done >= 0)
+			stream->pkts_done++;
+	}
+
+	done = !stream->q_head;
+	if (done)
+		sync_stream_unlink_unsafe(stream);
+	stream->flushing = 0;
+	lock_release(sync_streams_lock);
+
+	if (done) {
+		send_sync_end(stream->cluster_id, stream->node_id, &stream->cap_name,
+			stream->seq, stream->part_idx, stream->part_no, stream->pkts_done);
+		shm_free(stream);
+	}
+}
+
+/* the data set is packed - move the packets still held back by the window
+ * to shm, to be sent as the acks come in, rather than waiting for them
+ * here; returns 0 if the stream was handed over, -1 if nothing was left
+ * to send */
+static int sync_stream_handover(struct sync_stream *stream, int cluster_id,
+                                int dst_id)
+{
+	struct sync_shm_pkt *head = NULL, *tail = NULL, *ssp;
+	struct sync_pkt *sp;
+	str buf;
+
+	if (!sync_q_head)
+		return -1;
+
+	while ((sp = sync_q_head)) {
+		bin_get_buffer(&sp->packet, &buf);
+
+		ssp = shm_malloc(sizeof *ssp + buf.len);
+		if (!ssp) {
+			LM_ERR("No more shm memory, sending the last %d sync packets "
+			       "without flow control\n", sync_q_len);
+			break;
+		}
+		ssp->buf.s = (char *)(ssp + 1);
+		ssp->buf.len = buf.len;
+		memcpy(ssp->buf.s, buf.s, buf.len);
+		ssp->next = NULL;
+		if (tail)
+			tail->next = ssp;
+		else
+			head = ssp;
+		tail = ssp;
+
+		sync_q_head = sp->next;
+		sync_q_len--;
+		bin_free_packet(&sp->packet);
+		pkg_free(sp);
+	}
+
+	if (sync_q_head) {
+		/* out of shm - send them all right away, in order */
+		while ((ssp = head)) {
+			head = ssp->next;
+			if (send_sync_buf(&ssp->buf, cluster_id, dst_id) >= 0)
+				sync_pkts_sent++;
+			shm_free(ssp);
+		}
+
+		lock_get(sync_streams_lock);
+		stream->window = 0;
+		lock_release(sync_streams_lock);
+
+		sync_flush_queue(cluster_id, dst_id);
+		return -1;
+	}
+	sync_q_tail = NULL;
+
+	lock_get(sync_streams_lock);
+	stream->q_head = head;
+	stream->q_tail = tail;
+	stream->pkts_sent = sync_pkts_sent;
+	stream->pkts_done = sync_pkts_sent;
+	stream->last_ack = get_uticks();
+	stream->packed = 1;
+
+	/* some acks may have come in meanwhile */
+	sync_stream_flush(stream);
+
+	return 0;
+}
+
+void send_sync_repl(int sender, void *param)
+{
 	str bin_buffer;
 	struct local_cap *cap;
-	int rc, cluster_id;
+	struct sync_stream *stream;
+	int cluster_id;
 	struct reply_rpc_params *p = (struct reply_rpc_params *)param;
 
 	lock_start_read(cl_list_lock);
@@ -295,9 +746,17 @@ void send_sync_repl(int sender, void *param)
 		LM_ERR("Sync request for unknown capability: %.*s\n",
 			p->cap_name.len, p->cap_name.s);
 		lock_stop_read(cl_list_lock);
+		shm_free(param);
 		return;
 	}
 
+	sync_seq = p->seq;
+	sync_part_idx = p->part_idx;
+	sync_part_no = p->part_no;
+	sync_pkts_sent = 0;
+	if (p->window > 0)
+		sync_stream = sync_stream_add(p);
+
 	cap->reg.event_cb(SYNC_REQ_RCV, p->node_id);
 
 	if (sync_packet_snd) {
@@ -305,47 +764,38 @@ void send_sync_repl(int sender, void *param)
 		*sync_last_chunk_sz = bin_buffer.len - sync_prev_buf_len;
 
 		/* send and free the lastly built packet */
-		msg_add_trailer(sync_packet_snd, p->cluster->cluster_id, p->node_id);
-
-		if ((rc = clusterer_send_msg(sync_packet_snd, p->cluster->cluster_id,
-			p->node_id, 0))<0)
-			LM_ERR("Failed to send sync packet, rc=%d\n", rc);
-
-		bin_free_packet(sync_packet_snd);
-		pkg_free(sync_packet_snd);
-		sync_packet_snd = NULL;
-		sync_last_chunk_sz = NULL;
-	}
-
-	/* send indication that all sync packets were sent */
-	if (bin_init(&sync_end_pkt,&cl_extra_cap,CLUSTERER_SYNC_END,BIN_SYNC_VERSION,0)<0) {
-		LM_ERR("Failed to init bin packet\n");
-		lock_stop_read(cl_list_lock);
-		return;
-	}
-	bin_push_str(&sync_end_pkt, &p->cap_name);
-	msg_add_trailer(&sync_end_pkt, p->cluster->cluster_id, p->node_id);
-
-	if (clusterer_send_msg(&sync_end_pkt, p->cluster->cluster_id, p->node_id,
-		0) < 0) {
-		LM_ERR("Failed to send sync end message\n");
-		bin_free_packet(&sync_end_pkt);
-		lock_stop_read(cl_list_lock);
-		return;
+		send_sync_packet(p->cluster->cluster_id, p->node_id);
 	}
 
 	cluster_id = p->cluster->cluster_id;
 	lock_stop_read(cl_list_lock);
 
-	bin_free_packet(&sync_end_pkt);
+	sync_part_idx = 0;
+	sync_part_no = 1;
+
+	if (sync_stream) {
+		stream = sync_stream;
+
+		/* the held back packets, and the sync end after them, are sent
+		 * as the acks come in (see handle_sync_ack() and sync_timer()) */
+		if (sync_stream_handover(stream, cluster_id, p->node_id) == 0) {
+			sync_stream = NULL;
+			shm_free(param);
+			return;
+		}
+
+		sync_stream = NULL;
+		sync_stream_del(stream);
+	}
 
-	LM_INFO("Sent all sync packets for capability '%.*s' to node %d, cluster "
-	        "%d\n", p->cap_name.len, p->cap_name.s, p->node_id, cluster_id);
+	send_sync_end(cluster_id, p->node_id, &p->cap_name, p->seq, p->part_idx,
+		p->part_no, sync_pkts_sent);
 
 	shm_free(param);
 }
 
-int ipc_dispatch_sync_reply(cluster_info_t *cluster, int node_id, str *cap_name)
+int ipc_dispatch_sync_reply(cluster_info_t *cluster, int node_id, str *cap_name,
+                            int seq, int part_idx, int part_no, int window)
 {
 	struct reply_rpc_params *params;
 
@@ -361,6 +811,10 @@ int ipc_dispatch_sync_reply(cluster_info_t *cluster, int node_id, str *cap_name)
 	params->cap_name.len = cap_name->len;
 	params->node_id = node_id;
 	params->cluster = cluster;
+	params->seq = seq;
+	params->part_idx = part_idx;
+	params->part_no = part_no;
+	params->window = window;
 
 	if (ipc_dispatch_rpc(send_sync_repl, params) < 0) {
 		LM_ERR("Failed to dispatch rpc\n");
@@ -375,13 +829,30 @@ void handle_sync_request(bin_packet_t *packet, cluster_info_t *cluster,
 {
 	str cap_name;
 	struct remote_cap *cap;
+	int seq, part_idx, part_no, window;
 	int rc;
 
+	if (get_bin_pkg_version(packet) != BIN_SYNC_VERSION) {
+		LM_INFO("discarding sync request version %d, need version %d\n",
+		        get_bin_pkg_version(packet), BIN_SYNC_VERSION);
+		return;
+	}
+
 	bin_pop_str(packet, &cap_name);
+	bin_pop_int(packet, &seq);
+	bin_pop_int(packet, &part_idx);
+	bin_pop_int(packet, &part_no);
+	bin_pop_int(packet, &window);
+
+	if (part_no < 1 || part_idx < 0 || part_idx >= part_no) {
+		LM_ERR("Bad sync partition %d/%d requested by node %d\n",
+			part_idx + 1, part_no, source->node_id);
+		return;
+	}
 
-	LM_INFO("Received sync request for capability '%.*s' from node %d, "
-	        "cluster %d\n", cap_name.len, cap_name.s, source->node_id,
-	        cluster->cluster_id);
+	LM_INFO("Received sync request for capability '%.*s' (partition %d/%d) "
+	        "from node %d, cluster %d\n", cap_name.len, cap_name.s,
+	        part_idx + 1, part_no, source->node_id, cluster->cluster_id);
 
 	rc = get_capability_status(cluster, &cap_name);
 	if (rc == -1) {
@@ -392,7 +863,8 @@ void handle_sync_request(bin_packet_t *packet, cluster_info_t *cluster,
 	}
 
 	if (get_next_hop(source)) {
-		if (ipc_dispatch_sync_reply(cluster, source->node_id, &cap_name) < 0)
+		if (ipc_dispatch_sync_reply(cluster, source->node_id, &cap_name,
+			seq, part_idx, part_no, window) < 0)
 			LM_ERR("Failed to dispatch sync reply job\n");
 	} else {
 		lock_get(source->lock);
@@ -407,12 +879,174 @@ void handle_sync_request(bin_packet_t *packet, cluster_info_t *cluster,
 			return;
 		}
 
-		/* reply to sync later when the node is up */
+		/* reply to sync later when the node is up; the whole data set
+		 * will be sent at that point, regardless of the partitioning */
 		cap->flags |= CAP_SYNC_PENDING;
+		cap->sync_seq = seq;
 		lock_release(source->lock);
 	}
 }
 
+void handle_sync_ack(bin_packet_t *packet, cluster_info_t *cluster,
+                     int source_id)
+{
+	str cap_name;
+	struct sync_stream *stream;
+	int seq, part_idx, pkts_acked;
+
+	bin_pop_str(packet, &cap_name);
+	bin_pop_int(packet, &seq);
+	bin_pop_int(packet, &part_idx);
+	bin_pop_int(packet, &pkts_acked);
+
+	lock_get(sync_streams_lock);
+
+	for (stream = *sync_streams; stream; stream = stream->next)
+		if (stream->cluster_id == cluster->cluster_id &&
+			stream->node_id == source_id && stream->seq == seq &&
+			stream->part_idx == part_idx &&
+			!str_strcmp(&stream->cap_name, &cap_name))
+			break;
+
+	if (!stream) {
+		lock_release(sync_streams_lock);
+		LM_DBG("sync ack for unknown stream (partition %d) from node %d\n",
+			part_idx + 1, source_id);
+		return;
+	}
+
+	if ((int)((unsigned int)pkts_acked - stream->pkts_acked) > 0) {
+		stream->pkts_acked = pkts_acked;
+		stream->last_ack = get_uticks();
+	}
+
+	/* send what the window now allows, if the data set was packed */
+	sync_stream_flush(stream);
+}
+
+/* gives up on the flow control for the packed streams not acknowledged
+ * in time, sending them all */
+void sync_timer(utime_t ticks, void *param)
+{
+	struct sync_stream *stream;
+	utime_t now = get_uticks();
+
+again:
+	lock_get(sync_streams_lock);
+
+	for (stream = *sync_streams; stream; stream = stream->next)
+		if (stream->packed && !stream->flushing && stream->window &&
+		        now - stream->last_ack >= (utime_t)sync_ack_timeout * 1000) {
+			LM_WARN("no sync acks from node %d in %d ms, disabling flow "
+			        "control for partition %d/%d\n", stream->node_id,
+			        sync_ack_timeout, stream->part_idx + 1, stream->part_no);
+			stream->window = 0;
+
+			/* releases the lock, the list may change meanwhile */
+			sync_stream_flush(stream);
+			goto again;
+		}
+
+	lock_release(sync_streams_lock);
+}
+
+static int send_sync_ack(cluster_info_t *cluster, struct local_cap *cap,
+                         int dst_id, int seq, int part_idx, int pkts_acked)
+{
+	bin_packet_t packet;
+	int rc;
+
+	if (bin_init(&packet, &cl_extra_cap, CLUSTERER_SYNC_ACK, BIN_SYNC_VERSION, 0) < 0) {
+		LM_ERR("Failed to init bin send buffer\n");
+		return -1;
+	}
+
+	bin_push_str(&packet, &cap->reg.name);
+	bin_push_int(&packet, seq);
+	bin_push_int(&packet, part_idx);
+	bin_push_int(&packet, pkts_acked);
+	msg_add_trailer(&packet, cluster->cluster_id, dst_id);
+
+	rc = clusterer_send_msg(&packet, cluster->cluster_id, dst_id, 0);
+	if (rc != CLUSTERER_SEND_SUCCESS)
+		LM_DBG("Failed to send sync ack to node %d, rc=%d\n", dst_id, rc);
+
+	bin_free_packet(&packet);
+
+	return rc;
+}
+
+static void run_sync_packet_cb(int sender, void *param)
+{
+	extern char *next_data_chunk;
+	struct sync_pkt_rpc_params *p = (struct sync_pkt_rpc_params *)param;
+	bin_packet_t packet;
+	str cap_name;
+	int data_version, seq, part_idx, pkts = 0;
+
+	bin_init_buffer(&packet, p->pkt_buf.s, p->pkt_buf.len);
+	packet.src_id = p->pkt_src_id;
+	packet.type = SYNC_PACKET_TYPE;
+
+	/* this packet is cloned and all below fields have been used */
+	bin_pop_str(&packet, &cap_name);
+	bin_pop_int(&packet, &data_version);
+	bin_pop_int(&packet, &seq);
+	bin_pop_int(&packet, &part_idx);
+	next_data_chunk = NULL;
+
+	p->cap->reg.packet_cb(&packet);
+
+	if (sync_window <= 0) {
+		shm_free(param);
+		return;
+	}
+
+	/* acknowledge the packets processed so far, so the donor may keep
+	 * streaming this partition */
+	lock_start_read(cl_list_lock);
+
+	lock_get(p->cluster->lock);
+	if (seq == p->cap->sync_seq && part_idx >= 0 &&
+		part_idx < MAX_SYNC_PARTITIONS)
+		pkts = ++p->cap->sync_part_pkts[part_idx];
+	lock_release(p->cluster->lock);
+
+	if (pkts && pkts % SYNC_ACK_EVERY(sync_window) == 0)
+		send_sync_ack(p->cluster, p->cap, p->pkt_src_id, seq, part_idx, pkts);
+
+	lock_stop_read(cl_list_lock);
+
+	shm_free(param);
+}
+
+static int ipc_dispatch_sync_packet(bin_packet_t *packet,
+                          cluster_info_t *cluster, struct local_cap *cap)
+{
+	struct sync_pkt_rpc_params *params;
+
+	params = shm_malloc(sizeof *params + packet->buffer.len);
+	if (!params) {
+		LM_ERR("oom!\n");
+		return -1;
+	}
+	memset(params, 0, sizeof *params);
+	params->pkt_buf.s = (char *)(params + 1);
+
+	memcpy(params->pkt_buf.s, packet->buffer.s, packet->buffer.len);
+	params->pkt_buf.len = packet->buffer.len;
+	params->cluster = cluster;
+	params->cap = cap;
+	params->pkt_src_id = packet->src_id;
+
+	if (ipc_dispatch_rpc(run_sync_packet_cb, params) < 0) {
+		LM_ERR("Failed to dispatch rpc\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 static void run_cb_buf_pkt(int sender, void *param)
 {
 	struct packet_rpc_params *p = (struct packet_rpc_params *)param;
@@ -465,7 +1099,7 @@ void handle_sync_packet(bin_packet_t *packet, int packet_type,
 	str cap_name;
 	struct local_cap *cap;
 	struct buf_bin_pkt *buf_pkt, *buf_tmp;
-	int data_version;
+	int data_version, seq, part_idx, part_no, pkts_sent;
 
 	if (get_bin_pkg_version(packet) != BIN_SYNC_VERSION) {
 		LM_INFO("discarding sync packet version %d, need version %d\n",
@@ -490,10 +1124,15 @@ void handle_sync_packet(bin_packet_t *packet, int packet_type,
 
 	if (packet_type == CLUSTERER_SYNC) {
 		bin_pop_int(packet, &data_version);
+		bin_pop_int(packet, &seq);
 
 		lock_get(cluster->lock);
 		/* buffer other types of packets during sync */
 		cap->flags |= CAP_PKT_BUFFERING;
+		if (seq == cap->sync_seq) {
+			cap->sync_pkts++;
+			cap->sync_bytes += packet->buffer.len;
+		}
 		lock_release(cluster->lock);
 
 		/* overwrite packet type with one identifiable by modules */
@@ -501,14 +1140,42 @@ void handle_sync_packet(bin_packet_t *packet, int packet_type,
 		packet->src_id = source_id;
 		set_bin_pkg_version(packet, (short)data_version);
 
-		if (ipc_dispatch_mod_packet(packet, &cap->reg) < 0)
+		if (ipc_dispatch_sync_packet(packet, cluster, cap) < 0)
 			LM_ERR("Failed to dispatch handling of module packet\n");
 	} else { /* CLUSTERER_SYNC_END */
-		LM_INFO("Received all sync packets for capability '%.*s' in "
-		        "cluster %d\n", cap_name.len, cap_name.s, cluster->cluster_id);
+		bin_pop_int(packet, &seq);
+		bin_pop_int(packet, &part_idx);
+		bin_pop_int(packet, &part_no);
+		bin_pop_int(packet, &pkts_sent);
 
 		lock_get(cluster->lock);
 
+		if (seq != cap->sync_seq) {
+			lock_release(cluster->lock);
+			LM_DBG("stale sync end for capability '%.*s' from node %d\n",
+				cap_name.len, cap_name.s, source_id);
+			return;
+		}
+
+		/* a partition count of 1 means the donor sent the whole data set */
+		if (part_no <= 1)
+			cap->sync_parts_done = cap->sync_parts;
+		else
+			cap->sync_parts_done++;
+
+		if (cap->sync_parts_done < cap->sync_parts) {
+			lock_release(cluster->lock);
+			LM_INFO("Received all sync packets (%d) for capability '%.*s', "
+			        "partition %d/%d, in cluster %d\n", pkts_sent, cap_name.len,
+			        cap_name.s, part_idx + 1, part_no, cluster->cluster_id);
+			return;
+		}
+
+		gettimeofday(&cap->sync_end, NULL);
+
+		LM_INFO("Received all sync packets for capability '%.*s' in "
+		        "cluster %d\n", cap_name.len, cap_name.s, cluster->cluster_id);
+
 		/* post-sync phase */
 		buf_pkt = cap->pkt_q_front;
 		while (buf_pkt) {
@@ -21,31 +21,89 @@
 #define CLUSTERER_SYNC_H
 
 #include "../../bin_interface.h"
+#include "../../timer.h"
 
 #define DEFAULT_SYNC_PACKET_SIZE 32768
 #define SYNC_CHUNK_START_MARKER 101010101
+#define DEFAULT_SYNC_ACK_TIMEOUT 500 /* ms */
+#define DEFAULT_SYNC_MAX_QUEUED 64
+#define SYNC_TIMER_INTERVAL 100 /* ms */
+
+/* the receiver acks every half window of processed sync packets */
+#define SYNC_ACK_EVERY(_window) ((_window) > 1 ? (_window) / 2 : 1)
 
 extern int sync_packet_size;
+extern int sync_partitions;
+extern int sync_donors;
+extern int sync_window;
+extern int sync_ack_timeout;
+extern int sync_max_queued;
 
 struct reply_rpc_params {
 	cluster_info_t *cluster;
 	str cap_name;
 	int node_id;
+	int seq;
+	int part_idx;
+	int part_no;
+	int window;
+};
+
+struct sync_pkt_rpc_params {
+	cluster_info_t *cluster;
+	struct local_cap *cap;
+	int pkt_src_id;
+	str pkt_buf;
+};
+
+/* a sync packet left to send once the data set was packed */
+struct sync_shm_pkt {
+	str buf;
+	struct sync_shm_pkt *next;
 };
 
+/* a partition of a capability's data set, currently streamed to a node */
+struct sync_stream {
+	int cluster_id;
+	int node_id;
+	int seq;
+	int part_idx;
+	int part_no;
+	str cap_name;
+	unsigned int window;
+	unsigned int pkts_sent;
+	unsigned int pkts_acked;
+	/* the packets held back by the window when the packing was over; they
+	 * are sent by the processes getting the acks, or by the sync timer */
+	struct sync_shm_pkt *q_head, *q_tail;
+	unsigned int pkts_done;  /* the packets successfully sent */
+	int packed;
+	int flushing;
+	utime_t last_ack;
+	struct sync_stream *next;
+};
+
+int init_sync(void);
+
 int cl_request_sync(str *capability, int cluster_id);
 bin_packet_t *cl_sync_chunk_start(str *capability, int cluster_id, int dst_id,
                                   short data_version);
 int cl_sync_chunk_iter(bin_packet_t *packet);
+int cl_sync_partition(int *part_idx, int *part_no);
+int cl_set_partitioned_sync(str *capability, int cluster_id);
 
 void handle_sync_request(bin_packet_t *packet, cluster_info_t *cluster,
 							node_info_t *source);
 void handle_sync_packet(bin_packet_t *packet, int packet_type,
 								cluster_info_t *cluster, int source_id);
+void handle_sync_ack(bin_packet_t *packet, cluster_info_t *cluster,
+								int source_id);
+void sync_timer(utime_t ticks, void *param);
 
 int buffer_bin_pkt(bin_packet_t *packet, struct local_cap *cap, int src_id);
 int send_sync_req(str *capability, int cluster_id, int source_id);
-int ipc_dispatch_sync_reply(cluster_info_t *cluster, int node_id, str *cap_name);
+int ipc_dispatch_sync_reply(cluster_info_t *cluster, int node_id, str *cap_name,
+                            int seq, int part_idx, int part_no, int window);
 
 #endif  /* CLUSTERER_SYNC_H */
 
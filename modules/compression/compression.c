@@ -322,6 +322,8 @@ void wrap_tm_func(struct cell* t, int type, struct tmcb_params* p)
 	if (ret < 0)
 		return;
 
+	if (buf != t->uac[p->code].request.buffer.s)
+		tm_api.t_buf_free(t, t->uac[p->code].request.buffer.s);
 	t->uac[p->code].request.buffer.s = buf;
 	t->uac[p->code].request.buffer.len = olen;
 	/* we also need to compute the uri so that it points within the new buffer */
@@ -928,7 +930,7 @@ again:
 
 	switch (type) {
 		case TM_CB:
-			shm_free(*buf_p);
+			/* the old buffer is released by the caller, through TM */
 			*buf_p = shm_malloc(new_buf.len);
 			if (*buf_p == NULL) {
 				LM_ERR("no more sh mem\n");
@@ -1527,7 +1529,7 @@ only_body:
 
 	switch (type) {
 		case TM_CB:
-			shm_free(*buf_p);
+			/* the old buffer is released by the caller, through TM */
 			*buf_p = shm_malloc(buf2send.len+1);
 			if (*buf_p == NULL) {
 				LM_ERR("no more sh mem\n");
@@ -169,6 +169,7 @@ int db_mysql_bind_api(const str* mod, db_func_t *dbb)
 	dbb->raw_query         = db_mysql_raw_query;
 	dbb->free_result       = db_mysql_free_result;
 	dbb->insert            = db_mysql_insert;
+	dbb->insert_rows       = db_mysql_insert_rows;
 	dbb->delete            = db_mysql_delete;
 	dbb->update            = db_mysql_update;
 	dbb->replace           = db_mysql_replace;
@@ -1334,6 +1334,70 @@ res_ins:
 	return ret;
 }
 
+/* the most placeholders a MySQL prepared statement may hold */
+#define MYSQL_PS_MAX_PARAMS 65535
+
+/**
+ * Insert a batch of rows into a specified table, as a single
+ * multi-row INSERT statement.
+ * If a prepared statement is attached, the full batches (of
+ * query_buffer_size rows) are inserted through it - the statement has
+ * a fixed number of rows, so the shorter batches are sent as text.
+ * \param _h structure representing database connection
+ * \param _k key names
+ * \param _rows the rows to be inserted
+ * \param _nr number of rows
+ * \param _n number of key=value pairs
+ * \return zero on success, negative value on failure
+ */
+int db_mysql_insert_rows(const db_con_t* _h, const db_key_t* _k,
+		db_val_t** _rows, const int _nr, const int _n)
+{
+	static db_val_t *vals = NULL;
+	static int vals_no = 0;
+	db_val_t *v;
+	int ret, i;
+
+	if (!CON_HAS_PS(_h) || _nr != query_buffer_size ||
+	_nr * _n > MYSQL_PS_MAX_PARAMS)
+		goto text;
+
+	/* the statement takes all the values as a single set */
+	if (vals_no < _nr * _n) {
+		v = pkg_realloc(vals, _nr * _n * sizeof *vals);
+		if (!v) {
+			LM_ERR("no more pkg mem for %d values\n", _nr * _n);
+			goto text;
+		}
+		vals = v;
+		vals_no = _nr * _n;
+	}
+
+	for (i = 0; i < _nr; i++)
+		memcpy(vals + i * _n, _rows[i], _n * sizeof *vals);
+
+	/* not a buffered insert, the rows are already here */
+	if (CON_HAS_INSLIST(_h))
+		CON_RESET_INSLIST(_h);
+
+	if (CON_HAS_UNINIT_PS(_h)||!has_stmt_ctx(_h,&(CON_MYSQL_PS(_h)->ctx))){
+		ret = db_do_insert_rows(_h, _k, _rows, _nr, _n, db_mysql_val2str,
+			db_mysql_submit_dummy_query);
+		if (ret!=0) goto out;
+	}
+	ret = db_mysql_do_prepared_query(_h, &query_holder, vals, _nr * _n,
+		NULL, 0);
+out:
+	CON_RESET_CURR_PS(_h);
+	return ret;
+
+text:
+	CON_RESET_CURR_PS(_h);
+
+	return db_do_insert_rows(_h, _k, _rows, _nr, _n, db_mysql_val2str,
+		db_mysql_submit_query);
+}
+
 
 /**
  * Delete a row from the specified table
@@ -78,6 +78,13 @@ int db_mysql_raw_query(const db_con_t* _h, const str* _s, db_res_t** _r);
 int db_mysql_insert(const db_con_t* _h, const db_key_t* _k, const db_val_t* _v, const int _n);
 
 
+/*
+ * Insert a batch of rows into table
+ */
+int db_mysql_insert_rows(const db_con_t* _h, const db_key_t* _k,
+		db_val_t** _rows, const int _nr, const int _n);
+
+
 /*
  * Delete a row from table
  */
@@ -148,6 +148,7 @@ int db_postgres_bind_api(const str* mod, db_func_t *dbb)
 	dbb->raw_query        = db_postgres_raw_query;
 	dbb->free_result      = db_postgres_free_result;
 	dbb->insert           = db_postgres_insert;
+	dbb->insert_rows      = db_postgres_insert_rows;
 	dbb->delete           = db_postgres_delete;
 	dbb->update           = db_postgres_update;
 
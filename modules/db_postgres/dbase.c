@@ -632,6 +632,113 @@ int db_postgres_insert(const db_con_t* _h, const db_key_t* _k,
 }
 
 
+/*
+ * Insert a batch of rows into the specified table, streaming them
+ * through a single "COPY ... FROM STDIN"
+ * _h: structure representing database connection
+ * _k: key names
+ * _rows: the rows to be inserted
+ * _nr: number of rows
+ * _n: number of key=value pairs
+ */
+int db_postgres_insert_rows(const db_con_t* _h, const db_key_t* _k,
+		db_val_t** _rows, const int _nr, const int _n)
+{
+	static char copy_buf[SQL_BUF_LEN];
+	PGresult *res;
+	struct timeval start;
+	int i, j, off, l, ret, rc = -1;
+	str sql_str;
+
+	if (!_h || !_k || !_rows || !_nr || !_n) {
+		LM_ERR("invalid parameter value\n");
+		return -1;
+	}
+
+	CON_RESET_CURR_PS(_h); /* no prepared statements support */
+
+	ret = snprintf(copy_buf, SQL_BUF_LEN, "COPY %.*s (",
+		CON_TABLE(_h)->len, CON_TABLE(_h)->s);
+	if (ret < 0 || ret >= SQL_BUF_LEN)
+		goto error;
+	off = ret;
+
+	ret = db_print_columns(copy_buf + off, SQL_BUF_LEN - off, _k, _n);
+	if (ret < 0)
+		goto error;
+	off += ret;
+
+	ret = snprintf(copy_buf + off, SQL_BUF_LEN - off, ") FROM STDIN");
+	if (ret < 0 || ret >= SQL_BUF_LEN - off)
+		goto error;
+	sql_str.s = copy_buf;
+	sql_str.len = off + ret;
+
+	if (CON_RESULT(_h))
+		free_query(_h);
+
+	start_expire_timer(start, db_postgres_exec_query_threshold);
+
+	res = PQexec(CON_CONNECTION(_h), copy_buf);
+	if (PQresultStatus(res) != PGRES_COPY_IN) {
+		LM_ERR("%p failed to start COPY: %s Query: %.*s\n", _h,
+			PQerrorMessage(CON_CONNECTION(_h)), sql_str.len, sql_str.s);
+		PQclear(res);
+		if (PQstatus(CON_CONNECTION(_h)) != CONNECTION_OK)
+			PQreset(CON_CONNECTION(_h));
+		goto out;
+	}
+	PQclear(res);
+
+	for (i = 0; i < _nr; i++) {
+		for (j = 0, off = 0; j < _n; j++) {
+			l = SQL_BUF_LEN - off - 1;
+			if (l <= 0 || db_postgres_val2copy(_rows[i] + j, copy_buf + off,
+					&l) < 0) {
+				LM_ERR("failed to print value %d of row %d\n", j, i);
+				PQputCopyEnd(CON_CONNECTION(_h), "bad row");
+				goto end_copy;
+			}
+			off += l;
+			copy_buf[off++] = (j == _n - 1) ? '\n' : '\t';
+		}
+
+		if (PQputCopyData(CON_CONNECTION(_h), copy_buf, off) != 1) {
+			LM_ERR("failed to send COPY data: %s\n",
+				PQerrorMessage(CON_CONNECTION(_h)));
+			goto end_copy;
+		}
+	}
+
+	if (PQputCopyEnd(CON_CONNECTION(_h), NULL) != 1) {
+		LM_ERR("failed to end COPY: %s\n", PQerrorMessage(CON_CONNECTION(_h)));
+		goto end_copy;
+	}
+
+	rc = 0;
+
+end_copy:
+	while ((res = PQgetResult(CON_CONNECTION(_h)))) {
+		if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+			LM_ERR("COPY of %d rows into %.*s failed: %s\n", _nr,
+				CON_TABLE(_h)->len, CON_TABLE(_h)->s, PQresultErrorMessage(res));
+			rc = -1;
+		}
+		PQclear(res);
+	}
+
+out:
+	_stop_expire_timer(start, db_postgres_exec_query_threshold,
+		"pgsql copy", sql_str.s, sql_str.len, 0,
+		sql_slow_queries, sql_total_queries);
+	return rc;
+
+error:
+	LM_ERR("error while preparing COPY operation\n");
+	return -1;
+}
+
+
 /*
  * Delete a row from the specified table
  * _con: structure representing database connection
@@ -85,6 +85,13 @@ int db_postgres_insert(const db_con_t* _h, const db_key_t* _k, const db_val_t* _
 		const int _n);
 
 
+/**
+ * Insert a batch of rows into table, using COPY
+ */
+int db_postgres_insert_rows(const db_con_t* _h, const db_key_t* _k,
+		db_val_t** _rows, const int _nr, const int _n);
+
+
 /**
  * Delete a row from table
  */
@@ -331,3 +331,106 @@ int db_postgres_val2str(const db_con_t* _con, const db_val_t* _v,
 	}
 }
 
+
+
+/* escapes a string for the COPY text format */
+static int copy_escape(const char *_v, int l, char *_s, int *_len)
+{
+	char *p = _s, *end = _s + *_len;
+	int i;
+
+	for (i = 0; i < l; i++) {
+		if (end - p < 2)
+			return -1;
+
+		switch (_v[i]) {
+		case '\\': *p++ = '\\'; *p++ = '\\'; break;
+		case '\t': *p++ = '\\'; *p++ = 't'; break;
+		case '\n': *p++ = '\\'; *p++ = 'n'; break;
+		case '\r': *p++ = '\\'; *p++ = 'r'; break;
+		default: *p++ = _v[i];
+		}
+	}
+
+	*_len = p - _s;
+	return 0;
+}
+
+
+/*
+ * Prints a value in the text format expected by "COPY ... FROM STDIN"
+ */
+int db_postgres_val2copy(const db_val_t* _v, char* _s, int* _len)
+{
+	static const char hex[] = "0123456789abcdef";
+	unsigned char *b;
+	int i, l;
+
+	if ((!_v) || (!_s) || (!_len) || (!*_len)) {
+		LM_ERR("invalid parameter value\n");
+		return -1;
+	}
+
+	if (VAL_NULL(_v)) {
+		if (*_len < 2) {
+			LM_ERR("buffer too short to print NULL\n");
+			return -1;
+		}
+		_s[0] = '\\';
+		_s[1] = 'N';
+		*_len = 2;
+		return 0;
+	}
+
+	switch (VAL_TYPE(_v)) {
+	case DB_INT:
+		return db_int2str(VAL_INT(_v), _s, _len);
+
+	case DB_BIGINT:
+		return db_bigint2str(VAL_BIGINT(_v), _s, _len);
+
+	case DB_BITMAP:
+		return db_int2str(VAL_BITMAP(_v), _s, _len);
+
+	case DB_DOUBLE:
+		return db_double2str(VAL_DOUBLE(_v), _s, _len);
+
+	case DB_STRING:
+		if (copy_escape(VAL_STRING(_v), strlen(VAL_STRING(_v)), _s, _len) < 0)
+			goto too_short;
+		return 0;
+
+	case DB_STR:
+		if (copy_escape(VAL_STR(_v).s, VAL_STR(_v).len, _s, _len) < 0)
+			goto too_short;
+		return 0;
+
+	case DB_DATETIME:
+		return db_time2str_nq(VAL_TIME(_v), _s, _len);
+
+	case DB_BLOB:
+		/* bytea hex format, with the backslash escaped for COPY */
+		l = VAL_BLOB(_v).len;
+		if (*_len < 2 * l + 3)
+			goto too_short;
+
+		b = (unsigned char *)VAL_BLOB(_v).s;
+		_s[0] = '\\';
+		_s[1] = '\\';
+		_s[2] = 'x';
+		for (i = 0; i < l; i++) {
+			_s[3 + 2 * i] = hex[b[i] >> 4];
+			_s[4 + 2 * i] = hex[b[i] & 0xf];
+		}
+		*_len = 2 * l + 3;
+		return 0;
+
+	default:
+		LM_DBG("unknown data type\n");
+		return -1;
+	}
+
+too_short:
+	LM_ERR("destination buffer too short for COPY value\n");
+	return -1;
+}
@@ -27,4 +27,6 @@ int db_postgres_str2val(const db_type_t _t, db_val_t* _v, const char* _s, const
 
 int db_postgres_val2str(const db_con_t* _con, const db_val_t* _v, char* _s, int* _len);
 
+int db_postgres_val2copy(const db_val_t* _v, char* _s, int* _len);
+
 #endif
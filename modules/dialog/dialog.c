@@ -56,6 +56,7 @@
 #include "dlg_vals.h"
 #include "dlg_replication.h"
 #include "dlg_repl_profile.h"
+#include "dlg_snapshot.h"
 
 static int mod_init(void);
 static int child_init(int rank);
@@ -333,6 +334,9 @@ static param_export_t mod_params[]={
 	{ "replicate_profiles_buffer",INT_PARAM, &repl_prof_buffer_th   },
 	{ "replicate_profiles_expire",INT_PARAM, &repl_prof_timer_expire},
 	{ "cluster_auto_sync",        INT_PARAM, &cluster_auto_sync     },
+	/* restart persistency through binary snapshots */
+	{ "snapshot_file",            STR_PARAM, &dlg_snapshot_file     },
+	{ "snapshot_interval",        INT_PARAM, &dlg_snapshot_interval },
 	{ 0,0,0 }
 };
 
@@ -483,6 +487,11 @@ static dep_export_t deps = {
 	},
 };
 
+static proc_export_t procs[] = {
+	{"dialog snapshot", 0, 0, dlg_snapshot_process, 0, PROC_FLAG_HAS_IPC},
+	{0,0,0,0,0,0}
+};
+
 struct module_exports exports= {
 	"dialog",        /* module's name */
 	MOD_TYPE_DEFAULT,/* class of this module */
@@ -497,7 +506,7 @@ struct module_exports exports= {
 	mi_cmds,         /* exported MI functions */
 	mod_items,       /* exported pseudo-variables */
 	0,			 	 /* exported transformations */
-	0,               /* extra processes */
+	procs,           /* extra processes */
 	0,               /* module pre-initialization function */
 	mod_init,        /* module initialization function */
 	0,               /* reply processing function */
@@ -688,6 +697,7 @@ static void ctx_dlg_idx_destroy(void *v)
 static int mod_init(void)
 {
 	unsigned int n;
+	int snapshot;
 
 	LM_INFO("Dialog module - initializing\n");
 
@@ -859,6 +869,10 @@ static int mod_init(void)
 			return -1;
 		}
 
+		if (clusterer_api.set_partitioned_sync(&dlg_repl_cap,
+				dialog_repl_cluster) < 0)
+			LM_WARN("Cannot enable partitioned sync for dialogs\n");
+
 		if (clusterer_api.request_sync(&dlg_repl_cap, dialog_repl_cluster) < 0)
 			LM_ERR("Sync request failed\n");
 	}
@@ -927,6 +941,16 @@ static int mod_init(void)
 		return -1;
 	}
 
+	if (dlg_init_snapshot() < 0) {
+		LM_ERR("failed to initialize the snapshot support\n");
+		return -1;
+	}
+	if (dlg_snapshot_file && dlg_snapshot_interval > 0)
+		procs[0].no = 1;
+
+	/* restore the dialogs from the snapshot before looking into the DB */
+	snapshot = dlg_snapshot_load();
+
 	/* if a database should be used to store the dialogs' information */
 	if (dlg_db_mode==DB_MODE_NONE) {
 		db_url.s = 0; db_url.len = 0;
@@ -940,7 +964,8 @@ static int mod_init(void)
 			LM_ERR("db_url not configured for db_mode %d\n", dlg_db_mode);
 			return -1;
 		}
-		if (init_dlg_db(&db_url, dlg_hash_size, db_update_period)!=0) {
+		if (init_dlg_db(&db_url, dlg_hash_size, db_update_period,
+		snapshot)!=0) {
 			LM_ERR("failed to initialize the DB support\n");
 			return -1;
 		}
@@ -988,6 +1013,9 @@ static void mod_destroy(void)
 		}
 	}
 
+	/* written after the DB flush, so it is at least as recent as the DB */
+	dlg_snapshot_write(1, 0/*do not do locking*/);
+
 	/* no DB interaction from now on */
 	dlg_db_mode = DB_MODE_NONE;
 	destroy_dlg_table();
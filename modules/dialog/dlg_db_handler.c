@@ -28,6 +28,7 @@
 #include "../../timer.h"
 #include "../../db/db.h"
 #include "../../db/db_insertq.h"
+#include "../../db/db_preload.h"
 #include "../../str.h"
 #include "../../socket_info.h"
 #include "../../pt.h"
@@ -71,6 +72,7 @@ int dlg_db_mode				=	DB_MODE_NONE;
 
 static db_con_t* dialog_db_handle    = 0; /* database connection handle */
 static db_func_t dialog_dbf;
+static const str *dialog_db_url;
 
 extern int active_dlgs_cnt;
 extern int early_dlgs_cnt;
@@ -150,6 +152,7 @@ static inline void set_final_update_cols(db_val_t *, struct dlg_cell *, int);
 
 
 static int load_dialog_info_from_db(int dlg_hash_size);
+static int reconcile_dialogs_from_db(int dlg_hash_size);
 
 
 int dlg_connect_db(const str *db_url)
@@ -191,7 +194,8 @@ static int remove_all_dialogs_from_db(void)
 }
 
 
-int init_dlg_db(const str *db_url, int dlg_hash_size , int db_update_period)
+int init_dlg_db(const str *db_url, int dlg_hash_size , int db_update_period,
+															int snapshot)
 {
 	/* Find a database module */
 	if (db_bind_mod(db_url, &dialog_dbf) < 0){
@@ -203,6 +207,7 @@ int init_dlg_db(const str *db_url, int dlg_hash_size , int db_update_period)
 		LM_ERR("unable to connect to the database\n");
 		return -1;
 	}
+	dialog_db_url = db_url;
 
 	if(db_check_table_version(&dialog_dbf, dialog_db_handle,
 	&dialog_table_name, DLG_TABLE_VERSION) < 0) {
@@ -219,10 +224,20 @@ int init_dlg_db(const str *db_url, int dlg_hash_size , int db_update_period)
 		}
 	}
 
-	if( (load_dialog_info_from_db(dlg_hash_size) ) !=0 ){
-		LM_ERR("unable to load the dialog data\n");
-		return -1;
+	if (snapshot == DLG_SNAP_NONE) {
+		if( (load_dialog_info_from_db(dlg_hash_size) ) !=0 ){
+			LM_ERR("unable to load the dialog data\n");
+			return -1;
+		}
+	} else if (snapshot == DLG_SNAP_PERIODIC &&
+	dlg_db_mode != DB_MODE_SHUTDOWN) {
+		/* some changes may have been lost since the snapshot */
+		if (reconcile_dialogs_from_db(dlg_hash_size) != 0) {
+			LM_ERR("unable to reconcile the snapshot with the dialog data\n");
+			return -1;
+		}
 	}
+	/* else, the snapshot is at least as recent as the DB data */
 
 	if (dlg_db_mode==DB_MODE_SHUTDOWN && remove_all_dialogs_from_db()!=0) {
 		LM_WARN("failed to properly remove all the dialogs form DB\n");
@@ -247,27 +262,29 @@ void destroy_dlg_db(void)
 
 
 
+/* all the columns of the dialog table, in the order expected by
+ * dlg_load_db_row() */
+static db_key_t dialog_query_cols[DIALOG_TABLE_TOTAL_COL_NO] = {
+		&dlg_id_column,		&call_id_column,	&from_uri_column,
+		&from_tag_column,	&to_uri_column,		&to_tag_column,
+		&start_time_column,	&state_column,		&timeout_column,
+		&from_cseq_column,	&to_cseq_column,	&from_route_column,
+		&to_route_column,	&from_contact_column,&to_contact_column,
+		&from_sock_column,	&to_sock_column,	&vars_column,
+		&profiles_column,	&sflags_column,		&from_ping_cseq_column,
+		&to_ping_cseq_column,&flags_column,		&mangled_fu_column,
+		&mangled_tu_column,	&mflags_column,		&rt_on_answer_column,
+		&rt_on_timeout_column,&rt_on_hangup_column};
+
 static int select_entire_dialog_table(db_res_t ** res, int *no_rows)
 {
-	db_key_t query_cols[DIALOG_TABLE_TOTAL_COL_NO] = {
-			&dlg_id_column,		&call_id_column,	&from_uri_column,
-			&from_tag_column,	&to_uri_column,		&to_tag_column,
-			&start_time_column,	&state_column,		&timeout_column,
-			&from_cseq_column,	&to_cseq_column,	&from_route_column,
-			&to_route_column,	&from_contact_column,&to_contact_column,
-			&from_sock_column,	&to_sock_column,	&vars_column,
-			&profiles_column,	&sflags_column,		&from_ping_cseq_column,
-			&to_ping_cseq_column,&flags_column,		&mangled_fu_column,
-			&mangled_tu_column,	&mflags_column,		&rt_on_answer_column,
-			&rt_on_timeout_column,&rt_on_hangup_column};
-
 	if(use_dialog_table() != 0){
 		return -1;
 	}
 
 	/* select the whole tabel and all the columns */
 	if (DB_CAPABILITY(dialog_dbf, DB_CAP_FETCH)) {
-		if(dialog_dbf.query(dialog_db_handle,0,0,0,query_cols, 0,
+		if(dialog_dbf.query(dialog_db_handle,0,0,0,dialog_query_cols, 0,
 		DIALOG_TABLE_TOTAL_COL_NO, 0, 0) < 0) {
 			LM_ERR("Error while querying (fetch) database\n");
 			return -1;
@@ -282,7 +299,7 @@ static int select_entire_dialog_table(db_res_t ** res, int *no_rows)
 			return -1;
 		}
 	} else {
-		if(dialog_dbf.query(dialog_db_handle,0,0,0,query_cols, 0,
+		if(dialog_dbf.query(dialog_db_handle,0,0,0,dialog_query_cols, 0,
 		DIALOG_TABLE_TOTAL_COL_NO, 0, res) < 0) {
 			LM_ERR("Error while querying database\n");
 			return -1;
@@ -521,278 +538,465 @@ int remove_ended_dlgs_from_db(void)
 	return 0;
 }
 
-static int load_dialog_info_from_db(int dlg_hash_size)
+/* restore a dialog from a row of the dialog table (with the columns of
+ * dialog_query_cols); returns -1 only on fatal errors */
+int dlg_load_db_row(db_val_t *values, unsigned int extra_flags,
+												int *found_ended_dlgs)
 {
-	db_res_t * res;
-	db_val_t * values;
-	db_row_t * rows;
-	int i, nr_rows;
 	struct dlg_cell *dlg;
 	struct dlg_entry *d_entry;
 	str callid, from_uri, to_uri, from_tag, to_tag;
 	str cseq1,cseq2,contact1,contact2,rroute1,rroute2,mangled_fu,mangled_tu;
-	int no_rows = 10;
 	struct socket_info *caller_sock,*callee_sock;
-	int found_ended_dlgs=0;
 	unsigned int hash_entry,hash_id;
 	str tag_name;
 	int rc;
 
-	res = 0;
-	if((nr_rows = select_entire_dialog_table(&res,&no_rows)) < 0)
-		goto error;
 
-	nr_rows = RES_ROW_N(res);
+	if (VAL_NULL(values) || VAL_TYPE(values) != DB_BIGINT) {
+		LM_ERR("column %.*s cannot be null/has wrong type %d -> skipping\n",
+			dlg_id_column.len,dlg_id_column.s,VAL_TYPE(values));
+		return 0;
+	}
 
-	do {
-		LM_DBG("loading information from database for %i dialogs\n", nr_rows);
+	dlg_parse_db_id(VAL_BIGINT(values), hash_entry, hash_id);
 
-		rows = RES_ROWS(res);
+	if (VAL_NULL(values+6) || VAL_NULL(values+7)) {
+		LM_ERR("columns %.*s or/and %.*s cannot be null -> skipping\n",
+			start_time_column.len, start_time_column.s,
+			state_column.len, state_column.s);
+		return 0;
+	}
 
-		/* for every row---dialog */
-		for(i=0; i<nr_rows; i++){
+	if ( VAL_INT(values+7) == DLG_STATE_DELETED ) {
+		LM_INFO("dialog already terminated -> skipping\n");
+		*found_ended_dlgs=1;
+		return 0;
+	}
 
-			values = ROW_VALUES(rows + i);
+	caller_sock = create_socket_info(values, 15);
+	callee_sock = create_socket_info(values, 16);
+	if (caller_sock == NULL || callee_sock == NULL) {
+		LM_ERR("Dialog in DB doesn't match any listening sockets\n");
+		return 0;
+	}
 
-			if (VAL_NULL(values) || VAL_TYPE(values) != DB_BIGINT) {
-				LM_ERR("column %.*s cannot be null/has wrong type %d -> skipping\n",
-					dlg_id_column.len,dlg_id_column.s,VAL_TYPE(values));
-				continue;
-			}
+	/*restore the dialog info*/
+	GET_STR_VALUE(callid, values, 1, 1, 0);
+	GET_STR_VALUE(from_tag, values, 3, 1, 0);
+	GET_STR_VALUE(to_tag, values, 5, 1, 0);
+
+	d_entry = &d_table->entries[hash_entry];
+	dlg_lock(d_table, d_entry);
+
+	if (get_dlg_unsafe(d_entry, &callid, &from_tag, &to_tag,
+	                   &dlg) == 0) {
+		/*
+		 * there are two cases that could lead here:
+		 * 1) a race condition between the loading from DB and events
+		 *    received over a replicated channel - in this case we
+		 *    double check if the dialog has the same callid, and if
+		 *    we do, we drop the loaded dialog, as it has already been
+		 *    learned through replication
+		 * 2) a call looping scenario - a call that passes more than
+		 *    once through the same OpenSIPS instance, basically
+		 *    creating different dialogs with different hash IDs - in
+		 *    this case we shall learn the new dialog (Ticket #2311)
+		 */
+		if (dlg->h_id == hash_id) {
+			dlg_unlock(d_table, d_entry);
+			LM_DBG("dialog already exists, skipping (ci: %.*s, did: %u.%u)\n",
+					callid.len, callid.s, hash_entry, hash_id);
+			return 0;
+		}
+	}
 
-			dlg_parse_db_id(VAL_BIGINT(values), hash_entry, hash_id);
+	GET_STR_VALUE(from_uri, values, 2, 1, 0);
+	GET_STR_VALUE(to_uri, values, 4, 1, 0);
 
-			if (VAL_NULL(values+6) || VAL_NULL(values+7)) {
-				LM_ERR("columns %.*s or/and %.*s cannot be null -> skipping\n",
-					start_time_column.len, start_time_column.s,
-					state_column.len, state_column.s);
-				continue;
-			}
+	if((dlg=build_new_dlg(&callid, &from_uri, &to_uri, &from_tag))==0){
+		LM_ERR("failed to build new dialog\n");
+		dlg_unlock(d_table, d_entry);
+		return -1;
+	}
 
-			if ( VAL_INT(values+7) == DLG_STATE_DELETED ) {
-				LM_INFO("dialog already terminated -> skipping\n");
-				found_ended_dlgs=1;
-				continue;
-			}
+	if(dlg->h_entry != hash_entry){
+		dlg_unlock(d_table, d_entry);
+		LM_ERR("inconsistent hash data in the dialog database: "
+			"you may have restarted opensips using a different "
+			"hash_size: please erase %.*s database and restart\n"
+			"dlg : %u, db : %u\n",
+			dialog_table_name.len, dialog_table_name.s,
+			dlg->h_entry,hash_entry);
+		shm_free(dlg);
+		return 0;
+	}
 
-			caller_sock = create_socket_info(values, 15);
-			callee_sock = create_socket_info(values, 16);
-			if (caller_sock == NULL || callee_sock == NULL) {
-				LM_ERR("Dialog in DB doesn't match any listening sockets\n");
-				continue;
-			}
+	/* link the dialog */
+	link_dlg_unsafe(d_entry, dlg);
 
-			/*restore the dialog info*/
-			GET_STR_VALUE(callid, values, 1, 1, 0);
-			GET_STR_VALUE(from_tag, values, 3, 1, 0);
-			GET_STR_VALUE(to_tag, values, 5, 1, 0);
+	dlg->h_id = hash_id;
 
-			d_entry = &d_table->entries[hash_entry];
-			dlg_lock(d_table, d_entry);
+	/* next_id follows the max value of all loaded ids */
+	if (d_table->entries[dlg->h_entry].next_id <= dlg->h_id)
+		d_table->entries[dlg->h_entry].next_id = dlg->h_id + 1;
 
-			if (get_dlg_unsafe(d_entry, &callid, &from_tag, &to_tag,
-			                   &dlg) == 0) {
-				/*
-				 * there are two cases that could lead here:
-				 * 1) a race condition between the loading from DB and events
-				 *    received over a replicated channel - in this case we
-				 *    double check if the dialog has the same callid, and if
-				 *    we do, we drop the loaded dialog, as it has already been
-				 *    learned through replication
-				 * 2) a call looping scenario - a call that passes more than
-				 *    once through the same OpenSIPS instance, basically
-				 *    creating different dialogs with different hash IDs - in
-				 *    this case we shall learn the new dialog (Ticket #2311)
-				 */
-				if (dlg->h_id == hash_id) {
-					dlg_unlock(d_table, d_entry);
-					LM_DBG("dialog already exists, skipping (ci: %.*s, did: %u.%u)\n",
-							callid.len, callid.s, hash_entry, hash_id);
-					continue;
-				}
-			}
+	GET_STR_VALUE(to_tag, values, 5, 1, 1);
 
-			GET_STR_VALUE(from_uri, values, 2, 1, 0);
-			GET_STR_VALUE(to_uri, values, 4, 1, 0);
+	dlg->start_ts	= VAL_INT(values+6);
 
-			if((dlg=build_new_dlg(&callid, &from_uri, &to_uri, &from_tag))==0){
-				LM_ERR("failed to build new dialog\n");
-				goto error_unlock;
-			}
+	dlg->state 		= VAL_INT(values+7);
 
-			if(dlg->h_entry != hash_entry){
-				dlg_unlock(d_table, d_entry);
-				LM_ERR("inconsistent hash data in the dialog database: "
-					"you may have restarted opensips using a different "
-					"hash_size: please erase %.*s database and restart\n"
-					"dlg : %u, db : %u\n",
-					dialog_table_name.len, dialog_table_name.s,
-					dlg->h_entry,hash_entry);
-				shm_free(dlg);
-				continue;
-			}
+	GET_STR_VALUE(cseq1, values, 9 , 1, 1);
+	GET_STR_VALUE(cseq2, values, 10 , 1, 1);
+	GET_STR_VALUE(rroute1, values, 11, 0, 0);
+	GET_STR_VALUE(rroute2, values, 12, 0, 0);
+	GET_STR_VALUE(contact1, values, 13, 0, 1);
+	GET_STR_VALUE(contact2, values, 14, 0, 1);
 
-			/* link the dialog */
-			link_dlg_unsafe(d_entry, dlg);
+	GET_STR_VALUE(mangled_fu, values, 23,0,1);
+	GET_STR_VALUE(mangled_tu, values, 24,0,1);
 
-			dlg->h_id = hash_id;
+	/* add the 2 legs */
+	if ( (dlg_update_leg_info(0, dlg, &from_tag, &rroute1, &contact1,
+	NULL, &cseq1, caller_sock,0,0,0,0)!=0) ||
+	(dlg_update_leg_info(1, dlg, &to_tag, &rroute2, &contact2,
+	NULL, &cseq2, callee_sock,&mangled_fu,&mangled_tu,0,0)!=0) ) {
+		LM_ERR("dlg_set_leg_info failed\n");
+		/* destroy the dialog */
+		unref_dlg_unsafe(dlg, 1, d_entry);
+		dlg_unlock(d_table, d_entry);
+		return 0;
+	}
+	dlg->legs_no[DLG_LEG_200OK] = DLG_FIRST_CALLEE_LEG;
 
-			/* next_id follows the max value of all loaded ids */
-			if (d_table->entries[dlg->h_entry].next_id <= dlg->h_id)
-				d_table->entries[dlg->h_entry].next_id = dlg->h_id + 1;
+	/* script variables */
+	if (!VAL_NULL(values+17)) {
+		if (VAL_TYPE(values+17) == DB_BLOB) {
+			read_dialog_vars( VAL_BLOB(values+17).s,
+					VAL_BLOB(values+17).len, dlg);
+		} else {
+			LM_ERR("non-blob variables column - cannot store dialog variables\n");
+		}
+	}
 
-			GET_STR_VALUE(to_tag, values, 5, 1, 1);
+	/* script flags */
+	if (!VAL_NULL(values+19)) {
+		dlg->user_flags = VAL_INT(values+19);
+	}
 
-			dlg->start_ts	= VAL_INT(values+6);
+	/* module flags */
+	if (!VAL_NULL(values+25)) {
+		dlg->mod_flags = VAL_INT(values+25);
+	}
 
-			dlg->state 		= VAL_INT(values+7);
+	/* the script routes */
+	GET_ROUTE_VALUE( dlg->rt_on_answer, values, 26);
+	GET_ROUTE_VALUE( dlg->rt_on_timeout, values, 27);
+	GET_ROUTE_VALUE( dlg->rt_on_hangup, values, 28);
+
+	/* dialog flags */
+	dlg->flags = VAL_INT(values+22);
+	if (dlg_db_mode==DB_MODE_SHUTDOWN)
+		dlg->flags |= DLG_FLAG_NEW;
+
+	/* mark this dialog as loaded from DB in order to drop it when
+	 * syncing from cluster is finished */
+	dlg->flags |= DLG_FLAG_FROM_DB;
+	dlg->flags |= extra_flags;
+
+	/* calculate timeout */
+	dlg->tl.timeout = (unsigned int)(VAL_INT(values+8));
+	if (dlg->tl.timeout<=(unsigned int)time(0))
+		dlg->tl.timeout = 0;
+	else
+		dlg->tl.timeout -= (unsigned int)time(0);
+
+	/* restore the timer values */
+	if (0 != insert_dlg_timer( &(dlg->tl), (int)dlg->tl.timeout )) {
+		LM_CRIT("Unable to insert dlg %p [%u:%u] "
+			"with clid '%.*s' and tags '%.*s' '%.*s'\n",
+			dlg, dlg->h_entry, dlg->h_id,
+			dlg->callid.len, dlg->callid.s,
+			dlg->legs[DLG_CALLER_LEG].tag.len,
+			dlg->legs[DLG_CALLER_LEG].tag.s,
+			dlg->legs[callee_idx(dlg)].tag.len,
+			ZSW(dlg->legs[callee_idx(dlg)].tag.s));
+		/* destroy the dialog */
+		unref_dlg_unsafe(dlg, 1, d_entry);
+		dlg_unlock(d_table, d_entry);
+		return 0;
+	}
 
-			GET_STR_VALUE(cseq1, values, 9 , 1, 1);
-			GET_STR_VALUE(cseq2, values, 10 , 1, 1);
-			GET_STR_VALUE(rroute1, values, 11, 0, 0);
-			GET_STR_VALUE(rroute2, values, 12, 0, 0);
-			GET_STR_VALUE(contact1, values, 13, 0, 1);
-			GET_STR_VALUE(contact2, values, 14, 0, 1);
+	/* reference the dialog as kept in the timer list + this ref */
+	ref_dlg_unsafe(dlg, 2);
+	LM_DBG("current dialog timeout is %u\n", dlg->tl.timeout);
 
-			GET_STR_VALUE(mangled_fu, values, 23,0,1);
-			GET_STR_VALUE(mangled_tu, values, 24,0,1);
+	dlg->lifetime = 0;
 
-			/* add the 2 legs */
-			if ( (dlg_update_leg_info(0, dlg, &from_tag, &rroute1, &contact1,
-			NULL, &cseq1, caller_sock,0,0,0,0)!=0) ||
-			(dlg_update_leg_info(1, dlg, &to_tag, &rroute2, &contact2,
-			NULL, &cseq2, callee_sock,&mangled_fu,&mangled_tu,0,0)!=0) ) {
-				LM_ERR("dlg_set_leg_info failed\n");
-				/* destroy the dialog */
-				unref_dlg_unsafe(dlg, 1, d_entry);
-				dlg_unlock(d_table, d_entry);
-				continue;
-			}
-			dlg->legs_no[DLG_LEG_200OK] = DLG_FIRST_CALLEE_LEG;
+	dlg->legs[DLG_CALLER_LEG].last_gen_cseq =
+		(unsigned int)(VAL_INT(values+20));
+	dlg->legs[callee_idx(dlg)].last_gen_cseq =
+		(unsigned int)(VAL_INT(values+21));
 
-			/* script variables */
-			if (!VAL_NULL(values+17)) {
-				if (VAL_TYPE(values+17) == DB_BLOB) {
-					read_dialog_vars( VAL_BLOB(values+17).s,
-							VAL_BLOB(values+17).len, dlg);
-				} else {
-					LM_ERR("non-blob variables column - cannot store dialog variables\n");
-				}
-			}
+	dlg_unlock(d_table, d_entry);
 
-			/* script flags */
-			if (!VAL_NULL(values+19)) {
-				dlg->user_flags = VAL_INT(values+19);
-			}
+	/* profiles */
+	if (!VAL_NULL(values+18))
+		read_dialog_profiles( VAL_STR(values+18).s,
+			strlen(VAL_STR(values+18).s), dlg, 0, 0);
+
+	if (dlg_has_options_pinging(dlg)) {
+		if (0 != insert_ping_timer(dlg))
+			LM_CRIT("Unable to insert dlg %p into ping timer\n",dlg);
+		else {
+			/* reference dialog as kept in ping timer list */
+			ref_dlg(dlg, 1);
+		}
+	}
 
-			/* module flags */
-			if (!VAL_NULL(values+25)) {
-				dlg->mod_flags = VAL_INT(values+25);
-			}
 
-			/* the script routes */
-			GET_ROUTE_VALUE( dlg->rt_on_answer, values, 26);
-			GET_ROUTE_VALUE( dlg->rt_on_timeout, values, 27);
-			GET_ROUTE_VALUE( dlg->rt_on_hangup, values, 28);
-
-			/* dialog flags */
-			dlg->flags = VAL_INT(values+22);
-			if (dlg_db_mode==DB_MODE_SHUTDOWN)
-				dlg->flags |= DLG_FLAG_NEW;
-
-			/* mark this dialog as loaded from DB in order to drop it when
-			 * syncing from cluster is finished */
-			dlg->flags |= DLG_FLAG_FROM_DB;
-
-			/* calculate timeout */
-			dlg->tl.timeout = (unsigned int)(VAL_INT(values+8));
-			if (dlg->tl.timeout<=(unsigned int)time(0))
-				dlg->tl.timeout = 0;
-			else
-				dlg->tl.timeout -= (unsigned int)time(0);
-
-			/* restore the timer values */
-			if (0 != insert_dlg_timer( &(dlg->tl), (int)dlg->tl.timeout )) {
-				LM_CRIT("Unable to insert dlg %p [%u:%u] "
-					"with clid '%.*s' and tags '%.*s' '%.*s'\n",
-					dlg, dlg->h_entry, dlg->h_id,
-					dlg->callid.len, dlg->callid.s,
-					dlg->legs[DLG_CALLER_LEG].tag.len,
-					dlg->legs[DLG_CALLER_LEG].tag.s,
-					dlg->legs[callee_idx(dlg)].tag.len,
-					ZSW(dlg->legs[callee_idx(dlg)].tag.s));
-				/* destroy the dialog */
-				unref_dlg_unsafe(dlg, 1, d_entry);
-				dlg_unlock(d_table, d_entry);
-				continue;
-			}
+	if (restore_reinvite_pinging(dlg) != 0)
+		LM_ERR("failed to fetch some Re-INVITE pinging data\n");
+	if (dlg_has_reinvite_pinging(dlg)) {
+		/* re-populate Re-INVITE pinging fields */
+		if (0 != insert_reinvite_ping_timer(dlg))
+			LM_CRIT("Unable to insert dlg %p into reinvite"
+			        "ping timer\n", dlg);
+		else
+			/* reference dialog as kept in reinvite ping timer list */
+			ref_dlg(dlg, 1);
+	}
+
+	if ((rc = fetch_dlg_value(dlg, &shtag_dlg_val, &tag_name, 0)) == 0) {
+		if (shm_str_dup(&dlg->shtag, &tag_name) < 0)
+			LM_ERR("No more shm memory\n");
+	} else if (rc == -1)
+		LM_ERR("Failed to get dlg value for sharing tag\n");
 
-			/* reference the dialog as kept in the timer list + this ref */
-			ref_dlg_unsafe(dlg, 2);
-			LM_DBG("current dialog timeout is %u\n", dlg->tl.timeout);
+	if (dlg_db_mode == DB_MODE_DELAYED) {
+		/* to be later removed by timer */
+		ref_dlg(dlg, 1);
+	}
 
-			dlg->lifetime = 0;
+	if (dlg->state==DLG_STATE_CONFIRMED_NA ||
+	dlg->state==DLG_STATE_CONFIRMED) {
+		active_dlgs_cnt++;
+	} else if (dlg->state==DLG_STATE_EARLY) {
+		early_dlgs_cnt++;
+	}
+	run_load_callback_per_dlg(dlg);
+	unref_dlg(dlg, 1);
 
-			dlg->legs[DLG_CALLER_LEG].last_gen_cseq =
-				(unsigned int)(VAL_INT(values+20));
-			dlg->legs[callee_idx(dlg)].last_gen_cseq =
-				(unsigned int)(VAL_INT(values+21));
+next_dialog:
+	return 0;
+}
 
-			dlg_unlock(d_table, d_entry);
+static int load_dialog_row(db_val_t *values, int n_vals, void *param)
+{
+	return dlg_load_db_row(values, 0, (int *)param);
+}
 
-			/* profiles */
-			if (!VAL_NULL(values+18))
-				read_dialog_profiles( VAL_STR(values+18).s,
-					strlen(VAL_STR(values+18).s), dlg, 0, 0);
-
-			if (dlg_has_options_pinging(dlg)) {
-				if (0 != insert_ping_timer(dlg))
-					LM_CRIT("Unable to insert dlg %p into ping timer\n",dlg);
-				else {
-					/* reference dialog as kept in ping timer list */
-					ref_dlg(dlg, 1);
-				}
+static int load_dialog_info_from_db(int dlg_hash_size)
+{
+	struct db_preload p;
+	int found_ended_dlgs=0;
+	int rc;
+
+	memset(&p, 0, sizeof p);
+	p.url = dialog_db_url;
+	p.dbf = &dialog_dbf;
+	p.table = &dialog_table_name;
+	p.cols = dialog_query_cols;
+	p.n_cols = DIALOG_TABLE_TOTAL_COL_NO;
+	/* the entry of the dialog is in the upper half of its id */
+	p.split_key = &dlg_id_column;
+	p.row_size = 4+255+128+64+128+64+64+64+11+11+4+4
+		+512+512+128+128+64+64+4+4+4+4096+512+4+4+4+16+16+16;
+
+	rc = db_preload_table(&p, dialog_db_handle, load_dialog_row,
+		&found_ended_dlgs);
+
+	if (found_ended_dlgs)
+		remove_ended_dlgs_from_db();
+	return rc;
+}
+
+/* above this many dialogs missing from the snapshot, it is cheaper to
+ * go through the whole table than to fetch them one by one */
+#define DLG_SNAP_MAX_MISSING 1000
+
+static inline void update_state_counters(int old_state, int new_state)
+{
+	if (old_state==DLG_STATE_CONFIRMED_NA || old_state==DLG_STATE_CONFIRMED)
+		active_dlgs_cnt--;
+	else if (old_state==DLG_STATE_EARLY)
+		early_dlgs_cnt--;
+
+	if (new_state==DLG_STATE_CONFIRMED_NA || new_state==DLG_STATE_CONFIRMED)
+		active_dlgs_cnt++;
+	else if (new_state==DLG_STATE_EARLY)
+		early_dlgs_cnt++;
+}
+
+static int load_dialog_by_id(long long id, int *found_ended_dlgs)
+{
+	db_key_t match_keys[1] = { &dlg_id_column };
+	db_val_t match_vals[1];
+	db_res_t *res = NULL;
+	int rc = 0;
+
+	VAL_TYPE(match_vals) = DB_BIGINT;
+	VAL_NULL(match_vals) = 0;
+	VAL_BIGINT(match_vals) = id;
+
+	if (dialog_dbf.query(dialog_db_handle, match_keys, 0, match_vals,
+	dialog_query_cols, 1, DIALOG_TABLE_TOTAL_COL_NO, 0, &res) < 0) {
+		LM_ERR("failed to query dialog %lld\n", id);
+		return -1;
+	}
+
+	if (RES_ROW_N(res) > 0)
+		rc = dlg_load_db_row(ROW_VALUES(RES_ROWS(res)), 0, found_ended_dlgs);
+
+	dialog_dbf.free_result(dialog_db_handle, res);
+	return rc;
+}
+
+/*
+ * Bring the dialogs restored from a periodic snapshot up to date with the
+ * database: only the columns which change during the life of a dialog are
+ * fetched for the whole table, while the full rows are only loaded for the
+ * dialogs created after the snapshot. The restored dialogs which are no
+ * longer in the database are dropped.
+ */
+static int reconcile_dialogs_from_db(int dlg_hash_size)
+{
+	db_key_t query_cols[7] = {
+			&dlg_id_column,		&state_column,		&timeout_column,
+			&from_cseq_column,	&to_cseq_column,	&from_ping_cseq_column,
+			&to_ping_cseq_column};
+	db_res_t *res = NULL;
+	db_row_t *rows;
+	db_val_t *values;
+	struct dlg_entry *d_entry;
+	struct dlg_cell *dlg;
+	unsigned int hash_entry, hash_id, timeout, now;
+	long long *missing = NULL;
+	int n_missing = 0, full_load = 0, found_ended_dlgs = 0;
+	int i, nr_rows, no_rows = 10, n_updated = 0, n_dropped = 0;
+	str cseq;
+
+	if (use_dialog_table() != 0)
+		return -1;
+
+	missing = pkg_malloc(DLG_SNAP_MAX_MISSING * sizeof *missing);
+	if (!missing) {
+		LM_ERR("oom\n");
+		return -1;
+	}
+
+	if (DB_CAPABILITY(dialog_dbf, DB_CAP_FETCH)) {
+		if (dialog_dbf.query(dialog_db_handle, 0, 0, 0, query_cols, 0,
+		7, 0, 0) < 0) {
+			LM_ERR("Error while querying (fetch) database\n");
+			goto error;
+		}
+		no_rows = estimate_available_rows(8+4+4+64+64+4+4, 7);
+		if (no_rows==0) no_rows = 10;
+		if (dialog_dbf.fetch_result(dialog_db_handle, &res, no_rows) < 0) {
+			LM_ERR("fetching rows failed\n");
+			goto error;
+		}
+	} else {
+		if (dialog_dbf.query(dialog_db_handle, 0, 0, 0, query_cols, 0,
+		7, 0, &res) < 0) {
+			LM_ERR("Error while querying database\n");
+			goto error;
+		}
+	}
+
+	now = (unsigned int)time(0);
+	nr_rows = RES_ROW_N(res);
+
+	do {
+		rows = RES_ROWS(res);
+
+		for (i = 0; i < nr_rows; i++) {
+			values = ROW_VALUES(rows + i);
+
+			if (VAL_NULL(values) || VAL_TYPE(values) != DB_BIGINT ||
+			VAL_NULL(values+1))
+				continue;
+
+			if (VAL_INT(values+1) == DLG_STATE_DELETED) {
+				/* if restored, the dialog is dropped along with the others
+				 * not confirmed by the database */
+				found_ended_dlgs = 1;
+				continue;
 			}
 
+			dlg_parse_db_id(VAL_BIGINT(values), hash_entry, hash_id);
+			if (hash_entry >= dlg_hash_size)
+				continue;
+
+			d_entry = &d_table->entries[hash_entry];
+			dlg_lock(d_table, d_entry);
+
+			for (dlg = d_entry->first; dlg && dlg->h_id != hash_id;
+			dlg = dlg->next) ;
+
+			if (!dlg || !(dlg->flags & DLG_FLAG_SNAPSHOT)) {
+				dlg_unlock(d_table, d_entry);
 
-			if (restore_reinvite_pinging(dlg) != 0)
-				LM_ERR("failed to fetch some Re-INVITE pinging data\n");
-			if (dlg_has_reinvite_pinging(dlg)) {
-				/* re-populate Re-INVITE pinging fields */
-				if (0 != insert_reinvite_ping_timer(dlg))
-					LM_CRIT("Unable to insert dlg %p into reinvite"
-					        "ping timer\n", dlg);
+				if (dlg)
+					continue;
+
+				if (n_missing < DLG_SNAP_MAX_MISSING)
+					missing[n_missing++] = VAL_BIGINT(values);
 				else
-					/* reference dialog as kept in reinvite ping timer list */
-					ref_dlg(dlg, 1);
+					full_load = 1;
+				continue;
 			}
 
-			if ((rc = fetch_dlg_value(dlg, &shtag_dlg_val, &tag_name, 0)) == 0) {
-				if (shm_str_dup(&dlg->shtag, &tag_name) < 0)
-					LM_ERR("No more shm memory\n");
-			} else if (rc == -1)
-				LM_ERR("Failed to get dlg value for sharing tag\n");
+			dlg->flags &= ~DLG_FLAG_SNAPSHOT;
 
-			if (dlg_db_mode == DB_MODE_DELAYED) {
-				/* to be later removed by timer */
-				ref_dlg(dlg, 1);
+			if (dlg->state != VAL_INT(values+1)) {
+				update_state_counters(dlg->state, VAL_INT(values+1));
+				dlg->state = VAL_INT(values+1);
 			}
 
-			if (dlg->state==DLG_STATE_CONFIRMED_NA ||
-			dlg->state==DLG_STATE_CONFIRMED) {
-				active_dlgs_cnt++;
-			} else if (dlg->state==DLG_STATE_EARLY) {
-				early_dlgs_cnt++;
+			if (!VAL_NULL(values+2)) {
+				timeout = (unsigned int)VAL_INT(values+2);
+				timeout = timeout <= now ? 0 : timeout - now;
+				if (dlg->tl.timeout != get_ticks() + timeout)
+					update_dlg_timer(&dlg->tl, timeout);
 			}
-			run_load_callback_per_dlg(dlg);
-			unref_dlg(dlg, 1);
 
-			next_dialog:;
+			if (!VAL_NULL(values+3)) {
+				cseq.s = (char *)VAL_STRING(values+3);
+				cseq.len = strlen(cseq.s);
+				dlg_update_cseq(dlg, DLG_CALLER_LEG, &cseq, 0);
+			}
+			if (!VAL_NULL(values+4)) {
+				cseq.s = (char *)VAL_STRING(values+4);
+				cseq.len = strlen(cseq.s);
+				dlg_update_cseq(dlg, callee_idx(dlg), &cseq, 0);
+			}
+
+			if (!VAL_NULL(values+5))
+				dlg->legs[DLG_CALLER_LEG].last_gen_cseq =
+					(unsigned int)VAL_INT(values+5);
+			if (!VAL_NULL(values+6))
+				dlg->legs[callee_idx(dlg)].last_gen_cseq =
+					(unsigned int)VAL_INT(values+6);
+
+			dlg_unlock(d_table, d_entry);
+			n_updated++;
 		}
 
-		/* any more data to be fetched ?*/
 		if (DB_CAPABILITY(dialog_dbf, DB_CAP_FETCH)) {
-			if (dialog_dbf.fetch_result( dialog_db_handle, &res,no_rows) < 0) {
+			if (dialog_dbf.fetch_result(dialog_db_handle, &res, no_rows) < 0) {
 				LM_ERR("fetching more rows failed\n");
 				goto error;
 			}
@@ -800,20 +1004,50 @@ static int load_dialog_info_from_db(int dlg_hash_size)
 		} else {
 			nr_rows = 0;
 		}
-
-	}while (nr_rows>0);
+	} while (nr_rows > 0);
 
 	dialog_dbf.free_result(dialog_db_handle, res);
-	if (found_ended_dlgs)
-		remove_ended_dlgs_from_db();
+	res = NULL;
+
+	/* the dialogs created since the snapshot */
+	if (full_load) {
+		if (load_dialog_info_from_db(dlg_hash_size) != 0)
+			goto error;
+	} else {
+		for (i = 0; i < n_missing; i++)
+			if (load_dialog_by_id(missing[i], &found_ended_dlgs) < 0)
+				goto error;
+		if (found_ended_dlgs)
+			remove_ended_dlgs_from_db();
+	}
+
+	/* the dialogs ended since the snapshot */
+	for (i = 0; i < dlg_hash_size; i++) {
+		dlg_lock(d_table, &d_table->entries[i]);
+		dlg = d_table->entries[i].first;
+		while (dlg) {
+			if (dlg->flags & DLG_FLAG_SNAPSHOT) {
+				dlg->flags &= ~DLG_FLAG_SNAPSHOT;
+				dlg = drop_dlg(dlg, i);
+				n_dropped++;
+			} else {
+				dlg = dlg->next;
+			}
+		}
+		dlg_unlock(d_table, &d_table->entries[i]);
+	}
+
+	LM_INFO("snapshot reconciled with DB: %d dialogs updated, %d dropped, "
+		"%s\n", n_updated, n_dropped,
+		full_load ? "full table reloaded" : "new dialogs loaded by id");
+
+	pkg_free(missing);
 	return 0;
 
-error_unlock:
-	dlg_unlock(d_table, d_entry);
 error:
-	dialog_dbf.free_result(dialog_db_handle, res);
-	if (found_ended_dlgs)
-		remove_ended_dlgs_from_db();
+	if (res)
+		dialog_dbf.free_result(dialog_db_handle, res);
+	pkg_free(missing);
 	return -1;
 }
 
@@ -1505,6 +1739,76 @@ static inline void set_final_update_cols(db_val_t *vals, struct dlg_cell *cell,
 
 
 
+/* fill in a full row of the dialog table, in the order of dialog_query_cols;
+ * the entry of the dialog must be locked */
+void dlg_get_db_row(struct dlg_cell *cell, db_val_t *values)
+{
+	static const db_type_t types[DIALOG_TABLE_TOTAL_COL_NO] = {
+		DB_BIGINT, DB_STR, DB_STR, DB_STR, DB_STR, DB_STR, DB_INT, DB_INT,
+		DB_INT, DB_STR, DB_STR, DB_STR, DB_STR, DB_STR, DB_STR, DB_STR,
+		DB_STR, DB_BLOB, DB_STR, DB_INT, DB_INT, DB_INT, DB_INT, DB_STR,
+		DB_STR, DB_INT, DB_STRING, DB_STRING, DB_STRING};
+	db_val_t final_vals[4];
+	int callee_leg, i;
+
+	memset(values, 0, DIALOG_TABLE_TOTAL_COL_NO * sizeof *values);
+	for (i = 0; i < DIALOG_TABLE_TOTAL_COL_NO; i++)
+		VAL_TYPE(values+i) = types[i];
+
+	callee_leg = callee_idx(cell);
+
+	SET_BIGINT_VALUE(values, dlg_get_db_id(cell));
+	SET_STR_VALUE(values+1, cell->callid);
+	SET_STR_VALUE(values+2, cell->from_uri);
+	SET_STR_VALUE(values+3, cell->legs[DLG_CALLER_LEG].tag);
+	SET_STR_VALUE(values+4, cell->to_uri);
+	SET_STR_VALUE(values+5, cell->legs[callee_leg].tag);
+
+	SET_INT_VALUE(values+6, cell->start_ts);
+	SET_INT_VALUE(values+7, cell->state);
+	SET_INT_VALUE(values+8, (unsigned int)((unsigned int)time(0)
+		+ cell->tl.timeout - get_ticks()) );
+
+	SET_STR_VALUE(values+9, cell->legs[DLG_CALLER_LEG].r_cseq);
+	SET_STR_VALUE(values+10, cell->legs[callee_leg].r_cseq);
+	SET_STR_VALUE(values+11, cell->legs[DLG_CALLER_LEG].route_set);
+	SET_STR_VALUE(values+12, cell->legs[callee_leg].route_set);
+	SET_STR_VALUE(values+13, cell->legs[DLG_CALLER_LEG].contact);
+	SET_STR_VALUE(values+14, cell->legs[callee_leg].contact);
+
+	SET_STR_VALUE(values+15, *get_socket_internal_name
+		(cell->legs[DLG_CALLER_LEG].bind_addr) );
+	if (cell->legs[callee_leg].bind_addr) {
+		SET_STR_VALUE(values+16, *get_socket_internal_name
+			(cell->legs[callee_leg].bind_addr) );
+	} else {
+		VAL_NULL(values+16) = 1;
+	}
+
+	/* vars, profiles, sflags and mflags, all of them forced */
+	set_final_update_cols(final_vals, cell, 1);
+	VAL_NULL(values+17) = VAL_NULL(final_vals);
+	VAL_BLOB(values+17) = VAL_STR(final_vals);
+	VAL_NULL(values+18) = VAL_NULL(final_vals+1);
+	VAL_STR(values+18) = VAL_STR(final_vals+1);
+	SET_INT_VALUE(values+19, VAL_INT(final_vals+2));
+	SET_INT_VALUE(values+25, VAL_INT(final_vals+3));
+
+	SET_INT_VALUE(values+20, cell->legs[DLG_CALLER_LEG].last_gen_cseq);
+	SET_INT_VALUE(values+21, cell->legs[callee_leg].last_gen_cseq);
+	SET_INT_VALUE(values+22, cell->flags & ~(DLG_FLAG_NEW|DLG_FLAG_CHANGED|
+		DLG_FLAG_VP_CHANGED|DLG_FLAG_DB_DELETED|DLG_FLAG_FROM_DB|
+		DLG_FLAG_SYNCED|DLG_FLAG_SNAPSHOT));
+
+	SET_STR_VALUE(values+23, cell->legs[callee_leg].from_uri);
+	SET_STR_VALUE(values+24, cell->legs[callee_leg].to_uri);
+
+	SET_ROUTE_VALUE(values+26, cell->rt_on_answer);
+	SET_ROUTE_VALUE(values+27, cell->rt_on_timeout);
+	SET_ROUTE_VALUE(values+28, cell->rt_on_hangup);
+}
+
+
 void dialog_update_db(unsigned int ticks, void *do_lock)
 {
 	static db_ps_t my_ps_update = NULL;
@@ -103,7 +103,13 @@ extern int db_flush_vp;
 
 #define should_remove_dlg_db() (dlg_db_mode==DB_MODE_REALTIME)
 
-int init_dlg_db(const str *db_url, int dlg_hash_size, int db_update_period);
+/* how the dialogs were already restored from a snapshot */
+#define DLG_SNAP_NONE      0
+#define DLG_SNAP_PERIODIC  1
+#define DLG_SNAP_FINAL     2
+
+int init_dlg_db(const str *db_url, int dlg_hash_size, int db_update_period,
+		int snapshot);
 int dlg_connect_db(const str *db_url);
 void destroy_dlg_db();
 
@@ -112,6 +118,10 @@ int update_dialog_dbinfo(struct dlg_cell * cell);
 int update_dialog_timeout_info(struct dlg_cell * cell);
 void dialog_update_db(unsigned int ticks, void * param);
 
+void dlg_get_db_row(struct dlg_cell *cell, db_val_t *values);
+int dlg_load_db_row(db_val_t *values, unsigned int extra_flags,
+		int *found_ended_dlgs);
+
 void read_dialog_vars(char *b, int l, struct dlg_cell *dlg);
 void read_dialog_profiles(char *b, int l, struct dlg_cell *dlg,
                           int double_check, char is_replicated);
@@ -68,6 +68,7 @@
 #define DLG_FLAG_RACE_CONDITION_OCCURRED	(1<<17)
 #define DLG_FLAG_SELF_EXTENDED_TIMEOUT		(1<<18)
 #define DLG_FLAG_SYNCED                     (1<<19)
+#define DLG_FLAG_SNAPSHOT                   (1<<20)
 
 #define dlg_has_options_pinging(dlg) \
 	(dlg->flags & DLG_FLAG_PING_CALLER || \
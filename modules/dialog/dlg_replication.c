@@ -1024,11 +1024,14 @@ void receive_dlg_repl(bin_packet_t *pkt)
 
 static int receive_sync_request(int node_id)
 {
-	int i;
+	int i, part_idx, part_no;
 	struct dlg_cell *dlg;
 	bin_packet_t *sync_packet;
 
-	for (i = 0; i < d_table->size; i++) {
+	/* only send the hash entries in the requested partition */
+	clusterer_api.sync_partition(&part_idx, &part_no);
+
+	for (i = part_idx; i < d_table->size; i += part_no) {
 		dlg_lock(d_table, &(d_table->entries[i]));
 		for (dlg = d_table->entries[i].first; dlg; dlg = dlg->next) {
 			if (dlg->state != DLG_STATE_CONFIRMED_NA &&
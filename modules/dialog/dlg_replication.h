@@ -62,6 +62,7 @@ int dlg_replicated_delete(bin_packet_t *packet);
 
 void receive_dlg_repl(bin_packet_t *packet);
 void rcv_cluster_event(enum clusterer_event ev, int node_id);
+struct dlg_cell *drop_dlg(struct dlg_cell *dlg, int i);
 
 mi_response_t *mi_sync_cl_dlg(const mi_params_t *params,
 								struct mi_handler *async_hdl);
@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdint.h>
+#include <sys/time.h>
+
+#include "../../dprint.h"
+#include "../../timer.h"
+#include "../../db/db.h"
+#include "../../lib/snapshot.h"
+
+#include "dlg_hash.h"
+#include "dlg_db_handler.h"
+#include "dlg_snapshot.h"
+
+#define DLG_SNAP_MAGIC    "OSIPSDLG"
+#define DLG_SNAP_VERSION  1
+
+/* the value tags */
+#define DLG_SNAP_VAL_NULL    0
+#define DLG_SNAP_VAL_INT     1
+#define DLG_SNAP_VAL_BIGINT  2
+#define DLG_SNAP_VAL_STR     3
+
+char *dlg_snapshot_file;
+int dlg_snapshot_interval = 300;
+
+/* the startup restoring was done, so the table may be dumped */
+static int snap_ready;
+
+
+int dlg_init_snapshot(void)
+{
+	if (!dlg_snapshot_file)
+		return 0;
+
+	/* with no DB to reconcile them with, the dialogs of a periodic
+	 * snapshot could no longer be told apart from the ended ones */
+	if (dlg_snapshot_interval > 0 && dlg_db_mode != DB_MODE_REALTIME &&
+	dlg_db_mode != DB_MODE_DELAYED) {
+		LM_WARN("periodic snapshots need a db_mode of 1 or 2, only "
+			"writing %s on shutdown\n", dlg_snapshot_file);
+		dlg_snapshot_interval = 0;
+	}
+
+#ifndef HAVE_TIMER_FD
+	if (dlg_snapshot_interval > 0) {
+		LM_WARN("no timer FD support, only writing %s on shutdown\n",
+			dlg_snapshot_file);
+		dlg_snapshot_interval = 0;
+	}
+#endif
+
+	return 0;
+}
+
+
+static int dlg_snap_put_row(struct snap_writer *w, db_val_t *values)
+{
+	unsigned char tag;
+	int32_t i32;
+	int64_t i64;
+	str s;
+	int i;
+
+	for (i = 0; i < DIALOG_TABLE_TOTAL_COL_NO; i++) {
+		if (VAL_NULL(values+i)) {
+			tag = DLG_SNAP_VAL_NULL;
+			if (snap_put_val(w, tag) < 0)
+				return -1;
+			continue;
+		}
+
+		switch (VAL_TYPE(values+i)) {
+		case DB_INT:
+			tag = DLG_SNAP_VAL_INT;
+			i32 = VAL_INT(values+i);
+			if (snap_put_val(w, tag) < 0 || snap_put_val(w, i32) < 0)
+				return -1;
+			break;
+		case DB_BIGINT:
+			tag = DLG_SNAP_VAL_BIGINT;
+			i64 = VAL_BIGINT(values+i);
+			if (snap_put_val(w, tag) < 0 || snap_put_val(w, i64) < 0)
+				return -1;
+			break;
+		case DB_STRING:
+			s.s = (char *)VAL_STRING(values+i);
+			s.len = strlen(s.s);
+			goto put_str;
+		case DB_BLOB:
+			s = VAL_BLOB(values+i);
+			goto put_str;
+		default:
+			s = VAL_STR(values+i);
+put_str:
+			tag = DLG_SNAP_VAL_STR;
+			if (snap_put_val(w, tag) < 0 || snap_put_str(w, &s) < 0)
+				return -1;
+		}
+	}
+
+	return 0;
+}
+
+
+int dlg_snapshot_write(int final, int do_lock)
+{
+	db_val_t values[DIALOG_TABLE_TOTAL_COL_NO];
+	struct snap_writer w;
+	struct dlg_entry *entry;
+	struct dlg_cell *cell;
+	uint32_t size, next_id;
+	unsigned int i;
+
+	if (!dlg_snapshot_file || !snap_ready)
+		return 0;
+
+	if (snap_open_write(&w, dlg_snapshot_file, DLG_SNAP_MAGIC,
+	DLG_SNAP_VERSION) < 0) {
+		LM_ERR("failed to start a new snapshot\n");
+		return -1;
+	}
+
+	size = d_table->size;
+	if (snap_put_val(&w, size) < 0 || snap_end_block(&w) < 0)
+		goto error;
+
+	/* a block for each hash entry */
+	for (i = 0; i < d_table->size; i++) {
+		entry = &d_table->entries[i];
+		if (do_lock)
+			dlg_lock(d_table, entry);
+
+		next_id = entry->next_id;
+		snap_put_val(&w, next_id);
+
+		for (cell = entry->first; cell; cell = cell->next) {
+			if (cell->state == DLG_STATE_DELETED)
+				continue;
+
+			dlg_get_db_row(cell, values);
+			if (dlg_snap_put_row(&w, values) < 0)
+				break;
+		}
+
+		if (do_lock)
+			dlg_unlock(d_table, entry);
+
+		if (snap_end_block(&w) < 0)
+			goto error;
+	}
+
+	if (snap_commit(&w, final ? SNAP_FL_FINAL : 0) < 0)
+		goto error;
+
+	return 0;
+
+error:
+	LM_ERR("failed to write the %s snapshot\n", dlg_snapshot_file);
+	snap_abort(&w);
+	return -1;
+}
+
+
+#ifdef HAVE_TIMER_FD
+static int dlg_snapshot_timer(int fd, void *param, int was_timeout)
+{
+	uint64_t ticks;
+
+	if (read(fd, &ticks, sizeof ticks) < 0) {
+		if (errno == EAGAIN || errno == EINTR)
+			return 0;
+		LM_ERR("failed to read the snapshot timer (%d) <%s>\n",
+			errno, strerror(errno));
+		return -1;
+	}
+
+	dlg_snapshot_write(0, 1);
+	return 0;
+}
+
+
+void dlg_snapshot_process(int rank)
+{
+	struct itimerspec its;
+	int fd;
+
+	if (reactor_proc_init("dialog snapshot") < 0) {
+		LM_ERR("failed to init the dialog snapshot process\n");
+		return;
+	}
+
+	if ((fd = timerfd_create(CLOCK_MONOTONIC, 0)) < 0) {
+		LM_ERR("failed to create the snapshot timer FD (%d) <%s>\n",
+			errno, strerror(errno));
+		return;
+	}
+
+	memset(&its, 0, sizeof its);
+	its.it_value.tv_sec = dlg_snapshot_interval;
+	its.it_interval.tv_sec = dlg_snapshot_interval;
+	if (timerfd_settime(fd, 0, &its, NULL) < 0) {
+		LM_ERR("failed to set the snapshot timer FD (%d) <%s>\n",
+			errno, strerror(errno));
+		close(fd);
+		return;
+	}
+
+	if (reactor_proc_add_fd(fd, dlg_snapshot_timer, NULL) < 0) {
+		LM_ERR("failed to watch the snapshot timer FD\n");
+		close(fd);
+		return;
+	}
+
+	reactor_proc_loop();
+}
+#else
+void dlg_snapshot_process(int rank)
+{
+}
+#endif
+
+
+static int dlg_snap_get_row(struct snap_cursor *cur, db_val_t *values)
+{
+	unsigned char tag;
+	int32_t i32;
+	int64_t i64;
+	str s;
+	int i;
+
+	memset(values, 0, DIALOG_TABLE_TOTAL_COL_NO * sizeof *values);
+
+	for (i = 0; i < DIALOG_TABLE_TOTAL_COL_NO; i++) {
+		if (snap_get_val(cur, tag) < 0)
+			return -1;
+
+		switch (tag) {
+		case DLG_SNAP_VAL_NULL:
+			/* some columns are strlen()'ed before checking for NULL */
+			VAL_TYPE(values+i) = DB_STR;
+			VAL_NULL(values+i) = 1;
+			VAL_STR(values+i).s = "";
+			break;
+		case DLG_SNAP_VAL_INT:
+			if (snap_get_val(cur, i32) < 0)
+				return -1;
+			VAL_TYPE(values+i) = DB_INT;
+			VAL_INT(values+i) = i32;
+			break;
+		case DLG_SNAP_VAL_BIGINT:
+			if (snap_get_val(cur, i64) < 0)
+				return -1;
+			VAL_TYPE(values+i) = DB_BIGINT;
+			VAL_BIGINT(values+i) = i64;
+			break;
+		case DLG_SNAP_VAL_STR:
+			if (snap_get_str(cur, &s) < 0)
+				return -1;
+			if (!s.s)
+				s.s = "";
+			/* the variables are expected as a blob */
+			VAL_TYPE(values+i) = (i == 17) ? DB_BLOB : DB_STR;
+			VAL_STR(values+i) = s;
+			break;
+		default:
+			LM_ERR("bad value tag %d for column %d\n", tag, i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+
+int dlg_snapshot_load(void)
+{
+	db_val_t values[DIALOG_TABLE_TOTAL_COL_NO];
+	struct snap_reader rd;
+	struct snap_cursor cur;
+	struct timeval start, end;
+	unsigned int blk, n = 0, flags;
+	uint32_t size, next_id;
+	int failed = 0, found_ended_dlgs = 0, final;
+
+	if (!dlg_snapshot_file)
+		return DLG_SNAP_NONE;
+
+	snap_ready = 1;
+	gettimeofday(&start, NULL);
+
+	if (snap_open_read(&rd, dlg_snapshot_file, DLG_SNAP_MAGIC,
+	DLG_SNAP_VERSION) != 0)
+		return DLG_SNAP_NONE;
+
+	if (snap_open_block(&rd, 0, &cur) < 0 || snap_get_val(&cur, size) < 0 ||
+	rd.n_blocks != size + 1) {
+		LM_ERR("bad dialog snapshot %s, ignoring it\n", dlg_snapshot_file);
+		goto ignore;
+	}
+
+	if (size != d_table->size) {
+		LM_WARN("%s was written with a different hash_size (%u), "
+			"ignoring it\n", dlg_snapshot_file, size);
+		goto ignore;
+	}
+
+	final = rd.flags & SNAP_FL_FINAL;
+
+	if (!final && dlg_db_mode != DB_MODE_REALTIME &&
+	dlg_db_mode != DB_MODE_DELAYED) {
+		LM_WARN("%s was not written on shutdown and cannot be checked "
+			"against the DB, ignoring it\n", dlg_snapshot_file);
+		goto ignore;
+	}
+
+	/* the dialogs not confirmed by the DB are to be dropped */
+	flags = final ? 0 : DLG_FLAG_SNAPSHOT;
+
+	for (blk = 1; blk < rd.n_blocks; blk++) {
+		if (snap_open_block(&rd, blk, &cur) < 0 ||
+		snap_get_val(&cur, next_id) < 0) {
+			failed = 1;
+			continue;
+		}
+
+		d_table->entries[blk - 1].next_id = next_id;
+
+		while (!snap_cursor_end(&cur)) {
+			if (dlg_snap_get_row(&cur, values) < 0) {
+				LM_ERR("truncated dialog in block %u of the snapshot\n", blk);
+				failed = 1;
+				break;
+			}
+
+			if (dlg_load_db_row(values, flags, &found_ended_dlgs) < 0) {
+				failed = 1;
+				break;
+			}
+			n++;
+		}
+	}
+
+	snap_close(&rd);
+
+	gettimeofday(&end, NULL);
+	LM_INFO("restored %u dialogs from %s in %ld ms%s\n", n, dlg_snapshot_file,
+		(end.tv_sec - start.tv_sec) * 1000 +
+		(end.tv_usec - start.tv_usec) / 1000,
+		failed ? " (with errors)" : "");
+
+	if (!final)
+		return DLG_SNAP_PERIODIC;
+
+	/* the DB is complete, so the missing dialogs may be loaded from it */
+	return failed ? DLG_SNAP_NONE : DLG_SNAP_FINAL;
+
+ignore:
+	snap_close(&rd);
+	return DLG_SNAP_NONE;
+}
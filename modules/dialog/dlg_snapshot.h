@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Restart persistency through binary snapshots of the dialog table
+ *
+ * Each dialog is stored as a full row of the dialog DB table, so a snapshot
+ * is restored through the very same code as the DB data. A snapshot written
+ * on shutdown replaces the DB loading altogether, while a periodic one is
+ * only reconciled with the DB for the changes made after it was written.
+ */
+
+#ifndef _DIALOG_DLG_SNAPSHOT_H_
+#define _DIALOG_DLG_SNAPSHOT_H_
+
+extern char *dlg_snapshot_file;
+extern int dlg_snapshot_interval;
+
+int dlg_init_snapshot(void);
+
+/* the process periodically writing the snapshot */
+void dlg_snapshot_process(int rank);
+
+/* returns how the dialogs were restored (DLG_SNAP_* values) */
+int dlg_snapshot_load(void);
+
+/* dump the dialog table; @final is set when called on shutdown */
+int dlg_snapshot_write(int final, int do_lock);
+
+#endif /* _DIALOG_DLG_SNAPSHOT_H_ */
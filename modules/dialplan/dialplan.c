@@ -81,6 +81,8 @@ static void dp_print_list(void);
 
 static str default_param_s = str_init(DEFAULT_PARAM);
 str dp_df_part = str_init(DEFAULT_PARTITION);
+int dp_prefix_index = 1;
+int dp_dpid_stats = 0;
 dp_param_p default_par2 = NULL;
 static str database_url = {NULL, 0};
 
@@ -100,6 +102,8 @@ static param_export_t mod_params[]={
 	{ "attrs_col",		STR_PARAM,	&attrs_column.s },
 	{ "timerec_col",        STR_PARAM,      &timerec_column.s },
 	{ "disabled_col",	STR_PARAM,	&disabled_column.s},
+	{ "prefix_index",	INT_PARAM,	&dp_prefix_index},
+	{ "dpid_stats",		INT_PARAM,	&dp_dpid_stats},
 	{0,0,0}
 };
 
@@ -31,6 +31,7 @@
 
 #include "../../db/db.h"
 #include "../../re.h"
+#include "../../statistics.h"
 #include <pcre.h>
 
 #define REGEX_OP	1
@@ -40,6 +41,7 @@
 
 #define DP_CASE_INSENSITIVE		1
 #define DP_INDEX_HASH_SIZE		16
+#define DP_MAX_PREFIX_LEN		32
 
 typedef struct dpl_node{
 	int dpid;
@@ -53,8 +55,10 @@ typedef struct dpl_node{
 	str attrs;
 	str timerec;
 	tmrec_expr *parsed_timerec;
+	int ord; /*position among the regexp rules of the dpid*/
 
 	struct dpl_node * next; /*next rule*/
+	struct dpl_node * next_idx; /*next rule in the same prefix index node*/
 }dpl_node_t, *dpl_node_p;
 
 /* HASH_SIZE	buckets of matching strings (lowercase hashing)
@@ -65,10 +69,25 @@ typedef struct dpl_index{
 
 }dpl_index_t, *dpl_index_p;
 
+/* trie over the literal prefixes the regexp rules are anchored to;
+   a node holds (in load order) the rules whose prefix ends there */
+typedef struct dpl_prefix_node{
+	char c;
+	dpl_node_t * first_rule;
+	dpl_node_t * last_rule;
+	struct dpl_prefix_node * kids;
+	struct dpl_prefix_node * next;
+}dpl_prefix_node_t, *dpl_prefix_node_p;
+
 /*For every DPID*/
 typedef struct dpl_id{
 	int dp_id;
 	dpl_index_t* rule_hash;/*fast access :string rules are hashed*/
+	dpl_prefix_node_t regex_index;/*the root holds the non-prefixed regexps*/
+	int regex_no;
+	stat_var *lookups;
+	stat_var *matches;
+	stat_var *match_usec;
 	struct dpl_id * next;
 }dpl_id_t,*dpl_id_p;
 
@@ -137,5 +156,7 @@ void wrap_pcre_free( pcre*);
 
 extern rw_lock_t *ref_lock;
 extern str dp_df_part;
+extern int dp_prefix_index;
+extern int dp_dpid_stats;
 
 #endif
@@ -24,6 +24,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 
 #include "../../dprint.h"
 #include "../../ut.h"
@@ -586,6 +587,129 @@ err:
 }
 
 
+/* gets the literal prefix any string matching the regexp rule must start
+ * with (e.g. "^\\+4021[0-9]+$" -> "+4021"), 0 if none can be found */
+static int dp_regex_prefix(dpl_node_t *rule, char *prefix)
+{
+	char *p = rule->match_exp.s, *end = p + rule->match_exp.len;
+	int len = 0;
+	char c;
+
+	if (p == end || *p != '^')
+		return 0;
+
+	/* an alternation may have branches with other (or no) anchors */
+	if (memchr(p, '|', rule->match_exp.len))
+		return 0;
+
+	for (p++; p < end && len < DP_MAX_PREFIX_LEN; p++) {
+		c = *p;
+		if (c == '\\') {
+			/* only the escaped punctuation chars stand for themselves */
+			if (p + 1 == end || isalnum((unsigned char)p[1]))
+				break;
+			c = *++p;
+		} else if (strchr(".[]()?*+{}^$", c)) {
+			break;
+		}
+
+		/* an optional char ends the prefix */
+		if (p + 1 < end && strchr("?*{", p[1]))
+			break;
+
+		if ((rule->match_flags & DP_CASE_INSENSITIVE) &&
+		isalpha((unsigned char)c))
+			break;
+
+		prefix[len++] = c;
+
+		/* the char is mandatory, but may repeat */
+		if (p + 1 < end && p[1] == '+')
+			break;
+	}
+
+	return len;
+}
+
+
+static int dp_index_regex_rule(dpl_id_p idp, dpl_node_t *rule)
+{
+	char prefix[DP_MAX_PREFIX_LEN];
+	dpl_prefix_node_p node, kid;
+	int len, i;
+
+	rule->ord = idp->regex_no++;
+	len = dp_prefix_index ? dp_regex_prefix(rule, prefix) : 0;
+
+	for (i = 0, node = &idp->regex_index; i < len; i++, node = kid) {
+		for (kid = node->kids; kid && kid->c != prefix[i]; kid = kid->next) ;
+
+		if (!kid) {
+			kid = shm_malloc(sizeof *kid);
+			if (!kid) {
+				LM_ERR("out of shm memory (prefix node)\n");
+				return -1;
+			}
+			memset(kid, 0, sizeof *kid);
+			kid->c = prefix[i];
+			kid->next = node->kids;
+			node->kids = kid;
+		}
+	}
+
+	LM_DBG("rule %.*s indexed under prefix %.*s\n",
+		rule->match_exp.len, rule->match_exp.s, len, prefix);
+
+	rule->next_idx = NULL;
+	if (node->last_rule)
+		node->last_rule->next_idx = rule;
+	else
+		node->first_rule = rule;
+	node->last_rule = rule;
+
+	return 0;
+}
+
+
+static void dp_free_prefix_nodes(dpl_prefix_node_p node)
+{
+	dpl_prefix_node_p kid;
+
+	while (node->kids) {
+		kid = node->kids;
+		node->kids = kid->next;
+
+		dp_free_prefix_nodes(kid);
+		shm_free(kid);
+	}
+}
+
+
+static void dp_init_dpid_stats(dpl_id_p idp, str *partition)
+{
+	static const char *names[] = {"lookups", "matches", "match_usec"};
+	stat_var **vars[] = {&idp->lookups, &idp->matches, &idp->match_usec};
+	char buf[128];
+	str name;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		name.s = buf;
+		name.len = snprintf(buf, sizeof buf, "dp_%.*s_%d_%s",
+			partition->len, partition->s, idp->dp_id, names[i]);
+		if (name.len < 0 || name.len >= (int)sizeof buf)
+			continue;
+
+		/* keep the counters across reloads */
+		if ((*vars[i] = get_stat(&name)) == NULL &&
+		register_dynamic_stat(&name, vars[i]) != 0) {
+			LM_ERR("failed to register statistic %.*s\n", name.len, name.s);
+			*vars[i] = NULL;
+		}
+	}
+}
+
+
 int add_rule2hash(dpl_node_t * rule, dp_connection_list_t *conn, int index)
 {
 	dpl_id_p crt_idp;
@@ -610,6 +734,8 @@ int add_rule2hash(dpl_node_t * rule, dp_connection_list_t *conn, int index)
 		memset(crt_idp, 0, sizeof(dpl_id_t) + (DP_INDEX_HASH_SIZE+1) * sizeof(dpl_index_t));
 		crt_idp->dp_id = rule->dpid;
 		crt_idp->rule_hash = (dpl_index_t*)(crt_idp + 1);
+		if (dp_dpid_stats)
+			dp_init_dpid_stats(crt_idp, &conn->partition);
 		new_id = 1;
 		LM_DBG("new dpl_id %i\n", rule->dpid);
 	}
@@ -617,6 +743,8 @@ int add_rule2hash(dpl_node_t * rule, dp_connection_list_t *conn, int index)
 	switch (rule->matchop) {
 		case REGEX_OP:
 			indexp = &crt_idp->rule_hash[DP_INDEX_HASH_SIZE];
+			if (dp_index_regex_rule(crt_idp, rule) != 0)
+				goto err;
 			break;
 
 		case EQUAL_OP:
@@ -657,8 +785,10 @@ int add_rule2hash(dpl_node_t * rule, dp_connection_list_t *conn, int index)
 	return 0;
 
 err:
-	if(new_id)
+	if(new_id) {
+		dp_free_prefix_nodes(&crt_idp->regex_index);
 		shm_free(crt_idp);
+	}
 	return -1;
 }
 
@@ -688,6 +818,7 @@ void destroy_hash(dpl_id_t **rules_hash)
 				rulep = NULL;
 			}
 		}
+		dp_free_prefix_nodes(&crt_idp->regex_index);
 		*rules_hash = crt_idp->next;
 
 		shm_free(crt_idp);
@@ -22,7 +22,10 @@
  *  2007-08-01 initial version (ancuta onofrei)
  */
 
+#include <sys/time.h>
+
 #include "../../re.h"
+#include "../../ut.h"
 #include "../../time_rec.h"
 #include "dialplan.h"
 
@@ -274,17 +277,34 @@ error:
 	return -1;
 }
 
+/* returns (in rule order) the next regexp rule which may match the input,
+ * out of the candidate lists of the prefix index */
+static inline dpl_node_p next_regex_candidate(dpl_node_p *cands, int n)
+{
+	dpl_node_p rule = NULL;
+	int i, k = 0;
+
+	for (i = 0; i < n; i++)
+		if (cands[i] && (!rule || cands[i]->ord < rule->ord)) {
+			rule = cands[i];
+			k = i;
+		}
+
+	if (rule)
+		cands[k] = rule->next_idx;
+
+	return rule;
+}
+
 #define DP_MAX_ATTRS_LEN	256
 static char dp_attrs_buf[DP_MAX_ATTRS_LEN+1];
-int translate(struct sip_msg *msg, str input, str * output, dpl_id_p idp, str * attrs) {
+static int _translate(struct sip_msg *msg, str input, str * output,
+		dpl_id_p idp, str * attrs) {
 
 	dpl_node_p rulep, rrulep;
-	int string_res = -1, regexp_res = -1, bucket;
-
-	if(!input.s || !input.len) {
-		LM_ERR("invalid input string\n");
-		return -1;
-	}
+	dpl_node_p cands[DP_MAX_PREFIX_LEN + 1];
+	dpl_prefix_node_p node;
+	int string_res = -1, regexp_res = -1, bucket, n, i;
 
 	bucket = core_case_hash(&input, NULL, DP_INDEX_HASH_SIZE);
 
@@ -321,8 +341,25 @@ int translate(struct sip_msg *msg, str input, str * output, dpl_id_p idp, str *
 		}
 	}
 
+	/* only the regexps anchored to a prefix of the input (or not anchored
+	 * to any prefix at all) are worth trying */
+	node = &idp->regex_index;
+	n = 0;
+	if (node->first_rule)
+		cands[n++] = node->first_rule;
+
+	for (i = 0; i < input.len && node->kids; i++) {
+		for (node = node->kids; node && node->c != input.s[i];
+			node = node->next) ;
+		if (!node)
+			break;
+
+		if (node->first_rule)
+			cands[n++] = node->first_rule;
+	}
+
 	/* try to match the input in the regexp bucket */
-	for (rrulep = idp->rule_hash[DP_INDEX_HASH_SIZE].first_rule; rrulep; rrulep=rrulep->next) {
+	while ((rrulep = next_regex_candidate(cands, n))) {
 
 		// Check for Time Period if Set
 		if(rrulep->parsed_timerec) {
@@ -396,6 +433,30 @@ int translate(struct sip_msg *msg, str input, str * output, dpl_id_p idp, str *
 	return 0;
 }
 
+int translate(struct sip_msg *msg, str input, str * output, dpl_id_p idp,
+		str * attrs) {
+	struct timeval start;
+	int ret;
+
+	if(!input.s || !input.len) {
+		LM_ERR("invalid input string\n");
+		return -1;
+	}
+
+	if (!idp->lookups)
+		return _translate(msg, input, output, idp, attrs);
+
+	gettimeofday(&start, NULL);
+	ret = _translate(msg, input, output, idp, attrs);
+
+	update_stat(idp->lookups, 1);
+	update_stat(idp->match_usec, get_time_diff(&start));
+	if (ret == 0)
+		update_stat(idp->matches, 1);
+
+	return ret;
+}
+
 
 int test_match(str string, pcre * exp, int * out, int out_max)
 {
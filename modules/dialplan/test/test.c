@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include <tap.h>
+
+#include "../../../dprint.h"
+#include "../../../ut.h"
+#include "../../../mem/shm_mem.h"
+
+#include "../dialplan.h"
+
+extern int add_rule2hash(dpl_node_t *rule, dp_connection_list_t *conn,
+		int index);
+extern void destroy_hash(dpl_id_t **rules_hash);
+
+#define BENCH_DPID     1
+#define BENCH_RULES    10000
+#define BENCH_LOOKUPS  5000
+
+static char prefixes[BENCH_RULES][16];
+
+
+static dpl_node_t *new_regex_rule(const char *exp, int pr, int id)
+{
+	dpl_node_t *rule;
+	char attrs[16];
+
+	rule = shm_malloc(sizeof *rule);
+	if (!rule)
+		return NULL;
+	memset(rule, 0, sizeof *rule);
+
+	rule->dpid = BENCH_DPID;
+	rule->pr = pr;
+	rule->table_id = id;
+	rule->matchop = REGEX_OP;
+
+	rule->match_exp.len = strlen(exp);
+	rule->match_exp.s = shm_malloc(rule->match_exp.len + 1);
+	rule->match_comp = wrap_pcre_compile((char *)exp, 0);
+
+	sprintf(attrs, "r%d", id);
+	rule->attrs.len = strlen(attrs);
+	rule->attrs.s = shm_malloc(rule->attrs.len);
+
+	if (!rule->match_exp.s || !rule->match_comp || !rule->attrs.s)
+		return NULL;
+
+	memcpy(rule->match_exp.s, exp, rule->match_exp.len + 1);
+	memcpy(rule->attrs.s, attrs, rule->attrs.len);
+
+	return rule;
+}
+
+
+/* loads the same large rule set into the given partition; most rules are
+ * anchored to a number prefix, some are not indexable at all */
+static int load_rules(dp_connection_list_t *conn)
+{
+	char exp[64];
+	dpl_node_t *rule;
+	int i;
+
+	for (i = 0; i < BENCH_RULES; i++) {
+		if (i % 500 == 250)
+			sprintf(exp, "[0-9]{4}%03d$", i % 1000);
+		else if (i % 3)
+			sprintf(exp, "^\\+%s[0-9]*$", prefixes[i]);
+		else
+			sprintf(exp, "^%s[0-9]{2,}", prefixes[i]);
+
+		rule = new_regex_rule(exp, i / 100, i);
+		if (!rule || add_rule2hash(rule, conn, 0) != 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+
+static long run_lookups(dpl_id_p idp, str *inputs, str *results)
+{
+	struct timeval start;
+	str out, attrs;
+	int i;
+
+	gettimeofday(&start, NULL);
+
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		results[i].len = 0;
+		if (translate(NULL, inputs[i], &out, idp, &attrs) == 0) {
+			results[i].s = pkg_malloc(attrs.len);
+			memcpy(results[i].s, attrs.s, attrs.len);
+			results[i].len = attrs.len;
+		}
+	}
+
+	return get_time_diff(&start);
+}
+
+
+static void test_prefix_index(void)
+{
+	static str idx_part = str_init("bench_idx"), lin_part = str_init("bench");
+	dp_connection_list_t idx_conn, lin_conn;
+	str inputs[BENCH_LOOKUPS], idx_res[BENCH_LOOKUPS], lin_res[BENCH_LOOKUPS];
+	dpl_id_p idx_idp, lin_idp;
+	long idx_us, lin_us;
+	int i, j, mismatches = 0, matched = 0;
+
+	srand(42);
+	for (i = 0; i < BENCH_RULES; i++) {
+		j = sprintf(prefixes[i], "40%d", 2 + rand() % 8);
+		while (j < 4 + rand() % 6)
+			prefixes[i][j++] = '0' + rand() % 10;
+		prefixes[i][j] = '\0';
+	}
+
+	memset(&idx_conn, 0, sizeof idx_conn);
+	memset(&lin_conn, 0, sizeof lin_conn);
+	idx_conn.partition = idx_part;
+	lin_conn.partition = lin_part;
+
+	dp_prefix_index = 0;
+	dp_dpid_stats = 0;
+	ok(load_rules(&lin_conn) == 0, "load linear rule set");
+
+	dp_prefix_index = 1;
+	dp_dpid_stats = 1;
+	ok(load_rules(&idx_conn) == 0, "load indexed rule set");
+
+	lin_idp = select_dpid(&lin_conn, BENCH_DPID, 0);
+	idx_idp = select_dpid(&idx_conn, BENCH_DPID, 0);
+	if (!ok(lin_idp && idx_idp, "dpids loaded"))
+		return;
+
+	ok(idx_idp->regex_index.first_rule != NULL &&
+		idx_idp->regex_index.kids != NULL, "prefixed rules are indexed");
+
+	/* a mix of numbers matching some rule prefix and random numbers */
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		inputs[i].s = pkg_malloc(32);
+		if (i % 4)
+			inputs[i].len = sprintf(inputs[i].s, "%s%s%d", i % 2 ? "+" : "",
+				prefixes[rand() % BENCH_RULES], rand() % 100000);
+		else
+			inputs[i].len = sprintf(inputs[i].s, "%d%d", rand(), rand());
+	}
+
+	lin_us = run_lookups(lin_idp, inputs, lin_res);
+	idx_us = run_lookups(idx_idp, inputs, idx_res);
+
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		if (lin_res[i].len)
+			matched++;
+		if (!str_match(&lin_res[i], &idx_res[i])) {
+			mismatches++;
+			diag("input %.*s: linear %.*s, indexed %.*s",
+				inputs[i].len, inputs[i].s, lin_res[i].len, lin_res[i].s,
+				idx_res[i].len, idx_res[i].s);
+		}
+	}
+
+	ok(matched > 0, "lookups matched");
+	ok(mismatches == 0, "indexed matching picks the same rules");
+
+	diag("%d lookups over %d regexp rules (%d matched): linear %ldus "
+		"(%.2fus/lookup), indexed %ldus (%.2fus/lookup)", BENCH_LOOKUPS,
+		BENCH_RULES, matched, lin_us, (double)lin_us / BENCH_LOOKUPS,
+		idx_us, (double)idx_us / BENCH_LOOKUPS);
+
+	ok(get_stat_val(idx_idp->lookups) == BENCH_LOOKUPS, "dpid lookups stat");
+	ok(get_stat_val(idx_idp->matches) == matched, "dpid matches stat");
+
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		pkg_free(inputs[i].s);
+		if (lin_res[i].len)
+			pkg_free(lin_res[i].s);
+		if (idx_res[i].len)
+			pkg_free(idx_res[i].s);
+	}
+
+	destroy_hash(&lin_conn.hash[0]);
+	destroy_hash(&idx_conn.hash[0]);
+}
+
+
+void mod_tests(void)
+{
+	test_prefix_index();
+}
@@ -30,6 +30,7 @@
 #include "../../dprint.h"
 #include "../../route.h"
 #include "../../db/db.h"
+#include "../../db/db_preload.h"
 #include "../../mem/shm_mem.h"
 #include "../../mem/rpm_mem.h"
 #include "../../time_rec.h"
@@ -273,6 +274,120 @@ void dr_update_head_cache(struct head_db *head)
 #define STR_VALS_ATTRS_DRR_COL    5
 #define STR_VALS_SORT_ALG_DRR_COL 6
 
+struct dr_rule_load_ctx {
+	struct head_db *part;
+	rt_data_t *rdata;
+	int n;
+};
+
+/* builds and adds a routing rule out of a dr_rules row */
+static int dr_load_rule_row(db_val_t *vals, int n_vals, void *param)
+{
+	struct dr_rule_load_ctx *ctx = (struct dr_rule_load_ctx *)param;
+	int    int_vals[5];
+	char * str_vals[7];
+	str tmp;
+	rt_info_t *ri;
+	tmrec_expr *time_rec;
+	char id_buf[INT2STR_MAX_LEN];
+
+	/* RULE_ID column */
+	check_val( rule_id_drr_col, vals, DB_INT, 1, 0);
+	int_vals[INT_VALS_RULE_ID_DRR_COL] = VAL_INT (vals);
+	/* GROUP column */
+	check_val( group_drr_col, vals+1, DB_STRING, 1, 1);
+	str_vals[STR_VALS_GROUP_DRR_COL] =
+		(char*)VAL_STRING(vals+1);
+	/* PREFIX column - it may be null or empty */
+	check_val( prefix_drr_col, vals+2, DB_STRING, 0, 0);
+	if ((vals+2)->nul || VAL_STRING(vals+2)==0){
+		tmp.s = NULL;
+		tmp.len = 0;
+	} else {
+		str_vals[STR_VALS_PREFIX_DRR_COL] =
+			(char*)VAL_STRING(vals+2);
+		tmp.s = str_vals[STR_VALS_PREFIX_DRR_COL];
+		tmp.len = strlen(str_vals[STR_VALS_PREFIX_DRR_COL]);
+	}
+	/* TIME column */
+	check_val( time_drr_col, vals+3,
+		vals[3].type == DB_BLOB ? DB_BLOB : DB_STRING, 0, 0);
+	/* PRIORITY column */
+	check_val2( priority_drr_col, vals+4, DB_INT, DB_BIGINT, 1, 0);
+	int_vals[INT_VALS_PRIORITY_DRR_COL] = VAL_INT(vals+4);
+	/* ROUTE_ID column */
+	check_val( routeid_drr_col, vals+5, DB_STRING, 0, 0);
+	/* DSTLIST column */
+	check_val2( dstlist_drr_col, vals+6, DB_STRING, DB_BLOB, 0, 1);
+	str_vals[STR_VALS_DSTLIST_DRR_COL] = vals[6].type == DB_STRING ?
+		(char*)VAL_STRING(vals+6) : VAL_BLOB(vals+6).s;
+	/* SORT_ALG column */
+	if( VAL_TYPE(vals+7) == DB_INT ) {
+		check_val(sort_alg_drr_col, vals+7, DB_INT, 1, 0);
+		str_vals[STR_VALS_SORT_ALG_DRR_COL] = int2bstr((unsigned long)
+				VAL_INT(vals+7), id_buf, &int_vals[0]);
+	} else {
+		check_val(sort_alg_drr_col, vals+7, DB_STRING, 1, 0);
+		str_vals[STR_VALS_SORT_ALG_DRR_COL] = (char*)VAL_STRING(
+				vals+7);
+	}
+	/* SORT_PROFILE column */
+	check_val2(sort_profile_drr_col, vals+8, DB_INT, DB_BIGINT, 0, 0);
+	int_vals[INT_VALS_QR_PROFILE_DRR_COL] = VAL_INT(vals+8);
+	/* ATTRS column */
+	check_val2( attrs_drr_col, vals+9, DB_STRING, DB_BLOB, 0, 0);
+	str_vals[STR_VALS_ATTRS_DRR_COL] = vals[9].type == DB_STRING ?
+		(char*)VAL_STRING(vals+9) : VAL_BLOB(vals+9).s;
+	/* parse the time definition */
+	if ( VAL_NULL(vals+3) ||
+	((str_vals[STR_VALS_TIME_DRR_COL]=
+		(char*)VAL_STRING(vals+3))==NULL ) ||
+	*(str_vals[STR_VALS_TIME_DRR_COL]) == 0)
+		time_rec = NULL;
+	else if ((time_rec = tmrec_expr_parse(
+	              str_vals[STR_VALS_TIME_DRR_COL], SHM_ALLOC))==0) {
+		LM_ERR("bad time definition <%s> for rule id %d -> skipping\n",
+			str_vals[STR_VALS_TIME_DRR_COL],
+			int_vals[INT_VALS_RULE_ID_DRR_COL]);
+		return 0;
+	}
+	/* set the script route ID */
+	if ( VAL_NULL(vals+5) ||
+	((str_vals[STR_VALS_ROUTEID_DRR_COL]=
+		(char*)VAL_STRING(vals+5))==NULL ) ||
+	str_vals[STR_VALS_ROUTEID_DRR_COL][0]==0 ) {
+		str_vals[STR_VALS_ROUTEID_DRR_COL] = NULL;
+	}
+	/* build the routing rule */
+	if ((ri = build_rt_info( int_vals[INT_VALS_RULE_ID_DRR_COL],
+					int_vals[INT_VALS_PRIORITY_DRR_COL], time_rec,
+					str_vals[STR_VALS_ROUTEID_DRR_COL],
+					str_vals[STR_VALS_DSTLIST_DRR_COL],
+					str_vals[STR_VALS_SORT_ALG_DRR_COL],
+					int_vals[INT_VALS_QR_PROFILE_DRR_COL],
+					str_vals[STR_VALS_ATTRS_DRR_COL], ctx->rdata,
+					ctx->part->malloc,
+					ctx->part->free))== 0 ) {
+		LM_ERR("failed to add routing info for rule id %d -> "
+				"skipping\n", int_vals[INT_VALS_RULE_ID_DRR_COL]);
+		tmrec_expr_free( time_rec );
+		return 0;
+	}
+	/* add the rule */
+	if (add_rule(ctx->rdata, str_vals[STR_VALS_GROUP_DRR_COL], &tmp, ri,
+			ctx->part->malloc, ctx->part->free)!=0) {
+		LM_ERR("failed to add rule id %d -> skipping\n",
+				int_vals[INT_VALS_RULE_ID_DRR_COL]);
+		free_rt_info(ri, ctx->part->free);
+		return 0;
+	}
+	ctx->n++;
+
+	return 0;
+error:
+	return -1;
+}
+
 /* loads routing info for given partition; if partition_name is NULL
  * loads all partitions
  */
@@ -284,7 +399,6 @@ rt_data_t* dr_load_routing_info(struct head_db *part,
 {
 	int    int_vals[5];
 	char * str_vals[7];
-	str tmp;
 	db_func_t *dr_dbf = &part->db_funcs;
 	db_con_t* db_hdl = *part->db_con;
 	str *drd_table = &part->drd_table;
@@ -292,10 +406,10 @@ rt_data_t* dr_load_routing_info(struct head_db *part,
 	db_key_t columns[10];
 	db_res_t* res;
 	db_row_t* row;
-	rt_info_t *ri;
 	rt_data_t *rdata;
-	tmrec_expr *time_rec;
-	int i, j, n, tot_gw = 0, tot_cr = 0, tot_rl = 0;
+	struct db_preload preload;
+	struct dr_rule_load_ctx rule_ctx;
+	int i, j, tot_gw = 0, tot_cr = 0, tot_rl = 0;
 	int no_rows = 10;
 	int db_cols;
 	struct socket_info *sock;
@@ -304,7 +418,6 @@ rt_data_t* dr_load_routing_info(struct head_db *part,
 	char id_buf[INT2STR_MAX_LEN];
 
 	res = 0;
-	ri = 0;
 	rdata = 0;
 
 	/* init new data structure */
@@ -586,162 +699,44 @@ rt_data_t* dr_load_routing_info(struct head_db *part,
 	dr_dbf->free_result(db_hdl, res);
 	res = 0;
 
+	columns[0] = &rule_id_drr_col;
+	columns[1] = &group_drr_col;
+	columns[2] = &prefix_drr_col;
+	columns[3] = &time_drr_col;
+	columns[4] = &priority_drr_col;
+	columns[5] = &routeid_drr_col;
+	columns[6] = &dstlist_drr_col;
+	columns[7] = &sort_alg_drr_col;
+	columns[8] = &sort_profile_drr_col;
+	columns[9] = &attrs_drr_col;
+
+	memset(&preload, 0, sizeof preload);
+	preload.url = &part->db_url;
+	preload.dbf = dr_dbf;
+	preload.cols = columns;
+	preload.n_cols = 10;
+	preload.split_key = &rule_id_drr_col;
+	preload.row_size = 4+32+32+128+32+64+128+4+1;
+
+	rule_ctx.part = part;
+	rule_ctx.rdata = rdata;
+
 	for (j = 0; j < rules_tables_no; j++) {
-		/* read the routing rules */
-		if (dr_dbf->use_table(db_hdl, rules_tables + j) < 0) {
-			LM_ERR("cannot select table \"%.*s\"\n",
+		/* read the routing rules (in parallel, if so configured) */
+		preload.table = rules_tables + j;
+		rule_ctx.n = 0;
+
+		if (db_preload_table(&preload, db_hdl, dr_load_rule_row,
+		&rule_ctx) < 0) {
+			LM_ERR("failed to load the rules from table \"%.*s\"\n",
 			       rules_tables[j].len, rules_tables[j].s);
 			goto error;
 		}
 
-		columns[0] = &rule_id_drr_col;
-		columns[1] = &group_drr_col;
-		columns[2] = &prefix_drr_col;
-		columns[3] = &time_drr_col;
-		columns[4] = &priority_drr_col;
-		columns[5] = &routeid_drr_col;
-		columns[6] = &dstlist_drr_col;
-		columns[7] = &sort_alg_drr_col;
-		columns[8] = &sort_profile_drr_col;
-		columns[9] = &attrs_drr_col;
-
-		if (DB_CAPABILITY(*dr_dbf, DB_CAP_FETCH)) {
-			if ( dr_dbf->query( db_hdl, 0, 0, 0, columns, 0, 10, 0, 0) < 0) {
-				LM_ERR("DB query failed\n");
-				goto error;
-			}
-			no_rows = estimate_available_rows( 4+32+32+128+32+64+128+4+1, 10/*cols*/);
-			if (no_rows==0) no_rows = 10;
-			if(dr_dbf->fetch_result(db_hdl, &res, no_rows)<0) {
-				LM_ERR("Error fetching rows (2)\n");
-				goto error;
-			}
-		} else {
-			if ( dr_dbf->query( db_hdl, 0, 0, 0, columns, 0, 10, 0, &res) < 0) {
-				LM_ERR("DB query failed\n");
-				goto error;
-			}
-		}
-
-		LM_DBG("initial %d records found in %.*s\n", RES_ROW_N(res),
-		       rules_tables[j].len, rules_tables[j].s);
-
-		n = 0;
-		do {
-			for(i=0; i < RES_ROW_N(res); i++) {
-				row = RES_ROWS(res) + i;
-				/* RULE_ID column */
-				check_val( rule_id_drr_col, ROW_VALUES(row), DB_INT, 1, 0);
-				int_vals[INT_VALS_RULE_ID_DRR_COL] = VAL_INT (ROW_VALUES(row));
-				/* GROUP column */
-				check_val( group_drr_col, ROW_VALUES(row)+1, DB_STRING, 1, 1);
-				str_vals[STR_VALS_GROUP_DRR_COL] =
-					(char*)VAL_STRING(ROW_VALUES(row)+1);
-				/* PREFIX column - it may be null or empty */
-				check_val( prefix_drr_col, ROW_VALUES(row)+2, DB_STRING, 0, 0);
-				if ((ROW_VALUES(row)+2)->nul || VAL_STRING(ROW_VALUES(row)+2)==0){
-					tmp.s = NULL;
-					tmp.len = 0;
-				} else {
-					str_vals[STR_VALS_PREFIX_DRR_COL] =
-						(char*)VAL_STRING(ROW_VALUES(row)+2);
-					tmp.s = str_vals[STR_VALS_PREFIX_DRR_COL];
-					tmp.len = strlen(str_vals[STR_VALS_PREFIX_DRR_COL]);
-				}
-				/* TIME column */
-				check_val( time_drr_col, ROW_VALUES(row)+3,
-					ROW_VALUES(row)[3].type == DB_BLOB ? DB_BLOB : DB_STRING, 0, 0);
-				/* PRIORITY column */
-				check_val2( priority_drr_col, ROW_VALUES(row)+4, DB_INT, DB_BIGINT, 1, 0);
-				int_vals[INT_VALS_PRIORITY_DRR_COL] = VAL_INT(ROW_VALUES(row)+4);
-				/* ROUTE_ID column */
-				check_val( routeid_drr_col, ROW_VALUES(row)+5, DB_STRING, 0, 0);
-				/* DSTLIST column */
-				check_val2( dstlist_drr_col, ROW_VALUES(row)+6, DB_STRING, DB_BLOB, 0, 1);
-				str_vals[STR_VALS_DSTLIST_DRR_COL] = ROW_VALUES(row)[6].type == DB_STRING ?
-					(char*)VAL_STRING(ROW_VALUES(row)+6) : VAL_BLOB(ROW_VALUES(row)+6).s;
-				/* SORT_ALG column */
-				if( VAL_TYPE(ROW_VALUES(row)+7) == DB_INT ) {
-					check_val(sort_alg_drr_col, ROW_VALUES(row)+7, DB_INT, 1, 0);
-					str_vals[STR_VALS_SORT_ALG_DRR_COL] = int2bstr((unsigned long)
-							VAL_INT(ROW_VALUES(row)+7), id_buf, &int_vals[0]);
-				} else {
-					check_val(sort_alg_drr_col, ROW_VALUES(row)+7, DB_STRING, 1, 0);
-					str_vals[STR_VALS_SORT_ALG_DRR_COL] = (char*)VAL_STRING(
-							ROW_VALUES(row)+7);
-				}
-				/* SORT_PROFILE column */
-				check_val2(sort_profile_drr_col, ROW_VALUES(row)+8, DB_INT, DB_BIGINT, 0, 0);
-				int_vals[INT_VALS_QR_PROFILE_DRR_COL] = VAL_INT(ROW_VALUES(row)+8);
-				/* ATTRS column */
-				check_val2( attrs_drr_col, ROW_VALUES(row)+9, DB_STRING, DB_BLOB, 0, 0);
-				str_vals[STR_VALS_ATTRS_DRR_COL] = ROW_VALUES(row)[9].type == DB_STRING ?
-					(char*)VAL_STRING(ROW_VALUES(row)+9) : VAL_BLOB(ROW_VALUES(row)+9).s;
-				/* parse the time definition */
-				if ( VAL_NULL(ROW_VALUES(row)+3) ||
-				((str_vals[STR_VALS_TIME_DRR_COL]=
-					(char*)VAL_STRING(ROW_VALUES(row)+3))==NULL ) ||
-				*(str_vals[STR_VALS_TIME_DRR_COL]) == 0)
-					time_rec = NULL;
-				else if ((time_rec = tmrec_expr_parse(
-				              str_vals[STR_VALS_TIME_DRR_COL], SHM_ALLOC))==0) {
-					LM_ERR("bad time definition <%s> for rule id %d -> skipping\n",
-						str_vals[STR_VALS_TIME_DRR_COL],
-						int_vals[INT_VALS_RULE_ID_DRR_COL]);
-					continue;
-				}
-				/* set the script route ID */
-				if ( VAL_NULL(ROW_VALUES(row)+5) ||
-				((str_vals[STR_VALS_ROUTEID_DRR_COL]=
-					(char*)VAL_STRING(ROW_VALUES(row)+5))==NULL ) ||
-				str_vals[STR_VALS_ROUTEID_DRR_COL][0]==0 ) {
-					str_vals[STR_VALS_ROUTEID_DRR_COL] = NULL;
-				}
-				/* build the routing rule */
-				if ((ri = build_rt_info( int_vals[INT_VALS_RULE_ID_DRR_COL],
-								int_vals[INT_VALS_PRIORITY_DRR_COL], time_rec,
-								str_vals[STR_VALS_ROUTEID_DRR_COL],
-								str_vals[STR_VALS_DSTLIST_DRR_COL],
-								str_vals[STR_VALS_SORT_ALG_DRR_COL],
-								int_vals[INT_VALS_QR_PROFILE_DRR_COL],
-								str_vals[STR_VALS_ATTRS_DRR_COL], rdata,
-								part->malloc,
-								part->free))== 0 ) {
-					LM_ERR("failed to add routing info for rule id %d -> "
-							"skipping\n", int_vals[INT_VALS_RULE_ID_DRR_COL]);
-					tmrec_expr_free( time_rec );
-					continue;
-				}
-				/* add the rule */
-				if (add_rule(rdata, str_vals[STR_VALS_GROUP_DRR_COL], &tmp, ri,
-						part->malloc, part->free)!=0) {
-					LM_ERR("failed to add rule id %d -> skipping\n",
-							int_vals[INT_VALS_RULE_ID_DRR_COL]);
-					free_rt_info(ri, part->free);
-					continue;
-				}
-				n++;
-			}
-
-			if (DB_CAPABILITY(*dr_dbf, DB_CAP_FETCH)) {
-				if(dr_dbf->fetch_result(db_hdl, &res, no_rows)<0) {
-					LM_ERR("fetching rows (2)\n");
-					goto error;
-				}
-				LM_DBG("additional %d records found in %.*s\n", RES_ROW_N(res),
-				       rules_tables[j].len, rules_tables[j].s);
-			} else {
-				break;
-			}
-		} while(RES_ROW_N(res)>0);
-
-		dr_dbf->free_result(db_hdl, res);
-		res = NULL;
-
 		if (custom_rule_tables)
-			LM_NOTICE("loaded %d rules from table '%.*s'\n", n,
+			LM_NOTICE("loaded %d rules from table '%.*s'\n", rule_ctx.n,
 			          rules_tables[j].len, rules_tables[j].s);
-		tot_rl += n;
+		tot_rl += rule_ctx.n;
 	}
 
 	LM_NOTICE("loaded %d gateways in partition '%.*s'\n", tot_gw,
@@ -324,221 +324,490 @@ void pm_empty_hash(struct address_list** table) {
 
 
 /*
- * Create and initialize a subnet table
+ * The subnets are kept in two binary radix (Patricia) trees, one for IPv4
+ * and one for IPv6. Each node holds a prefix; the nodes having no entries
+ * are only branching (glue) nodes. A lookup walks down the tree once,
+ * collecting all the prefixes covering the address, then tests the entries
+ * (group, port, proto and pattern filters) of the longest prefix first.
  */
-struct subnet* new_subnet_table(void)
-{
-    struct subnet* ptr;
 
-    /* subnet record [PERM_MAX_SUBNETS] contains in its grp field
-       the number of subnet records in the subnet table */
-    ptr = (struct subnet *)shm_malloc
-	(sizeof(struct subnet) * (PERM_MAX_SUBNETS + 1));
+#define SUBNET_MAX_DEPTH  (128 + 1)
 
-    if (!ptr) {
-		LM_ERR("no shm memory for subnet table\n");
+#define SUBNET_BIT(_key, _b) ((_key)[(_b) >> 3] & (0x80 >> ((_b) & 0x07)))
+
+#define subnet_tree(_table, _af) \
+	(&(_table)->root[(_af) == AF_INET6 ? 1 : 0])
+
+
+/* checks if the first "bits" bits of the two keys are the same */
+static inline int subnet_prefix_match(const unsigned char *a,
+		const unsigned char *b, unsigned int bits)
+{
+	unsigned int n = bits >> 3;
+
+	if (n && memcmp(a, b, n))
 		return 0;
-    }
 
-    ptr[PERM_MAX_SUBNETS].grp = 0;
-    return ptr;
+	if (bits & 0x07)
+		return ((a[n] ^ b[n]) & (0xff << (8 - (bits & 0x07))) & 0xff) == 0;
+
+	return 1;
+}
+
+
+/* returns the first bit (up to "bits") the two keys are different at */
+static inline unsigned int subnet_differ_bit(const unsigned char *a,
+		const unsigned char *b, unsigned int bits)
+{
+	unsigned int i, j;
+	unsigned char r;
+
+	for (i = 0; i * 8 < bits; i++) {
+		r = a[i] ^ b[i];
+		if (r == 0)
+			continue;
+
+		for (j = 0; !(r & (0x80 >> j)); j++);
+		return (i * 8 + j < bits) ? i * 8 + j : bits;
+	}
+
+	return bits;
+}
+
+
+static unsigned int subnet_mask_len(struct net *subnet)
+{
+	unsigned int i, len = 0;
+	unsigned char b;
+
+	for (i = 0; i < subnet->mask.len; i++) {
+		for (b = subnet->mask.u.addr[i]; b; b <<= 1)
+			len++;
+		if (subnet->mask.u.addr[i] != 0xff)
+			break;
+	}
+
+	return len;
+}
+
+
+static struct subnet_node *new_subnet_node(struct ip_addr *ip,
+		unsigned int bitlen, struct subnet_node *parent)
+{
+	struct subnet_node *node;
+	unsigned int i;
+
+	node = (struct subnet_node *)shm_malloc(sizeof *node);
+	if (!node) {
+		LM_ERR("no shm memory for subnet node\n");
+		return NULL;
+	}
+	memset(node, 0, sizeof *node);
+
+	node->bitlen = bitlen;
+	node->parent = parent;
+
+	/* the key keeps only the prefix bits */
+	node->net.ip.af = node->net.mask.af = ip->af;
+	node->net.ip.len = node->net.mask.len = ip->len;
+	for (i = 0; i < ip->len; i++) {
+		if (bitlen >= (i + 1) * 8)
+			node->net.mask.u.addr[i] = 0xff;
+		else if (bitlen > i * 8)
+			node->net.mask.u.addr[i] = 0xff << (8 - (bitlen & 0x07));
+		node->net.ip.u.addr[i] = ip->u.addr[i] & node->net.mask.u.addr[i];
+	}
+
+	return node;
+}
+
+
+static inline void subnet_node_replace(struct subnet_node **root,
+		struct subnet_node *old, struct subnet_node *new)
+{
+	if (!old->parent)
+		*root = new;
+	else if (old->parent->r == old)
+		old->parent->r = new;
+	else
+		old->parent->l = new;
+}
+
+
+/* adds the entry to the node, keeping the entries ordered by group */
+static void subnet_node_add(struct subnet_node *node, struct subnet *entry)
+{
+	struct subnet **it;
+
+	for (it = &node->entries; *it && (*it)->grp <= entry->grp;
+		it = &(*it)->next);
+
+	entry->node = node;
+	entry->next = *it;
+	*it = entry;
 }
 
 
 /*
- * Add <grp, subnet, mask, port> into subnet table so that table is
- * kept in increasing ordered according to grp.
+ * Finds (or creates) the node of the <ip, bitlen> prefix and adds the entry
  */
-int subnet_table_insert(struct subnet* table, unsigned int grp,
-			struct net *subnet,
-			unsigned int port, int proto, str* pattern, str *info)
+static int subnet_tree_insert(struct subnet_node **root, struct ip_addr *ip,
+		unsigned int bitlen, struct subnet *entry)
 {
-    int i;
-    unsigned int count;
+	struct subnet_node *node, *new_node, *glue;
+	unsigned int maxbits = ip->len * 8, check_bit, differ_bit;
+	const unsigned char *key = ip->u.addr;
 
-    count = table[PERM_MAX_SUBNETS].grp;
+	if (!*root) {
+		*root = new_subnet_node(ip, bitlen, NULL);
+		if (!*root)
+			return -1;
+		subnet_node_add(*root, entry);
+		return 0;
+	}
 
-    if (count == PERM_MAX_SUBNETS) {
-		LM_CRIT("subnet table is full\n");
+	/* go down as far as possible along the prefix bits */
+	node = *root;
+	while (node->bitlen < bitlen || !node->entries) {
+		if (node->bitlen < maxbits && SUBNET_BIT(key, node->bitlen)) {
+			if (!node->r)
+				break;
+			node = node->r;
+		} else {
+			if (!node->l)
+				break;
+			node = node->l;
+		}
+	}
+
+	check_bit = (node->bitlen < bitlen) ? node->bitlen : bitlen;
+	differ_bit = subnet_differ_bit(key, node->net.ip.u.addr, check_bit);
+
+	/* and back up to the node the new prefix branches from */
+	while (node->parent && node->parent->bitlen >= differ_bit)
+		node = node->parent;
+
+	if (differ_bit == bitlen && node->bitlen == bitlen) {
+		/* the prefix is already known (maybe as a glue node) */
+		subnet_node_add(node, entry);
 		return 0;
-    }
+	}
 
-    i = count - 1;
+	new_node = new_subnet_node(ip, bitlen, NULL);
+	if (!new_node)
+		return -1;
+	subnet_node_add(new_node, entry);
+
+	if (node->bitlen == differ_bit) {
+		/* the new prefix is a child of the node */
+		new_node->parent = node;
+		if (node->bitlen < maxbits && SUBNET_BIT(key, node->bitlen))
+			node->r = new_node;
+		else
+			node->l = new_node;
+		return 0;
+	}
 
-    while (i >= 0 && table[i].grp > grp) {
-		table[i + 1] = table[i];
-		i--;
-    }
+	if (bitlen == differ_bit) {
+		/* the new prefix covers the node */
+		if (bitlen < maxbits && SUBNET_BIT(node->net.ip.u.addr, bitlen))
+			new_node->r = node;
+		else
+			new_node->l = node;
+		new_node->parent = node->parent;
+		subnet_node_replace(root, node, new_node);
+		node->parent = new_node;
+		return 0;
+	}
 
-    table[i + 1].grp = grp;
-    table[i + 1].port = port;
-	table[i + 1].proto = proto;
+	/* the two prefixes fork at differ_bit */
+	glue = new_subnet_node(ip, differ_bit, node->parent);
+	if (!glue) {
+		shm_free(new_node);
+		return -1;
+	}
 
-	if (subnet) {
-		table[i + 1].subnet = (struct net*) shm_malloc(sizeof(struct net));
-		if (!table[i + 1].subnet) {
-			LM_ERR("cannot allocate shm memory for table subnet\n");
-			return -1;
-		}
-		memcpy(table[i + 1].subnet, subnet, sizeof(struct net));
+	if (differ_bit < maxbits && SUBNET_BIT(key, differ_bit)) {
+		glue->r = new_node;
+		glue->l = node;
+	} else {
+		glue->r = node;
+		glue->l = new_node;
 	}
-	else
-		table[i + 1].subnet = NULL;
+	new_node->parent = glue;
+	subnet_node_replace(root, node, glue);
+	node->parent = glue;
 
-	if (info->len) {
-		table[i + 1].info = (char*) shm_malloc(info->len + 1);
-		if (!table[i + 1].info) {
-			LM_ERR("cannot allocate shm memory for table info\n");
+	return 0;
+}
+
+
+/*
+ * Collects the nodes whose prefix covers the address, from the shortest
+ * to the longest prefix; returns their number
+ */
+static inline int subnet_tree_lookup(struct subnet_table *table,
+		struct ip_addr *ip, struct subnet_node **stack)
+{
+	struct subnet_node *node;
+	unsigned int maxbits = ip->len * 8;
+	int n = 0;
+
+	for (node = *subnet_tree(table, ip->af); node;
+	node = SUBNET_BIT(ip->u.addr, node->bitlen) ? node->r : node->l) {
+		/* all the nodes below share the prefix of this one */
+		if (!subnet_prefix_match(node->net.ip.u.addr, ip->u.addr,node->bitlen))
+			break;
+
+		if (node->entries)
+			stack[n++] = node;
+
+		if (node->bitlen >= maxbits)
+			break;
+	}
+
+	return n;
+}
+
+
+static void free_subnet_nodes(struct subnet_node *node)
+{
+	struct subnet *entry;
+
+	if (!node)
+		return;
+
+	free_subnet_nodes(node->l);
+	free_subnet_nodes(node->r);
+
+	while (node->entries) {
+		entry = node->entries;
+		node->entries = entry->next;
+		shm_free(entry);
+	}
+
+	shm_free(node);
+}
+
+
+static int subnet_table_has_group(struct subnet_table *table,
+		unsigned int grp)
+{
+	int l = 0, r = table->groups_no - 1, m;
+
+	while (l <= r) {
+		m = (l + r) / 2;
+		if (table->groups[m] == grp)
+			return 1;
+		if (table->groups[m] < grp)
+			l = m + 1;
+		else
+			r = m - 1;
+	}
+
+	return 0;
+}
+
+
+static int subnet_table_add_group(struct subnet_table *table,
+		unsigned int grp)
+{
+	unsigned int *groups;
+	int i;
+
+	if (subnet_table_has_group(table, grp))
+		return 0;
+
+	if (table->groups_no == table->groups_size) {
+		groups = (unsigned int *)shm_realloc(table->groups,
+			(table->groups_size ? 2 * table->groups_size : 8) * sizeof *groups);
+		if (!groups) {
+			LM_ERR("no shm memory for subnet groups\n");
 			return -1;
 		}
-		memcpy(table[i + 1].info, info->s, info->len);
-		table[i + 1].info[info->len] = 0;
+		table->groups = groups;
+		table->groups_size = table->groups_size ? 2 * table->groups_size : 8;
+	}
+
+	for (i = table->groups_no; i > 0 && table->groups[i - 1] > grp; i--)
+		table->groups[i] = table->groups[i - 1];
+	table->groups[i] = grp;
+	table->groups_no++;
+
+	return 0;
+}
+
+
+/*
+ * Create and initialize a subnet table
+ */
+struct subnet_table* new_subnet_table(void)
+{
+	struct subnet_table* ptr;
+
+	ptr = (struct subnet_table *)shm_malloc(sizeof *ptr);
+	if (!ptr) {
+		LM_ERR("no shm memory for subnet table\n");
+		return 0;
+	}
+
+	memset(ptr, 0, sizeof *ptr);
+	return ptr;
+}
+
+
+/*
+ * Add <grp, subnet, mask, port> into the subnet tree of the given table;
+ * the entries of the same subnet are kept ordered according to grp.
+ */
+int subnet_table_insert(struct subnet_table* table, unsigned int grp,
+			struct net *subnet,
+			unsigned int port, int proto, str* pattern, str *info)
+{
+	struct subnet *entry;
+	char *p;
+
+	if (!subnet) {
+		LM_ERR("no subnet to insert\n");
+		return -1;
 	}
-	else
-		table[i + 1].info = NULL;
 
+	entry = (struct subnet *)shm_malloc(sizeof *entry +
+		(pattern->len ? pattern->len + 1 : 0) + (info->len ? info->len + 1 : 0));
+	if (!entry) {
+		LM_ERR("cannot allocate shm memory for subnet\n");
+		return -1;
+	}
+	memset(entry, 0, sizeof *entry);
+
+	entry->grp = grp;
+	entry->port = port;
+	entry->proto = proto;
+
+	p = (char *)(entry + 1);
 	if (pattern->len) {
-		table[i + 1].pattern = (char*) shm_malloc(pattern->len + 1);
-		if (!table[i + 1].pattern) {
-			LM_ERR("cannot allocate shm memory for table pattern\n");
-			return -1;
-		}
-		memcpy(table[i + 1].pattern, pattern->s, pattern->len);
-		table[i + 1].pattern[ pattern->len ] = 0;
+		entry->pattern = p;
+		memcpy(p, pattern->s, pattern->len);
+		p[pattern->len] = 0;
+		p += pattern->len + 1;
 	}
-	else
-		table[i + 1].pattern = NULL;
 
+	if (info->len) {
+		entry->info = p;
+		memcpy(p, info->s, info->len);
+		p[info->len] = 0;
+	}
 
-    table[PERM_MAX_SUBNETS].grp = count + 1;
+	if (subnet_table_add_group(table, grp) < 0 ||
+	subnet_tree_insert(subnet_tree(table, subnet->ip.af), &subnet->ip,
+	subnet_mask_len(subnet), entry) < 0) {
+		LM_ERR("failed to add subnet to the table\n");
+		shm_free(entry);
+		return -1;
+	}
 
-    return 1;
+	table->count++;
+
+	return 1;
 }
 
 
 /*
  * Check if an entry exists in subnet table that matches given group, ip_addr,
- * and port.  Port 0 in subnet table matches any port.
+ * and port.  Port 0 in subnet table matches any port. The longest matching
+ * subnet wins.
  */
-int match_subnet_table(struct sip_msg *msg, struct subnet* table,
+int match_subnet_table(struct sip_msg *msg, struct subnet_table* table,
 			unsigned int grp, struct ip_addr *ip, unsigned int port, int proto,
 			char *pattern, pv_spec_t *info)
 {
-        unsigned int count, i;
+	struct subnet_node *stack[SUBNET_MAX_DEPTH];
+	struct subnet *e;
 	pv_value_t pvt;
-	int match_res, found_group = 0;
-
-	count = table[PERM_MAX_SUBNETS].grp;
+	int n;
 
-	if (count == 0) {
+	if (table->count == 0) {
 		LM_DBG("subnet table is empty\n");
 		return -2;
 	}
 
-	if (grp != GROUP_ANY) {
-		for (i = 0; i < count; i++) {
-			if (table[i].grp == grp) {
-				found_group = 1;
-				break;
-			} else if (table[i].grp > grp) {
-				break;
-			}
-		}
-
-		if (!found_group) {
-			LM_DBG("specified group %u does not exist in hash table\n", grp);
-			return -2;
-		}
+	if (grp != GROUP_ANY && !subnet_table_has_group(table, grp)) {
+		LM_DBG("specified group %u does not exist in hash table\n", grp);
+		return -2;
 	}
 
-	i = 0;
-	do {
-		if ((table[i].grp == grp || table[i].grp == GROUP_ANY
-				|| grp == GROUP_ANY) &&
-			(table[i].port == port || table[i].port == PORT_ANY
-				|| port == PORT_ANY) &&
-			(table[i].proto == proto || table[i].proto == PROTO_NONE
-			 	|| proto == PROTO_NONE))
-			{
+	n = subnet_tree_lookup(table, ip, stack);
 
-				match_res = matchnet(ip, table[i].subnet);
-
-				if (match_res != 1) {
-					i++;
-					continue;
-				}
+	/* longest prefix first */
+	while (n-- > 0) {
+		for (e = stack[n]->entries; e; e = e->next) {
+			if (grp != GROUP_ANY && e->grp != grp && e->grp != GROUP_ANY) {
+				if (e->grp > grp)
+					break;
+				continue;
+			}
 
-				if (table[i].pattern && pattern) {
-					match_res = fnmatch(table[i].pattern, pattern, FNM_PERIOD);
+			if ((e->port != port && e->port != PORT_ANY && port != PORT_ANY) ||
+			(e->proto != proto && e->proto != PROTO_NONE && proto != PROTO_NONE))
+				continue;
 
-					if (match_res) {
-						i++;
-						continue;
-					}
-				}
+			if (e->pattern && pattern &&
+			fnmatch(e->pattern, pattern, FNM_PERIOD))
+				continue;
 
-				if (info) {
-					pvt.flags = PV_VAL_STR;
-					pvt.rs.s = table[i].info;
-					pvt.rs.len = table[i].info ? strlen(table[i].info) : 0;
+			if (info) {
+				pvt.flags = PV_VAL_STR;
+				pvt.rs.s = e->info;
+				pvt.rs.len = e->info ? strlen(e->info) : 0;
 
-					if (pv_set_value(msg, info, (int)EQ_T, &pvt) < 0) {
-						LM_ERR("setting of avp failed\n");
-						return -1;
-	    			}
+				if (pv_set_value(msg, info, (int)EQ_T, &pvt) < 0) {
+					LM_ERR("setting of avp failed\n");
+					return -1;
 				}
-
-				LM_DBG("match found in the subnet table\n");
-				return 1;
 			}
 
-		if (table[i].grp > grp && grp != GROUP_ANY)
-			break;
-		i++;
-
-	} while (i < count);
+			LM_DBG("match found in the subnet table\n");
+			return 1;
+		}
+	}
 
 	LM_DBG("no match in the subnet table\n");
-    return -1;
+	return -1;
 }
 
 
-/*
- * Print subnets stored in subnet table
- */
-int subnet_table_mi_print(struct subnet* table, mi_item_t *part_item,
-		struct pm_part_struct *pm)
+static int subnet_node_mi_print(struct subnet_node *node, mi_item_t *dests_arr)
 {
-    unsigned int count, i;
 	char *p, *ip, *mask, prbuf[PROTO_NAME_MAX_SIZE];
 	int len;
 	static char ip_buff[IP_ADDR_MAX_STR_SIZE];
-	mi_item_t *dests_arr, *dest_item;
+	mi_item_t *dest_item;
+	struct subnet *e;
 
-	count = table[PERM_MAX_SUBNETS].grp;
+	if (!node)
+		return 0;
 
-	dests_arr = add_mi_array(part_item, MI_SSTR("Destinations"));
-	if (!dests_arr)
+	if (subnet_node_mi_print(node->l, dests_arr) < 0)
 		return -1;
 
-	for (i = 0; i < count; i++) {
+	for (e = node->entries; e; e = e->next) {
 		dest_item = add_mi_object(dests_arr, NULL, 0);
 		if (!dest_item)
 			return -1;
 
-		ip = ip_addr2a(&table[i].subnet->ip);
+		ip = ip_addr2a(&node->net.ip);
 		if (!ip) {
 			LM_ERR("cannot print ip address\n");
 			continue;
 		}
 		strcpy(ip_buff, ip);
-		mask = ip_addr2a(&table[i].subnet->mask);
+		mask = ip_addr2a(&node->net.mask);
 		if (!mask) {
 			LM_ERR("cannot print mask address\n");
 			continue;
 		}
 
-		if (add_mi_number(dest_item, MI_SSTR("grp"), table[i].grp) < 0)
+		if (add_mi_number(dest_item, MI_SSTR("grp"), e->grp) < 0)
 			return -1;
 
 		if (add_mi_string(dest_item, MI_SSTR("ip"), ip_buff, strlen(ip_buff)) < 0)
@@ -547,14 +816,14 @@ int subnet_table_mi_print(struct subnet* table, mi_item_t *part_item,
 		if (add_mi_string(dest_item, MI_SSTR("mask"), mask, strlen(mask)) < 0)
 			return -1;
 
-		if (add_mi_number(dest_item, MI_SSTR("port"), table[i].port) < 0)
+		if (add_mi_number(dest_item, MI_SSTR("port"), e->port) < 0)
 			return -1;
 
-		if (table[i].proto == PROTO_NONE) {
+		if (e->proto == PROTO_NONE) {
 			p = "any";
 			len = 3;
 		} else {
-			p = proto2str(table[i].proto, prbuf);
+			p = proto2str(e->proto, prbuf);
 			len = p - prbuf;
 			p = prbuf;
 		}
@@ -562,15 +831,33 @@ int subnet_table_mi_print(struct subnet* table, mi_item_t *part_item,
 			return -1;
 
 		if (add_mi_string(dest_item, MI_SSTR("pattern"),
-			table[i].pattern,
-		    table[i].pattern ? strlen(table[i].pattern) : 0) < 0)
-		    return -1;
+			e->pattern, e->pattern ? strlen(e->pattern) : 0) < 0)
+			return -1;
 
 		if (add_mi_string(dest_item, MI_SSTR("context_info"),
-			table[i].info,
-		    table[i].info ? strlen(table[i].info) : 0) < 0)
-		    return -1;
-    }
+			e->info, e->info ? strlen(e->info) : 0) < 0)
+			return -1;
+	}
+
+	return subnet_node_mi_print(node->r, dests_arr);
+}
+
+
+/*
+ * Print subnets stored in subnet table
+ */
+int subnet_table_mi_print(struct subnet_table* table, mi_item_t *part_item,
+		struct pm_part_struct *pm)
+{
+	mi_item_t *dests_arr;
+
+	dests_arr = add_mi_array(part_item, MI_SSTR("Destinations"));
+	if (!dests_arr)
+		return -1;
+
+	if (subnet_node_mi_print(table->root[0], dests_arr) < 0 ||
+	subnet_node_mi_print(table->root[1], dests_arr) < 0)
+		return -1;
 
 	return 0;
 }
@@ -579,26 +866,21 @@ int subnet_table_mi_print(struct subnet* table, mi_item_t *part_item,
 /*
  * Check if an entry exists in subnet table that matches given ip_addr,
  * and port.  Port 0 in subnet table matches any port.  Return group of
- * first match or -1 if no match is found.
+ * the longest match or -1 if no match is found.
  */
-int find_group_in_subnet_table(struct subnet* table,
+int find_group_in_subnet_table(struct subnet_table* table,
 		                   struct ip_addr *ip, unsigned int port)
 {
-	unsigned int count, i, match_res;
-
-	count = table[PERM_MAX_SUBNETS].grp;
+	struct subnet_node *stack[SUBNET_MAX_DEPTH];
+	struct subnet *e;
+	int n;
 
-	i = 0;
-	while (i < count) {
-		if	(table[i].port == port || table[i].port == 0) {
-			match_res = matchnet(ip, table[i].subnet);
+	n = subnet_tree_lookup(table, ip, stack);
 
-			if (match_res == 1)
-		        return table[i].grp;
-
-		}
-	    i++;
-	}
+	while (n-- > 0)
+		for (e = stack[n]->entries; e; e = e->next)
+			if (e->port == port || e->port == 0)
+				return e->grp;
 
 	return -1;
 }
@@ -607,39 +889,30 @@ int find_group_in_subnet_table(struct subnet* table,
 /*
  * Empty contents of subnet table
  */
-void empty_subnet_table(struct subnet *table)
+void empty_subnet_table(struct subnet_table *table)
 {
-	int count, i;
-
 	if (!table)
 		return;
 
-	count = table[PERM_MAX_SUBNETS].grp;
+	free_subnet_nodes(table->root[0]);
+	free_subnet_nodes(table->root[1]);
+	table->root[0] = table->root[1] = NULL;
 
-	for (i = 0; i < count; i++) {
-		if (table[i].info)
-			shm_free(table[i].info);
-		if (table[i].pattern)
-			shm_free(table[i].pattern);
-		if (table[i].subnet)
-			shm_free(table[i].subnet);
-	}
-
-	table[PERM_MAX_SUBNETS].grp = 0;
+	table->groups_no = 0;
+	table->count = 0;
 }
 
 
 /*
  * Release memory allocated for a subnet table
  */
-void free_subnet_table(struct subnet* table)
+void free_subnet_table(struct subnet_table* table)
 {
 	empty_subnet_table(table);
 
-	if (table)
-	    shm_free(table);
+	if (table) {
+		if (table->groups)
+			shm_free(table->groups);
+		shm_free(table);
+	}
 }
-
-
-
-
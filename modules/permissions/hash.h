@@ -102,32 +102,55 @@ int find_group_in_hash_table(struct address_list** table,
 
 
 
-#define PERM_MAX_SUBNETS 128
-
 /*
- * Structure used to store a subnet
+ * Structure used to store a subnet entry; all the entries of the same
+ * subnet hang off the same node of the subnet tree
  */
 struct subnet {
-	unsigned int grp;        /* address group, subnet count in last record */
-	struct net *subnet;		 /* IP subnet + mask */
+	unsigned int grp;        /* address group */
 	int proto;                  /* Protocol -- UDP, TCP, TLS, or SCTP */
 	char *pattern;              /* Pattern matching From header field */
 	unsigned int port;       /* port or 0 */
 	char *info;				 /* extra information */
+	struct subnet_node *node;   /* the node holding the IP subnet + mask */
+	struct subnet *next;        /* next entry of the subnet, ordered by grp */
+};
+
+/*
+ * Node of a binary radix (Patricia) tree of subnets
+ */
+struct subnet_node {
+	struct net net;             /* prefix (masked IP) + mask */
+	unsigned int bitlen;        /* prefix length */
+	struct subnet *entries;     /* NULL for the branching-only nodes */
+	struct subnet_node *parent;
+	struct subnet_node *l;      /* next bit is 0 */
+	struct subnet_node *r;      /* next bit is 1 */
+};
+
+/*
+ * Subnet table: longest-prefix-match trees for IPv4 and IPv6
+ */
+struct subnet_table {
+	struct subnet_node *root[2]; /* IPv4 and IPv6 trees */
+	unsigned int *groups;        /* groups having subnets, sorted */
+	unsigned int groups_no;
+	unsigned int groups_size;
+	unsigned int count;          /* number of subnet entries */
 };
 
 
 /*
  * Create a subnet table
  */
-struct subnet* new_subnet_table(void);
+struct subnet_table* new_subnet_table(void);
 
 
 /*
  * Check if an entry exists in subnet table that matches given group, ip_addr,
  * and port.  Port 0 in subnet table matches any port.
  */
-int match_subnet_table(struct sip_msg *msg, struct subnet* table,
+int match_subnet_table(struct sip_msg *msg, struct subnet_table* table,
 		unsigned int group, struct ip_addr *ip, unsigned int port, int proto,
 		char *pattern, pv_spec_t* info);
 
@@ -135,29 +158,29 @@ int match_subnet_table(struct sip_msg *msg, struct subnet* table,
 /*
  * Checks if an entry exists in subnet table that matches given ip_addr,
  * and port.  Port 0 in subnet table matches any port.  Returns group of
- * the first match or -1 if no match is found.
+ * the longest match or -1 if no match is found.
  */
-int find_group_in_subnet_table(struct subnet* table,
+int find_group_in_subnet_table(struct subnet_table* table,
 		struct ip_addr *ip, unsigned int port);
 
 /*
  * Empty contents of subnet table
  */
-void empty_subnet_table(struct subnet *table);
+void empty_subnet_table(struct subnet_table *table);
 
 
 /*
  * Release memory allocated for a subnet table
  */
-void free_subnet_table(struct subnet* table);
+void free_subnet_table(struct subnet_table* table);
 
 
 
 /*
- * Add <grp, subnet, mask, port> into subnet table so that table is
- * kept ordered according to subnet, port, grp.
+ * Add <grp, subnet, mask, port> into subnet table; the entries of the same
+ * subnet are kept ordered according to grp.
  */
-int subnet_table_insert(struct subnet* table, unsigned int grp,
+int subnet_table_insert(struct subnet_table* table, unsigned int grp,
 		struct net *subnet, unsigned int port, int proto,
 		str* pattern, str *info);
 
@@ -165,8 +188,7 @@ int subnet_table_insert(struct subnet* table, unsigned int grp,
 /*
  * Print subnets stored in subnet table
  */
-/*void subnet_table_print(struct subnet* table, FILE* reply_file);*/
-int subnet_table_mi_print(struct subnet* table, mi_item_t *part_item,
+int subnet_table_mi_print(struct subnet_table* table, mi_item_t *part_item,
 		struct pm_part_struct *pm);
 
 
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include <tap.h>
+
+#include "../../../dprint.h"
+#include "../../../ut.h"
+#include "../../../ip_addr.h"
+#include "../../../mem/mem.h"
+
+#include "../hash.h"
+
+#define BENCH_SUBNETS      100000
+#define BENCH_V6_SUBNETS   20000
+#define BENCH_GROUPS       50
+#define BENCH_LOOKUPS      100000
+#define BENCH_LIN_LOOKUPS  2000
+
+struct bench_subnet {
+	struct net *net;
+	unsigned int grp;
+	unsigned int port;
+};
+
+static struct bench_subnet subnets[BENCH_SUBNETS];
+static struct ip_addr ips[BENCH_LOOKUPS];
+
+
+static void rand_ip(struct ip_addr *ip, int v6)
+{
+	int i;
+
+	memset(ip, 0, sizeof *ip);
+	ip->af = v6 ? AF_INET6 : AF_INET;
+	ip->len = v6 ? 16 : 4;
+
+	/* keep the space dense enough to get overlapping subnets */
+	ip->u.addr[0] = v6 ? 0x20 : 10 + rand() % 4;
+	ip->u.addr[1] = v6 ? 0x01 : rand() % 8;
+	for (i = 2; i < ip->len; i++)
+		ip->u.addr[i] = (v6 && i < 4) ? rand() % 4 : rand();
+}
+
+
+/* the reference: longest matching subnet, then lowest group */
+static int linear_find_group(struct ip_addr *ip, unsigned int port)
+{
+	int i, grp = -1, best = -1, bitlen;
+
+	for (i = 0; i < BENCH_SUBNETS; i++) {
+		if ((subnets[i].port != port && subnets[i].port != 0) ||
+		matchnet(ip, subnets[i].net) != 1)
+			continue;
+
+		for (bitlen = 0; bitlen < subnets[i].net->mask.len * 8 &&
+			(subnets[i].net->mask.u.addr[bitlen >> 3] & (0x80 >> (bitlen & 0x07))); bitlen++);
+
+		if (bitlen > best || (bitlen == best && subnets[i].grp < grp)) {
+			best = bitlen;
+			grp = subnets[i].grp;
+		}
+	}
+
+	return grp;
+}
+
+
+static int linear_match(struct ip_addr *ip, unsigned int grp)
+{
+	int i;
+
+	for (i = 0; i < BENCH_SUBNETS; i++)
+		if ((subnets[i].grp == grp || subnets[i].grp == GROUP_ANY) &&
+		matchnet(ip, subnets[i].net) == 1)
+			return 1;
+
+	return -1;
+}
+
+
+static void test_subnet_tree(void)
+{
+	static str empty = STR_NULL;
+	struct subnet_table *table;
+	struct ip_addr ip;
+	struct timeval start;
+	long tree_us, lin_us;
+	int i, v6, inserted = 0, matched = 0, mismatches = 0, grp;
+
+	srand(7);
+
+	table = new_subnet_table();
+	if (!ok(table != NULL, "create subnet table"))
+		return;
+
+	for (i = 0; i < BENCH_SUBNETS; i++) {
+		v6 = i < BENCH_V6_SUBNETS;
+		rand_ip(&ip, v6);
+
+		subnets[i].net = mk_net_bitlen(&ip,
+			v6 ? 24 + rand() % 41 : 12 + rand() % 19);
+		subnets[i].grp = rand() % BENCH_GROUPS;
+		subnets[i].port = (i % 10) ? 0 : 5060;
+
+		if (subnets[i].net && subnet_table_insert(table, subnets[i].grp,
+				subnets[i].net, subnets[i].port, PROTO_NONE, &empty, &empty) == 1)
+			inserted++;
+	}
+
+	ok(inserted == BENCH_SUBNETS, "insert %d subnets", BENCH_SUBNETS);
+	ok(table->count == BENCH_SUBNETS, "subnet count");
+
+	for (i = 0; i < BENCH_LOOKUPS; i++)
+		rand_ip(&ips[i], i % 5 == 0);
+
+	/* the tree picks the same group as an exhaustive search */
+	for (i = 0; i < BENCH_LIN_LOOKUPS; i++) {
+		grp = find_group_in_subnet_table(table, &ips[i], 5060);
+		if (grp != -1)
+			matched++;
+		if (grp != linear_find_group(&ips[i], 5060)) {
+			mismatches++;
+			diag("%s: tree group %d, linear group %d", ip_addr2a(&ips[i]),
+				grp, linear_find_group(&ips[i], 5060));
+		}
+
+		if (match_subnet_table(NULL, table, i % BENCH_GROUPS, &ips[i],
+				PORT_ANY, PROTO_NONE, NULL, NULL) != linear_match(&ips[i],
+				i % BENCH_GROUPS))
+			mismatches++;
+	}
+
+	ok(matched > 0, "lookups matched");
+	ok(mismatches == 0, "longest prefix matching");
+
+	ok(match_subnet_table(NULL, table, BENCH_GROUPS + 1, &ips[0], PORT_ANY,
+		PROTO_NONE, NULL, NULL) == -2, "unknown group");
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < BENCH_LIN_LOOKUPS; i++)
+		linear_match(&ips[i], i % BENCH_GROUPS);
+	lin_us = get_time_diff(&start);
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < BENCH_LOOKUPS; i++)
+		match_subnet_table(NULL, table, i % BENCH_GROUPS, &ips[i], PORT_ANY,
+			PROTO_NONE, NULL, NULL);
+	tree_us = get_time_diff(&start);
+
+	diag("%d subnets (%d IPv6): linear %.2fus/lookup, tree %.2fus/lookup",
+		BENCH_SUBNETS, BENCH_V6_SUBNETS, (double)lin_us / BENCH_LIN_LOOKUPS,
+		(double)tree_us / BENCH_LOOKUPS);
+
+	empty_subnet_table(table);
+	ok(table->count == 0 && !table->root[0] && !table->root[1],
+		"empty subnet table");
+	ok(match_subnet_table(NULL, table, GROUP_ANY, &ips[0], PORT_ANY,
+		PROTO_NONE, NULL, NULL) == -2, "lookup in empty table");
+
+	free_subnet_table(table);
+
+	for (i = 0; i < BENCH_SUBNETS; i++)
+		if (subnets[i].net)
+			pkg_free(subnets[i].net);
+}
+
+
+void mod_tests(void)
+{
+	test_subnet_tree();
+}
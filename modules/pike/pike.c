@@ -49,6 +49,7 @@
 #include "timer.h"
 #include "pike_mi.h"
 #include "pike_funcs.h"
+#include "pike_sketch.h"
 
 
 
@@ -63,6 +64,7 @@ static int pike_exit(void);
 static int time_unit = 2;
 static int max_reqs  = 30;
 static char *pike_route_s = NULL;
+static char *engine_s = "tree";
 int timeout   = 120;
 int pike_log_level = L_WARN;
 
@@ -86,6 +88,11 @@ static param_export_t params[]={
 	{"remove_latency",        INT_PARAM,  &timeout},
 	{"pike_log_level",        INT_PARAM,  &pike_log_level},
 	{"check_route",           STR_PARAM,  &pike_route_s},
+	{"engine",                STR_PARAM,  &engine_s},
+	{"sketch_width",          INT_PARAM,  &sketch_width},
+	{"sketch_offenders",      INT_PARAM,  &sketch_offenders},
+	{"ipv4_prefixes",         STR_PARAM,  &ipv4_prefixes_s},
+	{"ipv6_prefixes",         STR_PARAM,  &ipv6_prefixes_s},
 	{0,0,0}
 };
 
@@ -141,6 +148,24 @@ static int pike_init(void)
 		LM_NOTICE("Forcing remove_latency to %ds\n", timeout);
 	}
 
+	if (!strcasecmp(engine_s, "sketch")) {
+		use_sketch = 1;
+	} else if (strcasecmp(engine_s, "tree")) {
+		LM_ERR("unknown engine <%s>\n", engine_s);
+		return -1;
+	}
+
+	if (use_sketch) {
+		if (init_pike_sketch(max_reqs, time_unit) != 0) {
+			LM_ERR("sketch creation failed!\n");
+			return -1;
+		}
+
+		register_timer( "pike-sketch", sketch_timer, 0, time_unit,
+			TIMER_FLAG_DELAY_ON_DELAY );
+		goto route;
+	}
+
 	/* alloc the timer lock */
 	timer_lock=lock_alloc();
 	if (timer_lock==0) {
@@ -173,6 +198,7 @@ static int pike_init(void)
 	register_timer( "pike-swap", swap_routine , 0, time_unit,
 		TIMER_FLAG_DELAY_ON_DELAY );
 
+route:
 	if (pike_route_s && *pike_route_s) {
 		rt = get_script_route_ID_by_name(pike_route_s,sroutes->request,RT_NO);
 		if (rt<1) {
@@ -222,6 +248,8 @@ static int pike_exit(void)
 	/* destroy the IP tree */
 	destroy_ip_tree();
 
+	destroy_pike_sketch();
+
 	return 0;
 }
 
@@ -47,6 +47,7 @@
 #include "../../script_cb.h"
 #include "ip_tree.h"
 #include "pike_funcs.h"
+#include "pike_sketch.h"
 #include "timer.h"
 
 
@@ -96,6 +97,8 @@ int pike_check_req(struct sip_msg *msg)
 	struct ip_node *father;
 	unsigned char flags;
 	struct ip_addr* ip;
+	char *prefix;
+	int ret;
 
 
 #ifdef _test
@@ -112,6 +115,15 @@ int pike_check_req(struct sip_msg *msg)
 	ip = &(msg->rcv.src_ip);
 #endif
 
+	if (use_sketch) {
+		ret = sketch_check_ip(ip, &prefix);
+		if (ret == -2) {
+			LM_GEN1( pike_log_level, "PIKE - BLOCKing %s (ip %s)\n",
+				prefix, ip_addr2a(ip));
+			pike_raise_event(ip_addr2a(ip));
+		}
+		return ret;
+	}
 
 	/* first lock the proper tree branch and mark the IP with one more hit*/
 	lock_tree_branch( ip->u.addr[0] );
@@ -30,6 +30,7 @@
 
 #include "ip_tree.h"
 #include "pike_mi.h"
+#include "pike_sketch.h"
 
 #define IPv6_LEN 16
 #define IPv4_LEN 4
@@ -110,6 +111,17 @@ mi_response_t *mi_pike_rm(const mi_params_t *params,
     if (get_mi_string_param(params, "ip", &ip_param.s, &ip_param.len) < 0)
 		return init_mi_param_error();
 
+    if (use_sketch) {
+	switch (sketch_mi_rm(&ip_param)) {
+	case 0:
+	    return init_mi_result_ok();
+	case -1:
+	    return init_mi_error(404, MI_SSTR("Match not found"));
+	default:
+	    return init_mi_error(500, MI_SSTR("Bad IP"));
+	}
+    }
+
     ip = str2ip(&ip_param);
     if (ip==0)
 	return init_mi_error(500, MI_SSTR("Bad IP"));
@@ -177,6 +189,12 @@ mi_response_t *mi_pike_list(const mi_params_t *params,
 	if (!ips_arr)
 		goto error;
 
+	if (use_sketch) {
+		if (sketch_mi_list(ips_arr) < 0)
+			goto error;
+		return resp;
+	}
+
 	for( i=0 ; i<MAX_IP_BRANCHES ; i++ ) {
 
 		if (get_tree_branch(i)==0)
@@ -0,0 +1,515 @@
+/*
+ * PIKE module - decayed count-min sketch detection engine
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../mem/shm_mem.h"
+#include "../../locking.h"
+#include "../../dprint.h"
+#include "../../ut.h"
+#include "pike_sketch.h"
+
+extern int pike_log_level;
+
+/* a counter word: the time (msecs) of its last update and its decayed
+ * value, as fixed point */
+#define CNT_VAL_BITS    24
+#define CNT_VAL_MASK    ((1ULL << CNT_VAL_BITS) - 1)
+#define CNT_FIX         16
+#define CNT_TIME(_c)    ((_c) >> CNT_VAL_BITS)
+#define CNT_VAL(_c)     ((_c) & CNT_VAL_MASK)
+
+/* the values halve each sampling_time_unit, so a constant rate of N
+ * requests per unit sums up to N/ln(2) */
+#define DENSITY2VAL(_d) \
+	((unsigned long long)(_d) * CNT_FIX * 14427 / 10000)
+
+/* 2^(-i/16), scaled by 2^16 */
+static const unsigned int decay_frac[16] = {65536, 62757, 60097, 57549,
+	55109, 52773, 50535, 48393, 46341, 44376, 42495, 40693, 38968, 37316,
+	35734, 34219};
+
+#define MAX_PREFIXES    4
+#define OFFENDER_PROBES 8
+
+struct pike_prefix {
+	unsigned char len;
+	unsigned long long threshold;
+};
+
+struct pike_key {
+	unsigned char af;
+	unsigned char plen;
+	unsigned char addr[16];
+};
+
+struct pike_offender {
+	struct pike_key key;
+	unsigned long long value;
+	unsigned long long threshold;
+};
+
+struct pike_sketch {
+	gen_lock_t lock;
+	struct pike_offender *offenders;
+	volatile unsigned long long counters[0];
+};
+
+int use_sketch = 0;
+int sketch_width = 1 << 16;
+int sketch_offenders = 1024;
+char *ipv4_prefixes_s = "32";
+char *ipv6_prefixes_s = "64";
+
+static struct pike_sketch *sketch;
+static unsigned long long half_life;
+static struct timespec sketch_start;
+
+static struct pike_prefix v4_prefixes[MAX_PREFIXES], v6_prefixes[MAX_PREFIXES];
+static int v4_prefixes_no, v6_prefixes_no;
+
+/* "len[:factor], ..." - the factor multiplies the allowed density */
+static int parse_prefixes(char *s, int max_len, int max_reqs,
+		struct pike_prefix *prefixes)
+{
+	char *end;
+	long len, factor;
+	int n = 0;
+
+	while (*s) {
+		if (n == MAX_PREFIXES) {
+			LM_ERR("more than %d prefixes in <%s>\n", MAX_PREFIXES, s);
+			return -1;
+		}
+
+		len = strtol(s, &end, 10);
+		if (end == s || len < 1 || len > max_len) {
+			LM_ERR("bad prefix length in <%s>\n", s);
+			return -1;
+		}
+		s = end;
+
+		factor = 1;
+		if (*s == ':') {
+			factor = strtol(s + 1, &end, 10);
+			if (end == s + 1 || factor < 1) {
+				LM_ERR("bad density factor in <%s>\n", s);
+				return -1;
+			}
+			s = end;
+		}
+
+		while (*s == ' ')
+			s++;
+		if (*s == ',')
+			s++;
+		else if (*s) {
+			LM_ERR("unexpected <%s> in prefixes\n", s);
+			return -1;
+		}
+		while (*s == ' ')
+			s++;
+
+		prefixes[n].len = len;
+		prefixes[n].threshold = DENSITY2VAL(max_reqs * factor);
+		n++;
+	}
+
+	return n;
+}
+
+int init_pike_sketch(int max_reqs, int time_unit)
+{
+	int width;
+
+	if ((v4_prefixes_no = parse_prefixes(ipv4_prefixes_s, 32, max_reqs,
+			v4_prefixes)) < 0 ||
+		(v6_prefixes_no = parse_prefixes(ipv6_prefixes_s, 128, max_reqs,
+			v6_prefixes)) < 0)
+		return -1;
+
+	/* round up to a power of 2 */
+	for (width = 1; width < sketch_width; width <<= 1);
+	sketch_width = width;
+	if (sketch_offenders < OFFENDER_PROBES)
+		sketch_offenders = OFFENDER_PROBES;
+
+	sketch = shm_malloc(sizeof *sketch +
+		SKETCH_DEPTH * sketch_width * sizeof *sketch->counters);
+	if (!sketch) {
+		LM_ERR("no more shm mem for a %dx%d sketch\n",
+			SKETCH_DEPTH, sketch_width);
+		return -1;
+	}
+	memset(sketch, 0, sizeof *sketch +
+		SKETCH_DEPTH * sketch_width * sizeof *sketch->counters);
+
+	sketch->offenders = shm_malloc(sketch_offenders *
+		sizeof *sketch->offenders);
+	if (!sketch->offenders) {
+		LM_ERR("no more shm mem\n");
+		goto error;
+	}
+	memset(sketch->offenders, 0, sketch_offenders *
+		sizeof *sketch->offenders);
+
+	if (!lock_init(&sketch->lock)) {
+		LM_ERR("failed to init lock\n");
+		goto error;
+	}
+
+	half_life = time_unit * 1000;
+	clock_gettime(CLOCK_MONOTONIC, &sketch_start);
+
+	LM_DBG("%dx%d sketch, %d IPv4 and %d IPv6 prefixes\n", SKETCH_DEPTH,
+		sketch_width, v4_prefixes_no, v6_prefixes_no);
+
+	return 0;
+
+error:
+	if (sketch->offenders)
+		shm_free(sketch->offenders);
+	shm_free(sketch);
+	sketch = NULL;
+	return -1;
+}
+
+void destroy_pike_sketch(void)
+{
+	if (!sketch)
+		return;
+
+	lock_destroy(&sketch->lock);
+	shm_free(sketch->offenders);
+	shm_free(sketch);
+	sketch = NULL;
+}
+
+/* msecs since startup, the same in all the processes */
+static inline unsigned long long sketch_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec - sketch_start.tv_sec) * 1000ULL +
+		ts.tv_nsec / 1000000 - sketch_start.tv_nsec / 1000000;
+}
+
+static inline unsigned long long decay(unsigned long long val,
+		unsigned long long age)
+{
+	unsigned long long halves;
+
+	if (!age || !val)
+		return val;
+
+	halves = age / half_life;
+	if (halves >= CNT_VAL_BITS)
+		return 0;
+
+	val >>= halves;
+	return (val * decay_frac[(age % half_life) * 16 / half_life]) >> 16;
+}
+
+static void build_key(struct ip_addr *ip, int plen, struct pike_key *key)
+{
+	int bytes = (plen + 7) / 8;
+
+	memset(key, 0, sizeof *key);
+	key->af = ip->af;
+	key->plen = plen;
+	memcpy(key->addr, ip->u.addr, bytes);
+	if (plen % 8)
+		key->addr[bytes - 1] &= 0xff << (8 - plen % 8);
+}
+
+static inline unsigned long long hash_key(struct pike_key *key)
+{
+	unsigned long long h = 0xcbf29ce484222325ULL;
+	unsigned char *p;
+
+	/* FNV-1a, with a final avalanche */
+	for (p = (unsigned char *)key; p < key->addr + (key->plen + 7) / 8; p++)
+		h = (h ^ *p) * 0x100000001b3ULL;
+
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return h;
+}
+
+#define row_counter(_h, _row) \
+	(&sketch->counters[(_row) * sketch_width + \
+		(((_h) + (_row) * (((_h) >> 32) | 1)) & (sketch_width - 1))])
+
+/* adds "hits" to the counters of the key and returns its estimation */
+static unsigned long long sketch_update(unsigned long long h, int hits,
+		unsigned long long now)
+{
+	volatile unsigned long long *c;
+	unsigned long long old, val, t, est = CNT_VAL_MASK;
+	int row;
+
+	for (row = 0; row < SKETCH_DEPTH; row++) {
+		c = row_counter(h, row);
+
+		do {
+			old = *c;
+			t = CNT_TIME(old);
+			if (t < now) {
+				val = decay(CNT_VAL(old), now - t);
+				t = now;
+			} else {
+				val = CNT_VAL(old);
+			}
+
+			val += hits * CNT_FIX;
+			if (val > CNT_VAL_MASK)
+				val = CNT_VAL_MASK;
+		} while (hits && __sync_val_compare_and_swap(c, old,
+			(t << CNT_VAL_BITS) | val) != old);
+
+		if (val < est)
+			est = val;
+	}
+
+	return est;
+}
+
+static void sketch_clear(unsigned long long h)
+{
+	int row;
+
+	for (row = 0; row < SKETCH_DEPTH; row++)
+		__sync_lock_test_and_set(row_counter(h, row), 0);
+}
+
+static char *print_key(struct pike_key *key)
+{
+	static char buf[IP_ADDR_MAX_STR_SIZE + 4];
+	struct ip_addr ip;
+	char *p;
+	int len;
+
+	memset(&ip, 0, sizeof ip);
+	ip.af = key->af;
+	ip.len = key->af == AF_INET ? 4 : 16;
+	memcpy(ip.u.addr, key->addr, ip.len);
+
+	p = ip_addr2a(&ip);
+	len = strlen(p);
+	memcpy(buf, p, len);
+
+	/* the full addresses are printed as such */
+	if (key->plen == ip.len * 8)
+		buf[len] = '\0';
+	else
+		sprintf(buf + len, "/%d", key->plen);
+
+	return buf;
+}
+
+/* returns -2 if just added to the offenders, -1 if already there */
+static int mark_offender(struct pike_key *key, unsigned long long h,
+		unsigned long long value, unsigned long long threshold)
+{
+	struct pike_offender *o, *free = NULL, *victim = NULL;
+	int i;
+
+	lock_get(&sketch->lock);
+
+	for (i = 0; i < OFFENDER_PROBES; i++) {
+		o = &sketch->offenders[(h + i) % sketch_offenders];
+		if (!o->key.plen) {
+			if (!free)
+				free = o;
+		} else if (!memcmp(&o->key, key, sizeof *key)) {
+			o->value = value;
+			lock_release(&sketch->lock);
+			return -1;
+		} else if (!victim || o->value < victim->value) {
+			victim = o;
+		}
+	}
+
+	/* no room left, forget about the smallest of the neighbours - it is
+	 * reported as blocked again on its next request, if still over */
+	o = free ? free : victim;
+	if (!free)
+		LM_GEN1(pike_log_level, "PIKE - UNBLOCKing %s\n",
+			print_key(&o->key));
+	o->key = *key;
+	o->value = value;
+	o->threshold = threshold;
+
+	lock_release(&sketch->lock);
+	return -2;
+}
+
+int sketch_check_ip(struct ip_addr *ip, char **prefix)
+{
+	struct pike_prefix *prefixes;
+	struct pike_key key;
+	unsigned long long now, h, est;
+	int i, n, ret = 1;
+
+	if (ip->af == AF_INET) {
+		prefixes = v4_prefixes;
+		n = v4_prefixes_no;
+	} else {
+		prefixes = v6_prefixes;
+		n = v6_prefixes_no;
+	}
+
+	now = sketch_now();
+
+	for (i = 0; i < n; i++) {
+		build_key(ip, prefixes[i].len, &key);
+		h = hash_key(&key);
+
+		est = sketch_update(h, 1, now);
+		if (est < prefixes[i].threshold)
+			continue;
+
+		if (mark_offender(&key, h, est, prefixes[i].threshold) == -2) {
+			if (ret != -2)
+				*prefix = print_key(&key);
+			ret = -2;
+		} else if (ret == 1) {
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+/* releases the offenders whose rate dropped below their density */
+void sketch_timer(unsigned int ticks, void *param)
+{
+	struct pike_offender *o;
+	unsigned long long now;
+
+	now = sketch_now();
+
+	lock_get(&sketch->lock);
+
+	for (o = sketch->offenders; o < sketch->offenders + sketch_offenders; o++) {
+		if (!o->key.plen)
+			continue;
+
+		o->value = sketch_update(hash_key(&o->key), 0, now);
+		if (o->value < o->threshold) {
+			LM_GEN1(pike_log_level, "PIKE - UNBLOCKing %s\n",
+				print_key(&o->key));
+			o->key.plen = 0;
+		}
+	}
+
+	lock_release(&sketch->lock);
+}
+
+static int cmp_offenders(const void *a, const void *b)
+{
+	const struct pike_offender *oa = a, *ob = b;
+
+	return oa->value < ob->value ? 1 : (oa->value > ob->value ? -1 : 0);
+}
+
+/* lists the blocked prefixes, the top offenders first */
+int sketch_mi_list(mi_item_t *ips_arr)
+{
+	struct pike_offender *list;
+	int i, n = 0;
+
+	list = pkg_malloc(sketch_offenders * sizeof *list);
+	if (!list) {
+		LM_ERR("no more pkg mem\n");
+		return -1;
+	}
+
+	lock_get(&sketch->lock);
+	for (i = 0; i < sketch_offenders; i++)
+		if (sketch->offenders[i].key.plen)
+			list[n++] = sketch->offenders[i];
+	lock_release(&sketch->lock);
+
+	qsort(list, n, sizeof *list, cmp_offenders);
+
+	for (i = 0; i < n; i++)
+		if (add_mi_string_fmt(ips_arr, 0, 0, "%s", print_key(&list[i].key)) < 0)
+			break;
+
+	pkg_free(list);
+	return i == n ? 0 : -1;
+}
+
+/* unblocks an address or prefix ("ip[/len]"); returns -1 if not found */
+int sketch_mi_rm(str *ip_s)
+{
+	struct pike_offender *o;
+	struct pike_key key;
+	struct ip_addr *ip;
+	str addr = *ip_s;
+	char *p;
+	int plen, ret = -1;
+	unsigned int ui;
+	str len_s;
+
+	p = q_memchr(ip_s->s, '/', ip_s->len);
+	if (p)
+		addr.len = p - ip_s->s;
+
+	ip = str2ip(&addr);
+	if (!ip)
+		ip = str2ip6(&addr);
+	if (!ip)
+		return -2;
+
+	plen = ip->len * 8;
+	if (p) {
+		len_s.s = p + 1;
+		len_s.len = ip_s->s + ip_s->len - len_s.s;
+		if (str2int(&len_s, &ui) < 0 || ui < 1 || ui > plen)
+			return -2;
+		plen = ui;
+	}
+
+	build_key(ip, plen, &key);
+
+	lock_get(&sketch->lock);
+	for (o = sketch->offenders; o < sketch->offenders + sketch_offenders; o++)
+		if (o->key.plen && !memcmp(&o->key, &key, sizeof key)) {
+			o->key.plen = 0;
+			sketch_clear(hash_key(&key));
+			ret = 0;
+			break;
+		}
+	lock_release(&sketch->lock);
+
+	if (ret == 0)
+		LM_GEN1(pike_log_level, "PIKE - UNBLOCKing %s\n", print_key(&key));
+
+	return ret;
+}
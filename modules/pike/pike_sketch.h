@@ -0,0 +1,64 @@
+/*
+ * PIKE module - decayed count-min sketch detection engine
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/*
+ * Instead of a tree node per IP address (byte), the request rates are
+ * estimated with a fixed size count-min sketch of exponentially decayed
+ * counters, updated with compare-and-swap. Each request is accounted for
+ * all the configured prefixes of its source address (i.e. /32 and /24 for
+ * IPv4, /64 and /48 for IPv6), so a flood spread over a whole prefix is
+ * detected as well, without allocating anything per address.
+ *
+ * Only the prefixes exceeding their density are remembered, in a small
+ * fixed size table of offenders, used for the BLOCK/UNBLOCK reporting and
+ * for the MI commands.
+ */
+
+#ifndef _PIKE_SKETCH_H
+#define _PIKE_SKETCH_H
+
+#include "../../ip_addr.h"
+#include "../../mi/mi.h"
+
+#define SKETCH_DEPTH 4
+
+extern int use_sketch;
+extern int sketch_width;
+extern int sketch_offenders;
+extern char *ipv4_prefixes_s;
+extern char *ipv6_prefixes_s;
+
+int init_pike_sketch(int max_reqs, int time_unit);
+void destroy_pike_sketch(void);
+
+/* accounts one more request from the given IP; returns 1 if allowed,
+ * -1 if one of its prefixes is blocked or -2 if just blocked, in which
+ * case "prefix" points to the printed blocked prefix */
+int sketch_check_ip(struct ip_addr *ip, char **prefix);
+
+void sketch_timer(unsigned int ticks, void *param);
+
+int sketch_mi_list(mi_item_t *ips_arr);
+/* returns 0 if unblocked, -1 if not blocked, -2 if not an "ip[/len]" */
+int sketch_mi_rm(str *ip_s);
+
+#endif
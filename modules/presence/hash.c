@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 #include "../../mem/shm_mem.h"
 #include "../../dprint.h"
 #include "../../str.h"
@@ -375,10 +376,15 @@ int update_shtable(shtable_t htable,unsigned int hash_code,
 	s->event= subs->event;
 	subs->db_flag= s->db_flag;
 
-	if(s->db_flag == NO_UPDATEDB_FLAG)
+	if(fallback2db)
+	{
+		/* the SUBSCRIBE triggered changes are written in realtime, the
+		 * NOTIFY triggered ones too, unless written behind on timer */
+		if(type == LOCAL_TYPE)
+			s->db_flag = memory_subs_index ? UPDATEDB_FLAG : NO_UPDATEDB_FLAG;
+	}
+	else if(s->db_flag == NO_UPDATEDB_FLAG)
 		s->db_flag= UPDATEDB_FLAG;
-	if(fallback2db && type == LOCAL_TYPE)
-		s->db_flag = NO_UPDATEDB_FLAG;
 
 	lock_release(&htable[hash_code].lock);
 	return 0;
@@ -794,3 +800,191 @@ int delete_cluster_query(str* pres_uri, int event, unsigned int hash_code)
 }
 
 
+
+
+agg_htable_t* new_agg_htable(void)
+{
+	agg_htable_t* htable;
+	int i;
+
+	htable= (agg_htable_t*)shm_malloc(phtable_size* sizeof(agg_htable_t));
+	if(htable== NULL)
+	{
+		LM_ERR("no more shared memory\n");
+		return NULL;
+	}
+	memset(htable, 0, phtable_size* sizeof(agg_htable_t));
+
+	for(i= 0; i< phtable_size; i++)
+	{
+		if(lock_init(&htable[i].lock)== 0)
+		{
+			LM_ERR("initializing lock [%d]\n", i);
+			while(--i>= 0)
+				lock_destroy(&htable[i].lock);
+			shm_free(htable);
+			return NULL;
+		}
+	}
+
+	return htable;
+}
+
+void destroy_agg_htable(void)
+{
+	agg_entry_t* e;
+	int i;
+
+	if(agg_htable== NULL)
+		return;
+
+	for(i= 0; i< phtable_size; i++)
+	{
+		lock_destroy(&agg_htable[i].lock);
+		while(agg_htable[i].entries)
+		{
+			e= agg_htable[i].entries;
+			agg_htable[i].entries= e->next;
+			shm_free(e);
+		}
+	}
+	shm_free(agg_htable);
+	agg_htable= NULL;
+}
+
+/* returns 1 and a pkg copy of the body (and extra headers) if cached, or
+ * 0 and the version to be used when caching the newly built body */
+int agg_cache_get(str* pres_uri, int event, str* body, str* extra_hdrs,
+		unsigned int* version)
+{
+	unsigned int hash_code;
+	agg_entry_t* e;
+
+	hash_code= core_hash(pres_uri, NULL, phtable_size);
+
+	lock_get(&agg_htable[hash_code].lock);
+
+	for(e= agg_htable[hash_code].entries; e; e= e->next)
+		if(e->event== event && e->pres_uri.len== pres_uri->len &&
+		memcmp(e->pres_uri.s, pres_uri->s, pres_uri->len)== 0)
+			break;
+
+	if(e== NULL || e->valid_until<= (int)time(NULL))
+		goto miss;
+
+	body->s= (char*)pkg_malloc(e->body.len);
+	if(body->s== NULL)
+	{
+		LM_ERR("no more pkg memory\n");
+		goto miss;
+	}
+	memcpy(body->s, e->body.s, e->body.len);
+	body->len= e->body.len;
+
+	if(e->extra_hdrs.len && extra_hdrs && !extra_hdrs->s)
+	{
+		extra_hdrs->s= (char*)pkg_malloc(e->extra_hdrs.len);
+		if(extra_hdrs->s)
+		{
+			memcpy(extra_hdrs->s, e->extra_hdrs.s, e->extra_hdrs.len);
+			extra_hdrs->len= e->extra_hdrs.len;
+		}
+	}
+
+	lock_release(&agg_htable[hash_code].lock);
+	return 1;
+
+miss:
+	*version= agg_htable[hash_code].version;
+	lock_release(&agg_htable[hash_code].lock);
+	return 0;
+}
+
+void agg_cache_put(str* pres_uri, int event, str* body, str* extra_hdrs,
+		int valid_until, unsigned int version)
+{
+	unsigned int hash_code;
+	agg_entry_t* e, **prev;
+	int len;
+
+	if(valid_until<= (int)time(NULL))
+		return;
+
+	len= sizeof(agg_entry_t)+ pres_uri->len+ body->len+
+		(extra_hdrs? extra_hdrs->len: 0);
+	e= (agg_entry_t*)shm_malloc(len);
+	if(e== NULL)
+	{
+		LM_ERR("no more shared memory\n");
+		return;
+	}
+	memset(e, 0, sizeof(agg_entry_t));
+
+	e->event= event;
+	e->valid_until= valid_until;
+	e->pres_uri.s= (char*)(e+ 1);
+	e->pres_uri.len= pres_uri->len;
+	memcpy(e->pres_uri.s, pres_uri->s, pres_uri->len);
+	e->body.s= e->pres_uri.s+ pres_uri->len;
+	e->body.len= body->len;
+	memcpy(e->body.s, body->s, body->len);
+	if(extra_hdrs && extra_hdrs->len)
+	{
+		e->extra_hdrs.s= e->body.s+ body->len;
+		e->extra_hdrs.len= extra_hdrs->len;
+		memcpy(e->extra_hdrs.s, extra_hdrs->s, extra_hdrs->len);
+	}
+
+	hash_code= core_hash(pres_uri, NULL, phtable_size);
+
+	lock_get(&agg_htable[hash_code].lock);
+
+	if(agg_htable[hash_code].version!= version)
+	{
+		/* the presentity changed while building the body */
+		lock_release(&agg_htable[hash_code].lock);
+		shm_free(e);
+		return;
+	}
+
+	/* replace any older body of the presentity */
+	for(prev= &agg_htable[hash_code].entries; *prev; prev= &(*prev)->next)
+		if((*prev)->event== event && (*prev)->pres_uri.len== pres_uri->len &&
+		memcmp((*prev)->pres_uri.s, pres_uri->s, pres_uri->len)== 0)
+		{
+			e->next= (*prev)->next;
+			shm_free(*prev);
+			*prev= e;
+			lock_release(&agg_htable[hash_code].lock);
+			return;
+		}
+
+	e->next= agg_htable[hash_code].entries;
+	agg_htable[hash_code].entries= e;
+
+	lock_release(&agg_htable[hash_code].lock);
+}
+
+void agg_cache_invalidate(str* pres_uri, int event)
+{
+	unsigned int hash_code;
+	agg_entry_t* e, **prev;
+
+	hash_code= core_hash(pres_uri, NULL, phtable_size);
+
+	lock_get(&agg_htable[hash_code].lock);
+
+	agg_htable[hash_code].version++;
+
+	for(prev= &agg_htable[hash_code].entries; *prev; prev= &(*prev)->next)
+		if((*prev)->event== event && (*prev)->pres_uri.len== pres_uri->len &&
+		memcmp((*prev)->pres_uri.s, pres_uri->s, pres_uri->len)== 0)
+		{
+			e= *prev;
+			*prev= e->next;
+			shm_free(e);
+			break;
+		}
+
+	lock_release(&agg_htable[hash_code].lock);
+}
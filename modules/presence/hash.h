@@ -182,5 +182,40 @@ cluster_query_entry_t* search_cluster_query(str* pres_uri, int event,
 
 int delete_cluster_query(str* pres_uri, int event, unsigned int hash_code);
 
+
+/* aggregated NOTIFY bodies of the presentities, per event */
+typedef struct agg_entry
+{
+	str pres_uri;
+	int event;
+	str body;
+	str extra_hdrs;
+	/* the first expiring publication the body was built from */
+	int valid_until;
+	struct agg_entry* next;
+}agg_entry_t;
+
+typedef struct agg_htable
+{
+	agg_entry_t* entries;
+	/* bumped by each invalidation, so bodies built in parallel with a
+	 * presentity change are not cached */
+	unsigned int version;
+	gen_lock_t lock;
+}agg_htable_t;
+
+extern agg_htable_t* agg_htable;
+
+agg_htable_t* new_agg_htable(void);
+void destroy_agg_htable(void);
+
+int agg_cache_get(str* pres_uri, int event, str* body, str* extra_hdrs,
+		unsigned int* version);
+
+void agg_cache_put(str* pres_uri, int event, str* body, str* extra_hdrs,
+		int valid_until, unsigned int version);
+
+void agg_cache_invalidate(str* pres_uri, int event);
+
 #endif
 
@@ -28,6 +28,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
+#include <limits.h>
 #include <libxml/parser.h>
 
 #include "../../trim.h"
@@ -37,6 +39,9 @@
 #include "../../db/db.h"
 #include "../../db/db_val.h"
 #include "../../socket_info.h"
+#include "../../ipc.h"
+#include "../../pt.h"
+#include "../../reactor_proc.h"
 #include "../tm/tm_load.h"
 #include "../pua/hash.h"
 #include "presentity.h"
@@ -47,6 +52,42 @@
 
 #define MAX_FORWARD 70
 
+/* NOTIFY bodies built once per fan-out and shared by all the watchers of
+ * the same (event, content-type, filter) class */
+typedef struct fanout_body {
+	pres_ev_t *event;
+	str filter;            /* the SUBSCRIBE body the NOTIFY body depends on */
+	str *body;
+	str ct;                /* content-type, if not the one of the event */
+	str extra_hdrs;
+	free_body_t *free_fct;
+	int suppress;
+	struct fanout_body *next;
+} fanout_body_t;
+
+/* the class bodies of the fan-out in progress, if any */
+static fanout_body_t **fanout_bodies;
+
+/* a fan-out handed over to a notifier process */
+typedef struct notify_job {
+	pres_ev_t *event;
+	str pres_uri;
+	str *sender;
+	str *extra_hdrs;
+	str *body;
+	str *offline_etag;
+	str *rules_doc;
+	str *dialog_body;
+	str strs[6];           /* storage for the above */
+	str **sh_tags;
+	int from_publish;
+	struct timeval start;
+} notify_job_t;
+
+int notifier_processes = 0;
+/* process_no of each notifier process, -1 until started */
+int *notifier_procs;
+
 c_back_param* shm_dup_cbparam(subs_t*);
 void free_cbparam(c_back_param* cb_param);
 
@@ -923,6 +964,8 @@ static str* get_p_notify_body(str pres_uri, pres_ev_t* event, str* etag,
 	str* dialog_body= NULL, *local_dialog_body = NULL;
 	int init_i = 0;
 	pres_entry_t* p;
+	int cacheable, own_hdrs = 0, valid_until = INT_MAX;
+	unsigned int agg_version = 0;
 
 	if(parse_uri(pres_uri.s, pres_uri.len, &uri)< 0)
 	{
@@ -1013,6 +1056,30 @@ static str* get_p_notify_body(str pres_uri, pres_ev_t* event, str* etag,
 		}
 	}
 
+	/* the aggregated body of all the publications may be cached */
+	cacheable = agg_htable && event->agg_nbody && !etag && !publ_body &&
+		!(mix_dialog_presence && event->evp->parsed == EVENT_PRESENCE);
+	if(cacheable)
+	{
+		own_hdrs = extra_hdrs && !extra_hdrs->s;
+
+		notify_body= (str*)pkg_malloc(sizeof(str));
+		if(notify_body== NULL)
+		{
+			ERR_MEM(PKG_MEM_STR);
+		}
+		if(agg_cache_get(&pres_uri, event->evp->parsed, notify_body,
+		extra_hdrs, &agg_version))
+		{
+			update_stat(agg_cache_hits, 1);
+			*free_fct = (free_body_t*)pkg_free_w;
+			return notify_body;
+		}
+		pkg_free(notify_body);
+		notify_body= NULL;
+		update_stat(agg_cache_misses, 1);
+	}
+
 	result = pres_search_db(&uri,&event->name,&body_col,&extra_hdrs_col,&expires_col,&etag_col);
 	if(result== NULL)
 		return NULL;
@@ -1209,6 +1276,9 @@ static str* get_p_notify_body(str pres_uri, pres_ev_t* event, str* etag,
 					}
 				}
 
+				if(row_vals[expires_col].val.int_val< valid_until)
+					valid_until= row_vals[expires_col].val.int_val;
+
 				len= strlen((char*)row_vals[body_col].val.string_val);
 				if(len== 0)
 				{
@@ -1274,6 +1344,10 @@ static str* get_p_notify_body(str pres_uri, pres_ev_t* event, str* etag,
 			LM_ERR("Failed to aggregate notify body\n");
 			goto error;
 		}
+
+		if(cacheable && notify_body->s)
+			agg_cache_put(&pres_uri, event->evp->parsed, notify_body,
+				own_hdrs ? extra_hdrs : NULL, valid_until, agg_version);
 	}
 
 done:
@@ -1707,7 +1781,7 @@ int presentity_has_subscribers(str* pres_uri, pres_ev_t* event)
 	lock_release(&subs_htable[hash_code].lock);
 
 	/* presentity has no subscriber in hash. Check db ?? */
-	if(fallback2db==0)
+	if(fallback2db==0 || memory_subs_index)
 		return 0;
 
 	keys[0] = &str_presentity_uri_col;
@@ -1782,9 +1856,10 @@ subs_t* get_subs_dialog(str* pres_uri, pres_ev_t* event, str* sender,
 	}
 
 	/* if fallback2db -> should take all dialogs from db
-	 * and the only those dialogs from cache with db_flag= INSERTDB_FLAG */
+	 * and the only those dialogs from cache with db_flag= INSERTDB_FLAG,
+	 * unless the in-memory subscriptions are the authoritative ones */
 
-	if(fallback2db)
+	if(fallback2db && !memory_subs_index)
 	{
 		if(get_subs_db(pres_uri, event, sender, &s_array, &n, sh_tags)< 0)
 		{
@@ -1847,16 +1922,92 @@ error:
 	return NULL;
 }
 
-int publ_notify(presentity_t* p, str pres_uri, str* body, str* offline_etag,
-		str* rules_doc, str* dialog_body, int from_publish, str **sh_tags)
+static fanout_body_t *get_fanout_body(subs_t *subs, int from_publish)
+{
+	fanout_body_t *fb;
+	str filter = {NULL, 0};
+
+	if (subs->event->build_notify_body)
+		filter = subs->subs_body;
+
+	for (fb = *fanout_bodies; fb; fb = fb->next)
+		if (fb->event == subs->event && fb->filter.len == filter.len &&
+		(filter.len == 0 || memcmp(fb->filter.s, filter.s, filter.len) == 0)) {
+			update_stat(fanout_body_reuses, 1);
+			return fb;
+		}
+
+	fb = (fanout_body_t *)pkg_malloc(sizeof *fb + filter.len);
+	if (fb == NULL) {
+		LM_ERR("no more pkg memory\n");
+		return NULL;
+	}
+	memset(fb, 0, sizeof *fb);
+
+	fb->event = subs->event;
+	if (filter.len) {
+		fb->filter.s = (char *)(fb + 1);
+		fb->filter.len = filter.len;
+		memcpy(fb->filter.s, filter.s, filter.len);
+	}
+
+	if (subs->event->build_notify_body) {
+		fb->body = subs->event->build_notify_body(&subs->pres_uri,
+			&subs->subs_body, &fb->ct, &fb->suppress);
+		fb->free_fct = subs->event->free_body;
+	} else {
+		fb->body = get_p_notify_body(subs->pres_uri, subs->event, 0, 0,
+			(subs->contact.s)?&subs->contact:NULL, NULL, &fb->extra_hdrs,
+			&fb->free_fct, from_publish, 1);
+	}
+
+	/* a missing body is a valid outcome too */
+	fb->next = *fanout_bodies;
+	*fanout_bodies = fb;
+
+	return fb;
+}
+
+
+static void free_fanout_bodies(fanout_body_t *fb)
+{
+	fanout_body_t *next;
+
+	for (; fb; fb = next) {
+		next = fb->next;
+
+		if (fb->body) {
+			if (fb->body->s) {
+				if (fb->free_fct)
+					fb->free_fct(fb->body->s);
+				else
+					fb->event->free_body(fb->body->s);
+			}
+			pkg_free(fb->body);
+		}
+		if (fb->ct.s)
+			pkg_free(fb->ct.s);
+		if (fb->extra_hdrs.s)
+			pkg_free(fb->extra_hdrs.s);
+
+		pkg_free(fb);
+	}
+}
+
+
+static int do_publ_notify(pres_ev_t *event, str *sender, str *extra_hdrs,
+		str pres_uri, str* body, str* offline_etag, str* rules_doc,
+		str* dialog_body, int from_publish, str **sh_tags,
+		struct timeval *start)
 {
 	str *notify_body = NULL;
 	str notify_extra_hdrs = {NULL, 0};
 	subs_t* subs_array= NULL, *s= NULL;
-	int ret_code= -1;
+	int ret_code= -1, sent = 0;
 	free_body_t* free_fct = 0;
+	fanout_body_t *bodies = NULL, **prev_bodies;
 
-	subs_array= get_subs_dialog(&pres_uri, p->event , p->sender, sh_tags);
+	subs_array= get_subs_dialog(&pres_uri, event, sender, sh_tags);
 	if(subs_array == NULL)
 	{
 		LM_DBG("Could not find subs_dialog\n");
@@ -1865,27 +2016,39 @@ int publ_notify(presentity_t* p, str pres_uri, str* body, str* offline_etag,
 	}
 
 	/* if the event does not require aggregation - we have the final body */
-	if(p->event->agg_nbody)
+	if(event->agg_nbody)
 	{
-		notify_body = get_p_notify_body(pres_uri, p->event , offline_etag, body,
+		notify_body = get_p_notify_body(pres_uri, event, offline_etag, body,
 				NULL, dialog_body,
-				p->extra_hdrs?p->extra_hdrs:&notify_extra_hdrs, &free_fct,
+				extra_hdrs?extra_hdrs:&notify_extra_hdrs, &free_fct,
 				from_publish, 0);
 	}
 
+	prev_bodies = fanout_bodies;
+	fanout_bodies = &bodies;
+
 	s= subs_array;
 	while(s)
 	{
 		s->auth_rules_doc= rules_doc;
 		LM_INFO("notify\n");
 		if(notify(s, NULL, notify_body?notify_body:body,
-			0, p->extra_hdrs?p->extra_hdrs:&notify_extra_hdrs, from_publish)< 0 )
+			0, extra_hdrs?extra_hdrs:&notify_extra_hdrs, from_publish)< 0 )
 		{
 			LM_ERR("Could not send notify for %.*s\n",
-					p->event->name.len, p->event->name.s);
+					event->name.len, event->name.s);
 		}
+		else
+			sent++;
 		s= s->next;
 	}
+
+	fanout_bodies = prev_bodies;
+	free_fanout_bodies(bodies);
+
+	update_stat(fanout_jobs, 1);
+	update_stat(fanout_notifies, sent);
+	update_stat(fanout_usec, get_time_diff(start));
 	ret_code= 0;
 
 done:
@@ -1901,7 +2064,7 @@ done:
 			if( free_fct)
 				free_fct(notify_body->s);
 			else
-				p->event->free_body(notify_body->s);
+				event->free_body(notify_body->s);
 		}
 		pkg_free(notify_body);
 	}
@@ -1909,6 +2072,144 @@ done:
 }
 
 
+/* runs in the notifier process */
+static void run_notify_job(int sender, void *param)
+{
+	notify_job_t *job = (notify_job_t *)param;
+
+	do_publ_notify(job->event, job->sender, job->extra_hdrs, job->pres_uri,
+		job->body, job->offline_etag, job->rules_doc, job->dialog_body,
+		job->from_publish, job->sh_tags, &job->start);
+
+	shm_free(job);
+}
+
+
+/* hands the fan-out over to a notifier process, always the same for a
+ * presentity, so its NOTIFYs are still sent in order */
+static int dispatch_publ_notify(presentity_t* p, str *pres_uri, str* body,
+		str* offline_etag, str* rules_doc, str* dialog_body, int from_publish,
+		str **sh_tags)
+{
+	str *src[6] = {p->sender, p->extra_hdrs, body, offline_etag, rules_doc,
+		dialog_body};
+	notify_job_t *job;
+	str **dst[6], *tags;
+	int size, proc, i, n = 0;
+	char *c;
+
+	proc = notifier_procs[core_hash(pres_uri, NULL, 0) % notifier_processes];
+	if (proc < 0)
+		/* not started yet */
+		return -1;
+
+	size = sizeof *job + pres_uri->len;
+	for (i = 0; i < 6; i++)
+		if (src[i] && src[i] != FAKED_BODY && src[i]->s)
+			size += src[i]->len;
+	if (sh_tags) {
+		for (n = 0; sh_tags[n]; n++)
+			size += sizeof(str *) + sizeof(str) + sh_tags[n]->len;
+		size += sizeof(str *);
+	}
+
+	job = (notify_job_t *)shm_malloc(size);
+	if (job == NULL) {
+		LM_ERR("no more shm memory\n");
+		return -1;
+	}
+	memset(job, 0, sizeof *job);
+
+	job->event = p->event;
+	job->from_publish = from_publish;
+	gettimeofday(&job->start, NULL);
+
+	c = (char *)(job + 1);
+	if (sh_tags) {
+		job->sh_tags = (str **)c;
+		tags = (str *)(job->sh_tags + n + 1);
+		c = (char *)(tags + n);
+		for (i = 0; i < n; i++) {
+			job->sh_tags[i] = &tags[i];
+			tags[i].s = c;
+			tags[i].len = sh_tags[i]->len;
+			memcpy(c, sh_tags[i]->s, sh_tags[i]->len);
+			c += sh_tags[i]->len;
+		}
+		job->sh_tags[n] = NULL;
+	}
+
+	job->pres_uri.s = c;
+	job->pres_uri.len = pres_uri->len;
+	memcpy(c, pres_uri->s, pres_uri->len);
+	c += pres_uri->len;
+
+	dst[0] = &job->sender;
+	dst[1] = &job->extra_hdrs;
+	dst[2] = &job->body;
+	dst[3] = &job->offline_etag;
+	dst[4] = &job->rules_doc;
+	dst[5] = &job->dialog_body;
+	for (i = 0; i < 6; i++) {
+		if (!src[i] || src[i] == FAKED_BODY || !src[i]->s) {
+			*dst[i] = (src[i] == FAKED_BODY) ? FAKED_BODY : NULL;
+			continue;
+		}
+
+		*dst[i] = &job->strs[i];
+		job->strs[i].s = c;
+		job->strs[i].len = src[i]->len;
+		memcpy(c, src[i]->s, src[i]->len);
+		c += src[i]->len;
+	}
+
+	if (ipc_send_rpc(proc, run_notify_job, job) < 0) {
+		LM_ERR("failed to send the fan-out job to notifier %d\n", proc);
+		shm_free(job);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int publ_notify(presentity_t* p, str pres_uri, str* body, str* offline_etag,
+		str* rules_doc, str* dialog_body, int from_publish, str **sh_tags)
+{
+	struct timeval start;
+
+	/* called for each change of the presentity */
+	if (agg_htable)
+		agg_cache_invalidate(&pres_uri, p->event->evp->parsed);
+
+	/* tag filtering enabled, but no active tag - nothing to send */
+	if (sh_tags && sh_tags[0]==NULL)
+		return 0;
+
+	if (notifier_processes > 0 && dispatch_publ_notify(p, &pres_uri, body,
+	offline_etag, rules_doc, dialog_body, from_publish, sh_tags) == 0)
+		return 0;
+
+	gettimeofday(&start, NULL);
+
+	return do_publ_notify(p->event, p->sender, p->extra_hdrs, pres_uri, body,
+		offline_etag, rules_doc, dialog_body, from_publish, sh_tags, &start);
+}
+
+
+void notifier_process(int rank)
+{
+	notifier_procs[rank] = process_no;
+
+	if (reactor_proc_init("presence notifier") < 0) {
+		LM_ERR("failed to init the presence notifier\n");
+		return;
+	}
+
+	reactor_proc_loop();
+}
+
+
 int virtual_notify(str *pres_uri, pres_ev_t *ev, str *body)
 {
 	presentity_t pres;
@@ -1930,8 +2231,12 @@ int query_db_notify(str* pres_uri, pres_ev_t* event, subs_t* watcher_subs)
 	subs_t* subs_array = NULL, *s= NULL;
 	str notify_extra_hdrs = {NULL, 0};
 	str* notify_body = NULL;
-	int ret_code= -1;
+	int ret_code= -1, sent = 0;
 	free_body_t* free_fct = 0;
+	fanout_body_t *bodies = NULL, **prev_bodies;
+	struct timeval start;
+
+	gettimeofday(&start, NULL);
 
 	subs_array= get_subs_dialog(pres_uri, event , NULL, NULL);
 	if(subs_array == NULL)
@@ -1947,6 +2252,9 @@ int query_db_notify(str* pres_uri, pres_ev_t* event, subs_t* watcher_subs)
 				&notify_extra_hdrs, &free_fct, 0, 1);
 	}
 
+	prev_bodies = fanout_bodies;
+	fanout_bodies = &bodies;
+
 	s= subs_array;
 
 	while(s)
@@ -1957,9 +2265,17 @@ int query_db_notify(str* pres_uri, pres_ev_t* event, subs_t* watcher_subs)
 			LM_ERR("Could not send notify for [event]=%.*s\n",
 					event->name.len, event->name.s);
 		}
+		else
+			sent++;
 		s= s->next;
 	}
 
+	fanout_bodies = prev_bodies;
+	free_fanout_bodies(bodies);
+
+	update_stat(fanout_jobs, 1);
+	update_stat(fanout_notifies, sent);
+	update_stat(fanout_usec, get_time_diff(&start));
 	ret_code= 1;
 
 done:
@@ -2001,6 +2317,7 @@ int send_notify_request(subs_t* subs, subs_t * watcher_subs,
 	free_body_t* free_fct = 0;
 	str ct_body = {NULL,0};
 	int suppress_notify = 0;
+	fanout_body_t *fb = NULL;
 
 	LM_DBG("enter: have_body=%d force_null=%d dialog info:\n",
 	  (n_body!=0&&n_body->s!=0)?1:0, force_null_body);
@@ -2054,6 +2371,17 @@ int send_notify_request(subs_t* subs, subs_t * watcher_subs,
 			{
 				if (from_publish && n_body!= 0 && n_body->s!= 0) {
 					notify_body = n_body;
+				} else if (fanout_bodies) {
+					/* part of a fan-out, build it once per class of watchers */
+					fb = get_fanout_body(subs, from_publish);
+					if (fb == NULL)
+						goto error;
+					if (fb->suppress)
+						return 0;
+					notify_body = fb->body;
+					ct_body = fb->ct;
+					if (!extra_hdrs || !extra_hdrs->s)
+						extra_hdrs = &fb->extra_hdrs;
 				} else if (subs->event->build_notify_body) {
 					notify_body = subs->event->build_notify_body(&subs->pres_uri,
 						&subs->subs_body, &ct_body, &suppress_notify);
@@ -2082,8 +2410,10 @@ int send_notify_request(subs_t* subs, subs_t * watcher_subs,
 						}
 						if(final_body)
 						{
-							free_fct(notify_body->s);
-							pkg_free(notify_body);
+							if (!fb) {
+								free_fct(notify_body->s);
+								pkg_free(notify_body);
+							}
 							notify_body= final_body;
 						}
 					}
@@ -2170,7 +2500,8 @@ jump_over_body:
 	if (notify_extra_hdrs.s)
 		pkg_free(notify_extra_hdrs.s);
 
-	if((int)(long)n_body!= (int)(long)notify_body)
+	if((int)(long)n_body!= (int)(long)notify_body &&
+	(!fb || notify_body != fb->body))
 	{
 		if(notify_body!=NULL)
 		{
@@ -2196,10 +2527,11 @@ error:
 		pkg_free(str_hdr.s);
 	if (notify_extra_hdrs.s)
 		pkg_free(notify_extra_hdrs.s);
-	if (ct_body.s)
+	if (ct_body.s && (!fb || ct_body.s != fb->ct.s))
 		pkg_free(ct_body.s);
 
-	if((int)(long)n_body!= (int)(long)notify_body)
+	if((int)(long)n_body!= (int)(long)notify_body &&
+	(!fb || notify_body != fb->body))
 	{
 		if(notify_body!=NULL)
 		{
@@ -2232,6 +2564,11 @@ int notify(subs_t* subs, subs_t * watcher_subs, str* n_body, int force_null_body
 		{
 			LM_DBG("record not found in subs htable\n");
 		}
+		else if(memory_subs_index)
+		{
+			/* written behind, by the DB update timer */
+			goto send;
+		}
 		if(fallback2db)
 		{
 			if(update_subs_db(subs, LOCAL_TYPE)< 0)
@@ -2242,6 +2579,7 @@ int notify(subs_t* subs, subs_t * watcher_subs, str* n_body, int force_null_body
 		}
 	}
 
+send:
 	if(subs->reason.s && subs->status== ACTIVE_STATUS &&
 		subs->reason.len== 12 && strncmp(subs->reason.s, "polite-block", 12)== 0)
 	{
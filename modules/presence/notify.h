@@ -26,6 +26,7 @@
  */
 
 #include "../../str.h"
+#include "../../statistics.h"
 #include "../tm/dlg.h"
 #include "subscribe.h"
 #include "presentity.h"
@@ -98,6 +99,18 @@ void printf_subs(subs_t* subs);
 
 int query_db_notify(str* pres_uri,pres_ev_t* event, subs_t* watcher_subs );
 
+extern int notifier_processes;
+extern int *notifier_procs;
+
+extern stat_var *fanout_jobs;
+extern stat_var *fanout_notifies;
+extern stat_var *fanout_usec;
+extern stat_var *fanout_body_reuses;
+extern stat_var *agg_cache_hits;
+extern stat_var *agg_cache_misses;
+
+void notifier_process(int rank);
+
 int publ_notify(presentity_t* p, str pres_uri, str* body, str* offline_etag,
 		str* rules_doc, str* dialog_publish, int from_publish, str **sh_tags);
 
@@ -125,6 +125,9 @@ int max_expires_publish= 3600;
 int shtable_size= 9;
 shtable_t subs_htable= NULL;
 int fallback2db= 0;
+int memory_subs_index= 0;
+int agg_body_cache= 0;
+agg_htable_t* agg_htable= NULL;
 int sphere_enable= 0;
 int mix_dialog_presence= 0;
 int notify_offline_body= 0;
@@ -177,6 +180,9 @@ static param_export_t params[]={
 	{ "subs_htable_size",       INT_PARAM, &shtable_size},
 	{ "pres_htable_size",       INT_PARAM, &phtable_size},
 	{ "fallback2db",            INT_PARAM, &fallback2db},
+	{ "memory_subs_index",      INT_PARAM, &memory_subs_index},
+	{ "notifier_processes",     INT_PARAM, &notifier_processes},
+	{ "agg_body_cache",         INT_PARAM, &agg_body_cache},
 	{ "enable_sphere_check",    INT_PARAM, &sphere_enable},
 	{ "waiting_subs_daysno",    INT_PARAM, &waiting_subs_daysno},
 	{ "mix_dialog_presence",    INT_PARAM, &mix_dialog_presence},
@@ -190,6 +196,41 @@ static param_export_t params[]={
 	{0,0,0}
 };
 
+stat_var *fanout_jobs;
+stat_var *fanout_notifies;
+stat_var *fanout_usec;
+stat_var *fanout_body_reuses;
+stat_var *agg_cache_hits;
+stat_var *agg_cache_misses;
+
+static unsigned long agg_cache_hit_ratio(void *param)
+{
+	unsigned long hits, lookups;
+
+	hits = get_stat_val(agg_cache_hits);
+	lookups = hits + get_stat_val(agg_cache_misses);
+
+	return lookups ? hits * 100 / lookups : 0;
+}
+
+static stat_export_t mod_stats[] = {
+	{"notify_fanouts",        0, &fanout_jobs        },
+	{"notify_fanout_sent",    0, &fanout_notifies    },
+	{"notify_fanout_usec",    0, &fanout_usec        },
+	{"notify_body_reuses",    0, &fanout_body_reuses },
+	{"agg_body_cache_hits",   0, &agg_cache_hits     },
+	{"agg_body_cache_misses", 0, &agg_cache_misses   },
+	{"agg_body_cache_hit_ratio", STAT_IS_FUNC,
+		(stat_var**)agg_cache_hit_ratio },
+	{0, 0, 0}
+};
+
+static proc_export_t procs[] = {
+	{"presence notifier", 0, 0, notifier_process, 0,
+		PROC_FLAG_INITCHILD|PROC_FLAG_HAS_IPC},
+	{0,0,0,0,0,0}
+};
+
 static mi_export_t mi_cmds[] = {
 	// refreshWatchers is a deprecated alias for refresh_watchers. To be removed later.
 	{ "refreshWatchers", 0,0,0, {
@@ -246,11 +287,11 @@ struct module_exports exports= {
 	cmds,						/* exported functions */
 	0,							/* exported async functions */
 	params,						/* exported parameters */
-	0,							/* exported statistics */
+	mod_stats,					/* exported statistics */
 	mi_cmds,					/* exported MI functions */
 	0,							/* exported pseudo-variables */
 	0,			 				/* exported transformations */
-	0,							/* extra processes */
+	procs,						/* extra processes */
 	0,							/* module pre-initialization function */
 	mod_init,					/* module initialization function */
 	(response_function) 0,      /* response handling function */
@@ -394,6 +435,25 @@ static int mod_init(void)
 		return -1;
 	}
 
+	if(memory_subs_index && !fallback2db)
+	{
+		LM_INFO("the subscriptions are kept in memory anyhow without "
+			"fallback2db, ignoring memory_subs_index\n");
+		memory_subs_index = 0;
+	}
+
+	if(notifier_processes> 0)
+	{
+		notifier_procs = (int*)shm_malloc(notifier_processes* sizeof(int));
+		if(notifier_procs== NULL)
+		{
+			LM_ERR("no more shared memory\n");
+			return -1;
+		}
+		memset(notifier_procs, -1, notifier_processes* sizeof(int));
+		procs[0].no = notifier_processes;
+	}
+
 	if(phtable_size< 1)
 		phtable_size= 256;
 	else
@@ -406,6 +466,21 @@ static int mod_init(void)
 		return -1;
 	}
 
+	if(agg_body_cache)
+	{
+		if(fallback2db)
+		{
+			LM_WARN("the aggregated bodies cannot be cached with "
+				"fallback2db, ignoring agg_body_cache\n");
+			agg_body_cache= 0;
+		}
+		else if((agg_htable= new_agg_htable())== NULL)
+		{
+			LM_ERR("initializing the aggregated body cache\n");
+			return -1;
+		}
+	}
+
 	if(pres_htable_restore()< 0)
 	{
 		LM_ERR("filling in presentity hash table from database\n");
@@ -516,6 +591,9 @@ static void destroy(void)
 	if(pres_htable)
 		destroy_phtable();
 
+	if(agg_htable)
+		destroy_agg_htable();
+
 	if(pa_db && pa_dbf.close)
 		pa_dbf.close(pa_db);
 
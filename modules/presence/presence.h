@@ -58,6 +58,7 @@ extern str contact_user;
 extern int max_expires_publish;
 extern int max_expires_subscribe;
 extern int fallback2db;
+extern int memory_subs_index;
 extern int sphere_enable;
 extern int shtable_size;
 extern shtable_t subs_htable;
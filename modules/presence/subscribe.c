@@ -379,6 +379,13 @@ int update_subscription(struct sip_msg* msg, subs_t* subs, int init_req)
 			LM_DBG("updating subscription record in hash table failed\n");
 			if(!fallback2db)
 				goto error_500_reply;
+			/* known only by the DB so far - index it in memory too */
+			if(memory_subs_index &&
+			insert_shtable(subs_htable, hash_code, subs)< 0)
+			{
+				LM_ERR("inserting record in subs_htable\n");
+				goto error_500_reply;
+			}
 		}
 		if(fallback2db)
 		{
@@ -1376,10 +1383,11 @@ void update_db_subs(db_con_t *db,db_func_t *dbf, shtable_t hash_table,
 	str **sh_tags=NULL;
 
 
-	if (fallback2db==0) {
+	if (fallback2db==0 || memory_subs_index) {
 		/* if `fallback2db` is enabled, all the INSERT/UPDATED/DELETES ops
 		 * triggered by received SUBSCRIBE requests are done in realtime, not
-		 * on timer. */
+		 * on timer; with `memory_subs_index`, only the NOTIFY triggered
+		 * UPDATEs are pending here. */
 		query_cols[pres_uri_col= n_query_cols] =&str_presentity_uri_col;
 		query_vals[pres_uri_col].type = DB_STR;
 		query_vals[pres_uri_col].nul = 0;
@@ -1568,7 +1576,7 @@ void update_db_subs(db_con_t *db,db_func_t *dbf, shtable_t hash_table,
 			}
 
 			/* perform pending UPDATE/INSERT if not in DB realtime */
-			if (fallback2db==0) {
+			if (fallback2db==0 || memory_subs_index) {
 
 				switch(s->db_flag)
 				{
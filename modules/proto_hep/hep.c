@@ -43,6 +43,7 @@
 #include "../../mod_fix.h"
 
 #include "hep.h"
+#include "hep_ring.h"
 #include "../compression/compression_api.h"
 
 #include "../../lib/cJSON.h"
@@ -50,6 +51,18 @@
 #define GENERIC_VENDOR_ID 0x0000
 #define HEP_PROTO_SIP  0x01
 
+/* enough for a packet with up to 5 custom chunks */
+#define HEP_IOV_STATIC 16
+
+/* a HEP packet, as a list of buffers */
+struct hep_iov {
+	struct iovec *iov;
+	int cnt;
+	int len;
+	generic_chunk_t correlation;	/* the JSON correlation chunk */
+	struct iovec iov_buf[HEP_IOV_STATIC];
+};
+
 static int control_id = -1;
 
 struct hep_message_id {
@@ -1243,27 +1256,50 @@ static inline void JSON_free(void* root)
 	cJSON_Delete(root);
 }
 
-static char* build_hep3_buf(struct hep_desc* hep_msg, int* len)
+static void hep_iov_release(struct hep_iov* hi)
+{
+	if (hi->correlation.data) {
+		cJSON_PurgeString((char *)hi->correlation.data);
+		hi->correlation.data = NULL;
+	}
+
+	if (hi->iov != hi->iov_buf)
+		pkg_free(hi->iov);
+	hi->iov = hi->iov_buf;
+	hi->cnt = 0;
+}
+
+/*
+ * Describes the HEPv3 packet as a list of buffers, pointing straight into
+ * the hep_desc structure and the payload, so that it can be sent or copied
+ * with no intermediate buffer. The structure is converted to network order,
+ * so the packet can only be built once.
+ */
+static int build_hep3_iov(struct hep_desc* hep_msg, struct hep_iov* hi)
 {
-	#define HEP3_BUF_APPEND(_dst, _src, _sz) \
+	#define HEP3_IOV_ADD(_base, _sz) \
 		do { \
 			if (rem < (_sz)) { \
 				LM_BUG("bad packet length inside hep structure!\n"); \
 				goto out_err; \
 			} \
-			memcpy((_dst), (_src), (_sz)); \
+			hi->iov[hi->cnt].iov_base = (void *)(_base); \
+			hi->iov[hi->cnt].iov_len = (_sz); \
+			hi->cnt++; \
 			rem -= (_sz); \
-			(*len) += (_sz); \
+			hi->len += (_sz); \
 		} while (0);
 
 
-	int rem, hdr_len, pld_len, corr_len=0;
-	char* buf;
+	int rem, hdr_len, pld_len, corr_len=0, max_iov;
 	str* h5_buf;
 
-	generic_chunk_t *it, *corr_chunk, correlation;
+	generic_chunk_t *it, *corr_chunk;
 
-	*len = 0;
+	memset(&hi->correlation, 0, sizeof(generic_chunk_t));
+	hi->iov = hi->iov_buf;
+	hi->cnt = 0;
+	hi->len = 0;
 
 	rem = hep_msg->u.hepv3.hg.header.length;
 
@@ -1294,19 +1330,19 @@ static char* build_hep3_buf(struct hep_desc* hep_msg, int* len)
 
 	if ( hep_msg->correlation ) {
 		if ( !homer5_on ) {
-			memset( &correlation, 0, sizeof(generic_chunk_t));
-			correlation.chunk.vendor_id = htons(0);
+			hi->correlation.chunk.vendor_id = htons(0);
 			/* hardcoded but this is the header */
-			correlation.chunk.type_id = htons(HEP_EXTRA_CORRELATION);
-			correlation.chunk.length = sizeof(hep_chunk_t);
+			hi->correlation.chunk.type_id = htons(HEP_EXTRA_CORRELATION);
+			hi->correlation.chunk.length = sizeof(hep_chunk_t);
 
-			correlation.data = JSON_toString(hep_msg->correlation);
-			corr_len += strlen(correlation.data);
+			/* released along with the iov */
+			hi->correlation.data = JSON_toString(hep_msg->correlation);
+			corr_len += strlen(hi->correlation.data);
 
-			correlation.chunk.length += corr_len;
-			rem += correlation.chunk.length;
+			hi->correlation.chunk.length += corr_len;
+			rem += hi->correlation.chunk.length;
 
-			correlation.chunk.length = htons(correlation.chunk.length);
+			hi->correlation.chunk.length = htons(hi->correlation.chunk.length);
 		} else {
 			/* search to see whether we already got a correlation header */
 			for ( it=hep_msg->u.hepv3.chunk_list; it; it=it->next ) {
@@ -1320,13 +1356,13 @@ static char* build_hep3_buf(struct hep_desc* hep_msg, int* len)
 				corr_chunk = it;
 				rem -= it->chunk.length;
 			} else {
-				corr_chunk = pkg_malloc( sizeof(hep_chunk_t) );
+				corr_chunk = pkg_malloc( sizeof(generic_chunk_t) );
 				if ( !corr_chunk ) {
 					LM_ERR("no more pkg memory!\n");
-					return 0;
+					return -1;
 				}
 
-				memset( corr_chunk, 0, sizeof(hep_chunk_t) );
+				memset( corr_chunk, 0, sizeof(generic_chunk_t) );
 				corr_chunk->chunk.type_id = 0x11;
 			}
 
@@ -1344,24 +1380,31 @@ static char* build_hep3_buf(struct hep_desc* hep_msg, int* len)
 		}
 	}
 
+	/* generic header, addresses, payload and correlation, then the
+	 * custom chunks */
+	max_iov = 6;
+	for (it=hep_msg->u.hepv3.chunk_list; it; it=it->next)
+		max_iov += 2;
 
-	buf = pkg_malloc(rem);
+	if (max_iov > HEP_IOV_STATIC) {
+		hi->iov = pkg_malloc(max_iov * sizeof(struct iovec));
+		if (hi->iov == NULL) {
+			LM_ERR("no more pkg mem!\n");
+			hi->iov = hi->iov_buf;
+			goto out_err;
+		}
+	}
 
 	hep_msg->u.hepv3.hg.header.length = htons(rem);
 
-	if (buf == NULL) {
-		LM_ERR("no more pkg mem!\n");
-		return NULL;
-	}
-
-	HEP3_BUF_APPEND(buf, &hep_msg->u.hepv3.hg, sizeof(hep_generic_t));
+	HEP3_IOV_ADD(&hep_msg->u.hepv3.hg, sizeof(hep_generic_t));
 
 	if (hep_msg->u.hepv3.hg.ip_family.data == AF_INET) {
-		HEP3_BUF_APPEND(buf+*len, &hep_msg->u.hepv3.addr.ip4_addr, sizeof(struct ip4_addr));
+		HEP3_IOV_ADD(&hep_msg->u.hepv3.addr.ip4_addr, sizeof(struct ip4_addr));
 	}
 	/* IPv6 */
 	else if(hep_msg->u.hepv3.hg.ip_family.data == AF_INET6) {
-		HEP3_BUF_APPEND(buf+*len, &hep_msg->u.hepv3.addr.ip6_addr, sizeof(struct ip6_addr));
+		HEP3_IOV_ADD(&hep_msg->u.hepv3.addr.ip6_addr, sizeof(struct ip6_addr));
 	} else {
 		LM_ERR("unknown IP family\n");
 		goto out_err;
@@ -1375,21 +1418,18 @@ static char* build_hep3_buf(struct hep_desc* hep_msg, int* len)
 		hep_msg->u.hepv3.payload_chunk.chunk.length =
 					htons(hep_msg->u.hepv3.payload_chunk.chunk.length);
 
-		HEP3_BUF_APPEND(buf+*len, &hep_msg->u.hepv3.payload_chunk, sizeof(hep_chunk_t));
-		HEP3_BUF_APPEND(buf+*len, hep_msg->u.hepv3.payload_chunk.data, pld_len);
+		HEP3_IOV_ADD(&hep_msg->u.hepv3.payload_chunk, sizeof(hep_chunk_t));
+		HEP3_IOV_ADD(hep_msg->u.hepv3.payload_chunk.data, pld_len);
 	}
 
-	/* copy the correlation if exists */
+	/* add the correlation if exists */
 	if ( hep_msg->correlation ) {
 		/* if on it will be with the rest of the chunks */
 		if ( !homer5_on ) {
-			HEP3_BUF_APPEND( buf + *len, &correlation.chunk, sizeof(hep_chunk_t));
+			HEP3_IOV_ADD(&hi->correlation.chunk, sizeof(hep_chunk_t));
 
 			/* can't get the correlation length from header since it's in htons form */
-			HEP3_BUF_APPEND(buf + *len, correlation.data, corr_len);
-
-			/* just dumped the string - no need to keep it further on */
-			cJSON_PurgeString((char *)correlation.data);
+			HEP3_IOV_ADD(hi->correlation.data, corr_len);
 		}
 	}
 
@@ -1400,8 +1440,8 @@ static char* build_hep3_buf(struct hep_desc* hep_msg, int* len)
 		it->chunk.length = htons(it->chunk.length);
 		it->chunk.type_id = htons(it->chunk.type_id);
 
-		HEP3_BUF_APPEND(buf+*len, &it->chunk, sizeof(hep_chunk_t));
-		HEP3_BUF_APPEND(buf+*len, it->data, hdr_len - sizeof(hep_chunk_t));
+		HEP3_IOV_ADD(&it->chunk, sizeof(hep_chunk_t));
+		HEP3_IOV_ADD(it->data, hdr_len - sizeof(hep_chunk_t));
 	}
 
 	if (rem) {
@@ -1409,12 +1449,31 @@ static char* build_hep3_buf(struct hep_desc* hep_msg, int* len)
 		goto out_err;
 	}
 
-	return buf;
+	return 0;
 
 out_err:
-	pkg_free(buf);
-	return NULL;
-#undef HEP3_BUF_APPEND
+	hep_iov_release(hi);
+	return -1;
+#undef HEP3_IOV_ADD
+}
+
+static char* hep_iov_gather(struct hep_iov* hi)
+{
+	char *buf, *p;
+	int i;
+
+	buf = pkg_malloc(hi->len);
+	if (buf == NULL) {
+		LM_ERR("no more pkg mem!\n");
+		return NULL;
+	}
+
+	for (p = buf, i = 0; i < hi->cnt; i++) {
+		memcpy(p, hi->iov[i].iov_base, hi->iov[i].iov_len);
+		p += hi->iov[i].iov_len;
+	}
+
+	return buf;
 }
 
 /*
@@ -1670,6 +1729,7 @@ int send_hep_message(trace_message message, trace_dest dest, struct socket_info*
 {
 	int len, ret=-1;
 	char* buf=0;
+	struct hep_iov hi;
 
 	struct proxy_l* p;
 	union sockaddr_union* to;
@@ -1681,35 +1741,55 @@ int send_hep_message(trace_message message, trace_dest dest, struct socket_info*
 		goto end;
 	}
 
+	hi.iov = hi.iov_buf;
+	hi.cnt = 0;
+	memset(&hi.correlation, 0, sizeof hi.correlation);
 
 	if (((struct hep_desc *)message)->version == 3) {
 		/* hep msg will be freed after */
-		if ((buf=build_hep3_buf((struct hep_desc *)message, &len))==NULL) {
+		if (build_hep3_iov((struct hep_desc *)message, &hi) < 0) {
 			LM_ERR("failed to build hep buffer!\n");
 			goto end;
 		}
+		len = hi.len;
 	} else {
 		if ((buf=build_hep12_buf((struct hep_desc *)message, &len))==NULL) {
 			LM_ERR("failed to build hep buffer!\n");
 			goto end;
 		}
+		hi.iov[0].iov_base = buf;
+		hi.iov[0].iov_len = len;
+		hi.cnt = 1;
+		hi.len = len;
+	}
+
+	/* the tracing process does the sending; a full queue is not reported
+	 * as an error (the drop is accounted in the statistics), as we do not
+	 * want to flood the logs exactly when overloaded */
+	if (hep_ring_active()) {
+		hep_ring_push(hep_dest, send_sock, hi.iov, hi.cnt, len);
+		ret = 0;
+		goto release;
+	}
+
+	if (!buf && (buf=hep_iov_gather(&hi))==NULL) {
+		LM_ERR("failed to build hep buffer!\n");
+		goto release;
 	}
 
 	/* */
 	p=mk_proxy( &hep_dest->ip, hep_dest->port_no ? hep_dest->port_no : HEP_PORT, hep_dest->transport, 0);
 	if (p == NULL) {
-		pkg_free(buf);
 		LM_ERR("bad hep host name!\n");
-		goto end;
+		goto release;
 	}
 
 	to=(union sockaddr_union *)pkg_malloc(sizeof(union sockaddr_union));
 	if (to == 0) {
 		LM_ERR("no more pkg mem!\n");
-		pkg_free(buf);
 		free_proxy(p);
 		pkg_free(p);
-		goto end;
+		goto release;
 	}
 
 	hostent2su(to, &p->host, p->addr_idx, p->port?p->port:HEP_PORT);
@@ -1726,8 +1806,11 @@ int send_hep_message(trace_message message, trace_dest dest, struct socket_info*
 	free_proxy(p);
 	pkg_free(p);
 	pkg_free(to);
-	pkg_free(buf);
 
+release:
+	hep_iov_release(&hi);
+	if (buf)
+		pkg_free(buf);
 end:
 	return ret;
 }
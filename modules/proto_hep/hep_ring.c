@@ -0,0 +1,452 @@
+/*
+ * Copyright (C) 2021 - OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define _GNU_SOURCE
+#include <sys/socket.h>
+#include <poll.h>
+#include <errno.h>
+
+#include "../../dprint.h"
+#include "../../mem/mem.h"
+#include "../../mem/shm_mem.h"
+#include "../../locking.h"
+#include "../../ipc.h"
+#include "../../pt.h"
+#include "../../resolve.h"
+#include "../../forward.h"
+#include "../../reactor_proc.h"
+#include "hep_ring.h"
+
+#define HEP_PKT_ALIGN(_x) (((_x) + 7) & ~7U)
+
+/* state of a packet in the ring */
+#define HEP_PKT_BUSY  0  /* reserved, still being written by the worker */
+#define HEP_PKT_READY 1
+#define HEP_PKT_WRAP  2  /* end of the ring, continue from its start */
+
+/* how long to wait for a full UDP socket to become writable */
+#define HEP_UDP_WAIT_MS 100
+
+struct hep_ring_pkt {
+	unsigned int size;              /* of the whole entry */
+	volatile int state;
+	struct socket_info *send_sock;
+	unsigned int len;               /* of the HEP packet */
+	unsigned short port;
+	unsigned short host_len;
+	char transport;
+	char data[0];                   /* the host, then the packet */
+};
+
+struct hep_ring {
+	gen_lock_t lock;                /* serializes the producers */
+	unsigned int size;
+	unsigned int mask;
+	volatile unsigned int head;
+	volatile unsigned int tail;
+	volatile int wakeup;            /* the tracing process was signalled */
+	volatile int proc_no;
+	char *buf;
+};
+
+int hep_trace_queue_size = 4*1024*1024;
+int hep_trace_batch_size = 64;
+
+stat_var *hep_trace_dropped;
+stat_var *hep_trace_sent;
+stat_var *hep_trace_failed;
+
+static struct hep_ring *ring;
+
+/* tracing process state */
+static struct hep_ring_pkt **batch;
+static struct mmsghdr *batch_msgs;
+static struct iovec *batch_iov;
+static char *tcp_buf;
+static unsigned int tcp_buf_size;
+
+#define ring_pkt(_off) ((struct hep_ring_pkt *)(ring->buf + (_off)))
+
+
+int hep_ring_init(void)
+{
+	unsigned int size;
+
+	if (hep_trace_batch_size <= 0) {
+		LM_ERR("bad trace_batch_size %d\n", hep_trace_batch_size);
+		return -1;
+	}
+
+	/* round up to a power of 2 */
+	for (size = 4096; size < (unsigned int)hep_trace_queue_size; size <<= 1)
+		if (size >= (1U << 30)) {
+			LM_ERR("trace_queue_size too large\n");
+			return -1;
+		}
+
+	ring = shm_malloc(HEP_PKT_ALIGN(sizeof *ring) + size);
+	if (!ring) {
+		LM_ERR("no more shm memory\n");
+		return -1;
+	}
+	memset(ring, 0, sizeof *ring);
+
+	if (!lock_init(&ring->lock)) {
+		LM_ERR("failed to init lock\n");
+		shm_free(ring);
+		ring = NULL;
+		return -1;
+	}
+
+	ring->size = size;
+	ring->mask = size - 1;
+	ring->proc_no = -1;
+	ring->buf = (char *)ring + HEP_PKT_ALIGN(sizeof *ring);
+
+	return 0;
+}
+
+void hep_ring_destroy(void)
+{
+	if (!ring)
+		return;
+
+	lock_destroy(&ring->lock);
+	shm_free(ring);
+	ring = NULL;
+}
+
+int hep_ring_active(void)
+{
+	return ring && ring->proc_no >= 0 && ring->proc_no != process_no;
+}
+
+unsigned long hep_ring_used(void *foo)
+{
+	if (!ring)
+		return 0;
+
+	return ring->head - ring->tail;
+}
+
+
+static void hep_ring_job(int sender, void *param);
+
+int hep_ring_push(hid_list_p dest, struct socket_info *send_sock,
+		const struct iovec *iov, int iovcnt, int len)
+{
+	struct hep_ring_pkt *pkt;
+	unsigned int need, off, skip;
+	char *p;
+	int i;
+
+	need = HEP_PKT_ALIGN(sizeof *pkt + dest->ip.len + len);
+
+	lock_get(&ring->lock);
+
+	/* a packet never wraps - skip the end of the ring if too short */
+	off = ring->head & ring->mask;
+	skip = (ring->size - off < need) ? ring->size - off : 0;
+
+	if (ring->head - ring->tail + skip + need > ring->size) {
+		lock_release(&ring->lock);
+		update_stat(hep_trace_dropped, 1);
+		LM_DBG("HEP queue full, dropping packet (%d bytes)\n", len);
+		return -1;
+	}
+
+	if (skip) {
+		/* too little room left for a header is skipped implicitly */
+		if (skip >= sizeof *pkt) {
+			ring_pkt(off)->size = skip;
+			ring_pkt(off)->state = HEP_PKT_WRAP;
+		}
+		off = 0;
+	}
+
+	pkt = ring_pkt(off);
+	pkt->state = HEP_PKT_BUSY;
+	ring->head += skip + need;
+
+	lock_release(&ring->lock);
+
+	/* the copy is done outside the lock */
+	pkt->size = need;
+	pkt->send_sock = send_sock;
+	pkt->len = len;
+	pkt->port = dest->port_no;
+	pkt->host_len = dest->ip.len;
+	pkt->transport = dest->transport;
+
+	memcpy(pkt->data, dest->ip.s, dest->ip.len);
+	for (p = pkt->data + dest->ip.len, i = 0; i < iovcnt; i++) {
+		memcpy(p, iov[i].iov_base, iov[i].iov_len);
+		p += iov[i].iov_len;
+	}
+
+	__sync_synchronize();
+	pkt->state = HEP_PKT_READY;
+
+	/* only signal the tracing process if not already signalled */
+	if (__sync_bool_compare_and_swap(&ring->wakeup, 0, 1) &&
+			ipc_send_rpc(ring->proc_no, hep_ring_job, NULL) < 0) {
+		LM_ERR("failed to signal the HEP tracing process\n");
+		ring->wakeup = 0;
+	}
+
+	return 0;
+}
+
+
+static inline int hep_pkt_same_dest(struct hep_ring_pkt *a,
+		struct hep_ring_pkt *b)
+{
+	return a->transport == b->transport && a->port == b->port &&
+		a->send_sock == b->send_sock && a->host_len == b->host_len &&
+		!memcmp(a->data, b->data, a->host_len);
+}
+
+static inline char *hep_pkt_buf(struct hep_ring_pkt *pkt)
+{
+	return pkt->data + pkt->host_len;
+}
+
+static int hep_udp_wait(int fd)
+{
+	struct pollfd pfd;
+	int n;
+
+	pfd.fd = fd;
+	pfd.events = POLLOUT;
+again:
+	n = poll(&pfd, 1, HEP_UDP_WAIT_MS);
+	if (n < 0 && errno == EINTR)
+		goto again;
+
+	return n > 0 ? 0 : -1;
+}
+
+/* returns the number of packets done with (sent, or failed for good) */
+static int hep_send_udp_batch(struct socket_info *send_sock,
+		union sockaddr_union *to, struct hep_ring_pkt **pkts, int n)
+{
+	int i, done = 0, ret, err;
+
+	if (!send_sock)
+		send_sock = get_send_socket(0, to, PROTO_HEP_UDP);
+	if (!send_sock) {
+		LM_ERR("no sending socket found for hep_udp\n");
+		return 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		batch_iov[i].iov_base = hep_pkt_buf(pkts[i]);
+		batch_iov[i].iov_len = pkts[i]->len;
+
+		memset(&batch_msgs[i], 0, sizeof *batch_msgs);
+		batch_msgs[i].msg_hdr.msg_name = &to->s;
+		batch_msgs[i].msg_hdr.msg_namelen = sockaddru_len(*to);
+		batch_msgs[i].msg_hdr.msg_iov = &batch_iov[i];
+		batch_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while (done < n) {
+		ret = sendmmsg(send_sock->socket, batch_msgs + done, n - done, 0);
+		if (ret >= 0) {
+			update_stat(hep_trace_sent, ret);
+			done += ret;
+			continue;
+		}
+
+		err = errno;
+		if (err == EINTR)
+			continue;
+		if ((err == EAGAIN || err == EWOULDBLOCK) &&
+				hep_udp_wait(send_sock->socket) == 0)
+			continue;
+
+		LM_ERR("sendmmsg() failed: %s(%d)\n", strerror(err), err);
+		if (err != EMSGSIZE)
+			break;
+
+		/* only this packet is bad - skip it */
+		update_stat(hep_trace_failed, 1);
+		done++;
+	}
+
+	return done;
+}
+
+/* returns the number of packets done with (sent, or failed for good) */
+static int hep_send_tcp_batch(struct socket_info *send_sock,
+		union sockaddr_union *to, struct hep_ring_pkt **pkts, int n)
+{
+	unsigned int len = 0;
+	char *buf;
+	int i;
+
+	for (i = 0; i < n; i++)
+		len += pkts[i]->len;
+
+	if (len > tcp_buf_size) {
+		buf = pkg_realloc(tcp_buf, len);
+		if (!buf) {
+			LM_ERR("no more pkg memory\n");
+			return 0;
+		}
+		tcp_buf = buf;
+		tcp_buf_size = len;
+	}
+
+	/* coalesce all the packets into a single write */
+	for (buf = tcp_buf, i = 0; i < n; i++) {
+		memcpy(buf, hep_pkt_buf(pkts[i]), pkts[i]->len);
+		buf += pkts[i]->len;
+	}
+
+	if (msg_send(send_sock, PROTO_HEP_TCP, to, 0, tcp_buf, len, NULL) < 0)
+		return 0;
+
+	update_stat(hep_trace_sent, n);
+	return n;
+}
+
+/* sends @n packets, all having the same destination */
+static void hep_send_group(struct hep_ring_pkt **pkts, int n)
+{
+	struct hep_ring_pkt *pkt = pkts[0];
+	union sockaddr_union to;
+	struct proxy_l *p;
+	str host;
+	int done = 0;
+
+	host.s = pkt->data;
+	host.len = pkt->host_len;
+
+	p = mk_proxy(&host, pkt->port ? pkt->port : HEP_PORT, pkt->transport, 0);
+	if (!p) {
+		LM_ERR("bad hep host name <%.*s>!\n", host.len, host.s);
+		goto end;
+	}
+
+	hostent2su(&to, &p->host, p->addr_idx, p->port ? p->port : HEP_PORT);
+
+	do {
+		if (pkt->transport == PROTO_HEP_UDP)
+			done += hep_send_udp_batch(pkt->send_sock, &to, pkts + done,
+				n - done);
+		else
+			done += hep_send_tcp_batch(pkt->send_sock, &to, pkts + done,
+				n - done);
+		if (done == n)
+			break;
+		LM_ERR("Cannot send hep message!\n");
+	} while (get_next_su(p, &to, 0) == 0);
+
+	free_proxy(p);
+	pkg_free(p);
+
+end:
+	if (done < n)
+		update_stat(hep_trace_failed, n - done);
+}
+
+static void hep_send_batch(struct hep_ring_pkt **pkts, int n)
+{
+	int i, start;
+
+	for (start = 0, i = 1; i <= n; i++)
+		if (i == n || !hep_pkt_same_dest(pkts[start], pkts[i])) {
+			hep_send_group(pkts + start, i - start);
+			start = i;
+		}
+}
+
+static void hep_ring_job(int sender, void *param)
+{
+	struct hep_ring_pkt *pkt;
+	unsigned int head, pos, off, room;
+	int n, busy = 0;
+
+	/* any packet queued from now on signals us again */
+	ring->wakeup = 0;
+	__sync_synchronize();
+
+	/* only drain what is already queued, so we do not get stuck here */
+	head = ring->head;
+	pos = ring->tail;
+	__sync_synchronize();
+
+	while (pos != head && !busy) {
+		for (n = 0; pos != head && n < hep_trace_batch_size; ) {
+			off = pos & ring->mask;
+			room = ring->size - off;
+			if (room < sizeof *pkt) {
+				pos += room;
+				continue;
+			}
+
+			pkt = ring_pkt(off);
+			if (pkt->state == HEP_PKT_WRAP) {
+				pos += pkt->size;
+				continue;
+			}
+
+			/* still being written - the worker will signal us */
+			if (pkt->state != HEP_PKT_READY) {
+				busy = 1;
+				break;
+			}
+
+			batch[n++] = pkt;
+			pos += pkt->size;
+		}
+		__sync_synchronize();
+
+		if (n)
+			hep_send_batch(batch, n);
+
+		/* release the sent packets */
+		__sync_synchronize();
+		ring->tail = pos;
+	}
+}
+
+
+void hep_trace_process(int rank)
+{
+	batch = pkg_malloc(hep_trace_batch_size *
+		(sizeof *batch + sizeof *batch_msgs + sizeof *batch_iov));
+	if (!batch) {
+		LM_ERR("no more pkg memory\n");
+		return;
+	}
+	batch_msgs = (struct mmsghdr *)(batch + hep_trace_batch_size);
+	batch_iov = (struct iovec *)(batch_msgs + hep_trace_batch_size);
+
+	if (reactor_proc_init("HEP tracer") < 0) {
+		LM_ERR("failed to init the HEP tracing process\n");
+		return;
+	}
+
+	ring->proc_no = process_no;
+
+	reactor_proc_loop();
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2021 - OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * HEP sending queue
+ *
+ * The workers gather the HEP packets straight into a shm ring, which is
+ * drained by a dedicated tracing process. The tracing process sends the
+ * packets in batches, grouped by destination: with sendmmsg() over UDP and
+ * with a single (coalesced) write over TCP.
+ */
+
+#ifndef _HEP_RING_H
+#define _HEP_RING_H
+
+#include <sys/uio.h>
+
+#include "../../socket_info.h"
+#include "../../statistics.h"
+#include "hep.h"
+
+extern int hep_trace_queue_size;
+extern int hep_trace_batch_size;
+
+extern stat_var *hep_trace_dropped;
+extern stat_var *hep_trace_sent;
+extern stat_var *hep_trace_failed;
+
+/* to be called from mod_init(), only if the queue is enabled */
+int hep_ring_init(void);
+void hep_ring_destroy(void);
+
+/* the tracing process */
+void hep_trace_process(int rank);
+
+/* tells if the packets are to be queued or sent right away (the tracing
+ * process is not running yet, or it is the current process) */
+int hep_ring_active(void);
+
+/* queues the packet described by @iov, for @dest; returns -1 if the
+ * packet was dropped */
+int hep_ring_push(hid_list_p dest, struct socket_info *send_sock,
+		const struct iovec *iov, int iovcnt, int len);
+
+unsigned long hep_ring_used(void *foo);
+
+#endif
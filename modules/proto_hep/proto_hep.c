@@ -45,6 +45,7 @@
 #include "../compression/compression_api.h"
 #include "hep.h"
 #include "hep_cb.h"
+#include "hep_ring.h"
 
 
 
@@ -123,9 +124,24 @@ static param_export_t params[] = {
 	{ "hep_id",						 STR_PARAM|USE_FUNC_PARAM, parse_hep_id },
 	{ "homer5_on",						 INT_PARAM, &homer5_on              },
 	{ "homer5_delim",					 STR_PARAM, &homer5_delim.s },
+	{ "trace_queue_size",				 INT_PARAM, &hep_trace_queue_size   },
+	{ "trace_batch_size",				 INT_PARAM, &hep_trace_batch_size   },
 	{0, 0, 0}
 };
 
+static stat_export_t mod_stats[] = {
+	{"trace_queued_bytes", STAT_IS_FUNC, (stat_var**)hep_ring_used},
+	{"trace_sent",         0,            &hep_trace_sent            },
+	{"trace_send_failed",  0,            &hep_trace_failed          },
+	{"trace_dropped",      0,            &hep_trace_dropped         },
+	{0, 0, 0}
+};
+
+static proc_export_t procs[] = {
+	{"HEP tracer", 0, 0, hep_trace_process, 0, PROC_FLAG_HAS_IPC},
+	{0,0,0,0,0,0}
+};
+
 
 static module_dependency_t *get_deps_compression(param_export_t *param)
 {
@@ -160,11 +176,11 @@ struct module_exports exports = {
 	cmds,       /* exported functions */
 	0,          /* exported async functions */
 	params,     /* module parameters */
-	0,          /* exported statistics */
+	mod_stats,  /* exported statistics */
 	0,          /* exported MI functions */
 	0,          /* exported pseudo-variables */
 	0,			/* exported transformations */
-	0,          /* extra processes */
+	procs,      /* extra processes */
 	0,          /* module pre-initialization function */
 	mod_init,   /* module initialization function */
 	0,          /* response function */
@@ -200,6 +216,15 @@ static int mod_init(void)
 		}
 	}
 
+	/* the traced packets are sent by a dedicated process */
+	if (hep_trace_queue_size > 0) {
+		if (hep_ring_init() < 0) {
+			LM_ERR("failed to init the HEP sending queue\n");
+			return -1;
+		}
+		procs[0].no = 1;
+	}
+
 	hep_ctx_idx = context_register_ptr(CONTEXT_GLOBAL, 0);
 	homer5_delim.len = strlen(homer5_delim.s);
 
@@ -214,6 +239,7 @@ static void destroy(void)
 {
 	free_hep_cbs();
 	destroy_hep_id();
+	hep_ring_destroy();
 }
 
 void free_hep_context(void *ptr)
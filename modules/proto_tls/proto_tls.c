@@ -340,7 +340,7 @@ static int proto_tls_init(struct proto_info *pi)
 	pi->tran.send			= proto_tls_send;
 	pi->tran.dst_attr		= tcp_conn_fcntl;
 
-	pi->net.flags			= PROTO_NET_USE_TCP;
+	pi->net.flags			= PROTO_NET_USE_TCP|PROTO_NET_USE_HANDSHAKE;
 	pi->net.read			= (proto_net_read_f)tls_read_req;
 	pi->net.write			= (proto_net_write_f)tls_async_write;
 	pi->net.conn_init		= proto_tls_conn_init;
@@ -651,6 +651,12 @@ static int tls_read_req(struct tcp_connection* con, int* bytes_read)
 		return 0;
 	}
 
+	/* the handshake workers only get new connections - once the accept
+	 * is done (no matter by which process), the connection is to be passed
+	 * to a SIP worker */
+	if (tcp_handshake_worker && (con->flags & F_CONN_ACCEPTED))
+		con->proto_flags |= F_TLS_HANDOVER;
+
 	/* if there is pending tracing data on an accepted connection, flush it
 	 * As this is a read op, we look only for accepted conns, not to conflict
 	 * with connected conns (flushed on write op) */
@@ -732,6 +738,15 @@ again:
 
 	LM_DBG("tls_read_req end\n");
 done:
+	/* a handshake worker is done with the connection once the handshake
+	 * completed and any SIP data that came along with it was processed
+	 * (no partial message is left in the per connection buffer) */
+	if ((con->proto_flags & F_TLS_HANDOVER) && con->state==S_CONN_OK &&
+	con->con_req==NULL) {
+		con->proto_flags &= ~F_TLS_HANDOVER;
+		con->flags |= F_CONN_HANDOVER;
+	}
+
 	if (bytes_read) *bytes_read=total_bytes;
 	/* connection will be released */
 	return 0;
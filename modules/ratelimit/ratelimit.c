@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <regex.h>
 #include <math.h>
+#include <time.h>
 
 #include "../../sr_module.h"
 #include "../../mem/mem.h"
@@ -242,6 +243,8 @@ struct {
 	{ str_init("FEEDBACK"), PIPE_ALGO_FEEDBACK},
 	{ str_init("NETWORK"), PIPE_ALGO_NETWORK},
 	{ str_init("SBT"), PIPE_ALGO_HISTORY},
+	{ str_init("GCRA"), PIPE_ALGO_GCRA},
+	{ str_init("SLIDING"), PIPE_ALGO_SLIDING},
 	{
 		{ 0, 0}, 0
 	},
@@ -612,6 +615,161 @@ void hist_set_count(rl_pipe_t *pipe, long int value)
 }
 
 
+/*
+ * GCRA and SLIDING keep their whole state in a single 64 bit word, updated
+ * with compare-and-swap, so the checks are done without holding the lock
+ * of the pipe and without any reset done by the timer (no bursts at the
+ * edge of the intervals).
+ *
+ * GCRA: the word is the theoretical arrival time (usec) of the next
+ *   request; each accepted request pushes it by period/limit and requests
+ *   are refused if it would get more than one period ahead of now
+ * SLIDING: the word packs the index of the current window with the counts
+ *   of the current and of the previous window; the previous one is weighted
+ *   with the part of it still covered by the window sliding over now
+ */
+
+#define SW_WIN_BITS		20
+#define SW_CNT_BITS		22
+#define SW_WIN_MASK		((1ULL << SW_WIN_BITS) - 1)
+#define SW_CNT_MAX		((1ULL << SW_CNT_BITS) - 1)
+
+#define SW_WIN(_s)		((_s) >> (2 * SW_CNT_BITS))
+#define SW_PREV(_s)		(((_s) >> SW_CNT_BITS) & SW_CNT_MAX)
+#define SW_CUR(_s)		((_s) & SW_CNT_MAX)
+#define SW_STATE(_w, _p, _c) \
+	((((_w) & SW_WIN_MASK) << (2 * SW_CNT_BITS)) | ((_p) << SW_CNT_BITS) | (_c))
+
+#define RL_CAS(_p, _old, _new) \
+	(__sync_val_compare_and_swap(&(_p)->state, _old, _new) == (_old))
+
+/* the same clock in all the processes */
+static inline unsigned long long rl_now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* the period the limit of the pipe applies to */
+static inline unsigned long long rl_period_us(void)
+{
+	return (rl_limit_per_interval ? rl_timer_interval : 1) * 1000000ULL;
+}
+
+static int gcra_update(rl_pipe_t *pipe, int n, int check)
+{
+	unsigned long long now, period, t, tat, old, new;
+
+	period = rl_period_us();
+	t = period / pipe->limit;
+	if (!t)
+		t = 1;
+	now = rl_now_us();
+
+	do {
+		old = pipe->state;
+		tat = old > now ? old : now;
+
+		if (n >= 0) {
+			new = tat + n * t;
+			if (check && new - now > period)
+				return -1;
+		} else {
+			new = (tat - now > -n * t) ? tat - -n * t : now;
+		}
+	} while (!RL_CAS(pipe, old, new));
+
+	return 1;
+}
+
+static int sliding_update(rl_pipe_t *pipe, int n, int check)
+{
+	unsigned long long now, period, win, prev, cur, old, new, estimate;
+
+	period = rl_period_us();
+	now = rl_now_us();
+	win = (now / period) & SW_WIN_MASK;
+
+	do {
+		old = pipe->state;
+		prev = SW_PREV(old);
+		cur = SW_CUR(old);
+
+		if (SW_WIN(old) != win) {
+			/* the current window moved since the last update */
+			prev = (SW_WIN(old) == ((win - 1) & SW_WIN_MASK)) ? cur : 0;
+			cur = 0;
+		}
+
+		if (n >= 0) {
+			estimate = prev * (period - now % period) / period + cur + n;
+			if (check && estimate > pipe->limit)
+				return -1;
+			cur = (cur + n > SW_CNT_MAX) ? SW_CNT_MAX : cur + n;
+		} else {
+			cur = (cur > -n) ? cur + n : 0;
+		}
+
+		new = SW_STATE(win, prev, cur);
+	} while (!RL_CAS(pipe, old, new));
+
+	return 1;
+}
+
+/**
+ * accounts n requests (or releases -n of them) in a GCRA or SLIDING pipe
+ *
+ * @param check  refuse the requests if they do not fit in the limit
+ * @return -1 if the requests were refused, 1 if accounted
+ */
+int rl_atomic_update(rl_pipe_t *pipe, int n, int check)
+{
+	if (pipe->limit <= 0)
+		return (check && n > 0) ? -1 : 1;
+
+	if (pipe->algo == PIPE_ALGO_GCRA)
+		return gcra_update(pipe, n, check);
+	return sliding_update(pipe, n, check);
+}
+
+/* the number of requests currently accounted in the pipe */
+int rl_atomic_count(rl_pipe_t *pipe)
+{
+	unsigned long long now, period, t, state, win;
+
+	if (pipe->limit <= 0)
+		return 0;
+
+	period = rl_period_us();
+	now = rl_now_us();
+	state = pipe->state;
+
+	if (pipe->algo == PIPE_ALGO_GCRA) {
+		if (state <= now)
+			return 0;
+		t = period / pipe->limit;
+		if (!t)
+			t = 1;
+		return (state - now + t - 1) / t;
+	}
+
+	win = (now / period) & SW_WIN_MASK;
+	if (SW_WIN(state) == win)
+		return SW_PREV(state) * (period - now % period) / period +
+			SW_CUR(state);
+	if (SW_WIN(state) == ((win - 1) & SW_WIN_MASK))
+		return SW_CUR(state) * (period - now % period) / period;
+	return 0;
+}
+
+void rl_atomic_reset(rl_pipe_t *pipe)
+{
+	__sync_lock_test_and_set(&pipe->state, 0);
+}
+
+
 /**
  * runs the pipe's algorithm
  * (expects rl_lock to be taken)
@@ -624,6 +782,15 @@ int rl_pipe_check(rl_pipe_t *pipe)
 	if (pipe->algo == PIPE_ALGO_HISTORY)
 		return (hist_update(pipe, 1) > pipe->limit ? -1 : 1);
 
+	if (RL_ALGO_ATOMIC(pipe->algo)) {
+		if (rl_atomic_update(pipe, 1, 1) < 0)
+			return -1;
+		/* only the accepted requests are replicated */
+		if (pipe->flags & RL_PIPE_REPLICATE_BIN)
+			__sync_fetch_and_add(&pipe->repl_delta, 1);
+		return 1;
+	}
+
 	counter = rl_get_all_counters(pipe);
 
 	switch (pipe->algo) {
@@ -893,6 +1060,7 @@ mi_response_t *mi_dump_pipe(const mi_params_t *params,
 	unsigned int hash_idx;  //var to hold hash index 
 	rl_pipe_t **pipe;		//pipe object we're looking at.
 	int pipe_total = 0; 	//hold total of all buckets + nodes.
+	int counter;			//local counter of the pipe
 	
 	str *alg; 				//var to hold alg name
 	
@@ -934,6 +1102,10 @@ mi_response_t *mi_dump_pipe(const mi_params_t *params,
 		goto error;
 	//Start building response:
 	
+	//The atomic pipes keep no counter, it is derived from their state.
+	counter = RL_ALGO_ATOMIC((*pipe)->algo) ?
+		rl_atomic_count(*pipe) : (*pipe)->counter;
+	
 	//We know how to handle SBT 
 	if ((*pipe)->algo == PIPE_ALGO_HISTORY) {
 		window_item = add_mi_object(resp_obj, MI_SSTR("Window"));
@@ -1003,7 +1175,7 @@ mi_response_t *mi_dump_pipe(const mi_params_t *params,
 		
 	} else {
 		//For non-SBT pipes, we just add the counter.
-		pipe_total += (*pipe)->counter;
+		pipe_total += counter;
 	}
 	/************* End Bucket Loop ***************/
 	
@@ -1019,7 +1191,7 @@ mi_response_t *mi_dump_pipe(const mi_params_t *params,
 	else if (add_mi_string(resp_obj, MI_SSTR("Algorithm"), alg->s, alg->len) < 0) 
 		goto error;	
 	
-	if (add_mi_number(resp_obj, MI_SSTR("Counter"), (*pipe)->counter) < 0)
+	if (add_mi_number(resp_obj, MI_SSTR("Counter"), counter) < 0)
 		goto error;
 	
 	nodes_arr = add_mi_array(resp_obj, MI_SSTR("Replication Nodes"));
@@ -58,9 +58,15 @@ typedef enum {
 	PIPE_ALGO_RED,
 	PIPE_ALGO_FEEDBACK,
 	PIPE_ALGO_NETWORK,
-	PIPE_ALGO_HISTORY
+	PIPE_ALGO_HISTORY,
+	PIPE_ALGO_GCRA,
+	PIPE_ALGO_SLIDING
 } rl_algo_t;
 
+/* algorithms keeping their whole state in one word, updated lock-less */
+#define RL_ALGO_ATOMIC(_a) \
+	((_a) == PIPE_ALGO_GCRA || (_a) == PIPE_ALGO_SLIDING)
+
 typedef struct rl_repl_counter {
 	int counter;
 	time_t update;
@@ -95,6 +101,8 @@ typedef struct rl_pipe {
 	time_t last_local_used;		/* timestamp when the pipe was last locally accessed */
 	rl_repl_counter_t *dsts;	/* counters per destination */
 	rl_window_t rwin;			/* window of requests */
+	volatile unsigned long long state;	/* GCRA and SLIDING state word */
+	volatile int repl_delta;	/* accepted, but not replicated yet */
 } rl_pipe_t;
 
 typedef struct rl_repl_dst {
@@ -164,6 +172,10 @@ int rl_add_repl_dst(modparam_t type, void *val);
 void hist_set_count(rl_pipe_t *pipe, long int value);
 int hist_get_count(rl_pipe_t *pipe);
 
+int rl_atomic_update(rl_pipe_t *pipe, int n, int check);
+int rl_atomic_count(rl_pipe_t *pipe);
+void rl_atomic_reset(rl_pipe_t *pipe);
+
 #define RL_PIPE_COUNTER		0
 #define RL_EXPIRE_TIMER		10
 #define RL_BUF_THRESHOLD	32767
@@ -84,7 +84,7 @@ static str pipe_repl_cap = str_init("ratelimit-pipe-repl");
 /* returns true if the pipe should use cachedb interface */
 #define RL_USE_CDB(_p) \
 	(cdbc && (_p)->algo!=PIPE_ALGO_NETWORK && \
-	 (_p)->algo!=PIPE_ALGO_FEEDBACK && \
+	 (_p)->algo!=PIPE_ALGO_FEEDBACK && !RL_ALGO_ATOMIC((_p)->algo) && \
 	 (_p)->flags&RL_PIPE_REPLICATE_CACHE)
 
 #define RL_USE_BIN(_p) \
@@ -284,6 +284,8 @@ struct {
 	{ str_init("FEEDBACK"), PIPE_ALGO_FEEDBACK},
 	{ str_init("NETWORK"), PIPE_ALGO_NETWORK},
 	{ str_init("SBT"), PIPE_ALGO_HISTORY},
+	{ str_init("GCRA"), PIPE_ALGO_GCRA},
+	{ str_init("SLIDING"), PIPE_ALGO_SLIDING},
 	{
 		{ 0, 0}, 0
 	},
@@ -332,9 +334,9 @@ rl_pipe_t *rl_create_pipe(int limit, rl_algo_t algo, str *name, unsigned flags)
 			flags &= ~RL_PIPE_REPLICATE_CACHE;
 		}
 		if (algo == PIPE_ALGO_NETWORK ||
-				algo == PIPE_ALGO_FEEDBACK) {
+				algo == PIPE_ALGO_FEEDBACK || RL_ALGO_ATOMIC(algo)) {
 			LM_WARN("cachedb replication not possible for "
-					"NETWORK and FEEDBACK algorithms!\n");
+					"NETWORK, FEEDBACK, GCRA and SLIDING algorithms!\n");
 			flags &= ~RL_PIPE_REPLICATE_CACHE;
 		}
 	}
@@ -404,7 +406,7 @@ int w_rl_check(struct sip_msg *_m, str *name, int *limit, str *algorithm)
 {
 	int ret = 1, should_update = 0;
 	unsigned int hash_idx;
-	rl_pipe_t **pipe;
+	rl_pipe_t **pipe, *p;
 	str pipe_name;
 	unsigned flags;
 
@@ -479,6 +481,19 @@ int w_rl_check(struct sip_msg *_m, str *name, int *limit, str *algorithm)
 	(*pipe)->last_used = time(0);
 	/* set the last 'local' used time: */
 	(*pipe)->last_local_used = time(0);
+
+	if (RL_ALGO_ATOMIC((*pipe)->algo)) {
+		/* no need to hold the lock while checking: the state is updated
+		 * atomically and, as just used, the pipe cannot expire meanwhile */
+		p = *pipe;
+		RL_RELEASE_LOCK(hash_idx);
+
+		ret = rl_pipe_check(p);
+		LM_DBG("Pipe %.*s limit:%d should %sbe blocked (%p)\n",
+			pipe_name.len, pipe_name.s, p->limit, ret == 1 ? "NOT " : "", p);
+		goto end;
+	}
+
 	if (RL_USE_CDB(*pipe)) {
 		/* release the counter for a while */
 		if (rl_change_counter(&pipe_name, *pipe, 1) < 0) {
@@ -576,6 +591,12 @@ void rl_timer(unsigned int ticks, void *param)
 					shm_free(value);
 				continue;
 			} else {
+				/* nothing to reset, the state slides by itself */
+				if (RL_ALGO_ATOMIC((*pipe)->algo)) {
+					(*pipe)->last_counter = rl_atomic_count(*pipe);
+					goto next_pipe;
+				}
+
 				/* leave the lock if a cachedb query should be done*/
 				if (RL_USE_CDB(*pipe)) {
 					if (rl_get_counter(key, *pipe) < 0) {
@@ -655,7 +676,9 @@ static int rl_map_print(void *param, str key, void *value)
 	if (add_mi_number(pipe_item, MI_SSTR("limit"), pipe->limit) < 0)
 		return -1;
 
-	if (add_mi_number(pipe_item, MI_SSTR("counter"), pipe->last_counter) < 0)
+	if (add_mi_number(pipe_item, MI_SSTR("counter"),
+			RL_ALGO_ATOMIC(pipe->algo) ? rl_atomic_count(pipe) :
+			pipe->last_counter) < 0)
 		return -1;
 
 	return 0;
@@ -784,6 +807,11 @@ int w_rl_set_count(str key, int val)
 		}
 	} else if ((*pipe)->algo == PIPE_ALGO_HISTORY) {
 		hist_set_count(*pipe, val);
+	} else if (RL_ALGO_ATOMIC((*pipe)->algo)) {
+		if (val)
+			rl_atomic_update(*pipe, val, 0);
+		else
+			rl_atomic_reset(*pipe);
 	} else {
 		if (val && (val + (*pipe)->counter >= 0)) {
 			(*pipe)->counter += val;
@@ -927,6 +955,16 @@ void rl_rcv_bin(bin_packet_t *packet)
 		}
 		/* set the last used time */
 		(*pipe)->last_used = time(0);
+
+		/* the node sent what it accepted since its last replication */
+		if (RL_ALGO_ATOMIC((*pipe)->algo)) {
+			if (counter > 0)
+				rl_atomic_update(*pipe, counter, 0);
+			RL_DBG(*pipe, "delta=%d id=%d", counter, packet->src_id);
+			RL_RELEASE_LOCK(hash_idx);
+			continue;
+		}
+
 		/* set the destination's counter */
 		destination = find_destination(*pipe, packet->src_id);
 		if (!destination)
@@ -1036,6 +1074,7 @@ void rl_timer_repl(utime_t ticks, void *param)
 	str *key;
 	int nr = 0;
 	int ret = 0;
+	int counter;
 	bin_packet_t packet;
 	time_t now = time(0);
 
@@ -1086,13 +1125,18 @@ void rl_timer_repl(utime_t ticks, void *param)
 
 			/*
 			 * for the SBT algorithm it is safe to replicate the current
-			 * counter, since it is always updating according to the window
+			 * counter, since it is always updating according to the window;
+			 * GCRA and SLIDING only send the requests accepted since the
+			 * last replication, to be accounted by the other nodes as well
 			 */
-			RL_DBG(*pipe, "replicate=%d", ((*pipe)->algo == PIPE_ALGO_HISTORY ?
-						 (*pipe)->counter : (*pipe)->my_last_counter));
-			if ((ret = bin_push_int(&packet,
-						((*pipe)->algo == PIPE_ALGO_HISTORY ?
-						 (*pipe)->counter : (*pipe)->my_last_counter))) < 0)
+			if (RL_ALGO_ATOMIC((*pipe)->algo))
+				counter = __sync_lock_test_and_set(&(*pipe)->repl_delta, 0);
+			else if ((*pipe)->algo == PIPE_ALGO_HISTORY)
+				counter = (*pipe)->counter;
+			else
+				counter = (*pipe)->my_last_counter;
+			RL_DBG(*pipe, "replicate=%d", counter);
+			if ((ret = bin_push_int(&packet, counter)) < 0)
 				goto error;
 			nr++;
 
@@ -1162,6 +1206,8 @@ int rl_get_counter_value(str *key)
 		}
 	} else if ((*pipe)->algo == PIPE_ALGO_HISTORY)
 		ret = hist_get_count(*pipe);
+	else if (RL_ALGO_ATOMIC((*pipe)->algo))
+		ret = rl_atomic_count(*pipe);
 	else
 		ret = rl_get_all_counters(*pipe);
 
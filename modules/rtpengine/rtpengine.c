@@ -40,11 +40,13 @@
 #include <sys/un.h>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <netdb.h>
 #include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "../../str.h"
@@ -75,6 +77,8 @@
 #include "../../mod_fix.h"
 #include "../../dset.h"
 #include "../../route.h"
+#include "../../async.h"
+#include "../../lib/timerfd.h"
 #include "../../modules/tm/tm_load.h"
 #include "../../modules/dialog/dlg_load.h"
 #include "../../lib/cJSON.h"
@@ -256,6 +260,11 @@ static const str stat_maps[] = {
 	[STAT_PACKETLOSS_MAX_AT]	= str_init("packetloss-max-at")
 };
 
+static const unsigned int rtpe_lat_limits[RTPE_LAT_BUCKETS - 1] =
+	{1, 2, 5, 10, 50, 100, 500};
+static const char *rtpe_lat_names[RTPE_LAT_BUCKETS] =
+	{"1ms", "2ms", "5ms", "10ms", "50ms", "100ms", "500ms", "more"};
+
 static char *gencookie();
 static int rtpe_test(struct rtpe_node*, int, int);
 static int start_recording_f(struct sip_msg* msg, str *flags, pv_spec_t *spvar);
@@ -264,6 +273,14 @@ static int rtpengine_offer_f(struct sip_msg *msg, str *flags, pv_spec_t *spvar,
 		pv_spec_t *bpvar, str *body);
 static int rtpengine_answer_f(struct sip_msg *msg, str *flags, pv_spec_t *spvar,
 		pv_spec_t *bpvar, str *body);
+static int rtpengine_offer_async_f(struct sip_msg *msg, async_ctx *ctx,
+		str *flags, pv_spec_t *spvar, pv_spec_t *bpvar, str *body);
+static int rtpengine_answer_async_f(struct sip_msg *msg, async_ctx *ctx,
+		str *flags, pv_spec_t *spvar, pv_spec_t *bpvar, str *body);
+static int rtpengine_manage_async_f(struct sip_msg *msg, async_ctx *ctx,
+		str *flags, pv_spec_t *spvar, pv_spec_t *bpvar, str *body);
+static int rtpengine_delete_async_f(struct sip_msg *msg, async_ctx *ctx,
+		str *flags, pv_spec_t *spvar);
 static int rtpengine_manage_f(struct sip_msg *msg, str *flags, pv_spec_t *spvar,
 		pv_spec_t *bpvar, str *body);
 static int rtpengine_delete_f(struct sip_msg* msg, str *flags, pv_spec_t *spvar);
@@ -298,6 +315,9 @@ static int set_rtpengine_set_f(struct sip_msg * msg, rtpe_set_link_t *set_param)
 static struct rtpe_set * select_rtpe_set(int id_set);
 static struct rtpe_node *select_rtpe_node(str, struct rtpe_set *);
 static char *send_rtpe_command(struct rtpe_node *, bencode_item_t *, int *);
+struct rtpe_async_cmd;
+static int rtpe_async_send(struct rtpe_async_cmd *, struct rtpe_node *,
+		struct rtpe_set *, str *, bencode_item_t *);
 static int get_extra_id(struct sip_msg* msg, str *id_str);
 
 static int update_rtpengines(void);
@@ -458,6 +478,28 @@ static cmd_export_t cmds[] = {
 	{0,0,{{0,0,0}},0}
 };
 
+static acmd_export_t acmds[] = {
+	{"rtpengine_offer", (acmd_function)rtpengine_offer_async_f, {
+		{CMD_PARAM_STR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_VAR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_VAR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_STR | CMD_PARAM_OPT, 0, 0}, {0,0,0}}},
+	{"rtpengine_answer", (acmd_function)rtpengine_answer_async_f, {
+		{CMD_PARAM_STR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_VAR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_VAR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_STR | CMD_PARAM_OPT, 0, 0}, {0,0,0}}},
+	{"rtpengine_manage", (acmd_function)rtpengine_manage_async_f, {
+		{CMD_PARAM_STR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_VAR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_VAR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_STR | CMD_PARAM_OPT, 0, 0}, {0,0,0}}},
+	{"rtpengine_delete", (acmd_function)rtpengine_delete_async_f, {
+		{CMD_PARAM_STR | CMD_PARAM_OPT, 0, 0},
+		{CMD_PARAM_VAR | CMD_PARAM_OPT, 0, 0}, {0,0,0}}},
+	{0,0,{{0,0,0}}}
+};
+
 static int pv_rtpengine_stats_used(pv_spec_p sp, int param)
 {
 	rtpengine_stats_used = 1;
@@ -700,7 +742,7 @@ struct module_exports exports = {
 	0,				 /* load function */
 	&deps,           /* OpenSIPS module dependencies */
 	cmds,
-	0,
+	acmds,
 	params,
 	0,           /* exported statistics */
 	mi_cmds,     /* exported MI functions */
@@ -1092,9 +1134,10 @@ static mi_response_t *mi_show_rtpengines(const mi_params_t *params,
 								struct mi_handler *async_hdl)
 {
 	mi_response_t *resp;
-	mi_item_t *sets_arr, *set_item, *nodes_arr, *node_item;
+	mi_item_t *sets_arr, *set_item, *nodes_arr, *node_item, *lat_item;
 	struct rtpe_set * rtpe_list;
 	struct rtpe_node * crt_rtpe;
+	int i;
 
 	resp = init_mi_result_array(&sets_arr);
 	if (!resp)
@@ -1141,6 +1184,17 @@ static mi_response_t *mi_show_rtpengines(const mi_params_t *params,
 			if (add_mi_number(node_item, MI_RECHECK_TICKS, MI_RECHECK_T_LEN,
 				crt_rtpe->rn_recheck_ticks) < 0)
 				goto error;
+
+			lat_item = add_mi_object(node_item, MI_SSTR("latency"));
+			if (!lat_item)
+				goto error;
+			for (i = 0; i < RTPE_LAT_BUCKETS; i++)
+				if (add_mi_number(lat_item, (char *)rtpe_lat_names[i],
+					strlen(rtpe_lat_names[i]), crt_rtpe->rn_lat_hist[i]) < 0)
+					goto error;
+			if (add_mi_number(node_item, MI_SSTR("timeouts"),
+				crt_rtpe->rn_timeouts) < 0)
+				goto error;
 		}
 	}
 	RTPE_STOP_READ();
@@ -1454,22 +1508,19 @@ static int mi_child_init(void)
 	return 0;
 }
 
-static inline int rtpengine_connect_node(struct rtpe_node *pnode)
+/* resolves the address of an UDP node */
+static int rtpe_resolve_node(struct rtpe_node *pnode, union sockaddr_union *su,
+		socklen_t *su_len)
 {
 	int n;
 	char *cp;
 	char *hostname;
 	struct addrinfo hints, *res;
 
-	if (pnode->rn_umode == 0) {
-		rtpe_socks[pnode->idx] = -1;
-		return 1;
-	}
-
 	hostname = (char*)pkg_malloc(strlen(pnode->rn_address) + 1);
 	if (hostname==NULL) {
 		LM_ERR("no more pkg memory\n");
-		return 0;
+		return -1;
 	}
 	strcpy(hostname, pnode->rn_address);
 
@@ -1488,26 +1539,47 @@ static inline int rtpengine_connect_node(struct rtpe_node *pnode)
 	if ((n = getaddrinfo(hostname, cp, &hints, &res)) != 0) {
 		LM_ERR("%s\n", gai_strerror(n));
 		pkg_free(hostname);
-		return 0;
+		return -1;
 	}
 	pkg_free(hostname);
 
+	if (res->ai_addrlen > sizeof *su) {
+		LM_ERR("unexpected address length %d\n", (int)res->ai_addrlen);
+		freeaddrinfo(res);
+		return -1;
+	}
+	memcpy(su, res->ai_addr, res->ai_addrlen);
+	*su_len = res->ai_addrlen;
+	freeaddrinfo(res);
+	return 0;
+}
+
+static inline int rtpengine_connect_node(struct rtpe_node *pnode)
+{
+	union sockaddr_union su;
+	socklen_t su_len;
+
+	if (pnode->rn_umode == 0) {
+		rtpe_socks[pnode->idx] = -1;
+		return 1;
+	}
+
+	if (rtpe_resolve_node(pnode, &su, &su_len) < 0)
+		return 0;
+
 	rtpe_socks[pnode->idx] = socket((pnode->rn_umode == 6)
 			? AF_INET6 : AF_INET, SOCK_DGRAM, 0);
 	if ( rtpe_socks[pnode->idx] == -1) {
 		LM_ERR("can't create socket\n");
-		freeaddrinfo(res);
 		return 0;
 	}
 
-	if (connect(rtpe_socks[pnode->idx], res->ai_addr, res->ai_addrlen) == -1) {
+	if (connect(rtpe_socks[pnode->idx], &su.s, su_len) == -1) {
 		LM_ERR("can't connect to a RTP proxy\n");
 		close( rtpe_socks[pnode->idx] );
 		rtpe_socks[pnode->idx] = -1;
-		freeaddrinfo(res);
 		return 0;
 	}
-	freeaddrinfo(res);
 	return 1;
 }
 
@@ -2017,9 +2089,62 @@ static struct rtpe_node *get_rtpe_node(str *node, struct rtpe_set *set)
 }
 
 
-static bencode_item_t *rtpe_function_call(bencode_buffer_t *bencbuf, struct sip_msg *msg,
+static void rtpe_set_error(struct sip_msg *msg, str *error)
+{
+	pv_value_t val;
+
+	if (!err_pv_param)
+		return;
+
+	memset(&val, 0, sizeof(pv_value_t));
+	val.flags = PV_VAL_STR;
+	val.rs = *error;
+	if(pv_set_value(msg, &err_pv, (int)EQ_T, &val)<-1)
+		LM_ERR("setting rtpengine result pvar failed\n");
+}
+
+/* stores the selected node and decodes the reply of a command */
+static bencode_item_t *rtpe_function_reply(bencode_buffer_t *bencbuf,
+		struct sip_msg *msg, str *node_url, pv_spec_t *spvar, char *cp, int len)
+{
+	bencode_item_t *resp;
+	pv_value_t val;
+	str error;
+
+	/* store the value of the selected node */
+	if (spvar) {
+		memset(&val, 0, sizeof(pv_value_t));
+		val.flags = PV_VAL_STR;
+		val.rs = *node_url;
+		if(pv_set_value(msg, spvar, (int)EQ_T, &val)<0)
+			LM_ERR("setting rtpengine pvar failed\n");
+	}
+
+	resp = bencode_decode_expect(bencbuf, cp, len, BENCODE_DICTIONARY);
+	if (!resp) {
+		LM_ERR("failed to decode bencoded reply from proxy: %.*s\n", len, cp);
+		init_str(&error, "failed to decode bencoded reply");
+		rtpe_set_error(msg, &error);
+		return NULL;
+	}
+	if (!bencode_dictionary_get_strcmp(resp, "result", "error")) {
+		if (!bencode_dictionary_get_str(resp, "error-reason", &error)) {
+			LM_ERR("proxy return error but didn't give an error reason: %.*s\n",
+				len, cp);
+		} else {
+			LM_ERR("proxy replied with error: %.*s\n", error.len, error.s);
+			rtpe_set_error(msg, &error);
+		}
+		return NULL;
+	}
+
+	return resp;
+}
+
+static bencode_item_t *__rtpe_function_call(bencode_buffer_t *bencbuf, struct sip_msg *msg,
 	enum rtpe_operation op, str *flags_str, str *body_in, pv_spec_t *spvar,
-	struct rtpe_set *set, str *snode, bencode_item_t *extra_dict)
+	struct rtpe_set *set, str *snode, bencode_item_t *extra_dict,
+	struct rtpe_async_cmd *acmd)
 {
 	struct ng_flags_parse ng_flags;
 	bencode_item_t *item, *resp;
@@ -2027,7 +2152,6 @@ static bencode_item_t *rtpe_function_call(bencode_buffer_t *bencbuf, struct sip_
 	int ret;
 	struct rtpe_node *node;
 	char *cp, *err = NULL;
-	pv_value_t val;
 	str flags_nt = {0,0};
 
 	/*** get & init basic stuff needed ***/
@@ -2202,35 +2326,36 @@ static bencode_item_t *rtpe_function_call(bencode_buffer_t *bencbuf, struct sip_
 			goto error;
 		}
 
+		/* unix sockets are stream based, so they are only used in sync mode */
+		if (acmd && node->rn_umode != 0) {
+			ret = rtpe_async_send(acmd, node, set, &ng_flags.call_id,
+				ng_flags.dict);
+			if (ret == 0) {
+				RTPE_STOP_READ();
+				/* the reply is to be processed on resume */
+				if (flags_nt.s)
+					pkg_free(flags_nt.s);
+				return ng_flags.dict;
+			} else if (ret < -1) {
+				err = "failed to send async command";
+				RTPE_STOP_READ();
+				goto error;
+			}
+			/* the node was disabled, try another one */
+			cp = NULL;
+			continue;
+		}
+
 		cp = send_rtpe_command(node, ng_flags.dict, &ret);
 	} while (cp == NULL);
 	RTPE_STOP_READ();
 	LM_DBG("proxy reply: %.*s\n", ret, cp);
 
-	/* store the value of the selected node */
-	if (spvar) {
-		memset(&val, 0, sizeof(pv_value_t));
-		val.flags = PV_VAL_STR;
-		val.rs = node->rn_url;
-		if(pv_set_value(msg, spvar, (int)EQ_T, &val)<0)
-			LM_ERR("setting rtpengine pvar failed\n");
-	}
-
 	/*** process reply ***/
 
-	resp = bencode_decode_expect(bencbuf, cp, ret, BENCODE_DICTIONARY);
-	if (!resp) {
-		LM_ERR("failed to decode bencoded reply from proxy: %.*s\n", ret, cp);
-		err = "failed to decode bencoded reply";
-		goto error;
-	}
-	if (!bencode_dictionary_get_strcmp(resp, "result", "error")) {
-		if (!bencode_dictionary_get_str(resp, "error-reason", &error))
-			LM_ERR("proxy return error but didn't give an error reason: %.*s\n", ret, cp);
-		else
-			LM_ERR("proxy replied with error: %.*s\n", error.len, error.s);
+	resp = rtpe_function_reply(bencbuf, msg, &node->rn_url, spvar, cp, ret);
+	if (!resp)
 		goto error;
-	}
 
 	if (flags_nt.s)
 		pkg_free(flags_nt.s);
@@ -2244,18 +2369,22 @@ error:
 		LM_ERR("%s\n", err);
 		init_str(&error, err);
 	}
-	if (error.len && err_pv_param) {
-		memset(&val, 0, sizeof(pv_value_t));
-		val.flags = PV_VAL_STR;
-		val.rs = error;
-		if(pv_set_value(msg, &err_pv, (int)EQ_T, &val)<-1)
-			LM_ERR("setting rtpengine result pvar failed\n");
-	}
+	if (error.len)
+		rtpe_set_error(msg, &error);
 	if (bencbuf)
 		bencode_buffer_free(bencbuf);
 	return NULL;
 }
 
+static inline bencode_item_t *rtpe_function_call(bencode_buffer_t *bencbuf,
+	struct sip_msg *msg, enum rtpe_operation op, str *flags_str, str *body_in,
+	pv_spec_t *spvar, struct rtpe_set *set, str *snode,
+	bencode_item_t *extra_dict)
+{
+	return __rtpe_function_call(bencbuf, msg, op, flags_str, body_in, spvar,
+		set, snode, extra_dict, NULL);
+}
+
 static int
 set_rtpengine_set_from_avp(struct sip_msg *msg)
 {
@@ -2285,19 +2414,12 @@ set_rtpengine_set_from_avp(struct sip_msg *msg)
 }
 
 
-static int rtpe_function_call_simple(struct sip_msg *msg, enum rtpe_operation op,
-		str *flags_str, struct rtpe_set *set, str *node, pv_spec_t *spvar)
+/* releases the buffer of a successful command, unless the statistics
+ * returned by a delete are to be kept in the ctx */
+static void rtpe_function_done(bencode_buffer_t *bencbuf, bencode_item_t *ret,
+		enum rtpe_operation op)
 {
-	bencode_buffer_t bencbuf;
 	struct rtpe_ctx *ctx;
-	bencode_item_t *ret;
-
-	if (set_rtpengine_set_from_avp(msg) == -1)
-		return -1;
-
-	ret = rtpe_function_call(&bencbuf, msg, op, flags_str, NULL, spvar, set, node, NULL);
-	if (!ret)
-		return -1;
 
 	if (op == OP_DELETE && rtpengine_stats_used) {
 		/* if statistics are to be used, store stats in the ctx, if possible */
@@ -2307,17 +2429,33 @@ static int rtpe_function_call_simple(struct sip_msg *msg, enum rtpe_operation op
 			else
 				ctx->stats = pkg_malloc(sizeof *ctx->stats);
 			if (ctx->stats) {
-				ctx->stats->buf = bencbuf;
+				ctx->stats->buf = *bencbuf;
 				ctx->stats->dict = ret;
 				ctx->stats->json.s = 0;
 				/* return here to prevent buffer from being freed */
-				return 1;
+				return;
 			} else
 				LM_WARN("no more pkg memory - cannot cache stats!\n");
 		}
 	}
 
-	bencode_buffer_free(&bencbuf);
+	bencode_buffer_free(bencbuf);
+}
+
+static int rtpe_function_call_simple(struct sip_msg *msg, enum rtpe_operation op,
+		str *flags_str, struct rtpe_set *set, str *node, pv_spec_t *spvar)
+{
+	bencode_buffer_t bencbuf;
+	bencode_item_t *ret;
+
+	if (set_rtpengine_set_from_avp(msg) == -1)
+		return -1;
+
+	ret = rtpe_function_call(&bencbuf, msg, op, flags_str, NULL, spvar, set, node, NULL);
+	if (!ret)
+		return -1;
+
+	rtpe_function_done(&bencbuf, ret, op);
 	return 1;
 }
 
@@ -2397,6 +2535,32 @@ error:
 #define RTPENGINE_BUF_SIZE 0x10000
 #define OSIP_IOV_MAX 1024
 
+static inline unsigned long long rtpe_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* accounts the time (usec) it took a node to reply to a command */
+static void rtpe_update_latency(struct rtpe_node *node, unsigned long long usec)
+{
+	int i;
+
+	for (i = 0; i < RTPE_LAT_BUCKETS - 1; i++)
+		if (usec <= rtpe_lat_limits[i] * 1000ULL)
+			break;
+	__sync_fetch_and_add(&node->rn_lat_hist[i], 1);
+}
+
+static void rtpe_disable_node(struct rtpe_node *node)
+{
+	LM_ERR("proxy <%s> does not respond, disable it\n", node->rn_url.s);
+	node->rn_disabled = 1;
+	node->rn_recheck_ticks = get_ticks() + rtpengine_disable_tout;
+}
+
 static char *
 send_rtpe_command(struct rtpe_node *node, bencode_item_t *dict, int *outlen)
 {
@@ -2407,6 +2571,7 @@ send_rtpe_command(struct rtpe_node *node, bencode_item_t *dict, int *outlen)
 	static char buf[RTPENGINE_BUF_SIZE];
 	struct pollfd fds[1];
 	struct iovec *v;
+	unsigned long long start;
 
 	v = bencode_iovec(dict, &vcnt, 1, 0);
 	if (!v) {
@@ -2442,6 +2607,7 @@ send_rtpe_command(struct rtpe_node *node, bencode_item_t *dict, int *outlen)
 
 	len = 0;
 	cp = buf;
+	start = rtpe_now();
 	if (node->rn_umode == 0) {
 		memset(&addr, 0, sizeof(addr));
 		addr.sun_family = AF_LOCAL;
@@ -2542,93 +2708,610 @@ send_rtpe_command(struct rtpe_node *node, bencode_item_t *dict, int *outlen)
 		}
 		if (i == rtpengine_retr) {
 			LM_ERR("timeout waiting reply from a RTP proxy\n");
+			__sync_fetch_and_add(&node->rn_timeouts, 1);
 			goto badproxy;
 		}
 	}
 
 out:
+	rtpe_update_latency(node, rtpe_now() - start);
 	cp[len] = '\0';
 	*outlen = len;
 	return cp;
 badproxy:
-	LM_ERR("proxy <%s> does not respond, disable it\n", node->rn_url.s);
-	node->rn_disabled = 1;
-	node->rn_recheck_ticks = get_ticks() + rtpengine_disable_tout;
-
+	rtpe_disable_node(node);
 	return NULL;
 }
 
 /*
- * select the set with the id_set id
+ * Asynchronous control channel
+ *
+ * Each process sends its async commands over a single, unconnected UDP
+ * socket (one per address family), so any number of commands may be in
+ * flight at the same time; the replies are matched back to their commands
+ * by the cookie, which holds a per-process sequence number. A timer FD
+ * drives the retransmissions and the fail-over to the other nodes of the
+ * set, just like the blocking send_rtpe_command() does.
  */
 
-static struct rtpe_set * select_rtpe_set(int id_set )
+#define RTPE_ASYNC_HASH_SIZE	256
+#define RTPE_ASYNC_TICK			50 /* ms */
+#define RTPE_ASYNC_MAX_READS	64
+
+enum rtpe_async_state {
+	RTPE_ASYNC_INIT,
+	RTPE_ASYNC_PENDING,
+	RTPE_ASYNC_REPLIED,
+	RTPE_ASYNC_FAILED,
+};
+
+struct rtpe_async_cmd {
+	unsigned int seq;
+	enum rtpe_operation op;
+	enum rtpe_async_state state;
+
+	struct rtpe_set *set;
+	struct rtpe_node *node;		/* only valid for the same list version */
+	unsigned int version;
+	union sockaddr_union dst;
+	socklen_t dst_len;
+	str node_url;
+	str callid;					/* kept after the request, for fail-overs */
+
+	char *req;					/* cookie + bencoded command */
+	int req_len;
+	int tries;
+	unsigned long long start;	/* first sent to the current node */
+	unsigned long long sent;
+
+	char *reply;				/* starts after the cookie */
+	int reply_len;
+
+	pv_spec_t *spvar;
+	pv_spec_t *bpvar;
+	async_ctx *actx;
+
+	struct rtpe_async_cmd *next;
+};
+
+static struct rtpe_async_cmd *rtpe_async_cmds[RTPE_ASYNC_HASH_SIZE];
+static unsigned int rtpe_async_pending;
+static unsigned int rtpe_async_seq;
+static int rtpe_async_socks[2] = {-1, -1};
+static int rtpe_async_timer = -1;
+static int rtpe_async_timer_on;
+static char rtpe_async_cookie[24];
+static int rtpe_async_cookie_len;
+
+/* resolved addresses of the nodes, indexed by node->idx */
+struct rtpe_async_addr {
+	int resolved;
+	union sockaddr_union su;
+	socklen_t su_len;
+};
+static struct rtpe_async_addr *rtpe_async_addrs;
+static unsigned int rtpe_async_addrs_no;
+static unsigned int rtpe_async_addrs_version;
+
+static void rtpe_async_free(struct rtpe_async_cmd *cmd)
 {
+	if (cmd->req)
+		pkg_free(cmd->req);
+	if (cmd->reply)
+		pkg_free(cmd->reply);
+	if (cmd->node_url.s)
+		pkg_free(cmd->node_url.s);
+	pkg_free(cmd);
+}
 
-	struct rtpe_set * rtpe_list;
-	/*is it a valid set_id?*/
+static void rtpe_async_free_reply(void *p)
+{
+	pkg_free(p);
+}
 
-	if(!rtpe_set_list || !(*rtpe_set_list) || !(*rtpe_set_list)->rset_first)
-		return 0;
+static int rtpe_async_reply(int fd, void *param);
+static int rtpe_async_tick(int fd, void *param);
 
-	for(rtpe_list=(*rtpe_set_list)->rset_first; rtpe_list!=0 &&
-		rtpe_list->id_set!=id_set; rtpe_list=rtpe_list->rset_next);
-	if(!rtpe_list){
-		LM_DBG("no engine in set %d\n", id_set);
+static int rtpe_async_socket(int af)
+{
+	int *fd = (af == AF_INET6) ? &rtpe_async_socks[1] : &rtpe_async_socks[0];
+	int flags;
+
+	if (*fd >= 0)
+		return *fd;
+
+	*fd = socket(af, SOCK_DGRAM, 0);
+	if (*fd < 0) {
+		LM_ERR("can't create socket (%d:%s)\n", errno, strerror(errno));
+		return -1;
 	}
 
-	return rtpe_list;
+	flags = fcntl(*fd, F_GETFL);
+	if (flags == -1 || fcntl(*fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+		LM_ERR("failed to set O_NONBLOCK (%d:%s)\n", errno, strerror(errno));
+		goto error;
+	}
+
+	if (register_async_fd(*fd, rtpe_async_reply, NULL) < 0) {
+		LM_ERR("failed to register the rtpengine socket\n");
+		goto error;
+	}
+
+	return *fd;
+error:
+	close(*fd);
+	*fd = -1;
+	return -1;
 }
-/*
- * Main balancing routine. This does not try to keep the same proxy for
- * the call if some proxies were disabled or enabled; proxy death considered
- * too rare. Otherwise we should implement "mature" HA clustering, which is
- * too expensive here.
- */
-static struct rtpe_node *
-select_rtpe_node(str callid, struct rtpe_set *set)
+
+static int rtpe_async_start_timer(void)
 {
-	unsigned sum, weight_sum;
-	struct rtpe_node* node;
-	int was_forced, sumcut, found, constant_weight_sum;
+#ifdef HAVE_TIMER_FD
+	struct itimerspec its;
 
-	/* check last list version */
-	if (my_version != *list_version && update_rtpengines() < 0) {
-		LM_ERR("cannot update rtpengines list\n");
+	if (rtpe_async_timer_on)
 		return 0;
-	}
 
-	if(!set){
-		LM_ERR("script error -no valid set selected\n");
-		return NULL;
+	if (rtpe_async_timer < 0) {
+		rtpe_async_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+		if (rtpe_async_timer < 0) {
+			LM_ERR("failed to create timer FD (%d:%s)\n", errno, strerror(errno));
+			return -1;
+		}
+		if (register_async_fd(rtpe_async_timer, rtpe_async_tick, NULL) < 0) {
+			LM_ERR("failed to register the timer FD\n");
+			close(rtpe_async_timer);
+			rtpe_async_timer = -1;
+			return -1;
+		}
 	}
 
-	/* Most popular case: 1 proxy, nothing to calculate */
-	if (set->rtpe_node_count == 1) {
-		node = set->rn_first;
-		if (node->rn_disabled)
-			return NULL;
-		return node;
+	its.it_value.tv_sec = 0;
+	its.it_value.tv_nsec = RTPE_ASYNC_TICK * 1000000;
+	its.it_interval = its.it_value;
+	if (timerfd_settime(rtpe_async_timer, 0, &its, NULL) < 0) {
+		LM_ERR("failed to set timer FD (%d:%s)\n", errno, strerror(errno));
+		return -1;
 	}
 
-	/* XXX Use quick-and-dirty hashing algo */
-	for(sum = 0; callid.len > 0; callid.len--)
-		sum += callid.s[callid.len - 1];
-	sum &= 0xff;
+	rtpe_async_timer_on = 1;
+	return 0;
+#else
+	return -1;
+#endif
+}
 
-	was_forced = 0;
-	weight_sum = 0;
-	constant_weight_sum = 0;
-	found = 0;
-	for (node=set->rn_first; node!=NULL; node=node->rn_next) {
-		constant_weight_sum += node->rn_weight;
-		if (!node->rn_disabled) {
-			weight_sum += node->rn_weight;
-			found = 1;
+static void rtpe_async_stop_timer(void)
+{
+#ifdef HAVE_TIMER_FD
+	struct itimerspec its;
+
+	if (!rtpe_async_timer_on)
+		return;
+
+	memset(&its, 0, sizeof its);
+	if (timerfd_settime(rtpe_async_timer, 0, &its, NULL) < 0)
+		LM_ERR("failed to stop timer FD (%d:%s)\n", errno, strerror(errno));
+	rtpe_async_timer_on = 0;
+#endif
+}
+
+/* points the command to a new node; must be called under the read lock */
+static int rtpe_async_set_node(struct rtpe_async_cmd *cmd,
+		struct rtpe_node *node)
+{
+	struct rtpe_async_addr *addr;
+	char *url;
+
+	if (rtpe_async_addrs_version != *list_version) {
+		/* the nodes were reloaded, so their indexes are reused */
+		memset(rtpe_async_addrs, 0,
+			rtpe_async_addrs_no * sizeof *rtpe_async_addrs);
+		rtpe_async_addrs_version = *list_version;
+	}
+
+	if (node->idx >= rtpe_async_addrs_no) {
+		addr = pkg_realloc(rtpe_async_addrs, (node->idx + 1) * sizeof *addr);
+		if (!addr) {
+			LM_ERR("no more pkg memory\n");
+			return -1;
 		}
+		memset(addr + rtpe_async_addrs_no, 0,
+			(node->idx + 1 - rtpe_async_addrs_no) * sizeof *addr);
+		rtpe_async_addrs = addr;
+		rtpe_async_addrs_no = node->idx + 1;
 	}
-	if (found == 0) {
-			return NULL;
+
+	addr = &rtpe_async_addrs[node->idx];
+	if (!addr->resolved) {
+		if (rtpe_resolve_node(node, &addr->su, &addr->su_len) < 0)
+			return -1;
+		addr->resolved = 1;
+	}
+
+	url = pkg_malloc(node->rn_url.len + 1);
+	if (!url) {
+		LM_ERR("no more pkg memory\n");
+		return -1;
+	}
+	memcpy(url, node->rn_url.s, node->rn_url.len + 1);
+	if (cmd->node_url.s)
+		pkg_free(cmd->node_url.s);
+	cmd->node_url.s = url;
+	cmd->node_url.len = node->rn_url.len;
+
+	cmd->node = node;
+	cmd->version = *list_version;
+	cmd->dst = addr->su;
+	cmd->dst_len = addr->su_len;
+	cmd->tries = 0;
+	cmd->start = rtpe_now();
+	return 0;
+}
+
+static int rtpe_async_transmit(struct rtpe_async_cmd *cmd)
+{
+	int fd, len;
+
+	cmd->tries++;
+	cmd->sent = rtpe_now();
+
+	fd = rtpe_async_socket(cmd->dst.s.sa_family);
+	if (fd < 0)
+		return -1;
+
+	do {
+		len = sendto(fd, cmd->req, cmd->req_len, 0, &cmd->dst.s, cmd->dst_len);
+	} while (len == -1 && errno == EINTR);
+	if (len <= 0) {
+		LM_ERR("can't send command to RTP proxy <%.*s> (%d:%s)\n",
+			cmd->node_url.len, cmd->node_url.s, errno, strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+/* a failed send counts as a try, like in the blocking mode */
+static int rtpe_async_retransmit(struct rtpe_async_cmd *cmd)
+{
+	while (cmd->tries < rtpengine_retr)
+		if (rtpe_async_transmit(cmd) == 0)
+			return 0;
+
+	return -1;
+}
+
+static int rtpe_async_send_node(struct rtpe_async_cmd *cmd,
+		struct rtpe_node *node)
+{
+	if (rtpe_async_set_node(cmd, node) < 0)
+		return -1;
+
+	return rtpe_async_retransmit(cmd);
+}
+
+/*
+ * Starts an async command; must be called under the read lock
+ *
+ * Returns 0 if the command was sent, -1 if the node failed (it is disabled,
+ * so another one may be selected) or -2 on internal errors.
+ */
+static int rtpe_async_send(struct rtpe_async_cmd *cmd, struct rtpe_node *node,
+		struct rtpe_set *set, str *callid, bencode_item_t *dict)
+{
+	struct iovec *v;
+	int vcnt, i, len;
+	char *p;
+
+	if (!cmd->req) {
+		/* first node tried - build the datagram and the command */
+		v = bencode_iovec(dict, &vcnt, 1, 0);
+		if (!v) {
+			LM_ERR("error converting bencode to iovec\n");
+			return -2;
+		}
+
+		if (!rtpe_async_cookie_len)
+			rtpe_async_cookie_len = snprintf(rtpe_async_cookie,
+				sizeof rtpe_async_cookie, "%d_%d_a", (int)mypid, myrand);
+
+		for (len = 0, i = 1; i < vcnt; i++)
+			len += v[i].iov_len;
+		cmd->req = pkg_malloc(rtpe_async_cookie_len + INT2STR_MAX_LEN + 1 +
+			len + callid->len);
+		if (!cmd->req) {
+			LM_ERR("no more pkg memory\n");
+			return -2;
+		}
+
+		cmd->seq = rtpe_async_seq++;
+		p = cmd->req;
+		memcpy(p, rtpe_async_cookie, rtpe_async_cookie_len);
+		p += rtpe_async_cookie_len;
+		p += sprintf(p, "%u ", cmd->seq);
+		for (i = 1; i < vcnt; i++) {
+			memcpy(p, v[i].iov_base, v[i].iov_len);
+			p += v[i].iov_len;
+		}
+		cmd->req_len = p - cmd->req;
+
+		memcpy(p, callid->s, callid->len);
+		cmd->callid.s = p;
+		cmd->callid.len = callid->len;
+		cmd->set = set;
+	}
+
+	if (rtpe_async_send_node(cmd, node) < 0) {
+		rtpe_disable_node(node);
+		return -1;
+	}
+
+	if (rtpe_async_start_timer() < 0)
+		return -2;
+
+	cmd->state = RTPE_ASYNC_PENDING;
+	i = cmd->seq & (RTPE_ASYNC_HASH_SIZE - 1);
+	cmd->next = rtpe_async_cmds[i];
+	rtpe_async_cmds[i] = cmd;
+	rtpe_async_pending++;
+
+	return 0;
+}
+
+static void rtpe_async_unlink(struct rtpe_async_cmd *cmd)
+{
+	struct rtpe_async_cmd **it;
+
+	for (it = &rtpe_async_cmds[cmd->seq & (RTPE_ASYNC_HASH_SIZE - 1)];
+			*it; it = &(*it)->next)
+		if (*it == cmd) {
+			*it = cmd->next;
+			rtpe_async_pending--;
+			return;
+		}
+}
+
+/* triggers the resume route for all the completed commands */
+static void rtpe_async_resume_all(struct rtpe_async_cmd *done)
+{
+	struct rtpe_async_cmd *cmd;
+
+	if (!rtpe_async_pending)
+		rtpe_async_stop_timer();
+
+	while (done) {
+		cmd = done;
+		done = cmd->next;
+		cmd->next = NULL;
+		/* the command is released by the resume function */
+		async_script_resume_f(ASYNC_FD_NONE, cmd->actx, 0);
+	}
+}
+
+static struct rtpe_async_cmd *rtpe_async_match(char *buf, int len,
+		union sockaddr_union *from)
+{
+	struct rtpe_async_cmd *cmd;
+	unsigned int seq = 0;
+	char *p, *end = buf + len;
+
+	if (len <= rtpe_async_cookie_len ||
+			memcmp(buf, rtpe_async_cookie, rtpe_async_cookie_len))
+		return NULL;
+
+	for (p = buf + rtpe_async_cookie_len; p < end && *p >= '0' && *p <= '9'; p++)
+		seq = seq * 10 + (*p - '0');
+	if (p == end || *p != ' ')
+		return NULL;
+
+	for (cmd = rtpe_async_cmds[seq & (RTPE_ASYNC_HASH_SIZE - 1)]; cmd;
+			cmd = cmd->next)
+		if (cmd->seq == seq)
+			break;
+	/* late replies of a previous node are ignored */
+	if (!cmd || !su_cmp(from, &cmd->dst))
+		return NULL;
+
+	p++;
+	cmd->reply_len = end - p;
+	cmd->reply = pkg_malloc(cmd->reply_len + 1);
+	if (!cmd->reply) {
+		LM_ERR("no more pkg memory\n");
+		cmd->state = RTPE_ASYNC_FAILED;
+	} else {
+		memcpy(cmd->reply, p, cmd->reply_len);
+		cmd->reply[cmd->reply_len] = '\0';
+		cmd->state = RTPE_ASYNC_REPLIED;
+	}
+
+	rtpe_async_unlink(cmd);
+	return cmd;
+}
+
+static int rtpe_async_reply(int fd, void *param)
+{
+	static char buf[RTPENGINE_BUF_SIZE];
+	struct rtpe_async_cmd *cmd, *done = NULL;
+	union sockaddr_union from;
+	socklen_t from_len;
+	unsigned long long now;
+	int len, n;
+
+	for (n = 0; n < RTPE_ASYNC_MAX_READS; n++) {
+		from_len = sizeof from;
+		len = recvfrom(fd, buf, sizeof(buf) - 1, MSG_DONTWAIT,
+			&from.s, &from_len);
+		if (len < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				LM_ERR("can't read reply from a RTP proxy (%d:%s)\n",
+					errno, strerror(errno));
+			break;
+		}
+
+		cmd = rtpe_async_match(buf, len, &from);
+		if (!cmd) {
+			LM_DBG("discarding unexpected reply: %.*s\n", len, buf);
+			continue;
+		}
+
+		now = rtpe_now();
+		RTPE_START_READ();
+		if (cmd->version == *list_version)
+			rtpe_update_latency(cmd->node, now - cmd->start);
+		RTPE_STOP_READ();
+
+		cmd->next = done;
+		done = cmd;
+	}
+
+	rtpe_async_resume_all(done);
+
+	/* keep the socket in the reactor */
+	async_status = ASYNC_CONTINUE;
+	return 0;
+}
+
+/* moves a timed out command to a different node of its set */
+static int rtpe_async_failover(struct rtpe_async_cmd *cmd)
+{
+	struct rtpe_node *node;
+	int ret = -1;
+
+	LM_ERR("timeout waiting reply from a RTP proxy\n");
+
+	RTPE_START_READ();
+	if (cmd->version == *list_version) {
+		__sync_fetch_and_add(&cmd->node->rn_timeouts, 1);
+		rtpe_disable_node(cmd->node);
+	}
+
+	while ((node = select_rtpe_node(cmd->callid, cmd->set)) != NULL) {
+		if (node->rn_umode == 0) {
+			LM_ERR("cannot fail over to the unix socket of <%s>\n",
+				node->rn_url.s);
+			break;
+		}
+		if (rtpe_async_send_node(cmd, node) == 0) {
+			ret = 0;
+			break;
+		}
+		rtpe_disable_node(node);
+	}
+	RTPE_STOP_READ();
+
+	return ret;
+}
+
+static int rtpe_async_tick(int fd, void *param)
+{
+	struct rtpe_async_cmd *cmd, *next, *done = NULL;
+	unsigned long long now, tout;
+	uint64_t exp;
+	int i;
+
+	if (read(fd, &exp, sizeof exp) < 0 && errno != EAGAIN)
+		LM_ERR("failed to read from timer FD (%d:%s)\n", errno, strerror(errno));
+
+	now = rtpe_now();
+	tout = rtpengine_tout * 1000000ULL;
+
+	for (i = 0; i < RTPE_ASYNC_HASH_SIZE; i++) {
+		for (cmd = rtpe_async_cmds[i]; cmd; cmd = next) {
+			next = cmd->next;
+			if (now < cmd->sent + tout)
+				continue;
+
+			if (rtpe_async_retransmit(cmd) == 0 ||
+					rtpe_async_failover(cmd) == 0)
+				continue;
+
+			rtpe_async_unlink(cmd);
+			cmd->state = RTPE_ASYNC_FAILED;
+			cmd->next = done;
+			done = cmd;
+		}
+	}
+
+	rtpe_async_resume_all(done);
+
+	async_status = ASYNC_CONTINUE;
+	return 0;
+}
+
+/*
+ * select the set with the id_set id
+ */
+
+static struct rtpe_set * select_rtpe_set(int id_set )
+{
+
+	struct rtpe_set * rtpe_list;
+	/*is it a valid set_id?*/
+
+	if(!rtpe_set_list || !(*rtpe_set_list) || !(*rtpe_set_list)->rset_first)
+		return 0;
+
+	for(rtpe_list=(*rtpe_set_list)->rset_first; rtpe_list!=0 &&
+		rtpe_list->id_set!=id_set; rtpe_list=rtpe_list->rset_next);
+	if(!rtpe_list){
+		LM_DBG("no engine in set %d\n", id_set);
+	}
+
+	return rtpe_list;
+}
+/*
+ * Main balancing routine. This does not try to keep the same proxy for
+ * the call if some proxies were disabled or enabled; proxy death considered
+ * too rare. Otherwise we should implement "mature" HA clustering, which is
+ * too expensive here.
+ */
+static struct rtpe_node *
+select_rtpe_node(str callid, struct rtpe_set *set)
+{
+	unsigned sum, weight_sum;
+	struct rtpe_node* node;
+	int was_forced, sumcut, found, constant_weight_sum;
+
+	/* check last list version */
+	if (my_version != *list_version && update_rtpengines() < 0) {
+		LM_ERR("cannot update rtpengines list\n");
+		return 0;
+	}
+
+	if(!set){
+		LM_ERR("script error -no valid set selected\n");
+		return NULL;
+	}
+
+	/* Most popular case: 1 proxy, nothing to calculate */
+	if (set->rtpe_node_count == 1) {
+		node = set->rn_first;
+		if (node->rn_disabled)
+			return NULL;
+		return node;
+	}
+
+	/* XXX Use quick-and-dirty hashing algo */
+	for(sum = 0; callid.len > 0; callid.len--)
+		sum += callid.s[callid.len - 1];
+	sum &= 0xff;
+
+	was_forced = 0;
+	weight_sum = 0;
+	constant_weight_sum = 0;
+	found = 0;
+	for (node=set->rn_first; node!=NULL; node=node->rn_next) {
+		constant_weight_sum += node->rn_weight;
+		if (!node->rn_disabled) {
+			weight_sum += node->rn_weight;
+			found = 1;
+		}
+	}
+	if (found == 0) {
+			return NULL;
 	}
 	sumcut = weight_sum ? sum % constant_weight_sum : -1;
 	/*
@@ -2703,9 +3386,24 @@ set_rtpengine_set_f(struct sip_msg * msg, rtpe_set_link_t *rtpl)
 	return 1;
 }
 
-static int
-rtpengine_manage(struct sip_msg *msg, str *flags, pv_spec_t *spvar,
+static int rtpe_async_call(struct sip_msg *msg, async_ctx *ctx,
+		enum rtpe_operation op, str *flags, pv_spec_t *spvar,
+		pv_spec_t *bpvar, str *body);
+
+static inline int rtpe_manage_call(struct sip_msg *msg, async_ctx *ctx,
+		enum rtpe_operation op, str *flags, pv_spec_t *spvar,
 		pv_spec_t *bpvar, str *body)
+{
+	if (ctx)
+		return rtpe_async_call(msg, ctx, op, flags, spvar, bpvar, body);
+	if (op == OP_DELETE)
+		return rtpengine_delete(msg, flags, NULL, NULL, spvar);
+	return rtpengine_offer_answer(msg, flags, NULL, spvar, bpvar, body, op);
+}
+
+static int
+rtpengine_manage(struct sip_msg *msg, async_ctx *ctx, str *flags,
+		pv_spec_t *spvar, pv_spec_t *bpvar, str *body)
 {
 	int method;
 	int nosdp;
@@ -2726,7 +3424,7 @@ rtpengine_manage(struct sip_msg *msg, str *flags, pv_spec_t *spvar,
 		return -1;
 
 	if(method==METHOD_CANCEL || method==METHOD_BYE)
-		return rtpengine_delete(msg, flags, NULL, NULL, spvar);
+		return rtpe_manage_call(msg, ctx, OP_DELETE, flags, spvar, NULL, NULL);
 
 	if (body)
 		nosdp = body->len != 0;
@@ -2744,7 +3442,7 @@ rtpengine_manage(struct sip_msg *msg, str *flags, pv_spec_t *spvar,
 					break;
 				case METHOD_INVITE:
 					if(route_type==FAILURE_ROUTE)
-						return rtpengine_delete(msg, flags, NULL, NULL, spvar);
+						return rtpe_manage_call(msg, ctx, OP_DELETE, flags, spvar, NULL, NULL);
 					/* fall through */
 				case METHOD_UPDATE:
 					op = OP_OFFER;
@@ -2752,23 +3450,29 @@ rtpengine_manage(struct sip_msg *msg, str *flags, pv_spec_t *spvar,
 				default:
 					return -1;
 			}
-			return rtpengine_offer_answer(msg, flags, NULL, spvar, bpvar, body, op);
+			return rtpe_manage_call(msg, ctx, op, flags, spvar, bpvar, body);
 		} else if (method==METHOD_INVITE) {
 			msg->msg_flags |= FL_BODY_NO_SDP;
+			/* in async mode, the transaction was already created */
+			if (ctx && tmb.t_gett != NULL) {
+				t = tmb.t_gett();
+				if (t && t != T_UNDEFINED && t->uas.request)
+					t->uas.request->msg_flags |= FL_BODY_NO_SDP;
+			}
 		}
 	} else if(msg->first_line.type == SIP_REPLY) {
 		if(msg->first_line.u.reply.statuscode>=300)
-			return rtpengine_delete(msg, flags, NULL, NULL, spvar);
+			return rtpe_manage_call(msg, ctx, OP_DELETE, flags, spvar, NULL, NULL);
 		if(nosdp==0) {
 			if(method==METHOD_UPDATE)
-				return rtpengine_offer_answer(msg, flags, NULL, spvar, bpvar, body, OP_ANSWER);
+				return rtpe_manage_call(msg, ctx, OP_ANSWER, flags, spvar, bpvar, body);
 			if (tmb.t_gett != NULL) {
 				t = tmb.t_gett();
 				if(t && t != T_UNDEFINED && t->uas.request->msg_flags & FL_BODY_NO_SDP)
 					op = OP_OFFER;
 			}
 			/* op defaults to OP_ANSWER */
-			return rtpengine_offer_answer(msg, flags, NULL, spvar, bpvar, body, op);
+			return rtpe_manage_call(msg, ctx, op, flags, spvar, bpvar, body);
 		}
 	}
 	return -1;
@@ -2781,7 +3485,7 @@ rtpengine_manage_f(struct sip_msg *msg, str *flags, pv_spec_t *spvar,
 	if (set_rtpengine_set_from_avp(msg) == -1)
 	    return -1;
 
-	return rtpengine_manage(msg, flags, spvar, bpvar, body);
+	return rtpengine_manage(msg, NULL, flags, spvar, bpvar, body);
 }
 
 static int
@@ -2809,36 +3513,22 @@ rtpengine_answer_f(struct sip_msg *msg, str *flags, pv_spec_t *spvar,
 	return rtpengine_offer_answer(msg, flags, NULL, spvar, bpvar, body, OP_ANSWER);
 }
 
-static int
-rtpengine_offer_answer_body(struct sip_msg *msg, str *flags, str *node,
-		pv_spec_t *spvar, str *body, str *outbody, struct rtpe_set *set, int op)
+/* replaces the SDP of the message with the one in the reply, or returns it
+ * in @outbody, if given */
+static int rtpe_set_body(struct sip_msg *msg, bencode_item_t *dict,
+		str *outbody)
 {
-	bencode_buffer_t bencbuf;
-	bencode_item_t *dict;
 	str oldbody, newbody;
 	struct lump *anchor;
 
-	if (!body) {
-		if (extract_body(msg, &oldbody) == -1) {
-			LM_ERR("can't extract body from the message\n");
-			return -1;
-		}
-	} else {
-		oldbody = *body;
-	}
-
-	dict = rtpe_function_call_ok(&bencbuf, msg, op, flags, &oldbody, spvar, set, node);
-	if (!dict)
-		return -1;
-
 	if (!bencode_dictionary_get_str_dup(dict, "sdp", &newbody)) {
 		LM_ERR("failed to extract sdp body from proxy reply\n");
-		goto error;
+		return -1;
 	}
 
 	if (outbody) {
 		*outbody = newbody;
-	} else if (!body || (extract_body(msg, &oldbody) > 0)) {
+	} else if (extract_body(msg, &oldbody) > 0) {
 		/* otherwise directly set the body of the message */
 		anchor = del_lump(msg, oldbody.s - msg->buf, oldbody.len, 0);
 		if (!anchor) {
@@ -2854,38 +3544,260 @@ rtpengine_offer_answer_body(struct sip_msg *msg, str *flags, str *node,
 		goto error_free;
 	}
 
-	bencode_buffer_free(&bencbuf);
 	return 1;
 
 error_free:
 	pkg_free(newbody.s);
+	return -1;
+}
+
+static int
+rtpengine_offer_answer_body(struct sip_msg *msg, str *flags, str *node,
+		pv_spec_t *spvar, str *body, str *outbody, struct rtpe_set *set, int op)
+{
+	bencode_buffer_t bencbuf;
+	bencode_item_t *dict;
+	str oldbody;
+
+	if (!body) {
+		if (extract_body(msg, &oldbody) == -1) {
+			LM_ERR("can't extract body from the message\n");
+			return -1;
+		}
+	} else {
+		oldbody = *body;
+	}
+
+	dict = rtpe_function_call_ok(&bencbuf, msg, op, flags, &oldbody, spvar, set, node);
+	if (!dict)
+		return -1;
+
+	if (rtpe_set_body(msg, dict, outbody) < 0)
+		goto error;
+
+	bencode_buffer_free(&bencbuf);
+	return 1;
+
 error:
 	bencode_buffer_free(&bencbuf);
 	return -1;
 }
 
+static void rtpe_store_body(struct sip_msg *msg, pv_spec_t *bpvar,
+		str *newbody)
+{
+	pv_value_t val;
+
+	memset(&val, 0, sizeof(pv_value_t));
+	val.flags = PV_VAL_STR;
+	val.rs = *newbody;
+	if(pv_set_value(msg, bpvar, (int)EQ_T, &val)<0)
+		LM_ERR("setting PV failed\n");
+	pkg_free(newbody->s);
+}
+
 static int
 rtpengine_offer_answer(struct sip_msg *msg, str *flags, str *node,
 		pv_spec_t *spvar, pv_spec_t *bpvar, str *body, int op)
 {
 	str newbody;
-	pv_value_t val;
 	int ret = rtpengine_offer_answer_body(msg, flags, node,
 			spvar, body, (bpvar?&newbody:NULL), NULL, op);
 	if (ret < 0)
 		return -1;
 	/* if we have a variable to store into, use it */
-	if (bpvar) {
-		memset(&val, 0, sizeof(pv_value_t));
-		val.flags = PV_VAL_STR;
-		val.rs = newbody;
-		if(pv_set_value(msg, bpvar, (int)EQ_T, &val)<0)
-			LM_ERR("setting PV failed\n");
-		pkg_free(newbody.s);
+	if (bpvar)
+		rtpe_store_body(msg, bpvar, &newbody);
+	return ret;
+}
+
+/* applies the reply of an async command to the message */
+static int rtpe_async_result(struct sip_msg *msg, struct rtpe_async_cmd *cmd,
+		bencode_buffer_t *bencbuf, bencode_item_t *dict)
+{
+	str newbody;
+
+	if (cmd->op == OP_DELETE) {
+		rtpe_function_done(bencbuf, dict, cmd->op);
+		return 1;
 	}
+
+	if (bencode_dictionary_get_strcmp(dict, "result", "ok")) {
+		LM_ERR("proxy didn't return \"ok\" result\n");
+		goto error;
+	}
+
+	if (rtpe_set_body(msg, dict, cmd->bpvar ? &newbody : NULL) < 0)
+		goto error;
+	if (cmd->bpvar)
+		rtpe_store_body(msg, cmd->bpvar, &newbody);
+
+	bencode_buffer_free(bencbuf);
+	return 1;
+
+error:
+	bencode_buffer_free(bencbuf);
+	return -1;
+}
+
+static enum async_ret_code rtpe_async_resume(int fd, struct sip_msg *msg,
+		void *param)
+{
+	struct rtpe_async_cmd *cmd = (struct rtpe_async_cmd *)param;
+	bencode_buffer_t bencbuf;
+	bencode_item_t *dict;
+	str error;
+	char *reply;
+	int ret = -1;
+
+	if (cmd->state != RTPE_ASYNC_REPLIED) {
+		init_str(&error, "no available proxies");
+		rtpe_set_error(msg, &error);
+		goto end;
+	}
+
+	if (bencode_buffer_init(&bencbuf)) {
+		LM_ERR("could not initialize bencode_buffer_t\n");
+		goto end;
+	}
+	/* the decoded strings point inside the reply, which may outlive the
+	 * command (i.e. the statistics of a delete) */
+	reply = cmd->reply;
+	cmd->reply = NULL;
+	bencode_buffer_destroy_add(&bencbuf, rtpe_async_free_reply, reply);
+
+	dict = rtpe_function_reply(&bencbuf, msg, &cmd->node_url, cmd->spvar,
+		reply, cmd->reply_len);
+	if (!dict) {
+		bencode_buffer_free(&bencbuf);
+		goto end;
+	}
+
+	ret = rtpe_async_result(msg, cmd, &bencbuf, dict);
+end:
+	rtpe_async_free(cmd);
 	return ret;
 }
 
+/* same conditions tm needs for suspending the script */
+static inline int rtpe_async_possible(struct sip_msg *msg)
+{
+#ifdef HAVE_TIMER_FD
+	return async_script_resume_f && route_type == REQUEST_ROUTE &&
+		msg->first_line.type == SIP_REQUEST && msg->REQ_METHOD != METHOD_ACK;
+#else
+	return 0;
+#endif
+}
+
+static int rtpe_async_call(struct sip_msg *msg, async_ctx *ctx,
+		enum rtpe_operation op, str *flags, pv_spec_t *spvar,
+		pv_spec_t *bpvar, str *body)
+{
+	struct rtpe_async_cmd *cmd;
+	bencode_buffer_t bencbuf;
+	bencode_item_t *dict;
+	str oldbody;
+	int ret;
+
+	if (!rtpe_async_possible(msg)) {
+		LM_DBG("cannot suspend the script, running in sync mode\n");
+		if (op == OP_DELETE)
+			ret = rtpengine_delete(msg, flags, NULL, NULL, spvar);
+		else
+			ret = rtpengine_offer_answer(msg, flags, NULL, spvar, bpvar,
+				body, op);
+		async_status = ASYNC_SYNC;
+		return ret;
+	}
+
+	if (op != OP_DELETE && !body) {
+		if (extract_body(msg, &oldbody) == -1) {
+			LM_ERR("can't extract body from the message\n");
+			return -1;
+		}
+		body = &oldbody;
+	}
+
+	cmd = pkg_malloc(sizeof *cmd);
+	if (!cmd) {
+		LM_ERR("no more pkg memory\n");
+		return -1;
+	}
+	memset(cmd, 0, sizeof *cmd);
+	cmd->op = op;
+	cmd->spvar = spvar;
+	cmd->bpvar = bpvar;
+	cmd->actx = ctx;
+
+	dict = __rtpe_function_call(&bencbuf, msg, op, flags,
+		op == OP_DELETE ? NULL : body, spvar, NULL, NULL, NULL, cmd);
+	if (!dict) {
+		rtpe_async_free(cmd);
+		return -1;
+	}
+
+	if (cmd->state != RTPE_ASYNC_PENDING) {
+		/* an unix socket was used, so we already have the reply */
+		ret = rtpe_async_result(msg, cmd, &bencbuf, dict);
+		rtpe_async_free(cmd);
+		async_status = ASYNC_SYNC;
+		return ret;
+	}
+
+	bencode_buffer_free(&bencbuf);
+
+	ctx->resume_f = rtpe_async_resume;
+	ctx->resume_param = cmd;
+	async_status = ASYNC_NO_FD;
+	return 1;
+}
+
+static int
+rtpengine_offer_async_f(struct sip_msg *msg, async_ctx *ctx, str *flags,
+		pv_spec_t *spvar, pv_spec_t *bpvar, str *body)
+{
+	if (set_rtpengine_set_from_avp(msg) == -1)
+	    return -1;
+
+	return rtpe_async_call(msg, ctx, OP_OFFER, flags, spvar, bpvar, body);
+}
+
+static int
+rtpengine_answer_async_f(struct sip_msg *msg, async_ctx *ctx, str *flags,
+		pv_spec_t *spvar, pv_spec_t *bpvar, str *body)
+{
+	if (set_rtpengine_set_from_avp(msg) == -1)
+	    return -1;
+
+	if (msg->first_line.type == SIP_REQUEST)
+		if (msg->first_line.u.request.method_value != METHOD_ACK &&
+				msg->first_line.u.request.method_value != METHOD_PRACK)
+			return -1;
+
+	return rtpe_async_call(msg, ctx, OP_ANSWER, flags, spvar, bpvar, body);
+}
+
+static int
+rtpengine_delete_async_f(struct sip_msg *msg, async_ctx *ctx, str *flags,
+		pv_spec_t *spvar)
+{
+	if (set_rtpengine_set_from_avp(msg) == -1)
+	    return -1;
+
+	return rtpe_async_call(msg, ctx, OP_DELETE, flags, spvar, NULL, NULL);
+}
+
+static int
+rtpengine_manage_async_f(struct sip_msg *msg, async_ctx *ctx, str *flags,
+		pv_spec_t *spvar, pv_spec_t *bpvar, str *body)
+{
+	if (set_rtpengine_set_from_avp(msg) == -1)
+	    return -1;
+
+	return rtpengine_manage(msg, ctx, flags, spvar, bpvar, body);
+}
+
 
 static int
 start_recording_f(struct sip_msg* msg, str *flags, pv_spec_t *spvar)
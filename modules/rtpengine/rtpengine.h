@@ -29,6 +29,9 @@
 #include "bencode.h"
 #include "../../str.h"
 
+/* command latency buckets: up to 1, 2, 5, 10, 50, 100, 500ms and above */
+#define RTPE_LAT_BUCKETS	8
+
 struct rtpe_node {
 	unsigned int		idx;			/* overall index */
 	str					rn_url;			/* unparsed, deletable */
@@ -37,6 +40,8 @@ struct rtpe_node {
 	int					rn_disabled;	/* found unaccessible? */
 	unsigned			rn_weight;		/* for load balancing */
 	unsigned int		rn_recheck_ticks;
+	unsigned long		rn_lat_hist[RTPE_LAT_BUCKETS];	/* shared by all procs */
+	unsigned long		rn_timeouts;
 	struct rtpe_node	*rn_next;
 };
 
@@ -51,6 +51,10 @@
 /* BPF structure */
 #ifdef __OS_linux
 #include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+#include <sys/mman.h>
+#include <poll.h>
 #endif
 
 #ifndef __USE_BSD
@@ -214,6 +218,27 @@ struct _sipcapture_object {
 };
 
 #define ETHHDR 14 /* sizeof of ethhdr structure */
+
+#if defined(__OS_linux) && defined(TPACKET3_HDRLEN)
+#define HAVE_RAW_RING
+/* memory mapped TPACKET_V3 receive ring, one per RAW receiver */
+struct raw_ring {
+	int fd;
+	char *map;
+	unsigned int block_size;
+	unsigned int block_nr;
+	unsigned int cur;
+};
+
+#define RAW_RING_BLOCK_SIZE (1<<20)
+#define RAW_RING_FRAME_SIZE 2048
+#define RAW_RING_BLOCK_TMO 50 /* ms, for retiring partially filled blocks */
+#define RAW_RING_BATCH 32 /* packets passed to a worker in one IPC job */
+
+static struct raw_ring *raw_rings;
+static int raw_rings_no;
+#endif
+
 #define EMPTY_STR(val) val.s=""; val.len=0;
 #define TABLE_LEN 256
 
@@ -264,6 +289,11 @@ int hep_msg_received(void);
 int extract_host_port(void);
 int raw_capture_socket(struct ip_addr* ip, str* iface, int port_start, int port_end, int proto);
 int raw_capture_rcv_loop(int rsock, int port1, int port2, int ipip);
+#ifdef HAVE_RAW_RING
+static int raw_ring_open(str* iface, int port_start, int port_end, int fanout);
+static int raw_ring_rcv_loop(struct raw_ring *ring, int port1, int port2);
+static void raw_ring_close(void);
+#endif
 int sipcapture_db_init(const str* db_url);
 void sipcapture_db_close(void);
 
@@ -272,6 +302,9 @@ static mi_response_t *sip_capture_mi(const mi_params_t *params,
 static mi_response_t *sip_capture_mi_1(const mi_params_t *params,
 								struct mi_handler *async_hdl);
 static int db_sync_store(db_val_t* vals, db_key_t* keys, int num_keys);
+struct sc_ins_list;
+static void sc_set_inslist(struct sc_ins_list **lists, db_key_t *keys,
+		int num_keys);
 
 typedef int (*append_db_vals_f)(char *buf, int max_len, db_val_t* db_vals);
 static inline int append_sc_values(char* buf, int max_len, db_val_t* db_vals);
@@ -442,6 +475,8 @@ int moni_port_end   = 0;
 int *capture_on_flag = NULL;
 int promisc_on = 0;
 int bpf_on = 0;
+int raw_mmap_on = 0;
+int raw_ring_size = 16; /* MB, per RAW receiver */
 
 char* hep_route=0;
 str hep_route_s;
@@ -473,12 +508,22 @@ static struct sock_filter BPF_code[] = { { 0x28, 0, 0, 0x0000000c }, { 0x15, 0,
 db_func_t db_funcs;      	/*!< Database functions */
 db_con_t* db_con = 0; 		/*!< database connection */
 
+/* the insert queues (query_buffer_size) are bound to a table, so we keep
+ * one for each table we store into - the most recently used first, since
+ * the table names may be time based */
+#define SC_MAX_INS_LISTS 8
+struct sc_ins_list {
+	str table;
+	query_list_t *list;
+	struct sc_ins_list *next;
+};
+
 static db_ps_t sc_ps = NULL;
-static query_list_t *sc_ins_list = NULL;
+static struct sc_ins_list *sc_ins_lists = NULL;
 
 
 static db_ps_t rc_ps = NULL;
-static query_list_t *rc_ins_list = NULL;
+static struct sc_ins_list *rc_ins_lists = NULL;
 
 proto_hep_api_t hep_api;
 load_hep_f load_hep;
@@ -601,6 +646,8 @@ static param_export_t params[] = {
 	{"raw_interface",     		STR_PARAM, &raw_interface.s   },
         {"promiscious_on",  		INT_PARAM, &promisc_on   },
         {"raw_moni_bpf_on",  		INT_PARAM, &bpf_on   },
+	{"raw_moni_mmap_on",		INT_PARAM, &raw_mmap_on   },
+	{"raw_moni_ring_size",		INT_PARAM, &raw_ring_size   },
 	{"hep_route",		STR_PARAM, &hep_route_name},
 	{0, 0, 0}
 };
@@ -621,12 +668,23 @@ static mi_export_t mi_cmds[] = {
 #ifdef STATISTICS
 stat_var* sipcapture_req;
 stat_var* sipcapture_rpl;
+stat_var* sipcapture_hep_rcv;
+stat_var* sipcapture_stored;
+stat_var* sipcapture_dropped;
+stat_var* sipcapture_ring_drops;
 
 stat_export_t sipcapture_stats[] = {
 	{"captured_requests" ,  0,  &sipcapture_req  },
 	{"captured_replies"  ,  0,  &sipcapture_rpl  },
+	{"received_hep_packets", 0, &sipcapture_hep_rcv },
+	{"stored_packets"    ,  0,  &sipcapture_stored },
+	{"dropped_packets"   ,  0,  &sipcapture_dropped },
+	{"raw_ring_drops"    ,  0,  &sipcapture_ring_drops },
 	{0,0,0}
 };
+#define sc_update_stat(_stat) update_stat(_stat, 1)
+#else
+#define sc_update_stat(_stat)
 #endif
 
 static module_dependency_t *get_deps_hep(param_export_t *param)
@@ -757,6 +815,9 @@ static int mod_init(void) {
 
 	int i;
 	struct ip_addr *ip = NULL;
+#ifdef HAVE_RAW_RING
+	int err;
+#endif
 
 	if (hep_capture_on) {
 		load_hep = (load_hep_f)find_export("load_hep", 0);
@@ -1007,6 +1068,36 @@ static int mod_init(void) {
 				return -1;
 				}
 
+#ifdef HAVE_RAW_RING
+		if (moni_capture_on && raw_mmap_on) {
+			/* the rings are per socket, so each RAW receiver gets its own
+			 * socket, all of them spreading the traffic through a fanout
+			 * group; they are opened here, while still privileged */
+			if (raw_ring_size <= 0 || procs[0].no <= 0) {
+				LM_ERR("bad raw_moni_ring_size/raw_sock_children\n");
+				return -1;
+			}
+
+			raw_rings = pkg_malloc(procs[0].no * sizeof *raw_rings);
+			if (!raw_rings) {
+				LM_ERR("no more pkg memory\n");
+				return -1;
+			}
+
+			for (raw_rings_no = 0; raw_rings_no < procs[0].no; raw_rings_no++)
+				if (raw_ring_open(raw_interface.len ? &raw_interface : 0,
+						moni_port_start, moni_port_end, procs[0].no > 1) < 0)
+					break;
+
+			if (raw_rings_no == procs[0].no) {
+				raw_sock_desc = raw_rings[0].fd;
+			} else {
+				err = errno;
+				raw_ring_close();
+				errno = err;
+			}
+		} else
+#endif
 		raw_sock_desc = raw_capture_socket(raw_socket_listen.len ? ip : 0, raw_interface.len ? &raw_interface : 0,
 										moni_port_start, moni_port_end , ipip_capture_on ? IPPROTO_IPIP : htons(0x0800));
 
@@ -2243,6 +2334,14 @@ static void raw_socket_process(int rank)
 			return;
 		}
 
+#ifdef HAVE_RAW_RING
+	if (raw_rings) {
+		raw_ring_rcv_loop(&raw_rings[rank], moni_port_start, moni_port_end);
+		sipcapture_db_close();
+		return;
+	}
+#endif
+
 	raw_capture_rcv_loop(raw_sock_desc, moni_port_start, moni_port_end,
 			moni_capture_on ? 0 : 1);
 
@@ -2368,6 +2467,11 @@ static void destroy(void)
                          }
 #endif
                 }
+#ifdef HAVE_RAW_RING
+		if (raw_rings)
+			raw_ring_close();
+		else
+#endif
 		close(raw_sock_desc);
 	}
 }
@@ -2394,6 +2498,8 @@ int hep_msg_received(void)
 		return 0;
 	}
 
+	sc_update_stat(sipcapture_hep_rcv);
+
 	if ( hep_route_id == HEP_NO_ROUTE ) {
 		memset(&msg, 0, sizeof(struct sip_msg));
 
@@ -2745,13 +2851,12 @@ static int sip_capture_store(struct _sipcapture_object *sco,
 	ret=1;
 
 	/* each query has it's own parameters for the prepared statements */
-	if (con_set_inslist(&db_funcs, db_con, &sc_ins_list, db_keys + 1, NR_KEYS - 1) < 0) {
-		CON_RESET_INSLIST(db_con);
-	}
+	sc_set_inslist(&sc_ins_lists, db_keys + 1, NR_KEYS - 1);
 	CON_SET_CURR_PS(db_con, &sc_ps);
 
 	if (!actx && db_sync_store(db_vals+1, db_keys+1, NR_KEYS-1) != 1) {
 		LM_ERR("failed to insert into database\n");
+		sc_update_stat(sipcapture_dropped);
 		return -1;
 	} else if (actx) {
 		ret = db_async_store(db_vals+1, db_keys+1, NR_KEYS-1, append_sc_values,
@@ -2760,11 +2865,78 @@ static int sip_capture_store(struct _sipcapture_object *sco,
 
 	#ifdef STATISTICS
 		update_stat(sco->stat, 1);
+		update_stat(ret < 0 ? sipcapture_dropped : sipcapture_stored, 1);
 	#endif
 
 	return ret;
 }
 
+/*
+ * Binds the connection to the insert queue of the current table, if
+ * the rows are buffered (query_buffer_size). With query_writer_processes,
+ * the capturing processes only queue the rows, while the SQL writers
+ * flush them in bulk.
+ */
+static void sc_set_inslist(struct sc_ins_list **lists, db_key_t *keys,
+		int num_keys)
+{
+	struct sc_ins_list *it, *prev = NULL;
+	int n = 0;
+
+	if (query_buffer_size <= 1)
+		return;
+
+	/* the queues are looked up by the table of the connection */
+	if (db_funcs.use_table(db_con, &current_table) < 0) {
+		LM_ERR("use table failed!\n");
+		goto no_list;
+	}
+
+	for (it = *lists; it; prev = it, it = it->next, n++)
+		if (it->table.len == current_table.len &&
+				!memcmp(it->table.s, current_table.s, current_table.len))
+			break;
+
+	if (it) {
+		/* move it in front */
+		if (prev) {
+			prev->next = it->next;
+			it->next = *lists;
+			*lists = it;
+		}
+	} else {
+		/* drop the least recently used table */
+		if (n >= SC_MAX_INS_LISTS) {
+			for (prev = *lists; prev->next->next; prev = prev->next) ;
+			/* its queued rows get flushed before the queue is freed */
+			ql_release(prev->next->list);
+			pkg_free(prev->next);
+			prev->next = NULL;
+		}
+
+		it = pkg_malloc(sizeof *it + current_table.len);
+		if (!it) {
+			LM_ERR("no more pkg memory\n");
+			goto no_list;
+		}
+
+		it->table.s = (char *)(it + 1);
+		it->table.len = current_table.len;
+		memcpy(it->table.s, current_table.s, current_table.len);
+		it->list = NULL;
+		it->next = *lists;
+		*lists = it;
+	}
+
+	if (con_set_inslist(&db_funcs, db_con, &it->list, keys, num_keys) < 0)
+		goto no_list;
+
+	return;
+
+no_list:
+	CON_RESET_INSLIST(db_con);
+}
+
 
 static int db_sync_store(db_val_t* vals, db_key_t* keys, int num_keys)
 {
@@ -4511,6 +4683,7 @@ static int report_capture(struct sip_msg* msg, str* table, str* cor_id,
 	char src_ip[INET6_ADDRSTRLEN], dst_ip[INET6_ADDRSTRLEN];
 
 	int homerV = hep_api.get_homer_version();
+	int ret;
 
 	struct _sipcapture_object sco;
 
@@ -4698,19 +4871,24 @@ static int report_capture(struct sip_msg* msg, str* table, str* cor_id,
 	}
 
 	/* each query has it's own parameters for the prepared statements */
-	if (con_set_inslist(&db_funcs, db_con, &rc_ins_list, db_keys, NR_KEYS) < 0) {
-		CON_RESET_INSLIST(db_con);
-	}
+	sc_set_inslist(&rc_ins_lists, rtcp_db_keys, rtp_keys_no);
 	CON_SET_CURR_PS(db_con, &rc_ps);
 
 	if (!actx && db_sync_store(db_vals, rtcp_db_keys, rtp_keys_no) != 1) {
 		LM_ERR("failed to insert into database\n");
+		sc_update_stat(sipcapture_dropped);
 		return -1;
 	} else if (actx) {
-		return db_async_store(db_vals, rtcp_db_keys, rtp_keys_no,
+		ret = db_async_store(db_vals, rtcp_db_keys, rtp_keys_no,
 			append_rc_values, actx, t_el);
+		if (ret < 0)
+			sc_update_stat(sipcapture_dropped);
+		else
+			sc_update_stat(sipcapture_stored);
+		return ret;
 	}
 
+	sc_update_stat(sipcapture_stored);
 	return 1;
 }
 
@@ -4820,6 +4998,38 @@ static mi_response_t *sip_capture_mi_1(const mi_params_t *params,
 	}
 }
 
+#ifdef __OS_linux
+/* attaches the port/portrange filter to the socket */
+static int raw_capture_filter(int sock, int port_start, int port_end)
+{
+	struct sock_fprog pf;
+
+	memset(&pf, 0, sizeof(pf));
+	pf.len = sizeof(BPF_code) / sizeof(BPF_code[0]);
+	pf.filter = (struct sock_filter *) BPF_code;
+
+	if(!port_end) port_end = port_start;
+
+	/* Start PORT */
+	BPF_code[5]  = (struct sock_filter)BPF_JUMP(0x35, port_start, 0, 1);
+	BPF_code[8] = (struct  sock_filter)BPF_JUMP(0x35, port_start, 11, 13);
+	BPF_code[16] = (struct sock_filter)BPF_JUMP(0x35, port_start, 0, 1);
+	BPF_code[19] = (struct sock_filter)BPF_JUMP(0x35, port_start, 0, 2);
+	/* Stop PORT */
+	BPF_code[6]  = (struct sock_filter)BPF_JUMP(0x25, port_end, 0, 14);
+	BPF_code[17] = (struct sock_filter)BPF_JUMP(0x25, port_end, 0, 3);
+	BPF_code[20] = (struct sock_filter)BPF_JUMP(0x25, port_end, 1, 0);
+
+	/* Attach the filter to the socket */
+	if(setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER, &pf, sizeof(pf)) < 0 ) {
+		LM_ERR("setsockopt filter: [%s] [%d]\n", strerror(errno), errno);
+		return -1;
+	}
+
+	return 0;
+}
+#endif
+
 /* Local raw socket */
 int raw_capture_socket(struct ip_addr* ip, str* iface, int port_start, int port_end, int proto)
 {
@@ -4828,7 +5038,6 @@ int raw_capture_socket(struct ip_addr* ip, str* iface, int port_start, int port_
 	union sockaddr_union su;
 
 #ifdef __OS_linux
-	struct sock_fprog pf;
 	char short_ifname[sizeof(int)];
 	int ifname_len;
 	char* ifname;
@@ -4873,29 +5082,8 @@ int raw_capture_socket(struct ip_addr* ip, str* iface, int port_start, int port_
 		}
 	}
 
-	if(bpf_on) {
-
-		memset(&pf, 0, sizeof(pf));
-	        pf.len = sizeof(BPF_code) / sizeof(BPF_code[0]);
-        	pf.filter = (struct sock_filter *) BPF_code;
-
-                if(!port_end) port_end = port_start;
-
-        	/* Start PORT */
-        	BPF_code[5]  = (struct sock_filter)BPF_JUMP(0x35, port_start, 0, 1);
-        	BPF_code[8] = (struct  sock_filter)BPF_JUMP(0x35, port_start, 11, 13);
-        	BPF_code[16] = (struct sock_filter)BPF_JUMP(0x35, port_start, 0, 1);
-        	BPF_code[19] = (struct sock_filter)BPF_JUMP(0x35, port_start, 0, 2);
-        	/* Stop PORT */
-        	BPF_code[6]  = (struct sock_filter)BPF_JUMP(0x25, port_end, 0, 14);
-        	BPF_code[17] = (struct sock_filter)BPF_JUMP(0x25, port_end, 0, 3);
-        	BPF_code[20] = (struct sock_filter)BPF_JUMP(0x25, port_end, 1, 0);
-
-        	/* Attach the filter to the socket */
-        	if(setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER, &pf, sizeof(pf)) < 0 ) {
-                        LM_ERR("setsockopt filter: [%s] [%d]\n", strerror(errno), errno);
-                }
-        }
+	if(bpf_on)
+		raw_capture_filter(sock, port_start, port_end);
 #endif
 
         if (ip && proto == IPPROTO_IPIP){
@@ -4931,25 +5119,118 @@ void rpc_msg_received(int sender, void *param)
 	shm_free( ipc_pack );
 }
 
-/* Local raw receive loop */
-int raw_capture_rcv_loop(int rsock, int port1, int port2, int ipip) {
-
-
-	static char buf [BUF_SIZE+1];
+/* Parses the IP/UDP headers of a captured packet (the IP header starting
+ * at @offset) and builds the message to be passed to the workers; returns
+ * NULL if the packet is to be ignored */
+static struct ipc_msg_pack *raw_capture_parse(char *buf, int len, int offset,
+		int port1, int port2)
+{
 	union sockaddr_union from;
 	union sockaddr_union to;
-	int len;
 	struct ip *iph;
 	struct udphdr *udph;
 	char* udph_start;
 	unsigned short udp_len;
-	int offset = 0;
 	char* end;
 	unsigned short dst_port;
 	unsigned short src_port;
 	struct ip_addr dst_ip, src_ip;
 	struct ipc_msg_pack *ipc_pack;
 
+	end=buf+len;
+
+	if (len < (sizeof(struct ip)+sizeof(struct udphdr) + offset)) {
+		LM_DBG("received small packet: %d. Ignore it\n",len);
+		return NULL;
+	}
+
+	iph = (struct ip*) (buf + offset);
+
+	offset+=iph->ip_hl*4;
+
+	udph_start = buf+offset;
+
+	udph = (struct udphdr*) udph_start;
+	offset +=sizeof(struct udphdr);
+
+	if ((buf+offset)>end){
+		return NULL;
+	}
+
+	/* cut off the offset */
+	len -= offset;
+
+	if (len<MIN_UDP_PACKET){
+		LM_DBG("probing packet received from\n");
+		return NULL;
+	}
+
+	udp_len=ntohs(udph->uh_ulen);
+	if ((udph_start+udp_len)!=end){
+		if ((udph_start+udp_len)>end){
+			return NULL;
+		}else{
+			LM_DBG("udp length too small: %d/%d\n", (int)udp_len, (int)(end-udph_start));
+			return NULL;
+		}
+	}
+
+	/* fill dst_port */
+	dst_port=ntohs(udph->uh_dport);
+	/* fill src_port */
+	src_port=ntohs(udph->uh_sport);
+
+	LM_DBG("PORT: [%d] and [%d]\n", port1, port2);
+
+	if (!((!port1 && !port2)
+	|| (src_port >= port1 && src_port <= port2)
+	|| (dst_port >= port1 && dst_port <= port2)
+	|| (!port2 && (src_port == port1 || dst_port == port1))))
+		return NULL;
+
+	ipc_pack = (struct ipc_msg_pack*)shm_malloc( sizeof(struct ipc_msg_pack) + len );
+	if (ipc_pack==NULL) {
+		LM_ERR("failed to allocate new ipc_msg_pack, discarding...\n");
+		return NULL;
+	}
+	memset( ipc_pack, 0, sizeof(struct ipc_msg_pack) + len);
+
+	/* cleaup previous values in dst */
+	memset(&dst_ip, 0, sizeof(dst_ip));
+
+	/*FIL IPs*/
+	dst_ip.af=AF_INET;
+	dst_ip.len=4;
+	dst_ip.u.addr32[0]=iph->ip_dst.s_addr;
+	ip_addr2su(&to, &dst_ip, dst_port);
+	src_ip.af=AF_INET;
+	src_ip.len=4;
+	src_ip.u.addr32[0]=iph->ip_src.s_addr;
+	ip_addr2su(&from, &src_ip, src_port);
+	su_setport(&from, src_port);
+
+	ipc_pack->ri.src_su=from;
+	su2ip_addr(&(ipc_pack->ri.src_ip), &from);
+	ipc_pack->ri.src_port=src_port;
+		su2ip_addr(&(ipc_pack->ri.dst_ip), &to);
+	ipc_pack->ri.dst_port=dst_port;
+	ipc_pack->ri.proto=PROTO_UDP;
+
+	ipc_pack->buf.s = (char*)(ipc_pack+1);
+	ipc_pack->buf.len = len;
+	memcpy( ipc_pack->buf.s, buf+offset, len);
+
+	return ipc_pack;
+}
+
+/* Local raw receive loop */
+int raw_capture_rcv_loop(int rsock, int port1, int port2, int ipip) {
+
+
+	static char buf [BUF_SIZE+1];
+	int len;
+	struct ipc_msg_pack *ipc_pack;
+
 
 	for(;;) {
 
@@ -4968,97 +5249,255 @@ int raw_capture_rcv_loop(int rsock, int port1, int port2, int ipip) {
 			}
 		}
 
-		end=buf+len;
+		ipc_pack = raw_capture_parse(buf, len,
+			ipip ? sizeof(struct ip) : ETHHDR, port1, port2);
+		if (ipc_pack && ipc_dispatch_rpc( rpc_msg_received, ipc_pack) < 0)
+			shm_free(ipc_pack);
+	}
 
-		offset =  ipip ? sizeof(struct ip) : ETHHDR;
+	return 0;
 
-		if (len < (sizeof(struct ip)+sizeof(struct udphdr) + offset)) {
-			LM_DBG("received small packet: %d. Ignore it\n",len);
-			continue;
+error:
+	return -1;
+
+}
+
+#ifdef HAVE_RAW_RING
+struct ipc_msg_batch {
+	int no;
+	struct ipc_msg_pack *msgs[RAW_RING_BATCH];
+};
+
+static void rpc_msg_batch_received(int sender, void *param)
+{
+	struct ipc_msg_batch *batch = (struct ipc_msg_batch *)param;
+	int i;
+
+	for (i = 0; i < batch->no; i++)
+		rpc_msg_received(sender, batch->msgs[i]);
+
+	shm_free(batch);
+}
+
+static struct ipc_msg_batch *raw_ring_flush(struct ipc_msg_batch *batch)
+{
+	int i;
+
+	if (!batch || !batch->no)
+		return batch;
+
+	if (ipc_dispatch_rpc(rpc_msg_batch_received, batch) < 0) {
+		for (i = 0; i < batch->no; i++)
+			shm_free(batch->msgs[i]);
+		shm_free(batch);
+	}
+
+	return NULL;
+}
+
+/* Opens the next TPACKET_V3 ring of the raw_rings array: the socket is
+ * bound to the interface, gets the port filter in the kernel and, if
+ * @fanout, joins the (hash based) fanout group of the RAW receivers */
+static int raw_ring_open(str* iface, int port_start, int port_end, int fanout)
+{
+	struct raw_ring *ring = &raw_rings[raw_rings_no];
+	struct tpacket_req3 req;
+	struct sockaddr_ll sll;
+	char ifname[IFNAMSIZ];
+	int ver = TPACKET_V3;
+	int arg;
+
+	ring->map = MAP_FAILED;
+	/* no protocol yet - nothing gets queued until the socket is bound */
+	ring->fd = socket(PF_PACKET, SOCK_RAW, 0);
+	if (ring->fd < 0) {
+		LM_ERR("failed to create packet socket: %s [%d]\n",
+			strerror(errno), errno);
+		return -1;
+	}
+
+	if (setsockopt(ring->fd, SOL_PACKET, PACKET_VERSION, &ver,
+			sizeof ver) < 0) {
+		LM_ERR("TPACKET_V3 not supported: %s [%d]\n", strerror(errno), errno);
+		goto error;
+	}
+
+	memset(&req, 0, sizeof req);
+	req.tp_block_size = RAW_RING_BLOCK_SIZE;
+	req.tp_block_nr = raw_ring_size * ((1<<20) / RAW_RING_BLOCK_SIZE);
+	req.tp_frame_size = RAW_RING_FRAME_SIZE;
+	req.tp_frame_nr = req.tp_block_size / req.tp_frame_size * req.tp_block_nr;
+	req.tp_retire_blk_tov = RAW_RING_BLOCK_TMO;
+	if (setsockopt(ring->fd, SOL_PACKET, PACKET_RX_RING, &req,
+			sizeof req) < 0) {
+		LM_ERR("failed to set up a %dMB receive ring: %s [%d]\n",
+			raw_ring_size, strerror(errno), errno);
+		goto error;
+	}
+
+	ring->block_size = req.tp_block_size;
+	ring->block_nr = req.tp_block_nr;
+	ring->cur = 0;
+	ring->map = mmap(NULL, (size_t)ring->block_size * ring->block_nr,
+		PROT_READ|PROT_WRITE, MAP_SHARED, ring->fd, 0);
+	if (ring->map == MAP_FAILED) {
+		LM_ERR("failed to map the receive ring: %s [%d]\n",
+			strerror(errno), errno);
+		goto error;
+	}
+
+	if (raw_capture_filter(ring->fd, port_start, port_end) < 0)
+		goto error;
+
+	memset(&sll, 0, sizeof sll);
+	sll.sll_family = AF_PACKET;
+	sll.sll_protocol = htons(ETH_P_IP);
+	if (iface && iface->s) {
+		if (iface->len >= IFNAMSIZ) {
+			LM_ERR("bad interface name %.*s\n", iface->len, iface->s);
+			goto error;
+		}
+		memcpy(ifname, iface->s, iface->len);
+		ifname[iface->len] = 0;
+		sll.sll_ifindex = if_nametoindex(ifname);
+		if (!sll.sll_ifindex) {
+			LM_ERR("could not find interface %s: %s [%d]\n",
+				ifname, strerror(errno), errno);
+			goto error;
 		}
+	}
+	if (bind(ring->fd, (struct sockaddr *)&sll, sizeof sll) < 0) {
+		LM_ERR("could not bind to %.*s: %s [%d]\n", iface ? iface->len : 3,
+			iface ? iface->s : "any", strerror(errno), errno);
+		goto error;
+	}
 
-		iph = (struct ip*) (buf + offset);
+	if (fanout) {
+		/* all the sockets of this instance share the group; a flow always
+		 * lands on the same receiver, reassembled if fragmented */
+		arg = (getpid() & 0xffff) |
+			((PACKET_FANOUT_HASH|PACKET_FANOUT_FLAG_DEFRAG) << 16);
+		if (setsockopt(ring->fd, SOL_PACKET, PACKET_FANOUT, &arg,
+				sizeof arg) < 0) {
+			LM_ERR("failed to join the fanout group: %s [%d]\n",
+				strerror(errno), errno);
+			goto error;
+		}
+	}
 
-		offset+=iph->ip_hl*4;
+	return 0;
 
-		udph_start = buf+offset;
+error:
+	if (ring->map != MAP_FAILED)
+		munmap(ring->map, (size_t)ring->block_size * ring->block_nr);
+	close(ring->fd);
+	return -1;
+}
+
+static void raw_ring_close(void)
+{
+	int i;
 
-		udph = (struct udphdr*) udph_start;
-		offset +=sizeof(struct udphdr);
+	for (i = 0; i < raw_rings_no; i++) {
+		munmap(raw_rings[i].map,
+			(size_t)raw_rings[i].block_size * raw_rings[i].block_nr);
+		close(raw_rings[i].fd);
+	}
 
-		if ((buf+offset)>end){
-			continue;
+	pkg_free(raw_rings);
+	raw_rings = NULL;
+	raw_rings_no = 0;
+}
+
+#ifdef STATISTICS
+static void raw_ring_stats(struct raw_ring *ring)
+{
+	struct tpacket_stats_v3 st;
+	socklen_t len = sizeof st;
+
+	/* the kernel resets the counters on each read */
+	if (getsockopt(ring->fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) < 0) {
+		LM_DBG("failed to read the ring stats: %s\n", strerror(errno));
+		return;
+	}
+
+	if (st.tp_drops)
+		update_stat(sipcapture_ring_drops, st.tp_drops);
+}
+#else
+#define raw_ring_stats(_ring)
+#endif
+
+/* Ring receive loop: the kernel fills in whole blocks of packets, which are
+ * walked without any syscall and handed back once processed; the packets
+ * are passed to the workers in batches */
+static int raw_ring_rcv_loop(struct raw_ring *ring, int port1, int port2)
+{
+	struct tpacket_block_desc *bd;
+	struct tpacket3_hdr *hdr;
+	struct ipc_msg_batch *batch = NULL;
+	struct ipc_msg_pack *ipc_pack;
+	struct pollfd pfd;
+	time_t last = 0, now;
+	unsigned int i;
+
+	pfd.fd = ring->fd;
+	pfd.events = POLLIN|POLLERR;
+
+	for(;;) {
+		now = time(NULL);
+		if (now != last) {
+			raw_ring_stats(ring);
+			last = now;
 		}
 
-		/* cut off the offset */
-		len -= offset;
+		bd = (struct tpacket_block_desc *)
+			(ring->map + (size_t)ring->cur * ring->block_size);
 
-		if (len<MIN_UDP_PACKET){
-			LM_DBG("probing packet received from\n");
+		if (!(__sync_fetch_and_add(&bd->hdr.bh1.block_status, 0) &
+				TP_STATUS_USER)) {
+			pfd.revents = 0;
+			if (poll(&pfd, 1, 1000) < 0 && errno != EINTR) {
+				LM_ERR("poll: %s [%d]\n", strerror(errno), errno);
+				return -1;
+			}
 			continue;
 		}
 
-		udp_len=ntohs(udph->uh_ulen);
-		if ((udph_start+udp_len)!=end){
-			if ((udph_start+udp_len)>end){
-				continue;
-			}else{
-				LM_DBG("udp length too small: %d/%d\n", (int)udp_len, (int)(end-udph_start));
+		hdr = (struct tpacket3_hdr *)((char *)bd +
+			bd->hdr.bh1.offset_to_first_pkt);
+		for (i = 0; i < bd->hdr.bh1.num_pkts; i++) {
+			ipc_pack = raw_capture_parse((char *)hdr + hdr->tp_mac,
+				hdr->tp_snaplen, ETHHDR, port1, port2);
+			hdr = (struct tpacket3_hdr *)((char *)hdr + hdr->tp_next_offset);
+			if (!ipc_pack)
 				continue;
+
+			if (!batch) {
+				batch = shm_malloc(sizeof *batch);
+				if (!batch) {
+					LM_ERR("no more shm memory, discarding...\n");
+					shm_free(ipc_pack);
+					continue;
+				}
+				batch->no = 0;
 			}
-		}
 
-		ipc_pack = (struct ipc_msg_pack*)shm_malloc( sizeof(struct ipc_msg_pack) + len );
-		if (ipc_pack==NULL) {
-			LM_ERR("failed to allocate new ipc_msg_pack, discarding...\n");
-			continue;
+			batch->msgs[batch->no++] = ipc_pack;
+			if (batch->no == RAW_RING_BATCH)
+				batch = raw_ring_flush(batch);
 		}
-		memset( ipc_pack, 0, sizeof(struct ipc_msg_pack) + len);
-
-		/* cleaup previous values in dst */
-		memset(&dst_ip, 0, sizeof(dst_ip));
-
-		/*FIL IPs*/
-		dst_ip.af=AF_INET;
-		dst_ip.len=4;
-		dst_ip.u.addr32[0]=iph->ip_dst.s_addr;
-		/* fill dst_port */
-		dst_port=ntohs(udph->uh_dport);
-		ip_addr2su(&to, &dst_ip, dst_port);
-		/* fill src_port */
-		src_port=ntohs(udph->uh_sport);
-		src_ip.af=AF_INET;
-		src_ip.len=4;
-		src_ip.u.addr32[0]=iph->ip_src.s_addr;
-		ip_addr2su(&from, &src_ip, src_port);
-		su_setport(&from, src_port);
-
-		ipc_pack->ri.src_su=from;
-		su2ip_addr(&(ipc_pack->ri.src_ip), &from);
-		ipc_pack->ri.src_port=src_port;
-			su2ip_addr(&(ipc_pack->ri.dst_ip), &to);
-		ipc_pack->ri.dst_port=dst_port;
-		ipc_pack->ri.proto=PROTO_UDP;
-
-		LM_DBG("PORT: [%d] and [%d]\n", port1, port2);
-
-		ipc_pack->buf.s = (char*)(ipc_pack+1);
-		ipc_pack->buf.len = len;
-		memcpy( ipc_pack->buf.s, buf+offset, len);
-
-		if((!port1 && !port2)
-		|| (src_port >= port1 && src_port <= port2)
-		|| (dst_port >= port1 && dst_port <= port2)
-		|| (!port2 && (src_port == port1 || dst_port == port1)))
-			ipc_dispatch_rpc( rpc_msg_received, ipc_pack);
+		batch = raw_ring_flush(batch);
+
+		/* give the block back to the kernel */
+		__sync_synchronize();
+		bd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+		ring->cur = (ring->cur + 1) % ring->block_nr;
 	}
 
 	return 0;
-
-error:
-	return -1;
-
 }
+#endif
 
 #undef QUERY_BUF
 #undef QUERY_LEN
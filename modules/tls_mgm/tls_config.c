@@ -59,6 +59,13 @@ char 	       *tls_ca_dir    = TLS_CA_DIRECTORY;
 char           *tls_tmp_dh_file        = TLS_DH_PARAMS_FILE;
 /* defaul cipher=0, this means the DEFAULT ciphers */
 char           *tls_ciphers_list = 0;
+/* lifetime of the resumable TLS sessions (cached or ticket based) */
+int             tls_session_lifetime = 300;
+/* how often the session ticket keys are rotated */
+int             tls_ticket_key_lifetime = 3600;
+/* secret the ticket keys are derived from - if shared by several
+ * instances, any of them is able to resume the sessions of the others */
+char           *tls_ticket_key_secret = 0;
 /* AVPs used to enforce client domain matching from the script */
 int             tls_client_domain_avp = -1;
 int             sip_client_domain_avp = -1;
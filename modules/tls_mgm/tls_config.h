@@ -52,6 +52,9 @@ extern char    *tls_ca_file;
 extern char    *tls_ca_dir;
 extern char    *tls_tmp_dh_file;
 extern char    *tls_ciphers_list;
+extern int      tls_session_lifetime;
+extern int      tls_ticket_key_lifetime;
+extern char    *tls_ticket_key_secret;
 
 extern str     tls_db_url; 
 extern str     tls_db_table;
@@ -46,6 +46,7 @@ enum tls_method {
 /* SSL extra data indexes */
 #define SSL_EX_CONN_IDX 0
 #define SSL_EX_DOM_IDX 1
+#define SSL_EX_HS_START_IDX 2
 
 #endif	/* TLS_CONFIG_HELPER_H */
 
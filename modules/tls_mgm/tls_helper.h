@@ -39,6 +39,9 @@
 #define F_TLS_DO_ACCEPT   (1<<0)
 #define F_TLS_DO_CONNECT  (1<<1)
 #define F_TLS_TRACE_READY (1<<2)
+/* the accept completed in a TCP handshake worker, the connection is to be
+ * handed over once its buffered data is processed */
+#define F_TLS_HANDOVER    (1<<3)
 
 #define DOM_FLAG_SRV			(1<<0)
 #define DOM_FLAG_CLI			(1<<1)
@@ -74,6 +77,15 @@ enum {
 	VAR_COMP_SUBJECT_SERIAL = 1<<20    /*Serial name from Subject*/
 };
 
+/* TLS session resumption counters, updated by all the processes */
+struct tls_sess_stats {
+	unsigned long handshakes;
+	unsigned long resumed;
+	unsigned long cache_hits;
+	unsigned long cache_misses;
+	unsigned long cache_evictions;
+};
+
 struct tls_domain {
 	str name;
 	int flags;
@@ -97,6 +109,13 @@ struct tls_domain {
 	str method_str;
 	enum tls_method method;
 	enum tls_method method_max;
+	int session_cache;  /* max sessions in the shared cache, 0 to disable */
+	int session_lifetime;
+	int session_tickets;
+	int ticket_key_lifetime;
+	char *ticket_key_secret;
+	void *sess_cache;  /* TLS library specific shared session cache */
+	struct tls_sess_stats sess_stats;
 	struct tls_domain *next;
 };
 
@@ -133,6 +133,11 @@ static param_export_t params[] = {
 	{ "ciphers_list",  STR_PARAM|USE_FUNC_PARAM,  (void*)tlsp_set_cplist     },
 	{ "dh_params",     STR_PARAM|USE_FUNC_PARAM,  (void*)tlsp_set_dhparams   },
 	{ "ec_curve",      STR_PARAM|USE_FUNC_PARAM,  (void*)tlsp_set_eccurve    },
+	{ "session_cache", STR_PARAM|USE_FUNC_PARAM,  (void*)tlsp_set_sess_cache },
+	{ "session_tickets", STR_PARAM|USE_FUNC_PARAM, (void*)tlsp_set_sess_tickets },
+	{ "session_lifetime",    INT_PARAM,  &tls_session_lifetime    },
+	{ "ticket_key_lifetime", INT_PARAM,  &tls_ticket_key_lifetime },
+	{ "ticket_key_secret",   STR_PARAM,  &tls_ticket_key_secret   },
 	{ "db_url",		STR_PARAM,  &tls_db_url.s	},
 	{ "db_table",		STR_PARAM,  &tls_db_table.s	},
 	{ "domain_col",		STR_PARAM,  &domain_col.s		},
@@ -669,6 +674,10 @@ static int init_tls_dom(struct tls_domain *d)
 	if (!d->crl_directory)
 		LM_NOTICE("no crl for tls, using none\n");
 
+	d->session_lifetime = tls_session_lifetime;
+	d->ticket_key_lifetime = tls_ticket_key_lifetime;
+	d->ticket_key_secret = tls_ticket_key_secret;
+
 	if (tls_library == TLS_LIB_OPENSSL)
 		return openssl_api.init_tls_dom(d, init_flags);
 	else if (tls_library == TLS_LIB_WOLFSSL)
@@ -1292,6 +1301,34 @@ static int list_domain(mi_item_t *domains_arr, struct tls_domain *d)
 			d->tls_ec_curve, len(d->tls_ec_curve)) < 0)
 			goto error;
 
+		if (add_mi_number(domain_item, MI_SSTR("SESSION_CACHE"),
+			d->session_cache) < 0)
+			goto error;
+
+		if (add_mi_bool(domain_item, MI_SSTR("SESSION_TICKETS"),
+			d->session_tickets) < 0)
+			goto error;
+
+		if (add_mi_number(domain_item, MI_SSTR("HANDSHAKES"),
+			d->sess_stats.handshakes) < 0)
+			goto error;
+
+		if (add_mi_number(domain_item, MI_SSTR("RESUMED"),
+			d->sess_stats.resumed) < 0)
+			goto error;
+
+		if (add_mi_number(domain_item, MI_SSTR("CACHE_HITS"),
+			d->sess_stats.cache_hits) < 0)
+			goto error;
+
+		if (add_mi_number(domain_item, MI_SSTR("CACHE_MISSES"),
+			d->sess_stats.cache_misses) < 0)
+			goto error;
+
+		if (add_mi_number(domain_item, MI_SSTR("CACHE_EVICTIONS"),
+			d->sess_stats.cache_evictions) < 0)
+			goto error;
+
 		d = d->next;
 	}
 
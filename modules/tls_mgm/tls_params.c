@@ -381,3 +381,39 @@ int tlsp_set_eccurve(modparam_t type, void *in)
 	set_domain_attr(name, tls_ec_curve, val.s);
 	return 1;
 }
+
+int tlsp_set_sess_cache(modparam_t type, void *in)
+{
+	str name;
+	str val;
+	unsigned int size;
+
+	if (split_param_val((char*)in, &name, &val) < 0)
+		return -1;
+
+	if (str2int(&val, &size)!=0) {
+		LM_ERR("option is not a number [%s]\n",val.s);
+		return -1;
+	}
+
+	set_domain_attr(name, session_cache, size);
+	return 1;
+}
+
+int tlsp_set_sess_tickets(modparam_t type, void *in)
+{
+	str name;
+	str val;
+	unsigned int tickets;
+
+	if (split_param_val((char*)in, &name, &val) < 0)
+		return -1;
+
+	if (str2int(&val, &tickets)!=0) {
+		LM_ERR("option is not a number [%s]\n",val.s);
+		return -1;
+	}
+
+	set_domain_attr(name, session_tickets, tickets);
+	return 1;
+}
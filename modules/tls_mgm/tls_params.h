@@ -75,5 +75,9 @@ int tlsp_set_dhparams(modparam_t type, void *val);
 
 int tlsp_set_eccurve(modparam_t type, void *val);
 
+int tlsp_set_sess_cache(modparam_t type, void *val);
+
+int tlsp_set_sess_tickets(modparam_t type, void *val);
+
 #endif
 
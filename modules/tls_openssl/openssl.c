@@ -40,6 +40,8 @@
 
 #include "openssl_helpers.h"
 #include "openssl_api.h"
+#include "openssl_sess_cache.h"
+#include "openssl_hs_stats.h"
 
 #if (OPENSSL_VERSION_NUMBER >= 0x10100000L && defined __OS_linux)
 #include <features.h>
@@ -98,12 +100,31 @@ int tls_ctx_set_pkey_file(void *ctx, char *pkey_file);
 gen_lock_t *tls_global_lock;
 #endif
 
+/* use asynchronous OpenSSL jobs (SSL_MODE_ASYNC) for the server handshakes */
+int openssl_async_handshakes = 0;
+
 static cmd_export_t cmds[] = {
 	{"load_tls_openssl", (cmd_function)load_tls_openssl,
 		{{0,0,0}}, ALL_ROUTES},
 	{0,0,{{0,0,0}},0}
 };
 
+static param_export_t params[] = {
+	{"async_handshakes", INT_PARAM, &openssl_async_handshakes},
+	{0, 0, 0}
+};
+
+static stat_export_t mod_stats[] = {
+	{"tls_handshakes_pending", STAT_NO_RESET, &tls_hs_pending},
+	{"tls_handshakes",         0,             &tls_hs_done},
+	{"tls_handshakes_failed",  0,             &tls_hs_failed},
+	{"tls_handshake_avg_time", STAT_IS_FUNC,
+		(stat_var**)openssl_hs_avg_time},
+	{"tls_handshake_max_time", STAT_IS_FUNC,
+		(stat_var**)openssl_hs_max_time},
+	{0, 0, 0}
+};
+
 struct module_exports exports = {
 	"tls_openssl",  /* module name*/
 	MOD_TYPE_DEFAULT,/* class of this module */
@@ -113,8 +134,8 @@ struct module_exports exports = {
 	0,          /* OpenSIPS module dependencies */
 	cmds,          /* exported functions */
 	0,          /* exported async functions */
-	0,          /* module parameters */
-	0,          /* exported statistics */
+	params,     /* module parameters */
+	mod_stats,  /* exported statistics */
 	0,          /* exported MI functions */
 	0,          /* exported pseudo-variables */
 	0,			/* exported transformations */
@@ -272,6 +293,20 @@ static int mod_init(void)
 
 	init_ssl_methods();
 
+	if (openssl_sess_init() < 0)
+		return -1;
+
+	if (openssl_hs_stats_init() < 0)
+		return -1;
+
+#if (OPENSSL_VERSION_NUMBER < 0x10100000L)
+	if (openssl_async_handshakes) {
+		LM_WARN("asynchronous handshakes require OpenSSL 1.1.0 or newer, "
+			"disabling them\n");
+		openssl_async_handshakes = 0;
+	}
+#endif
+
 #if (OPENSSL_VERSION_NUMBER < 0x10100000L)
 	n = check_for_krb();
 	if (n==-1) {
@@ -32,6 +32,9 @@
 #include "../tls_mgm/tls_helper.h"
 
 #include "openssl_api.h"
+#include "openssl_sess_cache.h"
+
+extern int openssl_async_handshakes;
 
 void tls_dump_cert_info(char* s, X509* cert);
 void tls_print_errstack(void);
@@ -807,7 +810,7 @@ int openssl_init_tls_dom(struct tls_domain *d, int init_flags)
 
 		/* Set a bunch of options:
 		 *     do not accept SSLv2 / SSLv3
-		 *     no session resumption
+		 *     no session resumption on renegotiation
 		 *     choose cipher according to server's preference's*/
 
 		SSL_CTX_set_options(((void**)d->ctx)[i],
@@ -819,8 +822,12 @@ int openssl_init_tls_dom(struct tls_domain *d, int init_flags)
 		SSL_CTX_set_verify(((void**)d->ctx)[i], verify_mode, verify_callback);
 		SSL_CTX_set_verify_depth(((void**)d->ctx)[i], VERIFY_DEPTH_S);
 
-		//SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER );
-		SSL_CTX_set_session_cache_mode(((void**)d->ctx)[i], SSL_SESS_CACHE_OFF );
+		if (openssl_sess_init_ctx(d, ((void**)d->ctx)[i]) < 0)
+			return -1;
+#ifdef SSL_MODE_ASYNC
+		if (openssl_async_handshakes && d->flags & DOM_FLAG_SRV)
+			SSL_CTX_set_mode(((void**)d->ctx)[i], SSL_MODE_ASYNC);
+#endif
 		SSL_CTX_set_session_id_context(((void**)d->ctx)[i], (unsigned char*)OS_SSL_SESS_ID,
 				OS_SSL_SESS_ID_LEN );
 
@@ -1021,4 +1028,6 @@ void openssl_destroy_tls_dom(struct tls_domain *tls_dom)
 				SSL_CTX_free(((void**)tls_dom->ctx)[i]);
 		shm_free(tls_dom->ctx);
 	}
+
+	openssl_sess_destroy_dom(tls_dom);
 }
@@ -32,10 +32,13 @@
 #include <netinet/tcp.h>
 
 #include "../../net/tcp_conn_defs.h"
+#include "../../net/net_tcp.h"
 #include "../../net/proto_tcp/tcp_common_defs.h"
 #include "../tls_mgm/tls_helper.h"
 
 #include "openssl_trace.h"
+#include "openssl_sess_cache.h"
+#include "openssl_hs_stats.h"
 
 void tls_print_errstack(void);
 void tls_dump_cert_info(char* s, X509* cert);
@@ -43,6 +46,10 @@ void tls_dump_cert_info(char* s, X509* cert);
 extern gen_lock_t *tls_global_lock;
 
 #define TLS_ERR_MAX 256
+
+/* how long to block for an asynchronous crypto job, in ms (only when the
+ * accept is not done by the TCP worker holding the connection) */
+#define TLS_ASYNC_JOB_TIMEOUT 1000
 static char tls_err_buf[TLS_ERR_MAX];
 
 static int tls_get_errstack( char* result, int size )
@@ -241,6 +248,7 @@ int openssl_tls_conn_init(struct tcp_connection* c, struct tls_domain *tls_dom)
 	if ( c->proto_flags & F_TLS_DO_ACCEPT ) {
 		LM_DBG("Setting in ACCEPT mode (server)\n");
 		SSL_set_accept_state((SSL *) c->extra_data);
+		openssl_hs_start((SSL *) c->extra_data);
 	} else {
 		LM_DBG("Setting in CONNECT mode (client)\n");
 		SSL_set_connect_state((SSL *) c->extra_data);
@@ -341,6 +349,9 @@ void openssl_tls_conn_clean(struct tcp_connection *c, struct tls_domain **tls_do
 	if (c->extra_data) {
 		d = SSL_get_ex_data(c->extra_data, SSL_EX_DOM_IDX);
 
+		/* a handshake still in progress will never complete */
+		openssl_hs_end(c->extra_data, 0);
+
 		openssl_tls_update_fd(c,c->s);
 		openssl_tls_conn_shutdown(c);
 		SSL_free((SSL *) c->extra_data);
@@ -487,11 +498,58 @@ static int openssl_tls_connect(struct tcp_connection *c, short *poll_events,
 	return -1;
 }
 
+#ifdef SSL_ERROR_WANT_ASYNC
+/* gets the wait fds of the paused asynchronous job(s) of @ssl; returns
+ * their number or -1 */
+static int openssl_get_async_fds(SSL *ssl, OSSL_ASYNC_FD *fds)
+{
+	size_t numfds;
+
+	if (!SSL_get_all_async_fds(ssl, NULL, &numfds))
+		return -1;
+	if (numfds > TCP_CONN_WAIT_MAX_FDS) {
+		LM_ERR("too many async fds (%zu)\n", numfds);
+		return -1;
+	}
+	if (numfds && !SSL_get_all_async_fds(ssl, fds, &numfds))
+		return -1;
+
+	return (int)numfds;
+}
+
+/* blocks until any of the async job @fds is readable */
+static int openssl_wait_async(OSSL_ASYNC_FD *fds, int numfds)
+{
+	struct pollfd pf[TCP_CONN_WAIT_MAX_FDS];
+	int i, n;
+
+	for (i = 0; i < numfds; i++) {
+		pf[i].fd = fds[i];
+		pf[i].events = POLLIN;
+	}
+
+again:
+	n = poll(pf, numfds, TLS_ASYNC_JOB_TIMEOUT);
+	if (n < 0) {
+		if (errno == EINTR)
+			goto again;
+		LM_ERR("poll failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	return n ? 0 : -1;
+}
+#endif
+
 static int openssl_tls_accept(struct tcp_connection *c, short *poll_events)
 {
 	int ret, err;
 	SSL *ssl;
 	X509* cert;
+#ifdef SSL_ERROR_WANT_ASYNC
+	OSSL_ASYNC_FD async_fds[TCP_CONN_WAIT_MAX_FDS];
+	int n;
+#endif
 
 	str tls_err_s;
 
@@ -507,6 +565,7 @@ static int openssl_tls_accept(struct tcp_connection *c, short *poll_events)
 		ssl->kssl_ctx = kssl_ctx_new( );
 #endif
 #endif
+retry:
 	#ifndef NO_SSL_GLOBAL_LOCK
 	lock_get(tls_global_lock);
 	#endif
@@ -532,6 +591,8 @@ static int openssl_tls_accept(struct tcp_connection *c, short *poll_events)
 
 		/* TLS accept done, reset the flag */
 		c->proto_flags &= ~F_TLS_DO_ACCEPT;
+		openssl_sess_handshake_done(ssl);
+		openssl_hs_end(ssl, 1);
 
 		LM_DBG("new TLS connection from %s:%d using %s %s %d\n",
 			ip_addr2a(&c->rcv.src_ip), c->rcv.src_port,
@@ -592,6 +653,31 @@ static int openssl_tls_accept(struct tcp_connection *c, short *poll_events)
 				if (poll_events)
 					*poll_events = POLLOUT;
 				return 0;
+#ifdef SSL_ERROR_WANT_ASYNC
+			case SSL_ERROR_WANT_ASYNC:
+				#ifndef NO_SSL_GLOBAL_LOCK
+				lock_release(tls_global_lock);
+				#endif
+
+				/* the crypto job was paused; the TCP worker holding the
+				 * connection resumes the accept once the job is done, while
+				 * handling other connections in the meantime */
+				n = openssl_get_async_fds(ssl, async_fds);
+				if (n == 0)
+					goto retry;
+				if (n > 0) {
+					if (tcp_conn_wait_fds(c, async_fds, n) == 0)
+						return 0;
+					/* not our connection (i.e. a writer) - block */
+					if (openssl_wait_async(async_fds, n) == 0)
+						goto retry;
+				}
+
+				LM_ERR("asynchronous handshake with %s:%d failed\n",
+					ip_addr2a(&c->rcv.src_ip), c->rcv.src_port);
+				c->state = S_CONN_BAD;
+				return -1;
+#endif
 			case SSL_ERROR_SYSCALL:
 				LM_ERR("SSL_ERROR_SYSCALL err=%s(%d)\n",
 					strerror(errno), errno);
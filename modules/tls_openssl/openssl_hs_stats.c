@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <time.h>
+
+#include "../../dprint.h"
+#include "../../mem/shm_mem.h"
+#include "../tls_mgm/tls_config_helper.h"
+
+#include "openssl_hs_stats.h"
+
+struct hs_latency {
+	unsigned long long total;
+	unsigned long count;
+	unsigned long max;
+};
+
+stat_var *tls_hs_pending;
+stat_var *tls_hs_done;
+stat_var *tls_hs_failed;
+
+static struct hs_latency *hs_lat;
+
+/* a fine grained, system wide clock (the handshake may complete in another
+ * process than the one accepting the connection), in usec */
+static inline unsigned long hs_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int openssl_hs_stats_init(void)
+{
+	hs_lat = shm_malloc(sizeof *hs_lat);
+	if (!hs_lat) {
+		LM_ERR("oom\n");
+		return -1;
+	}
+	memset(hs_lat, 0, sizeof *hs_lat);
+
+	return 0;
+}
+
+void openssl_hs_start(SSL *ssl)
+{
+	/* the low bit is set, so that the stored value is never NULL */
+	unsigned long start = hs_now() | 1;
+
+	if (!SSL_set_ex_data(ssl, SSL_EX_HS_START_IDX, (void *)start)) {
+		LM_DBG("failed to store the handshake start time\n");
+		return;
+	}
+
+	update_stat(tls_hs_pending, 1);
+}
+
+void openssl_hs_end(SSL *ssl, int success)
+{
+	unsigned long start, now, elapsed, max;
+
+	start = (unsigned long)SSL_get_ex_data(ssl, SSL_EX_HS_START_IDX);
+	if (!start)
+		return;
+	SSL_set_ex_data(ssl, SSL_EX_HS_START_IDX, NULL);
+
+	update_stat(tls_hs_pending, -1);
+
+	if (!success) {
+		update_stat(tls_hs_failed, 1);
+		return;
+	}
+
+	update_stat(tls_hs_done, 1);
+	if (!hs_lat)
+		return;
+
+	now = hs_now();
+	elapsed = now > start ? now - start : 0;
+
+	__sync_fetch_and_add(&hs_lat->total, elapsed);
+	__sync_fetch_and_add(&hs_lat->count, 1);
+	for (max = hs_lat->max; elapsed > max; max = hs_lat->max)
+		if (__sync_bool_compare_and_swap(&hs_lat->max, max, elapsed))
+			break;
+}
+
+unsigned long openssl_hs_avg_time(void *foo)
+{
+	unsigned long count;
+
+	if (!hs_lat || !(count = hs_lat->count))
+		return 0;
+
+	return (unsigned long)(hs_lat->total / count);
+}
+
+unsigned long openssl_hs_max_time(void *foo)
+{
+	return hs_lat ? hs_lat->max : 0;
+}
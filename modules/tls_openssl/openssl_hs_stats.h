@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/*
+ * Accounting of the server side TLS handshakes
+ *
+ * A handshake is pending from the moment the SSL struct of an accepted
+ * connection is created (in TCP main) and until the accept completes or the
+ * connection is destroyed, so the number of pending handshakes is the depth
+ * of the handshake queue of the TCP workers.
+ */
+
+#ifndef OPENSSL_HS_STATS_H
+#define OPENSSL_HS_STATS_H
+
+#include <openssl/ssl.h>
+
+#include "../../statistics.h"
+
+extern stat_var *tls_hs_pending;
+extern stat_var *tls_hs_done;
+extern stat_var *tls_hs_failed;
+
+int openssl_hs_stats_init(void);
+
+/* a new server side handshake is queued */
+void openssl_hs_start(SSL *ssl);
+
+/* the handshake completed or (if @success is 0) was abandoned */
+void openssl_hs_end(SSL *ssl, int success);
+
+/* average and maximum handshake duration, in microseconds */
+unsigned long openssl_hs_avg_time(void *foo);
+unsigned long openssl_hs_max_time(void *foo);
+
+#endif /* OPENSSL_HS_STATS_H */
@@ -0,0 +1,565 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <openssl/ssl.h>
+#include <openssl/opensslv.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
+
+#include <stdint.h>
+#include <time.h>
+
+#include "../../dprint.h"
+#include "../../ut.h"
+#include "../../mem/shm_mem.h"
+#include "../../locking.h"
+#include "../../hash_func.h"
+#include "../tls_mgm/tls_helper.h"
+
+#include "openssl_sess_cache.h"
+
+/* larger sessions (i.e. with huge client certificates) are not cached */
+#define SESS_MAX_DER_LEN    16384
+#define SESS_MAX_HASH_SIZE  (1<<16)
+
+#define TICKET_SECRET_LEN   32
+#define TICKET_NAME_LEN     16
+
+struct sess_entry {
+	struct sess_entry *hnext;
+	struct sess_entry *lru_prev;
+	struct sess_entry *lru_next;
+	unsigned int hash;
+	time_t expires;
+	unsigned int id_len;
+	unsigned char id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+	unsigned int der_len;
+	unsigned char der[0];
+};
+
+/* per domain session resumption data, in shm */
+struct sess_data {
+	gen_lock_t lock;
+	unsigned int max_entries;
+	unsigned int entries;
+	unsigned int hash_size;
+	struct sess_entry **hash;
+	/* most recently used first */
+	struct sess_entry *lru_head;
+	struct sess_entry *lru_tail;
+
+	/* the ticket keys of each period are derived from this one */
+	unsigned char ticket_prk[EVP_MAX_MD_SIZE];
+};
+
+struct ticket_keys {
+	unsigned char name[TICKET_NAME_LEN];
+	unsigned char aes_key[32];
+	unsigned char hmac_key[32];
+};
+
+/* used when no "ticket_key_secret" is configured; generated before
+ * forking, so it is common to all the processes of this instance */
+static unsigned char sess_rand_secret[TICKET_SECRET_LEN];
+
+
+int openssl_sess_init(void)
+{
+	if (RAND_bytes(sess_rand_secret, TICKET_SECRET_LEN) != 1) {
+		LM_ERR("failed to generate the session ticket secret\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static inline unsigned int sess_hash(const unsigned char *id, unsigned int len,
+		unsigned int size)
+{
+	str s;
+
+	s.s = (char *)id;
+	s.len = len;
+	return core_hash(&s, NULL, size);
+}
+
+static void sess_unlink(struct sess_data *sd, struct sess_entry *e)
+{
+	struct sess_entry **it;
+
+	for (it = &sd->hash[e->hash]; *it; it = &(*it)->hnext)
+		if (*it == e) {
+			*it = e->hnext;
+			break;
+		}
+
+	if (e->lru_prev)
+		e->lru_prev->lru_next = e->lru_next;
+	else
+		sd->lru_head = e->lru_next;
+
+	if (e->lru_next)
+		e->lru_next->lru_prev = e->lru_prev;
+	else
+		sd->lru_tail = e->lru_prev;
+
+	sd->entries--;
+}
+
+static void sess_lru_push(struct sess_data *sd, struct sess_entry *e)
+{
+	e->lru_prev = NULL;
+	e->lru_next = sd->lru_head;
+	if (sd->lru_head)
+		sd->lru_head->lru_prev = e;
+	else
+		sd->lru_tail = e;
+	sd->lru_head = e;
+}
+
+static struct sess_entry *sess_lookup(struct sess_data *sd,
+		const unsigned char *id, unsigned int len, unsigned int hash)
+{
+	struct sess_entry *e;
+
+	for (e = sd->hash[hash]; e; e = e->hnext)
+		if (e->id_len == len && !memcmp(e->id, id, len))
+			return e;
+
+	return NULL;
+}
+
+static int sess_new_cb(SSL *ssl, SSL_SESSION *sess)
+{
+	struct tls_domain *d;
+	struct sess_data *sd;
+	struct sess_entry *e, *old, *evicted = NULL, *next;
+	const unsigned char *id;
+	unsigned char *p;
+	unsigned int id_len;
+	int der_len;
+	time_t now;
+
+	d = SSL_get_ex_data(ssl, SSL_EX_DOM_IDX);
+	if (!d || !(sd = d->sess_cache) || !sd->max_entries)
+		return 0;
+
+#ifdef TLS1_3_VERSION
+	/* TLS 1.3 sessions are resumed through the (stateless) tickets */
+	if (SSL_version(ssl) == TLS1_3_VERSION &&
+			!(SSL_get_options(ssl) & SSL_OP_NO_TICKET))
+		return 0;
+#endif
+
+	id = SSL_SESSION_get_id(sess, &id_len);
+	if (!id_len || id_len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+		return 0;
+
+	der_len = i2d_SSL_SESSION(sess, NULL);
+	if (der_len <= 0 || der_len > SESS_MAX_DER_LEN) {
+		LM_DBG("not caching TLS session of %d bytes\n", der_len);
+		return 0;
+	}
+
+	e = shm_malloc(sizeof *e + der_len);
+	if (!e) {
+		LM_ERR("no more shm memory\n");
+		return 0;
+	}
+
+	p = e->der;
+	e->der_len = i2d_SSL_SESSION(sess, &p);
+	memcpy(e->id, id, id_len);
+	e->id_len = id_len;
+	e->hash = sess_hash(id, id_len, sd->hash_size);
+	e->expires = SSL_SESSION_get_time(sess) + SSL_SESSION_get_timeout(sess);
+
+	now = time(NULL);
+
+	lock_get(&sd->lock);
+
+	old = sess_lookup(sd, id, id_len, e->hash);
+	if (old) {
+		sess_unlink(sd, old);
+		old->lru_next = evicted;
+		evicted = old;
+	}
+
+	/* first drop the expired sessions which are not in use anymore */
+	while (sd->lru_tail && sd->lru_tail->expires <= now) {
+		old = sd->lru_tail;
+		sess_unlink(sd, old);
+		old->lru_next = evicted;
+		evicted = old;
+	}
+
+	while (sd->entries >= sd->max_entries) {
+		old = sd->lru_tail;
+		sess_unlink(sd, old);
+		old->lru_next = evicted;
+		evicted = old;
+		__sync_fetch_and_add(&d->sess_stats.cache_evictions, 1);
+	}
+
+	e->hnext = sd->hash[e->hash];
+	sd->hash[e->hash] = e;
+	sess_lru_push(sd, e);
+	sd->entries++;
+
+	lock_release(&sd->lock);
+
+	for (; evicted; evicted = next) {
+		next = evicted->lru_next;
+		shm_free(evicted);
+	}
+
+	/* we do not keep a reference to the session */
+	return 0;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+static SSL_SESSION *sess_get_cb(SSL *ssl, const unsigned char *id, int len,
+		int *copy)
+#else
+static SSL_SESSION *sess_get_cb(SSL *ssl, unsigned char *id, int len,
+		int *copy)
+#endif
+{
+	struct tls_domain *d;
+	struct sess_data *sd;
+	struct sess_entry *e;
+	SSL_SESSION *sess = NULL;
+	const unsigned char *p;
+
+	*copy = 0;
+
+	d = SSL_get_ex_data(ssl, SSL_EX_DOM_IDX);
+	if (!d || !(sd = d->sess_cache) || !sd->max_entries ||
+			len <= 0 || len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+		return NULL;
+
+	lock_get(&sd->lock);
+
+	e = sess_lookup(sd, id, len, sess_hash(id, len, sd->hash_size));
+	if (e && e->expires <= time(NULL)) {
+		sess_unlink(sd, e);
+		lock_release(&sd->lock);
+		shm_free(e);
+		e = NULL;
+	} else if (e) {
+		/* move it in front of the LRU list */
+		if (e != sd->lru_head) {
+			e->lru_prev->lru_next = e->lru_next;
+			if (e->lru_next)
+				e->lru_next->lru_prev = e->lru_prev;
+			else
+				sd->lru_tail = e->lru_prev;
+			sess_lru_push(sd, e);
+		}
+
+		p = e->der;
+		sess = d2i_SSL_SESSION(NULL, &p, e->der_len);
+		lock_release(&sd->lock);
+	} else {
+		lock_release(&sd->lock);
+	}
+
+	if (sess)
+		__sync_fetch_and_add(&d->sess_stats.cache_hits, 1);
+	else
+		__sync_fetch_and_add(&d->sess_stats.cache_misses, 1);
+
+	return sess;
+}
+
+static void sess_remove_cb(SSL_CTX *ctx, SSL_SESSION *sess)
+{
+	struct tls_domain *d;
+	struct sess_data *sd;
+	struct sess_entry *e;
+	const unsigned char *id;
+	unsigned int id_len;
+
+	d = SSL_CTX_get_app_data(ctx);
+	if (!d || !(sd = d->sess_cache) || !sd->max_entries)
+		return;
+
+	id = SSL_SESSION_get_id(sess, &id_len);
+	if (!id_len || id_len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+		return;
+
+	lock_get(&sd->lock);
+	e = sess_lookup(sd, id, id_len, sess_hash(id, id_len, sd->hash_size));
+	if (e)
+		sess_unlink(sd, e);
+	lock_release(&sd->lock);
+
+	if (e)
+		shm_free(e);
+}
+
+/*
+ * The keys of a rotation period are derived from the domain's key:
+ *   name     = period (8 bytes, network order) | HMAC(prk, "name"|period)
+ *   aes key  = HMAC(prk, "aes"|period)
+ *   hmac key = HMAC(prk, "hmac"|period)
+ * so any process (or instance sharing the secret) can rebuild them.
+ */
+static int ticket_derive_keys(struct sess_data *sd, uint64_t period,
+		struct ticket_keys *k)
+{
+	unsigned char buf[16], md[EVP_MAX_MD_SIZE];
+	unsigned int md_len, i;
+
+	for (i = 0; i < 8; i++)
+		buf[i] = (unsigned char)(period >> (56 - 8 * i));
+
+	memcpy(k->name, buf, 8);
+
+	memcpy(buf + 8, "name", 4);
+	if (!HMAC(EVP_sha256(), sd->ticket_prk, 32, buf, 12, md, &md_len))
+		return -1;
+	memcpy(k->name + 8, md, TICKET_NAME_LEN - 8);
+
+	memcpy(buf + 8, "aes", 3);
+	if (!HMAC(EVP_sha256(), sd->ticket_prk, 32, buf, 11, k->aes_key, &md_len))
+		return -1;
+
+	memcpy(buf + 8, "hmac", 4);
+	if (!HMAC(EVP_sha256(), sd->ticket_prk, 32, buf, 12, k->hmac_key, &md_len))
+		return -1;
+
+	return 0;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+static int ticket_hmac_init(EVP_MAC_CTX *hctx, struct ticket_keys *k)
+{
+	OSSL_PARAM params[3];
+
+	params[0] = OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY,
+		k->hmac_key, sizeof k->hmac_key);
+	params[1] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST,
+		"SHA256", 0);
+	params[2] = OSSL_PARAM_construct_end();
+
+	return EVP_MAC_CTX_set_params(hctx, params) ? 0 : -1;
+}
+
+static int ticket_key_cb(SSL *ssl, unsigned char *key_name,
+		unsigned char *iv, EVP_CIPHER_CTX *cctx, EVP_MAC_CTX *hctx, int enc)
+#else
+static int ticket_hmac_init(HMAC_CTX *hctx, struct ticket_keys *k)
+{
+	return HMAC_Init_ex(hctx, k->hmac_key, sizeof k->hmac_key,
+		EVP_sha256(), NULL) ? 0 : -1;
+}
+
+static int ticket_key_cb(SSL *ssl, unsigned char *key_name,
+		unsigned char *iv, EVP_CIPHER_CTX *cctx, HMAC_CTX *hctx, int enc)
+#endif
+{
+	struct tls_domain *d;
+	struct sess_data *sd;
+	struct ticket_keys k;
+	uint64_t period, cur;
+	int i;
+
+	d = SSL_get_ex_data(ssl, SSL_EX_DOM_IDX);
+	/* no ticket is issued (or accepted) if the domain has none */
+	if (!d || !(sd = d->sess_cache) || !d->session_tickets)
+		return 0;
+
+	cur = (uint64_t)time(NULL) / d->ticket_key_lifetime;
+
+	if (enc) {
+		if (ticket_derive_keys(sd, cur, &k) < 0 ||
+				RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1)
+			return -1;
+
+		memcpy(key_name, k.name, TICKET_NAME_LEN);
+
+		if (!EVP_EncryptInit_ex(cctx, EVP_aes_256_cbc(), NULL, k.aes_key, iv) ||
+				ticket_hmac_init(hctx, &k) < 0)
+			return -1;
+
+		return 1;
+	}
+
+	for (period = 0, i = 0; i < 8; i++)
+		period = (period << 8) | key_name[i];
+
+	/* only the tickets of the current and previous periods are accepted */
+	if (period != cur && period + 1 != cur) {
+		LM_DBG("ticket key of period %llu has expired\n",
+			(unsigned long long)period);
+		return 0;
+	}
+
+	if (ticket_derive_keys(sd, period, &k) < 0)
+		return -1;
+
+	if (memcmp(key_name, k.name, TICKET_NAME_LEN))
+		return 0;
+
+	if (!EVP_DecryptInit_ex(cctx, EVP_aes_256_cbc(), NULL, k.aes_key, iv) ||
+			ticket_hmac_init(hctx, &k) < 0)
+		return -1;
+
+#ifdef TLS1_3_VERSION
+	/* TLS 1.3 clients use each ticket only once, so always issue a new one */
+	if (SSL_version(ssl) == TLS1_3_VERSION)
+		return 2;
+#endif
+
+	/* ask for a fresh ticket if encrypted with the previous key */
+	return period == cur ? 1 : 2;
+}
+
+static struct sess_data *sess_data_new(struct tls_domain *d)
+{
+	struct sess_data *sd;
+	const unsigned char *secret;
+	unsigned int hash_size = 0, md_len;
+	int secret_len;
+
+	if (d->session_cache > 0)
+		for (hash_size = 16; hash_size < d->session_cache &&
+			hash_size < SESS_MAX_HASH_SIZE; hash_size <<= 1) ;
+
+	sd = shm_malloc(sizeof *sd + hash_size * sizeof *sd->hash);
+	if (!sd) {
+		LM_ERR("no more shm memory\n");
+		return NULL;
+	}
+	memset(sd, 0, sizeof *sd + hash_size * sizeof *sd->hash);
+
+	if (!lock_init(&sd->lock)) {
+		LM_ERR("failed to init lock\n");
+		shm_free(sd);
+		return NULL;
+	}
+
+	sd->max_entries = d->session_cache > 0 ? d->session_cache : 0;
+	sd->hash_size = hash_size;
+	sd->hash = (struct sess_entry **)(sd + 1);
+
+	if (d->ticket_key_secret) {
+		secret = (unsigned char *)d->ticket_key_secret;
+		secret_len = strlen(d->ticket_key_secret);
+	} else {
+		secret = sess_rand_secret;
+		secret_len = TICKET_SECRET_LEN;
+	}
+
+	if (!HMAC(EVP_sha256(), secret, secret_len, (unsigned char *)d->name.s,
+			d->name.len, sd->ticket_prk, &md_len)) {
+		LM_ERR("failed to derive the session ticket key\n");
+		lock_destroy(&sd->lock);
+		shm_free(sd);
+		return NULL;
+	}
+
+	return sd;
+}
+
+int openssl_sess_init_ctx(struct tls_domain *d, SSL_CTX *ctx)
+{
+	/* client side resumption would also need a per destination store */
+	if (!(d->flags & DOM_FLAG_SRV) ||
+			(d->session_cache <= 0 && !d->session_tickets)) {
+		SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+		if (d->flags & DOM_FLAG_SRV)
+			SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+		return 0;
+	}
+
+	if (d->session_tickets && d->ticket_key_lifetime <= 0) {
+		LM_ERR("bad ticket_key_lifetime for tls domain '%.*s'\n",
+			d->name.len, ZSW(d->name.s));
+		return -1;
+	}
+
+	if (!d->sess_cache && !(d->sess_cache = sess_data_new(d)))
+		return -1;
+
+	SSL_CTX_set_app_data(ctx, d);
+
+	if (d->session_lifetime > 0)
+		SSL_CTX_set_timeout(ctx, d->session_lifetime);
+
+	if (d->session_cache > 0) {
+		SSL_CTX_set_session_cache_mode(ctx,
+			SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+		SSL_CTX_sess_set_new_cb(ctx, sess_new_cb);
+		SSL_CTX_sess_set_get_cb(ctx, sess_get_cb);
+		SSL_CTX_sess_set_remove_cb(ctx, sess_remove_cb);
+	} else {
+		SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+	}
+
+	if (d->session_tickets) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+		SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, ticket_key_cb);
+#else
+		SSL_CTX_set_tlsext_ticket_key_cb(ctx, ticket_key_cb);
+#endif
+	} else {
+		SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+	}
+
+	return 0;
+}
+
+void openssl_sess_destroy_dom(struct tls_domain *d)
+{
+	struct sess_data *sd = d->sess_cache;
+	struct sess_entry *e, *next;
+
+	if (!sd)
+		return;
+
+	for (e = sd->lru_head; e; e = next) {
+		next = e->lru_next;
+		shm_free(e);
+	}
+
+	lock_destroy(&sd->lock);
+	shm_free(sd);
+	d->sess_cache = NULL;
+}
+
+void openssl_sess_handshake_done(SSL *ssl)
+{
+	struct tls_domain *d;
+
+	d = SSL_get_ex_data(ssl, SSL_EX_DOM_IDX);
+	if (!d)
+		return;
+
+	__sync_fetch_and_add(&d->sess_stats.handshakes, 1);
+	if (SSL_session_reused(ssl))
+		__sync_fetch_and_add(&d->sess_stats.resumed, 1);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/*
+ * TLS session resumption, shared by all the OpenSIPS processes
+ *
+ * Each SIP worker has its own SSL_CTX, so neither the OpenSSL internal
+ * session cache, nor its (randomly generated) ticket keys are of any use
+ * when the connections of a client are handled by different processes.
+ *
+ * Instead, the sessions of a server domain are kept in a shm cache, in
+ * serialized (DER) form, bounded by the number of sessions and evicted in
+ * LRU order. The session tickets are protected by keys derived from a
+ * secret and the current rotation period, so all the processes - and all
+ * the instances sharing the secret - are able to decrypt them.
+ */
+
+#ifndef OPENSSL_SESS_CACHE_H
+#define OPENSSL_SESS_CACHE_H
+
+#include <openssl/ssl.h>
+
+#include "../tls_mgm/tls_helper.h"
+
+/* to be called from mod_init(), before the domains are initialized */
+int openssl_sess_init(void);
+
+/* set up the session resumption for one SSL_CTX of the domain */
+int openssl_sess_init_ctx(struct tls_domain *d, SSL_CTX *ctx);
+
+void openssl_sess_destroy_dom(struct tls_domain *d);
+
+/* account a completed server side handshake */
+void openssl_sess_handshake_done(SSL *ssl);
+
+#endif /* OPENSSL_SESS_CACHE_H */
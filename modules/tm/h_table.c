@@ -66,6 +66,14 @@ static struct s_table*  tm_table;
 
 int syn_branch = 1;
 
+/* number of branch-sized buffers in the per-transaction arena; 0 disables
+ * the arena */
+int tm_branch_arena = 0;
+
+/* each arena chunk is prefixed by its size */
+#define TM_BUF_HDR  8
+#define TM_BUF_CHUNK(_len_) (((_len_) + TM_BUF_HDR + 7) & ~7U)
+
 
 void reset_kr(void)
 {
@@ -143,10 +151,11 @@ void free_cell( struct cell* dead_cell )
 	for ( i =0 ; i<dead_cell->nr_of_outgoings;  i++ )
 	{
 		/* retransmission buffer */
-		if ( (b=dead_cell->uac[i].request.buffer.s) )
+		if ( (b=dead_cell->uac[i].request.buffer.s) &&
+		!tm_buf_in_arena(dead_cell, b) )
 			shm_free_bulk( b );
 		b=dead_cell->uac[i].local_cancel.buffer.s;
-		if (b!=0 && b!=BUSY_BUFFER)
+		if (b!=0 && b!=BUSY_BUFFER && !tm_buf_in_arena(dead_cell, b))
 			shm_free_bulk( b );
 		rpl=dead_cell->uac[i].reply;
 		if (rpl && rpl!=FAKED_REPLY && rpl->msg_flags&FL_SHM_CLONE) {
@@ -184,6 +193,10 @@ void free_cell( struct cell* dead_cell )
 	if ( dead_cell->extra_hdrs.s )
 		shm_free_bulk( dead_cell->extra_hdrs.s );
 
+	/* buffer arena */
+	if ( dead_cell->buf_arena )
+		shm_free_bulk( dead_cell->buf_arena );
+
 	/* the cell's body */
 	shm_free_bulk( dead_cell );
 
@@ -192,6 +205,72 @@ void free_cell( struct cell* dead_cell )
 
 
 
+int tm_buf_arena_init(struct cell *t, unsigned int len)
+{
+	unsigned int size;
+	char *arena;
+
+	/* leave some room for the later branches being larger */
+	size = tm_branch_arena * TM_BUF_CHUNK(len + (len>>2));
+
+	arena = shm_malloc(size);
+	if (!arena) {
+		LM_ERR("no more shm mem for a %u bytes buffer arena\n", size);
+		return -1;
+	}
+
+	t->buf_arena_size = size;
+	t->buf_arena_used = 0;
+	/* the arena may be used right away by a concurrent CANCEL */
+	__sync_synchronize();
+	t->buf_arena = arena;
+
+	return 0;
+}
+
+
+char *tm_buf_alloc(struct cell *t, unsigned int len)
+{
+	unsigned int size, used;
+	char *arena;
+
+	if ( (arena=t->buf_arena)==NULL )
+		return shm_malloc(len);
+
+	size = TM_BUF_CHUNK(len);
+	do {
+		used = t->buf_arena_used;
+		if (used + size > t->buf_arena_size) {
+			LM_DBG("arena of T=%p is full (%u/%u), falling back to shm\n",
+				t, used, t->buf_arena_size);
+			return shm_malloc(len);
+		}
+	} while (__sync_val_compare_and_swap(&t->buf_arena_used,
+		used, used + size)!=used);
+
+	*(unsigned int*)(arena + used) = size;
+	return arena + used + TM_BUF_HDR;
+}
+
+
+void tm_buf_free(struct cell *t, char *buf)
+{
+	unsigned int off;
+
+	if (!tm_buf_in_arena(t, buf)) {
+		shm_free(buf);
+		return;
+	}
+
+	/* only the last chunk may be given back (a rebuilt branch or a sent
+	 * ACK), the others are released together with the whole arena */
+	off = buf - TM_BUF_HDR - t->buf_arena;
+	__sync_bool_compare_and_swap(&t->buf_arena_used,
+		off + *(unsigned int*)(buf - TM_BUF_HDR), off);
+}
+
+
+
 static inline void init_synonym_id( struct cell *t )
 {
 	struct sip_msg *p_msg;
@@ -305,6 +305,12 @@ typedef struct cell
 
 	/* extra T headers */
 	str extra_hdrs;
+
+	/* shm arena holding the branch requests and the local CANCELs/ACKs,
+	 * sized from the first branch; NULL if not used */
+	char *buf_arena;
+	unsigned int buf_arena_size;
+	volatile unsigned int buf_arena_used;
 }cell_type;
 
 
@@ -364,6 +370,7 @@ struct s_table
 
 
 extern int syn_branch;
+extern int tm_branch_arena;
 extern int fr_timeout;
 extern int fr_inv_timeout;
 extern int tm_timer_shift;
@@ -386,6 +393,20 @@ void   insert_into_hash_table_unsafe( struct cell * p_cell, unsigned int _hash )
 
 unsigned int transaction_count( void );
 
+#define tm_buf_in_arena(_t_, _b_) \
+	((_t_)->buf_arena && (_b_)>=(_t_)->buf_arena && \
+		(_b_)<(_t_)->buf_arena+(_t_)->buf_arena_size)
+
+typedef void (*tbuf_free_f)(struct cell *t, char *buf);
+
+/* creates the buffer arena of @t, sized for tm_branch_arena buffers
+ * of about @len bytes */
+int tm_buf_arena_init(struct cell *t, unsigned int len);
+/* allocates a buffer from the arena of @t, if there is one and it still
+ * has room, or from shm otherwise */
+char *tm_buf_alloc(struct cell *t, unsigned int len);
+void tm_buf_free(struct cell *t, char *buf);
+
 /* Unix socket variant */
 int unixsock_hash(str* msg);
 
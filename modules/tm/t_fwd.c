@@ -226,9 +226,21 @@ error:
 	return -1;
 }
 
+static char *uac_buf_alloc(unsigned int len, void *param)
+{
+	struct cell *t = (struct cell*)param;
+
+	/* the arena is sized from the first branch */
+	if (tm_branch_arena && !t->buf_arena)
+		tm_buf_arena_init(t, len);
+
+	return tm_buf_alloc(t, len);
+}
+
 /* be aware and use it *all* the time between pre_* and post_* functions! */
-static inline char *print_uac_request(struct sip_msg *i_req, unsigned int *len,
-		struct socket_info *send_sock, enum sip_protos proto )
+static inline char *print_uac_request(struct cell *t, struct sip_msg *i_req,
+		unsigned int *len, struct socket_info *send_sock,
+		enum sip_protos proto )
 {
 	char *buf;
 	str *cid = NULL;
@@ -237,8 +249,8 @@ static inline char *print_uac_request(struct sip_msg *i_req, unsigned int *len,
 		cid = tm_via_cid();
 
 	/* build the shm buffer now */
-	buf=build_req_buf_from_sip_req( i_req, len, send_sock, proto,
-			cid, MSG_TRANS_SHM_FLAG);
+	buf=build_req_buf_from_sip_req_alloc( i_req, len, send_sock, proto,
+			cid, MSG_TRANS_SHM_FLAG, uac_buf_alloc, t);
 	if (!buf) {
 		LM_ERR("no more shm_mem\n");
 		ser_error=E_OUT_OF_MEM;
@@ -315,7 +327,7 @@ int add_blind_uac(void)  /*struct cell *t*/
 }
 
 
-static inline int update_uac_dst( struct sip_msg *request,
+static inline int update_uac_dst( struct cell *t, struct sip_msg *request,
 													struct ua_client *uac )
 {
 	struct socket_info* send_sock;
@@ -334,21 +346,26 @@ static inline int update_uac_dst( struct sip_msg *request,
 
 	if (send_sock!=uac->request.dst.send_sock) {
 		/* rebuild */
-		shbuf = print_uac_request( request, &len, send_sock,
+		/* free the old buffer first, so its arena room can be reused */
+		if (uac->request.buffer.s) {
+			tm_buf_free(t, uac->request.buffer.s);
+			uac->request.buffer.s = NULL;
+			uac->request.buffer.len = 0;
+		}
+
+		shbuf = print_uac_request( t, request, &len, send_sock,
 			uac->request.dst.proto);
 		if (!shbuf) {
 			ser_error=E_OUT_OF_MEM;
 			return -1;
 		}
 
-		if (uac->request.buffer.s)
-			shm_free(uac->request.buffer.s);
-
 		/* things went well, move ahead and install new buffer! */
 		uac->request.dst.send_sock = send_sock;
 		uac->request.dst.proto_reserved1 = 0;
 		uac->request.buffer.s = shbuf;
 		uac->request.buffer.len = len;
+		uac->uri.s = shbuf + request->first_line.u.request.method.len + 1;
 	}
 
 	return 0;
@@ -453,7 +470,7 @@ static int add_uac( struct cell *t, struct sip_msg *request, const str *uri,
 	t->uac[branch].request.dst.proto = proxy->proto;
 
 	/* do print of the uac request */
-	if ( update_uac_dst( request, &t->uac[branch] )!=0) {
+	if ( update_uac_dst( t, request, &t->uac[branch] )!=0) {
 		ret = ser_error;
 		goto error02;
 	}
@@ -850,14 +867,15 @@ int t_forward_nonack( struct cell *t, struct sip_msg* p_msg ,
 					break;
 				t->uac[i].request.dst.proto = t->uac[i].proxy->proto;
 				/* update branch */
-				if ( update_uac_dst( p_msg, &t->uac[i] )!=0)
+				if ( update_uac_dst( t, p_msg, &t->uac[i] )!=0)
 					break;
 			}while(1);
 
 			tcp_no_new_conn = 0;
 
 			if (ser_error) {
-				shm_free(t->uac[i].request.buffer.s);
+				if (t->uac[i].request.buffer.s)
+					tm_buf_free(t, t->uac[i].request.buffer.s);
 				t->uac[i].request.buffer.s = NULL;
 				t->uac[i].request.buffer.len = 0;
 				continue;
@@ -203,7 +203,7 @@ char *build_local(struct cell *Trans,unsigned int branch,
 	*len+=LOCAL_MAXFWD_HEADER_LEN + CONTENT_LENGTH_LEN+1 + (extra?extra->len:0)
 		+ (Trans->extra_hdrs.s?Trans->extra_hdrs.len:0) + CRLF_LEN + CRLF_LEN;
 
-	cancel_buf=shm_malloc( *len+1 );
+	cancel_buf=tm_buf_alloc( Trans, *len+1 );
 	if (!cancel_buf)
 	{
 		LM_ERR("no more share memory\n");
@@ -522,7 +522,7 @@ char *build_dlg_ack(struct sip_msg* rpl, struct cell *Trans,
 	/* Content Length, EoM */
 	*len += CONTENT_LENGTH_LEN + 1 + CRLF_LEN + CRLF_LEN;
 
-	req_buf = shm_malloc(*len + 1);
+	req_buf = tm_buf_alloc(Trans, *len + 1);
 	if (!req_buf) {
 		LM_ERR("no more share memory\n");
 		goto error01;
@@ -321,7 +321,7 @@ static int send_ack(struct sip_msg* rpl, struct cell *trans, int branch)
 
 	tcp_no_new_conn = 0;
 
-	shm_free(ack_buf.s);
+	tm_buf_free(trans, ack_buf.s);
 
 	return 0;
 error:
@@ -314,6 +314,8 @@ static param_export_t params[]={
 		&tm_cluster_param.s },
 	{ "cluster_auto_cancel",      INT_PARAM,
 		&tm_repl_auto_cancel },
+	{ "branch_arena_slots",       INT_PARAM,
+		&tm_branch_arena },
 	{0,0,0}
 };
 
@@ -681,6 +683,8 @@ int load_tm( struct tm_binds *tmb)
 	tmb->t_ctx_get_str = t_ctx_get_str;
 	tmb->t_ctx_get_ptr = t_ctx_get_ptr;
 
+	tmb->t_buf_free = tm_buf_free;
+
 	return 1;
 }
 
@@ -784,6 +788,12 @@ static int mod_init(void)
 		return -1;
 	}
 
+	if (tm_branch_arena < 0) {
+		LM_WARN("invalid branch_arena_slots %d, disabling the arena\n",
+			tm_branch_arena);
+		tm_branch_arena = 0;
+	}
+
 	/* how many timer sets do we need to create? */
 	timer_sets = (timer_partitions<=1)?1:timer_partitions ;
 
@@ -121,6 +121,9 @@ struct tm_binds {
 	t_ctx_get_int_f t_ctx_get_int;
 	t_ctx_get_str_f t_ctx_get_str;
 	t_ctx_get_ptr_f t_ctx_get_ptr;
+
+	/* releases a (replaced) branch request buffer of the transaction */
+	tbuf_free_f t_buf_free;
 };
 
 
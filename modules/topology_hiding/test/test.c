@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include <tap.h>
+
+#include "../../../dprint.h"
+#include "../../../ut.h"
+#include "../../../socket_info.h"
+#include "../../../mem/mem.h"
+
+#include "../topo_hiding_token.h"
+
+#define BENCH_TOKENS 100000
+
+static str rr_set = str_init("<sip:10.0.0.10;lr;ftag=a8f3c2d1>, "
+	"<sip:edge1.carrier.example.net;transport=tcp;lr>, "
+	"<sip:192.168.100.5:5080;lr;did=8a1.e21>");
+static str contact = str_init("sip:+14155550100@172.16.31.7:5062;transport=udp");
+
+static int roundtrip(struct socket_info *sock, char *token, int len)
+{
+	str tok = {token, len}, ct, rr;
+	struct socket_info *dsock;
+	char *rr_buf;
+	int ret;
+
+	if (th_token_decode(&tok, &ct, &dsock, &rr_buf, 7, 2, &rr) < 0)
+		return 0;
+
+	ret = str_match(&ct, &contact) && str_match(&rr, &rr_set) &&
+		dsock == sock && rr.s == rr_buf + 7;
+	pkg_free(rr_buf);
+	return ret;
+}
+
+/* encodes and decodes BENCH_TOKENS tokens */
+static void bench(const char *name, struct socket_info *sock)
+{
+	struct timeval start;
+	long enc_us, dec_us;
+	int i, len, failed = 0;
+	char *token;
+	str tok, ct, rr;
+	struct socket_info *dsock;
+	char *rr_buf;
+
+	len = th_token_len(&rr_set, &contact, sock);
+	token = pkg_malloc(len);
+	if (!ok(token != NULL, "%s: alloc", name))
+		return;
+
+	ok(th_token_encode(token, &rr_set, &contact, sock) == len,
+		"%s: encode", name);
+	ok(roundtrip(sock, token, len), "%s: decode", name);
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < BENCH_TOKENS; i++)
+		th_token_encode(token, &rr_set, &contact, sock);
+	enc_us = get_time_diff(&start);
+
+	tok.s = token;
+	tok.len = len;
+	gettimeofday(&start, NULL);
+	for (i = 0; i < BENCH_TOKENS; i++) {
+		if (th_token_decode(&tok, &ct, &dsock, &rr_buf, 7, 2, &rr) < 0)
+			failed++;
+		else
+			pkg_free(rr_buf);
+	}
+	dec_us = get_time_diff(&start);
+
+	ok(failed == 0, "%s: %d decodes", name, BENCH_TOKENS);
+
+	diag("%s: %d bytes token (%d bytes route set + contact), "
+		"encode %.2fus, decode %.2fus", name, len, rr_set.len + contact.len,
+		(double)enc_us / BENCH_TOKENS, (double)dec_us / BENCH_TOKENS);
+
+	pkg_free(token);
+}
+
+#ifdef TH_AEAD
+static void test_aead(struct socket_info *sock)
+{
+	char *token;
+	int len, i, tampered = 0;
+
+	th_contact_encode_key.s = "ToPoCtKeY";
+	ok(th_token_init() == 0, "aead: init");
+
+	len = th_token_len(&rr_set, &contact, sock);
+	token = pkg_malloc(len);
+	if (!ok(token != NULL, "aead: alloc"))
+		return;
+
+	th_token_encode(token, &rr_set, &contact, sock);
+
+	/* any change is detected (the last chars may only hold padding) */
+	for (i = 0; i < len - 4; i++) {
+		token[i] = token[i] == 'A' ? 'B' : 'A';
+		if (!roundtrip(sock, token, len))
+			tampered++;
+		th_token_encode(token, &rr_set, &contact, sock);
+	}
+	ok(tampered == len - 4, "aead: tampered tokens are rejected");
+
+	/* a token from another key */
+	th_token_destroy();
+	th_contact_encode_key.s = "OtHeRkEy";
+	th_token_init();
+	ok(!roundtrip(sock, token, len), "aead: foreign key is rejected");
+
+	pkg_free(token);
+	th_token_destroy();
+	th_contact_encode_key.s = "ToPoCtKeY";
+	th_token_init();
+	bench("aes-256-gcm", sock);
+
+	th_token_destroy();
+	th_contact_encode_cipher.s = "chacha20-poly1305";
+	th_token_init();
+	bench("chacha20-poly1305", sock);
+
+	th_token_destroy();
+	th_contact_encode_cipher.s = "aes-256-gcm";
+	th_contact_encode_key.s = NULL;
+}
+#endif
+
+void mod_tests(void)
+{
+	str host = str_init("127.0.0.1");
+	struct socket_info *sock;
+
+	sock = grep_sock_info(&host, 5060, PROTO_UDP);
+	if (!ok(sock != NULL, "find the listener"))
+		return;
+
+	bench("legacy", sock);
+
+#ifdef TH_AEAD
+	test_aead(sock);
+#endif
+}
@@ -25,6 +25,7 @@
 */
 
 #include "topo_hiding_logic.h"
+#include "topo_hiding_token.h"
 
 extern int force_dialog;
 extern struct tm_binds tm_api;
@@ -1557,8 +1558,8 @@ error:
 /* Via headers will be restored using the TM module, no need to save anything for them */
 static char* build_encoded_contact_suffix(struct sip_msg* msg,int *suffix_len)
 {
-	short rr_len,ct_len,addr_len,enc_len;
-	char *suffix_plain,*suffix_enc,*p,*s;
+	int enc_len;
+	char *suffix_enc,*s;
 	str rr_set = {NULL, 0};
 	str contact;
 	int i,total_len;
@@ -1566,9 +1567,6 @@ static char* build_encoded_contact_suffix(struct sip_msg* msg,int *suffix_len)
 	struct th_ct_params* el;
 	param_t *it;
 	int is_req = (msg->first_line.type==SIP_REQUEST)?1:0;
-	int local_len = sizeof(short) /* RR length */ +
-			sizeof(short) /* Contact length */ +
-			sizeof(short) /* bind addr */;
 
 	/* parse all headers as we can have multiple
 	   RR headers in the same message */
@@ -1582,9 +1580,6 @@ static char* build_encoded_contact_suffix(struct sip_msg* msg,int *suffix_len)
 			LM_ERR("failed to print route records \n");
 			return NULL;
 		}
-		rr_len = (short)rr_set.len;
-	} else {
-		rr_len = 0;
 	}
 
 	if ( parse_contact(msg->contact)<0 ||
@@ -1594,13 +1589,9 @@ static char* build_encoded_contact_suffix(struct sip_msg* msg,int *suffix_len)
 		goto error;
 	} else {
 		contact = ((contact_body_t *)msg->contact->parsed)->contacts->uri;
-		ct_len = (short)contact.len;
 	}
 
-	addr_len = (short)msg->rcv.bind_address->sock_str.len;
-	local_len += rr_len + ct_len + addr_len; 
-	enc_len = th_ct_enc_scheme == ENC_BASE64 ?
-		calc_word64_encode_len(local_len) : calc_word32_encode_len(local_len);
+	enc_len = th_token_len(&rr_set, &contact, msg->rcv.bind_address);
 	total_len = enc_len +  
 		1 /* ; */ + 
 		th_contact_encode_param.len + 
@@ -1662,41 +1653,17 @@ static char* build_encoded_contact_suffix(struct sip_msg* msg,int *suffix_len)
 		LM_ERR("no more pkg\n");
 		goto error;
 	}
-	suffix_plain = pkg_malloc(local_len+1);
-	if (!suffix_plain) {
-		LM_ERR("no more pkg\n");
-		goto error;
-	}
-
-	p = suffix_plain;
-	memcpy(p,&rr_len,sizeof(short));
-	p+= sizeof(short);
-	if (rr_len) {
-		memcpy(p,rr_set.s,rr_set.len);
-		p+= rr_set.len;
-	}
-	memcpy(p,&ct_len,sizeof(short));
-	p+= sizeof(short);
-	if (ct_len) {
-		memcpy(p,contact.s,contact.len);
-		p+= contact.len;
-	}
-	memcpy(p,&addr_len,sizeof(short));
-	p+= sizeof(short);
-	memcpy(p,msg->rcv.bind_address->sock_str.s,msg->rcv.bind_address->sock_str.len);
-	p+= msg->rcv.bind_address->sock_str.len;
-	for (i=0;i<(int)(p-suffix_plain);i++)
-		suffix_plain[i] ^= topo_hiding_ct_encode_pw.s[i%topo_hiding_ct_encode_pw.len];
 
 	s = suffix_enc;
 	*s++ = ';';
 	memcpy(s,th_contact_encode_param.s,th_contact_encode_param.len);
 	s+= th_contact_encode_param.len;
 	*s++ = '=';
-	if (th_ct_enc_scheme == ENC_BASE64)
-		word64encode((unsigned char*)s,(unsigned char *)suffix_plain,p-suffix_plain);
-	else
-		word32encode((unsigned char*)s,(unsigned char *)suffix_plain,p-suffix_plain);
+	if (th_token_encode(s, &rr_set, &contact, msg->rcv.bind_address) < 0) {
+		LM_ERR("failed to encode the contact info\n");
+		pkg_free(suffix_enc);
+		goto error;
+	}
 	s = s+enc_len;
 	
 	if (th_param_list) {
@@ -1745,7 +1712,6 @@ static char* build_encoded_contact_suffix(struct sip_msg* msg,int *suffix_len)
 
 	if (rr_set.s)
 		pkg_free(rr_set.s);
-	pkg_free(suffix_plain);
 	*suffix_len = total_len;
 	return suffix_enc;
 error:
@@ -1846,17 +1812,15 @@ error:
 
 static int topo_no_dlg_seq_handling(struct sip_msg *msg,str *info)
 {
-	int max_size,dec_len,i,size;
-	char *dec_buf,*p,*route=NULL,*hdrs,*remote_contact;
+	int i,size;
+	char *route=NULL,*remote_contact;
 	struct hdr_field *it;
-	str rr_buf,ct_buf,bind_buf;
+	str rr_buf,ct_buf;
 	rr_t *head = NULL, *rrp;
 	int next_strict=0;
 	struct sip_uri fru;
 	char* buf = msg->buf;
 	struct lump* lmp = NULL;
-	str host;
-	int port,proto;
 	struct socket_info *sock;
 
 	/* parse all headers to be sure that all RR and Contact hdrs are found */
@@ -1879,49 +1843,22 @@ static int topo_no_dlg_seq_handling(struct sip_msg *msg,str *info)
 		}
 	}
 
-	max_size = th_ct_enc_scheme == ENC_BASE64 ?
-		calc_max_word64_decode_len(info->len) :
-		calc_max_word32_decode_len(info->len);
-	dec_buf = pkg_malloc(max_size);
-	if (dec_buf==NULL) {
-		LM_ERR("No more pkg\n");
+	/* the route set is decoded with room around it, to be turned
+	 * into a Route header in place */
+	if (th_token_decode(info, &ct_buf, &sock, &route, ROUTE_LEN, CRLF_LEN,
+	&rr_buf) < 0) {
+		LM_ERR("failed to decode the contact info\n");
 		return -1;
 	}
 
-	if (th_ct_enc_scheme == ENC_BASE64)
-		dec_len = word64decode((unsigned char *)dec_buf,
-			(unsigned char *)info->s,info->len);
-	else
-		dec_len = word32decode((unsigned char *)dec_buf,
-			(unsigned char *)info->s,info->len);
-	for (i=0;i<dec_len;i++)
-		dec_buf[i] ^= topo_hiding_ct_encode_pw.s[i%topo_hiding_ct_encode_pw.len]; 
-
-	#define __extract_len_and_buf(_p, _len, _s) \
-		do { \
-			(_s).len = *(short *)p;\
-			if ((_s).len<0 || (_s).len>_len) {\
-				LM_ERR("bad length %d in encoded contact\n", (_s).len);\
-				goto err_free_buf;\
-			}\
-			(_s).s = _p + sizeof(short);\
-			_p += sizeof(short) + (_s).len;\
-			_len -= sizeof(short) + (_s).len;\
-		} while(0)
-
-	p = dec_buf;
-	size = dec_len;
-	__extract_len_and_buf(p, size, rr_buf);
-	__extract_len_and_buf(p, size, ct_buf);
-	__extract_len_and_buf(p, size, bind_buf);
-
 	LM_DBG("extracted routes [%.*s] , ct [%.*s] and bind [%.*s]\n",
-		rr_buf.len,rr_buf.s,ct_buf.len,ct_buf.s,bind_buf.len,bind_buf.s);
+		rr_buf.len,rr_buf.s,ct_buf.len,ct_buf.s,
+		sock ? sock->sock_str.len : 0, sock ? sock->sock_str.s : NULL);
 
 	if (rr_buf.len) {
 		if (parse_rr_body(rr_buf.s,rr_buf.len,&head) != 0) {
 			LM_ERR("failed parsing route set\n");
-			goto err_free_buf;
+			goto err_free_route;
 		}
 
 		if(parse_uri(head->nameaddr.uri.s, head->nameaddr.uri.len, &fru) < 0) {
@@ -1976,24 +1913,17 @@ static int topo_no_dlg_seq_handling(struct sip_msg *msg,str *info)
 			}
 
 			size = rr_buf.len + ROUTE_LEN + CRLF_LEN;
-			route = pkg_malloc(size+1);
-			if (route == 0) {
-				LM_ERR("no more pkg memory\n");
-				goto err_free_head;
-			}
-
 			memcpy(route,ROUTE_STR,ROUTE_LEN);
-			memcpy(route+ROUTE_LEN,rr_buf.s,rr_buf.len);
 			memcpy(route+ROUTE_LEN+rr_buf.len,CRLF,CRLF_LEN);
 
-			route[size] = 0;
-
 			if ((lmp = insert_new_lump_after(lmp,route,size,HDR_ROUTE_T)) == 0) {
 				LM_ERR("failed inserting new route set\n");
-				goto err_free_route;
+				goto err_free_head;
 			}
+			/* the lump owns it now */
+			route = NULL;
 
-			LM_DBG("Setting route  header to <%s> \n",route);
+			LM_DBG("Setting route  header to <%.*s> \n",size,lmp->u.value);
 			LM_DBG("setting dst_uri to <%.*s> \n",head->nameaddr.uri.len,
 					head->nameaddr.uri.s);
 
@@ -2034,25 +1964,20 @@ static int topo_no_dlg_seq_handling(struct sip_msg *msg,str *info)
 					goto err_free_head;
 				}
 
-				hdrs = rr_buf.s + head->len + 1;
-
-				size = rr_buf.len - head->len - 1 + ROUTE_LEN + CRLF_LEN;
-				route = pkg_malloc(size);
-				if (route == 0) {
-					LM_ERR("no more pkg memory\n");
-					goto err_free_head;
-				}
-
+				/* drop the first route, in place */
+				size = rr_buf.len - head->len - 1;
+				memmove(route+ROUTE_LEN,rr_buf.s + head->len + 1,size);
 				memcpy(route,ROUTE_STR,ROUTE_LEN);
-				memcpy(route+ROUTE_LEN,hdrs,rr_buf.len - head->len-1);
-				memcpy(route+ROUTE_LEN+rr_buf.len - head->len-1,CRLF,CRLF_LEN);
+				memcpy(route+ROUTE_LEN+size,CRLF,CRLF_LEN);
+				size += ROUTE_LEN + CRLF_LEN;
 
 				LM_DBG("Adding Route header : [%.*s] \n",size,route);
 
 				if ((lmp = insert_new_lump_after(lmp,route,size,HDR_ROUTE_T)) == 0) {
 					LM_ERR("failed inserting new route set\n");
-					goto err_free_route;
+					goto err_free_head;
 				}
+				route = NULL;
 			}
 
 			if (lmp == NULL) {
@@ -2060,7 +1985,7 @@ static int topo_no_dlg_seq_handling(struct sip_msg *msg,str *info)
 				if (lmp == 0)
 				{
 					LM_ERR("failed anchoring new lump\n");
-					return -1;
+					goto err_free_head;
 				}
 			}
 
@@ -2095,23 +2020,16 @@ static int topo_no_dlg_seq_handling(struct sip_msg *msg,str *info)
 		LM_ERR("failed to register TMCB\n");
 	}
 
-	if (bind_buf.len && bind_buf.s) {
-		LM_DBG("forcing send socket for req to [%.*s]\n",bind_buf.len,bind_buf.s);
-		if (parse_phostport( bind_buf.s, bind_buf.len, &host.s, &host.len,
-		&port, &proto)!=0) {
-			LM_ERR("bad socket <%.*s>\n", bind_buf.len, bind_buf.s);
-		} else {
-			sock = grep_sock_info( &host, (unsigned short)port, proto);
-			if (!sock) {
-				LM_WARN("non-local socket <%.*s>...ignoring\n", bind_buf.len, bind_buf.s);
-			}
-			msg->force_send_socket = sock;
-		}
+	if (sock) {
+		LM_DBG("forcing send socket for req to [%.*s]\n",
+			sock->sock_str.len,sock->sock_str.s);
+		msg->force_send_socket = sock;
 	}
 
-	if (rr_buf.len)
+	if (head)
 		free_rr(&head);
-	pkg_free(dec_buf);
+	if (route)
+		pkg_free(route);
 
 	if (topo_no_dlg_encode_contact(msg,0) < 0) {
 		LM_ERR("Failed to encode contact header \n");
@@ -2120,13 +2038,11 @@ static int topo_no_dlg_seq_handling(struct sip_msg *msg,str *info)
 
 	return 1;
 
+err_free_head:
+	if (head)
+		free_rr(&head);
 err_free_route:
 	if (route)
 		pkg_free(route);
-err_free_head:
-	if (rr_buf.len)
-		free_rr(&head);
-err_free_buf:
-	pkg_free(dec_buf);
 	return -1;
 }
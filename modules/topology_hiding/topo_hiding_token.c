@@ -0,0 +1,571 @@
+/**
+ * Topology Hiding Module
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <time.h>
+
+#ifdef TH_AEAD
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#endif
+
+#include "../../dprint.h"
+#include "../../ut.h"
+#include "../../pt.h"
+#include "../../resolve.h"
+#include "../../mem/mem.h"
+#include "topo_hiding_logic.h"
+#include "topo_hiding_token.h"
+
+extern str topo_hiding_ct_encode_pw;
+extern int th_ct_enc_scheme;
+
+str th_contact_encode_key = {NULL, 0};
+str th_contact_encode_cipher = str_init("aes-256-gcm");
+int th_contact_key_rotation = 3600;
+
+int th_ct_aead = 0;
+
+/* the binary tokens, before encoding / after decoding */
+static char *th_enc_buf, *th_dec_buf;
+static int th_enc_buf_len, th_dec_buf_len;
+
+static inline char *th_buf_get(char **buf, int *buf_len, int len)
+{
+	char *p;
+
+	if (len > *buf_len) {
+		p = pkg_realloc(*buf, len);
+		if (!p) {
+			LM_ERR("no more pkg memory\n");
+			return NULL;
+		}
+		*buf = p;
+		*buf_len = len;
+	}
+
+	return *buf;
+}
+
+#define th_text_len(_bin_len) \
+	(th_ct_enc_scheme == ENC_BASE64 ? \
+		calc_word64_encode_len(_bin_len) : calc_word32_encode_len(_bin_len))
+
+static inline void th_text_encode(char *out, char *bin, int len)
+{
+	if (th_ct_enc_scheme == ENC_BASE64)
+		word64encode((unsigned char *)out, (unsigned char *)bin, len);
+	else
+		word32encode((unsigned char *)out, (unsigned char *)bin, len);
+}
+
+static inline char *th_text_decode(str *token, int *len)
+{
+	char *bin;
+
+	bin = th_buf_get(&th_dec_buf, &th_dec_buf_len,
+		th_ct_enc_scheme == ENC_BASE64 ?
+			calc_max_word64_decode_len(token->len) :
+			calc_max_word32_decode_len(token->len));
+	if (!bin)
+		return NULL;
+
+	if (th_ct_enc_scheme == ENC_BASE64)
+		*len = word64decode((unsigned char *)bin,
+			(unsigned char *)token->s, token->len);
+	else
+		*len = word32decode((unsigned char *)bin,
+			(unsigned char *)token->s, token->len);
+
+	return bin;
+}
+
+
+/* legacy tokens */
+
+static inline int th_legacy_bin_len(str *rr, str *ct,
+		struct socket_info *sock)
+{
+	return sizeof(short) /* RR length */ + rr->len +
+		sizeof(short) /* Contact length */ + ct->len +
+		sizeof(short) /* bind addr */ + sock->sock_str.len;
+}
+
+static int th_legacy_encode(char *out, str *rr, str *ct,
+		struct socket_info *sock)
+{
+	short rr_len = (short)rr->len, ct_len = (short)ct->len,
+		addr_len = (short)sock->sock_str.len;
+	int i, len = th_legacy_bin_len(rr, ct, sock);
+	char *bin, *p;
+
+	bin = th_buf_get(&th_enc_buf, &th_enc_buf_len, len);
+	if (!bin)
+		return -1;
+
+	p = bin;
+	memcpy(p,&rr_len,sizeof(short));
+	p+= sizeof(short);
+	if (rr_len) {
+		memcpy(p,rr->s,rr->len);
+		p+= rr->len;
+	}
+	memcpy(p,&ct_len,sizeof(short));
+	p+= sizeof(short);
+	if (ct_len) {
+		memcpy(p,ct->s,ct->len);
+		p+= ct->len;
+	}
+	memcpy(p,&addr_len,sizeof(short));
+	p+= sizeof(short);
+	memcpy(p,sock->sock_str.s,sock->sock_str.len);
+
+	for (i=0;i<len;i++)
+		bin[i] ^= topo_hiding_ct_encode_pw.s[i%topo_hiding_ct_encode_pw.len];
+
+	th_text_encode(out, bin, len);
+	return th_text_len(len);
+}
+
+static int th_legacy_decode(str *token, str *ct, struct socket_info **sock,
+		char **rr_buf, int rr_head, int rr_tail, str *rr)
+{
+	char *p, *dec_buf;
+	str rr_bin, bind_buf, host;
+	int dec_len, size, i, port, proto;
+
+	dec_buf = th_text_decode(token, &dec_len);
+	if (!dec_buf)
+		return -1;
+
+	for (i=0;i<dec_len;i++)
+		dec_buf[i] ^= topo_hiding_ct_encode_pw.s[i%topo_hiding_ct_encode_pw.len];
+
+	#define __extract_len_and_buf(_p, _len, _s) \
+		do { \
+			if (_len < (int)sizeof(short)) {\
+				LM_ERR("truncated encoded contact\n");\
+				return -1;\
+			}\
+			(_s).len = *(short *)p;\
+			if ((_s).len<0 || (_s).len>_len) {\
+				LM_ERR("bad length %d in encoded contact\n", (_s).len);\
+				return -1;\
+			}\
+			(_s).s = _p + sizeof(short);\
+			_p += sizeof(short) + (_s).len;\
+			_len -= sizeof(short) + (_s).len;\
+		} while(0)
+
+	p = dec_buf;
+	size = dec_len;
+	__extract_len_and_buf(p, size, rr_bin);
+	__extract_len_and_buf(p, size, *ct);
+	__extract_len_and_buf(p, size, bind_buf);
+
+	#undef __extract_len_and_buf
+
+	*sock = NULL;
+	if (bind_buf.len) {
+		if (parse_phostport( bind_buf.s, bind_buf.len, &host.s, &host.len,
+		&port, &proto)!=0) {
+			LM_ERR("bad socket <%.*s>\n", bind_buf.len, bind_buf.s);
+		} else {
+			*sock = grep_sock_info( &host, (unsigned short)port, proto);
+			if (!*sock)
+				LM_WARN("non-local socket <%.*s>...ignoring\n",
+					bind_buf.len, bind_buf.s);
+		}
+	}
+
+	if (!rr_bin.len) {
+		*rr_buf = NULL;
+		rr->s = NULL;
+		rr->len = 0;
+		return 0;
+	}
+
+	*rr_buf = pkg_malloc(rr_head + rr_bin.len + rr_tail);
+	if (!*rr_buf) {
+		LM_ERR("no more pkg memory\n");
+		return -1;
+	}
+	rr->s = *rr_buf + rr_head;
+	rr->len = rr_bin.len;
+	memcpy(rr->s, rr_bin.s, rr_bin.len);
+
+	return 0;
+}
+
+
+#ifdef TH_AEAD
+
+#define TH_TOKEN_VERSION 1
+#define TH_NONCE_LEN     12
+#define TH_TAG_LEN       16
+#define TH_HDR_LEN       (1 /* version */ + 1 /* key id */ + TH_NONCE_LEN)
+#define TH_META_LEN      (2 /* ct */ + 2 /* rr */ + 1 /* proto */ + \
+	1 /* ip len */ + 2 /* port */)
+
+/* the keys of the last few rotation intervals, derived on demand */
+#define TH_KEY_SLOTS 4
+
+struct th_key {
+	long epoch;
+	EVP_CIPHER_CTX *ectx;
+	EVP_CIPHER_CTX *dctx;
+};
+
+static struct th_key th_keys[TH_KEY_SLOTS];
+static const EVP_CIPHER *th_cipher;
+
+/* random prefix (per process) + counter */
+static unsigned char th_nonce[TH_NONCE_LEN];
+static unsigned int th_nonce_cnt;
+static int th_nonce_pid;
+
+static struct th_key *th_get_key(long epoch)
+{
+	struct th_key *k = &th_keys[epoch % TH_KEY_SLOTS];
+	unsigned char msg[64], key[EVP_MAX_MD_SIZE];
+	unsigned int key_len;
+	int len;
+
+	if (k->epoch == epoch)
+		return k;
+
+	/* key = HMAC-SHA256(secret, label | cipher | epoch) */
+	len = snprintf((char *)msg, sizeof msg, "opensips-th:%.*s:%ld",
+		th_contact_encode_cipher.len, th_contact_encode_cipher.s, epoch);
+	if (!HMAC(EVP_sha256(), th_contact_encode_key.s, th_contact_encode_key.len,
+			msg, len, key, &key_len)) {
+		LM_ERR("failed to derive the key\n");
+		return NULL;
+	}
+
+	if (EVP_EncryptInit_ex(k->ectx, th_cipher, NULL, key, NULL) != 1 ||
+			EVP_DecryptInit_ex(k->dctx, th_cipher, NULL, key, NULL) != 1) {
+		LM_ERR("failed to set up the key\n");
+		k->epoch = -1;
+		return NULL;
+	}
+
+	k->epoch = epoch;
+	return k;
+}
+
+static inline int th_aead_bin_len(str *rr, str *ct, struct socket_info *sock)
+{
+	return TH_HDR_LEN + TH_META_LEN + sock->address.len + ct->len + rr->len +
+		TH_TAG_LEN;
+}
+
+#define th_put_u16(_p, _v) \
+	do { \
+		(_p)[0] = (unsigned char)((_v) >> 8); \
+		(_p)[1] = (unsigned char)(_v); \
+	} while (0)
+#define th_get_u16(_p) (((unsigned short)(_p)[0] << 8) | (_p)[1])
+
+static int th_aead_encode(char *out, str *rr, str *ct,
+		struct socket_info *sock)
+{
+	unsigned char meta[TH_META_LEN + sizeof sock->address.u], *bin, *p;
+	int len = th_aead_bin_len(rr, ct, sock), n, meta_len;
+	long epoch = time(NULL) / th_contact_key_rotation;
+	struct th_key *k;
+
+	if (rr->len > 0xffff || ct->len > 0xffff) {
+		LM_ERR("route set / contact too long\n");
+		return -1;
+	}
+
+	k = th_get_key(epoch);
+	if (!k)
+		return -1;
+
+	bin = (unsigned char *)th_buf_get(&th_enc_buf, &th_enc_buf_len, len);
+	if (!bin)
+		return -1;
+
+	if (th_nonce_pid != my_pid() || th_nonce_cnt == 0) {
+		if (RAND_bytes(th_nonce, TH_NONCE_LEN - sizeof th_nonce_cnt) != 1) {
+			LM_ERR("failed to generate the nonce\n");
+			return -1;
+		}
+		th_nonce_pid = my_pid();
+		th_nonce_cnt = 1;
+	}
+	memcpy(th_nonce + TH_NONCE_LEN - sizeof th_nonce_cnt, &th_nonce_cnt,
+		sizeof th_nonce_cnt);
+	th_nonce_cnt++;
+
+	bin[0] = TH_TOKEN_VERSION;
+	bin[1] = (unsigned char)epoch;
+	memcpy(bin + 2, th_nonce, TH_NONCE_LEN);
+
+	th_put_u16(meta, ct->len);
+	th_put_u16(meta + 2, rr->len);
+	meta[4] = (unsigned char)sock->proto;
+	meta[5] = (unsigned char)sock->address.len;
+	th_put_u16(meta + 6, sock->port_no);
+	memcpy(meta + TH_META_LEN, sock->address.u.addr, sock->address.len);
+	meta_len = TH_META_LEN + sock->address.len;
+
+	p = bin + TH_HDR_LEN;
+	if (EVP_EncryptInit_ex(k->ectx, NULL, NULL, NULL, bin + 2) != 1 ||
+			EVP_EncryptUpdate(k->ectx, NULL, &n, bin, 2) != 1 ||
+			EVP_EncryptUpdate(k->ectx, p, &n, meta, meta_len) != 1)
+		goto error;
+	p += n;
+	if (ct->len) {
+		if (EVP_EncryptUpdate(k->ectx, p, &n, (unsigned char *)ct->s,
+				ct->len) != 1)
+			goto error;
+		p += n;
+	}
+	if (rr->len) {
+		if (EVP_EncryptUpdate(k->ectx, p, &n, (unsigned char *)rr->s,
+				rr->len) != 1)
+			goto error;
+		p += n;
+	}
+	if (EVP_EncryptFinal_ex(k->ectx, p, &n) != 1)
+		goto error;
+	p += n;
+	if (EVP_CIPHER_CTX_ctrl(k->ectx, EVP_CTRL_AEAD_GET_TAG, TH_TAG_LEN, p) != 1)
+		goto error;
+
+	th_text_encode(out, (char *)bin, len);
+	return th_text_len(len);
+
+error:
+	LM_ERR("failed to encrypt the token\n");
+	return -1;
+}
+
+static int th_aead_decode(str *token, str *ct, struct socket_info **sock,
+		char **rr_buf, int rr_head, int rr_tail, str *rr)
+{
+	unsigned char *bin, *p;
+	int len, n, rr_len;
+	long now, epoch;
+	unsigned char age;
+	struct th_key *k;
+	struct ip_addr ip;
+	unsigned short port;
+	int proto;
+
+	*rr_buf = NULL;
+
+	bin = (unsigned char *)th_text_decode(token, &len);
+	if (!bin)
+		return -1;
+
+	if (len < TH_HDR_LEN + TH_META_LEN + TH_TAG_LEN ||
+			bin[0] != TH_TOKEN_VERSION) {
+		LM_ERR("bad token\n");
+		return -1;
+	}
+
+	/* the key id is the (truncated) rotation interval; allow the peer's
+	 * clock to be one interval ahead */
+	now = time(NULL) / th_contact_key_rotation;
+	age = (unsigned char)(now - bin[1]);
+	epoch = age == 0xff ? now + 1 : now - age;
+
+	k = th_get_key(epoch);
+	if (!k)
+		return -1;
+
+	len -= TH_HDR_LEN + TH_TAG_LEN;
+	p = bin + TH_HDR_LEN;
+
+	/* nothing decrypted so far may be trusted before the final check */
+	if (EVP_DecryptInit_ex(k->dctx, NULL, NULL, NULL, bin + 2) != 1 ||
+			EVP_DecryptUpdate(k->dctx, NULL, &n, bin, 2) != 1 ||
+			EVP_DecryptUpdate(k->dctx, p, &n, p, TH_META_LEN) != 1)
+		goto error;
+
+	ct->len = th_get_u16(p);
+	rr_len = th_get_u16(p + 2);
+	proto = p[4];
+	ip.len = p[5];
+	port = th_get_u16(p + 6);
+	if ((ip.len != 4 && ip.len != 16) ||
+			TH_META_LEN + ip.len + ct->len + rr_len != len) {
+		LM_ERR("bad token\n");
+		return -1;
+	}
+	p += TH_META_LEN;
+
+	/* the address and the contact are decrypted in place */
+	if (EVP_DecryptUpdate(k->dctx, p, &n, p, ip.len + ct->len) != 1)
+		goto error;
+	memcpy(ip.u.addr, p, ip.len);
+	ip.af = ip.len == 4 ? AF_INET : AF_INET6;
+	ct->s = (char *)p + ip.len;
+	p += ip.len + ct->len;
+
+	/* while the route set goes straight to its final buffer */
+	if (rr_len) {
+		*rr_buf = pkg_malloc(rr_head + rr_len + rr_tail);
+		if (!*rr_buf) {
+			LM_ERR("no more pkg memory\n");
+			return -1;
+		}
+		rr->s = *rr_buf + rr_head;
+		rr->len = rr_len;
+		if (EVP_DecryptUpdate(k->dctx, (unsigned char *)rr->s, &n, p,
+				rr_len) != 1)
+			goto error;
+		p += rr_len;
+	} else {
+		rr->s = NULL;
+		rr->len = 0;
+	}
+
+	if (EVP_CIPHER_CTX_ctrl(k->dctx, EVP_CTRL_AEAD_SET_TAG, TH_TAG_LEN, p) != 1
+			|| EVP_DecryptFinal_ex(k->dctx, p, &n) != 1) {
+		LM_ERR("token authentication failed\n");
+		goto free_rr;
+	}
+
+	*sock = find_si(&ip, port, proto);
+	if (!*sock)
+		LM_WARN("non-local socket <%s:%d>...ignoring\n", ip_addr2a(&ip), port);
+
+	return 0;
+
+error:
+	LM_ERR("failed to decrypt the token\n");
+free_rr:
+	if (*rr_buf) {
+		pkg_free(*rr_buf);
+		*rr_buf = NULL;
+	}
+	return -1;
+}
+
+int th_token_init(void)
+{
+	int i;
+
+	if (!th_contact_encode_key.s)
+		return 0;
+
+	th_contact_encode_key.len = strlen(th_contact_encode_key.s);
+	th_contact_encode_cipher.len = strlen(th_contact_encode_cipher.s);
+
+	if (!str_strcmp(&th_contact_encode_cipher, const_str("aes-256-gcm"))) {
+		th_cipher = EVP_aes_256_gcm();
+	} else if (!str_strcmp(&th_contact_encode_cipher,
+			const_str("chacha20-poly1305"))) {
+		th_cipher = EVP_chacha20_poly1305();
+	} else {
+		LM_ERR("unsupported th_contact_encode_cipher '%.*s', use "
+			"'aes-256-gcm' or 'chacha20-poly1305'\n",
+			th_contact_encode_cipher.len, th_contact_encode_cipher.s);
+		return -1;
+	}
+
+	if (th_contact_key_rotation <= 0) {
+		LM_ERR("bad th_contact_key_rotation %d\n", th_contact_key_rotation);
+		return -1;
+	}
+
+	for (i = 0; i < TH_KEY_SLOTS; i++) {
+		th_keys[i].epoch = -1;
+		th_keys[i].ectx = EVP_CIPHER_CTX_new();
+		th_keys[i].dctx = EVP_CIPHER_CTX_new();
+		if (!th_keys[i].ectx || !th_keys[i].dctx) {
+			LM_ERR("failed to allocate the cipher contexts\n");
+			return -1;
+		}
+	}
+
+	th_ct_aead = 1;
+	return 0;
+}
+
+void th_token_destroy(void)
+{
+	int i;
+
+	for (i = 0; i < TH_KEY_SLOTS; i++) {
+		if (th_keys[i].ectx)
+			EVP_CIPHER_CTX_free(th_keys[i].ectx);
+		if (th_keys[i].dctx)
+			EVP_CIPHER_CTX_free(th_keys[i].dctx);
+		th_keys[i].ectx = th_keys[i].dctx = NULL;
+	}
+
+	th_ct_aead = 0;
+}
+
+#else
+
+int th_token_init(void)
+{
+	if (th_contact_encode_key.s) {
+		LM_ERR("th_contact_encode_key set, but the module was built without "
+			"AEAD support (OpenSSL 1.1.0 or newer is required)\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+void th_token_destroy(void)
+{
+}
+
+#endif /* TH_AEAD */
+
+
+int th_token_len(str *rr, str *ct, struct socket_info *sock)
+{
+#ifdef TH_AEAD
+	if (th_ct_aead)
+		return th_text_len(th_aead_bin_len(rr, ct, sock));
+#endif
+	return th_text_len(th_legacy_bin_len(rr, ct, sock));
+}
+
+int th_token_encode(char *out, str *rr, str *ct, struct socket_info *sock)
+{
+#ifdef TH_AEAD
+	if (th_ct_aead)
+		return th_aead_encode(out, rr, ct, sock);
+#endif
+	return th_legacy_encode(out, rr, ct, sock);
+}
+
+int th_token_decode(str *token, str *ct, struct socket_info **sock,
+		char **rr_buf, int rr_head, int rr_tail, str *rr)
+{
+#ifdef TH_AEAD
+	if (th_ct_aead)
+		return th_aead_decode(token, ct, sock, rr_buf, rr_head, rr_tail, rr);
+#endif
+	return th_legacy_decode(token, ct, sock, rr_buf, rr_head, rr_tail, rr);
+}
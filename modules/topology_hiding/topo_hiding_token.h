@@ -0,0 +1,73 @@
+/**
+ * Topology Hiding Module
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/*
+ * The state token carried in the Contact, when topology hiding is done
+ * without dialog: the route set, the Contact URI and the receiving socket
+ * of the message.
+ *
+ * Two formats are supported:
+ *  - the legacy one: the plain fields, XOR-ed with th_contact_encode_passwd
+ *  - the AEAD one (when th_contact_encode_key is set): a versioned binary
+ *    token, encrypted and authenticated with AES-256-GCM or
+ *    ChaCha20-Poly1305, with keys derived from the secret for each rotation
+ *    interval. Layout:
+ *      version(1) | key id(1) | nonce(12) |
+ *      encrypted: ct len(2) | rr len(2) | proto(1) | ip len(1) | port(2) |
+ *                 ip | ct | rr
+ *      | tag(16)
+ *
+ * In both cases, the binary token is base64/base32 encoded.
+ */
+
+#ifndef _TOPOH_TOKEN_H
+#define _TOPOH_TOKEN_H
+
+#include "../../str.h"
+#include "../../socket_info.h"
+
+extern str th_contact_encode_key;
+extern str th_contact_encode_cipher;
+extern int th_contact_key_rotation;
+
+/* set if the AEAD tokens are in use */
+extern int th_ct_aead;
+
+int th_token_init(void);
+void th_token_destroy(void);
+
+/* the length of the (text) token holding @rr, @ct and @sock */
+int th_token_len(str *rr, str *ct, struct socket_info *sock);
+
+/* writes the token at @out, which must have room for th_token_len() bytes;
+ * returns the number of written bytes or -1 */
+int th_token_encode(char *out, str *rr, str *ct, struct socket_info *sock);
+
+/* decodes a token: @ct points into an internal buffer, valid until the next
+ * call; @sock is NULL if the socket is not a local one. The route set is
+ * written straight into a new pkg buffer (*rr_buf, NULL if there is no
+ * route set), @rr_head bytes after its start and followed by @rr_tail free
+ * bytes, so that it can be turned into a header in place */
+int th_token_decode(str *token, str *ct, struct socket_info **sock,
+		char **rr_buf, int rr_head, int rr_tail, str *rr);
+
+#endif
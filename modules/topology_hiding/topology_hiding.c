@@ -29,6 +29,7 @@
 
 
 #include "topo_hiding_logic.h"
+#include "topo_hiding_token.h"
 
 struct tm_binds tm_api;
 struct dlg_binds dlg_api;
@@ -71,6 +72,9 @@ static param_export_t params[] = {
 	{ "th_contact_encode_passwd",    STR_PARAM, &topo_hiding_ct_encode_pw.s  },
 	{ "th_contact_encode_param",     STR_PARAM, &th_contact_encode_param.s   },
 	{ "th_contact_encode_scheme",    STR_PARAM, &th_contact_encode_scheme.s   },
+	{ "th_contact_encode_key",       STR_PARAM, &th_contact_encode_key.s     },
+	{ "th_contact_encode_cipher",    STR_PARAM, &th_contact_encode_cipher.s  },
+	{ "th_contact_key_rotation",     INT_PARAM, &th_contact_key_rotation     },
 	{0, 0, 0}
 };
 
@@ -153,6 +157,11 @@ static int mod_init(void)
 		goto error;
 	}
 
+	if (th_token_init() < 0) {
+		LM_ERR("failed to init the contact encoding\n");
+		goto error;
+	}
+
 
 	/* loading dependencies */
 	if (load_tm_api(&tm_api)!=0) {
@@ -194,7 +203,7 @@ error:
 
 static void mod_destroy(void)
 {
-	return;
+	th_token_destroy();
 }
 
 static int fixup_mmode(void **param)
@@ -73,6 +73,9 @@ typedef enum flags {
 	/* Handle RFC 8599 Push Notifications when routing to this contact */
 	FL_PN_ON       = 1 << 2,
 
+	/* Restored from a snapshot, not yet confirmed by the DB (transient) */
+	FL_SNAPSHOT    = 1 << 3,
+
 	FL_ALL         = (int)0xFFFFFFFF  /*!< All flags set */
 } ucontact_flags_t;
 
@@ -27,6 +27,7 @@
 #include "../../mem/shm_mem.h"
 #include "../../dprint.h"
 #include "../../db/db.h"
+#include "../../db/db_preload.h"
 #include "../../socket_info.h"
 #include "../../ut.h"
 #include "../../hash_func.h"
@@ -420,285 +421,290 @@ static inline ucontact_info_t* dbrow2info(db_val_t *vals, str *contact)
 }
 
 
-int preload_udomain(db_con_t* _c, udomain_t* _d)
+struct ul_preload_ctx {
+	udomain_t *d;
+	int merge;
+	char suggest_regen;
+};
+
+static int preload_udomain_row(db_val_t *vals, int n_vals, void *param)
 {
-	/* no use to try prepared statements here as this query is performed
-	   once at startup -bogdan */
+	struct ul_preload_ctx *ctx = (struct ul_preload_ctx *)param;
+	udomain_t *d = ctx->d;
 	int sl;
 	char uri[MAX_URI_SIZE];
 	ucontact_info_t *ci;
-	db_row_t *row;
-	db_key_t columns[UL_COLS];
-	db_res_t* res = NULL;
 	str user, contact;
 	char* domain;
-	int i;
-	int n;
 	int ret;
-	int no_rows = 10;
 	unsigned short aorhash, clabel;
 	unsigned int   rlabel;
-	UNUSED(n);
-
-	char suggest_regen=0;
+	time_t old_expires = 0;
 
 	urecord_t* r;
 	ucontact_t* c;
 
-	/* user column first in order to check if null */
-	columns[0] = &user_col;
-	columns[1] = &contactid_col;
-	columns[2] = &contact_col;
-	columns[3] = &expires_col;
-	columns[4] = &q_col;
-	columns[5] = &callid_col;
-	columns[6] = &cseq_col;
-	columns[7] = &flags_col;
-	columns[8] = &cflags_col;
-	columns[9] = &user_agent_col;
-	columns[10] = &received_col;
-	columns[11] = &path_col;
-	columns[12] = &sock_col;
-	columns[13] = &methods_col;
-	columns[14] = &last_mod_col;
-	columns[15] = &sip_instance_col;
-	columns[16] = &kv_store_col;
-	columns[17] = &attr_col;
-	columns[UL_COLS - 1] = &domain_col; /* "domain" always stays last */
 
-	if (ul_dbf.use_table(_c, _d->name) < 0) {
-		LM_ERR("sql use_table failed\n");
-		return -1;
+	user.s = (char*)VAL_STRING(vals);
+	if (VAL_NULL(vals) || user.s==0 || user.s[0]==0) {
+		LM_CRIT("empty username record in table %s...skipping\n",
+				d->name->s);
+		return 0;
 	}
+	user.len = strlen(user.s);
 
-#ifdef EXTRA_DEBUG
-	LM_NOTICE("load start time [%d]\n", (int)time(NULL));
-#endif
+	ci = dbrow2info( vals+1, &contact);
+	if (ci==0) {
+		LM_ERR("sipping record for %.*s in table %s\n",
+				user.len, user.s, d->name->s);
+		return 0;
+	}
 
-	if (DB_CAPABILITY(ul_dbf, DB_CAP_FETCH)) {
-		if (ul_dbf.query(_c, 0, 0, 0, columns, 0,
-		                 use_domain ? UL_COLS : UL_COLS - 1, 0, 0) < 0) {
-			LM_ERR("db_query (1) failed\n");
-			return -1;
-		}
-		no_rows = estimate_available_rows( 8+32+64+4+8+128+8+4+4+64
-			+32+128+16+8+8+255+255+32+255, UL_COLS);
-		if (no_rows==0) no_rows = 10;
-		if(ul_dbf.fetch_result(_c, &res, no_rows)<0) {
-			LM_ERR("fetching rows failed\n");
-			return -1;
+	if (use_domain) {
+		domain = (char*)VAL_STRING(vals + UL_COLS - 1);
+		if (VAL_NULL(vals + UL_COLS - 1) || !domain ||
+		     domain[0] == '\0'){
+			LM_CRIT("empty domain record for user %.*s...skipping\n",
+					user.len, user.s);
+			return 0;
 		}
-	} else {
-		if (ul_dbf.query(_c, 0, 0, 0, columns, 0,
-		                 use_domain ? UL_COLS : UL_COLS - 1, 0, &res) < 0) {
-			LM_ERR("db_query failed\n");
-			return -1;
+		/* user.s cannot be NULL - checked previosly */
+		user.len = snprintf(uri, MAX_URI_SIZE, "%.*s@%s",
+			user.len, user.s, domain);
+		user.s = uri;
+		if (user.s[user.len]!=0) {
+			LM_CRIT("URI '%.*s@%s' longer than %d\n", user.len, user.s,
+					domain,	MAX_URI_SIZE);
+			return 0;
 		}
 	}
 
-	if (RES_ROW_N(res) == 0) {
-		LM_DBG("table is empty\n");
-		ul_dbf.free_result(_c, res);
-		return 0;
-	}
+	unpack_indexes(ci->contact_id, &aorhash, &rlabel, &clabel);
 
+	lock_udomain(d, &user);
 
-	n = 0;
-	do {
-		LM_DBG("loading records - cycle [%d]\n", ++n);
-		for(i = 0; i < RES_ROW_N(res); i++) {
-			time_t old_expires = 0;
-			row = RES_ROWS(res) + i;
+	if ((ret=get_urecord(d, &user, &r)) > 0) {
+		if (mem_insert_urecord(d, &user, &r) < 0) {
+			LM_ERR("failed to create a record\n");
+			unlock_udomain(d, &user);
+			return -1;
+		}
 
-			user.s = (char*)VAL_STRING(ROW_VALUES(row));
-			if (VAL_NULL(ROW_VALUES(row)) || user.s==0 || user.s[0]==0) {
-				LM_CRIT("empty username record in table %s...skipping\n",
-						_d->name->s);
-				continue;
-			}
-			user.len = strlen(user.s);
+		/* set the record label */
+		sl = r->aorhash&(d->size-1);
+
+		if ((unsigned short)r->aorhash == aorhash) {
+			r->label = rlabel;
+		}/* else we'll get in trouble below */
 
-			ci = dbrow2info( ROW_VALUES(row)+1, &contact);
-			if (ci==0) {
-				LM_ERR("sipping record for %.*s in table %s\n",
-						user.len, user.s, _d->name->s);
-				continue;
+	} else if (ret < 0) {
+		unlock_udomain(d, &user);
+		return -1;
+	} else {
+		/* record found */
+		sl = r->aorhash&(d->size-1);
+	}
+
+	if ((unsigned short)r->aorhash != aorhash) {
+		/* we've got an invalid contact;
+		 * if regeneration not set we throw error else we will try generate
+		 * new indexes for record and contact labels */
+		if ( !cid_regen ) {
+			ctx->suggest_regen=1;
+			LM_ERR("failed to match aorhashes for user %.*s,"
+					"db aorhash [%u] new aorhash [%u],"
+					"db contactid [%" PRIu64 "]\n",
+					user.len, user.s, aorhash,
+					(unsigned short)(r->aorhash&(d->size-1)),
+					ci->contact_id);
+			if (ret > 0) {
+				LM_DBG("release bogus urecord\n");
+				release_urecord(r, 0);
 			}
+			unlock_udomain(d, &user);
+			return 0;
+		} else {
+			/* invalid contact
+			 * regenerate aor label and contact label if they're not */
+			if ( r->label == 0 ) {
+				if (d->table[sl].next_label == 0)
+					d->table[sl].next_label = rand();
 
-			if (use_domain) {
-				domain = (char*)VAL_STRING(ROW_VALUES(row) + UL_COLS - 1);
-				if (VAL_NULL(ROW_VALUES(row) + UL_COLS - 1) || !domain ||
-				     domain[0] == '\0'){
-					LM_CRIT("empty domain record for user %.*s...skipping\n",
-							user.len, user.s);
-					continue;
-				}
-				/* user.s cannot be NULL - checked previosly */
-				user.len = snprintf(uri, MAX_URI_SIZE, "%.*s@%s",
-					user.len, user.s, domain);
-				user.s = uri;
-				if (user.s[user.len]!=0) {
-					LM_CRIT("URI '%.*s@%s' longer than %d\n", user.len, user.s,
-							domain,	MAX_URI_SIZE);
-					continue;
-				}
+				r->label = CID_NEXT_RLABEL(d, sl);
+			} else {
+				if (d->table[sl].next_label == 0)
+					d->table[sl].next_label = r->label;
 			}
 
-			unpack_indexes(ci->contact_id, &aorhash, &rlabel, &clabel);
+			if (r->next_clabel == 0)
+				r->next_clabel = rand();
 
-			lock_udomain(_d, &user);
+			old_expires = ci->expires;
 
-			if ((ret=get_urecord(_d, &user, &r)) > 0) {
-				if (mem_insert_urecord(_d, &user, &r) < 0) {
-					LM_ERR("failed to create a record\n");
-					unlock_udomain(_d, &user);
-					goto error;
-				}
+			/* mark contact with broken contact id as expired for deletion */
+			ci->expires = 1;
+		}
+	} else {
+		/* we've got a valid contact */
+		/* update indexes accordingly */
+		sl = r->aorhash&(d->size-1);
 
-				/* set the record label */
-				sl = r->aorhash&(_d->size-1);
+		if (d->table[sl].next_label <= rlabel)
+			d->table[sl].next_label = rlabel + 1;
 
-				if ((unsigned short)r->aorhash == aorhash) {
-					r->label = rlabel;
-				}/* else we'll get in trouble below */
+		if (r->next_clabel <= clabel || r->next_clabel == 0)
+			r->next_clabel = CLABEL_INC_AND_TEST(clabel);
 
-			} else if (ret < 0) {
-				unlock_udomain(_d, &user);
-				goto error;
-			} else {
-				/* record found */
-				sl = r->aorhash&(_d->size-1);
-			}
+		r->label = rlabel;
+	}
 
-			if ((unsigned short)r->aorhash != aorhash) {
-				/* we've got an invalid contact;
-				 * if regeneration not set we throw error else we will try generate
-				 * new indexes for record and contact labels */
-				if ( !cid_regen ) {
-					suggest_regen=1;
-					LM_ERR("failed to match aorhashes for user %.*s,"
-							"db aorhash [%u] new aorhash [%u],"
-							"db contactid [%" PRIu64 "]\n",
-							user.len, user.s, aorhash,
-							(unsigned short)(r->aorhash&(_d->size-1)),
-							ci->contact_id);
-					if (ret > 0) {
-						LM_DBG("release bogus urecord\n");
-						release_urecord(r, 0);
-					}
-					unlock_udomain(_d, &user);
-					continue;
-				} else {
-					/* invalid contact
-					 * regenerate aor label and contact label if they're not */
-					if ( r->label == 0 ) {
-						if (_d->table[sl].next_label == 0)
-							_d->table[sl].next_label = rand();
-
-						r->label = CID_NEXT_RLABEL(_d, sl);
-					} else {
-						if (_d->table[sl].next_label == 0)
-							_d->table[sl].next_label = r->label;
-					}
 
-					if (r->next_clabel == 0)
-						r->next_clabel = rand();
+	if (ctx->merge) {
+		for (c = r->contacts; c; c = c->next)
+			if (c->contact_id == ci->contact_id)
+				break;
+
+		/* the DB holds a newer version of the contact */
+		if (c) {
+			ci->c = &contact;
+			if (mem_update_ucontact(c, ci) < 0)
+				LM_ERR("failed to update contact %"PRIu64"\n",
+				       ci->contact_id);
+			c->state = CS_SYNC;
+			unlock_udomain(d, &user);
+			return 0;
+		}
+	}
+
+	if ( (c=mem_insert_ucontact(r, &contact, ci)) == 0) {
+		LM_ERR("inserting contact failed\n"
+				"Found a bad contact with id:[%" PRIu64 "] "
+				"aor:[%.*s] contact:[%.*s] received:[%.*s]!\n"
+				"Will continue but that contact needs to be REMOVED!!\n",
+				ci->contact_id,
+				r->aor.len, r->aor.s,
+				contact.len, contact.s,
+				ci->received.len, ci->received.s);
+		unlock_udomain(d, &user);
+		free_ucontact(c);
+		return 0;
+	}
 
-					old_expires = ci->expires;
 
-					/* mark contact with broken contact id as expired for deletion */
-					ci->expires = 1;
-				}
-			} else {
-				/* we've got a valid contact */
-				/* update indexes accordingly */
-				sl = r->aorhash&(_d->size-1);
+	/* We have to do this, because insert_ucontact sets state to CS_NEW
+	 * and we have the contact in the database already */
+	/* if contact id regeneration requested then we need to update the
+	 * database so we set the state to CS_DIRTY */
+	if ( !cid_regen )
+		c->state = CS_SYNC;
+	else {
+		/* mark for removal if we've it has an invalid aorhash */
+		if (old_expires)
+			c->state = CS_DIRTY;
+		else
+			c->state = CS_SYNC;
+	}
 
-				if (_d->table[sl].next_label <= rlabel)
-					_d->table[sl].next_label = rlabel + 1;
+	/* if we've found a broken contact id and regeneration set
+	 * reinsert the newly created contact that will have a valid contact id */
+	if (cid_regen && old_expires) {
+		/* rebuild the contact id for this contact */
+		ci->contact_id = pack_indexes(r->aorhash, r->label, r->next_clabel);
+		r->next_clabel = CLABEL_INC_AND_TEST(r->next_clabel);
 
-				if (r->next_clabel <= clabel || r->next_clabel == 0)
-					r->next_clabel = CLABEL_INC_AND_TEST(clabel);
+		ci->expires = old_expires;
 
-				r->label = rlabel;
-			}
+		if ( (c=mem_insert_ucontact(r, &contact, ci)) == 0) {
+			LM_ERR("inserting contact failed\n"
+					"Found a bad contact with id:[%" PRIu64 "] "
+					"aor:[%.*s] contact:[%.*s] received:[%.*s]!\n"
+					"Will continue but that contact needs to be REMOVED!!\n",
+					ci->contact_id,
+					r->aor.len, r->aor.s,
+					contact.len, contact.s,
+					ci->received.len, ci->received.s);
+			unlock_udomain(d, &user);
+			free_ucontact(c);
+			return 0;
+		}
 
+		/* mark for database insertion */
+		c->state = CS_NEW;
 
-			if ( (c=mem_insert_ucontact(r, &contact, ci)) == 0) {
-				LM_ERR("inserting contact failed\n"
-						"Found a bad contact with id:[%" PRIu64 "] "
-						"aor:[%.*s] contact:[%.*s] received:[%.*s]!\n"
-						"Will continue but that contact needs to be REMOVED!!\n",
-						ci->contact_id,
-						r->aor.len, r->aor.s,
-						contact.len, contact.s,
-						ci->received.len, ci->received.s);
-				unlock_udomain(_d, &user);
-				free_ucontact(c);
-				continue;
-			}
+		LM_DBG("regenerated contact id to %"PRIu64"\n", ci->contact_id);
+	}
 
+	unlock_udomain(d, &user);
 
-			/* We have to do this, because insert_ucontact sets state to CS_NEW
-			 * and we have the contact in the database already */
-			/* if contact id regeneration requested then we need to update the
-			 * database so we set the state to CS_DIRTY */
-			if ( !cid_regen )
-				c->state = CS_SYNC;
-			else {
-				/* mark for removal if we've it has an invalid aorhash */
-				if (old_expires)
-					c->state = CS_DIRTY;
-				else
-					c->state = CS_SYNC;
-			}
+	return 0;
+}
 
-			/* if we've found a broken contact id and regeneration set
-			 * reinsert the newly created contact that will have a valid contact id */
-			if (cid_regen && old_expires) {
-				/* rebuild the contact id for this contact */
-				ci->contact_id = pack_indexes(r->aorhash, r->label, r->next_clabel);
-				r->next_clabel = CLABEL_INC_AND_TEST(r->next_clabel);
-
-				ci->expires = old_expires;
-
-				if ( (c=mem_insert_ucontact(r, &contact, ci)) == 0) {
-					LM_ERR("inserting contact failed\n"
-							"Found a bad contact with id:[%" PRIu64 "] "
-							"aor:[%.*s] contact:[%.*s] received:[%.*s]!\n"
-							"Will continue but that contact needs to be REMOVED!!\n",
-							ci->contact_id,
-							r->aor.len, r->aor.s,
-							contact.len, contact.s,
-							ci->received.len, ci->received.s);
-					unlock_udomain(_d, &user);
-					free_ucontact(c);
-					continue;
-				}
 
-				/* mark for database insertion */
-				c->state = CS_NEW;
+static int __preload_udomain(db_con_t* _c, udomain_t* _d, time_t since,
+                             int merge)
+{
+	/* no use to try prepared statements here as this query is performed
+	   once at startup -bogdan */
+	struct ul_preload_ctx ctx = {_d, merge, 0};
+	struct db_preload p;
+	db_key_t columns[UL_COLS];
+	db_key_t keys[1] = {&last_mod_col};
+	db_op_t ops[1] = {OP_GEQ};
+	db_val_t vals[1];
+	int sl;
 
-				LM_DBG("regenerated contact id to %"PRIu64"\n", ci->contact_id);
-			}
+	/* user column first in order to check if null */
+	columns[0] = &user_col;
+	columns[1] = &contactid_col;
+	columns[2] = &contact_col;
+	columns[3] = &expires_col;
+	columns[4] = &q_col;
+	columns[5] = &callid_col;
+	columns[6] = &cseq_col;
+	columns[7] = &flags_col;
+	columns[8] = &cflags_col;
+	columns[9] = &user_agent_col;
+	columns[10] = &received_col;
+	columns[11] = &path_col;
+	columns[12] = &sock_col;
+	columns[13] = &methods_col;
+	columns[14] = &last_mod_col;
+	columns[15] = &sip_instance_col;
+	columns[16] = &kv_store_col;
+	columns[17] = &attr_col;
+	columns[UL_COLS - 1] = &domain_col; /* "domain" always stays last */
 
-			unlock_udomain(_d, &user);
-		}
+	memset(&p, 0, sizeof p);
+	p.url = &db_url;
+	p.dbf = &ul_dbf;
+	p.table = _d->name;
+	p.cols = columns;
+	p.n_cols = use_domain ? UL_COLS : UL_COLS - 1;
+	/* the contact_id is spread all over the 64 bits */
+	p.split_key = &contactid_col;
+	p.row_size = 8+32+64+4+8+128+8+4+4+64+32+128+16+8+8+255+255+32+255;
 
-		if (DB_CAPABILITY(ul_dbf, DB_CAP_FETCH)) {
-			if(ul_dbf.fetch_result(_c, &res, no_rows)<0) {
-				LM_ERR("fetching rows (1) failed\n");
-				ul_dbf.free_result(_c, res);
-				return -1;
-			}
-		} else {
-			break;
-		}
-	} while(RES_ROW_N(res)>0);
+	if (since) {
+		VAL_TYPE(vals) = DB_DATETIME;
+		VAL_NULL(vals) = 0;
+		VAL_TIME(vals) = since;
 
-	ul_dbf.free_result(_c, res);
+		p.keys = keys;
+		p.ops = ops;
+		p.vals = vals;
+		p.n_keys = 1;
+	}
 
-	if ( suggest_regen ) {
+#ifdef EXTRA_DEBUG
+	LM_NOTICE("load start time [%d]\n", (int)time(NULL));
+#endif
+
+	if (db_preload_table(&p, _c, preload_udomain_row, &ctx) < 0) {
+		LM_ERR("failed to load table %.*s\n", _d->name->len, _d->name->s);
+		return -1;
+	}
+
+	if ( ctx.suggest_regen ) {
 		LM_NOTICE("At least 1 contact(s) from the database has invalid contact_id!\n"
 				"Possible causes for this can be:\n"
 				"\t* you are migrating your location table from a version older than 2.2\n"
@@ -720,9 +726,18 @@ int preload_udomain(db_con_t* _c, udomain_t* _d)
 #endif
 
 	return 0;
-error:
-	ul_dbf.free_result(_c, res);
-	return -1;
+}
+
+
+int preload_udomain(db_con_t* _c, udomain_t* _d)
+{
+	return __preload_udomain(_c, _d, 0, 0);
+}
+
+
+int preload_udomain_delta(db_con_t* _c, udomain_t* _d, time_t since)
+{
+	return __preload_udomain(_c, _d, since, 1);
 }
 
 
@@ -88,6 +88,13 @@ void free_udomain(udomain_t* _d);
 int preload_udomain(db_con_t* _c, udomain_t* _d);
 
 
+/*! \brief
+ * Load the rows changed since @since (all of them, if 0) into a domain
+ * which is already populated, updating the contacts found in memory
+ */
+int preload_udomain_delta(db_con_t* _c, udomain_t* _d, time_t since);
+
+
 /*! \brief
  * Check the DB validity of a domain
  */
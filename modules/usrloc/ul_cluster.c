@@ -58,6 +58,10 @@ int ul_init_cluster(void)
 		return -1;
 	}
 
+	if (clusterer_api.set_partitioned_sync(&contact_repl_cap,
+		location_cluster) < 0)
+		LM_WARN("cannot enable partitioned sync for contacts\n");
+
 	if (rr_persist == RRP_SYNC_FROM_CLUSTER &&
 	    clusterer_api.request_sync(&contact_repl_cap, location_cluster) < 0)
 		LM_ERR("Sync request failed\n");
@@ -976,11 +980,14 @@ static int receive_sync_request(int node_id)
 	struct urecord *r;
 	ucontact_t* c;
 	void **p;
-	int i;
+	int i, part_idx, part_no;
+
+	/* only send the hash slots in the requested partition */
+	clusterer_api.sync_partition(&part_idx, &part_no);
 
 	for (dl = root; dl; dl = dl->next) {
 		dom = dl->d;
-		for(i = 0; i < dom->size; i++) {
+		for(i = part_idx; i < dom->size; i += part_no) {
 			lock_ulslot(dom, i);
 			for (map_first(dom->table[i].records, &it);
 				iterator_is_valid(&it);
@@ -60,6 +60,7 @@
 #include "ul_evi.h"
 #include "ul_mi.h"
 #include "ul_callback.h"
+#include "ul_snapshot.h"
 #include "usrloc.h"
 
 #define CONTACTID_COL  "contact_id"
@@ -242,6 +243,11 @@ static param_export_t params[] = {
 	{ "max_contact_delete", INT_PARAM, &max_contact_delete },
 	{ "regen_broken_contactid", INT_PARAM, &cid_regen},
 
+	/* binary snapshots of the in-memory domains */
+	{ "snapshot_file",      STR_PARAM, &ul_snapshot_file   },
+	{ "snapshot_interval",  INT_PARAM, &ul_snapshot_interval },
+	{ "snapshot_loaders",   INT_PARAM, &ul_snapshot_loaders },
+
 	{0, 0, 0}
 };
 
@@ -400,6 +406,11 @@ static int mod_init(void)
 		return -1;
 	}
 
+	if (ul_init_snapshot() < 0) {
+		LM_ERR("failed to init the snapshot support\n");
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -408,13 +419,21 @@ static void ul_rpc_data_load(int sender_id, void *unsused)
 {
 	dlist_t* ptr;
 
-	for( ptr=root ; ptr ; ptr=ptr->next) {
-		if (preload_udomain(ul_dbh, ptr->d) < 0) {
-			LM_ERR("failed to preload domain '%.*s'\n",
-				ptr->name.len, ZSW(ptr->name.s));
-			/* continue with the other ul domains */;
+	/* if restored from a snapshot, only the delta is loaded from DB */
+	if (ul_snapshot_load() > 0)
+		return;
+
+	if (rr_persist == RRP_LOAD_FROM_SQL) {
+		for( ptr=root ; ptr ; ptr=ptr->next) {
+			if (preload_udomain(ul_dbh, ptr->d) < 0) {
+				LM_ERR("failed to preload domain '%.*s'\n",
+					ptr->name.len, ZSW(ptr->name.s));
+				/* continue with the other ul domains */;
+			}
 		}
 	}
+
+	ul_snapshot_loaded();
 }
 
 int init_cachedb(void)
@@ -441,20 +460,20 @@ static int child_init(int _rank)
 	    return -1;
 	}
 
-	if (!have_sql_con())
-		return 0;
-
 	/* we need connection from SIP workers only */
 	if (_rank < 1 )
 		return 0;
 
-	ul_dbh = ul_dbf.init(&db_url); /* Get a new database connection */
-	if (!ul_dbh) {
-		LM_ERR("child(%d): failed to connect to database\n", _rank);
-		return -1;
+	if (have_sql_con()) {
+		ul_dbh = ul_dbf.init(&db_url); /* Get a new database connection */
+		if (!ul_dbh) {
+			LM_ERR("child(%d): failed to connect to database\n", _rank);
+			return -1;
+		}
 	}
+
 	/* _rank==1 is used even when fork is disabled */
-	if (_rank==1 && rr_persist == RRP_LOAD_FROM_SQL) {
+	if (_rank==1 && (rr_persist == RRP_LOAD_FROM_SQL || ul_snapshot_file)) {
 		/* if cache is used, populate domains from DB */
 		if (ipc_send_rpc( process_no, ul_rpc_data_load, NULL)<0) {
 			LM_ERR("failed to fire RPC for data load\n");
@@ -517,6 +536,13 @@ static void destroy(void)
 		cdbf.destroy(cdbc);
 	cdbc = NULL;
 
+	/* after the DB flush, so the next startup has no DB delta to load */
+	if (ul_snapshot_file) {
+		ul_unlock_locks();
+		if (ul_snapshot_write(1) != 0)
+			LM_ERR("failed to write the final snapshot\n");
+	}
+
 	free_all_udomains();
 	ul_destroy_locks();
 
@@ -0,0 +1,649 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "../../dprint.h"
+#include "../../ipc.h"
+#include "../../locking.h"
+#include "../../timer.h"
+#include "../../socket_info.h"
+#include "../../mem/shm_mem.h"
+#include "../../lib/snapshot.h"
+
+#include "ul_mod.h"
+#include "ul_timer.h"
+#include "ul_snapshot.h"
+#include "dlist.h"
+#include "udomain.h"
+#include "urecord.h"
+#include "ucontact.h"
+#include "kv_store.h"
+#include "hslot.h"
+
+#define UL_SNAP_MAGIC    "OSIPSUL\0"
+#define UL_SNAP_VERSION  1
+
+#define UL_SNAP_MAX_LOADERS 64
+
+char *ul_snapshot_file;
+int ul_snapshot_interval = 300;
+int ul_snapshot_loaders = 4;
+
+struct ul_snap_load {
+	gen_lock_t lock;
+	int ready;          /* the startup loading is over */
+	int pending;        /* loaders still running */
+	int failed;         /* some slots could not be restored */
+	int final;          /* the snapshot was written on shutdown */
+	time_t created;
+	unsigned int records;
+	unsigned int contacts;
+	struct timeval start;
+};
+
+static struct ul_snap_load *snap_load;
+
+static void ul_snapshot_timer(unsigned int ticks, void *param);
+
+
+int ul_init_snapshot(void)
+{
+	if (!ul_snapshot_file)
+		return 0;
+
+	if (!have_mem_storage()) {
+		LM_ERR("'snapshot_file' requires a working mode with in-memory "
+		       "storage\n");
+		return -1;
+	}
+
+	if (ul_snapshot_loaders < 1)
+		ul_snapshot_loaders = 1;
+	else if (ul_snapshot_loaders > UL_SNAP_MAX_LOADERS)
+		ul_snapshot_loaders = UL_SNAP_MAX_LOADERS;
+
+	snap_load = shm_malloc(sizeof *snap_load);
+	if (!snap_load) {
+		LM_ERR("oom\n");
+		return -1;
+	}
+	memset(snap_load, 0, sizeof *snap_load);
+	lock_init(&snap_load->lock);
+
+	if (ul_snapshot_interval > 0 &&
+	    register_timer("ul-snapshot", ul_snapshot_timer, 0,
+	                   ul_snapshot_interval, TIMER_FLAG_SKIP_ON_DELAY) < 0) {
+		LM_ERR("failed to register the snapshot timer\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static int ul_snap_put_contact(struct snap_writer *w, ucontact_t *c)
+{
+	int64_t expires = c->expires, expires_out = c->expires_out,
+	        last_modified = c->last_modified;
+	uint32_t flags = c->flags, cflags = c->cflags, methods = c->methods;
+	int32_t q = c->q, cseq = c->cseq;
+	unsigned char state = c->state;
+	str kv = STR_NULL;
+	int rc;
+
+	if (c->kv_storage)
+		kv = store_serialize(c->kv_storage);
+
+	rc = (snap_put_val(w, c->contact_id) < 0 ||
+	    snap_put_val(w, expires) < 0 ||
+	    snap_put_val(w, expires_out) < 0 ||
+	    snap_put_val(w, last_modified) < 0 ||
+	    snap_put_val(w, q) < 0 ||
+	    snap_put_val(w, cseq) < 0 ||
+	    snap_put_val(w, flags) < 0 ||
+	    snap_put_val(w, cflags) < 0 ||
+	    snap_put_val(w, methods) < 0 ||
+	    snap_put_val(w, state) < 0 ||
+	    snap_put_str(w, &c->c) < 0 ||
+	    snap_put_str(w, &c->received) < 0 ||
+	    snap_put_str(w, &c->path) < 0 ||
+	    snap_put_str(w, &c->callid) < 0 ||
+	    snap_put_str(w, &c->user_agent) < 0 ||
+	    snap_put_str(w, &c->instance) < 0 ||
+	    snap_put_str(w, &c->attr) < 0 ||
+	    snap_put_str(w, c->sock ? &c->sock->sock_str : NULL) < 0 ||
+	    snap_put_str(w, &kv) < 0) ? -1 : 0;
+
+	store_free_buffer(&kv);
+	return rc;
+}
+
+
+static int ul_snap_put_record(struct snap_writer *w, urecord_t *r)
+{
+	uint32_t label = r->label, n = 0;
+	uint16_t next_clabel = r->next_clabel;
+	ucontact_t *c;
+	str kv = STR_NULL;
+	int rc;
+
+	for (c = r->contacts; c; c = c->next)
+		if (!(c->flags & FL_EXTRA_HOP))
+			n++;
+
+	if (!n)
+		return 0;
+
+	if (r->kv_storage)
+		kv = store_serialize(r->kv_storage);
+
+	rc = (snap_put_str(w, &r->aor) < 0 ||
+	    snap_put_val(w, label) < 0 ||
+	    snap_put_val(w, next_clabel) < 0 ||
+	    snap_put_val(w, n) < 0 ||
+	    snap_put_str(w, &kv) < 0) ? -1 : 0;
+
+	store_free_buffer(&kv);
+	if (rc < 0)
+		return -1;
+
+	for (c = r->contacts; c; c = c->next)
+		if (!(c->flags & FL_EXTRA_HOP) && ul_snap_put_contact(w, c) < 0)
+			return -1;
+
+	return 0;
+}
+
+
+int ul_snapshot_write(int final)
+{
+	struct snap_writer w;
+	map_iterator_t it;
+	dlist_t *dl;
+	udomain_t *d;
+	uint32_t size, next_label;
+	void **dest;
+	int sl;
+
+	/* do not overwrite the snapshot with partially loaded domains */
+	if (!snap_load || !snap_load->ready) {
+		LM_DBG("startup loading in progress, skipping the snapshot\n");
+		return 0;
+	}
+
+	if (snap_open_write(&w, ul_snapshot_file, UL_SNAP_MAGIC,
+	                    UL_SNAP_VERSION) < 0) {
+		LM_ERR("failed to start a new snapshot\n");
+		return -1;
+	}
+
+	for (dl = root; dl; dl = dl->next) {
+		d = dl->d;
+
+		/* the domain descriptor, followed by a block for each slot */
+		size = d->size;
+		if (snap_put_str(&w, d->name) < 0 || snap_put_val(&w, size) < 0 ||
+		    snap_end_block(&w) < 0)
+			goto error;
+
+		for (sl = 0; sl < d->size; sl++) {
+			lock_ulslot(d, sl);
+
+			next_label = d->table[sl].next_label;
+			snap_put_val(&w, next_label);
+
+			for (map_first(d->table[sl].records, &it);
+			     iterator_is_valid(&it); iterator_next(&it)) {
+				dest = iterator_val(&it);
+				if (!dest)
+					break;
+
+				if (ul_snap_put_record(&w, (urecord_t *)*dest) < 0)
+					break;
+			}
+
+			unlock_ulslot(d, sl);
+
+			if (snap_end_block(&w) < 0)
+				goto error;
+		}
+	}
+
+	if (snap_commit(&w, final ? SNAP_FL_FINAL : 0) < 0)
+		goto error;
+
+	return 0;
+
+error:
+	LM_ERR("failed to write the %s snapshot\n", ul_snapshot_file);
+	snap_abort(&w);
+	return -1;
+}
+
+
+static void ul_snapshot_timer(unsigned int ticks, void *param)
+{
+	ul_snapshot_write(0);
+}
+
+
+static int ul_snap_load_contact(struct snap_cursor *cur, urecord_t *r,
+                                int mark)
+{
+	ucontact_info_t ci;
+	ucontact_t *c;
+	int64_t expires, expires_out, last_modified;
+	uint32_t flags, cflags, methods;
+	int32_t q, cseq;
+	unsigned char state;
+	str contact, path, callid, ua, attr, sock, kv, host;
+	int port, proto;
+
+	memset(&ci, 0, sizeof ci);
+
+	if (snap_get_val(cur, ci.contact_id) < 0 ||
+	    snap_get_val(cur, expires) < 0 ||
+	    snap_get_val(cur, expires_out) < 0 ||
+	    snap_get_val(cur, last_modified) < 0 ||
+	    snap_get_val(cur, q) < 0 ||
+	    snap_get_val(cur, cseq) < 0 ||
+	    snap_get_val(cur, flags) < 0 ||
+	    snap_get_val(cur, cflags) < 0 ||
+	    snap_get_val(cur, methods) < 0 ||
+	    snap_get_val(cur, state) < 0 ||
+	    snap_get_str(cur, &contact) < 0 ||
+	    snap_get_str(cur, &ci.received) < 0 ||
+	    snap_get_str(cur, &path) < 0 ||
+	    snap_get_str(cur, &callid) < 0 ||
+	    snap_get_str(cur, &ua) < 0 ||
+	    snap_get_str(cur, &ci.instance) < 0 ||
+	    snap_get_str(cur, &attr) < 0 ||
+	    snap_get_str(cur, &sock) < 0 ||
+	    snap_get_str(cur, &kv) < 0)
+		return -1;
+
+	/* learned meanwhile, from the DB or from the cluster? */
+	for (c = r->contacts; c; c = c->next)
+		if (c->contact_id == ci.contact_id)
+			return 0;
+
+	ci.expires = expires;
+	ci.expires_out = expires_out;
+	ci.last_modified = last_modified;
+	ci.q = q;
+	ci.cseq = cseq;
+	ci.flags = flags;
+	ci.cflags = cflags;
+	ci.methods = methods;
+	ci.path = &path;
+	ci.callid = &callid;
+	ci.user_agent = &ua;
+	ci.attr = &attr;
+	ci.packed_kv_storage = &kv;
+
+	if (sock.s) {
+		if (parse_phostport(sock.s, sock.len, &host.s, &host.len,
+		                    &port, &proto) != 0) {
+			LM_ERR("bad socket <%.*s>\n", sock.len, sock.s);
+			return 0;
+		}
+
+		ci.sock = grep_sock_info(&host, (unsigned short)port, proto);
+		if (!ci.sock)
+			LM_DBG("non-local socket <%.*s>...ignoring\n", sock.len, sock.s);
+	}
+
+	c = mem_insert_ucontact(r, &contact, &ci);
+	if (!c) {
+		LM_ERR("failed to restore contact %.*s of %.*s\n",
+		       contact.len, contact.s, r->aor.len, r->aor.s);
+		return 0;
+	}
+
+	/* keep any pending DB write */
+	c->state = state;
+	if (mark && c->state == CS_SYNC)
+		c->flags |= FL_SNAPSHOT;
+
+	return 1;
+}
+
+
+static int ul_snap_load_slot(udomain_t *d, int sl, struct snap_cursor *cur,
+                             unsigned int *records, unsigned int *contacts)
+{
+	hslot_t *slot = &d->table[sl];
+	urecord_t *r;
+	uint32_t next_label, label, n;
+	uint16_t next_clabel;
+	str aor, kv;
+	int mark, rc;
+
+	/* the contacts still in the DB are confirmed by the delta loading */
+	mark = rr_persist == RRP_LOAD_FROM_SQL && !snap_load->final;
+
+	lock_ulslot(d, sl);
+
+	if (snap_get_val(cur, next_label) < 0)
+		goto error;
+
+	if (slot->next_label < next_label)
+		slot->next_label = next_label;
+
+	while (!snap_cursor_end(cur)) {
+		if (snap_get_str(cur, &aor) < 0 || !aor.s ||
+		    snap_get_val(cur, label) < 0 ||
+		    snap_get_val(cur, next_clabel) < 0 ||
+		    snap_get_val(cur, n) < 0 ||
+		    snap_get_str(cur, &kv) < 0)
+			goto error;
+
+		if (get_urecord(d, &aor, &r) > 0) {
+			if (mem_insert_urecord(d, &aor, &r) < 0) {
+				LM_ERR("failed to create a record\n");
+				goto error;
+			}
+
+			if (kv.s) {
+				store_destroy(r->kv_storage);
+				r->kv_storage = store_deserialize(&kv);
+			}
+
+			(*records)++;
+		}
+
+		r->label = label;
+		if (r->next_clabel < next_clabel)
+			r->next_clabel = next_clabel;
+
+		while (n--) {
+			rc = ul_snap_load_contact(cur, r, mark);
+			if (rc < 0)
+				goto error;
+			*contacts += rc;
+		}
+	}
+
+	unlock_ulslot(d, sl);
+	return 0;
+
+error:
+	unlock_ulslot(d, sl);
+	LM_ERR("malformed slot %d of domain %.*s\n", sl, d->name->len, d->name->s);
+	return -1;
+}
+
+
+/* drop the restored contacts which are no longer in the DB (deleted after
+ * the snapshot was taken), based on a scan of the "contact_id" column */
+static int ul_snap_sweep(udomain_t *d)
+{
+	db_key_t columns[1] = {&contactid_col};
+	db_res_t *res = NULL;
+	map_iterator_t it;
+	ucontact_t *c, *next;
+	urecord_t *r;
+	void **dest;
+	int i, sl, no_rows = 1000, dropped = 0;
+
+	if (ul_dbf.use_table(ul_dbh, d->name) < 0) {
+		LM_ERR("sql use_table failed\n");
+		return -1;
+	}
+
+	if (DB_CAPABILITY(ul_dbf, DB_CAP_FETCH)) {
+		if (ul_dbf.query(ul_dbh, 0, 0, 0, columns, 0, 1, 0, 0) < 0 ||
+		    ul_dbf.fetch_result(ul_dbh, &res, no_rows) < 0) {
+			LM_ERR("failed to query the contact IDs\n");
+			return -1;
+		}
+	} else if (ul_dbf.query(ul_dbh, 0, 0, 0, columns, 0, 1, 0, &res) < 0) {
+		LM_ERR("failed to query the contact IDs\n");
+		return -1;
+	}
+
+	while (RES_ROW_N(res) > 0) {
+		for (i = 0; i < RES_ROW_N(res); i++) {
+			if (VAL_NULL(ROW_VALUES(RES_ROWS(res) + i)))
+				continue;
+
+			/* the slot is left locked on success */
+			c = get_ucontact_from_id(d,
+			        VAL_BIGINT(ROW_VALUES(RES_ROWS(res) + i)), &r);
+			if (c) {
+				c->flags &= ~FL_SNAPSHOT;
+				unlock_ulslot(d, r->aorhash & (d->size - 1));
+			}
+		}
+
+		if (!DB_CAPABILITY(ul_dbf, DB_CAP_FETCH))
+			break;
+
+		if (ul_dbf.fetch_result(ul_dbh, &res, no_rows) < 0) {
+			LM_ERR("fetching rows failed\n");
+			ul_dbf.free_result(ul_dbh, res);
+			return -1;
+		}
+	}
+
+	ul_dbf.free_result(ul_dbh, res);
+
+	/* the empty records are cleaned up by the timer */
+	for (sl = 0; sl < d->size; sl++) {
+		lock_ulslot(d, sl);
+
+		for (map_first(d->table[sl].records, &it);
+		     iterator_is_valid(&it); iterator_next(&it)) {
+			dest = iterator_val(&it);
+			if (!dest)
+				break;
+
+			r = (urecord_t *)*dest;
+			for (c = r->contacts; c; c = next) {
+				next = c->next;
+				if (c->flags & FL_SNAPSHOT) {
+					mem_delete_ucontact(r, c);
+					dropped++;
+				}
+			}
+		}
+
+		unlock_ulslot(d, sl);
+	}
+
+	if (dropped)
+		LM_INFO("dropped %d contacts of %.*s, deleted after the snapshot\n",
+		        dropped, d->name->len, d->name->s);
+
+	return 0;
+}
+
+
+/* runs in the process of the last loader to complete */
+static void ul_snap_load_finish(void)
+{
+	struct timeval end;
+	dlist_t *dl;
+	time_t since;
+	int sl;
+
+	for (dl = root; dl; dl = dl->next) {
+		if (rr_persist == RRP_LOAD_FROM_SQL) {
+			/* cover for any changes not yet flushed at snapshot time */
+			since = snap_load->failed ? 0 :
+			        snap_load->created - 2 * timer_interval;
+
+			if (preload_udomain_delta(ul_dbh, dl->d, since) < 0)
+				LM_ERR("failed to load the changes of domain '%.*s'\n",
+				       dl->name.len, dl->name.s);
+
+			if (!snap_load->final && ul_snap_sweep(dl->d) < 0)
+				LM_ERR("failed to check the contacts of domain '%.*s'\n",
+				       dl->name.len, dl->name.s);
+		}
+
+		for (sl = 0; sl < dl->d->size; sl++) {
+			lock_ulslot(dl->d, sl);
+			if (dl->d->table[sl].next_label == 0)
+				dl->d->table[sl].next_label = rand();
+			unlock_ulslot(dl->d, sl);
+		}
+	}
+
+	gettimeofday(&end, NULL);
+	LM_INFO("restored %u records / %u contacts from %s in %ld ms%s\n",
+	        snap_load->records, snap_load->contacts, ul_snapshot_file,
+	        (end.tv_sec - snap_load->start.tv_sec) * 1000 +
+	        (end.tv_usec - snap_load->start.tv_usec) / 1000,
+	        snap_load->failed ? " (with errors)" : "");
+
+	ul_snapshot_loaded();
+}
+
+
+static void ul_snap_load_range(int sender, void *param)
+{
+	struct snap_reader rd;
+	struct snap_cursor cur;
+	unsigned int blk, size, from, to, records = 0, contacts = 0;
+	int idx = (int)(long)param, failed = 0, last, sl;
+	udomain_t *d;
+	str name;
+
+	if (snap_open_read(&rd, ul_snapshot_file, UL_SNAP_MAGIC,
+	                   UL_SNAP_VERSION) != 0 ||
+	    rd.created != snap_load->created) {
+		LM_ERR("snapshot %s changed while loading\n", ul_snapshot_file);
+		failed = 1;
+		goto done;
+	}
+
+	for (blk = 0; blk < rd.n_blocks; blk += size + 1) {
+		if (snap_open_block(&rd, blk, &cur) < 0 ||
+		    snap_get_str(&cur, &name) < 0 || !name.s ||
+		    snap_get_val(&cur, size) < 0 || blk + size >= rd.n_blocks) {
+			/* validated before dispatching the loaders */
+			LM_BUG("bad domain descriptor in block %u\n", blk);
+			failed = 1;
+			break;
+		}
+
+		if (find_domain(&name, &d) != 0)
+			continue;
+
+		from = size * idx / ul_snapshot_loaders;
+		to = size * (idx + 1) / ul_snapshot_loaders;
+
+		for (sl = from; sl < to; sl++)
+			if (snap_open_block(&rd, blk + 1 + sl, &cur) < 0 ||
+			    ul_snap_load_slot(d, sl, &cur, &records, &contacts) < 0)
+				failed = 1;
+	}
+
+	snap_close(&rd);
+
+done:
+	lock_get(&snap_load->lock);
+	snap_load->records += records;
+	snap_load->contacts += contacts;
+	if (failed)
+		snap_load->failed = 1;
+	last = (--snap_load->pending == 0);
+	lock_release(&snap_load->lock);
+
+	LM_DBG("loader %d done: %u records, %u contacts\n", idx, records,
+	       contacts);
+
+	if (last)
+		ul_snap_load_finish();
+}
+
+
+int ul_snapshot_load(void)
+{
+	struct snap_reader rd;
+	struct snap_cursor cur;
+	unsigned int blk, size;
+	udomain_t *d;
+	str name;
+	int i, rc;
+
+	if (!ul_snapshot_file)
+		return 0;
+
+	rc = snap_open_read(&rd, ul_snapshot_file, UL_SNAP_MAGIC,
+	                    UL_SNAP_VERSION);
+	if (rc != 0) {
+		if (rc < 0)
+			LM_WARN("ignoring the %s snapshot\n", ul_snapshot_file);
+		return 0;
+	}
+
+	/* the labels inside the contact IDs depend on the hash size */
+	for (blk = 0; blk < rd.n_blocks; blk += size + 1) {
+		if (snap_open_block(&rd, blk, &cur) < 0 ||
+		    snap_get_str(&cur, &name) < 0 || !name.s ||
+		    snap_get_val(&cur, size) < 0 || blk + size >= rd.n_blocks) {
+			LM_WARN("bad domain descriptor, ignoring the %s snapshot\n",
+			        ul_snapshot_file);
+			goto ignore;
+		}
+
+		if (find_domain(&name, &d) == 0 && d->size != size) {
+			LM_WARN("'hash_size' changed, ignoring the %s snapshot\n",
+			        ul_snapshot_file);
+			goto ignore;
+		}
+	}
+
+	snap_load->created = rd.created;
+	snap_load->final = rd.flags & SNAP_FL_FINAL;
+	snap_load->pending = ul_snapshot_loaders;
+	gettimeofday(&snap_load->start, NULL);
+	snap_close(&rd);
+
+	LM_INFO("restoring the domains from %s (%s, %ld s old), %d loaders\n",
+	        ul_snapshot_file, snap_load->final ? "final" : "periodic",
+	        (long)(time(NULL) - snap_load->created), ul_snapshot_loaders);
+
+	/* spread the slot ranges over the SIP workers, keeping one */
+	for (i = 1; i < ul_snapshot_loaders; i++)
+		if (ipc_dispatch_rpc(ul_snap_load_range, (void *)(long)i) < 0) {
+			LM_DBG("failed to dispatch loader %d, running it inline\n", i);
+			ul_snap_load_range(process_no, (void *)(long)i);
+		}
+
+	ul_snap_load_range(process_no, (void *)0);
+	return 1;
+
+ignore:
+	snap_close(&rd);
+	return 0;
+}
+
+
+void ul_snapshot_loaded(void)
+{
+	if (snap_load)
+		snap_load->ready = 1;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Restart persistency through binary snapshots of the in-memory domains
+ *
+ * The domains are periodically dumped (one snapshot block per hash slot)
+ * by a timer and, once more, on shutdown. On startup, the snapshot is loaded
+ * in parallel by several SIP workers, each of them handling a range of hash
+ * slots, then, if "restart_persistency" is "load-from-sql", only the rows
+ * changed since the snapshot are loaded from the database.
+ */
+
+#ifndef _UL_SNAPSHOT_H_
+#define _UL_SNAPSHOT_H_
+
+extern char *ul_snapshot_file;
+extern int ul_snapshot_interval;
+extern int ul_snapshot_loaders;
+
+int ul_init_snapshot(void);
+
+/*
+ * Start restoring the domains from the snapshot, if any
+ *
+ * Returns 1 if the loading started (the DB delta is loaded by the last
+ * loader to complete) or 0 if the domains are to be fully loaded from DB.
+ */
+int ul_snapshot_load(void);
+
+/* to be called once the domains were loaded in a different way */
+void ul_snapshot_loaded(void);
+
+/* dump all the domains; @final is set when called on shutdown */
+int ul_snapshot_write(int final);
+
+#endif /* _UL_SNAPSHOT_H_ */
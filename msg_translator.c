@@ -2102,6 +2102,17 @@ char * build_req_buf_from_sip_req( struct sip_msg* msg,
 								unsigned int *returned_len,
 								struct socket_info* send_sock, int proto,
 								str *via_params, unsigned int flags)
+{
+	return build_req_buf_from_sip_req_alloc( msg, returned_len, send_sock,
+		proto, via_params, flags, NULL, NULL);
+}
+
+
+char * build_req_buf_from_sip_req_alloc( struct sip_msg* msg,
+								unsigned int *returned_len,
+								struct socket_info* send_sock, int proto,
+								str *via_params, unsigned int flags,
+								msg_buf_alloc_f *alloc, void *alloc_param)
 {
 	unsigned int len, new_len, received_len, rport_len, uri_len, via_len, body_delta;
 	char *line_buf, *received_buf, *rport_buf, *new_buf, *buf, *id_buf;
@@ -2303,7 +2314,9 @@ build_msg:
 		uri_len=msg->new_uri.len;
 		new_len=new_len-msg->first_line.u.request.uri.len+uri_len;
 	}
-	if (flags&MSG_TRANS_SHM_FLAG)
+	if (alloc)
+		new_buf=alloc(new_len+1, alloc_param);
+	else if (flags&MSG_TRANS_SHM_FLAG)
 		new_buf=(char*)shm_malloc(new_len+1);
 	else
 		new_buf=(char*)pkg_malloc(new_len+1);
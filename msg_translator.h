@@ -138,6 +138,15 @@ char * build_req_buf_from_sip_req (	struct sip_msg* msg,
 				unsigned int *returned_len, struct socket_info* send_sock,
 				int proto, str *via_params, unsigned int flags);
 
+/* allocator for the new message buffer, to be used instead of the
+ * pkg/shm one selected by MSG_TRANS_SHM_FLAG */
+typedef char* (msg_buf_alloc_f)(unsigned int len, void *param);
+
+char * build_req_buf_from_sip_req_alloc( struct sip_msg* msg,
+				unsigned int *returned_len, struct socket_info* send_sock,
+				int proto, str *via_params, unsigned int flags,
+				msg_buf_alloc_f *alloc, void *alloc_param);
+
 char * build_res_buf_from_sip_res(	struct sip_msg* msg,
 				unsigned int *returned_len, struct socket_info *sock,int flags);
 
@@ -31,6 +31,9 @@
 /* api_proto_net flags */
 #define PROTO_NET_USE_TCP	(1<<0) /* set by proto's that are based on TCP */
 #define PROTO_NET_USE_UDP	(1<<1) /* set by proto's that are based on UDP */
+/* the accepted connections start with a (costly) handshake, to be done
+ * by the dedicated TCP handshake workers, if any */
+#define PROTO_NET_USE_HANDSHAKE	(1<<2)
 
 
 typedef int (*proto_net_write_f)(void *src, int fd);
@@ -89,6 +89,11 @@ struct tcp_worker *tcp_workers=0;
  * quickly finding the corresponding connection for a reply */
 static unsigned int* connection_id=0;
 
+/* connections passed to the TCP workers and not released yet (the sum of
+ * all the "busy" counters), in shm for the auto-scaling engine; written
+ * by TCP MAIN only */
+static int* tcp_workers_pending=0;
+
 /* array of TCP partitions */
 static struct tcp_partition tcp_parts[TCP_PARTITION_SIZE];
 
@@ -113,6 +118,12 @@ int tcp_max_connections=DEFAULT_TCP_MAX_CONNECTIONS;
 int tcp_workers_no = UDP_WORKERS_NO;
 /* the maximum numbers of TCP workers */
 int tcp_workers_max_no;
+/* how many of the (first) TCP workers are dedicated to the handshakes of
+ * the newly accepted connections (i.e. TLS), before these are passed to
+ * the other workers */
+int tcp_handshake_workers_no = 0;
+/* is the process a TCP handshake worker ? */
+int tcp_handshake_worker = 0;
 /* the name of the auto-scaling profile (optional) */
 char* tcp_auto_scaling_profile = NULL;
 /* Max number of seconds that we except a full SIP message
@@ -244,7 +255,7 @@ error:
 	return -1;
 }
 
-static int send2worker(struct tcp_connection* tcpconn,int rw)
+static int send2worker(struct tcp_connection* tcpconn,int rw,int handshake)
 {
 	int i;
 	int min_busy;
@@ -252,8 +263,10 @@ static int send2worker(struct tcp_connection* tcpconn,int rw)
 	long response[2];
 
 	min_busy=INT_MAX;
-	idx=0;
-	for (i=0; i<tcp_workers_max_no; i++){
+	/* the handshake workers are the first ones, they get only the new
+	 * connections requiring a handshake */
+	idx = handshake ? 0 : tcp_handshake_workers_no;
+	for (i=idx; i<(handshake?tcp_handshake_workers_no:tcp_workers_max_no); i++){
 		if (tcp_workers[i].state==STATE_ACTIVE) {
 			if (!tcp_workers[i].busy){
 				idx=i;
@@ -266,8 +279,15 @@ static int send2worker(struct tcp_connection* tcpconn,int rw)
 		}
 	}
 
+	if (min_busy==INT_MAX) {
+		LM_ERR("no active TCP %sworker to pass the connection to\n",
+			handshake?"handshake ":"");
+		return -1;
+	}
+
 	tcp_workers[idx].busy++;
 	tcp_workers[idx].n_reqs++;
+	(*tcp_workers_pending)++;
 	if (min_busy) {
 		LM_DBG("no free tcp receiver, connection passed to the least "
 		       "busy one (proc #%d, %d con)\n", idx, min_busy);
@@ -1062,7 +1082,8 @@ static inline int handle_new_connect(struct socket_info* si)
 				tcpconn, tcpconn->s, tcpconn->flags);
 		/* pass it to a workerr */
 		sh_log(tcpconn->hist, TCP_SEND2CHILD, "accept");
-		if(send2worker(tcpconn,IO_WATCH_READ)<0){
+		if(send2worker(tcpconn,IO_WATCH_READ, tcp_handshake_workers_no &&
+		(protos[tcpconn->type].net.flags&PROTO_NET_USE_HANDSHAKE))<0){
 			LM_ERR("no TCP workers available\n");
 			id = tcpconn->id;
 			sh_log(tcpconn->hist, TCP_UNREF, "accept, (%d)", tcpconn->refcnt);
@@ -1112,7 +1133,7 @@ inline static int handle_tcpconn_ev(struct tcp_connection* tcpconn, int fd_i,
 		tcpconn_ref(tcpconn); /* refcnt ++ */
 		sh_log(tcpconn->hist, TCP_REF, "tcpconn read, (%d)", tcpconn->refcnt);
 		sh_log(tcpconn->hist, TCP_SEND2CHILD, "read");
-		if (send2worker(tcpconn,IO_WATCH_READ)<0){
+		if (send2worker(tcpconn,IO_WATCH_READ,0)<0){
 			LM_ERR("no TCP workers available\n");
 			id = tcpconn->id;
 			TCPCONN_LOCK(id);
@@ -1176,7 +1197,7 @@ async_write:
 			sh_log(tcpconn->hist, TCP_REF, "tcpconn write, (%d)",
 				tcpconn->refcnt);
 			sh_log(tcpconn->hist, TCP_SEND2CHILD, "write");
-			if (send2worker(tcpconn,IO_WATCH_WRITE)<0){
+			if (send2worker(tcpconn,IO_WATCH_WRITE,0)<0){
 				LM_ERR("no TCP worker available\n");
 				id = tcpconn->id;
 				TCPCONN_LOCK(id);
@@ -1270,6 +1291,7 @@ inline static int handle_tcp_worker(struct tcp_worker* tcp_c, int fd_i)
 	switch(cmd){
 		case CONN_RELEASE:
 			tcp_c->busy--;
+			(*tcp_workers_pending)--;
 			if (tcpconn->state==S_CONN_BAD){
 				sh_log(tcpconn->hist, TCP_UNREF, "tcpworker release bad, (%d)", tcpconn->refcnt);
 				tcpconn_destroy(tcpconn);
@@ -1283,6 +1305,7 @@ inline static int handle_tcp_worker(struct tcp_worker* tcp_c, int fd_i)
 			break;
 		case CONN_RELEASE_WRITE:
 			tcp_c->busy--;
+			(*tcp_workers_pending)--;
 			if (tcpconn->state==S_CONN_BAD){
 				sh_log(tcpconn->hist, TCP_UNREF, "tcpworker release write bad, (%d)", tcpconn->refcnt);
 				tcpconn_destroy(tcpconn);
@@ -1293,6 +1316,7 @@ inline static int handle_tcp_worker(struct tcp_worker* tcp_c, int fd_i)
 			break;
 		case ASYNC_WRITE:
 			tcp_c->busy--;
+			(*tcp_workers_pending)--;
 			/* fall through*/
 		case ASYNC_WRITE2:
 			if (tcpconn->state==S_CONN_BAD){
@@ -1311,6 +1335,7 @@ inline static int handle_tcp_worker(struct tcp_worker* tcp_c, int fd_i)
 		case CONN_EOF:
 			/* WARNING: this will auto-dec. refcnt! */
 			tcp_c->busy--;
+			(*tcp_workers_pending)--;
 			/* fall through*/
 		case CONN_ERROR2:
 			if ((tcpconn->flags & F_CONN_REMOVED) != F_CONN_REMOVED &&
@@ -1729,8 +1754,36 @@ int tcp_init(void)
 		}
 	}
 
-	tcp_workers_max_no = (s_profile && (tcp_workers_no<s_profile->max_procs)) ?
-		s_profile->max_procs : tcp_workers_no ;
+	if (tcp_handshake_workers_no) {
+		for ( i=PROTO_FIRST ; i<PROTO_LAST ; i++ )
+			if ((protos[i].net.flags&PROTO_NET_USE_HANDSHAKE) &&
+			proto_has_listeners(i))
+				break;
+		if (i==PROTO_LAST) {
+			LM_INFO("no listener requiring handshakes, the TCP handshake "
+				"workers are not needed\n");
+			tcp_handshake_workers_no = 0;
+		} else {
+			/* the handshake workers are not part of the auto-scaling
+			 * group, so enough workers must be left for the SIP traffic
+			 * to cover the minimum of the scaling profile (at least one) */
+			i = (s_profile && s_profile->min_procs>1) ?
+				s_profile->min_procs : 1;
+			if (tcp_workers_no < tcp_handshake_workers_no + i) {
+				LM_WARN("too many TCP handshake workers (%d), using %d\n",
+					tcp_handshake_workers_no,
+					(tcp_workers_no>i) ? tcp_workers_no-i : 0);
+				tcp_handshake_workers_no =
+					(tcp_workers_no>i) ? tcp_workers_no-i : 0;
+			}
+		}
+	}
+
+	/* the scaling profile accounts only for the SIP workers, the
+	 * handshake ones are on top of it */
+	tcp_workers_max_no = (s_profile &&
+		(tcp_workers_no-tcp_handshake_workers_no<s_profile->max_procs)) ?
+		tcp_handshake_workers_no+s_profile->max_procs : tcp_workers_no ;
 
 	/* init tcp workers array */
 	tcp_workers = (struct tcp_worker*)pkg_malloc
@@ -1749,6 +1802,12 @@ int tcp_init(void)
 	// The  rand()  function returns a pseudo-random integer in the range 0 to
 	// RAND_MAX inclusive (i.e., the mathematical range [0, RAND_MAX]).
 	*connection_id=(unsigned int)rand();
+	tcp_workers_pending=(int*)shm_malloc(sizeof(int));
+	if (tcp_workers_pending==0){
+		LM_CRIT("could not alloc globals in shm memory\n");
+		goto error;
+	}
+	*tcp_workers_pending=0;
 	memset( &tcp_parts, 0, TCP_PARTITION_SIZE*sizeof(struct tcp_partition));
 	/* init partitions */
 	for( i=0 ; i<TCP_PARTITION_SIZE ; i++ ) {
@@ -1805,6 +1864,10 @@ void tcp_destroy(void)
 		shm_free(connection_id);
 		connection_id=0;
 	}
+	if (tcp_workers_pending){
+		shm_free(tcp_workers_pending);
+		tcp_workers_pending=0;
+	}
 
 	for ( part=0 ; part<TCP_PARTITION_SIZE ; part++ ) {
 		if (tcp_parts[part].tcpconn_id_hash){
@@ -1882,6 +1945,18 @@ int _get_own_tcp_worker_id(void)
 }
 
 
+unsigned int tcp_get_pending_conns(void)
+{
+	int n;
+
+	if (tcp_workers_pending==0)
+		return 0;
+
+	n = *(volatile int*)tcp_workers_pending;
+	return (n>0) ? n : 0;
+}
+
+
 void tcp_reset_worker_slot(void)
 {
 	int i;
@@ -1899,8 +1974,9 @@ static int fork_dynamic_tcp_process(void *foo)
 	int p_id;
 	int r;
 
-	/* search for free slot in the TCP workers table */
-	for( r=0 ; r<tcp_workers_max_no ; r++ )
+	/* search for free slot in the TCP workers table (the dynamic
+	 * workers are never used for handshakes) */
+	for( r=tcp_handshake_workers_no ; r<tcp_workers_max_no ; r++ )
 		if (tcp_workers[r].state==STATE_INACTIVE)
 			break;
 
@@ -1983,8 +2059,9 @@ int tcp_count_processes(unsigned int *extra)
 
 	if (s_profile && extra) {
 		/* how many can be forked over th number of procs to start with ?*/
-		if (s_profile->max_procs > tcp_workers_no)
-			*extra = s_profile->max_procs - tcp_workers_no;
+		if (s_profile->max_procs > tcp_workers_no-tcp_handshake_workers_no)
+			*extra = s_profile->max_procs -
+				(tcp_workers_no-tcp_handshake_workers_no);
 	}
 
 	return 1/* tcp main */ + tcp_workers_no /*workers to start with*/;
@@ -2028,7 +2105,9 @@ int tcp_start_processes(int *chd_rank, int *startup_done)
 	/* start the TCP workers */
 	for(r=0; r<tcp_workers_no; r++){
 		(*chd_rank)++;
-		p_id=internal_fork("SIP receiver TCP", OSS_PROC_NEEDS_SCRIPT,TYPE_TCP);
+		p_id=internal_fork((r<tcp_handshake_workers_no)?
+			"TCP handshake worker":"SIP receiver TCP",
+			OSS_PROC_NEEDS_SCRIPT,TYPE_TCP);
 		if (p_id<0){
 			LM_ERR("fork failed\n");
 			goto error;
@@ -2041,6 +2120,12 @@ int tcp_start_processes(int *chd_rank, int *startup_done)
 			/* child */
 			set_proc_attrs("TCP receiver");
 			tcp_workers[r].pid = getpid();
+			tcp_handshake_worker = (r<tcp_handshake_workers_no);
+			/* keep the handshake workers out of the TCP auto-scaling
+			 * group - they are neither counted for its load, nor
+			 * terminated when downscaling */
+			if (tcp_handshake_worker)
+				pt[process_no].pg_filter = &tcp_handshake_workers_no;
 			if (tcp_worker_proc_reactor_init(tcp_workers[r].main_unix_sock)<0||
 					init_child(*chd_rank) < 0) {
 				LM_ERR("init_children failed\n");
@@ -66,6 +66,9 @@ int tcp_start_listener(void);
 
 void tcp_reset_worker_slot(void);
 
+/* number of connections currently handed to the TCP workers */
+unsigned int tcp_get_pending_conns(void);
+
 /* MI function to list all existing TCP connections */
 mi_response_t *mi_tcp_list_conns(const mi_params_t *params,
 							struct mi_handler *async_hdl);
@@ -108,4 +111,16 @@ int tcp_get_correlation_id( unsigned int id, unsigned long long *cid);
 
 extern unsigned int last_outgoing_tcp_id;
 
+/* is the process a TCP handshake worker ? */
+extern int tcp_handshake_worker;
+
+#define TCP_CONN_WAIT_MAX_FDS 8
+
+/* to be called by the protocol read handlers: the TCP worker holding @con
+ * also waits for @fds (i.e. the fds of an asynchronous crypto job) to
+ * become readable and then resumes the reading of the connection, as if
+ * its own fd was readable. Returns -1 if @con is not held by the current
+ * process */
+int tcp_conn_wait_fds(struct tcp_connection *con, int *fds, int fds_no);
+
 #endif /* _NET_TCP_H_ */
@@ -31,6 +31,7 @@
 #include "../async.h"
 #include "../cfg_reload.h"
 
+#include "net_tcp.h"
 #include "tcp_conn.h"
 #include "tcp_passfd.h"
 #include "net_tcp_report.h"
@@ -47,6 +48,16 @@ static struct tcp_connection* tcp_conn_lst=0;
 static int tcpmain_sock=-1;
 extern int unix_tcp_sock;
 
+/*!< the extra fds waited on for a connection handled by this process */
+struct tcp_conn_wait {
+	struct tcp_connection *con;
+	int fds[TCP_CONN_WAIT_MAX_FDS];
+	int fds_no;
+	struct tcp_conn_wait *next;
+};
+
+static struct tcp_conn_wait *tcp_conn_waits = NULL;
+
 extern struct struct_hist_list *con_hist;
 
 #define tcpconn_release_error(_conn, _writer, _reason) \
@@ -109,6 +120,77 @@ void tcp_conn_release(struct tcp_connection* c, int pending_data)
 }
 
 
+int tcp_conn_wait_fds(struct tcp_connection *con, int *fds, int fds_no)
+{
+	struct tcp_conn_wait *w;
+	int i;
+
+	if (con->proc_id!=process_no || fds_no<=0 ||
+	fds_no>TCP_CONN_WAIT_MAX_FDS)
+		return -1;
+
+	/* already waiting (for the same, still paused, job) */
+	if (con->flags & F_CONN_ASYNC_WAIT)
+		return 0;
+
+	w = pkg_malloc(sizeof *w);
+	if (!w) {
+		LM_ERR("no more pkg memory\n");
+		return -1;
+	}
+	w->con = con;
+	w->fds_no = 0;
+
+	for (i=0; i<fds_no; i++) {
+		if (reactor_add_reader(fds[i], F_TCPCONN_ASYNC, RCT_PRIO_NET, w)<0) {
+			LM_ERR("failed to add async fd %d to the reactor\n", fds[i]);
+			goto error;
+		}
+		w->fds[w->fds_no++] = fds[i];
+	}
+
+	w->next = tcp_conn_waits;
+	tcp_conn_waits = w;
+	con->flags |= F_CONN_ASYNC_WAIT;
+
+	return 0;
+error:
+	for (i=0; i<w->fds_no; i++)
+		reactor_del_reader(w->fds[i], -1, 0);
+	pkg_free(w);
+	return -1;
+}
+
+
+/*! \brief stops waiting on the extra fds of a connection, if any; to be done
+ * before the connection leaves the process */
+static void tcp_conn_unwait(struct tcp_connection *con)
+{
+	struct tcp_conn_wait *w, *prev;
+	int i;
+
+	if (!(con->flags & F_CONN_ASYNC_WAIT))
+		return;
+	con->flags &= ~F_CONN_ASYNC_WAIT;
+
+	for (prev=NULL, w=tcp_conn_waits; w; prev=w, w=w->next)
+		if (w->con==con)
+			break;
+	if (!w)
+		return;
+
+	/* the fds are owned by someone else, do not close them */
+	for (i=0; i<w->fds_no; i++)
+		reactor_del_reader(w->fds[i], -1, 0);
+
+	if (prev)
+		prev->next = w->next;
+	else
+		tcp_conn_waits = w->next;
+	pkg_free(w);
+}
+
+
 /*! \brief  releases expired connections and cleans up bad ones (state<0) */
 static void tcp_receive_timeout(void)
 {
@@ -125,6 +207,7 @@ static void tcp_receive_timeout(void)
 
 			reactor_del_reader(con->fd, -1/*idx*/, IO_FD_CLOSING/*io_flags*/ );
 			tcpconn_check_del(con);
+			tcp_conn_unwait(con);
 			tcpconn_listrm(tcp_conn_lst, con, c_next, c_prev);
 			con->proc_id = -1;
 			con->state=S_CONN_BAD;
@@ -144,6 +227,7 @@ static void tcp_receive_timeout(void)
 			/* fd will be closed in tcpconn_release */
 			reactor_del_reader(con->fd, -1/*idx*/, IO_FD_CLOSING/*io_flags*/ );
 			tcpconn_check_del(con);
+			tcp_conn_unwait(con);
 			tcpconn_listrm(tcp_conn_lst, con, c_next, c_prev);
 
 			/* connection is going to main */
@@ -162,6 +246,59 @@ static void tcp_receive_timeout(void)
 }
 
 
+/*! \brief reads from a connection held by this process and passes it back
+ * to TCP main, if done with it; @idx is the index of its fd in the reactor
+ * (or -1 if not known) */
+static int tcp_handle_conn_read(struct tcp_connection *con, int idx)
+{
+	int ret=0;
+	long resp;
+
+	resp = protos[con->type].net.read( (void*)con, &ret );
+	if (resp<0) {
+		ret=-1; /* some error occurred */
+		con->state=S_CONN_BAD;
+		reactor_del_all( con->fd, idx, IO_FD_CLOSING );
+		tcpconn_check_del(con);
+		tcp_conn_unwait(con);
+		tcpconn_listrm(tcp_conn_lst, con, c_next, c_prev);
+		con->proc_id = -1;
+		if (con->fd!=-1) { close(con->fd); con->fd = -1; }
+		sh_log(con->hist, TCP_SEND2MAIN, "handle read, err, resp: %d, att: %d",
+		       resp, con->msg_attempts);
+		tcpconn_release_error(con, 0, "Read error");
+	} else if (con->state==S_CONN_EOF) {
+		reactor_del_all( con->fd, idx, IO_FD_CLOSING );
+		tcpconn_check_del(con);
+		tcp_conn_unwait(con);
+		tcpconn_listrm(tcp_conn_lst, con, c_next, c_prev);
+		con->proc_id = -1;
+		if (con->fd!=-1) { close(con->fd); con->fd = -1; }
+		tcp_trigger_report( con, TCP_REPORT_CLOSE,
+			"EOF received");
+		sh_log(con->hist, TCP_SEND2MAIN, "handle read, EOF, resp: %d, att: %d",
+		       resp, con->msg_attempts);
+		tcpconn_release(con, CONN_EOF,0);
+	} else if (con->flags & F_CONN_HANDOVER) {
+		/* handshake done, let TCP main pass the connection
+		 * to a SIP worker when more data arrives */
+		con->flags &= ~F_CONN_HANDOVER;
+		reactor_del_all( con->fd, idx, IO_FD_CLOSING );
+		tcpconn_check_del(con);
+		tcp_conn_unwait(con);
+		tcpconn_listrm(tcp_conn_lst, con, c_next, c_prev);
+		con->proc_id = -1;
+		if (con->fd!=-1) { close(con->fd); con->fd = -1; }
+		sh_log(con->hist, TCP_SEND2MAIN, "handshake done, resp: %d",
+		       resp);
+		tcpconn_release(con, CONN_RELEASE,0);
+	}
+	/* else keep the connection for now */
+
+	return ret;
+}
+
+
 /*! \brief
  *  handle io routine, based on the fd_map type
  * (it will be called from reactor_main_loop )
@@ -307,37 +444,17 @@ again:
 			}
 			break;
 		case F_TCPCONN:
-			if (event_type & IO_WATCH_READ) {
-				con=(struct tcp_connection*)fm->data;
-				resp = protos[con->type].net.read( (void*)con, &ret );
-				if (resp<0) {
-					ret=-1; /* some error occurred */
-					con->state=S_CONN_BAD;
-					reactor_del_all( con->fd, idx, IO_FD_CLOSING );
-					tcpconn_check_del(con);
-					tcpconn_listrm(tcp_conn_lst, con, c_next, c_prev);
-					con->proc_id = -1;
-					if (con->fd!=-1) { close(con->fd); con->fd = -1; }
-					sh_log(con->hist, TCP_SEND2MAIN, "handle read, err, resp: %d, att: %d",
-					       resp, con->msg_attempts);
-					tcpconn_release_error(con, 0, "Read error");
-				} else if (con->state==S_CONN_EOF) {
-					reactor_del_all( con->fd, idx, IO_FD_CLOSING );
-					tcpconn_check_del(con);
-					tcpconn_listrm(tcp_conn_lst, con, c_next, c_prev);
-					con->proc_id = -1;
-					if (con->fd!=-1) { close(con->fd); con->fd = -1; }
-					tcp_trigger_report( con, TCP_REPORT_CLOSE,
-						"EOF received");
-					sh_log(con->hist, TCP_SEND2MAIN, "handle read, EOF, resp: %d, att: %d",
-					       resp, con->msg_attempts);
-					tcpconn_release(con, CONN_EOF,0);
-				} else {
-					//tcpconn_release(con, CONN_RELEASE);
-					/* keep the connection for now */
-					break;
-				}
-			}
+			if (event_type & IO_WATCH_READ)
+				ret = tcp_handle_conn_read((struct tcp_connection*)fm->data,
+					idx);
+			break;
+		case F_TCPCONN_ASYNC:
+			/* an async job of the connection completed, resume the
+			 * reading (and the job) */
+			con = ((struct tcp_conn_wait*)fm->data)->con;
+			tcp_conn_unwait(con);
+			tcp_handle_conn_read(con, -1);
+			ret = 0;
 			break;
 		case F_NONE:
 			LM_CRIT("empty fd map %p: "
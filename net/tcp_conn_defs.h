@@ -83,6 +83,10 @@
 /*!< no longer in "main" reactor for read or write */
 #define F_CONN_REMOVED			(F_CONN_REMOVED_READ|F_CONN_REMOVED_WRITE)
 #define F_CONN_INIT				(1<<5) /*!< the connection was initialized */
+/*!< to be passed back to "main" by the handshake worker (handshake done) */
+#define F_CONN_HANDOVER			(1<<6)
+/*!< the worker waits on some extra fds (async jobs) for this connection */
+#define F_CONN_ASYNC_WAIT		(1<<7)
 
 enum tcp_conn_states { S_CONN_ERROR=-2, S_CONN_BAD=-1, S_CONN_OK=0,
 		S_CONN_CONNECTING, S_CONN_EOF };
@@ -26,6 +26,7 @@
 #include "net/net_tcp.h"
 #include "net/net_udp.h"
 #include "db/db_insertq.h"
+#include "db/db_async_exec.h"
 #include "sr_module.h"
 #include "dprint.h"
 #include "pt.h"
@@ -391,6 +392,12 @@ int count_child_processes(void)
 	/* count the processes requested by modules */
 	proc_no += count_module_procs(0);
 
+	/* SQL writers for the buffered inserts */
+	proc_no += ql_count_writer_processes();
+
+	/* executors of the async DB queries */
+	proc_no += db_async_exec_count_processes();
+
 	return proc_no + proc_extra_no;
 }
 
@@ -48,8 +48,9 @@ struct process_table {
 	/* various flags describing properties of this process */
 	unsigned int flags;
 
-	/* pipe used by the process to receive designated jobs (used by IPC)
-	 * [1] for writting into by other process,
+	/* eventfd used by the process to be woken up for its designated jobs
+	 * (used by IPC, the jobs are in a shm queue) - the same fd in both
+	 * [1] for signaling by other process,
 	 * [0] to listen on by this process */
 	int ipc_pipe[2];
 	/* same as above, but the holder used when the corresponding process
@@ -89,6 +90,11 @@ struct process_table {
 
 	/* the load statistic of this process */
 	struct proc_load_info load;
+
+	/* IPC jobs handled by this process and their total queueing time
+	 * (usec) - updated only by the process itself */
+	unsigned long ipc_jobs;
+	unsigned long long ipc_latency;
 };
 
 
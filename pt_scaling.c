@@ -19,14 +19,22 @@
  */
 
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <time.h>
+#ifdef __OS_linux
+#include <linux/sockios.h>
+#include <linux/sock_diag.h>
+#endif
 #include "mem/shm_mem.h"
 #include "socket_info.h"
 #include "dprint.h"
 #include "pt.h"
 #include "ipc.h"
 #include "daemonize.h"
+#include "net/net_tcp.h"
 
 struct process_group {
 	enum process_type type;
@@ -38,6 +46,20 @@ struct process_group {
 	unsigned char *history_map;
 	unsigned char history_idx;
 	unsigned short no_downscale_cycles;
+
+	/* the last sampling, for MI */
+	unsigned int procs;
+	unsigned int load;
+	unsigned int pressure;
+	unsigned int queued;
+	unsigned int ipc_latency;
+	/* the last scaling decision */
+	char *decision;
+	char *reason;
+	time_t decision_ts;
+	unsigned int ups;
+	unsigned int downs;
+
 	struct process_group *next;
 };
 
@@ -45,6 +67,32 @@ static struct process_group *pg_head = NULL;
 
 static struct scaling_profile *profiles_head = NULL;
 
+int auto_scaling_policy = AUTO_SCALING_POLICY_LOAD;
+int auto_scaling_latency = 10000;
+int auto_scaling_queue = 4;
+int auto_scaling_spares = 0;
+
+/* the per process IPC counters, as seen at the previous cycle */
+static unsigned long *ipc_jobs_seen = NULL;
+static unsigned long long *ipc_latency_seen = NULL;
+
+/* estimated kernel memory overhead for each queued UDP datagram, on top of
+ * its payload (sk_buff, shared info, rounding to the allocation bucket) */
+#define UDP_DGRAM_OVERHEAD  1024
+
+
+int set_auto_scaling_policy(char *name)
+{
+	if (strcasecmp(name, "load")==0)
+		auto_scaling_policy = AUTO_SCALING_POLICY_LOAD;
+	else if (strcasecmp(name, "queue")==0)
+		auto_scaling_policy = AUTO_SCALING_POLICY_QUEUE;
+	else
+		return -1;
+
+	return 0;
+}
+
 
 
 int create_auto_scaling_profile( char *name,
@@ -167,6 +215,8 @@ int create_process_group(enum process_type type,
 	pg->history_map = (unsigned char*)(pg+1);
 	pg->history_idx = 0;
 	pg->no_downscale_cycles = pg->prof->down_cycles_delay;
+	pg->decision = "none";
+	pg->reason = "";
 
 	/* add at the end of list, to avoid changing the head of the list due
 	 * forking */
@@ -180,6 +230,22 @@ int create_process_group(enum process_type type,
 }
 
 
+static int _pg_type_str(struct process_group *pg, str *s)
+{
+	if (pg->type==TYPE_UDP) {
+		s->s = "UDP"; s->len = 3;
+	} else if (pg->type==TYPE_TCP) {
+		s->s = "TCP"; s->len = 3;
+	} else if (pg->type==TYPE_TIMER) {
+		s->s = "TIMER"; s->len = 5;
+	} else {
+		return -1;
+	}
+
+	return 0;
+}
+
+
 static void _pt_raise_event(struct process_group *pg, int p_id, int load,
 																char *scale)
 {
@@ -195,22 +261,17 @@ static void _pt_raise_event(struct process_group *pg, int p_id, int load,
 	if (!evi_probe_event(EVI_PROC_AUTO_SCALE_ID))
 		return;
 
+	if (_pg_type_str(pg, &s) < 0) {
+		LM_BUG("trying to raise event for unsupported group %d\n",pg->type);
+		return;
+	}
+
 	list = evi_get_params();
 	if (!list) {
 		LM_ERR("cannot create event params\n");
 		return;
 	}
 
-	if (pg->type==TYPE_UDP) {
-		s.s = "UDP"; s.len = 3;
-	} else if (pg->type==TYPE_TCP) {
-		s.s = "TCP"; s.len = 3;
-	} else if (pg->type==TYPE_TIMER) {
-		s.s = "TIMER"; s.len = 5;
-	} else {
-		LM_BUG("trying to raise event for unsupported group %d\n",pg->type);
-		return;
-	}
 	if (evi_param_add_str(list, &pt_ev_type, &s) < 0) {
 		LM_ERR("cannot add group type\n");
 		goto error;
@@ -275,14 +336,114 @@ static void rescale_group_history(struct process_group *pg, unsigned int idx,
 }
 
 
+/* estimates the number of datagrams waiting in the receive queue of an UDP
+ * socket; SIOCINQ only gives the size of the first datagram, so the whole
+ * queue is estimated from the memory it uses */
+static unsigned int udp_queued_dgrams(struct socket_info *si)
+{
+	int inq;
+#ifdef SO_MEMINFO
+	unsigned int mi[SK_MEMINFO_VARS];
+	socklen_t len = sizeof(mi);
+#endif
+
+	if (si==NULL || si->socket<0)
+		return 0;
+
+	if (ioctl(si->socket, SIOCINQ, &inq) < 0 || inq <= 0)
+		return 0;
+
+#ifdef SO_MEMINFO
+	if (getsockopt(si->socket, SOL_SOCKET, SO_MEMINFO, mi, &len) == 0 &&
+	len >= (SK_MEMINFO_RMEM_ALLOC+1)*sizeof(unsigned int) &&
+	mi[SK_MEMINFO_RMEM_ALLOC] > inq + UDP_DGRAM_OVERHEAD)
+		return mi[SK_MEMINFO_RMEM_ALLOC] / (inq + UDP_DGRAM_OVERHEAD);
+#endif
+
+	return 1;
+}
+
+
+/* adds the IPC jobs (and their queueing time) handled by process @i since
+ * the previous cycle */
+static inline void get_ipc_latency(int i, unsigned long *jobs,
+												unsigned long long *latency)
+{
+	unsigned long j;
+	unsigned long long l;
+
+	if (ipc_jobs_seen==NULL) {
+		ipc_jobs_seen = pkg_malloc(counted_max_processes *
+			(sizeof(unsigned long) + sizeof(unsigned long long)));
+		if (ipc_jobs_seen==NULL) {
+			LM_ERR("no more pkg mem for the IPC counters\n");
+			return;
+		}
+		memset(ipc_jobs_seen, 0, counted_max_processes *
+			(sizeof(unsigned long) + sizeof(unsigned long long)));
+		ipc_latency_seen =
+			(unsigned long long*)(ipc_jobs_seen + counted_max_processes);
+	}
+
+	j = *(volatile unsigned long*)&pt[i].ipc_jobs;
+	l = *(volatile unsigned long long*)&pt[i].ipc_latency;
+	if (j > ipc_jobs_seen[i] && l >= ipc_latency_seen[i]) {
+		*jobs += j - ipc_jobs_seen[i];
+		*latency += l - ipc_latency_seen[i];
+	}
+	ipc_jobs_seen[i] = j;
+	ipc_latency_seen[i] = l;
+}
+
+
+/* the pressure on the queues feeding a group, in percentages: 100% means
+ * auto_scaling_queue pending datagrams/connections per process or the IPC
+ * jobs waiting for auto_scaling_latency usec, on average */
+static unsigned int get_group_pressure(struct process_group *pg,
+		unsigned int procs_no, unsigned long ipc_jobs,
+		unsigned long long ipc_latency)
+{
+	unsigned int pressure, p;
+
+	if (pg->type==TYPE_UDP)
+		pg->queued = udp_queued_dgrams(pg->si_filter);
+	else if (pg->type==TYPE_TCP)
+		pg->queued = tcp_get_pending_conns();
+	else
+		pg->queued = 0;
+
+	pg->ipc_latency = ipc_jobs ? (unsigned int)(ipc_latency / ipc_jobs) : 0;
+
+	pressure = pg->queued * 100 / (procs_no * auto_scaling_queue);
+	p = (unsigned int)((unsigned long long)pg->ipc_latency * 100 /
+		auto_scaling_latency);
+	if (p > pressure)
+		pressure = p;
+
+	return pressure;
+}
+
+
+static void set_decision(struct process_group *pg, char *decision,
+																char *reason)
+{
+	pg->decision = decision;
+	pg->reason = reason;
+	pg->decision_ts = time(NULL);
+}
+
+
 void do_workers_auto_scaling(void)
 {
 	struct process_group *pg;
 	unsigned int i, k, idx;
-	unsigned int load;
+	unsigned int load, pressure, needed;
 	unsigned int procs_no;
 	unsigned char cnt_under, cnt_over;
+	unsigned long ipc_jobs;
+	unsigned long long ipc_latency;
 	int p_id, last_idx_in_pg;
+	char *reason;
 
 	/* iterate all the groups we have */
 	for ( pg=pg_head ; pg ; pg=pg->next ) {
@@ -290,6 +451,8 @@ void do_workers_auto_scaling(void)
 		load = 0;
 		procs_no = 0;
 		last_idx_in_pg = -1;
+		ipc_jobs = 0;
+		ipc_latency = 0;
 
 		/* find the processes belonging to this group */
 		for ( i=0 ; i<counted_max_processes ; i++) {
@@ -304,6 +467,8 @@ void do_workers_auto_scaling(void)
 				continue;
 
 			load += get_stat_val( pt[i].load_rt );
+			if (auto_scaling_policy==AUTO_SCALING_POLICY_QUEUE)
+				get_ipc_latency( i, &ipc_jobs, &ipc_latency);
 			last_idx_in_pg = i;
 			procs_no++;
 
@@ -314,12 +479,30 @@ void do_workers_auto_scaling(void)
 			continue;
 		}
 
+		pg->procs = procs_no;
+		pg->load = load / procs_no;
+
+		/* the queues start growing before the load gets high, so they are
+		 * accounted as load - a burst has to last for up_cycles_needed
+		 * cycles in order to trigger an up scaling, as the load does */
+		pressure = 0;
+		if (auto_scaling_policy==AUTO_SCALING_POLICY_QUEUE)
+			pressure = get_group_pressure( pg, procs_no, ipc_jobs, ipc_latency);
+		pg->pressure = pressure;
+
 		/* set the current value */
 		idx = (pg->history_idx+1)%pg->history_size;
-		pg->history_map[idx] = (unsigned char) ( load / procs_no );
+		pg->history_map[idx] = (unsigned char)
+			((pg->load > pressure) ? pg->load : (pressure > 100 ? 100 : pressure));
 
-		LM_DBG("group %d (with %d procs) has average load of %d\n",
-			pg->type, procs_no, pg->history_map[idx]);
+		LM_DBG("group %d (with %d procs) has average load of %d, queue "
+			"pressure %d%% (%d queued, %dus IPC latency)\n",
+			pg->type, procs_no, pg->load, pressure, pg->queued,
+			pg->ipc_latency);
+
+		/* the processes busy with the current load, plus the idle spares */
+		needed = auto_scaling_spares ?
+			((load + 99) / 100 + auto_scaling_spares) : 0;
 
 		/* do the check over the history */
 		cnt_over = 0;
@@ -339,11 +522,19 @@ void do_workers_auto_scaling(void)
 		} while(k!=idx);
 
 		/* decide what to do */
-		if ( cnt_over >= pg->prof->up_cycles_needed ) {
+		if ( cnt_over >= pg->prof->up_cycles_needed )
+			reason = (pressure > pg->load) ? "queue" : "load";
+		else if ( procs_no < needed )
+			reason = "spares";
+		else
+			reason = NULL;
+
+		if ( reason ) {
 			if ( procs_no < pg->prof->max_procs ) {
-				LM_NOTICE("score %d/%d -> forking new proc in group %d "
-					"(with %d procs)\n", cnt_over, pg->prof->up_cycles_tocheck,
-					pg->type, procs_no);
+				LM_NOTICE("score %d/%d, pressure %d%% -> forking new proc in "
+					"group %d (with %d procs) due to %s\n", cnt_over,
+					pg->prof->up_cycles_tocheck, pressure, pg->type, procs_no,
+					reason);
 				/* we need to fork one more process here */
 				if ( (p_id=pg->fork_func(pg->si_filter))<0 ||
 				wait_for_one_child()<0 ) {
@@ -353,11 +544,13 @@ void do_workers_auto_scaling(void)
 					_pt_raise_event( pg, p_id, pg->history_map[idx] ,"up");
 					rescale_group_history( pg, idx, procs_no, +1);
 					pg->no_downscale_cycles = pg->prof->down_cycles_delay;
+					set_decision( pg, "up", reason);
+					pg->ups++;
 				}
 			}
 		} else if ( pg->prof->down_cycles_tocheck != 0 &&
 		cnt_under == pg->prof->down_cycles_tocheck ) {
-			if ( procs_no > pg->prof->min_procs &&
+			if ( procs_no > pg->prof->min_procs && procs_no > needed &&
 			pg->no_downscale_cycles==0) {
 				/* try to estimate the load after downscaling */
 				load = 0;
@@ -380,6 +573,8 @@ void do_workers_auto_scaling(void)
 					ipc_send_rpc( last_idx_in_pg, pg->term_func, NULL);
 					_pt_raise_event( pg, last_idx_in_pg,
 						pg->history_map[idx], "down");
+					set_decision( pg, "down", "load");
+					pg->downs++;
 				}
 			}
 		}
@@ -389,3 +584,101 @@ void do_workers_auto_scaling(void)
 	}
 }
 
+
+mi_response_t *mi_auto_scaling(const mi_params_t *params,
+		struct mi_handler *async_hdl)
+{
+	mi_response_t *resp;
+	mi_item_t *resp_obj;
+	mi_item_t *arr, *item;
+	struct process_group *pg;
+	str s;
+
+	resp = init_mi_result_object(&resp_obj);
+	if (!resp)
+		return 0;
+
+	if (add_mi_string(resp_obj, MI_SSTR("Policy"),
+	(auto_scaling_policy==AUTO_SCALING_POLICY_QUEUE) ? "queue" : "load",
+	(auto_scaling_policy==AUTO_SCALING_POLICY_QUEUE) ? 5 : 4) < 0)
+		goto error;
+
+	if (add_mi_number(resp_obj, MI_SSTR("Spares"), auto_scaling_spares) < 0)
+		goto error;
+
+	if (add_mi_number(resp_obj, MI_SSTR("Queue depth"), auto_scaling_queue) < 0)
+		goto error;
+
+	if (add_mi_number(resp_obj, MI_SSTR("IPC latency"),
+	auto_scaling_latency) < 0)
+		goto error;
+
+	arr = add_mi_array(resp_obj, MI_SSTR("Groups"));
+	if (!arr)
+		goto error;
+
+	for ( pg=pg_head ; pg ; pg=pg->next ) {
+		item = add_mi_object(arr, 0, 0);
+		if (!item)
+			goto error;
+
+		if (_pg_type_str(pg, &s) < 0) {
+			s.s = "?"; s.len = 1;
+		}
+		if (add_mi_string(item, MI_SSTR("Type"), s.s, s.len) < 0)
+			goto error;
+
+		if (pg->si_filter==NULL) {
+			s.s = "none"; s.len = 4;
+		} else {
+			s = pg->si_filter->sock_str;
+		}
+		if (add_mi_string(item, MI_SSTR("Filter"), s.s, s.len) < 0)
+			goto error;
+
+		if (add_mi_string(item, MI_SSTR("Profile"),
+		pg->prof->name, strlen(pg->prof->name)) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Processes"), pg->procs) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Load"), pg->load) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Pressure"), pg->pressure) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Queued"), pg->queued) < 0)
+			goto error;
+
+		/* usec */
+		if (add_mi_number(item, MI_SSTR("IPC latency"), pg->ipc_latency) < 0)
+			goto error;
+
+		if (add_mi_string(item, MI_SSTR("Last decision"),
+		pg->decision, strlen(pg->decision)) < 0)
+			goto error;
+
+		if (add_mi_string(item, MI_SSTR("Reason"),
+		pg->reason, strlen(pg->reason)) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Decision time"),
+		pg->decision_ts) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Up scalings"), pg->ups) < 0)
+			goto error;
+
+		if (add_mi_number(item, MI_SSTR("Down scalings"), pg->downs) < 0)
+			goto error;
+	}
+
+	return resp;
+
+error:
+	LM_ERR("failed to add mi item\n");
+	free_mi_response(resp);
+	return 0;
+}
@@ -30,7 +30,24 @@
 #include "pt_load.h"
 #include "socket_info.h"
 #include "ipc.h"
+#include "mi/mi.h"
 
+/* scale on the process load only */
+#define AUTO_SCALING_POLICY_LOAD   0
+/* scale on the process load, but also on the queues feeding the processes
+ * (socket receive queue, pending TCP connections, IPC latency) */
+#define AUTO_SCALING_POLICY_QUEUE  1
+
+extern int auto_scaling_policy;
+/* the IPC queueing latency (usec) considered saturation */
+extern int auto_scaling_latency;
+/* the number of queued datagrams/connections per process considered
+ * saturation */
+extern int auto_scaling_queue;
+/* number of idle processes to be kept on top of the needed ones */
+extern int auto_scaling_spares;
+
+int set_auto_scaling_policy(char *name);
 
 
 struct scaling_profile {
@@ -77,5 +94,8 @@ int create_process_group(enum process_type type,
 
 void do_workers_auto_scaling(void);
 
+mi_response_t *mi_auto_scaling(const mi_params_t *params,
+		struct mi_handler *async_hdl);
+
 
 #endif
@@ -62,7 +62,7 @@ enum fd_types { F_NONE=0,
 		/* fd type specifc to UDP oriented processes (SIP workers) */
 		F_UDP_READ,
 		/* fd types specific to TCP oriented processes (SIP workers) */
-		F_TCPMAIN, F_TCPCONN,
+		F_TCPMAIN, F_TCPCONN, F_TCPCONN_ASYNC,
 		/* fd types for TCP management process (TCP main process) */
 		F_TCP_LISTENER, F_TCP_TCPWORKER, F_TCP_WORKER,
 		/* generic fd type specific to the custome processes (like MI) */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,USA
+ */
+
+#include <tap.h>
+
+#include "../ipc_queue.h"
+
+#define TEST_QUEUE_SIZE 4
+
+static int q_push(ipc_queue *q, long v)
+{
+	ipc_job job;
+
+	memset(&job, 0, sizeof job);
+	job.payload1 = (void *)v;
+	return ipc_queue_push(q, &job);
+}
+
+static long q_pop(ipc_queue *q)
+{
+	ipc_job job;
+
+	if (ipc_queue_pop(q, &job) < 0)
+		return -1;
+	return (long)job.payload1;
+}
+
+static void test_ipc_queue_bounds(ipc_queue *q)
+{
+	int i, rc = 0;
+
+	ok(ipc_queue_empty(q), "ipc-queue-empty-0");
+	ok(q_pop(q) == -1, "ipc-queue-empty-1");
+
+	for (i = 0; i < TEST_QUEUE_SIZE; i++)
+		rc |= q_push(q, i);
+	ok(rc == 0, "ipc-queue-full-0");
+	ok(q_push(q, TEST_QUEUE_SIZE) == -1, "ipc-queue-full-1");
+	ok(!ipc_queue_empty(q), "ipc-queue-full-2");
+
+	/* a slot freed by the consumer is usable again */
+	ok(q_pop(q) == 0, "ipc-queue-full-3");
+	ok(q_push(q, TEST_QUEUE_SIZE) == 0, "ipc-queue-full-4");
+	ok(q_push(q, TEST_QUEUE_SIZE + 1) == -1, "ipc-queue-full-5");
+
+	for (i = 1; i <= TEST_QUEUE_SIZE; i++)
+		if (q_pop(q) != i)
+			break;
+	ok(i == TEST_QUEUE_SIZE + 1, "ipc-queue-fifo-0");
+	ok(ipc_queue_empty(q), "ipc-queue-empty-2");
+	ok(q_pop(q) == -1, "ipc-queue-empty-3");
+}
+
+static void test_ipc_queue_wrap(ipc_queue *q)
+{
+	unsigned long pos;
+	long v = 0, exp = 0;
+	int i, j, bad = 0;
+
+	pos = q->enq_pos;
+
+	/* go around the ring several times, with a varying fill level */
+	for (i = 0; i < 10 * TEST_QUEUE_SIZE; i++) {
+		for (j = 0; j <= i % TEST_QUEUE_SIZE; j++)
+			if (q_push(q, v++) < 0)
+				bad = 1;
+		for (j = 0; j <= i % TEST_QUEUE_SIZE; j++)
+			if (q_pop(q) != exp++)
+				bad = 1;
+	}
+
+	ok(!bad, "ipc-queue-wrap-0");
+	ok(q->enq_pos - pos > 10 * TEST_QUEUE_SIZE, "ipc-queue-wrap-1");
+	ok(q->enq_pos == q->deq_pos && q_pop(q) == -1, "ipc-queue-wrap-2");
+}
+
+static void test_ipc_queue_wakeup(ipc_queue *q)
+{
+	uint64_t cnt = 0;
+
+	/* nothing to consume before the first wakeup */
+	ok(ipc_queue_ack(q) == -1, "ipc-wakeup-0");
+
+	/* several jobs in a row only signal once */
+	q_push(q, 1);
+	ipc_queue_wakeup(q);
+	q_push(q, 2);
+	ipc_queue_wakeup(q);
+	ok(q->signaled == 1, "ipc-wakeup-1");
+	ok(read(q->efd, &cnt, sizeof cnt) == sizeof cnt && cnt == 1,
+		"ipc-wakeup-2");
+	q->signaled = 0;
+	ok(q_pop(q) == 1 && q_pop(q) == 2, "ipc-wakeup-3");
+
+	/* the ack resets the signal... */
+	ipc_queue_wakeup(q);
+	ok(ipc_queue_ack(q) == 0, "ipc-wakeup-4");
+	ok(q->signaled == 0, "ipc-wakeup-5");
+	ok(ipc_queue_ack(q) == -1, "ipc-wakeup-6");
+
+	/* ...so a job queued while the consumer is busy signals again */
+	q_push(q, 3);
+	ipc_queue_wakeup(q);
+	ok(q->signaled == 1, "ipc-wakeup-7");
+	ok(ipc_queue_ack(q) == 0, "ipc-wakeup-8");
+	ok(q_pop(q) == 3 && q_pop(q) == -1, "ipc-wakeup-9");
+}
+
+void test_ipc(void)
+{
+	ipc_queue *q;
+
+	q = ipc_new_queue(TEST_QUEUE_SIZE);
+	ok(q != NULL, "ipc-queue-new");
+	if (!q)
+		return;
+
+	test_ipc_queue_bounds(q);
+	test_ipc_queue_wrap(q);
+	test_ipc_queue_wakeup(q);
+
+	close(q->efd);
+	shm_free(q);
+}
@@ -27,6 +27,7 @@
 #include "../parser/test/test_parser.h"
 #include "../mem/test/test_malloc.h"
 #include "test_ut.h"
+#include "test_ipc.h"
 
 #include "../str.h"
 #include "../lib/list.h"
@@ -63,6 +64,7 @@ int run_unit_tests(void)
 		test_lib_csv();
 		test_parser();
 		test_ut();
+		test_ipc();
 
 	/* module tests */
 	} else {
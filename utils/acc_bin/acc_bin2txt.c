@@ -0,0 +1,478 @@
+/*
+ * Converter of the binary accounting files (acc module, "file" backend)
+ * to CSV or JSON
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include "../../modules/acc/acc_file_fmt.h"
+
+enum out_format { OUT_CSV, OUT_JSON };
+
+struct value {
+	const char *s;
+	unsigned int len;
+};
+
+struct acc_file {
+	const char *name;
+	unsigned char *buf;
+	size_t size;
+	size_t pos;
+	int swap;
+	unsigned int fields;
+	unsigned int leg_fields;
+	struct value *names;    /* fields, then leg fields */
+};
+
+static const char *progname;
+static enum out_format format = OUT_CSV;
+static int no_header;
+
+static const char *rec_types[] = {
+	[ACC_FILE_REC_REQUEST] = "request",
+	[ACC_FILE_REC_MISSED] = "missed",
+	[ACC_FILE_REC_CDR] = "cdr",
+};
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: %s [-f csv|json] [-n] [-o output] file...\n"
+		"  -f  output format: CSV (one row per leg) or JSON (one object\n"
+		"      per record and line); default: csv\n"
+		"  -n  do not print the CSV header line\n"
+		"  -o  write to the given file instead of the standard output\n",
+		progname);
+}
+
+static int get(struct acc_file *f, void *v, size_t len)
+{
+	unsigned char *p = v, t;
+	size_t i;
+
+	if (f->size - f->pos < len)
+		return -1;
+
+	memcpy(v, f->buf + f->pos, len);
+	f->pos += len;
+
+	if (f->swap)
+		for (i = 0; i < len / 2; i++) {
+			t = p[i];
+			p[i] = p[len - 1 - i];
+			p[len - 1 - i] = t;
+		}
+
+	return 0;
+}
+
+static int get_value(struct acc_file *f, struct value *v)
+{
+	uint16_t len;
+
+	if (get(f, &len, sizeof len) < 0 || f->size - f->pos < len)
+		return -1;
+
+	v->s = (const char *)f->buf + f->pos;
+	v->len = len;
+	f->pos += len;
+	return 0;
+}
+
+static int read_file(const char *name, struct acc_file *f)
+{
+	FILE *fp;
+	long size;
+
+	memset(f, 0, sizeof *f);
+	f->name = name;
+
+	fp = fopen(name, "rb");
+	if (!fp) {
+		fprintf(stderr, "%s: failed to open %s: %s\n", progname, name,
+			strerror(errno));
+		return -1;
+	}
+
+	if (fseek(fp, 0, SEEK_END) < 0 || (size = ftell(fp)) < 0 ||
+			fseek(fp, 0, SEEK_SET) < 0) {
+		fprintf(stderr, "%s: failed to read %s: %s\n", progname, name,
+			strerror(errno));
+		goto error;
+	}
+
+	f->buf = malloc(size ? size : 1);
+	if (!f->buf) {
+		fprintf(stderr, "%s: out of memory\n", progname);
+		goto error;
+	}
+
+	if (size && fread(f->buf, size, 1, fp) != 1) {
+		fprintf(stderr, "%s: failed to read %s\n", progname, name);
+		goto error;
+	}
+	f->size = size;
+
+	fclose(fp);
+	return 0;
+
+error:
+	fclose(fp);
+	free(f->buf);
+	f->buf = NULL;
+	return -1;
+}
+
+static int read_header(struct acc_file *f)
+{
+	uint32_t version, bom;
+	uint64_t created;
+	uint16_t fields, leg_fields;
+	unsigned int i;
+
+	if (f->size < ACC_FILE_HDR_LEN ||
+			memcmp(f->buf, ACC_FILE_MAGIC, ACC_FILE_MAGIC_LEN)) {
+		fprintf(stderr, "%s: %s is not an accounting file\n", progname,
+			f->name);
+		return -1;
+	}
+	f->pos = ACC_FILE_MAGIC_LEN;
+
+	get(f, &version, sizeof version);
+	get(f, &bom, sizeof bom);
+	if (bom != ACC_FILE_BOM) {
+		f->swap = 1;
+		f->pos = ACC_FILE_MAGIC_LEN;
+		get(f, &version, sizeof version);
+		get(f, &bom, sizeof bom);
+		if (bom != ACC_FILE_BOM) {
+			fprintf(stderr, "%s: %s has a bad byte order mark\n", progname,
+				f->name);
+			return -1;
+		}
+	}
+
+	if (version != ACC_FILE_VERSION) {
+		fprintf(stderr, "%s: %s has an unsupported version (%u)\n", progname,
+			f->name, version);
+		return -1;
+	}
+
+	get(f, &created, sizeof created);
+	get(f, &fields, sizeof fields);
+	get(f, &leg_fields, sizeof leg_fields);
+	f->fields = fields;
+	f->leg_fields = leg_fields;
+
+	f->names = calloc(fields + leg_fields + 1, sizeof *f->names);
+	if (!f->names) {
+		fprintf(stderr, "%s: out of memory\n", progname);
+		return -1;
+	}
+
+	for (i = 0; i < f->fields + f->leg_fields; i++)
+		if (get_value(f, &f->names[i]) < 0) {
+			fprintf(stderr, "%s: %s has a truncated header\n", progname,
+				f->name);
+			return -1;
+		}
+
+	return 0;
+}
+
+static void print_csv_value(FILE *out, const struct value *v)
+{
+	unsigned int i;
+
+	if (!memchr(v->s, ',', v->len) && !memchr(v->s, '"', v->len) &&
+			!memchr(v->s, '\n', v->len) && !memchr(v->s, '\r', v->len)) {
+		fwrite(v->s, 1, v->len, out);
+		return;
+	}
+
+	fputc('"', out);
+	for (i = 0; i < v->len; i++) {
+		if (v->s[i] == '"')
+			fputc('"', out);
+		fputc(v->s[i], out);
+	}
+	fputc('"', out);
+}
+
+static void print_json_value(FILE *out, const struct value *v)
+{
+	unsigned char c;
+	unsigned int i;
+
+	fputc('"', out);
+	for (i = 0; i < v->len; i++) {
+		c = v->s[i];
+		switch (c) {
+		case '"':  fputs("\\\"", out); break;
+		case '\\': fputs("\\\\", out); break;
+		case '\n': fputs("\\n", out); break;
+		case '\r': fputs("\\r", out); break;
+		case '\t': fputs("\\t", out); break;
+		default:
+			if (c < 0x20)
+				fprintf(out, "\\u%04x", c);
+			else
+				fputc(c, out);
+		}
+	}
+	fputc('"', out);
+}
+
+static void print_csv_header(FILE *out, struct acc_file *f)
+{
+	unsigned int i;
+
+	fputs("type,time,created,setuptime,duration", out);
+	for (i = 0; i < f->fields + f->leg_fields; i++) {
+		fputc(',', out);
+		print_csv_value(out, &f->names[i]);
+	}
+	fputc('\n', out);
+}
+
+struct record {
+	uint8_t type;
+	uint64_t time;
+	uint32_t created;
+	uint32_t setuptime;
+	uint32_t duration;
+	uint16_t legs;
+	struct value *values;   /* fields, then the leg fields of each leg */
+};
+
+static void print_csv_record(FILE *out, struct acc_file *f, struct record *r)
+{
+	struct value *legv;
+	unsigned int i, leg = 0;
+
+	do {
+		fprintf(out, "%s,%llu.%03llu,%u,%u,%u.%03u", rec_types[r->type],
+			(unsigned long long)(r->time / 1000),
+			(unsigned long long)(r->time % 1000),
+			r->created, r->setuptime, r->duration / 1000,
+			r->duration % 1000);
+		for (i = 0; i < f->fields; i++) {
+			fputc(',', out);
+			print_csv_value(out, &r->values[i]);
+		}
+
+		legv = r->legs ? r->values + f->fields + leg * f->leg_fields : NULL;
+		for (i = 0; i < f->leg_fields; i++) {
+			fputc(',', out);
+			if (legv)
+				print_csv_value(out, &legv[i]);
+		}
+		fputc('\n', out);
+	} while (++leg < r->legs);
+}
+
+static void print_json_record(FILE *out, struct acc_file *f, struct record *r)
+{
+	struct value *legv;
+	unsigned int i, leg;
+
+	fprintf(out, "{\"type\":\"%s\",\"time\":%llu.%03llu,\"created\":%u,"
+		"\"setuptime\":%u,\"duration\":%u.%03u", rec_types[r->type],
+		(unsigned long long)(r->time / 1000),
+		(unsigned long long)(r->time % 1000),
+		r->created, r->setuptime, r->duration / 1000, r->duration % 1000);
+
+	for (i = 0; i < f->fields; i++) {
+		fputc(',', out);
+		print_json_value(out, &f->names[i]);
+		fputc(':', out);
+		print_json_value(out, &r->values[i]);
+	}
+
+	if (f->leg_fields) {
+		fputs(",\"legs\":[", out);
+		for (leg = 0; leg < r->legs; leg++) {
+			legv = r->values + f->fields + leg * f->leg_fields;
+			fputs(leg ? ",{" : "{", out);
+			for (i = 0; i < f->leg_fields; i++) {
+				if (i)
+					fputc(',', out);
+				print_json_value(out, &f->names[f->fields + i]);
+				fputc(':', out);
+				print_json_value(out, &legv[i]);
+			}
+			fputc('}', out);
+		}
+		fputc(']', out);
+	}
+
+	fputs("}\n", out);
+}
+
+static int convert(const char *name, FILE *out, int *header_done)
+{
+	struct acc_file f;
+	struct record r;
+	struct value *values = NULL;
+	unsigned int max_values = 0, n, i;
+	size_t start = 0, size;
+	uint32_t len;
+	int ret = -1;
+
+	if (read_file(name, &f) < 0)
+		return -1;
+
+	if (read_header(&f) < 0)
+		goto end;
+
+	if (format == OUT_CSV && !no_header && !*header_done) {
+		print_csv_header(out, &f);
+		*header_done = 1;
+	}
+
+	while (f.pos < f.size) {
+		start = f.pos;
+
+		if (get(&f, &len, sizeof len) < 0 || len < ACC_FILE_REC_HDR_LEN ||
+				f.size - start < len)
+			goto truncated;
+
+		/* the length was checked, these cannot fail */
+		if (get(&f, &r.type, sizeof r.type) < 0 ||
+				get(&f, &r.time, sizeof r.time) < 0 ||
+				get(&f, &r.created, sizeof r.created) < 0 ||
+				get(&f, &r.setuptime, sizeof r.setuptime) < 0 ||
+				get(&f, &r.duration, sizeof r.duration) < 0 ||
+				get(&f, &r.legs, sizeof r.legs) < 0)
+			goto truncated;
+
+		if (r.type < ACC_FILE_REC_REQUEST || r.type > ACC_FILE_REC_CDR) {
+			fprintf(stderr, "%s: %s: unknown record type %u at offset %zu\n",
+				progname, name, r.type, start);
+			goto end;
+		}
+
+		n = f.fields + r.legs * f.leg_fields;
+		if (n > max_values) {
+			free(values);
+			values = malloc(n * sizeof *values);
+			if (!values) {
+				fprintf(stderr, "%s: out of memory\n", progname);
+				goto end;
+			}
+			max_values = n;
+		}
+		r.values = values;
+
+		/* the values must not go past the record */
+		size = f.size;
+		f.size = start + len;
+		for (i = 0; i < n; i++)
+			if (get_value(&f, &values[i]) < 0) {
+				fprintf(stderr, "%s: %s: corrupted record at offset %zu\n",
+					progname, name, start);
+				goto end;
+			}
+		f.size = size;
+		f.pos = start + len;
+
+		if (format == OUT_CSV)
+			print_csv_record(out, &f, &r);
+		else
+			print_json_record(out, &f, &r);
+	}
+
+	ret = 0;
+	goto end;
+
+truncated:
+	/* the writer was stopped while writing the last record */
+	fprintf(stderr, "%s: %s: ignoring the truncated record at offset %zu\n",
+		progname, name, start);
+	ret = 0;
+
+end:
+	free(values);
+	free(f.names);
+	free(f.buf);
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *out = stdout;
+	int c, i, ret = 0, header_done = 0;
+
+	progname = argv[0];
+
+	while ((c = getopt(argc, argv, "f:no:h")) != -1) {
+		switch (c) {
+		case 'f':
+			if (!strcasecmp(optarg, "csv")) {
+				format = OUT_CSV;
+			} else if (!strcasecmp(optarg, "json")) {
+				format = OUT_JSON;
+			} else {
+				usage();
+				return 1;
+			}
+			break;
+		case 'n':
+			no_header = 1;
+			break;
+		case 'o':
+			out = fopen(optarg, "w");
+			if (!out) {
+				fprintf(stderr, "%s: failed to open %s: %s\n", progname,
+					optarg, strerror(errno));
+				return 1;
+			}
+			break;
+		default:
+			usage();
+			return c == 'h' ? 0 : 1;
+		}
+	}
+
+	if (optind >= argc) {
+		usage();
+		return 1;
+	}
+
+	for (i = optind; i < argc; i++)
+		if (convert(argv[i], out, &header_done) < 0)
+			ret = 1;
+
+	if (fclose(out) != 0) {
+		fprintf(stderr, "%s: failed to write the output: %s\n", progname,
+			strerror(errno));
+		ret = 1;
+	}
+
+	return ret;
+}
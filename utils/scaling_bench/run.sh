@@ -0,0 +1,46 @@
+#!/bin/sh
+#
+# Replays the same bursty traffic against OpenSIPS, once with each of the
+# auto-scaling policies, and prints the resulting reply latencies.
+#
+# usage: run.sh [sip_burst options]
+#
+# The OpenSIPS binary and the modules are taken from the source tree, so
+# build them first (make all && make -C utils/scaling_bench).
+#
+
+cd "$(dirname "$0")" || exit 1
+
+OPENSIPS=../../opensips
+BURST=./opensips_sip_burst
+PORT=5099
+ARGS=${*:-"-r 300 -b 3000 -B 2000 -P 10000 -t 60"}
+
+if [ ! -x "$OPENSIPS" ] || [ ! -x "$BURST" ]; then
+	echo "build opensips and $BURST first" >&2
+	exit 1
+fi
+
+for policy in load queue; do
+	cfg=/tmp/opensips_scaling_bench_$policy.cfg
+	pid=/tmp/opensips_scaling_bench.pid
+
+	sed "s/^auto_scaling_policy=.*/auto_scaling_policy=\"$policy\"/" \
+		scaling.cfg > "$cfg"
+
+	$OPENSIPS -f "$cfg" -P "$pid" || exit 1
+	# let the initial workers settle down
+	sleep 3
+
+	echo "=== policy: $policy"
+	$BURST -p $PORT $ARGS
+	if command -v opensips-cli >/dev/null; then
+		echo "--- auto-scaling decisions"
+		opensips-cli -o fifo_file=/tmp/opensips_scaling_bench_fifo \
+			-x mi auto_scaling
+	fi
+
+	kill "$(cat "$pid")"
+	sleep 2
+	rm -f "$cfg"
+done
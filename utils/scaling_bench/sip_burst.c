@@ -0,0 +1,303 @@
+/*
+ * Bursty SIP traffic generator, for benchmarking the worker auto-scaling
+ *
+ * Sends OPTIONS requests over UDP at a base rate, with periodic bursts at
+ * a higher rate, and measures the time until the reply to each request is
+ * received. The latency percentiles and the number of lost requests are
+ * printed at the end.
+ *
+ * Copyright (C) 2021 OpenSIPS Solutions
+ *
+ * This file is part of opensips, a free SIP server.
+ *
+ * opensips is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version
+ *
+ * opensips is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* how long to wait for the late replies, after the last request */
+#define DRAIN_MS   2000
+#define MAX_REQ    1500
+
+static const char *progname;
+
+static const char *dest = "127.0.0.1";
+static int port = 5060;
+static int base_rate = 200;        /* requests per second */
+static int burst_rate = 2000;      /* requests per second, during bursts */
+static int burst_len = 2000;       /* ms */
+static int burst_period = 10000;   /* ms */
+static int duration = 60;          /* s */
+
+/* sending time of each request (ns), 0 once the reply was received */
+static uint64_t *sent;
+static uint64_t *lat;
+static unsigned int n_sent, n_recv;
+static int local_port;
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: %s [-d addr] [-p port] [-r rate] [-b rate] [-B ms] [-P ms]"
+			" [-t s]\n"
+		"  -d  destination IPv4 address; default: %s\n"
+		"  -p  destination port; default: %d\n"
+		"  -r  base rate, in requests per second; default: %d\n"
+		"  -b  rate during the bursts, in requests per second; default: %d\n"
+		"  -B  length of a burst, in ms; default: %d\n"
+		"  -P  period of the bursts, in ms; default: %d\n"
+		"  -t  duration of the test, in seconds; default: %d\n",
+		progname, dest, port, base_rate, burst_rate, burst_len,
+		burst_period, duration);
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int get_int(const char *s, int *v)
+{
+	char *end;
+	long l;
+
+	l = strtol(s, &end, 10);
+	if (*s == '\0' || *end != '\0' || l <= 0 || l > 1000000) {
+		fprintf(stderr, "%s: bad value: %s\n", progname, s);
+		return -1;
+	}
+
+	*v = (int)l;
+	return 0;
+}
+
+static int send_req(int fd, struct sockaddr_in *to, unsigned int id)
+{
+	char buf[MAX_REQ];
+	int len;
+
+	len = snprintf(buf, sizeof buf,
+		"OPTIONS sip:bench@%s:%d SIP/2.0\r\n"
+		"Via: SIP/2.0/UDP 127.0.0.1:%d;branch=z9hG4bKsb%u\r\n"
+		"Max-Forwards: 70\r\n"
+		"From: <sip:bench@127.0.0.1>;tag=sb%d\r\n"
+		"To: <sip:bench@%s:%d>\r\n"
+		"Call-ID: sb-%u\r\n"
+		"CSeq: 1 OPTIONS\r\n"
+		"Content-Length: 0\r\n\r\n",
+		dest, port, local_port, id, (int)getpid(), dest, port, id);
+
+	sent[id] = now_ns();
+	if (sendto(fd, buf, len, 0, (struct sockaddr *)to, sizeof *to) < 0 &&
+			errno != EAGAIN && errno != ENOBUFS) {
+		fprintf(stderr, "%s: failed to send: %s\n", progname,
+			strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+/* waits for replies at most @timeout ns, so that their latency is
+ * measured even while waiting for the time of the next request */
+static void recv_replies(int fd, uint64_t timeout)
+{
+	char buf[4096];
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+	struct timespec ts;
+	unsigned int id;
+	ssize_t len;
+	char *p;
+
+	ts.tv_sec = timeout / 1000000000ULL;
+	ts.tv_nsec = timeout % 1000000000ULL;
+	if (ppoll(&pfd, 1, &ts, NULL) <= 0)
+		return;
+
+	while ((len = recv(fd, buf, sizeof buf - 1, MSG_DONTWAIT)) > 0) {
+		buf[len] = '\0';
+		p = strstr(buf, "\nCall-ID: sb-");
+		if (!p || sscanf(p + 13, "%u", &id) != 1 || id >= n_sent ||
+				!sent[id])
+			continue;
+
+		lat[n_recv++] = now_ns() - sent[id];
+		sent[id] = 0;
+	}
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static double pct(double p)
+{
+	unsigned int i;
+
+	i = (unsigned int)(p * n_recv / 100);
+	if (i >= n_recv)
+		i = n_recv - 1;
+	return lat[i] / 1000000.0;
+}
+
+int main(int argc, char **argv)
+{
+	struct sockaddr_in to, me;
+	socklen_t me_len = sizeof me;
+	uint64_t start, end, now, next, cycle;
+	unsigned int total;
+	int fd, c, rate;
+
+	progname = argv[0];
+
+	while ((c = getopt(argc, argv, "d:p:r:b:B:P:t:h")) != -1) {
+		switch (c) {
+		case 'd':
+			dest = optarg;
+			break;
+		case 'p':
+			if (get_int(optarg, &port) < 0)
+				return 1;
+			break;
+		case 'r':
+			if (get_int(optarg, &base_rate) < 0)
+				return 1;
+			break;
+		case 'b':
+			if (get_int(optarg, &burst_rate) < 0)
+				return 1;
+			break;
+		case 'B':
+			if (get_int(optarg, &burst_len) < 0)
+				return 1;
+			break;
+		case 'P':
+			if (get_int(optarg, &burst_period) < 0)
+				return 1;
+			break;
+		case 't':
+			if (get_int(optarg, &duration) < 0)
+				return 1;
+			break;
+		default:
+			usage();
+			return c == 'h' ? 0 : 1;
+		}
+	}
+
+	if (burst_len > burst_period) {
+		fprintf(stderr, "%s: the burst is longer than its period\n",
+			progname);
+		return 1;
+	}
+
+	memset(&to, 0, sizeof to);
+	to.sin_family = AF_INET;
+	to.sin_port = htons(port);
+	if (inet_pton(AF_INET, dest, &to.sin_addr) != 1) {
+		fprintf(stderr, "%s: bad IPv4 address: %s\n", progname, dest);
+		return 1;
+	}
+
+	/* the upper bound of the number of requests to be sent */
+	total = (unsigned int)((uint64_t)duration *
+		(base_rate > burst_rate ? base_rate : burst_rate)) + 1;
+	sent = calloc(total, sizeof *sent);
+	lat = calloc(total, sizeof *lat);
+	if (!sent || !lat) {
+		fprintf(stderr, "%s: out of memory\n", progname);
+		return 1;
+	}
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0) {
+		fprintf(stderr, "%s: failed to create socket: %s\n", progname,
+			strerror(errno));
+		return 1;
+	}
+
+	/* the Via must point back to the local port */
+	memset(&me, 0, sizeof me);
+	me.sin_family = AF_INET;
+	me.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(fd, (struct sockaddr *)&me, sizeof me) < 0 ||
+			getsockname(fd, (struct sockaddr *)&me, &me_len) < 0) {
+		fprintf(stderr, "%s: failed to bind: %s\n", progname,
+			strerror(errno));
+		return 1;
+	}
+	local_port = ntohs(me.sin_port);
+
+	c = 4 * 1024 * 1024;
+	setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &c, sizeof c);
+
+	start = now_ns();
+	end = start + (uint64_t)duration * 1000000000ULL;
+	next = start;
+
+	while ((now = now_ns()) < end && n_sent < total) {
+		if (now >= next) {
+			/* the bursts are at the end of each period */
+			cycle = ((now - start) / 1000000) % burst_period;
+			rate = cycle >= (uint64_t)(burst_period - burst_len) ?
+				burst_rate : base_rate;
+
+			if (send_req(fd, &to, n_sent) < 0)
+				return 1;
+			n_sent++;
+			next += 1000000000ULL / rate;
+			continue;
+		}
+
+		recv_replies(fd, next - now);
+	}
+
+	end = now_ns() + (uint64_t)DRAIN_MS * 1000000;
+	while (n_recv < n_sent && (now = now_ns()) < end)
+		recv_replies(fd, end - now);
+
+	close(fd);
+
+	printf("sent:     %u\n", n_sent);
+	printf("received: %u\n", n_recv);
+	printf("lost:     %u\n", n_sent - n_recv);
+
+	if (n_recv) {
+		qsort(lat, n_recv, sizeof *lat, cmp_u64);
+		printf("p50:      %.3f ms\n", pct(50));
+		printf("p90:      %.3f ms\n", pct(90));
+		printf("p99:      %.3f ms\n", pct(99));
+		printf("max:      %.3f ms\n", lat[n_recv - 1] / 1000000.0);
+	}
+
+	return 0;
+}